@@ -0,0 +1,13 @@
+/* generated by enum.awk */
+static const char *allocs[] = {
+	"elem",
+	"attr",
+	"cdata",
+	"node",
+	"document",
+	"token",
+	"str",
+	"ostack",
+	"view",
+	"input",
+};
@@ -0,0 +1,17 @@
+/* generated by enum.awk */
+#ifndef ALLOCS_H
+#define ALLOCS_H
+enum allocs {
+	ALLOC_ELEM,
+	ALLOC_ATTR,
+	ALLOC_CDATA,
+	ALLOC_NODE,
+	ALLOC_DOCUMENT,
+	ALLOC_TOKEN,
+	ALLOC_STR,
+	ALLOC_OSTACK,
+	ALLOC_VIEW,
+	ALLOC_INPUT,
+	NALLOCS
+};
+#endif
@@ -0,0 +1,83 @@
+# Amalgamate sources into one file, inlining each local include the
+# first time it is seen and dropping the TEST and BENCH mains. The
+# macros of a .c file are undefined at its end, but its statics stay,
+# so those must have names unique to the library. With
+# -v headers="a.h b.h" the headers are included as purehtml.h instead.
+
+function emit(path,	line, n, skip, depth, name, lic, macros, i, m,
+    list) {
+	printf("#line 1 \"%s\"\n", path)
+	n = 0
+	skip = 0
+	lic = 0
+	while ((getline line < path) > 0) {
+		n++
+		if (n == 1 && line == "/*")
+			lic = 1
+		if (lic) {
+			if (line == " */")
+				lic = 0
+			continue
+		}
+		if (skip) {
+			if (line ~ /^#[ \t]*if/)
+				depth++
+			else if (line ~ /^#[ \t]*endif/ && --depth == 0) {
+				skip = 0
+				printf("#line %d \"%s\"\n", n + 1, path)
+			}
+			continue
+		}
+		if (line ~ /^#ifdef (TEST|BENCH)$/) {
+			skip = 1
+			depth = 1
+			continue
+		}
+		if (line ~ /^#include "/) {
+			name = line
+			sub(/^#include "/, "", name)
+			sub(/".*/, "", name)
+			if (!(name in seen)) {
+				seen[name] = 1
+				emit(name)
+			}
+			printf("#line %d \"%s\"\n", n + 1, path)
+			continue
+		}
+		if (path ~ /\.c$/ && line ~ /^#define [A-Za-z_]/) {
+			name = line
+			sub(/^#define /, "", name)
+			sub(/[^A-Za-z0-9_].*/, "", name)
+			if (index(" " macros " ", " " name " ") == 0)
+				macros = macros " " name
+		}
+		print line
+	}
+	close(path)
+	m = split(macros, list, " ")
+	for (i = 1; i <= m; i++)
+		printf("#undef %s\n", list[i])
+}
+
+BEGIN {
+	printf("/* generated by amalg.awk */\n\n/*\n")
+	while ((getline line < "LICENSE") > 0)
+		print(line == "" ? " *" : " * " line)
+	printf(" */\n")
+	if (headers != "") {
+		split(headers, h, " ")
+		for (i in h)
+			seen[h[i]] = 1
+		printf("#include \"purehtml.h\"\n")
+	} else
+		printf("#ifndef PUREHTML_AMALG_H\n#define PUREHTML_AMALG_H\n")
+	for (i = 1; i < ARGC; i++) {
+		if (ARGV[i] in seen)
+			continue
+		seen[ARGV[i]] = 1
+		emit(ARGV[i])
+	}
+	if (headers == "")
+		printf("#endif\n")
+	exit
+}
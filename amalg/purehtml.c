@@ -0,0 +1,10027 @@
+/* generated by amalg.awk */
+
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include "purehtml.h"
+#line 1 "attr.c"
+
+#line 20 "attr.c"
+#line 21 "attr.c"
+#line 22 "attr.c"
+
+#include <stdlib.h>
+#include <string.h>
+#include <err.h>
+#include <assert.h>
+#include <strings.h>
+#include <ctype.h>
+
+#line 1 "attrs.c"
+/* generated by attrs.awk */
+static const struct attr_map attr_map[] = {
+	{ NULL, 0 }, /* 0 */
+	{ NULL, 0 }, /* 1 */
+	{ NULL, 0 }, /* 2 */
+	{ "accesskey", ATTR_FLAG_GLOBAL }, /* 3 */
+	{ NULL, 0 }, /* 4 */
+	{ NULL, 0 }, /* 5 */
+	{ NULL, 0 }, /* 6 */
+	{ NULL, 0 }, /* 7 */
+	{ NULL, 0 }, /* 8 */
+	{ NULL, 0 }, /* 9 */
+	{ NULL, 0 }, /* 10 */
+	{ NULL, 0 }, /* 11 */
+	{ NULL, 0 }, /* 12 */
+	{ NULL, 0 }, /* 13 */
+	{ NULL, 0 }, /* 14 */
+	{ NULL, 0 }, /* 15 */
+	{ NULL, 0 }, /* 16 */
+	{ "required", 0 }, /* 17 */
+	{ NULL, 0 }, /* 18 */
+	{ NULL, 0 }, /* 19 */
+	{ NULL, 0 }, /* 20 */
+	{ NULL, 0 }, /* 21 */
+	{ NULL, 0 }, /* 22 */
+	{ NULL, 0 }, /* 23 */
+	{ NULL, 0 }, /* 24 */
+	{ NULL, 0 }, /* 25 */
+	{ NULL, 0 }, /* 26 */
+	{ NULL, 0 }, /* 27 */
+	{ NULL, 0 }, /* 28 */
+	{ "id", ATTR_FLAG_GLOBAL }, /* 29 */
+	{ "onkeydown", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 30 */
+	{ NULL, 0 }, /* 31 */
+	{ NULL, 0 }, /* 32 */
+	{ "onauxclick", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 33 */
+	{ NULL, 0 }, /* 34 */
+	{ NULL, 0 }, /* 35 */
+	{ NULL, 0 }, /* 36 */
+	{ NULL, 0 }, /* 37 */
+	{ NULL, 0 }, /* 38 */
+	{ NULL, 0 }, /* 39 */
+	{ NULL, 0 }, /* 40 */
+	{ NULL, 0 }, /* 41 */
+	{ NULL, 0 }, /* 42 */
+	{ NULL, 0 }, /* 43 */
+	{ NULL, 0 }, /* 44 */
+	{ NULL, 0 }, /* 45 */
+	{ NULL, 0 }, /* 46 */
+	{ NULL, 0 }, /* 47 */
+	{ NULL, 0 }, /* 48 */
+	{ NULL, 0 }, /* 49 */
+	{ "slot", ATTR_FLAG_GLOBAL }, /* 50 */
+	{ NULL, 0 }, /* 51 */
+	{ NULL, 0 }, /* 52 */
+	{ NULL, 0 }, /* 53 */
+	{ NULL, 0 }, /* 54 */
+	{ NULL, 0 }, /* 55 */
+	{ NULL, 0 }, /* 56 */
+	{ NULL, 0 }, /* 57 */
+	{ NULL, 0 }, /* 58 */
+	{ NULL, 0 }, /* 59 */
+	{ NULL, 0 }, /* 60 */
+	{ NULL, 0 }, /* 61 */
+	{ NULL, 0 }, /* 62 */
+	{ NULL, 0 }, /* 63 */
+	{ NULL, 0 }, /* 64 */
+	{ NULL, 0 }, /* 65 */
+	{ NULL, 0 }, /* 66 */
+	{ NULL, 0 }, /* 67 */
+	{ NULL, 0 }, /* 68 */
+	{ NULL, 0 }, /* 69 */
+	{ NULL, 0 }, /* 70 */
+	{ NULL, 0 }, /* 71 */
+	{ "oncopy", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 72 */
+	{ "height", 0 }, /* 73 */
+	{ NULL, 0 }, /* 74 */
+	{ NULL, 0 }, /* 75 */
+	{ NULL, 0 }, /* 76 */
+	{ NULL, 0 }, /* 77 */
+	{ NULL, 0 }, /* 78 */
+	{ NULL, 0 }, /* 79 */
+	{ NULL, 0 }, /* 80 */
+	{ NULL, 0 }, /* 81 */
+	{ NULL, 0 }, /* 82 */
+	{ NULL, 0 }, /* 83 */
+	{ NULL, 0 }, /* 84 */
+	{ NULL, 0 }, /* 85 */
+	{ NULL, 0 }, /* 86 */
+	{ NULL, 0 }, /* 87 */
+	{ NULL, 0 }, /* 88 */
+	{ NULL, 0 }, /* 89 */
+	{ NULL, 0 }, /* 90 */
+	{ NULL, 0 }, /* 91 */
+	{ NULL, 0 }, /* 92 */
+	{ "onemptied", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 93 */
+	{ NULL, 0 }, /* 94 */
+	{ NULL, 0 }, /* 95 */
+	{ NULL, 0 }, /* 96 */
+	{ NULL, 0 }, /* 97 */
+	{ NULL, 0 }, /* 98 */
+	{ NULL, 0 }, /* 99 */
+	{ NULL, 0 }, /* 100 */
+	{ NULL, 0 }, /* 101 */
+	{ NULL, 0 }, /* 102 */
+	{ NULL, 0 }, /* 103 */
+	{ "onwaiting", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 104 */
+	{ NULL, 0 }, /* 105 */
+	{ NULL, 0 }, /* 106 */
+	{ NULL, 0 }, /* 107 */
+	{ NULL, 0 }, /* 108 */
+	{ NULL, 0 }, /* 109 */
+	{ NULL, 0 }, /* 110 */
+	{ NULL, 0 }, /* 111 */
+	{ NULL, 0 }, /* 112 */
+	{ NULL, 0 }, /* 113 */
+	{ NULL, 0 }, /* 114 */
+	{ NULL, 0 }, /* 115 */
+	{ NULL, 0 }, /* 116 */
+	{ NULL, 0 }, /* 117 */
+	{ NULL, 0 }, /* 118 */
+	{ NULL, 0 }, /* 119 */
+	{ NULL, 0 }, /* 120 */
+	{ NULL, 0 }, /* 121 */
+	{ NULL, 0 }, /* 122 */
+	{ "onformdata", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 123 */
+	{ "size", 0 } /* jump 1 */, /* 124 */
+	{ NULL, 0 }, /* 125 */
+	{ NULL, 0 }, /* 126 */
+	{ NULL, 0 }, /* 127 */
+	{ NULL, 0 }, /* 128 */
+	{ NULL, 0 }, /* 129 */
+	{ NULL, 0 }, /* 130 */
+	{ NULL, 0 }, /* 131 */
+	{ NULL, 0 }, /* 132 */
+	{ NULL, 0 }, /* 133 */
+	{ NULL, 0 }, /* 134 */
+	{ NULL, 0 }, /* 135 */
+	{ NULL, 0 }, /* 136 */
+	{ NULL, 0 }, /* 137 */
+	{ NULL, 0 }, /* 138 */
+	{ NULL, 0 }, /* 139 */
+	{ NULL, 0 }, /* 140 */
+	{ NULL, 0 }, /* 141 */
+	{ NULL, 0 }, /* 142 */
+	{ NULL, 0 }, /* 143 */
+	{ NULL, 0 }, /* 144 */
+	{ NULL, 0 }, /* 145 */
+	{ NULL, 0 }, /* 146 */
+	{ NULL, 0 }, /* 147 */
+	{ "is", ATTR_FLAG_GLOBAL }, /* 148 */
+	{ NULL, 0 }, /* 149 */
+	{ NULL, 0 }, /* 150 */
+	{ NULL, 0 }, /* 151 */
+	{ NULL, 0 }, /* 152 */
+	{ NULL, 0 }, /* 153 */
+	{ NULL, 0 }, /* 154 */
+	{ NULL, 0 }, /* 155 */
+	{ NULL, 0 }, /* 156 */
+	{ NULL, 0 }, /* 157 */
+	{ "class", ATTR_FLAG_GLOBAL }, /* 158 */
+	{ NULL, 0 }, /* 159 */
+	{ NULL, 0 }, /* 160 */
+	{ NULL, 0 }, /* 161 */
+	{ NULL, 0 }, /* 162 */
+	{ NULL, 0 }, /* 163 */
+	{ NULL, 0 }, /* 164 */
+	{ NULL, 0 }, /* 165 */
+	{ NULL, 0 }, /* 166 */
+	{ NULL, 0 }, /* 167 */
+	{ NULL, 0 }, /* 168 */
+	{ "ondragstart", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 169 */
+	{ NULL, 0 }, /* 170 */
+	{ NULL, 0 }, /* 171 */
+	{ NULL, 0 }, /* 172 */
+	{ "oncanplay", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 173 */
+	{ NULL, 0 }, /* 174 */
+	{ "onloadedmetadata", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 175 */
+	{ NULL, 0 }, /* 176 */
+	{ NULL, 0 }, /* 177 */
+	{ NULL, 0 }, /* 178 */
+	{ NULL, 0 }, /* 179 */
+	{ "oncontextlost", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 180 */
+	{ "list", 0 } /* jump 1 */, /* 181 */
+	{ NULL, 0 }, /* 182 */
+	{ NULL, 0 }, /* 183 */
+	{ NULL, 0 }, /* 184 */
+	{ NULL, 0 }, /* 185 */
+	{ "title", ATTR_FLAG_GLOBAL }, /* 186 */
+	{ NULL, 0 }, /* 187 */
+	{ NULL, 0 }, /* 188 */
+	{ "onbeforematch", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 189 */
+	{ "readonly", 0 }, /* 190 */
+	{ NULL, 0 }, /* 191 */
+	{ NULL, 0 }, /* 192 */
+	{ NULL, 0 }, /* 193 */
+	{ NULL, 0 }, /* 194 */
+	{ "onpause", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 195 */
+	{ NULL, 0 }, /* 196 */
+	{ NULL, 0 }, /* 197 */
+	{ NULL, 0 }, /* 198 */
+	{ NULL, 0 }, /* 199 */
+	{ NULL, 0 }, /* 200 */
+	{ NULL, 0 }, /* 201 */
+	{ NULL, 0 }, /* 202 */
+	{ NULL, 0 }, /* 203 */
+	{ NULL, 0 }, /* 204 */
+	{ "decoding", 0 }, /* 205 */
+	{ "onstalled", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 206 */
+	{ NULL, 0 }, /* 207 */
+	{ NULL, 0 }, /* 208 */
+	{ NULL, 0 }, /* 209 */
+	{ "onblur", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 210 */
+	{ "onmouseover", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT } /* jump 1 */, /* 211 */
+	{ NULL, 0 }, /* 212 */
+	{ NULL, 0 }, /* 213 */
+	{ NULL, 0 }, /* 214 */
+	{ NULL, 0 }, /* 215 */
+	{ NULL, 0 }, /* 216 */
+	{ NULL, 0 }, /* 217 */
+	{ "ondragend", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 218 */
+	{ NULL, 0 }, /* 219 */
+	{ NULL, 0 }, /* 220 */
+	{ NULL, 0 }, /* 221 */
+	{ NULL, 0 }, /* 222 */
+	{ NULL, 0 }, /* 223 */
+	{ NULL, 0 }, /* 224 */
+	{ NULL, 0 }, /* 225 */
+	{ NULL, 0 }, /* 226 */
+	{ "onclick", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 227 */
+	{ NULL, 0 }, /* 228 */
+	{ "referrerpolicy", 0 }, /* 229 */
+	{ NULL, 0 }, /* 230 */
+	{ NULL, 0 }, /* 231 */
+	{ NULL, 0 }, /* 232 */
+	{ NULL, 0 }, /* 233 */
+	{ NULL, 0 }, /* 234 */
+	{ NULL, 0 }, /* 235 */
+	{ NULL, 0 }, /* 236 */
+	{ NULL, 0 }, /* 237 */
+	{ NULL, 0 }, /* 238 */
+	{ NULL, 0 }, /* 239 */
+	{ NULL, 0 }, /* 240 */
+	{ NULL, 0 }, /* 241 */
+	{ NULL, 0 }, /* 242 */
+	{ NULL, 0 }, /* 243 */
+	{ NULL, 0 }, /* 244 */
+	{ NULL, 0 }, /* 245 */
+	{ NULL, 0 }, /* 246 */
+	{ NULL, 0 }, /* 247 */
+	{ NULL, 0 }, /* 248 */
+	{ NULL, 0 }, /* 249 */
+	{ NULL, 0 }, /* 250 */
+	{ NULL, 0 }, /* 251 */
+	{ NULL, 0 }, /* 252 */
+	{ NULL, 0 }, /* 253 */
+	{ NULL, 0 }, /* 254 */
+	{ NULL, 0 }, /* 255 */
+	{ NULL, 0 }, /* 256 */
+	{ NULL, 0 }, /* 257 */
+	{ "inert", ATTR_FLAG_GLOBAL }, /* 258 */
+	{ NULL, 0 }, /* 259 */
+	{ NULL, 0 }, /* 260 */
+	{ NULL, 0 }, /* 261 */
+	{ NULL, 0 }, /* 262 */
+	{ NULL, 0 }, /* 263 */
+	{ NULL, 0 }, /* 264 */
+	{ NULL, 0 }, /* 265 */
+	{ NULL, 0 }, /* 266 */
+	{ NULL, 0 }, /* 267 */
+	{ NULL, 0 }, /* 268 */
+	{ NULL, 0 }, /* 269 */
+	{ NULL, 0 }, /* 270 */
+	{ NULL, 0 }, /* 271 */
+	{ NULL, 0 }, /* 272 */
+	{ "name", 0 }, /* 273 */
+	{ NULL, 0 }, /* 274 */
+	{ NULL, 0 }, /* 275 */
+	{ NULL, 0 }, /* 276 */
+	{ NULL, 0 }, /* 277 */
+	{ NULL, 0 }, /* 278 */
+	{ NULL, 0 }, /* 279 */
+	{ NULL, 0 }, /* 280 */
+	{ NULL, 0 }, /* 281 */
+	{ NULL, 0 }, /* 282 */
+	{ "onvolumechange", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 283 */
+	{ NULL, 0 }, /* 284 */
+	{ NULL, 0 }, /* 285 */
+	{ "oncanplaythrough", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 286 */
+	{ "oncontextmenu", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 287 */
+	{ NULL, 0 }, /* 288 */
+	{ NULL, 0 }, /* 289 */
+	{ "onpaste", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 290 */
+	{ NULL, 0 }, /* 291 */
+	{ NULL, 0 }, /* 292 */
+	{ NULL, 0 }, /* 293 */
+	{ NULL, 0 }, /* 294 */
+	{ NULL, 0 }, /* 295 */
+	{ NULL, 0 }, /* 296 */
+	{ NULL, 0 }, /* 297 */
+	{ NULL, 0 }, /* 298 */
+	{ NULL, 0 }, /* 299 */
+	{ NULL, 0 }, /* 300 */
+	{ NULL, 0 }, /* 301 */
+	{ NULL, 0 }, /* 302 */
+	{ NULL, 0 }, /* 303 */
+	{ NULL, 0 }, /* 304 */
+	{ NULL, 0 }, /* 305 */
+	{ NULL, 0 }, /* 306 */
+	{ NULL, 0 }, /* 307 */
+	{ NULL, 0 }, /* 308 */
+	{ NULL, 0 }, /* 309 */
+	{ NULL, 0 }, /* 310 */
+	{ NULL, 0 }, /* 311 */
+	{ NULL, 0 }, /* 312 */
+	{ NULL, 0 }, /* 313 */
+	{ NULL, 0 }, /* 314 */
+	{ "onseeking", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 315 */
+	{ "usemap", 0 } /* jump 1 */, /* 316 */
+	{ NULL, 0 }, /* 317 */
+	{ "sizes", 0 }, /* 318 */
+	{ NULL, 0 }, /* 319 */
+	{ NULL, 0 }, /* 320 */
+	{ NULL, 0 }, /* 321 */
+	{ NULL, 0 }, /* 322 */
+	{ NULL, 0 }, /* 323 */
+	{ NULL, 0 }, /* 324 */
+	{ NULL, 0 }, /* 325 */
+	{ NULL, 0 }, /* 326 */
+	{ NULL, 0 }, /* 327 */
+	{ NULL, 0 }, /* 328 */
+	{ NULL, 0 }, /* 329 */
+	{ NULL, 0 }, /* 330 */
+	{ NULL, 0 }, /* 331 */
+	{ NULL, 0 }, /* 332 */
+	{ "contenteditable", ATTR_FLAG_GLOBAL }, /* 333 */
+	{ NULL, 0 }, /* 334 */
+	{ NULL, 0 }, /* 335 */
+	{ NULL, 0 }, /* 336 */
+	{ NULL, 0 }, /* 337 */
+	{ NULL, 0 }, /* 338 */
+	{ NULL, 0 }, /* 339 */
+	{ NULL, 0 }, /* 340 */
+	{ NULL, 0 }, /* 341 */
+	{ NULL, 0 }, /* 342 */
+	{ NULL, 0 }, /* 343 */
+	{ NULL, 0 }, /* 344 */
+	{ NULL, 0 }, /* 345 */
+	{ NULL, 0 }, /* 346 */
+	{ NULL, 0 }, /* 347 */
+	{ NULL, 0 }, /* 348 */
+	{ NULL, 0 }, /* 349 */
+	{ NULL, 0 }, /* 350 */
+	{ NULL, 0 }, /* 351 */
+	{ NULL, 0 }, /* 352 */
+	{ NULL, 0 }, /* 353 */
+	{ NULL, 0 }, /* 354 */
+	{ NULL, 0 }, /* 355 */
+	{ NULL, 0 }, /* 356 */
+	{ NULL, 0 }, /* 357 */
+	{ NULL, 0 }, /* 358 */
+	{ "onerror", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 359 */
+	{ NULL, 0 }, /* 360 */
+	{ NULL, 0 }, /* 361 */
+	{ NULL, 0 }, /* 362 */
+	{ NULL, 0 }, /* 363 */
+	{ NULL, 0 }, /* 364 */
+	{ NULL, 0 }, /* 365 */
+	{ NULL, 0 }, /* 366 */
+	{ NULL, 0 }, /* 367 */
+	{ NULL, 0 }, /* 368 */
+	{ NULL, 0 }, /* 369 */
+	{ NULL, 0 }, /* 370 */
+	{ NULL, 0 }, /* 371 */
+	{ NULL, 0 }, /* 372 */
+	{ NULL, 0 }, /* 373 */
+	{ NULL, 0 }, /* 374 */
+	{ NULL, 0 }, /* 375 */
+	{ NULL, 0 }, /* 376 */
+	{ NULL, 0 }, /* 377 */
+	{ NULL, 0 }, /* 378 */
+	{ NULL, 0 }, /* 379 */
+	{ NULL, 0 }, /* 380 */
+	{ NULL, 0 }, /* 381 */
+	{ NULL, 0 }, /* 382 */
+	{ NULL, 0 }, /* 383 */
+	{ NULL, 0 }, /* 384 */
+	{ NULL, 0 }, /* 385 */
+	{ NULL, 0 }, /* 386 */
+	{ "onkeyup", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 387 */
+	{ NULL, 0 }, /* 388 */
+	{ NULL, 0 }, /* 389 */
+	{ NULL, 0 }, /* 390 */
+	{ "onratechange", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 391 */
+	{ NULL, 0 }, /* 392 */
+	{ "ondurationchange", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 393 */
+	{ NULL, 0 }, /* 394 */
+	{ NULL, 0 }, /* 395 */
+	{ NULL, 0 }, /* 396 */
+	{ NULL, 0 }, /* 397 */
+	{ NULL, 0 }, /* 398 */
+	{ NULL, 0 }, /* 399 */
+	{ NULL, 0 }, /* 400 */
+	{ NULL, 0 }, /* 401 */
+	{ NULL, 0 }, /* 402 */
+	{ "onclose", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 403 */
+	{ NULL, 0 }, /* 404 */
+	{ NULL, 0 }, /* 405 */
+	{ NULL, 0 }, /* 406 */
+	{ NULL, 0 }, /* 407 */
+	{ NULL, 0 }, /* 408 */
+	{ "style", ATTR_FLAG_GLOBAL }, /* 409 */
+	{ NULL, 0 }, /* 410 */
+	{ NULL, 0 }, /* 411 */
+	{ NULL, 0 }, /* 412 */
+	{ "onended", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 413 */
+	{ NULL, 0 }, /* 414 */
+	{ NULL, 0 }, /* 415 */
+	{ NULL, 0 }, /* 416 */
+	{ NULL, 0 }, /* 417 */
+	{ NULL, 0 }, /* 418 */
+	{ NULL, 0 }, /* 419 */
+	{ NULL, 0 }, /* 420 */
+	{ NULL, 0 }, /* 421 */
+	{ NULL, 0 }, /* 422 */
+	{ NULL, 0 }, /* 423 */
+	{ NULL, 0 }, /* 424 */
+	{ NULL, 0 }, /* 425 */
+	{ NULL, 0 }, /* 426 */
+	{ NULL, 0 }, /* 427 */
+	{ NULL, 0 }, /* 428 */
+	{ NULL, 0 }, /* 429 */
+	{ NULL, 0 }, /* 430 */
+	{ NULL, 0 }, /* 431 */
+	{ NULL, 0 }, /* 432 */
+	{ NULL, 0 }, /* 433 */
+	{ NULL, 0 }, /* 434 */
+	{ NULL, 0 }, /* 435 */
+	{ NULL, 0 }, /* 436 */
+	{ NULL, 0 }, /* 437 */
+	{ NULL, 0 }, /* 438 */
+	{ NULL, 0 }, /* 439 */
+	{ NULL, 0 }, /* 440 */
+	{ NULL, 0 }, /* 441 */
+	{ "onprogress", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 442 */
+	{ NULL, 0 }, /* 443 */
+	{ NULL, 0 }, /* 444 */
+	{ NULL, 0 }, /* 445 */
+	{ NULL, 0 }, /* 446 */
+	{ NULL, 0 }, /* 447 */
+	{ NULL, 0 }, /* 448 */
+	{ NULL, 0 }, /* 449 */
+	{ NULL, 0 }, /* 450 */
+	{ NULL, 0 }, /* 451 */
+	{ NULL, 0 }, /* 452 */
+	{ NULL, 0 }, /* 453 */
+	{ NULL, 0 }, /* 454 */
+	{ NULL, 0 }, /* 455 */
+	{ NULL, 0 }, /* 456 */
+	{ NULL, 0 }, /* 457 */
+	{ "autocomplete", 0 }, /* 458 */
+	{ NULL, 0 }, /* 459 */
+	{ NULL, 0 }, /* 460 */
+	{ NULL, 0 }, /* 461 */
+	{ NULL, 0 }, /* 462 */
+	{ NULL, 0 }, /* 463 */
+	{ NULL, 0 }, /* 464 */
+	{ NULL, 0 }, /* 465 */
+	{ NULL, 0 }, /* 466 */
+	{ NULL, 0 }, /* 467 */
+	{ NULL, 0 }, /* 468 */
+	{ NULL, 0 }, /* 469 */
+	{ NULL, 0 }, /* 470 */
+	{ NULL, 0 }, /* 471 */
+	{ "colspan", 0 }, /* 472 */
+	{ NULL, 0 }, /* 473 */
+	{ NULL, 0 }, /* 474 */
+	{ NULL, 0 }, /* 475 */
+	{ NULL, 0 }, /* 476 */
+	{ NULL, 0 }, /* 477 */
+	{ NULL, 0 }, /* 478 */
+	{ NULL, 0 }, /* 479 */
+	{ NULL, 0 }, /* 480 */
+	{ NULL, 0 }, /* 481 */
+	{ NULL, 0 }, /* 482 */
+	{ NULL, 0 }, /* 483 */
+	{ NULL, 0 }, /* 484 */
+	{ NULL, 0 }, /* 485 */
+	{ NULL, 0 }, /* 486 */
+	{ NULL, 0 }, /* 487 */
+	{ NULL, 0 }, /* 488 */
+	{ NULL, 0 }, /* 489 */
+	{ NULL, 0 }, /* 490 */
+	{ NULL, 0 }, /* 491 */
+	{ NULL, 0 }, /* 492 */
+	{ NULL, 0 }, /* 493 */
+	{ NULL, 0 }, /* 494 */
+	{ NULL, 0 }, /* 495 */
+	{ NULL, 0 }, /* 496 */
+	{ NULL, 0 }, /* 497 */
+	{ NULL, 0 }, /* 498 */
+	{ NULL, 0 }, /* 499 */
+	{ NULL, 0 }, /* 500 */
+	{ NULL, 0 }, /* 501 */
+	{ "spellcheck", ATTR_FLAG_GLOBAL }, /* 502 */
+	{ NULL, 0 }, /* 503 */
+	{ "ondragleave", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 504 */
+	{ NULL, 0 }, /* 505 */
+	{ NULL, 0 }, /* 506 */
+	{ "onplay", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 507 */
+	{ NULL, 0 }, /* 508 */
+	{ NULL, 0 }, /* 509 */
+	{ NULL, 0 }, /* 510 */
+	{ NULL, 0 }, /* 511 */
+	{ NULL, 0 }, /* 512 */
+	{ NULL, 0 }, /* 513 */
+	{ NULL, 0 }, /* 514 */
+	{ NULL, 0 }, /* 515 */
+	{ NULL, 0 }, /* 516 */
+	{ NULL, 0 }, /* 517 */
+	{ "pattern", 0 }, /* 518 */
+	{ NULL, 0 }, /* 519 */
+	{ NULL, 0 }, /* 520 */
+	{ NULL, 0 }, /* 521 */
+	{ NULL, 0 }, /* 522 */
+	{ "onkeypress", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 523 */
+	{ NULL, 0 }, /* 524 */
+	{ "onmousemove", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 525 */
+	{ NULL, 0 }, /* 526 */
+	{ NULL, 0 }, /* 527 */
+	{ NULL, 0 }, /* 528 */
+	{ NULL, 0 }, /* 529 */
+	{ NULL, 0 }, /* 530 */
+	{ NULL, 0 }, /* 531 */
+	{ NULL, 0 }, /* 532 */
+	{ NULL, 0 }, /* 533 */
+	{ NULL, 0 }, /* 534 */
+	{ NULL, 0 }, /* 535 */
+	{ NULL, 0 }, /* 536 */
+	{ "oncut", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 537 */
+	{ NULL, 0 }, /* 538 */
+	{ NULL, 0 }, /* 539 */
+	{ NULL, 0 }, /* 540 */
+	{ NULL, 0 }, /* 541 */
+	{ NULL, 0 }, /* 542 */
+	{ NULL, 0 }, /* 543 */
+	{ NULL, 0 }, /* 544 */
+	{ NULL, 0 }, /* 545 */
+	{ NULL, 0 }, /* 546 */
+	{ NULL, 0 }, /* 547 */
+	{ NULL, 0 }, /* 548 */
+	{ NULL, 0 }, /* 549 */
+	{ NULL, 0 }, /* 550 */
+	{ "ontoggle", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 551 */
+	{ NULL, 0 }, /* 552 */
+	{ NULL, 0 }, /* 553 */
+	{ NULL, 0 }, /* 554 */
+	{ NULL, 0 }, /* 555 */
+	{ NULL, 0 }, /* 556 */
+	{ NULL, 0 }, /* 557 */
+	{ NULL, 0 }, /* 558 */
+	{ NULL, 0 }, /* 559 */
+	{ "dirname", 0 }, /* 560 */
+	{ NULL, 0 }, /* 561 */
+	{ NULL, 0 }, /* 562 */
+	{ NULL, 0 }, /* 563 */
+	{ NULL, 0 }, /* 564 */
+	{ NULL, 0 }, /* 565 */
+	{ NULL, 0 }, /* 566 */
+	{ NULL, 0 }, /* 567 */
+	{ NULL, 0 }, /* 568 */
+	{ NULL, 0 }, /* 569 */
+	{ NULL, 0 }, /* 570 */
+	{ NULL, 0 }, /* 571 */
+	{ NULL, 0 }, /* 572 */
+	{ NULL, 0 }, /* 573 */
+	{ NULL, 0 }, /* 574 */
+	{ NULL, 0 }, /* 575 */
+	{ "onbeforeinput", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 576 */
+	{ NULL, 0 }, /* 577 */
+	{ NULL, 0 }, /* 578 */
+	{ NULL, 0 }, /* 579 */
+	{ NULL, 0 }, /* 580 */
+	{ NULL, 0 }, /* 581 */
+	{ NULL, 0 }, /* 582 */
+	{ NULL, 0 }, /* 583 */
+	{ NULL, 0 }, /* 584 */
+	{ NULL, 0 }, /* 585 */
+	{ NULL, 0 }, /* 586 */
+	{ NULL, 0 }, /* 587 */
+	{ NULL, 0 }, /* 588 */
+	{ "ondblclick", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 589 */
+	{ "onseeked", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 590 */
+	{ NULL, 0 }, /* 591 */
+	{ NULL, 0 }, /* 592 */
+	{ NULL, 0 }, /* 593 */
+	{ NULL, 0 }, /* 594 */
+	{ NULL, 0 }, /* 595 */
+	{ "oninvalid", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 596 */
+	{ NULL, 0 }, /* 597 */
+	{ NULL, 0 }, /* 598 */
+	{ NULL, 0 }, /* 599 */
+	{ NULL, 0 }, /* 600 */
+	{ NULL, 0 }, /* 601 */
+	{ NULL, 0 }, /* 602 */
+	{ "onmouseup", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 603 */
+	{ NULL, 0 }, /* 604 */
+	{ NULL, 0 }, /* 605 */
+	{ "max", 0 }, /* 606 */
+	{ "tabindex", ATTR_FLAG_GLOBAL }, /* 607 */
+	{ NULL, 0 }, /* 608 */
+	{ NULL, 0 }, /* 609 */
+	{ NULL, 0 }, /* 610 */
+	{ NULL, 0 }, /* 611 */
+	{ NULL, 0 }, /* 612 */
+	{ NULL, 0 }, /* 613 */
+	{ NULL, 0 }, /* 614 */
+	{ NULL, 0 }, /* 615 */
+	{ NULL, 0 }, /* 616 */
+	{ "alt", 0 }, /* 617 */
+	{ NULL, 0 }, /* 618 */
+	{ "placeholder", 0 }, /* 619 */
+	{ "multiple", 0 }, /* 620 */
+	{ NULL, 0 }, /* 621 */
+	{ NULL, 0 }, /* 622 */
+	{ NULL, 0 }, /* 623 */
+	{ "onreset", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 624 */
+	{ NULL, 0 }, /* 625 */
+	{ NULL, 0 }, /* 626 */
+	{ NULL, 0 }, /* 627 */
+	{ NULL, 0 }, /* 628 */
+	{ NULL, 0 }, /* 629 */
+	{ NULL, 0 }, /* 630 */
+	{ NULL, 0 }, /* 631 */
+	{ NULL, 0 }, /* 632 */
+	{ NULL, 0 }, /* 633 */
+	{ NULL, 0 }, /* 634 */
+	{ NULL, 0 }, /* 635 */
+	{ NULL, 0 }, /* 636 */
+	{ NULL, 0 }, /* 637 */
+	{ NULL, 0 }, /* 638 */
+	{ NULL, 0 }, /* 639 */
+	{ NULL, 0 }, /* 640 */
+	{ "ondragenter", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 641 */
+	{ "type", 0 }, /* 642 */
+	{ NULL, 0 }, /* 643 */
+	{ NULL, 0 }, /* 644 */
+	{ NULL, 0 }, /* 645 */
+	{ NULL, 0 }, /* 646 */
+	{ NULL, 0 }, /* 647 */
+	{ NULL, 0 }, /* 648 */
+	{ NULL, 0 }, /* 649 */
+	{ "oncontextrestored", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 650 */
+	{ NULL, 0 }, /* 651 */
+	{ NULL, 0 }, /* 652 */
+	{ "oninput", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 653 */
+	{ NULL, 0 }, /* 654 */
+	{ NULL, 0 }, /* 655 */
+	{ NULL, 0 }, /* 656 */
+	{ NULL, 0 }, /* 657 */
+	{ NULL, 0 }, /* 658 */
+	{ NULL, 0 }, /* 659 */
+	{ NULL, 0 }, /* 660 */
+	{ NULL, 0 }, /* 661 */
+	{ NULL, 0 }, /* 662 */
+	{ "onresize", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 663 */
+	{ NULL, 0 }, /* 664 */
+	{ NULL, 0 }, /* 665 */
+	{ NULL, 0 }, /* 666 */
+	{ NULL, 0 }, /* 667 */
+	{ NULL, 0 }, /* 668 */
+	{ NULL, 0 }, /* 669 */
+	{ "translate", ATTR_FLAG_GLOBAL }, /* 670 */
+	{ NULL, 0 }, /* 671 */
+	{ NULL, 0 }, /* 672 */
+	{ NULL, 0 }, /* 673 */
+	{ NULL, 0 }, /* 674 */
+	{ NULL, 0 }, /* 675 */
+	{ NULL, 0 }, /* 676 */
+	{ NULL, 0 }, /* 677 */
+	{ NULL, 0 }, /* 678 */
+	{ NULL, 0 }, /* 679 */
+	{ NULL, 0 }, /* 680 */
+	{ NULL, 0 }, /* 681 */
+	{ "onwheel", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 682 */
+	{ NULL, 0 }, /* 683 */
+	{ NULL, 0 }, /* 684 */
+	{ NULL, 0 }, /* 685 */
+	{ NULL, 0 }, /* 686 */
+	{ NULL, 0 }, /* 687 */
+	{ NULL, 0 }, /* 688 */
+	{ NULL, 0 }, /* 689 */
+	{ NULL, 0 }, /* 690 */
+	{ NULL, 0 }, /* 691 */
+	{ NULL, 0 }, /* 692 */
+	{ NULL, 0 }, /* 693 */
+	{ NULL, 0 }, /* 694 */
+	{ NULL, 0 }, /* 695 */
+	{ NULL, 0 }, /* 696 */
+	{ NULL, 0 }, /* 697 */
+	{ NULL, 0 }, /* 698 */
+	{ NULL, 0 }, /* 699 */
+	{ NULL, 0 }, /* 700 */
+	{ NULL, 0 }, /* 701 */
+	{ NULL, 0 }, /* 702 */
+	{ NULL, 0 }, /* 703 */
+	{ NULL, 0 }, /* 704 */
+	{ NULL, 0 }, /* 705 */
+	{ NULL, 0 }, /* 706 */
+	{ "oncancel", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 707 */
+	{ "hidden", ATTR_FLAG_GLOBAL }, /* 708 */
+	{ NULL, 0 }, /* 709 */
+	{ NULL, 0 }, /* 710 */
+	{ NULL, 0 }, /* 711 */
+	{ NULL, 0 }, /* 712 */
+	{ NULL, 0 }, /* 713 */
+	{ "ismap", 0 }, /* 714 */
+	{ NULL, 0 }, /* 715 */
+	{ "onscroll", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 716 */
+	{ NULL, 0 }, /* 717 */
+	{ NULL, 0 }, /* 718 */
+	{ "ontimeupdate", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 719 */
+	{ "maxlength", 0 }, /* 720 */
+	{ NULL, 0 }, /* 721 */
+	{ "onsecuritypolicyviolation", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 722 */
+	{ NULL, 0 }, /* 723 */
+	{ NULL, 0 }, /* 724 */
+	{ NULL, 0 }, /* 725 */
+	{ NULL, 0 }, /* 726 */
+	{ NULL, 0 }, /* 727 */
+	{ NULL, 0 }, /* 728 */
+	{ NULL, 0 }, /* 729 */
+	{ NULL, 0 }, /* 730 */
+	{ NULL, 0 }, /* 731 */
+	{ "itemref", ATTR_FLAG_GLOBAL }, /* 732 */
+	{ NULL, 0 }, /* 733 */
+	{ NULL, 0 }, /* 734 */
+	{ NULL, 0 }, /* 735 */
+	{ NULL, 0 }, /* 736 */
+	{ NULL, 0 }, /* 737 */
+	{ NULL, 0 }, /* 738 */
+	{ NULL, 0 }, /* 739 */
+	{ NULL, 0 }, /* 740 */
+	{ NULL, 0 }, /* 741 */
+	{ NULL, 0 }, /* 742 */
+	{ NULL, 0 }, /* 743 */
+	{ "width", 0 }, /* 744 */
+	{ NULL, 0 }, /* 745 */
+	{ NULL, 0 }, /* 746 */
+	{ NULL, 0 }, /* 747 */
+	{ "min", 0 }, /* 748 */
+	{ NULL, 0 }, /* 749 */
+	{ NULL, 0 }, /* 750 */
+	{ NULL, 0 }, /* 751 */
+	{ NULL, 0 }, /* 752 */
+	{ NULL, 0 }, /* 753 */
+	{ NULL, 0 }, /* 754 */
+	{ NULL, 0 }, /* 755 */
+	{ NULL, 0 }, /* 756 */
+	{ "onfocus", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 757 */
+	{ NULL, 0 }, /* 758 */
+	{ NULL, 0 }, /* 759 */
+	{ "disabled", 0 }, /* 760 */
+	{ NULL, 0 }, /* 761 */
+	{ NULL, 0 }, /* 762 */
+	{ NULL, 0 }, /* 763 */
+	{ NULL, 0 }, /* 764 */
+	{ NULL, 0 }, /* 765 */
+	{ NULL, 0 }, /* 766 */
+	{ "dir", ATTR_FLAG_GLOBAL }, /* 767 */
+	{ NULL, 0 }, /* 768 */
+	{ "draggable", ATTR_FLAG_GLOBAL }, /* 769 */
+	{ "crossorigin", 0 }, /* 770 */
+	{ NULL, 0 }, /* 771 */
+	{ NULL, 0 }, /* 772 */
+	{ NULL, 0 }, /* 773 */
+	{ NULL, 0 }, /* 774 */
+	{ NULL, 0 }, /* 775 */
+	{ "src", 0 }, /* 776 */
+	{ NULL, 0 }, /* 777 */
+	{ NULL, 0 }, /* 778 */
+	{ NULL, 0 }, /* 779 */
+	{ NULL, 0 }, /* 780 */
+	{ NULL, 0 }, /* 781 */
+	{ NULL, 0 }, /* 782 */
+	{ NULL, 0 }, /* 783 */
+	{ NULL, 0 }, /* 784 */
+	{ NULL, 0 }, /* 785 */
+	{ NULL, 0 }, /* 786 */
+	{ NULL, 0 }, /* 787 */
+	{ NULL, 0 }, /* 788 */
+	{ NULL, 0 }, /* 789 */
+	{ NULL, 0 }, /* 790 */
+	{ NULL, 0 }, /* 791 */
+	{ "itemprop", ATTR_FLAG_GLOBAL }, /* 792 */
+	{ NULL, 0 }, /* 793 */
+	{ NULL, 0 }, /* 794 */
+	{ NULL, 0 }, /* 795 */
+	{ NULL, 0 }, /* 796 */
+	{ NULL, 0 }, /* 797 */
+	{ NULL, 0 }, /* 798 */
+	{ NULL, 0 }, /* 799 */
+	{ NULL, 0 }, /* 800 */
+	{ "onplaying", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 801 */
+	{ NULL, 0 }, /* 802 */
+	{ "onmouseleave", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 803 */
+	{ "rel", 0 } /* jump 1 */, /* 804 */
+	{ NULL, 0 }, /* 805 */
+	{ NULL, 0 }, /* 806 */
+	{ NULL, 0 }, /* 807 */
+	{ NULL, 0 }, /* 808 */
+	{ NULL, 0 }, /* 809 */
+	{ NULL, 0 }, /* 810 */
+	{ NULL, 0 }, /* 811 */
+	{ NULL, 0 }, /* 812 */
+	{ NULL, 0 }, /* 813 */
+	{ NULL, 0 }, /* 814 */
+	{ NULL, 0 }, /* 815 */
+	{ "oncuechange", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 816 */
+	{ NULL, 0 }, /* 817 */
+	{ "rowspan", 0 }, /* 818 */
+	{ NULL, 0 }, /* 819 */
+	{ NULL, 0 }, /* 820 */
+	{ NULL, 0 }, /* 821 */
+	{ "onmouseout", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 822 */
+	{ NULL, 0 }, /* 823 */
+	{ NULL, 0 }, /* 824 */
+	{ "itemtype", ATTR_FLAG_GLOBAL }, /* 825 */
+	{ NULL, 0 }, /* 826 */
+	{ "onloadstart", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 827 */
+	{ "srcset", 0 }, /* 828 */
+	{ NULL, 0 }, /* 829 */
+	{ NULL, 0 }, /* 830 */
+	{ NULL, 0 }, /* 831 */
+	{ NULL, 0 }, /* 832 */
+	{ "autofocus", ATTR_FLAG_GLOBAL }, /* 833 */
+	{ NULL, 0 }, /* 834 */
+	{ NULL, 0 }, /* 835 */
+	{ NULL, 0 }, /* 836 */
+	{ NULL, 0 }, /* 837 */
+	{ NULL, 0 }, /* 838 */
+	{ NULL, 0 }, /* 839 */
+	{ "onloadeddata", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 840 */
+	{ NULL, 0 }, /* 841 */
+	{ NULL, 0 }, /* 842 */
+	{ NULL, 0 }, /* 843 */
+	{ NULL, 0 }, /* 844 */
+	{ NULL, 0 }, /* 845 */
+	{ NULL, 0 }, /* 846 */
+	{ NULL, 0 }, /* 847 */
+	{ NULL, 0 }, /* 848 */
+	{ NULL, 0 }, /* 849 */
+	{ NULL, 0 }, /* 850 */
+	{ NULL, 0 }, /* 851 */
+	{ NULL, 0 }, /* 852 */
+	{ NULL, 0 }, /* 853 */
+	{ NULL, 0 }, /* 854 */
+	{ NULL, 0 }, /* 855 */
+	{ NULL, 0 }, /* 856 */
+	{ NULL, 0 }, /* 857 */
+	{ NULL, 0 }, /* 858 */
+	{ NULL, 0 }, /* 859 */
+	{ NULL, 0 }, /* 860 */
+	{ NULL, 0 }, /* 861 */
+	{ NULL, 0 }, /* 862 */
+	{ NULL, 0 }, /* 863 */
+	{ NULL, 0 }, /* 864 */
+	{ NULL, 0 }, /* 865 */
+	{ NULL, 0 }, /* 866 */
+	{ NULL, 0 }, /* 867 */
+	{ NULL, 0 }, /* 868 */
+	{ NULL, 0 }, /* 869 */
+	{ NULL, 0 }, /* 870 */
+	{ NULL, 0 }, /* 871 */
+	{ NULL, 0 }, /* 872 */
+	{ NULL, 0 }, /* 873 */
+	{ NULL, 0 }, /* 874 */
+	{ NULL, 0 }, /* 875 */
+	{ NULL, 0 }, /* 876 */
+	{ "inputmode", ATTR_FLAG_GLOBAL }, /* 877 */
+	{ NULL, 0 }, /* 878 */
+	{ NULL, 0 }, /* 879 */
+	{ NULL, 0 }, /* 880 */
+	{ NULL, 0 }, /* 881 */
+	{ NULL, 0 }, /* 882 */
+	{ NULL, 0 }, /* 883 */
+	{ NULL, 0 }, /* 884 */
+	{ NULL, 0 }, /* 885 */
+	{ "onmousedown", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 886 */
+	{ NULL, 0 }, /* 887 */
+	{ NULL, 0 }, /* 888 */
+	{ NULL, 0 }, /* 889 */
+	{ NULL, 0 }, /* 890 */
+	{ NULL, 0 }, /* 891 */
+	{ NULL, 0 }, /* 892 */
+	{ NULL, 0 }, /* 893 */
+	{ NULL, 0 }, /* 894 */
+	{ NULL, 0 }, /* 895 */
+	{ NULL, 0 }, /* 896 */
+	{ NULL, 0 }, /* 897 */
+	{ NULL, 0 }, /* 898 */
+	{ NULL, 0 }, /* 899 */
+	{ NULL, 0 }, /* 900 */
+	{ "onload", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 901 */
+	{ NULL, 0 }, /* 902 */
+	{ NULL, 0 }, /* 903 */
+	{ NULL, 0 }, /* 904 */
+	{ NULL, 0 }, /* 905 */
+	{ NULL, 0 }, /* 906 */
+	{ NULL, 0 }, /* 907 */
+	{ NULL, 0 }, /* 908 */
+	{ NULL, 0 }, /* 909 */
+	{ NULL, 0 }, /* 910 */
+	{ NULL, 0 }, /* 911 */
+	{ NULL, 0 }, /* 912 */
+	{ NULL, 0 }, /* 913 */
+	{ NULL, 0 }, /* 914 */
+	{ NULL, 0 }, /* 915 */
+	{ NULL, 0 }, /* 916 */
+	{ NULL, 0 }, /* 917 */
+	{ NULL, 0 }, /* 918 */
+	{ NULL, 0 }, /* 919 */
+	{ NULL, 0 }, /* 920 */
+	{ NULL, 0 }, /* 921 */
+	{ NULL, 0 }, /* 922 */
+	{ "content", 0 }, /* 923 */
+	{ NULL, 0 }, /* 924 */
+	{ NULL, 0 }, /* 925 */
+	{ NULL, 0 }, /* 926 */
+	{ NULL, 0 }, /* 927 */
+	{ NULL, 0 }, /* 928 */
+	{ "onsubmit", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 929 */
+	{ NULL, 0 }, /* 930 */
+	{ NULL, 0 }, /* 931 */
+	{ NULL, 0 }, /* 932 */
+	{ NULL, 0 }, /* 933 */
+	{ NULL, 0 }, /* 934 */
+	{ "autocapitalize", ATTR_FLAG_GLOBAL }, /* 935 */
+	{ NULL, 0 }, /* 936 */
+	{ NULL, 0 }, /* 937 */
+	{ "enterkeyhint", ATTR_FLAG_GLOBAL }, /* 938 */
+	{ NULL, 0 }, /* 939 */
+	{ "onmouseenter", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 940 */
+	{ "step", 0 } /* jump 1 */, /* 941 */
+	{ NULL, 0 }, /* 942 */
+	{ NULL, 0 }, /* 943 */
+	{ NULL, 0 }, /* 944 */
+	{ NULL, 0 }, /* 945 */
+	{ NULL, 0 }, /* 946 */
+	{ NULL, 0 }, /* 947 */
+	{ NULL, 0 }, /* 948 */
+	{ NULL, 0 }, /* 949 */
+	{ NULL, 0 }, /* 950 */
+	{ NULL, 0 }, /* 951 */
+	{ NULL, 0 }, /* 952 */
+	{ NULL, 0 }, /* 953 */
+	{ NULL, 0 }, /* 954 */
+	{ "onchange", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 955 */
+	{ NULL, 0 }, /* 956 */
+	{ NULL, 0 }, /* 957 */
+	{ "minlength", 0 }, /* 958 */
+	{ NULL, 0 }, /* 959 */
+	{ NULL, 0 }, /* 960 */
+	{ NULL, 0 }, /* 961 */
+	{ NULL, 0 }, /* 962 */
+	{ NULL, 0 }, /* 963 */
+	{ "itemid", ATTR_FLAG_GLOBAL }, /* 964 */
+	{ NULL, 0 }, /* 965 */
+	{ NULL, 0 }, /* 966 */
+	{ NULL, 0 }, /* 967 */
+	{ NULL, 0 }, /* 968 */
+	{ NULL, 0 }, /* 969 */
+	{ NULL, 0 }, /* 970 */
+	{ NULL, 0 }, /* 971 */
+	{ NULL, 0 }, /* 972 */
+	{ NULL, 0 }, /* 973 */
+	{ NULL, 0 }, /* 974 */
+	{ NULL, 0 }, /* 975 */
+	{ NULL, 0 }, /* 976 */
+	{ NULL, 0 }, /* 977 */
+	{ NULL, 0 }, /* 978 */
+	{ NULL, 0 }, /* 979 */
+	{ NULL, 0 }, /* 980 */
+	{ NULL, 0 }, /* 981 */
+	{ NULL, 0 }, /* 982 */
+	{ NULL, 0 }, /* 983 */
+	{ NULL, 0 }, /* 984 */
+	{ NULL, 0 }, /* 985 */
+	{ NULL, 0 }, /* 986 */
+	{ NULL, 0 }, /* 987 */
+	{ NULL, 0 }, /* 988 */
+	{ NULL, 0 }, /* 989 */
+	{ NULL, 0 }, /* 990 */
+	{ "onsuspend", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 991 */
+	{ NULL, 0 }, /* 992 */
+	{ NULL, 0 }, /* 993 */
+	{ NULL, 0 }, /* 994 */
+	{ "ondrag", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 995 */
+	{ NULL, 0 }, /* 996 */
+	{ NULL, 0 }, /* 997 */
+	{ NULL, 0 }, /* 998 */
+	{ NULL, 0 }, /* 999 */
+	{ NULL, 0 }, /* 1000 */
+	{ NULL, 0 }, /* 1001 */
+	{ NULL, 0 }, /* 1002 */
+	{ NULL, 0 }, /* 1003 */
+	{ NULL, 0 }, /* 1004 */
+	{ "onselect", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 1005 */
+	{ "onslotchange", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT } /* jump 1 */, /* 1006 */
+	{ "ondragover", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 1007 */
+	{ NULL, 0 }, /* 1008 */
+	{ "itemscope", ATTR_FLAG_GLOBAL }, /* 1009 */
+	{ "lang", ATTR_FLAG_GLOBAL }, /* 1010 */
+	{ "ondrop", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT } /* jump 1 */, /* 1011 */
+	{ "headers", 0 }, /* 1012 */
+	{ "href", 0 }, /* 1013 */
+	{ "loading", 0 }, /* 1014 */
+	{ NULL, 0 }, /* 1015 */
+	{ NULL, 0 }, /* 1016 */
+	{ NULL, 0 }, /* 1017 */
+	{ NULL, 0 }, /* 1018 */
+	{ "nonce", ATTR_FLAG_GLOBAL }, /* 1019 */
+	{ NULL, 0 }, /* 1020 */
+	{ NULL, 0 }, /* 1021 */
+	{ NULL, 0 }, /* 1022 */
+	{ NULL, 0 }, /* 1023 */
+};
+#line 31 "attr.c"
+
+#define ATTRMAP_SZ 1024
+
+const struct attr_map *
+attr_map_find(int i)
+{
+	assert(i >= 0 && i < ATTRMAP_SZ);
+	return &attr_map[i];
+}
+
+int
+attr_map_id(const char *s)
+{
+	static const int prime = 104729;
+	static const int modulo = 1048576;
+	size_t addr = 0;
+	const char *p = s;
+
+	while (*p != '\0') {
+		addr += *p++;
+		addr *= prime;
+		addr %= modulo;
+	}
+	addr %= ATTRMAP_SZ;
+	while (
+	    attr_map[addr].name != NULL &&
+	    strcmp(attr_map[addr].name, s) != 0) {
+		addr++;
+		addr %= ATTRMAP_SZ;
+	}
+	return addr;
+}
+
+struct attr *
+attr_get(struct attr *head, const char *name)
+{
+	struct attr *attr;
+
+	attr = head;
+	while (attr != NULL) {
+		if (attr->name != NULL && strcasecmp(attr->name, name) == 0)
+			return attr;
+		attr = attr->next;
+	}
+
+	return NULL;
+}
+
+size_t
+attr_size(struct attr *attr)
+{
+	size_t sum = 0;
+
+	while (attr != NULL) {
+		if (attr->name != NULL)
+			sum += strlen(attr->name);
+		if (attr->value != NULL)
+			sum += strlen(attr->value);
+
+		attr = attr->next;
+		sum += sizeof(struct attr);
+	}
+
+	return sum;
+}
+
+static struct attr *
+attr_new(struct attr **head)
+{
+	struct attr *attr;
+
+	attr = mem_calloc(1, sizeof(struct attr));
+	if (attr == NULL)
+		err(1, "calloc attr");
+	STATS_ADD(allocs[ALLOC_ATTR], 1);
+	attr->next = (*head);
+	*head = attr;
+	return attr;
+}
+
+/*
+ * An attribute of the pool if there is one, or a new one.
+ */
+static struct attr *
+attr_take(struct attr_index *index, struct attr **head)
+{
+	struct attr *attr;
+
+	if (index->pool == NULL || (attr = index->pool->free) == NULL)
+		return attr_new(head);
+
+	index->pool->free = attr->next;
+	attr->next = (*head);
+	*head = attr;
+	return attr;
+}
+
+/*
+ * Copy s to the buffer *p of *size bytes, replacing it if too small.
+ */
+static void
+attr_copy_str(char **p, size_t *size, const char *s)
+{
+	size_t len;
+
+	len = strlen(s) + 1;
+	if (len > *size) {
+		mem_free(*p);
+		if ((*p = mem_malloc(len)) == NULL)
+			err(1, "malloc attr");
+		STATS_ADD(allocs[ALLOC_ATTR], 1);
+		*size = len;
+	}
+	memcpy(*p, s, len);
+}
+
+static void
+attr_assign(struct attr *attr, const char *name, const char *value)
+{
+	attr_copy_str(&attr->name, &attr->name_size, name);
+
+	if (value != NULL)
+		attr_copy_str(&attr->value, &attr->value_size, value);
+	else {
+		mem_free(attr->value);
+		attr->value = NULL;
+		attr->value_size = 0;
+	}
+}
+
+void
+attr_set(struct attr **head, const char *name, const char *value)
+{
+	struct attr *attr;
+
+	assert(name != NULL && *name != '\0');
+
+	if ((attr = attr_get(*head, name)) == NULL)
+		attr = attr_new(head);
+	attr_assign(attr, name, value);
+}
+
+static size_t
+attr_hash(const char *name)
+{
+	size_t h;
+
+	h = 2166136261u;
+	while (*name != '\0') {
+		h ^= (unsigned char) tolower((unsigned char) *name++);
+		h *= 16777619u;
+	}
+	return h;
+}
+
+/*
+ * Slot of the given name, or the empty slot where it would go.
+ */
+static struct attr **
+attr_index_slot(struct attr_index *index, const char *name)
+{
+	size_t i;
+
+	i = attr_hash(name) & (index->alloc - 1);
+	while (index->slots[i] != NULL &&
+	    strcasecmp(index->slots[i]->name, name) != 0)
+		i = (i + 1) & (index->alloc - 1);
+	return &index->slots[i];
+}
+
+static void
+attr_index_build(struct attr_index *index, struct attr *head, size_t alloc)
+{
+	if (alloc != index->alloc) {
+		mem_free(index->slots);
+		index->alloc = alloc;
+		index->slots = mem_calloc(alloc, sizeof(struct attr *));
+		if (index->slots == NULL)
+			err(1, "calloc attr index");
+		STATS_ADD(allocs[ALLOC_ATTR], 1);
+	} else
+		memset(index->slots, 0, alloc * sizeof(struct attr *));
+
+	for (; head != NULL; head = head->next)
+		*attr_index_slot(index, head->name) = head;
+}
+
+/*
+ * Like attr_set() on a list that only gets attributes through the
+ * index until attr_index_clear().
+ */
+void
+attr_index_set(struct attr_index *index, struct attr **head,
+    const char *name, const char *value)
+{
+	struct attr **slot;
+	struct attr *attr;
+
+	assert(name != NULL && *name != '\0');
+
+	if (index->n < ATTR_INDEX_MIN) {
+		if ((attr = attr_get(*head, name)) == NULL) {
+			attr = attr_take(index, head);
+			index->n++;
+		}
+		attr_assign(attr, name, value);
+		if (index->n == ATTR_INDEX_MIN)
+			attr_index_build(index, *head, index->alloc ?
+			    index->alloc : ATTR_INDEX_MIN * 4);
+		return;
+	}
+
+	if (index->n * 2 >= index->alloc)
+		attr_index_build(index, *head, index->alloc * 2);
+	slot = attr_index_slot(index, name);
+	if (*slot == NULL) {
+		*slot = attr_take(index, head);
+		index->n++;
+	}
+	attr_assign(*slot, name, value);
+}
+
+void
+attr_index_clear(struct attr_index *index)
+{
+	if (index->n >= ATTR_INDEX_MIN)
+		memset(index->slots, 0, index->alloc * sizeof(struct attr *));
+	index->n = 0;
+}
+
+void
+attr_index_free(struct attr_index *index)
+{
+	mem_free(index->slots);
+	memset(index, 0, sizeof(struct attr_index));
+}
+
+/*
+ * Give back a list of attributes for attr_index_set() to take.
+ */
+void
+attr_pool_put(struct attr_pool *pool, struct attr *attr)
+{
+	struct attr *tail;
+
+	if (attr == NULL)
+		return;
+	for (tail = attr; tail->next != NULL; tail = tail->next)
+		;
+	tail->next = pool->free;
+	pool->free = attr;
+}
+
+/*
+ * The interned copy of a custom tag name, kept until attr_pool_free(),
+ * or NULL if the pool has no room for another one.
+ */
+char *
+attr_pool_name(struct attr_pool *pool, const char *name)
+{
+	struct attr *attr;
+
+	if (*name == '\0')
+		return NULL;
+	if (pool->index.n < ATTR_INDEX_MIN)
+		attr = attr_get(pool->names, name);
+	else
+		attr = *attr_index_slot(&pool->index, name);
+	if (attr != NULL)
+		return attr->name;
+
+	if (pool->index.n >= ATTR_POOL_NAMES)
+		return NULL;
+	attr_index_set(&pool->index, &pool->names, name, NULL);
+	return pool->names->name;
+}
+
+void
+attr_pool_free(struct attr_pool *pool)
+{
+	attr_free(pool->free);
+	attr_free(pool->names);
+	attr_index_free(&pool->index);
+	memset(pool, 0, sizeof(struct attr_pool));
+}
+
+int
+attr_has(struct attr *head, const char *name)
+{
+	if (attr_get(head, name) == NULL)
+		return 0;
+
+	return 1;
+}
+
+/*
+ * Deep copy of the list, preserving order.
+ */
+struct attr *
+attr_copy(struct attr *attr)
+{
+	struct attr *head;
+	struct attr **tail;
+
+	head = NULL;
+	tail = &head;
+	while (attr != NULL) {
+		*tail = mem_calloc(1, sizeof(struct attr));
+		if (*tail == NULL)
+			err(1, "calloc attr");
+		if (attr->name != NULL &&
+		    ((*tail)->name = mem_strdup(attr->name)) == NULL)
+			err(1, "strdup attr name");
+		if (attr->value != NULL &&
+		    ((*tail)->value = mem_strdup(attr->value)) == NULL)
+			err(1, "strdup attr value");
+		STATS_ADD(allocs[ALLOC_ATTR], 1 + (attr->name != NULL) +
+		    (attr->value != NULL));
+		tail = &(*tail)->next;
+		attr = attr->next;
+	}
+
+	return head;
+}
+
+void
+attr_free(struct attr *attr)
+{
+	struct attr *next;
+
+	while (attr != NULL) {
+		if (attr->name != NULL)
+			mem_free(attr->name);
+		if (attr->value != NULL)
+			mem_free(attr->value);
+		next = attr->next;
+		mem_free(attr);
+		attr = next;
+	}
+}
+
+#line 475 "attr.c"
+
+#line 544 "attr.c"
+#undef ATTRMAP_SZ
+#line 1 "document.c"
+
+#line 20 "document.c"
+#line 21 "document.c"
+#line 22 "document.c"
+
+#include <stdlib.h>
+#include <err.h>
+
+struct document *
+document_create(void)
+{
+	struct document	*document;
+
+	document = mem_calloc(1, sizeof(struct document));
+	if (document == NULL)
+		err(1, "calloc document");
+	STATS_ADD(allocs[ALLOC_DOCUMENT], 1);
+
+	return document;
+}
+#line 1 "dispatch.c"
+
+#line 20 "dispatch.c"
+#line 21 "dispatch.c"
+#line 22 "dispatch.c"
+#line 23 "dispatch.c"
+#line 24 "dispatch.c"
+#line 25 "dispatch.c"
+#line 26 "dispatch.c"
+#line 27 "dispatch.c"
+#line 28 "dispatch.c"
+#line 29 "dispatch.c"
+
+#include <stdlib.h>
+#include <assert.h>
+#include <err.h>
+#include <stdarg.h>
+#include <string.h>
+
+#line 37 "dispatch.c"
+
+struct elem_view {
+	struct node	node;
+	struct elem	elem;
+};
+
+static void clear_view(struct dispatcher *, struct elem *);
+static void insert_char(struct dispatcher *, struct token *);
+static void insert_close_tag(struct dispatcher *, struct token *);
+static void insert_token_set_mode(struct dispatcher *, struct token *, IMODE);
+static int insert_token_with_mode(struct dispatcher *, struct token *, IMODE);
+static struct elem *pop(struct dispatcher *);
+static void print_err(struct dispatcher *, struct token *, enum errors);
+static int skip_token(struct dispatcher *, struct token *);
+
+/* helper */
+int
+dispatch(struct dispatcher *ctx, struct token *token,
+    int (*begin)(struct node *), int (*end)(struct node *))
+{
+	int state;
+
+	ctx->begin = begin;
+	ctx->end = end;
+
+	if (ctx->stop)
+		return STATE_NONE;
+
+	if (ctx->skip != NULL)
+		return skip_token(ctx, token);
+
+	state = insert_token_with_mode(ctx, token, ctx->mode);
+	if (ctx->skip != NULL && ctx->skip_state == STATE_NONE) {
+		switch (state) {
+		case STATE_RCDATA:
+			ctx->skip_state = STATE_SKIP_RCDATA;
+			break;
+		case STATE_RAWTEXT:
+			ctx->skip_state = STATE_SKIP_RAWTEXT;
+			break;
+		case STATE_SCRIPT_DATA:
+			ctx->skip_state = STATE_SKIP_SCRIPT_DATA;
+			break;
+		default:
+			return state;
+		}
+		return ctx->skip_state;
+	}
+	return state;
+}
+
+/*
+ * Release what an element view took over from its token, giving the
+ * attributes back to the pool if there is one.
+ */
+static void
+clear_view(struct dispatcher *ctx, struct elem *elem)
+{
+	if (ctx->attr_pool != NULL) {
+		attr_pool_put(ctx->attr_pool, elem->attr);
+		elem->attr = NULL;
+	}
+	elem_clear(elem);
+}
+
+static void
+skip_end(struct dispatcher *ctx)
+{
+	ctx->skip = NULL;
+	ctx->skip_depth = 0;
+	ctx->skip_state = STATE_NONE;
+	ctx->skip_raw = 0;
+}
+
+/*
+ * The state insert_token_with_mode() switches the tokenizer to after
+ * the start tag of a raw text element, or STATE_NONE for the ones it
+ * leaves in the data state, such as textarea and noscript.
+ */
+int
+dispatch_raw_state(int tagid)
+{
+	switch (tagid) {
+	case TAG_TITLE:
+		return STATE_RCDATA;
+	case TAG_STYLE:
+	case TAG_NOFRAMES:
+		return STATE_RAWTEXT;
+	case TAG_SCRIPT:
+		return STATE_SCRIPT_DATA;
+	case TAG_PLAINTEXT:
+		return STATE_PLAINTEXT;
+	default:
+		return STATE_NONE;
+	}
+}
+
+/*
+ * The state the content of a skipped raw text element is tokenized in.
+ */
+static int
+skip_raw_state(int tagid)
+{
+	switch (dispatch_raw_state(tagid)) {
+	case STATE_RCDATA:
+		return STATE_SKIP_RCDATA;
+	case STATE_RAWTEXT:
+		return STATE_SKIP_RAWTEXT;
+	case STATE_SCRIPT_DATA:
+		return STATE_SKIP_SCRIPT_DATA;
+	default:
+		return dispatch_raw_state(tagid);
+	}
+}
+
+/*
+ * Release what is still held after parsing was stopped: the pending
+ * text and the elements left on the open elements stack. Callbacks
+ * are not called for these.
+ */
+void
+dispatch_unwind(struct dispatcher *ctx)
+{
+	struct elem *elem;
+
+	if (ctx->cdata != NULL) {
+		str_add(&ctx->cdata->data, '\0');
+		ctx->cdata = NULL;
+	}
+
+	while ((elem = ostack_pop(&ctx->ostack)) != NULL)
+		clear_view(ctx, elem);
+
+	skip_end(ctx);
+	ctx->head_elem = NULL;
+	ctx->pre_depth = 0;
+}
+
+/*
+ * Release everything held by the dispatcher.
+ */
+void
+dispatch_free(struct dispatcher *ctx)
+{
+	size_t i;
+
+	dispatch_unwind(ctx);
+
+	for (i = 0; i < ctx->views_alloc; i++)
+		mem_free(ctx->views[i]);
+	mem_free(ctx->views);
+	ctx->views = NULL;
+	ctx->views_alloc = 0;
+
+	ostack_free(&ctx->ostack);
+
+	mem_free(ctx->cdata_buf.data.s);
+	memset(&ctx->cdata_buf.data, 0, sizeof(struct str));
+}
+
+/*
+ * Minimal tree construction while the children of ctx->skip are being
+ * skipped: no nodes are built and we only count nesting of elements
+ * with the same name. The skip ends when the matching end tag, an end
+ * tag of an open ancestor, or an implicitly closing start tag arrives.
+ * That token is then processed normally so the tree stays correct.
+ * The content of raw text children is skipped up to their end tag.
+ */
+static int
+skip_token(struct dispatcher *ctx, struct token *token)
+{
+	struct elem *elem;
+	size_t i;
+	int tagid;
+	int same;
+	int below;
+
+	if (ctx->skip_raw != 0) {
+		if (!TOKEN_IS_END(token) ||
+		    token->u.tag.tagid != ctx->skip_raw)
+			return skip_raw_state(ctx->skip_raw);
+		ctx->skip_raw = 0;
+		return ctx->skip_state;
+	}
+
+	if (!TOKEN_IS_START_END(token))
+		return ctx->skip_state;
+
+	tagid = token->u.tag.tagid;
+	same = (tagid == ctx->skip->tagid &&
+	    (tagid != TAG_CUSTOM_TAG ||
+	    strcmp(token->u.tag.name, ctx->skip->name) == 0));
+
+	if (TOKEN_IS_START(token)) {
+		if (ctx->skip_depth == 0 && ctx->skip_state == STATE_NONE &&
+		    ((same && tagmap(tagid)->flags & TAG_OPTIONAL_CLOSE) ||
+		    (ctx->skip->tagid == TAG_P &&
+		    tagmap(tagid)->flags & TAG_BLOCK))) {
+			skip_end(ctx);
+			return dispatch(ctx, token, ctx->begin, ctx->end);
+		}
+		if (same && !(tagmap(tagid)->flags & TAG_EMPTY))
+			ctx->skip_depth++;
+		if (skip_raw_state(tagid) != STATE_NONE) {
+			ctx->skip_raw = tagid;
+			return skip_raw_state(tagid);
+		}
+		return ctx->skip_state;
+	}
+
+	if (same) {
+		if (ctx->skip_depth > 0) {
+			ctx->skip_depth--;
+			return ctx->skip_state;
+		}
+		skip_end(ctx);
+		return dispatch(ctx, token, ctx->begin, ctx->end);
+	}
+
+	below = 0;
+	for (i = ostack_depth(&ctx->ostack); i >= 1; i--) {
+		elem = ostack_peek_at(&ctx->ostack, i);
+		if (elem == ctx->skip)
+			below = 1;
+		else if (below && elem->tagid == tagid) {
+			skip_end(ctx);
+			return dispatch(ctx, token, ctx->begin, ctx->end);
+		}
+	}
+
+	return ctx->skip_state;
+}
+
+/*
+ * Nodes are not delivered while a subtree is skipped or after a
+ * callback asked us to stop.
+ */
+static int
+silent(struct dispatcher *ctx)
+{
+	return (ctx->skip != NULL || ctx->stop);
+}
+
+static int
+callback(struct dispatcher *ctx, int (*cb)(struct node *), struct node *node)
+{
+	int verdict;
+
+	verdict = cb(node);
+	if (verdict == CB_STOP)
+		ctx->stop = 1;
+
+	return verdict;
+}
+
+static int
+is_block(int tagid)
+{
+	return ((tagmap(tagid)->flags & TAG_BLOCK) != 0);
+}
+
+/*
+ * Whitespace-only text is never rendered in the head and table modes,
+ * and in the body it collapses away next to a block boundary unless
+ * it is inside a preformatted element.
+ */
+static int
+is_elidable(struct dispatcher *ctx, int tagid)
+{
+	if (!ctx->elide_space || !ctx->cdata_space || ctx->cdata_sent ||
+	    ctx->pre_depth > 0)
+		return 0;
+
+	switch (ctx->cdata_mode) {
+	case IMODE_IN_BODY:
+	case IMODE_IN_CELL:
+	case IMODE_IN_CAPTION:
+		return (ctx->cdata_block || is_block(tagid));
+	default:
+		return 1;
+	}
+}
+
+/*
+ * Deliver the pending text at the boundary of the element tagid.
+ */
+static void
+flush_cdata(struct dispatcher *ctx, int (*cb)(struct node *), int tagid)
+{
+	struct node *node;
+
+	if (ctx->cdata == NULL)
+		return;
+
+	node = ctx->cdata->node;
+	if (!silent(ctx) && !is_elidable(ctx, tagid)) {
+		if (ctx->text != NULL) {
+			if (ctx->text(node, 1) == CB_STOP)
+				ctx->stop = 1;
+		} else
+			callback(ctx, cb, node);
+	}
+
+	str_add(&ctx->cdata->data, '\0');
+	ctx->cdata = NULL;
+}
+
+static void
+insert_char(struct dispatcher *ctx, struct token *token)
+{
+	const char *s;
+
+	assert(token->type == TOKEN_CHAR);
+
+	if (ctx->cdata == NULL) {
+		ctx->cdata_buf.type = CDATA_TEXT;
+		ctx->cdata_buf.node = &ctx->cdata_node;
+		ctx->cdata_node.type = NODE_CDATA;
+		ctx->cdata_node.view = 1;
+		ctx->cdata_node.u.cdata = &ctx->cdata_buf;
+		ctx->cdata = &ctx->cdata_buf;
+		ctx->cdata_mode = ctx->mode;
+		ctx->cdata_space = 1;
+		ctx->cdata_sent = 0;
+		ctx->cdata_block = ctx->last_block;
+	}
+
+	for (s = token->s.s; ctx->cdata_space && *s != '\0'; s++)
+		if (!HTML_ISSPACE(*s))
+			ctx->cdata_space = 0;
+
+	cdata_add(ctx->cdata, token->s.s);
+	token->used = 1;
+
+	/*
+	 * In streaming mode the text is delivered in pieces as soon as
+	 * it grows past the threshold; the final piece is delivered by
+	 * flush_cdata() at the element boundary.
+	 */
+	if (ctx->text != NULL && ctx->cdata->data.len >=
+	    (ctx->text_max > 0 ? ctx->text_max : TEXT_MAX)) {
+		if (!silent(ctx) && ctx->text(ctx->cdata->node, 0) == CB_STOP)
+			ctx->stop = 1;
+		str_add(&ctx->cdata->data, '\0');
+		ctx->cdata_sent = 1;
+	}
+}
+
+/*
+ * Elements are passed to the callbacks as views living in a slot per
+ * open elements stack depth, so nothing gets allocated for them unless
+ * a callback asks for a copy with node_retain(). The view takes over
+ * the name and attributes of the token until the element is closed.
+ */
+static struct elem *
+elem_view(struct dispatcher *ctx, struct token *token)
+{
+	struct elem_view *view;
+	size_t depth;
+
+	depth = ostack_depth(&ctx->ostack);
+	if (depth >= ctx->views_alloc) {
+		ctx->views = mem_realloc(ctx->views,
+		    (depth + 1) * 2 * sizeof(struct elem_view *));
+		if (ctx->views == NULL)
+			err(1, "realloc views");
+		STATS_ADD(allocs[ALLOC_VIEW], 1);
+		while (ctx->views_alloc < (depth + 1) * 2) {
+			view = mem_malloc(sizeof(struct elem_view));
+			if (view == NULL)
+				err(1, "malloc view");
+			STATS_ADD(allocs[ALLOC_VIEW], 1);
+			ctx->views[ctx->views_alloc++] = view;
+		}
+	}
+
+	view = ctx->views[depth];
+	memset(view, 0, sizeof(struct elem_view));
+	view->elem.tagid = token->u.tag.tagid;
+	view->elem.name = token->u.tag.name;
+	view->elem.shared_name = token->u.tag.shared_name;
+	view->elem.attr = token->u.tag.attr;
+	view->elem.node = &view->node;
+	view->node.type = NODE_ELEM;
+	view->node.view = 1;
+	view->node.u.elem = &view->elem;
+	token->used = 1;
+
+	assert(view->elem.name != NULL);
+	return &view->elem;
+}
+
+static struct elem *
+insert_element_ns(struct dispatcher *ctx, struct token *token, int ns)
+{
+	struct elem *elem;
+	struct node *node;
+	int verdict;
+
+	assert(token->type == TOKEN_START_TAG);
+
+	flush_cdata(ctx, ctx->begin, token->u.tag.tagid);
+
+	elem = elem_view(ctx, token);
+	if (elem->tagid)
+		ctx->head_elem = elem;
+
+	node = elem->node;
+
+	/*
+	 * Implied elements can still get inserted below a skipped one
+	 * while the token that started the skip is being processed.
+	 */
+	if (silent(ctx))
+		verdict = CB_CONTINUE;
+	else
+		verdict = callback(ctx, ctx->begin, node);
+
+	ctx->last_block = is_block(elem->tagid);
+
+	if (!(tagmap(elem->tagid)->flags & TAG_EMPTY)) {
+		ostack_push(&ctx->ostack, elem);
+		if (tagmap(elem->tagid)->flags & TAG_PREFORMATTED)
+			ctx->pre_depth++;
+		if (verdict == CB_SKIP && ctx->skip == NULL) {
+			ctx->skip = elem;
+			ctx->skip_depth = 0;
+			ctx->skip_state = STATE_NONE;
+			ctx->skip_raw = 0;
+		}
+	} else {
+		if (!silent(ctx))
+			callback(ctx, ctx->end, node);
+		clear_view(ctx, elem);
+	}
+
+	return elem;
+}
+
+static struct elem *
+insert_foreign_element(struct dispatcher *ctx, struct token *token, int ns)
+{
+	struct elem *elem;
+
+	elem = insert_element_ns(ctx, token, ns);
+	return elem;
+}
+
+static void
+insert_tag(struct dispatcher *ctx, struct token *token)
+{
+	insert_element_ns(ctx, token, NS_HTML);
+}
+
+/* helper */
+static void
+insert_tag_name(struct dispatcher *ctx, const char *name, int close)
+{
+	struct token token;
+
+	if (close)
+		token = TOKEN_SET_END_TAG();
+	else
+		token = TOKEN_SET_START_TAG();
+
+	token_set_tag_name(&token, name);
+
+	if (close)
+		insert_close_tag(ctx, &token);
+	else
+		insert_tag(ctx, &token);
+
+	token_clear(&token);
+}
+
+/* helper */
+static void
+insert_tag_set_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
+{
+	insert_tag(ctx, token);
+	ctx->mode = mode;
+}
+
+/* helper */
+static void
+insert_tag_name_set_mode(struct dispatcher *ctx, const char *name, int close,
+    IMODE mode)
+{
+	insert_tag_name(ctx, name, close);
+	ctx->mode = mode;
+}
+
+static void
+close_tag(struct dispatcher *ctx, struct elem *elem)
+{
+	flush_cdata(ctx, ctx->end, elem->tagid);
+
+	ostack_pop(&ctx->ostack);
+	assert(elem->node != NULL);
+
+	if (tagmap(elem->tagid)->flags & TAG_PREFORMATTED)
+		ctx->pre_depth--;
+	ctx->last_block = is_block(elem->tagid);
+
+	if (ctx->skip == elem)
+		skip_end(ctx);
+
+	if (!silent(ctx))
+		callback(ctx, ctx->end, elem->node);
+
+	clear_view(ctx, elem);
+}
+
+static void
+insert_close_tag(struct dispatcher *ctx, struct token *token)
+{
+	struct elem *elem;
+
+	assert(token->type == TOKEN_END_TAG);
+
+	elem = ostack_peek(&ctx->ostack);
+	close_tag(ctx, elem);
+
+	token->used = 0;
+}
+
+/* helper */
+static void
+insert_close_tag_set_mode(struct dispatcher *ctx, struct token *token,
+    IMODE mode)
+{
+	insert_close_tag(ctx, token);
+	ctx->mode = mode;
+}
+
+static int
+is_open(struct dispatcher *ctx, int num_args, ...)
+{
+	size_t sz, i, j;
+	va_list ap;
+
+	sz = ostack_depth(&ctx->ostack);
+
+	for (i = sz; i >= 1; i--)  {
+		va_start(ap, num_args);
+		for (j = 0; j < num_args; j++)
+			if (ostack_peek_at(&ctx->ostack, i)->tagid == va_arg(ap, int))
+				return 1;
+		va_end(ap);
+	}
+
+	return 0;
+}
+
+static int
+is_open_other_than(struct dispatcher *ctx, int num_args, ...)
+{
+	size_t sz, i, j;
+	va_list ap;
+	int found;
+
+	sz = ostack_depth(&ctx->ostack);
+	found = 0;
+	for (i = sz; i >= 1; i--)  {
+		va_start(ap, num_args);
+		found = 0;
+		for (j = 0; j < num_args; j++) {
+			if (ostack_peek_at(&ctx->ostack, i)->tagid == va_arg(ap, int)) {
+				found++;
+			}
+		}
+		if (found == 0)
+			return ostack_peek_at(&ctx->ostack, i)->tagid;
+		va_end(ap);
+	}
+
+	return -1;
+}
+
+enum scope {
+	SCOPE_ANY,
+	SCOPE_LIST_ITEM,
+	SCOPE_BUTTON,
+	SCOPE_TABLE,
+	SCOPE_SELECT,
+};
+
+#if 0
+static int
+generate_implied_end_tags_thoroughly(struct dispatcher *ctx)
+{
+	size_t sz, i;
+
+	sz = ostack_depth(&ctx->ostack);
+	for (i = sz; i >= 1; i--) {
+		switch (ostack_peek_at(&ctx->ostack, i)->tagid) {
+		case TAG_CAPTION:
+		case TAG_COLGROUP:
+		case TAG_DD:
+		case TAG_DT:
+		case TAG_LI:
+		case TAG_OPTGROUP:
+		case TAG_OPTION:
+		case TAG_P:
+		case TAG_RB:
+		case TAG_RP:
+		case TAG_RT:
+		case TAG_RTC:
+		case TAG_TBODY:
+		case TAG_TD:
+		case TAG_TFOOT:
+		case TAG_TH:
+		case TAG_THEAD:
+		case TAG_TR:
+			pop(ctx);
+		}
+	}
+
+	return 0;
+}
+#endif
+
+static int
+generate_implied_end_tags(struct dispatcher *ctx, int except)
+{
+	size_t sz, i;
+
+	sz = ostack_depth(&ctx->ostack);
+	for (i = sz; i >= 1; i--) {
+		if (ostack_peek_at(&ctx->ostack, i)->tagid == except)
+			return 0;
+
+		switch (ostack_peek_at(&ctx->ostack, i)->tagid) {
+		case TAG_DD:
+		case TAG_DT:
+		case TAG_LI:
+		case TAG_OPTGROUP:
+		case TAG_OPTION:
+		case TAG_P:
+		case TAG_RB:
+		case TAG_RP:
+		case TAG_RT:
+		case TAG_RTC:
+			pop(ctx);
+			break;
+		default:
+			return 0;
+		}
+	}
+	return 0;
+}
+
+static int
+close_p_element(struct dispatcher *ctx)
+{
+	generate_implied_end_tags(ctx, TAG_P);
+	if (ostack_peek(&ctx->ostack)->tagid != TAG_P)
+		return 0;
+	pop(ctx);
+	return 1;
+}
+
+static int
+has_element_in_scope(struct dispatcher *ctx, int target, int scope)
+{
+	size_t sz, i;
+
+	STATS_ADD(scope_checks, 1);
+	if (ostack_count(&ctx->ostack, target) == 0)
+		return 0;
+
+	sz = ostack_depth(&ctx->ostack);
+	for (i = sz; i >= 1; i--) {
+		STATS_ADD(scope_scanned, 1);
+		if (ostack_peek_at(&ctx->ostack, i)->tagid == target)
+			return 1;
+
+		/*
+		 * Terminate search if we reach...
+		 */
+		switch (scope) {
+		case SCOPE_LIST_ITEM:
+			switch (ostack_peek_at(&ctx->ostack, i)->tagid) {
+			case TAG_OL:
+				return 0;
+			case TAG_UL:
+				return 0;
+			}
+			break;
+		case SCOPE_BUTTON:
+			switch (ostack_peek_at(&ctx->ostack, i)->tagid) {
+			case TAG_BUTTON:
+				return 0;
+			}
+			break;
+		case SCOPE_TABLE:
+			switch (ostack_peek_at(&ctx->ostack, i)->tagid) {
+			case TAG_HTML:
+			case TAG_TABLE:
+			case TAG_TEMPLATE:
+				return 0;
+			}
+			break;
+		default:
+			break;
+		}
+
+		if (scope == SCOPE_SELECT) {
+			if (ostack_peek_at(&ctx->ostack, i)->tagid == TAG_OPTGROUP)
+				continue;
+			if (ostack_peek_at(&ctx->ostack, i)->tagid == TAG_OPTION)
+				continue;
+			return 0;
+		}
+
+		switch (scope) {
+		case SCOPE_LIST_ITEM:
+		case SCOPE_BUTTON:
+		case SCOPE_ANY:
+			switch (ostack_peek_at(&ctx->ostack, i)->tagid) {
+			case TAG_APPLET:
+			case TAG_CAPTION:
+			case TAG_HTML:
+			case TAG_TABLE:
+			case TAG_TD:
+			case TAG_TH:
+			case TAG_MARQUEE:
+			case TAG_OBJECT:
+			case TAG_TEMPLATE:
+				return 0;
+			}
+		default:
+			break;
+		}
+	}
+
+	return 0;
+}
+
+static struct elem *
+pop(struct dispatcher *ctx)
+{
+	struct elem *elem;
+
+	elem = ostack_peek(&ctx->ostack);
+	close_tag(ctx, elem);
+	return elem;
+}
+
+static struct elem *
+pop_elem(struct dispatcher *ctx, int tagid)
+{
+	while (ostack_peek(&ctx->ostack) != NULL) {
+		if (ostack_peek(&ctx->ostack)->tagid == tagid) {
+			return pop(ctx);
+		} else
+			pop(ctx);
+	}
+	assert(0);
+	return NULL;
+}
+
+static int
+is_start_tag(struct token *token, int num_args, ...)
+{
+	va_list ap;
+	size_t i;
+
+	if (!TOKEN_IS_START(token))
+		return 0;
+
+	va_start(ap, num_args);
+	for (i = 0; i < num_args; i++) {
+		if (TOKEN_IS_START_TAG(token, va_arg(ap, int)))
+			return 1;
+	}
+
+	return 0;
+}
+
+
+static int
+is_end_tag(struct token *token, int num_args, ...)
+{
+	va_list ap;
+	size_t i;
+
+	if (!TOKEN_IS_END(token))
+		return 0;
+
+	va_start(ap, num_args);
+	for (i = 0; i < num_args; i++) {
+		if (TOKEN_IS_END_TAG(token, va_arg(ap, int)))
+			return 1;
+	}
+
+	return 0;
+}
+
+static int
+check_p(struct dispatcher *ctx, struct token *token, IMODE mode)
+{
+	if (has_element_in_scope(ctx, TAG_P, SCOPE_BUTTON)) {
+		if (close_p_element(ctx) == 0) {
+			print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static void
+adoption_agency(struct dispatcher *ctx, struct token *token)
+{
+}
+
+static void
+print_err(struct dispatcher *ctx, struct token *token, enum errors code)
+{
+	REPORT(ctx->report, code, token->end_line + 1, token->end_offset);
+}
+
+static IMODE
+reset_imode(struct dispatcher *ctx, struct elem *head_elem_ptr)
+{
+	int last;
+	size_t depth;
+	struct elem *node;
+
+	last = 0;
+	depth = ostack_depth(&ctx->ostack);
+	node = ostack_peek_at(&ctx->ostack, depth);
+
+	if (node == NULL)
+		return IMODE_INITIAL;
+
+	do {
+		if (depth == 1)
+			last = 1;
+
+		switch (node->tagid) {
+		case TAG_TD:
+		case TAG_TH:
+			if (!last)
+				return IMODE_IN_CELL;
+			break;
+		case TAG_TR:
+			return IMODE_IN_ROW;
+		case TAG_TBODY:
+		case TAG_THEAD:
+		case TAG_TFOOT:
+			return IMODE_IN_TABLE_BODY;
+		case TAG_CAPTION:
+			return IMODE_IN_CAPTION;
+		case TAG_TABLE:
+			return IMODE_IN_TABLE;
+		case TAG_TEMPLATE:
+			return IMODE_IN_TEMPLATE;
+		case TAG_HEAD:
+			return IMODE_IN_HEAD;
+		case TAG_BODY:
+			return IMODE_IN_BODY;
+		case TAG_FRAMESET:
+			return IMODE_IN_FRAMESET;
+		case TAG_HTML:
+			if (head_elem_ptr == NULL)
+				return IMODE_BEFORE_HEAD;
+			return IMODE_AFTER_HEAD;
+		}
+
+		if (last)
+			return IMODE_IN_BODY;
+
+		node = ostack_peek_at(&ctx->ostack, --depth);
+		assert(node != NULL);
+	} while(1);
+}
+
+enum context {
+	CONTEXT_TABLE,
+	CONTEXT_TABLE_BODY,
+	CONTEXT_TABLE_ROW,
+};
+static void
+clear_to_context(struct dispatcher *ctx, enum context c)
+{
+	int tagid;
+
+	while (ostack_depth(&ctx->ostack) >= 1) {
+		tagid = ostack_peek(&ctx->ostack)->tagid;
+		if (c == CONTEXT_TABLE && (tagid == TAG_TABLE ||
+		    tagid == TAG_TEMPLATE || tagid == TAG_HTML))
+			return;
+		if (c == CONTEXT_TABLE_BODY && (tagid == TAG_TBODY ||
+		    tagid == TAG_TFOOT || tagid == TAG_THEAD ||
+		    tagid == TAG_TEMPLATE || tagid == TAG_HTML))
+			return;
+		if (c == CONTEXT_TABLE_ROW && (tagid == TAG_TR ||
+		    tagid == TAG_TEMPLATE || tagid == TAG_HTML))
+			return;
+
+		pop(ctx);
+	}
+	assert(0);
+}
+
+static void
+close_cell(struct dispatcher *ctx, struct token *token)
+{
+	generate_implied_end_tags(ctx, -1);
+	if (ostack_peek(&ctx->ostack)->tagid == TAG_TD) {
+		pop_elem(ctx, TAG_TD);
+		ctx->mode = IMODE_IN_ROW;
+	} else if (ostack_peek(&ctx->ostack)->tagid == TAG_TH) {
+		pop_elem(ctx, TAG_TH);
+		ctx->mode = IMODE_IN_ROW;
+	} else
+		print_err(ctx, token, ERROR_UNCLOSED_ELEMENT);
+}
+
+/*
+ * TODO: Add comment handling (now all comments are ignored altogether).
+ * TODO: Add DOCTYPE token handling (now all are DOCTYPEs are ignored altogether).
+ */
+#include <stdio.h>
+static int
+insert_token_with_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
+{
+	struct elem *node;
+	int tagid;
+	size_t sz;
+
+#if 0
+	printf("Insert %s (%s) ", token_str(token), imodes[mode]);
+	if (token->type == TOKEN_START_TAG)
+		printf("...tag %s (%d)\n", token->u.tag.name, token->u.tag.tagid);
+	if (token->type == TOKEN_END_TAG)
+		printf("...tag end %s (%d)\n", token->u.tag.name, token->u.tag.tagid);
+	if (token->type == TOKEN_CHAR)
+		printf("...char '%s'\n", token->s.s);
+	printf("\n");
+#endif
+
+	STATS_ADD(tokens[mode], 1);
+	if (TOKEN_IS_EMPTY(token) || TOKEN_IS_COMMENT(token))
+		return STATE_NONE;
+
+	/*
+	 * Catch-all character insert.
+	 */
+	if (TOKEN_IS_CHAR(token)) {
+		switch (mode) {
+		case IMODE_IN_HEAD:
+			if (ostack_peek(&ctx->ostack) != NULL &&
+			    ostack_peek(&ctx->ostack)->tagid == TAG_TITLE) {
+				insert_char(ctx, token);
+				return STATE_NONE;
+			}
+			break;
+#if 1
+	/*
+	 * Remembering script content is disabled.
+	 */
+		case IMODE_TEXT:
+			return STATE_NONE;
+#endif
+		case IMODE_IN_BODY:
+			insert_char(ctx, token);
+			return STATE_NONE;
+		default:
+			break;
+		}
+	}
+
+	if (mode != IMODE_INITIAL && TOKEN_IS_DOCTYPE(token)) {
+		print_err(ctx, token, ERROR_UNEXPECTED_DOCTYPE);
+		return STATE_NONE;
+	}
+
+	/*
+	 * Whitespace rules.
+	 */
+	switch (mode) {
+	case IMODE_INITIAL:
+	case IMODE_BEFORE_HTML:
+	case IMODE_BEFORE_HEAD:
+		if (TOKEN_IS_SPACE(token))
+			return STATE_NONE;
+		break;
+	case IMODE_IN_HEAD:
+	case IMODE_IN_BODY:
+	case IMODE_AFTER_HEAD:
+		if (TOKEN_IS_SPACE(token)) {
+			insert_char(ctx, token);
+			return STATE_NONE;
+		}
+		break;
+	default:
+		break;
+	}
+
+	switch (mode) {
+	case IMODE_INITIAL:
+		if (TOKEN_IS_DOCTYPE(token)) {
+			ctx->mode = IMODE_BEFORE_HTML;
+			return STATE_NONE;
+		} else
+			insert_token_set_mode(ctx, token, IMODE_BEFORE_HTML);
+		return STATE_NONE;
+	case IMODE_BEFORE_HTML:
+		if (TOKEN_IS_START_TAG(token, TAG_HTML)) {
+			insert_tag_set_mode(ctx, token, IMODE_BEFORE_HEAD);
+		} else {
+			insert_tag_name_set_mode(ctx, "html", 0, IMODE_BEFORE_HEAD);
+			return dispatch(ctx, token, ctx->begin, ctx->end);
+		}
+		return STATE_NONE;
+	case IMODE_BEFORE_HEAD:
+		if (TOKEN_IS_START_TAG(token, TAG_HEAD)) {
+			insert_tag_set_mode(ctx, token, IMODE_IN_HEAD);
+		} else {
+			insert_tag_name_set_mode(ctx, "head", 0, IMODE_IN_HEAD);
+			insert_token_set_mode(ctx, token, IMODE_IN_HEAD);
+		}
+		return STATE_NONE;
+	case IMODE_IN_HEAD:
+		if (TOKEN_IS_START_TAG(token, TAG_TITLE)) {
+			insert_tag(ctx, token);
+			return STATE_RCDATA;
+		} else if (TOKEN_IS_END_TAG(token, TAG_HEAD)) {
+			insert_close_tag_set_mode(ctx, token, IMODE_AFTER_HEAD);
+			return STATE_NONE;
+		} else if (is_start_tag(token, 5, TAG_META, TAG_BASE,
+		    TAG_BASEFONT, TAG_BGSOUND, TAG_LINK)) {
+			insert_tag(ctx, token);
+			return STATE_NONE;
+		} else if (TOKEN_IS_END_TAG(token, TAG_TITLE)) {
+			/*
+			 * TODO: Report this to HTML LS spec, expecting
+			 * title end tag is not specified
+			 */
+			insert_close_tag(ctx, token);
+			return STATE_NONE;
+		} else if (is_start_tag(token, 2, TAG_NOFRAMES, TAG_STYLE)) {
+			insert_tag(ctx, token);
+			ctx->orig_mode = ctx->mode;
+			ctx->mode = IMODE_TEXT;
+			return STATE_RAWTEXT;
+		} else if (TOKEN_IS_START_TAG(token, TAG_NOSCRIPT)) {
+			insert_tag_set_mode(ctx, token, IMODE_IN_HEAD_NOSCRIPT);
+			print_err(ctx, token, ERROR_UNEXPECTED_TOKEN);
+			return STATE_NONE;
+		} else if (TOKEN_IS_START_TAG(token, TAG_SCRIPT)) {
+			ctx->orig_mode = ctx->mode;
+			ctx->mode = IMODE_TEXT;
+			insert_tag(ctx, token);
+			return STATE_SCRIPT_DATA;			
+		} else {
+		/* TODO: What should we do here if we already popped
+		 *       head off? */
+			pop_elem(ctx, TAG_HEAD);
+			print_err(ctx, token, ERROR_IMPLIED_HEAD);
+			insert_token_set_mode(ctx, token, IMODE_AFTER_HEAD);
+			return STATE_NONE;
+		}
+		break;
+	case IMODE_TEXT:
+		if (TOKEN_IS_END_TAG(token, TAG_SCRIPT)) {
+			insert_close_tag_set_mode(ctx, token, ctx->orig_mode);
+			return STATE_NONE;
+		} else {
+			pop(ctx);
+			ctx->mode = ctx->orig_mode;
+			return STATE_NONE;
+		}
+		break;
+	case IMODE_AFTER_HEAD:
+		if (TOKEN_IS_START_TAG(token, TAG_HTML))
+			insert_token_with_mode(ctx, token, IMODE_IN_BODY);
+		else if (TOKEN_IS_START_TAG(token, TAG_BODY))
+			insert_tag_set_mode(ctx, token, IMODE_IN_BODY);
+		else {
+			insert_tag_name_set_mode(ctx, "body", 0, IMODE_IN_BODY);
+			return dispatch(ctx, token, ctx->begin, ctx->end);
+		}
+		return STATE_NONE;
+	case IMODE_IN_SELECT:
+		if (TOKEN_IS_END_TAG(token, TAG_SELECT)) {
+			if (!has_element_in_scope(ctx, TAG_SELECT,
+			    SCOPE_SELECT)) {
+				print_err(ctx, token, ERROR_ELEMENT_NOT_IN_SCOPE);
+				return STATE_NONE;
+			}
+			pop_elem(ctx, TAG_SELECT);
+			ctx->mode = reset_imode(ctx, ctx->head_elem);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_START_TAG(token, TAG_OPTION)) {
+			if (ostack_peek(&ctx->ostack)->tagid == TAG_OPTION)
+				pop(ctx);
+			insert_tag(ctx, token);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_START_TAG(token, TAG_OPTGROUP)) {
+			if (ostack_peek(&ctx->ostack)->tagid == TAG_OPTION)
+				pop(ctx);
+			if (ostack_peek(&ctx->ostack)->tagid == TAG_OPTGROUP)
+				pop(ctx);
+			insert_tag(ctx, token);
+			return STATE_NONE;
+		}
+		return STATE_NONE;
+	case IMODE_IN_BODY:
+		if (TOKEN_IS_COMMENT(token) ||
+		    TOKEN_IS_DOCTYPE(token)) {
+			print_err(ctx, token, ERROR_UNEXPECTED_TOKEN);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_START_TAG(token, TAG_HTML) ||
+		    TOKEN_IS_START_TAG(token, TAG_BODY)) {
+			print_err(ctx, token, ERROR_UNEXPECTED_TOKEN);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_START_TAG(token, TAG_FRAMESET)) {
+			print_err(ctx, token, ERROR_UNEXPECTED_TOKEN);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_START_TAG(token, TAG_SELECT)) {
+			/*
+			 * We might be here temporarily even though our
+			 * mode is different than 'in body'.
+			 */
+			if (ctx->mode == IMODE_IN_TABLE ||
+			    ctx->mode == IMODE_IN_CAPTION ||
+			    ctx->mode == IMODE_IN_TABLE_BODY ||
+			    ctx->mode == IMODE_IN_ROW ||
+			    ctx->mode == IMODE_IN_CELL)
+				insert_tag_set_mode(ctx, token,
+				    IMODE_IN_SELECT_IN_TABLE);
+			else
+				insert_tag_set_mode(ctx, token,
+				    IMODE_IN_SELECT);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_START_TAG(token, TAG_BASE) ||
+		    TOKEN_IS_START_TAG(token, TAG_BASEFONT) ||
+		    TOKEN_IS_START_TAG(token, TAG_BGSOUND) ||
+		    TOKEN_IS_START_TAG(token, TAG_LINK) ||
+		    TOKEN_IS_START_TAG(token, TAG_META) ||
+		    TOKEN_IS_START_TAG(token, TAG_NOFRAMES) ||
+		    TOKEN_IS_START_TAG(token, TAG_SCRIPT) ||
+		    TOKEN_IS_START_TAG(token, TAG_STYLE) ||
+		    TOKEN_IS_START_TAG(token, TAG_TEMPLATE) ||
+		    TOKEN_IS_START_TAG(token, TAG_TITLE) ||
+		    TOKEN_IS_END_TAG(token, TAG_TEMPLATE)) {
+			return insert_token_with_mode(ctx, token, IMODE_IN_HEAD);
+		}
+		if (TOKEN_IS_END_TAG(token, TAG_BODY) ||
+		    TOKEN_IS_END_TAG(token, TAG_HTML)) {
+			if (!is_open(ctx, 1, TAG_BODY)) {
+				print_err(ctx, token, ERROR_ELEMENT_NOT_IN_SCOPE);
+				return STATE_NONE;
+			}
+			tagid = is_open_other_than(ctx, 18, TAG_DD, TAG_DT, TAG_LI,
+			    TAG_OPTGROUP, TAG_OPTION, TAG_P, TAG_RB, TAG_RP,
+			    TAG_RT, TAG_RTC, TAG_TBODY, TAG_TD, TAG_TFOOT,
+			    TAG_TH, TAG_THEAD, TAG_TR, TAG_BODY, TAG_HTML);
+			if (tagid != -1) {
+				print_err(ctx, token, ERROR_UNCLOSED_ELEMENT);
+				return STATE_NONE;
+			}
+			if (TOKEN_IS_END_TAG(token, TAG_BODY)) {
+				insert_close_tag(ctx, token);
+				return STATE_NONE;
+			}
+			return insert_token_with_mode(ctx, token, IMODE_AFTER_BODY);
+		}
+		if (is_start_tag(token, 24, TAG_ADDRESS, TAG_ARTICLE,
+		    TAG_ASIDE, TAG_BLOCKQUOTE, TAG_CENTER, TAG_DETAILS,
+		    TAG_DIALOG, TAG_DIR, TAG_DIV, TAG_DL, TAG_FIELDSET,
+		    TAG_FIGCAPTION, TAG_FIGURE, TAG_FOOTER, TAG_HEADER,
+		    TAG_HGROUP, TAG_MAIN, TAG_MENU, TAG_NAV, TAG_OL,
+		    TAG_P, TAG_SECTION, TAG_SUMMARY, TAG_UL)) {
+			if (check_p(ctx, token, mode) == -1)
+				return STATE_NONE;
+			insert_tag(ctx, token);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_END(token) &&
+		    tagmap(token->u.tag.tagid)->flags & TAG_HEADING) {
+			if (!has_element_in_scope(ctx, token->u.tag.tagid,
+			    SCOPE_ANY)) {
+				print_err(ctx, token, ERROR_ELEMENT_NOT_IN_SCOPE);
+				return STATE_NONE;
+			}
+			generate_implied_end_tags(ctx, token->u.tag.tagid);
+			if (ostack_peek(&ctx->ostack)->tagid != token->u.tag.tagid) {
+				print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
+				return STATE_NONE;
+			}
+			pop_elem(ctx, token->u.tag.tagid);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_START_TAG(token, TAG_MATH)) {
+			insert_foreign_element(ctx, token, NS_MATHML);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_START_TAG(token, TAG_SVG)) {
+			insert_foreign_element(ctx, token, NS_SVG);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_START_TAG(token, TAG_A)) {
+			insert_tag(ctx, token);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_START(token) &&
+		    tagmap(token->u.tag.tagid)->flags & TAG_FORMAT) {
+			insert_tag(ctx, token);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_START_TAG(token, TAG_TABLE)) {
+			if (check_p(ctx, token, mode) == -1)
+				return STATE_NONE;
+			insert_tag_set_mode(ctx, token, IMODE_IN_TABLE);	
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_START_TAG(token, TAG_NOBR)) {
+			/* TODO adoption agency etc */
+			print_err(ctx, token, ERROR_UNSUPPORTED);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_END(token) &&
+		    (tagmap(token->u.tag.tagid)->flags & TAG_FORMAT ||
+		    token->u.tag.tagid == TAG_A ||
+		    token->u.tag.tagid == TAG_NOBR)) {
+			adoption_agency(ctx, token);
+			insert_close_tag(ctx, token);
+			return STATE_NONE;
+		}
+		if (is_start_tag(token, 3, TAG_APPLET, TAG_MARQUEE, TAG_OBJECT)) {
+			print_err(ctx, token, ERROR_UNSUPPORTED);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_END_TAG(token, TAG_BR)) {
+			print_err(ctx, token, ERROR_UNSUPPORTED);
+			return STATE_NONE;
+		}
+		if (is_start_tag(token, 6, TAG_AREA, TAG_BR, TAG_EMBED, TAG_IMG,
+		    TAG_KEYGEN, TAG_WBR)) {
+			insert_tag(ctx, token);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_START(token) &&
+		    tagmap(token->u.tag.tagid)->flags & TAG_HEADING) {
+			if (check_p(ctx, token, mode) == -1)
+				return STATE_NONE;
+			if (tagmap(ostack_peek(&ctx->ostack)->tagid)->flags & TAG_HEADING) {
+				print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
+				pop(ctx);
+			}
+			insert_tag(ctx, token);
+			return STATE_NONE;
+		}
+		if (is_start_tag(token, 2, TAG_PRE, TAG_LISTING)) {
+			if (check_p(ctx, token, mode) == -1)
+				return STATE_NONE;
+			/* TODO: Ignore "Newlines at the start of pre blocks" */
+			insert_tag(ctx, token);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_START_TAG(token, TAG_FORM)) {
+			/* TODO */
+			if (check_p(ctx, token, mode) == -1)
+				return STATE_NONE;
+			insert_tag(ctx, token);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_START_TAG(token, TAG_BUTTON)) {
+			if (has_element_in_scope(ctx, TAG_BUTTON, SCOPE_ANY)) {
+				print_err(ctx, token, ERROR_NESTED_BUTTON);
+				generate_implied_end_tags(ctx, -1);
+				pop_elem(ctx, TAG_BUTTON);
+			}
+			insert_tag(ctx, token);
+			return STATE_NONE;
+		}
+		if (is_end_tag(token, 26, TAG_ADDRESS, TAG_ARTICLE, TAG_ASIDE,
+		    TAG_BLOCKQUOTE, TAG_BUTTON, TAG_CENTER, TAG_DETAILS,
+		    TAG_DIALOG, TAG_DIR, TAG_DIV, TAG_DL, TAG_FIELDSET,
+		    TAG_FIGCAPTION, TAG_FIGURE, TAG_FOOTER, TAG_HEADER,
+		    TAG_HGROUP, TAG_LISTING, TAG_MAIN, TAG_MENU, TAG_NAV,
+		    TAG_OL, TAG_PRE, TAG_SECTION, TAG_SUMMARY, TAG_UL)) {
+			if (!has_element_in_scope(ctx, token->u.tag.tagid,
+			    SCOPE_ANY)) {
+				print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
+				return STATE_NONE;
+			}
+			generate_implied_end_tags(ctx, 0);
+			if (ostack_peek(&ctx->ostack)->ns != NS_HTML ||
+			    ostack_peek(&ctx->ostack)->tagid != token->u.tag.tagid) {
+				print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
+				return STATE_NONE;
+			}
+			pop_elem(ctx, token->u.tag.tagid);
+			return STATE_NONE;
+		}
+		if (is_end_tag(token, 2, TAG_DD, TAG_DT)) {
+			if (!has_element_in_scope(ctx, token->u.tag.tagid,
+			    SCOPE_ANY)) {
+				print_err(ctx, token, ERROR_ELEMENT_NOT_IN_SCOPE);
+				return STATE_NONE;
+			}
+			generate_implied_end_tags(ctx, token->u.tag.tagid);
+			if (ostack_peek(&ctx->ostack)->tagid != token->u.tag.tagid) {
+				print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
+				return STATE_NONE;
+			}
+			pop_elem(ctx, token->u.tag.tagid);
+			return STATE_NONE;
+		}
+		if (is_start_tag(token, 2, TAG_DD, TAG_DT)) {
+			sz = ostack_depth(&ctx->ostack);
+dd_dt_loop:
+			tagid = ostack_peek_at(&ctx->ostack, sz)->tagid;
+			if (tagid == TAG_DD || tagid == TAG_DT) {
+				generate_implied_end_tags(ctx, tagid);
+				if (ostack_peek(&ctx->ostack)->tagid != tagid) {
+					print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
+					return STATE_NONE;
+				}
+				pop(ctx);
+				goto dd_dt_done;
+			} else if (tagmap(tagid)->flags & TAG_SPECIAL &&
+			    (tagid != TAG_ADDRESS && tagid != TAG_DIV &&
+			    tagid != TAG_P)) {
+				goto dd_dt_done;
+			} else if (sz > 1) {
+				sz--;
+				goto dd_dt_loop;
+			} else {
+				print_err(ctx, token, ERROR_UNSUPPORTED);
+			}
+			return STATE_NONE;
+dd_dt_done:
+			if (check_p(ctx, token, mode) == -1)
+				return STATE_NONE;
+			insert_tag(ctx, token);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_START_TAG(token, TAG_PLAINTEXT)) {
+			if (check_p(ctx, token, mode) == -1)
+				return STATE_NONE;
+			insert_tag(ctx, token);
+			return STATE_PLAINTEXT;
+		}
+		if (TOKEN_IS_END_TAG(token, TAG_P)) {
+			if (!has_element_in_scope(ctx, TAG_P, SCOPE_BUTTON)) {
+				print_err(ctx, token, ERROR_ELEMENT_NOT_IN_SCOPE);
+				insert_tag_name(ctx, "p", 0);
+			}
+			if (close_p_element(ctx) == 0) {
+				print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
+				return STATE_NONE;
+			}
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_END_TAG(token, TAG_LI)) {
+			if (!has_element_in_scope(ctx, TAG_LI, SCOPE_LIST_ITEM)) {
+				print_err(ctx, token, ERROR_ELEMENT_NOT_IN_SCOPE);
+				return STATE_NONE;
+			}
+			generate_implied_end_tags(ctx, TAG_LI);
+			if (ostack_peek(&ctx->ostack)->tagid != TAG_LI) {
+				print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
+				return STATE_NONE;
+			}
+			pop_elem(ctx, TAG_LI);
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_START_TAG(token, TAG_LI)) {
+li_loop:
+			if (ostack_peek(&ctx->ostack)->tagid == TAG_LI) {
+				generate_implied_end_tags(ctx, TAG_LI);
+				if (ostack_peek(&ctx->ostack)->tagid != TAG_LI) {
+					print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
+					return STATE_NONE;
+				}
+				pop(ctx);
+				goto li_done;
+			}
+			if ((tagmap(ostack_peek(&ctx->ostack)->tagid)->flags & TAG_SPECIAL) &&
+			    (ostack_peek(&ctx->ostack)->tagid != TAG_ADDRESS &&
+			     ostack_peek(&ctx->ostack)->tagid != TAG_DIV &&
+			     ostack_peek(&ctx->ostack)->tagid != TAG_P))
+				goto li_done;
+
+			pop(ctx);
+			goto li_loop;
+li_done:
+			if (check_p(ctx, token, mode) == -1)
+				return STATE_NONE;
+			insert_tag(ctx, token);
+			return STATE_NONE;
+		}
+		break;
+	case IMODE_AFTER_BODY:
+		if (TOKEN_IS_END_TAG(token, TAG_HTML)) {
+			insert_close_tag(ctx, token);
+			ctx->mode = IMODE_AFTER_AFTER_BODY;
+			return STATE_NONE;
+		}	
+		break;
+	case IMODE_IN_TABLE:
+		if (TOKEN_IS_CHAR(token)) {
+			ctx->orig_mode = ctx->mode;
+			ctx->mode = IMODE_IN_TABLE_TEXT;
+			return STATE_NONE;
+		}
+		if (TOKEN_IS_END_TAG(token, TAG_TABLE)) {
+			if (!has_element_in_scope(ctx, TAG_TABLE, SCOPE_TABLE)) {
+				print_err(ctx, token, ERROR_ELEMENT_NOT_IN_SCOPE);
+				return STATE_NONE;
+			}
+			if (pop_elem(ctx, TAG_TABLE) == NULL) {
+				print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
+				return STATE_NONE;
+			}
+			assert(ctx->head_elem);
+			ctx->mode = reset_imode(ctx, ctx->head_elem);
+			return STATE_NONE;
+		}
+		if (is_start_tag(token, 3, TAG_TBODY, TAG_TFOOT, TAG_THEAD)) {
+			clear_to_context(ctx, CONTEXT_TABLE);
+			insert_tag_set_mode(ctx, token, IMODE_IN_TABLE_BODY);
+			return STATE_NONE;
+		}
+		if (is_start_tag(token, 3, TAG_TD, TAG_TH, TAG_TR)) {
+			clear_to_context(ctx, CONTEXT_TABLE);
+			insert_tag_name_set_mode(ctx, "tbody", 0,
+			    IMODE_IN_TABLE_BODY);
+			return dispatch(ctx, token, ctx->begin, ctx->end);
+		}
+		return STATE_NONE;
+		break;
+	case IMODE_IN_TABLE_BODY:
+		if (TOKEN_IS_START_TAG(token, TAG_TR)) {
+			clear_to_context(ctx, CONTEXT_TABLE_BODY);
+			insert_tag_set_mode(ctx, token, IMODE_IN_ROW);
+			return STATE_NONE;
+		}
+		if (is_start_tag(token, 2, TAG_TH, TAG_TD)) {
+			print_err(ctx, token, ERROR_UNEXPECTED_TOKEN);
+			clear_to_context(ctx, CONTEXT_TABLE_BODY);
+			insert_tag_name_set_mode(ctx, "tr", 0, IMODE_IN_ROW);
+			return STATE_NONE;
+		}
+		return insert_token_with_mode(ctx, token, IMODE_IN_TABLE);
+	case IMODE_IN_ROW:
+		if (is_start_tag(token, 2, TAG_TH, TAG_TD)) {
+			clear_to_context(ctx, CONTEXT_TABLE_ROW);
+			insert_tag_set_mode(ctx, token, IMODE_IN_CELL);
+			return STATE_NONE;
+		}
+		if (is_end_tag(token, 1, TAG_TR)) {
+			if (!has_element_in_scope(ctx, TAG_TR, SCOPE_TABLE)) {
+				print_err(ctx, token, ERROR_ELEMENT_NOT_IN_SCOPE);
+				return STATE_NONE;
+			}
+			clear_to_context(ctx, CONTEXT_TABLE_ROW);
+			pop(ctx);
+			ctx->mode = IMODE_IN_TABLE_BODY;
+			return STATE_NONE;
+		}
+		if (is_start_tag(token, 7, TAG_CAPTION, TAG_COL, TAG_COLGROUP,
+		    TAG_TBODY, TAG_TFOOT, TAG_THEAD, TAG_TR) ||
+		    is_end_tag(token, 1, TAG_TABLE)) {
+			if (!has_element_in_scope(ctx, TAG_TR, SCOPE_TABLE)) {
+				print_err(ctx, token, ERROR_ELEMENT_NOT_IN_SCOPE);
+				return STATE_NONE;
+			}
+			clear_to_context(ctx, CONTEXT_TABLE_ROW);
+			if (ostack_peek(&ctx->ostack)->tagid != TAG_TR) {
+				print_err(ctx, token, ERROR_ELEMENT_NOT_IN_SCOPE);
+				return STATE_NONE;
+			}
+			pop(ctx);
+			ctx->mode = IMODE_IN_TABLE_BODY;
+			return dispatch(ctx, token, ctx->begin, ctx->end);
+		}
+		return STATE_NONE;
+	case IMODE_IN_CELL:
+		if (is_end_tag(token, 2, TAG_TH, TAG_TD)) {
+			if (!has_element_in_scope(ctx, token->u.tag.tagid,
+			    SCOPE_TABLE)) {
+				print_err(ctx, token, ERROR_ELEMENT_NOT_IN_SCOPE);
+				return STATE_NONE;
+			}
+			generate_implied_end_tags(ctx, -1);
+			if (ostack_peek(&ctx->ostack)->tagid != token->u.tag.tagid) {
+				print_err(ctx, token, ERROR_ELEMENT_NOT_IN_SCOPE);
+				return STATE_NONE;
+			}
+			pop_elem(ctx, token->u.tag.tagid);
+			ctx->mode = IMODE_IN_ROW;
+			return STATE_NONE;
+		}
+		if (is_start_tag(token, 9, TAG_CAPTION, TAG_COL, TAG_COLGROUP,
+		    TAG_TBODY, TAG_TD, TAG_TFOOT, TAG_TH, TAG_THEAD, TAG_TR)) {
+			if (!has_element_in_scope(ctx, TAG_TD, SCOPE_TABLE) &&
+			    !has_element_in_scope(ctx, TAG_TH, SCOPE_TABLE)) {
+				print_err(ctx, token, ERROR_ELEMENT_NOT_IN_SCOPE);
+				return STATE_NONE;
+			}
+			close_cell(ctx, token);
+			return dispatch(ctx, token, ctx->begin, ctx->end);	
+		}
+		if (is_end_tag(token, 5, TAG_BODY, TAG_CAPTION, TAG_COL,
+		    TAG_COLGROUP, TAG_HTML)) {
+			print_err(ctx, token, ERROR_UNEXPECTED_TOKEN);
+			return STATE_NONE;
+		}
+		if (is_end_tag(token, 5, TAG_TABLE, TAG_TBODY, TAG_TFOOT,
+		    TAG_THEAD, TAG_TR)) {
+			if (!has_element_in_scope(ctx, token->u.tag.tagid,
+			    SCOPE_TABLE)) {
+				print_err(ctx, token, ERROR_UNEXPECTED_TOKEN);
+				return STATE_NONE;
+			}
+			close_cell(ctx, token);
+			return dispatch(ctx, token, ctx->begin, ctx->end);
+		}
+		return insert_token_with_mode(ctx, token, IMODE_IN_BODY);
+	case IMODE_IN_TABLE_TEXT:
+		if (TOKEN_IS_SPACE(token)) {
+			insert_char(ctx, token);
+			return STATE_NONE;
+		} else {
+			ctx->mode = ctx->orig_mode;
+			return dispatch(ctx, token, ctx->begin, ctx->end);
+		}
+		return STATE_NONE;
+		break;
+	case IMODE_AFTER_AFTER_BODY:
+		break;
+	case IMODE_IN_HEAD_NOSCRIPT:
+		if (is_end_tag(token, 1, TAG_NOSCRIPT)) {
+			pop(ctx);
+		} else {
+			pop(ctx);
+		}
+		ctx->mode = IMODE_IN_HEAD;
+		break;
+	default:
+		return STATE_NONE;
+	}
+
+	/*
+	 * Catch all non-special tag operations.
+	 */
+	switch (mode) {
+	case IMODE_IN_HEAD:
+		if (TOKEN_IS_START(token))
+			insert_tag(ctx, token);
+		else if (TOKEN_IS_END(token))
+			insert_close_tag(ctx, token);
+		break;
+	case IMODE_IN_BODY:
+		if (TOKEN_IS_START(token))
+			insert_tag(ctx, token);
+		else if (TOKEN_IS_END(token)) {
+			/* "Any other end tag" */
+			node = ostack_peek(&ctx->ostack);
+loop:
+			if (node->ns == NS_HTML &&
+			    node->tagid == token->u.tag.tagid) {
+				generate_implied_end_tags(ctx,
+				    token->u.tag.tagid);
+				if (node->tagid != ostack_peek(&ctx->ostack)->tagid) {
+					print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
+					return STATE_NONE;
+				}
+				while (ostack_depth(&ctx->ostack) >= 1) {
+					if (node == ostack_peek(&ctx->ostack)) {
+						pop(ctx);
+						break;
+					} else {
+						pop(ctx);
+					}
+				}
+				return STATE_NONE;
+			} else if (tagmap(node->tagid)->flags &
+			    TAG_SPECIAL) {
+				print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
+				return STATE_NONE;
+			} else {
+				node = ostack_prev(&ctx->ostack, node);
+				if (node == NULL) {
+					print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
+					return STATE_NONE;
+				}
+				goto loop;
+			}
+		}
+		break;
+	default:
+		break;
+	}
+
+	return STATE_NONE;
+}
+
+/* helper */
+static void
+insert_token_set_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
+{
+	ctx->mode = mode;
+	insert_token_with_mode(ctx, token, ctx->mode);
+}
+
+#line 1713 "dispatch.c"
+#line 1 "tokenize.c"
+
+#line 20 "tokenize.c"
+#line 21 "tokenize.c"
+#line 22 "tokenize.c"
+#line 23 "tokenize.c"
+
+#include <ctype.h>
+#include <assert.h>
+#include <string.h>
+
+#line 1 "states.c"
+/* generated by enum.awk */
+static const char *states[] = {
+	"DATA",
+	"NONE",
+	"RCDATA",
+	"RCDATA_LT",
+	"RCDATA_END_TAG_OPEN",
+	"RCDATA_END_TAG_NAME",
+	"RAWTEXT",
+	"RAWTEXT_LT",
+	"RAWTEXT_END_TAG_OPEN",
+	"RAWTEXT_END_TAG_NAME",
+	"PLAINTEXT",
+	"TAG_OPEN",
+	"END_TAG_OPEN",
+	"TAG_NAME",
+	"BEFORE_ATTRIB_NAME",
+	"ATTRIB_NAME",
+	"AFTER_ATTRIB_NAME",
+	"BEFORE_ATTRIB_VAL",
+	"ATTRIB_VAL_QUOTED",
+	"ATTRIB_VAL_SQUOTED",
+	"ATTRIB_VAL",
+	"AFTER_ATTRIB_VAL_QUOTED",
+	"MARKUP_DECLARATION_OPEN",
+	"CHARACTER_REFERENCE",
+	"NAMED_CHAR_REF",
+	"NUM_CHAR_REF",
+	"COMMENT_START",
+	"COMMENT_START_DASH",
+	"COMMENT",
+	"COMMENT_LT",
+	"COMMENT_LT_BANG",
+	"COMMENT_LT_BANG_DASH",
+	"COMMENT_LT_BANG_DASH2",
+	"COMMENT_END_DASH",
+	"COMMENT_END",
+	"COMMENT_END_BANG",
+	"BOGUS_COMMENT",
+	"DOCTYPE",
+	"BEFORE_DOCTYPE_NAME",
+	"DOCTYPE_NAME",
+	"AFTER_DOCTYPE_NAME",
+	"BOGUS_DOCTYPE",
+	"SELF_CLOSING_START_TAG",
+	"SCRIPT_DATA",
+	"SCRIPT_DATA_LT",
+	"SCRIPT_DATA_ESC_START",
+	"SCRIPT_DATA_ESC_START_DASH",
+	"SCRIPT_DATA_ESC_DASH",
+	"SCRIPT_DATA_ESC_DASH2",
+	"SCRIPT_DATA_ESC_LT",
+	"SCRIPT_DATA_ESC_END_TAG_OPEN",
+	"SCRIPT_DATA_ESC_END_TAG_NAME",
+	"SCRIPT_DATA_DBL_ESC_START",
+	"SCRIPT_DATA_ESC",
+	"SCRIPT_DATA_END_TAG_OPEN",
+	"SCRIPT_DATA_END_TAG_NAME",
+	"SKIP_RCDATA",
+	"SKIP_RAWTEXT",
+	"SKIP_SCRIPT_DATA",
+};
+#line 29 "tokenize.c"
+
+/*
+ * A library built with -DPUREHTML_FAST does not count lines and leaves
+ * the end_line of tokens at 0, see report.h for the parse errors.
+ */
+#ifdef PUREHTML_FAST
+#define COUNT_LINE(_ctx, _c)	do { } while (0)
+#define MARK_END(_ctx) \
+	((_ctx)->token.end_offset = (_ctx)->offset)
+#else
+#define COUNT_LINE(_ctx, _c)	do { \
+	if ((_c) == '\n') \
+		(_ctx)->line++; \
+} while (0)
+#define MARK_END(_ctx)		do { \
+	(_ctx)->token.end_line = (_ctx)->line; \
+	(_ctx)->token.end_offset = (_ctx)->offset; \
+} while (0)
+#endif
+
+static void		 enter_state_return(struct tokenizer *, STATE, STATE);
+static struct token	*enter_state_emit(struct tokenizer *, STATE, struct token *);
+static struct token	*enter_state_emit_char(struct tokenizer *, STATE, char);
+static struct token	*enter_state_emit_doctype(struct tokenizer *, STATE);
+static void		 enter_state_reconsume(struct tokenizer *, STATE, char);
+static void		 enter_state(struct tokenizer *, STATE);
+static void		 tokenize_err(struct tokenizer *, enum errors);
+static void		 enter_state_err(struct tokenizer *, STATE, enum errors);
+static void		 new_token(struct tokenizer *, struct token);
+static void		 push_char(struct tokenizer *, char);
+static void		 set_tag_name(struct tokenizer *);
+static void		 set_attr(struct tokenizer *);
+static void		 skip_raw(struct tokenizer *, int);
+
+struct token *
+tokenize(struct tokenizer *ctx)
+{
+	char c;
+	char *p;
+
+	c = INPUT_GETC(&ctx->input);
+
+	if (c == EOF)
+		return NULL;
+
+	ctx->offset++;
+	STATS_ADD(bytes[ctx->state], 1);
+
+	COUNT_LINE(ctx, c);
+
+	/*
+	 * Additional prefilter for all modes and states, simplifying
+	 * the state machines.
+	 */
+	if (iscntrl(c) && (c != '\n' && c != '\t'))
+		return NULL;
+
+	/*
+	 * Whitespace rules.
+	 */
+	switch (ctx->state) {
+	case STATE_BEFORE_ATTRIB_NAME:
+	case STATE_AFTER_ATTRIB_NAME:
+	case STATE_BEFORE_ATTRIB_VAL:
+		if (HTML_ISSPACE(c))
+			return NULL;
+		break;
+	default:
+		break;
+	}
+
+	switch (ctx->state) {
+	/*
+	 *
+	 */
+	case STATE_SCRIPT_DATA:
+		if (c == '<')
+			enter_state(ctx, STATE_SCRIPT_DATA_LT);
+		else
+			return enter_state_emit_char(ctx, STATE_SCRIPT_DATA, c);
+		break;
+	case STATE_SCRIPT_DATA_LT:
+		if (c == '/')
+			enter_state(ctx, STATE_SCRIPT_DATA_END_TAG_OPEN);
+		else if (c == '!')
+			enter_state(ctx, STATE_SCRIPT_DATA_ESC_START);
+		else
+			enter_state_reconsume(ctx, STATE_SCRIPT_DATA, c);
+		break;
+	case STATE_SCRIPT_DATA_ESC_START:
+		if (c == '-')
+			enter_state(ctx, STATE_SCRIPT_DATA_ESC_START_DASH);
+		else
+			enter_state_reconsume(ctx, STATE_SCRIPT_DATA, c);
+		break;
+	case STATE_SCRIPT_DATA_ESC_START_DASH:
+		if (c == '-')
+			enter_state(ctx, STATE_SCRIPT_DATA_ESC_DASH2);
+		else
+			enter_state_reconsume(ctx, STATE_SCRIPT_DATA, c);
+		break;
+	case STATE_SCRIPT_DATA_ESC_DASH:
+		if (c == '-')
+			return enter_state_emit_char(ctx,
+			    STATE_SCRIPT_DATA_ESC_DASH2, c);
+		else if (c == '<')
+			enter_state(ctx, STATE_SCRIPT_DATA_ESC_LT);
+		else if (c == '>')
+			enter_state_emit_char(ctx, STATE_SCRIPT_DATA, c);
+		else
+			enter_state_emit_char(ctx, STATE_SCRIPT_DATA_ESC, c);
+		break;
+	case STATE_SCRIPT_DATA_ESC_DASH2:
+		if (c == '-')
+			return enter_state_emit_char(ctx,
+			    STATE_SCRIPT_DATA_ESC_DASH2, c);
+		else if (c == '<')
+			enter_state(ctx, STATE_SCRIPT_DATA_ESC_LT);
+		else if (c == '>')
+			enter_state_emit_char(ctx, STATE_SCRIPT_DATA, c);
+		else
+			enter_state_emit_char(ctx, STATE_SCRIPT_DATA_ESC, c);
+		break;
+	case STATE_SCRIPT_DATA_ESC_LT:
+		if (c == '/')
+			enter_state(ctx, STATE_SCRIPT_DATA_ESC_END_TAG_OPEN);
+		else if (isalpha(c))
+			enter_state(ctx, STATE_SCRIPT_DATA_DBL_ESC_START);
+		else
+			enter_state_reconsume(ctx, STATE_SCRIPT_DATA_ESC, c);
+		break;
+	case STATE_SCRIPT_DATA_ESC_END_TAG_OPEN:
+		if (isalpha(c))
+			enter_state_reconsume(ctx,
+			    STATE_SCRIPT_DATA_ESC_END_TAG_NAME, c);
+		else
+			enter_state_reconsume(ctx, STATE_SCRIPT_DATA_ESC, c);
+		break;
+	case STATE_SCRIPT_DATA_ESC_END_TAG_NAME:
+		if (HTML_ISSPACE(c))
+			enter_state(ctx, STATE_BEFORE_ATTRIB_NAME);
+		else
+			enter_state_reconsume(ctx, STATE_SCRIPT_DATA_ESC, c);
+		break;
+	case STATE_SCRIPT_DATA_DBL_ESC_START:
+		if (HTML_ISSPACE(c) || c == '/' || c == '>')
+			enter_state(ctx, STATE_SCRIPT_DATA_ESC);
+		else if (isalpha(c)) {
+			c = tolower(c);
+			return enter_state_emit(ctx,
+			    STATE_SCRIPT_DATA_DBL_ESC_START, &ctx->token);
+		} else
+			enter_state_reconsume(ctx, STATE_SCRIPT_DATA_ESC, c);
+		break;
+	case STATE_SCRIPT_DATA_ESC:
+		if (c == '-')
+			enter_state(ctx, STATE_SCRIPT_DATA_ESC_DASH);
+		else if (c == '<')
+			enter_state(ctx, STATE_SCRIPT_DATA_ESC_LT);
+		else
+			return enter_state_emit_char(ctx, STATE_SCRIPT_DATA_ESC, c);
+		break;
+	case STATE_SCRIPT_DATA_END_TAG_OPEN:
+		if (isalpha(c)) {
+			new_token(ctx, TOKEN_SET_END_TAG());
+			enter_state_reconsume(ctx, STATE_SCRIPT_DATA_END_TAG_NAME, c);
+		} else
+			enter_state_reconsume(ctx, STATE_SCRIPT_DATA, c);
+		break;
+	case STATE_SCRIPT_DATA_END_TAG_NAME:
+		if (HTML_ISSPACE(c))
+			enter_state(ctx, STATE_BEFORE_ATTRIB_NAME);
+		else if (c == '>') {
+			if (strcmp(ctx->name.s, "script") != 0) {
+				return enter_state_emit_char(ctx, STATE_SCRIPT_DATA, '<');
+			} else {
+				set_tag_name(ctx);
+				return enter_state_emit(ctx, STATE_DATA, &ctx->token);
+			}
+		} else if (isalpha(c)) {
+			str_add(&ctx->name, tolower(c));
+		} else {
+			return enter_state_emit_char(ctx, STATE_SCRIPT_DATA, '<');
+		}
+		break;
+
+	/*
+	 *
+	 */
+	case STATE_RAWTEXT:
+		if (c == '<')
+			enter_state(ctx, STATE_RAWTEXT_LT);
+		else
+			return enter_state_emit_char(ctx, STATE_RAWTEXT, c);
+		break;
+	case STATE_RAWTEXT_LT:
+		if (c == '/')
+			enter_state(ctx, STATE_RAWTEXT_END_TAG_OPEN);
+		else {
+			enter_state_emit_char(ctx, STATE_RAWTEXT, '<');
+			enter_state_reconsume(ctx, STATE_RAWTEXT, c);
+		}
+		break;
+	case STATE_RAWTEXT_END_TAG_OPEN:
+		if (isalpha(c)) {
+			new_token(ctx, TOKEN_SET_END_TAG());
+			enter_state_reconsume(ctx, STATE_RAWTEXT_END_TAG_NAME,
+			    c);
+		} else {
+			enter_state_emit_char(ctx, STATE_RAWTEXT, '<');
+			enter_state_emit_char(ctx, STATE_RAWTEXT, '/');
+			enter_state_reconsume(ctx, STATE_RAWTEXT, c);
+		}
+		break;
+	case STATE_RAWTEXT_END_TAG_NAME:
+		if (HTML_ISSPACE(c)) {
+			enter_state(ctx, STATE_BEFORE_ATTRIB_NAME);
+		} else if (c == '/') {
+		} else if (c == '>') {
+			set_tag_name(ctx);
+			return enter_state_emit(ctx, STATE_DATA, &ctx->token);
+		} else if (isalpha(c)) {
+			c = tolower(c);
+			str_add(&ctx->name, tolower(c));
+		} else
+			enter_state_reconsume(ctx, STATE_RAWTEXT, c);
+		break;
+
+	/*
+	 *
+	 */
+	case STATE_RCDATA:
+		if (c == '&')
+			enter_state_return(ctx, STATE_CHARACTER_REFERENCE,
+			    STATE_RCDATA);
+		else if (c == '<')
+			enter_state(ctx, STATE_RCDATA_LT);
+		else
+			return enter_state_emit_char(ctx, STATE_RCDATA, c);
+		break;
+	case STATE_RCDATA_LT:
+		if (c == '/')
+			enter_state(ctx, STATE_RCDATA_END_TAG_OPEN);
+		else {
+			enter_state_reconsume(ctx, STATE_RCDATA, c);
+			return enter_state_emit_char(ctx, STATE_RCDATA, '<');
+		}
+		break;
+	case STATE_RCDATA_END_TAG_OPEN:
+		if (isalpha(c)) {
+			new_token(ctx, TOKEN_SET_END_TAG());
+			enter_state_reconsume(ctx, STATE_RCDATA_END_TAG_NAME, c);
+		} else {
+			push_char(ctx, '<');
+			push_char(ctx, '/');
+			enter_state_reconsume(ctx, STATE_RCDATA, c);
+			return &ctx->token;
+		}
+		break;
+	case STATE_RCDATA_END_TAG_NAME:
+		if (HTML_ISSPACE(c))
+			enter_state(ctx, STATE_BEFORE_ATTRIB_NAME);
+		else if (c == '/')
+			ctx->token.u.tag.is_self_closing = 1;
+		else if (c == '>') {
+			set_tag_name(ctx);
+			return enter_state_emit(ctx, STATE_DATA, &ctx->token);
+		} else if (isalpha(c)) {
+			c = tolower(c);
+			str_add(&ctx->name, c);
+		} else {
+			push_char(ctx, '<');
+			push_char(ctx, '/');
+			p = ctx->name.s;
+			while (*p != '\0')
+				push_char(ctx, *p++);
+			enter_state_reconsume(ctx, STATE_RCDATA, c);
+			return &ctx->token;
+		}
+		break;
+	case STATE_DATA:
+		switch (c) {
+		case '<':
+			enter_state(ctx, STATE_TAG_OPEN);
+			return NULL;
+		case '&':
+			enter_state_return(ctx, STATE_CHARACTER_REFERENCE, STATE_DATA);
+			return NULL;
+		default:
+			return enter_state_emit_char(ctx, STATE_DATA, c);
+		}
+		break;
+	case STATE_TAG_OPEN:
+		switch (c) {
+		case '/':
+			enter_state(ctx, STATE_END_TAG_OPEN);
+			return NULL;
+		case '!':
+			enter_state(ctx, STATE_MARKUP_DECLARATION_OPEN);
+			return NULL;
+		default:
+			if (isalpha(c)) {
+				new_token(ctx, TOKEN_SET_START_TAG());
+				enter_state_reconsume(ctx, STATE_TAG_NAME, c);
+				return NULL;
+			}
+			break;
+		}
+		break;
+	case STATE_MARKUP_DECLARATION_OPEN:
+		ctx->buf[ctx->buf_len++] = c;
+		ctx->buf[ctx->buf_len] = '\0';
+
+		if (ctx->match == NULL) {
+			switch (c) {
+			case '-':
+				ctx->match = "--";
+				return NULL;
+			case 'D':
+				ctx->match = "DOCTYPE";
+				return NULL;
+			case '[':
+				ctx->match = "[CDATA[";
+				return NULL;
+			default:
+				goto err_markup_declaration_open;
+			}
+		} else if (ctx->buf[ctx->buf_len-1] != ctx->match[ctx->buf_len-1]) {
+			goto err_markup_declaration_open;
+		} else if (ctx->match[ctx->buf_len] == '\0') {
+			switch (ctx->match[0]) {
+			case '-':
+				enter_state(ctx, STATE_COMMENT_START);
+				return NULL;
+			case 'D':
+				enter_state(ctx, STATE_DOCTYPE);
+				return NULL;
+			case '[':
+				enter_state_err(ctx, STATE_BOGUS_COMMENT,
+				    ERROR_CDATA_IN_HTML_CONTENT);
+				return NULL;
+			default:
+				assert(0);
+			}
+		} else
+			return NULL;
+
+err_markup_declaration_open:
+		tokenize_err(ctx, ERROR_INCORRECTLY_OPENED_COMMENT);
+		enter_state(ctx, STATE_BOGUS_COMMENT);
+		return NULL;
+	case STATE_DOCTYPE:
+		if (HTML_ISSPACE(c)) {
+			enter_state(ctx, STATE_BEFORE_DOCTYPE_NAME);
+			return NULL;
+		} else if (c == '>') {
+			enter_state_reconsume(ctx, STATE_BEFORE_DOCTYPE_NAME, c);
+			return NULL;
+		} else {
+			tokenize_err(ctx,
+			    ERROR_MISSING_WHITESPACE_BEFORE_DOCTYPE_NAME);
+			enter_state_reconsume(ctx, STATE_BEFORE_DOCTYPE_NAME, c);
+			return NULL;
+		}
+		break;
+	case STATE_BEFORE_DOCTYPE_NAME:
+		if (HTML_ISSPACE(c)) {
+			return NULL;
+		} else if (c == '>') {
+			enter_state_err(ctx, STATE_DATA,
+			    ERROR_MISSING_DOCTYPE_NAME);
+			return NULL;
+		} else {
+			enter_state(ctx, STATE_DOCTYPE_NAME);
+			str_add(&ctx->name, '\0');
+			str_add(&ctx->name, c);
+			return NULL;
+		}
+		break;
+	case STATE_DOCTYPE_NAME:
+		if (HTML_ISSPACE(c)) {
+			enter_state(ctx, STATE_AFTER_DOCTYPE_NAME);
+			return NULL;
+		} else if (c == '>') {
+			enter_state_emit_doctype(ctx, STATE_DATA);
+			return NULL;
+		} else if (isupper(c)) {
+			c = tolower(c);
+			str_add(&ctx->name, c);
+		} else {
+			str_add(&ctx->name, c);
+		}
+		break;
+	case STATE_AFTER_DOCTYPE_NAME:
+		if (HTML_ISSPACE(c))
+			return NULL;
+		else if (c == '>') {
+			enter_state_emit_doctype(ctx, STATE_DATA);
+			return NULL;
+		} else {
+			enter_state(ctx, STATE_BOGUS_DOCTYPE);
+			return NULL;
+		}
+		break;
+	case STATE_BOGUS_DOCTYPE:
+		switch (c) {
+		case '>':
+			enter_state_emit_doctype(ctx, STATE_DATA);
+			return NULL;
+		default:
+			return NULL;
+		}
+		break;
+	case STATE_END_TAG_OPEN:
+		switch (c) {
+		case '>':	/* parse error */
+			enter_state(ctx, STATE_DATA);
+			return NULL;
+		}
+		if (isalpha(c)) {
+			new_token(ctx, TOKEN_SET_END_TAG());
+			enter_state_reconsume(ctx, STATE_TAG_NAME, c);
+			return NULL;
+		} else {
+			tokenize_err(ctx,
+			    ERROR_INVALID_FIRST_CHARACTER_OF_TAG_NAME);
+			enter_state_reconsume(ctx, STATE_BOGUS_COMMENT, c);
+			return NULL;
+		}
+		break;
+	case STATE_TAG_NAME:
+		if (HTML_ISSPACE(c)) {
+			set_tag_name(ctx);
+			enter_state(ctx, STATE_BEFORE_ATTRIB_NAME);
+			return NULL;
+		}
+		if (isupper(c))
+			c = tolower(c);
+			
+		switch (c) {
+		case '>':
+			set_tag_name(ctx);
+			return enter_state_emit(ctx, STATE_DATA, &ctx->token);
+		default:
+			str_add(&ctx->name, c);
+			return NULL;
+		}
+		break;
+	case STATE_BEFORE_ATTRIB_NAME:
+		if (c == '/' || c == '>')
+			enter_state_reconsume(ctx, STATE_AFTER_ATTRIB_NAME, c);
+		else if (c == '=') {
+			enter_state_err(ctx, STATE_ATTRIB_NAME,
+			    ERROR_UNEXPECTED_EQUALS_SIGN_BEFORE_ATTRIBUTE_NAME);
+		} else {
+			enter_state_reconsume(ctx, STATE_ATTRIB_NAME, c);
+		}
+		break;
+	case STATE_ATTRIB_NAME:
+		if (HTML_ISSPACE(c) || c == '/' || c == '>')
+			enter_state_reconsume(ctx, STATE_AFTER_ATTRIB_NAME, c);
+		else if (c == '=')
+			enter_state(ctx, STATE_BEFORE_ATTRIB_VAL);
+		else {
+			if (c == '\"' || c == '\'' || c == '<')
+				tokenize_err(ctx,
+				    ERROR_UNEXPECTED_CHARACTER_IN_ATTRIBUTE_NAME);
+			c = tolower(c);
+			str_add(&ctx->attrib_name, c);
+		}
+		break;
+	case STATE_AFTER_ATTRIB_NAME:
+		set_attr(ctx);
+		if (c == '/') {
+			enter_state(ctx, STATE_SELF_CLOSING_START_TAG);
+		} else if (c == '=')
+			enter_state(ctx, STATE_BEFORE_ATTRIB_VAL);
+		else if (c == '>')
+			return enter_state_emit(ctx, STATE_DATA, &ctx->token);
+		else
+			enter_state_reconsume(ctx, STATE_ATTRIB_NAME, c);
+		break;
+	case STATE_BEFORE_ATTRIB_VAL:
+		if (c == '\"')
+			enter_state(ctx, STATE_ATTRIB_VAL_QUOTED);
+		else if (c == '\'')
+			enter_state(ctx, STATE_ATTRIB_VAL_SQUOTED);
+		else if (c == '>') {
+			tokenize_err(ctx, ERROR_MISSING_ATTRIBUTE_VALUE);
+			return enter_state_emit(ctx, STATE_DATA, &ctx->token);
+		} else
+			enter_state(ctx, STATE_ATTRIB_VAL);
+		break;
+	case STATE_ATTRIB_VAL_QUOTED:
+		if (c == '\"')
+			enter_state(ctx, STATE_AFTER_ATTRIB_VAL_QUOTED);
+		else
+			str_add(&ctx->attrib_value, c);
+		break;
+	case STATE_ATTRIB_VAL_SQUOTED:
+		if (c == '\'')
+			enter_state(ctx, STATE_AFTER_ATTRIB_VAL_QUOTED);
+		else
+			str_add(&ctx->attrib_value, c);
+		break;
+	case STATE_ATTRIB_VAL:
+		if (HTML_ISSPACE(c)) {
+			enter_state(ctx, STATE_BEFORE_ATTRIB_NAME);
+		} else if (c == '&') {
+			enter_state_return(ctx, STATE_CHARACTER_REFERENCE,
+			    STATE_ATTRIB_VAL);
+		} else if (c == '>') {
+			set_attr(ctx);
+			return enter_state_emit(ctx, STATE_DATA, &ctx->token);
+		} else if (c == '\"' || c == '\'' || c == '<' || c == '=' ||
+		    c == '`') {
+			tokenize_err(ctx,
+			    ERROR_UNEXPECTED_CHARACTER_IN_UNQUOTED_ATTRIBUTE_VALUE);
+		} else {
+			str_add(&ctx->attrib_value, c);
+			/* TODO */
+		}
+		break;
+	case STATE_AFTER_ATTRIB_VAL_QUOTED:
+		if (HTML_ISSPACE(c))
+			enter_state(ctx, STATE_BEFORE_ATTRIB_NAME);
+		else if (c == '/')
+			enter_state(ctx, STATE_SELF_CLOSING_START_TAG);
+		else if (c == '>') {
+			set_attr(ctx);
+			return enter_state_emit(ctx, STATE_DATA, &ctx->token);
+		} else {
+			tokenize_err(ctx,
+			    ERROR_MISSING_WHITESPACE_BETWEEN_ATTRIBUTES);
+			enter_state_reconsume(ctx, STATE_BEFORE_ATTRIB_NAME, c);
+		}
+		break;
+	case STATE_SELF_CLOSING_START_TAG:
+		if (c == '>') {
+			set_attr(ctx);
+			return enter_state_emit(ctx, STATE_DATA, &ctx->token);
+		} else {
+			tokenize_err(ctx, ERROR_UNEXPECTED_SOLIDUS_IN_TAG);
+			enter_state(ctx, STATE_BEFORE_ATTRIB_NAME);
+		}
+		break;
+	case STATE_COMMENT_START:
+		if (c == '-')
+			enter_state(ctx, STATE_COMMENT_START_DASH);
+		else if (c == '>') {
+			tokenize_err(ctx, ERROR_ABRUPT_CLOSING_OF_EMPTY_COMMENT);
+			return enter_state_emit(ctx, STATE_DATA, &ctx->token);
+		} else
+			enter_state_reconsume(ctx, STATE_COMMENT, c);
+		break;
+	case STATE_COMMENT_START_DASH:
+		if (c == '-')
+			enter_state(ctx, STATE_COMMENT_END);
+		else if (c == '>') {
+			tokenize_err(ctx, ERROR_ABRUPT_CLOSING_OF_EMPTY_COMMENT);
+			enter_state(ctx, STATE_DATA);
+		} else
+			enter_state_reconsume(ctx, STATE_COMMENT, c);
+		break;
+	case STATE_COMMENT:
+		if (c == '<')
+			enter_state(ctx, STATE_COMMENT_LT);
+		else if (c == '-')
+			enter_state(ctx, STATE_COMMENT_END_DASH);
+		break;
+	case STATE_COMMENT_LT:
+		if (c == '!')
+			enter_state(ctx, STATE_COMMENT_LT_BANG);
+		else if (c == '<') {
+		} else
+			enter_state_reconsume(ctx, STATE_COMMENT, c);
+		break;
+	case STATE_COMMENT_LT_BANG:
+		if (c == '-')
+			enter_state(ctx, STATE_COMMENT_LT_BANG_DASH);
+		else
+			enter_state_reconsume(ctx, STATE_COMMENT, c);
+		break;
+	case STATE_COMMENT_LT_BANG_DASH:
+		if (c == '-')
+			enter_state(ctx, STATE_COMMENT_LT_BANG_DASH2);
+		else
+			enter_state_reconsume(ctx, STATE_COMMENT_END_DASH, c);
+		break;
+	case STATE_COMMENT_LT_BANG_DASH2:
+		if (c == '>')
+			enter_state_reconsume(ctx, STATE_COMMENT_END, c);
+		else {
+			tokenize_err(ctx, ERROR_NESTED_COMMENT);
+			enter_state_reconsume(ctx, STATE_COMMENT_END, c);
+		}
+		break;
+	case STATE_COMMENT_END_DASH:
+		if (c == '-')
+			enter_state(ctx, STATE_COMMENT_END);
+		else
+			enter_state(ctx, STATE_COMMENT);
+		break;
+	case STATE_COMMENT_END:
+		if (c == '>')
+			enter_state(ctx, STATE_DATA);
+		else if (c == '!')
+			enter_state(ctx, STATE_COMMENT_END_BANG);
+		else if (c == '-') {
+		} else
+			enter_state_reconsume(ctx, STATE_COMMENT, c);
+		break;
+	case STATE_COMMENT_END_BANG:
+		if (c == '-')
+			enter_state(ctx, STATE_COMMENT_END_DASH);
+		else if (c == '>') {
+			tokenize_err(ctx, ERROR_INCORRECTLY_CLOSED_COMMENT);
+			enter_state(ctx, STATE_DATA);
+		} else
+			enter_state_reconsume(ctx, STATE_COMMENT, c);
+		break;
+	case STATE_BOGUS_COMMENT:
+		if (c == '>')
+			enter_state(ctx, STATE_DATA);
+		break;
+	case STATE_CHARACTER_REFERENCE:
+		if (isalnum(c))
+			enter_state_reconsume(ctx, STATE_NAMED_CHAR_REF, c);
+		else if (c == '#')
+			enter_state(ctx, STATE_NUM_CHAR_REF);
+		else
+			enter_state(ctx, ctx->return_state);
+		break;
+	case STATE_NAMED_CHAR_REF:
+		enter_state(ctx, ctx->return_state);
+		break;
+	case STATE_NUM_CHAR_REF:
+		enter_state(ctx, ctx->return_state);
+		break;
+	case STATE_SKIP_RCDATA:
+	case STATE_SKIP_RAWTEXT:
+	case STATE_SKIP_SCRIPT_DATA:
+		skip_raw(ctx, c);
+		break;
+	default:
+		printf("State: %s\n", states[ctx->state]);
+		assert(0);
+		break;
+	}
+
+	return NULL;
+}
+
+static void
+enter_state(struct tokenizer *ctx, STATE state)
+{
+#if 0
+	printf("State str: %-30s\n", states[state]);
+#endif
+
+	switch (state) {
+	case STATE_SCRIPT_DATA_END_TAG_NAME:
+	case STATE_RAWTEXT_END_TAG_NAME:
+	case STATE_RCDATA_END_TAG_NAME:
+	case STATE_TAG_NAME:
+		str_add(&ctx->name, '\0');
+		break;
+	case STATE_BEFORE_ATTRIB_VAL:
+		str_add(&ctx->attrib_value, '\0');
+		break;
+	case STATE_BEFORE_ATTRIB_NAME:
+		set_attr(ctx);
+		break;
+	case STATE_ATTRIB_NAME:
+		str_add(&ctx->attrib_name, '\0');
+		break;
+	case STATE_MARKUP_DECLARATION_OPEN:
+		ctx->match = NULL;
+		ctx->buf_len = 0;
+		break;
+	case STATE_COMMENT_START:
+	case STATE_BOGUS_COMMENT:
+	case STATE_COMMENT:
+		new_token(ctx, TOKEN_SET_COMMENT());
+		break;
+	default:
+		break;
+	}
+
+	ctx->state = state;
+}
+
+static void
+enter_state_return(struct tokenizer *ctx, STATE state, STATE ret)
+{
+	enter_state(ctx, state);
+	ctx->return_state = ret;
+}
+
+static struct token *
+enter_state_emit(struct tokenizer *ctx, STATE state, struct token *token)
+{
+	enter_state(ctx, state);
+	MARK_END(ctx);
+
+	return &ctx->token;
+}
+
+/*
+ * Start a new token, keeping the buffer of the character tokens.
+ */
+static void
+new_token(struct tokenizer *ctx, struct token token)
+{
+	struct str s;
+
+	s = ctx->token.s;
+	ctx->token = token;
+	ctx->token.s = s;
+	str_add(&ctx->token.s, '\0');
+	attr_index_clear(&ctx->attrs);
+}
+
+static void
+push_char(struct tokenizer *ctx, char c)
+{
+	ctx->token.type = TOKEN_CHAR;
+	MARK_END(ctx);
+	str_add(&ctx->token.s, c);
+}
+
+/*
+ * With a pool the names of custom tags are interned, see
+ * attr_pool_name(), instead of copied for every tag.
+ */
+static void
+set_tag_name(struct tokenizer *ctx)
+{
+	struct tagtoken *tag;
+
+	tag = &ctx->token.u.tag;
+	if (ctx->attrs.pool == NULL) {
+		token_set_tag_name(&ctx->token, ctx->name.s);
+		return;
+	}
+
+	tag->tagid = tagmap_id(ctx->name.s);
+	if (tag->tagid != 0)
+		tag->name = tagmap(tag->tagid)->name;
+	else if ((tag->name = attr_pool_name(ctx->attrs.pool,
+	    ctx->name.s)) != NULL)
+		tag->shared_name = 1;
+	else
+		token_set_tag_name(&ctx->token, ctx->name.s);
+}
+
+/*
+ * Attributes are not collected at all while the consumer skips the
+ * subtree, see no_attrs.
+ */
+static void
+set_attr(struct tokenizer *ctx)
+{
+	if (ctx->no_attrs || ctx->attrib_name.s == NULL ||
+	    *ctx->attrib_name.s == '\0')
+		return;
+
+	assert(TOKEN_IS_START_END(&ctx->token));
+	attr_index_set(&ctx->attrs, &ctx->token.u.tag.attr,
+	    ctx->attrib_name.s, ctx->attrib_value.s);
+}
+
+/*
+ * Fast-forward the raw text of a skipped element up to the next "</"
+ * without emitting character tokens, then continue in the regular end
+ * tag open state so that the end tag gets tokenized as usual.
+ */
+static void
+skip_raw(struct tokenizer *ctx, int c)
+{
+	int prev;
+
+	prev = '\0';
+	for (;;) {
+		if (prev == '<' && c == '/')
+			break;
+		prev = c;
+		c = INPUT_GETC(&ctx->input);
+		if (c == EOF)
+			return;
+		ctx->offset++;
+		COUNT_LINE(ctx, c);
+	}
+
+	switch (ctx->state) {
+	case STATE_SKIP_RCDATA:
+		enter_state(ctx, STATE_RCDATA_END_TAG_OPEN);
+		break;
+	case STATE_SKIP_RAWTEXT:
+		enter_state(ctx, STATE_RAWTEXT_END_TAG_OPEN);
+		break;
+	case STATE_SKIP_SCRIPT_DATA:
+		enter_state(ctx, STATE_SCRIPT_DATA_END_TAG_OPEN);
+		break;
+	default:
+		assert(0);
+	}
+}
+
+static struct token *
+enter_state_emit_char(struct tokenizer *ctx, STATE state, char c)
+{
+	push_char(ctx, c);
+	enter_state(ctx, state);
+
+	return &ctx->token;
+}
+
+static struct token *
+enter_state_emit_doctype(struct tokenizer *ctx, STATE state)
+{
+	new_token(ctx, TOKEN_SET_DOCTYPE());
+	MARK_END(ctx);
+
+	enter_state(ctx, state);
+
+	return &ctx->token;
+}
+
+static void
+enter_state_reconsume(struct tokenizer *ctx, STATE state, char c)
+{
+	enter_state(ctx, state);
+	STATS_ADD(reconsumes, 1);
+
+	ctx->offset--;
+#if 0
+	printf("RECONSUME c='%c'\n", c);
+#endif
+	INPUT_UNGETC(&ctx->input);
+}
+
+static void
+tokenize_err(struct tokenizer *ctx, enum errors code)
+{
+	assert(ctx != NULL);
+
+	REPORT(ctx->report, code, ctx->line + 1, ctx->offset);
+}
+
+static void
+enter_state_err(struct tokenizer *ctx, STATE state, enum errors code)
+{
+	tokenize_err(ctx, code);
+	enter_state(ctx, state);
+}
+
+#line 923 "tokenize.c"
+
+#line 990 "tokenize.c"
+#undef COUNT_LINE
+#undef MARK_END
+#line 1 "tagmap.c"
+
+#line 20 "tagmap.c"
+
+#include <string.h>
+#include <assert.h>
+#include <err.h>
+
+#line 1 "tags.c"
+/* generated by tags.awk */
+static const struct tag tags[] = {
+	{ NULL, 0 }, /* 0 */
+	{ NULL, 0 }, /* 1 */
+	{ NULL, 0 }, /* 2 */
+	{ "noframes", TAG_SPECIAL | TAG_RAWTEXT }, /* 3 */
+	{ NULL, 0 }, /* 4 */
+	{ NULL, 0 }, /* 5 */
+	{ NULL, 0 }, /* 6 */
+	{ NULL, 0 }, /* 7 */
+	{ NULL, 0 }, /* 8 */
+	{ "q", 0 }, /* 9 */
+	{ NULL, 0 }, /* 10 */
+	{ NULL, 0 }, /* 11 */
+	{ NULL, 0 }, /* 12 */
+	{ NULL, 0 }, /* 13 */
+	{ NULL, 0 }, /* 14 */
+	{ NULL, 0 }, /* 15 */
+	{ NULL, 0 }, /* 16 */
+	{ NULL, 0 }, /* 17 */
+	{ NULL, 0 }, /* 18 */
+	{ NULL, 0 }, /* 19 */
+	{ NULL, 0 }, /* 20 */
+	{ "h5", TAG_BLOCK | TAG_SPECIAL | TAG_HEADING }, /* 21 */
+	{ NULL, 0 }, /* 22 */
+	{ "frameset", TAG_SPECIAL }, /* 23 */
+	{ NULL, 0 }, /* 24 */
+	{ "var", 0 }, /* 25 */
+	{ NULL, 0 }, /* 26 */
+	{ NULL, 0 }, /* 27 */
+	{ NULL, 0 }, /* 28 */
+	{ NULL, 0 }, /* 29 */
+	{ "aside", TAG_BLOCK | TAG_SPECIAL }, /* 30 */
+	{ NULL, 0 }, /* 31 */
+	{ NULL, 0 }, /* 32 */
+	{ NULL, 0 }, /* 33 */
+	{ NULL, 0 }, /* 34 */
+	{ NULL, 0 }, /* 35 */
+	{ NULL, 0 }, /* 36 */
+	{ NULL, 0 }, /* 37 */
+	{ NULL, 0 }, /* 38 */
+	{ NULL, 0 }, /* 39 */
+	{ NULL, 0 }, /* 40 */
+	{ NULL, 0 }, /* 41 */
+	{ NULL, 0 }, /* 42 */
+	{ NULL, 0 }, /* 43 */
+	{ NULL, 0 }, /* 44 */
+	{ NULL, 0 }, /* 45 */
+	{ NULL, 0 }, /* 46 */
+	{ NULL, 0 }, /* 47 */
+	{ NULL, 0 }, /* 48 */
+	{ NULL, 0 }, /* 49 */
+	{ "slot", 0 }, /* 50 */
+	{ NULL, 0 }, /* 51 */
+	{ NULL, 0 }, /* 52 */
+	{ "nav", TAG_BLOCK | TAG_SPECIAL }, /* 53 */
+	{ NULL, 0 }, /* 54 */
+	{ NULL, 0 }, /* 55 */
+	{ NULL, 0 }, /* 56 */
+	{ NULL, 0 }, /* 57 */
+	{ "figure", TAG_BLOCK | TAG_SPECIAL }, /* 58 */
+	{ "em", TAG_FORMAT } /* jump 1 */, /* 59 */
+	{ NULL, 0 }, /* 60 */
+	{ NULL, 0 }, /* 61 */
+	{ NULL, 0 }, /* 62 */
+	{ NULL, 0 }, /* 63 */
+	{ NULL, 0 }, /* 64 */
+	{ NULL, 0 }, /* 65 */
+	{ NULL, 0 }, /* 66 */
+	{ NULL, 0 }, /* 67 */
+	{ NULL, 0 }, /* 68 */
+	{ NULL, 0 }, /* 69 */
+	{ NULL, 0 }, /* 70 */
+	{ NULL, 0 }, /* 71 */
+	{ NULL, 0 }, /* 72 */
+	{ NULL, 0 }, /* 73 */
+	{ NULL, 0 }, /* 74 */
+	{ NULL, 0 }, /* 75 */
+	{ NULL, 0 }, /* 76 */
+	{ NULL, 0 }, /* 77 */
+	{ "COMMENT_TAG", TAG_EMPTY }, /* 78 */
+	{ NULL, 0 }, /* 79 */
+	{ NULL, 0 }, /* 80 */
+	{ NULL, 0 }, /* 81 */
+	{ NULL, 0 }, /* 82 */
+	{ NULL, 0 }, /* 83 */
+	{ NULL, 0 }, /* 84 */
+	{ "script", TAG_SPECIAL | TAG_RAWTEXT }, /* 85 */
+	{ "EXCLAIM_TAG", TAG_EMPTY }, /* 86 */
+	{ "tr", TAG_OPTIONAL_CLOSE | TAG_SPECIAL } /* jump 1 */, /* 87 */
+	{ NULL, 0 }, /* 88 */
+	{ NULL, 0 }, /* 89 */
+	{ NULL, 0 }, /* 90 */
+	{ NULL, 0 }, /* 91 */
+	{ NULL, 0 }, /* 92 */
+	{ NULL, 0 }, /* 93 */
+	{ "thead", TAG_OPTIONAL_CLOSE | TAG_SPECIAL }, /* 94 */
+	{ NULL, 0 }, /* 95 */
+	{ NULL, 0 }, /* 96 */
+	{ NULL, 0 }, /* 97 */
+	{ NULL, 0 }, /* 98 */
+	{ NULL, 0 }, /* 99 */
+	{ "br", TAG_EMPTY | TAG_SPECIAL }, /* 100 */
+	{ NULL, 0 }, /* 101 */
+	{ NULL, 0 }, /* 102 */
+	{ NULL, 0 }, /* 103 */
+	{ NULL, 0 }, /* 104 */
+	{ NULL, 0 }, /* 105 */
+	{ NULL, 0 }, /* 106 */
+	{ NULL, 0 }, /* 107 */
+	{ NULL, 0 }, /* 108 */
+	{ "u", TAG_FORMAT }, /* 109 */
+	{ NULL, 0 }, /* 110 */
+	{ NULL, 0 }, /* 111 */
+	{ NULL, 0 }, /* 112 */
+	{ NULL, 0 }, /* 113 */
+	{ NULL, 0 }, /* 114 */
+	{ NULL, 0 }, /* 115 */
+	{ NULL, 0 }, /* 116 */
+	{ NULL, 0 }, /* 117 */
+	{ NULL, 0 }, /* 118 */
+	{ NULL, 0 }, /* 119 */
+	{ NULL, 0 }, /* 120 */
+	{ NULL, 0 }, /* 121 */
+	{ NULL, 0 }, /* 122 */
+	{ NULL, 0 }, /* 123 */
+	{ "article", TAG_BLOCK | TAG_SPECIAL }, /* 124 */
+	{ NULL, 0 }, /* 125 */
+	{ NULL, 0 }, /* 126 */
+	{ NULL, 0 }, /* 127 */
+	{ NULL, 0 }, /* 128 */
+	{ NULL, 0 }, /* 129 */
+	{ NULL, 0 }, /* 130 */
+	{ NULL, 0 }, /* 131 */
+	{ NULL, 0 }, /* 132 */
+	{ NULL, 0 }, /* 133 */
+	{ NULL, 0 }, /* 134 */
+	{ NULL, 0 }, /* 135 */
+	{ NULL, 0 }, /* 136 */
+	{ NULL, 0 }, /* 137 */
+	{ NULL, 0 }, /* 138 */
+	{ NULL, 0 }, /* 139 */
+	{ "canvas", 0 }, /* 140 */
+	{ NULL, 0 }, /* 141 */
+	{ NULL, 0 }, /* 142 */
+	{ NULL, 0 }, /* 143 */
+	{ NULL, 0 }, /* 144 */
+	{ NULL, 0 }, /* 145 */
+	{ NULL, 0 }, /* 146 */
+	{ "wbr", TAG_EMPTY | TAG_SPECIAL }, /* 147 */
+	{ NULL, 0 }, /* 148 */
+	{ "meter", 0 }, /* 149 */
+	{ NULL, 0 }, /* 150 */
+	{ NULL, 0 }, /* 151 */
+	{ NULL, 0 }, /* 152 */
+	{ NULL, 0 }, /* 153 */
+	{ NULL, 0 }, /* 154 */
+	{ NULL, 0 }, /* 155 */
+	{ NULL, 0 }, /* 156 */
+	{ NULL, 0 }, /* 157 */
+	{ "link", TAG_EMPTY | TAG_SPECIAL }, /* 158 */
+	{ "time", 0 }, /* 159 */
+	{ NULL, 0 }, /* 160 */
+	{ NULL, 0 }, /* 161 */
+	{ NULL, 0 }, /* 162 */
+	{ NULL, 0 }, /* 163 */
+	{ NULL, 0 }, /* 164 */
+	{ NULL, 0 }, /* 165 */
+	{ NULL, 0 }, /* 166 */
+	{ NULL, 0 }, /* 167 */
+	{ NULL, 0 }, /* 168 */
+	{ "plaintext", TAG_SPECIAL | TAG_PREFORMATTED | TAG_RAWTEXT }, /* 169 */
+	{ NULL, 0 }, /* 170 */
+	{ NULL, 0 }, /* 171 */
+	{ NULL, 0 }, /* 172 */
+	{ NULL, 0 }, /* 173 */
+	{ NULL, 0 }, /* 174 */
+	{ NULL, 0 }, /* 175 */
+	{ NULL, 0 }, /* 176 */
+	{ NULL, 0 }, /* 177 */
+	{ NULL, 0 }, /* 178 */
+	{ "colgroup", TAG_OPTIONAL_CLOSE | TAG_SPECIAL }, /* 179 */
+	{ "tfoot", TAG_OPTIONAL_CLOSE | TAG_SPECIAL }, /* 180 */
+	{ NULL, 0 }, /* 181 */
+	{ NULL, 0 }, /* 182 */
+	{ NULL, 0 }, /* 183 */
+	{ NULL, 0 }, /* 184 */
+	{ NULL, 0 }, /* 185 */
+	{ "title", TAG_SPECIAL | TAG_RAWTEXT }, /* 186 */
+	{ NULL, 0 }, /* 187 */
+	{ NULL, 0 }, /* 188 */
+	{ NULL, 0 }, /* 189 */
+	{ NULL, 0 }, /* 190 */
+	{ NULL, 0 }, /* 191 */
+	{ NULL, 0 }, /* 192 */
+	{ NULL, 0 }, /* 193 */
+	{ NULL, 0 }, /* 194 */
+	{ NULL, 0 }, /* 195 */
+	{ NULL, 0 }, /* 196 */
+	{ NULL, 0 }, /* 197 */
+	{ NULL, 0 }, /* 198 */
+	{ NULL, 0 }, /* 199 */
+	{ NULL, 0 }, /* 200 */
+	{ "kbd", 0 }, /* 201 */
+	{ "h2", TAG_BLOCK | TAG_SPECIAL | TAG_HEADING }, /* 202 */
+	{ "output", 0 } /* jump 2 */, /* 203 */
+	{ NULL, 0 }, /* 204 */
+	{ NULL, 0 }, /* 205 */
+	{ NULL, 0 }, /* 206 */
+	{ NULL, 0 }, /* 207 */
+	{ NULL, 0 }, /* 208 */
+	{ NULL, 0 }, /* 209 */
+	{ NULL, 0 }, /* 210 */
+	{ NULL, 0 }, /* 211 */
+	{ NULL, 0 }, /* 212 */
+	{ NULL, 0 }, /* 213 */
+	{ NULL, 0 }, /* 214 */
+	{ NULL, 0 }, /* 215 */
+	{ NULL, 0 }, /* 216 */
+	{ NULL, 0 }, /* 217 */
+	{ NULL, 0 }, /* 218 */
+	{ NULL, 0 }, /* 219 */
+	{ NULL, 0 }, /* 220 */
+	{ "img", TAG_EMPTY | TAG_SPECIAL }, /* 221 */
+	{ NULL, 0 }, /* 222 */
+	{ NULL, 0 }, /* 223 */
+	{ "dialog", TAG_BLOCK }, /* 224 */
+	{ NULL, 0 }, /* 225 */
+	{ "audio", 0 }, /* 226 */
+	{ NULL, 0 }, /* 227 */
+	{ NULL, 0 }, /* 228 */
+	{ NULL, 0 }, /* 229 */
+	{ NULL, 0 }, /* 230 */
+	{ NULL, 0 }, /* 231 */
+	{ NULL, 0 }, /* 232 */
+	{ NULL, 0 }, /* 233 */
+	{ NULL, 0 }, /* 234 */
+	{ "code", TAG_FORMAT }, /* 235 */
+	{ NULL, 0 }, /* 236 */
+	{ "strong", TAG_FORMAT }, /* 237 */
+	{ NULL, 0 }, /* 238 */
+	{ NULL, 0 }, /* 239 */
+	{ NULL, 0 }, /* 240 */
+	{ NULL, 0 }, /* 241 */
+	{ NULL, 0 }, /* 242 */
+	{ NULL, 0 }, /* 243 */
+	{ NULL, 0 }, /* 244 */
+	{ NULL, 0 }, /* 245 */
+	{ NULL, 0 }, /* 246 */
+	{ NULL, 0 }, /* 247 */
+	{ "td", TAG_OPTIONAL_CLOSE | TAG_SPECIAL }, /* 248 */
+	{ NULL, 0 }, /* 249 */
+	{ "data", 0 }, /* 250 */
+	{ NULL, 0 }, /* 251 */
+	{ NULL, 0 }, /* 252 */
+	{ NULL, 0 }, /* 253 */
+	{ "body", TAG_OPTIONAL_CLOSE | TAG_SPECIAL }, /* 254 */
+	{ NULL, 0 }, /* 255 */
+	{ NULL, 0 }, /* 256 */
+	{ NULL, 0 }, /* 257 */
+	{ NULL, 0 }, /* 258 */
+	{ NULL, 0 }, /* 259 */
+	{ NULL, 0 }, /* 260 */
+	{ NULL, 0 }, /* 261 */
+	{ NULL, 0 }, /* 262 */
+	{ NULL, 0 }, /* 263 */
+	{ NULL, 0 }, /* 264 */
+	{ "center", TAG_SPECIAL }, /* 265 */
+	{ NULL, 0 }, /* 266 */
+	{ NULL, 0 }, /* 267 */
+	{ NULL, 0 }, /* 268 */
+	{ NULL, 0 }, /* 269 */
+	{ NULL, 0 }, /* 270 */
+	{ NULL, 0 }, /* 271 */
+	{ "table", TAG_BLOCK | TAG_SPECIAL }, /* 272 */
+	{ NULL, 0 }, /* 273 */
+	{ NULL, 0 }, /* 274 */
+	{ NULL, 0 }, /* 275 */
+	{ NULL, 0 }, /* 276 */
+	{ NULL, 0 }, /* 277 */
+	{ NULL, 0 }, /* 278 */
+	{ NULL, 0 }, /* 279 */
+	{ NULL, 0 }, /* 280 */
+	{ NULL, 0 }, /* 281 */
+	{ NULL, 0 }, /* 282 */
+	{ NULL, 0 }, /* 283 */
+	{ NULL, 0 }, /* 284 */
+	{ NULL, 0 }, /* 285 */
+	{ "caption", TAG_OPTIONAL_CLOSE | TAG_SPECIAL }, /* 286 */
+	{ "pre", TAG_BLOCK | TAG_SPECIAL | TAG_PREFORMATTED }, /* 287 */
+	{ NULL, 0 }, /* 288 */
+	{ NULL, 0 }, /* 289 */
+	{ NULL, 0 }, /* 290 */
+	{ NULL, 0 }, /* 291 */
+	{ NULL, 0 }, /* 292 */
+	{ NULL, 0 }, /* 293 */
+	{ NULL, 0 }, /* 294 */
+	{ NULL, 0 }, /* 295 */
+	{ NULL, 0 }, /* 296 */
+	{ NULL, 0 }, /* 297 */
+	{ NULL, 0 }, /* 298 */
+	{ "base", TAG_EMPTY | TAG_SPECIAL }, /* 299 */
+	{ NULL, 0 }, /* 300 */
+	{ NULL, 0 }, /* 301 */
+	{ "h6", TAG_BLOCK | TAG_SPECIAL | TAG_HEADING }, /* 302 */
+	{ NULL, 0 }, /* 303 */
+	{ "svg", 0 }, /* 304 */
+	{ "optgroup", 0 } /* jump 1 */, /* 305 */
+	{ "strike", TAG_FORMAT }, /* 306 */
+	{ NULL, 0 }, /* 307 */
+	{ NULL, 0 }, /* 308 */
+	{ NULL, 0 }, /* 309 */
+	{ NULL, 0 }, /* 310 */
+	{ NULL, 0 }, /* 311 */
+	{ NULL, 0 }, /* 312 */
+	{ NULL, 0 }, /* 313 */
+	{ "basefont", TAG_SPECIAL }, /* 314 */
+	{ NULL, 0 }, /* 315 */
+	{ NULL, 0 }, /* 316 */
+	{ NULL, 0 }, /* 317 */
+	{ NULL, 0 }, /* 318 */
+	{ NULL, 0 }, /* 319 */
+	{ NULL, 0 }, /* 320 */
+	{ NULL, 0 }, /* 321 */
+	{ "rp", 0 }, /* 322 */
+	{ NULL, 0 }, /* 323 */
+	{ NULL, 0 }, /* 324 */
+	{ NULL, 0 }, /* 325 */
+	{ NULL, 0 }, /* 326 */
+	{ NULL, 0 }, /* 327 */
+	{ "dfn", 0 }, /* 328 */
+	{ NULL, 0 }, /* 329 */
+	{ NULL, 0 }, /* 330 */
+	{ NULL, 0 }, /* 331 */
+	{ NULL, 0 }, /* 332 */
+	{ "section", TAG_BLOCK | TAG_SPECIAL }, /* 333 */
+	{ NULL, 0 }, /* 334 */
+	{ NULL, 0 }, /* 335 */
+	{ NULL, 0 }, /* 336 */
+	{ "area", TAG_EMPTY | TAG_SPECIAL }, /* 337 */
+	{ NULL, 0 }, /* 338 */
+	{ NULL, 0 }, /* 339 */
+	{ NULL, 0 }, /* 340 */
+	{ "menu", TAG_BLOCK | TAG_SPECIAL }, /* 341 */
+	{ NULL, 0 }, /* 342 */
+	{ NULL, 0 }, /* 343 */
+	{ NULL, 0 }, /* 344 */
+	{ NULL, 0 }, /* 345 */
+	{ NULL, 0 }, /* 346 */
+	{ NULL, 0 }, /* 347 */
+	{ "th", TAG_OPTIONAL_CLOSE | TAG_SPECIAL }, /* 348 */
+	{ NULL, 0 }, /* 349 */
+	{ NULL, 0 }, /* 350 */
+	{ NULL, 0 }, /* 351 */
+	{ NULL, 0 }, /* 352 */
+	{ NULL, 0 }, /* 353 */
+	{ NULL, 0 }, /* 354 */
+	{ NULL, 0 }, /* 355 */
+	{ NULL, 0 }, /* 356 */
+	{ NULL, 0 }, /* 357 */
+	{ NULL, 0 }, /* 358 */
+	{ NULL, 0 }, /* 359 */
+	{ NULL, 0 }, /* 360 */
+	{ NULL, 0 }, /* 361 */
+	{ NULL, 0 }, /* 362 */
+	{ NULL, 0 }, /* 363 */
+	{ NULL, 0 }, /* 364 */
+	{ "bdo", 0 }, /* 365 */
+	{ NULL, 0 }, /* 366 */
+	{ NULL, 0 }, /* 367 */
+	{ NULL, 0 }, /* 368 */
+	{ NULL, 0 }, /* 369 */
+	{ NULL, 0 }, /* 370 */
+	{ NULL, 0 }, /* 371 */
+	{ NULL, 0 }, /* 372 */
+	{ NULL, 0 }, /* 373 */
+	{ NULL, 0 }, /* 374 */
+	{ NULL, 0 }, /* 375 */
+	{ NULL, 0 }, /* 376 */
+	{ NULL, 0 }, /* 377 */
+	{ NULL, 0 }, /* 378 */
+	{ NULL, 0 }, /* 379 */
+	{ NULL, 0 }, /* 380 */
+	{ NULL, 0 }, /* 381 */
+	{ NULL, 0 }, /* 382 */
+	{ NULL, 0 }, /* 383 */
+	{ NULL, 0 }, /* 384 */
+	{ NULL, 0 }, /* 385 */
+	{ NULL, 0 }, /* 386 */
+	{ NULL, 0 }, /* 387 */
+	{ "form", TAG_BLOCK | TAG_SPECIAL }, /* 388 */
+	{ NULL, 0 }, /* 389 */
+	{ NULL, 0 }, /* 390 */
+	{ NULL, 0 }, /* 391 */
+	{ NULL, 0 }, /* 392 */
+	{ NULL, 0 }, /* 393 */
+	{ NULL, 0 }, /* 394 */
+	{ NULL, 0 }, /* 395 */
+	{ NULL, 0 }, /* 396 */
+	{ NULL, 0 }, /* 397 */
+	{ NULL, 0 }, /* 398 */
+	{ NULL, 0 }, /* 399 */
+	{ NULL, 0 }, /* 400 */
+	{ NULL, 0 }, /* 401 */
+	{ "math", 0 }, /* 402 */
+	{ NULL, 0 }, /* 403 */
+	{ NULL, 0 }, /* 404 */
+	{ NULL, 0 }, /* 405 */
+	{ "map", 0 }, /* 406 */
+	{ NULL, 0 }, /* 407 */
+	{ NULL, 0 }, /* 408 */
+	{ "style", TAG_SPECIAL | TAG_RAWTEXT }, /* 409 */
+	{ NULL, 0 }, /* 410 */
+	{ NULL, 0 }, /* 411 */
+	{ NULL, 0 }, /* 412 */
+	{ NULL, 0 }, /* 413 */
+	{ NULL, 0 }, /* 414 */
+	{ NULL, 0 }, /* 415 */
+	{ NULL, 0 }, /* 416 */
+	{ "header", TAG_BLOCK | TAG_SPECIAL }, /* 417 */
+	{ "bgsound", TAG_SPECIAL }, /* 418 */
+	{ NULL, 0 }, /* 419 */
+	{ NULL, 0 }, /* 420 */
+	{ NULL, 0 }, /* 421 */
+	{ "rt", 0 }, /* 422 */
+	{ NULL, 0 }, /* 423 */
+	{ NULL, 0 }, /* 424 */
+	{ "blockquote", TAG_BLOCK | TAG_SPECIAL }, /* 425 */
+	{ "param", TAG_EMPTY | TAG_SPECIAL } /* jump 1 */, /* 426 */
+	{ NULL, 0 }, /* 427 */
+	{ NULL, 0 }, /* 428 */
+	{ NULL, 0 }, /* 429 */
+	{ NULL, 0 }, /* 430 */
+	{ NULL, 0 }, /* 431 */
+	{ NULL, 0 }, /* 432 */
+	{ NULL, 0 }, /* 433 */
+	{ NULL, 0 }, /* 434 */
+	{ NULL, 0 }, /* 435 */
+	{ NULL, 0 }, /* 436 */
+	{ NULL, 0 }, /* 437 */
+	{ NULL, 0 }, /* 438 */
+	{ NULL, 0 }, /* 439 */
+	{ NULL, 0 }, /* 440 */
+	{ NULL, 0 }, /* 441 */
+	{ NULL, 0 }, /* 442 */
+	{ NULL, 0 }, /* 443 */
+	{ NULL, 0 }, /* 444 */
+	{ NULL, 0 }, /* 445 */
+	{ NULL, 0 }, /* 446 */
+	{ NULL, 0 }, /* 447 */
+	{ NULL, 0 }, /* 448 */
+	{ NULL, 0 }, /* 449 */
+	{ NULL, 0 }, /* 450 */
+	{ NULL, 0 }, /* 451 */
+	{ NULL, 0 }, /* 452 */
+	{ NULL, 0 }, /* 453 */
+	{ "applet", TAG_SPECIAL }, /* 454 */
+	{ NULL, 0 }, /* 455 */
+	{ NULL, 0 }, /* 456 */
+	{ NULL, 0 }, /* 457 */
+	{ NULL, 0 }, /* 458 */
+	{ "frame", TAG_SPECIAL }, /* 459 */
+	{ NULL, 0 }, /* 460 */
+	{ NULL, 0 }, /* 461 */
+	{ NULL, 0 }, /* 462 */
+	{ NULL, 0 }, /* 463 */
+	{ NULL, 0 }, /* 464 */
+	{ NULL, 0 }, /* 465 */
+	{ "tbody", TAG_OPTIONAL_CLOSE | TAG_SPECIAL }, /* 466 */
+	{ NULL, 0 }, /* 467 */
+	{ NULL, 0 }, /* 468 */
+	{ NULL, 0 }, /* 469 */
+	{ NULL, 0 }, /* 470 */
+	{ NULL, 0 }, /* 471 */
+	{ NULL, 0 }, /* 472 */
+	{ NULL, 0 }, /* 473 */
+	{ NULL, 0 }, /* 474 */
+	{ NULL, 0 }, /* 475 */
+	{ NULL, 0 }, /* 476 */
+	{ NULL, 0 }, /* 477 */
+	{ "CUSTOM_TAG", 0 }, /* 478 */
+	{ NULL, 0 }, /* 479 */
+	{ "label", 0 }, /* 480 */
+	{ NULL, 0 }, /* 481 */
+	{ NULL, 0 }, /* 482 */
+	{ "h3", TAG_BLOCK | TAG_SPECIAL | TAG_HEADING }, /* 483 */
+	{ "rb", 0 }, /* 484 */
+	{ NULL, 0 }, /* 485 */
+	{ NULL, 0 }, /* 486 */
+	{ NULL, 0 }, /* 487 */
+	{ "dd", TAG_BLOCK | TAG_OPTIONAL_CLOSE | TAG_SPECIAL }, /* 488 */
+	{ NULL, 0 }, /* 489 */
+	{ NULL, 0 }, /* 490 */
+	{ NULL, 0 }, /* 491 */
+	{ NULL, 0 }, /* 492 */
+	{ NULL, 0 }, /* 493 */
+	{ NULL, 0 }, /* 494 */
+	{ NULL, 0 }, /* 495 */
+	{ NULL, 0 }, /* 496 */
+	{ NULL, 0 }, /* 497 */
+	{ NULL, 0 }, /* 498 */
+	{ NULL, 0 }, /* 499 */
+	{ NULL, 0 }, /* 500 */
+	{ NULL, 0 }, /* 501 */
+	{ NULL, 0 }, /* 502 */
+	{ NULL, 0 }, /* 503 */
+	{ NULL, 0 }, /* 504 */
+	{ "acronym", 0 }, /* 505 */
+	{ NULL, 0 }, /* 506 */
+	{ NULL, 0 }, /* 507 */
+	{ NULL, 0 }, /* 508 */
+	{ NULL, 0 }, /* 509 */
+	{ NULL, 0 }, /* 510 */
+	{ NULL, 0 }, /* 511 */
+	{ NULL, 0 }, /* 512 */
+	{ NULL, 0 }, /* 513 */
+	{ NULL, 0 }, /* 514 */
+	{ NULL, 0 }, /* 515 */
+	{ NULL, 0 }, /* 516 */
+	{ NULL, 0 }, /* 517 */
+	{ NULL, 0 }, /* 518 */
+	{ "meta", TAG_EMPTY | TAG_SPECIAL }, /* 519 */
+	{ NULL, 0 }, /* 520 */
+	{ NULL, 0 }, /* 521 */
+	{ NULL, 0 }, /* 522 */
+	{ NULL, 0 }, /* 523 */
+	{ NULL, 0 }, /* 524 */
+	{ NULL, 0 }, /* 525 */
+	{ "summary", TAG_SPECIAL }, /* 526 */
+	{ NULL, 0 }, /* 527 */
+	{ NULL, 0 }, /* 528 */
+	{ NULL, 0 }, /* 529 */
+	{ NULL, 0 }, /* 530 */
+	{ NULL, 0 }, /* 531 */
+	{ NULL, 0 }, /* 532 */
+	{ NULL, 0 }, /* 533 */
+	{ NULL, 0 }, /* 534 */
+	{ "abbr", 0 }, /* 535 */
+	{ NULL, 0 }, /* 536 */
+	{ NULL, 0 }, /* 537 */
+	{ NULL, 0 }, /* 538 */
+	{ NULL, 0 }, /* 539 */
+	{ NULL, 0 }, /* 540 */
+	{ NULL, 0 }, /* 541 */
+	{ NULL, 0 }, /* 542 */
+	{ NULL, 0 }, /* 543 */
+	{ NULL, 0 }, /* 544 */
+	{ NULL, 0 }, /* 545 */
+	{ NULL, 0 }, /* 546 */
+	{ NULL, 0 }, /* 547 */
+	{ NULL, 0 }, /* 548 */
+	{ "html", TAG_OPTIONAL_CLOSE | TAG_SPECIAL }, /* 549 */
+	{ NULL, 0 }, /* 550 */
+	{ NULL, 0 }, /* 551 */
+	{ NULL, 0 }, /* 552 */
+	{ NULL, 0 }, /* 553 */
+	{ NULL, 0 }, /* 554 */
+	{ NULL, 0 }, /* 555 */
+	{ NULL, 0 }, /* 556 */
+	{ NULL, 0 }, /* 557 */
+	{ NULL, 0 }, /* 558 */
+	{ "object", TAG_SPECIAL }, /* 559 */
+	{ NULL, 0 }, /* 560 */
+	{ "ul", TAG_BLOCK | TAG_SPECIAL }, /* 561 */
+	{ NULL, 0 }, /* 562 */
+	{ NULL, 0 }, /* 563 */
+	{ NULL, 0 }, /* 564 */
+	{ NULL, 0 }, /* 565 */
+	{ NULL, 0 }, /* 566 */
+	{ NULL, 0 }, /* 567 */
+	{ NULL, 0 }, /* 568 */
+	{ NULL, 0 }, /* 569 */
+	{ NULL, 0 }, /* 570 */
+	{ "s", TAG_FORMAT }, /* 571 */
+	{ NULL, 0 }, /* 572 */
+	{ NULL, 0 }, /* 573 */
+	{ NULL, 0 }, /* 574 */
+	{ NULL, 0 }, /* 575 */
+	{ NULL, 0 }, /* 576 */
+	{ NULL, 0 }, /* 577 */
+	{ NULL, 0 }, /* 578 */
+	{ NULL, 0 }, /* 579 */
+	{ NULL, 0 }, /* 580 */
+	{ NULL, 0 }, /* 581 */
+	{ NULL, 0 }, /* 582 */
+	{ NULL, 0 }, /* 583 */
+	{ NULL, 0 }, /* 584 */
+	{ NULL, 0 }, /* 585 */
+	{ "noscript", TAG_BLOCK | TAG_SPECIAL | TAG_RAWTEXT }, /* 586 */
+	{ NULL, 0 }, /* 587 */
+	{ "figcaption", TAG_BLOCK | TAG_SPECIAL }, /* 588 */
+	{ NULL, 0 }, /* 589 */
+	{ NULL, 0 }, /* 590 */
+	{ NULL, 0 }, /* 591 */
+	{ NULL, 0 }, /* 592 */
+	{ NULL, 0 }, /* 593 */
+	{ NULL, 0 }, /* 594 */
+	{ NULL, 0 }, /* 595 */
+	{ NULL, 0 }, /* 596 */
+	{ NULL, 0 }, /* 597 */
+	{ NULL, 0 }, /* 598 */
+	{ NULL, 0 }, /* 599 */
+	{ NULL, 0 }, /* 600 */
+	{ NULL, 0 }, /* 601 */
+	{ NULL, 0 }, /* 602 */
+	{ NULL, 0 }, /* 603 */
+	{ NULL, 0 }, /* 604 */
+	{ NULL, 0 }, /* 605 */
+	{ NULL, 0 }, /* 606 */
+	{ NULL, 0 }, /* 607 */
+	{ NULL, 0 }, /* 608 */
+	{ NULL, 0 }, /* 609 */
+	{ "ruby", 0 }, /* 610 */
+	{ NULL, 0 }, /* 611 */
+	{ NULL, 0 }, /* 612 */
+	{ NULL, 0 }, /* 613 */
+	{ NULL, 0 }, /* 614 */
+	{ NULL, 0 }, /* 615 */
+	{ NULL, 0 }, /* 616 */
+	{ NULL, 0 }, /* 617 */
+	{ NULL, 0 }, /* 618 */
+	{ NULL, 0 }, /* 619 */
+	{ NULL, 0 }, /* 620 */
+	{ NULL, 0 }, /* 621 */
+	{ "datalist", 0 }, /* 622 */
+	{ NULL, 0 }, /* 623 */
+	{ NULL, 0 }, /* 624 */
+	{ NULL, 0 }, /* 625 */
+	{ NULL, 0 }, /* 626 */
+	{ NULL, 0 }, /* 627 */
+	{ NULL, 0 }, /* 628 */
+	{ NULL, 0 }, /* 629 */
+	{ NULL, 0 }, /* 630 */
+	{ NULL, 0 }, /* 631 */
+	{ NULL, 0 }, /* 632 */
+	{ "a", 0 }, /* 633 */
+	{ "ins", 0 }, /* 634 */
+	{ NULL, 0 }, /* 635 */
+	{ NULL, 0 }, /* 636 */
+	{ NULL, 0 }, /* 637 */
+	{ NULL, 0 }, /* 638 */
+	{ NULL, 0 }, /* 639 */
+	{ NULL, 0 }, /* 640 */
+	{ NULL, 0 }, /* 641 */
+	{ NULL, 0 }, /* 642 */
+	{ NULL, 0 }, /* 643 */
+	{ NULL, 0 }, /* 644 */
+	{ NULL, 0 }, /* 645 */
+	{ NULL, 0 }, /* 646 */
+	{ NULL, 0 }, /* 647 */
+	{ "tt", TAG_FORMAT }, /* 648 */
+	{ "samp", 0 }, /* 649 */
+	{ NULL, 0 }, /* 650 */
+	{ NULL, 0 }, /* 651 */
+	{ NULL, 0 }, /* 652 */
+	{ NULL, 0 }, /* 653 */
+	{ NULL, 0 }, /* 654 */
+	{ NULL, 0 }, /* 655 */
+	{ NULL, 0 }, /* 656 */
+	{ NULL, 0 }, /* 657 */
+	{ NULL, 0 }, /* 658 */
+	{ NULL, 0 }, /* 659 */
+	{ NULL, 0 }, /* 660 */
+	{ NULL, 0 }, /* 661 */
+	{ NULL, 0 }, /* 662 */
+	{ NULL, 0 }, /* 663 */
+	{ NULL, 0 }, /* 664 */
+	{ NULL, 0 }, /* 665 */
+	{ NULL, 0 }, /* 666 */
+	{ NULL, 0 }, /* 667 */
+	{ NULL, 0 }, /* 668 */
+	{ NULL, 0 }, /* 669 */
+	{ NULL, 0 }, /* 670 */
+	{ NULL, 0 }, /* 671 */
+	{ "sup", 0 }, /* 672 */
+	{ NULL, 0 }, /* 673 */
+	{ NULL, 0 }, /* 674 */
+	{ NULL, 0 }, /* 675 */
+	{ NULL, 0 }, /* 676 */
+	{ "del", 0 }, /* 677 */
+	{ NULL, 0 }, /* 678 */
+	{ NULL, 0 }, /* 679 */
+	{ "marquee", TAG_SPECIAL }, /* 680 */
+	{ NULL, 0 }, /* 681 */
+	{ NULL, 0 }, /* 682 */
+	{ NULL, 0 }, /* 683 */
+	{ NULL, 0 }, /* 684 */
+	{ NULL, 0 }, /* 685 */
+	{ NULL, 0 }, /* 686 */
+	{ NULL, 0 }, /* 687 */
+	{ "dl", TAG_BLOCK | TAG_SPECIAL }, /* 688 */
+	{ NULL, 0 }, /* 689 */
+	{ NULL, 0 }, /* 690 */
+	{ NULL, 0 }, /* 691 */
+	{ NULL, 0 }, /* 692 */
+	{ NULL, 0 }, /* 693 */
+	{ NULL, 0 }, /* 694 */
+	{ NULL, 0 }, /* 695 */
+	{ "input", TAG_EMPTY | TAG_SPECIAL }, /* 696 */
+	{ NULL, 0 }, /* 697 */
+	{ NULL, 0 }, /* 698 */
+	{ NULL, 0 }, /* 699 */
+	{ NULL, 0 }, /* 700 */
+	{ NULL, 0 }, /* 701 */
+	{ NULL, 0 }, /* 702 */
+	{ NULL, 0 }, /* 703 */
+	{ NULL, 0 }, /* 704 */
+	{ NULL, 0 }, /* 705 */
+	{ NULL, 0 }, /* 706 */
+	{ NULL, 0 }, /* 707 */
+	{ NULL, 0 }, /* 708 */
+	{ "hgroup", TAG_SPECIAL }, /* 709 */
+	{ NULL, 0 }, /* 710 */
+	{ NULL, 0 }, /* 711 */
+	{ NULL, 0 }, /* 712 */
+	{ NULL, 0 }, /* 713 */
+	{ NULL, 0 }, /* 714 */
+	{ NULL, 0 }, /* 715 */
+	{ NULL, 0 }, /* 716 */
+	{ NULL, 0 }, /* 717 */
+	{ NULL, 0 }, /* 718 */
+	{ NULL, 0 }, /* 719 */
+	{ NULL, 0 }, /* 720 */
+	{ NULL, 0 }, /* 721 */
+	{ NULL, 0 }, /* 722 */
+	{ NULL, 0 }, /* 723 */
+	{ NULL, 0 }, /* 724 */
+	{ NULL, 0 }, /* 725 */
+	{ NULL, 0 }, /* 726 */
+	{ "bdi", 0 }, /* 727 */
+	{ NULL, 0 }, /* 728 */
+	{ NULL, 0 }, /* 729 */
+	{ "big", TAG_FORMAT }, /* 730 */
+	{ NULL, 0 }, /* 731 */
+	{ NULL, 0 }, /* 732 */
+	{ NULL, 0 }, /* 733 */
+	{ NULL, 0 }, /* 734 */
+	{ NULL, 0 }, /* 735 */
+	{ NULL, 0 }, /* 736 */
+	{ NULL, 0 }, /* 737 */
+	{ NULL, 0 }, /* 738 */
+	{ NULL, 0 }, /* 739 */
+	{ NULL, 0 }, /* 740 */
+	{ NULL, 0 }, /* 741 */
+	{ NULL, 0 }, /* 742 */
+	{ NULL, 0 }, /* 743 */
+	{ NULL, 0 }, /* 744 */
+	{ NULL, 0 }, /* 745 */
+	{ NULL, 0 }, /* 746 */
+	{ NULL, 0 }, /* 747 */
+	{ NULL, 0 }, /* 748 */
+	{ "li", TAG_BLOCK | TAG_OPTIONAL_CLOSE | TAG_SPECIAL }, /* 749 */
+	{ NULL, 0 }, /* 750 */
+	{ NULL, 0 }, /* 751 */
+	{ "p", TAG_BLOCK | TAG_OPTIONAL_CLOSE | TAG_SPECIAL }, /* 752 */
+	{ NULL, 0 }, /* 753 */
+	{ NULL, 0 }, /* 754 */
+	{ NULL, 0 }, /* 755 */
+	{ NULL, 0 }, /* 756 */
+	{ NULL, 0 }, /* 757 */
+	{ NULL, 0 }, /* 758 */
+	{ NULL, 0 }, /* 759 */
+	{ NULL, 0 }, /* 760 */
+	{ "nobr", 0 }, /* 761 */
+	{ NULL, 0 }, /* 762 */
+	{ NULL, 0 }, /* 763 */
+	{ "h4", TAG_BLOCK | TAG_SPECIAL | TAG_HEADING }, /* 764 */
+	{ NULL, 0 }, /* 765 */
+	{ NULL, 0 }, /* 766 */
+	{ "dir", TAG_SPECIAL }, /* 767 */
+	{ NULL, 0 }, /* 768 */
+	{ NULL, 0 }, /* 769 */
+	{ NULL, 0 }, /* 770 */
+	{ NULL, 0 }, /* 771 */
+	{ "iframe", TAG_SPECIAL | TAG_RAWTEXT }, /* 772 */
+	{ NULL, 0 }, /* 773 */
+	{ "col", TAG_EMPTY | TAG_SPECIAL }, /* 774 */
+	{ NULL, 0 }, /* 775 */
+	{ NULL, 0 }, /* 776 */
+	{ NULL, 0 }, /* 777 */
+	{ "hr", TAG_BLOCK | TAG_EMPTY | TAG_SPECIAL }, /* 778 */
+	{ NULL, 0 }, /* 779 */
+	{ NULL, 0 }, /* 780 */
+	{ NULL, 0 }, /* 781 */
+	{ NULL, 0 }, /* 782 */
+	{ NULL, 0 }, /* 783 */
+	{ NULL, 0 }, /* 784 */
+	{ NULL, 0 }, /* 785 */
+	{ "noembed", TAG_SPECIAL | TAG_RAWTEXT }, /* 786 */
+	{ NULL, 0 }, /* 787 */
+	{ NULL, 0 }, /* 788 */
+	{ NULL, 0 }, /* 789 */
+	{ NULL, 0 }, /* 790 */
+	{ NULL, 0 }, /* 791 */
+	{ NULL, 0 }, /* 792 */
+	{ NULL, 0 }, /* 793 */
+	{ NULL, 0 }, /* 794 */
+	{ NULL, 0 }, /* 795 */
+	{ NULL, 0 }, /* 796 */
+	{ NULL, 0 }, /* 797 */
+	{ NULL, 0 }, /* 798 */
+	{ NULL, 0 }, /* 799 */
+	{ "select", TAG_SPECIAL }, /* 800 */
+	{ NULL, 0 }, /* 801 */
+	{ NULL, 0 }, /* 802 */
+	{ NULL, 0 }, /* 803 */
+	{ NULL, 0 }, /* 804 */
+	{ NULL, 0 }, /* 805 */
+	{ NULL, 0 }, /* 806 */
+	{ NULL, 0 }, /* 807 */
+	{ NULL, 0 }, /* 808 */
+	{ NULL, 0 }, /* 809 */
+	{ NULL, 0 }, /* 810 */
+	{ NULL, 0 }, /* 811 */
+	{ NULL, 0 }, /* 812 */
+	{ NULL, 0 }, /* 813 */
+	{ NULL, 0 }, /* 814 */
+	{ NULL, 0 }, /* 815 */
+	{ NULL, 0 }, /* 816 */
+	{ NULL, 0 }, /* 817 */
+	{ NULL, 0 }, /* 818 */
+	{ NULL, 0 }, /* 819 */
+	{ "template", TAG_SPECIAL }, /* 820 */
+	{ NULL, 0 }, /* 821 */
+	{ NULL, 0 }, /* 822 */
+	{ NULL, 0 }, /* 823 */
+	{ NULL, 0 }, /* 824 */
+	{ NULL, 0 }, /* 825 */
+	{ NULL, 0 }, /* 826 */
+	{ NULL, 0 }, /* 827 */
+	{ NULL, 0 }, /* 828 */
+	{ "progress", 0 }, /* 829 */
+	{ NULL, 0 }, /* 830 */
+	{ NULL, 0 }, /* 831 */
+	{ NULL, 0 }, /* 832 */
+	{ "i", TAG_FORMAT }, /* 833 */
+	{ "sub", 0 }, /* 834 */
+	{ NULL, 0 }, /* 835 */
+	{ NULL, 0 }, /* 836 */
+	{ "xmp", TAG_SPECIAL | TAG_PREFORMATTED | TAG_RAWTEXT }, /* 837 */
+	{ NULL, 0 }, /* 838 */
+	{ NULL, 0 }, /* 839 */
+	{ NULL, 0 }, /* 840 */
+	{ "small", TAG_FORMAT }, /* 841 */
+	{ NULL, 0 }, /* 842 */
+	{ NULL, 0 }, /* 843 */
+	{ NULL, 0 }, /* 844 */
+	{ "main", TAG_BLOCK | TAG_SPECIAL }, /* 845 */
+	{ NULL, 0 }, /* 846 */
+	{ NULL, 0 }, /* 847 */
+	{ "fieldset", TAG_BLOCK | TAG_SPECIAL }, /* 848 */
+	{ NULL, 0 }, /* 849 */
+	{ NULL, 0 }, /* 850 */
+	{ NULL, 0 }, /* 851 */
+	{ NULL, 0 }, /* 852 */
+	{ NULL, 0 }, /* 853 */
+	{ NULL, 0 }, /* 854 */
+	{ NULL, 0 }, /* 855 */
+	{ NULL, 0 }, /* 856 */
+	{ NULL, 0 }, /* 857 */
+	{ NULL, 0 }, /* 858 */
+	{ NULL, 0 }, /* 859 */
+	{ NULL, 0 }, /* 860 */
+	{ NULL, 0 }, /* 861 */
+	{ NULL, 0 }, /* 862 */
+	{ NULL, 0 }, /* 863 */
+	{ NULL, 0 }, /* 864 */
+	{ NULL, 0 }, /* 865 */
+	{ NULL, 0 }, /* 866 */
+	{ "div", TAG_BLOCK | TAG_SPECIAL }, /* 867 */
+	{ "keygen", TAG_EMPTY | TAG_SPECIAL } /* jump 1 */, /* 868 */
+	{ NULL, 0 }, /* 869 */
+	{ NULL, 0 }, /* 870 */
+	{ NULL, 0 }, /* 871 */
+	{ NULL, 0 }, /* 872 */
+	{ NULL, 0 }, /* 873 */
+	{ NULL, 0 }, /* 874 */
+	{ NULL, 0 }, /* 875 */
+	{ NULL, 0 }, /* 876 */
+	{ NULL, 0 }, /* 877 */
+	{ NULL, 0 }, /* 878 */
+	{ "font", TAG_FORMAT }, /* 879 */
+	{ NULL, 0 }, /* 880 */
+	{ "option", 0 }, /* 881 */
+	{ NULL, 0 }, /* 882 */
+	{ NULL, 0 }, /* 883 */
+	{ NULL, 0 }, /* 884 */
+	{ NULL, 0 }, /* 885 */
+	{ NULL, 0 }, /* 886 */
+	{ NULL, 0 }, /* 887 */
+	{ "dt", TAG_BLOCK | TAG_OPTIONAL_CLOSE | TAG_SPECIAL }, /* 888 */
+	{ NULL, 0 }, /* 889 */
+	{ NULL, 0 }, /* 890 */
+	{ NULL, 0 }, /* 891 */
+	{ NULL, 0 }, /* 892 */
+	{ NULL, 0 }, /* 893 */
+	{ "textarea", TAG_SPECIAL | TAG_PREFORMATTED | TAG_RAWTEXT }, /* 894 */
+	{ NULL, 0 }, /* 895 */
+	{ NULL, 0 }, /* 896 */
+	{ NULL, 0 }, /* 897 */
+	{ NULL, 0 }, /* 898 */
+	{ NULL, 0 }, /* 899 */
+	{ NULL, 0 }, /* 900 */
+	{ NULL, 0 }, /* 901 */
+	{ NULL, 0 }, /* 902 */
+	{ NULL, 0 }, /* 903 */
+	{ NULL, 0 }, /* 904 */
+	{ NULL, 0 }, /* 905 */
+	{ "head", TAG_OPTIONAL_CLOSE | TAG_SPECIAL }, /* 906 */
+	{ "ol", TAG_BLOCK | TAG_SPECIAL }, /* 907 */
+	{ NULL, 0 }, /* 908 */
+	{ NULL, 0 }, /* 909 */
+	{ NULL, 0 }, /* 910 */
+	{ NULL, 0 }, /* 911 */
+	{ NULL, 0 }, /* 912 */
+	{ NULL, 0 }, /* 913 */
+	{ "b", TAG_FORMAT }, /* 914 */
+	{ "span", 0 } /* jump 1 */, /* 915 */
+	{ "button", TAG_SPECIAL }, /* 916 */
+	{ "track", TAG_EMPTY | TAG_SPECIAL }, /* 917 */
+	{ NULL, 0 }, /* 918 */
+	{ "footer", TAG_BLOCK | TAG_SPECIAL }, /* 919 */
+	{ NULL, 0 }, /* 920 */
+	{ NULL, 0 }, /* 921 */
+	{ NULL, 0 }, /* 922 */
+	{ NULL, 0 }, /* 923 */
+	{ NULL, 0 }, /* 924 */
+	{ NULL, 0 }, /* 925 */
+	{ NULL, 0 }, /* 926 */
+	{ NULL, 0 }, /* 927 */
+	{ NULL, 0 }, /* 928 */
+	{ NULL, 0 }, /* 929 */
+	{ "listing", TAG_SPECIAL | TAG_PREFORMATTED }, /* 930 */
+	{ NULL, 0 }, /* 931 */
+	{ NULL, 0 }, /* 932 */
+	{ NULL, 0 }, /* 933 */
+	{ "details", TAG_BLOCK | TAG_SPECIAL }, /* 934 */
+	{ NULL, 0 }, /* 935 */
+	{ NULL, 0 }, /* 936 */
+	{ NULL, 0 }, /* 937 */
+	{ NULL, 0 }, /* 938 */
+	{ NULL, 0 }, /* 939 */
+	{ NULL, 0 }, /* 940 */
+	{ NULL, 0 }, /* 941 */
+	{ NULL, 0 }, /* 942 */
+	{ NULL, 0 }, /* 943 */
+	{ NULL, 0 }, /* 944 */
+	{ "h1", TAG_BLOCK | TAG_SPECIAL | TAG_HEADING }, /* 945 */
+	{ NULL, 0 }, /* 946 */
+	{ NULL, 0 }, /* 947 */
+	{ "picture", 0 }, /* 948 */
+	{ NULL, 0 }, /* 949 */
+	{ NULL, 0 }, /* 950 */
+	{ NULL, 0 }, /* 951 */
+	{ NULL, 0 }, /* 952 */
+	{ NULL, 0 }, /* 953 */
+	{ NULL, 0 }, /* 954 */
+	{ NULL, 0 }, /* 955 */
+	{ NULL, 0 }, /* 956 */
+	{ NULL, 0 }, /* 957 */
+	{ NULL, 0 }, /* 958 */
+	{ NULL, 0 }, /* 959 */
+	{ NULL, 0 }, /* 960 */
+	{ "source", TAG_EMPTY | TAG_SPECIAL }, /* 961 */
+	{ NULL, 0 }, /* 962 */
+	{ NULL, 0 }, /* 963 */
+	{ NULL, 0 }, /* 964 */
+	{ "cite", 0 }, /* 965 */
+	{ NULL, 0 }, /* 966 */
+	{ NULL, 0 }, /* 967 */
+	{ NULL, 0 }, /* 968 */
+	{ NULL, 0 }, /* 969 */
+	{ NULL, 0 }, /* 970 */
+	{ NULL, 0 }, /* 971 */
+	{ NULL, 0 }, /* 972 */
+	{ NULL, 0 }, /* 973 */
+	{ NULL, 0 }, /* 974 */
+	{ NULL, 0 }, /* 975 */
+	{ NULL, 0 }, /* 976 */
+	{ NULL, 0 }, /* 977 */
+	{ NULL, 0 }, /* 978 */
+	{ NULL, 0 }, /* 979 */
+	{ NULL, 0 }, /* 980 */
+	{ "embed", TAG_EMPTY | TAG_SPECIAL }, /* 981 */
+	{ NULL, 0 }, /* 982 */
+	{ NULL, 0 }, /* 983 */
+	{ NULL, 0 }, /* 984 */
+	{ NULL, 0 }, /* 985 */
+	{ NULL, 0 }, /* 986 */
+	{ NULL, 0 }, /* 987 */
+	{ NULL, 0 }, /* 988 */
+	{ NULL, 0 }, /* 989 */
+	{ NULL, 0 }, /* 990 */
+	{ NULL, 0 }, /* 991 */
+	{ NULL, 0 }, /* 992 */
+	{ "rtc", 0 }, /* 993 */
+	{ NULL, 0 }, /* 994 */
+	{ NULL, 0 }, /* 995 */
+	{ NULL, 0 }, /* 996 */
+	{ NULL, 0 }, /* 997 */
+	{ NULL, 0 }, /* 998 */
+	{ NULL, 0 }, /* 999 */
+	{ NULL, 0 }, /* 1000 */
+	{ NULL, 0 }, /* 1001 */
+	{ NULL, 0 }, /* 1002 */
+	{ NULL, 0 }, /* 1003 */
+	{ NULL, 0 }, /* 1004 */
+	{ NULL, 0 }, /* 1005 */
+	{ "address", TAG_BLOCK | TAG_SPECIAL }, /* 1006 */
+	{ NULL, 0 }, /* 1007 */
+	{ NULL, 0 }, /* 1008 */
+	{ NULL, 0 }, /* 1009 */
+	{ NULL, 0 }, /* 1010 */
+	{ NULL, 0 }, /* 1011 */
+	{ NULL, 0 }, /* 1012 */
+	{ NULL, 0 }, /* 1013 */
+	{ NULL, 0 }, /* 1014 */
+	{ NULL, 0 }, /* 1015 */
+	{ NULL, 0 }, /* 1016 */
+	{ NULL, 0 }, /* 1017 */
+	{ NULL, 0 }, /* 1018 */
+	{ "mark", 0 }, /* 1019 */
+	{ NULL, 0 }, /* 1020 */
+	{ NULL, 0 }, /* 1021 */
+	{ NULL, 0 }, /* 1022 */
+	{ "video", 0 }, /* 1023 */
+};
+#line 26 "tagmap.c"
+
+const struct tag *
+tagmap(int i)
+{
+	assert(i >= 0 && i < TAGMAP_SZ);
+
+#if 0
+	warnx("tagmap returns tag=%s flags %d\n", tags[i].name, tags[i].flags);
+#endif
+	return &tags[i];
+}
+
+int
+tagmap_id(const char *tag)
+{
+	size_t	 i;
+	size_t	 sz;
+	size_t	 prime;
+	size_t	 modulo;
+	size_t	 addr;
+
+	prime = 104729;
+	modulo = 1048576;
+	sz = strlen(tag);
+	addr = 0;
+	for (i = 0; i < sz; i++) {
+		addr = addr + tag[i];
+		addr *= prime;
+		addr %= modulo;
+	}
+
+	i = addr % TAGMAP_SZ;
+	if (tags[i].name == NULL)
+		return TAG_CUSTOM_TAG;
+
+	while (tags[i].name != NULL &&
+	    strcmp(tags[i].name, tag) != 0) {
+		addr++;
+		i = addr % TAGMAP_SZ;
+	}
+	if (tags[i].name == NULL)
+		return TAG_CUSTOM_TAG;
+
+#if 0
+	warnx("tagmap '%s' i=%d, i", tag, i);
+#endif
+
+	return i;
+}
+#line 1 "token.c"
+
+#line 20 "token.c"
+#line 21 "token.c"
+#line 22 "token.c"
+#line 23 "token.c"
+#line 24 "token.c"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <err.h>
+
+static void
+tagtoken_set_attr(struct tagtoken *tagtoken, const char *name, const char *value);
+
+const char*
+token_str(struct token *token)
+{
+	static const char	*s[] = {
+		"EMPTY", "CHAR", "DOCTYPE", "START_TAG", "END_TAG",
+		"COMMENT"
+	};
+
+	assert(token != NULL);
+	assert(token->type < sizeof(s) / sizeof(s[0]));
+	return s[token->type];
+}
+
+void
+token_set_tag_attr(struct token *token, const char *name, const char *value)
+{
+	assert(token != NULL);
+	assert(TOKEN_IS_START_END(token));
+
+	tagtoken_set_attr(&token->u.tag, name, value);
+}
+
+static void
+tagtoken_set_attr(struct tagtoken *tagtoken, const char *name, const char *value)
+{
+	assert(tagtoken != NULL);
+
+	attr_set(&tagtoken->attr, name, value);
+}
+
+void
+token_clear(struct token *token)
+{
+	assert(token != NULL);
+
+	if (!token->used && TOKEN_IS_START_END(token)) {
+		if (token->u.tag.name != NULL && !token->u.tag.shared_name &&
+		    token->u.tag.name != tagmap(token->u.tag.tagid)->name)
+			mem_free(token->u.tag.name);
+
+		attr_free(token->u.tag.attr);
+	} else if (TOKEN_IS_CHAR(token)) {
+		str_add(&token->s, '\0');
+	}
+
+	if (TOKEN_IS_START_END(token))
+		memset(&token->u.tag, '\0', sizeof(struct tagtoken));
+	token->type = TOKEN_EMPTY;
+	token->used = 0;
+}
+
+void
+token_add_char(struct token *token, char c)
+{
+	str_add(&token->s, c);
+}
+
+void
+token_set_tag_name(struct token *token, const char *name)
+{
+	assert(token != NULL);
+	assert(name != NULL);
+
+	token->u.tag.tagid = tagmap_id(name);
+	if (token->u.tag.tagid == 0) {
+		token->u.tag.name = mem_strdup(name);
+		if (token->u.tag.name == NULL)
+			err(1, "strup token tag name");
+		STATS_ADD(allocs[ALLOC_TOKEN], 1);
+	} else
+		token->u.tag.name = tagmap(token->u.tag.tagid)->name;
+}
+#line 1 "node.c"
+
+#line 20 "node.c"
+#line 21 "node.c"
+#line 22 "node.c"
+#line 23 "node.c"
+#line 24 "node.c"
+#line 25 "node.c"
+
+#include <stdlib.h>
+#include <err.h>
+#include <assert.h>
+
+static struct node	*node_create(T_NODE type);
+
+struct node *
+node_create_from_cdata(struct cdata *cdata)
+{
+	struct node	*node;
+
+	assert(cdata != NULL);
+
+	node = node_create(NODE_CDATA);
+	node->u.cdata = cdata;
+	cdata->node = node;
+
+	return node;
+}
+
+struct node *
+node_create_from_elem(struct elem *elem)
+{
+	struct node	*node;
+
+	assert(elem != NULL);
+
+	node = node_create(NODE_ELEM);
+	node->u.elem = elem;
+	elem->node = node;
+
+	return node;
+}
+
+static size_t
+node_free_internal(struct node *node, int want_sum)
+{
+	size_t sum = sizeof(struct node);
+
+	switch (node->type) {
+	case NODE_ELEM:
+		if (want_sum)
+			sum += elem_size(node->u.elem);
+		else
+			elem_free(node->u.elem);
+		break;
+	case NODE_CDATA:
+		if (want_sum)
+			sum += cdata_size(node->u.cdata);
+		else
+			cdata_free(node->u.cdata);
+		break;
+	default:
+		break;
+	}
+
+	if (!want_sum)
+		mem_free(node);
+
+	return sum;
+}
+
+size_t
+node_size(struct node *node)
+{
+	return node_free_internal(node, 1);
+}
+
+/*
+ * Views are released by the parser after the callback returns.
+ */
+void
+node_free(struct node *node)
+{
+	if (node->view)
+		return;
+
+	(void) node_free_internal(node, 0);
+}
+
+/*
+ * The nodes passed to the begin and end callbacks are views owned by
+ * the parser, valid only until the callback returns. This returns a
+ * copy the caller owns and releases with node_free().
+ */
+struct node *
+node_retain(struct node *node)
+{
+	assert(node != NULL);
+
+	if (!node->view)
+		return node;
+
+	switch (node->type) {
+	case NODE_ELEM:
+		return node_create_from_elem(elem_copy(node->u.elem));
+	case NODE_CDATA:
+		return node_create_from_cdata(cdata_copy(node->u.cdata));
+	default:
+		break;
+	}
+
+	return node;
+}
+
+struct node *
+node_create_from_document(struct document *document)
+{
+	struct node	*node;
+
+	assert(document != NULL);
+
+	node = node_create(NODE_DOCUMENT);
+	node->u.document = document;
+	document->node = node;
+
+	return node;
+}
+
+static struct node *
+node_create(T_NODE type)
+{
+	struct node	*node;
+
+	node = mem_calloc(1, sizeof(struct node));
+	if (node == NULL)
+		err(1, "calloc node");
+	STATS_ADD(allocs[ALLOC_NODE], 1);
+
+	node->type = type;
+
+	return node;
+}
+#line 1 "elem.c"
+
+#line 20 "elem.c"
+#line 21 "elem.c"
+#line 22 "elem.c"
+#line 23 "elem.c"
+#line 24 "elem.c"
+#line 25 "elem.c"
+
+#include <stdlib.h>
+#include <assert.h>
+#include <err.h>
+#include <string.h>
+
+struct elem *
+elem_create(const char *name)
+{
+	struct	token token;
+
+	assert(name != NULL);
+
+	token = TOKEN_SET_START_TAG();
+	token_set_tag_name(&token, name);
+
+	return elem_create_from_token(&token);
+}
+
+const char *
+elem_attr_value(struct elem *elem, const char *name)
+{
+	struct attr *attr;
+
+	attr = attr_get(elem->attr, name);
+	if (attr != NULL)
+		return attr->value;
+	return NULL;
+}
+
+void elem_set_attr(struct elem *elem, const char *name, const char *value)
+{
+	attr_set(&elem->attr, name, value);
+}
+
+int
+elem_has_attr(struct elem *elem, const char *name)
+{
+	return attr_has(elem->attr, name);
+}
+
+struct elem *
+elem_create_from_token(struct token *token)
+{
+	struct	elem *elem;
+
+	assert(TOKEN_IS_START_END(token));
+
+	elem = mem_calloc(1, sizeof(struct elem));
+	if (elem == NULL)
+		err(1, "calloc elem");
+	STATS_ADD(allocs[ALLOC_ELEM], 1);
+
+	elem->tagid = token->u.tag.tagid;
+	elem->name = token->u.tag.name;
+	elem->shared_name = token->u.tag.shared_name;
+
+	assert(elem->name != NULL);
+	return elem;
+}
+
+size_t
+elem_size(struct elem *elem)
+{
+	size_t sum;
+
+	sum = 0;
+	if (elem->tagid == TAG_CUSTOM_TAG && elem->name != NULL)
+		sum += strlen(elem->name);
+
+	sum += attr_size(elem->attr);
+	return sum;
+}
+
+struct elem *
+elem_copy(struct elem *elem)
+{
+	struct elem *copy;
+
+	assert(elem != NULL);
+	assert(elem->name != NULL);
+
+	copy = mem_calloc(1, sizeof(struct elem));
+	if (copy == NULL)
+		err(1, "calloc elem");
+	STATS_ADD(allocs[ALLOC_ELEM], 1);
+
+	copy->tagid = elem->tagid;
+	copy->ns = elem->ns;
+	if (elem->name != tagmap(elem->tagid)->name) {
+		copy->name = mem_strdup(elem->name);
+		if (copy->name == NULL)
+			err(1, "strdup elem name");
+		STATS_ADD(allocs[ALLOC_ELEM], 1);
+	} else
+		copy->name = elem->name;
+	copy->attr = attr_copy(elem->attr);
+
+	return copy;
+}
+
+/*
+ * Releases the name and attributes but not the elem itself.
+ */
+void
+elem_clear(struct elem *elem)
+{
+	assert(elem != NULL);
+	assert(elem->name != NULL);
+
+	if (elem->name != tagmap(elem->tagid)->name && !elem->shared_name) {
+		mem_free(elem->name);
+		elem->name = NULL;
+	}
+
+	attr_free(elem->attr);
+	elem->attr = NULL;
+}
+
+void
+elem_free(struct elem *elem)
+{
+	elem_clear(elem);
+	mem_free(elem);
+}
+#line 1 "cdata.c"
+
+#line 20 "cdata.c"
+#line 21 "cdata.c"
+#line 22 "cdata.c"
+
+#include <stdlib.h>
+#include <string.h>
+#include <err.h>
+
+struct cdata *
+cdata_create(T_CDATA type)
+{
+	struct cdata *cdata;
+
+	cdata = mem_calloc(1, sizeof(struct cdata));
+	if (cdata == NULL)
+		err(1, "calloc cdata");
+	STATS_ADD(allocs[ALLOC_CDATA], 1);
+	cdata->type = type;
+
+	return cdata;
+}
+
+struct cdata *
+cdata_copy(struct cdata *cdata)
+{
+	struct cdata *copy;
+
+	copy = cdata_create(cdata->type);
+	if (cdata->data.s != NULL) {
+		copy->data.alloc = cdata->data.len + 1;
+		copy->data.len = cdata->data.len;
+		copy->data.s = mem_malloc(copy->data.alloc);
+		if (copy->data.s == NULL)
+			err(1, "malloc cdata");
+		STATS_ADD(allocs[ALLOC_CDATA], 1);
+		memcpy(copy->data.s, cdata->data.s, copy->data.alloc);
+	}
+
+	return copy;
+}
+
+void
+cdata_add(struct cdata *cdata, const char *s)
+{
+	while (*s != '\0')
+		str_add(&cdata->data, *s++);
+}
+
+size_t
+cdata_size(struct cdata *cdata)
+{
+	return cdata->data.alloc;	
+}
+
+void
+cdata_free(struct cdata *cdata)
+{
+	if (cdata->data.s != NULL)
+		mem_free(cdata->data.s);
+	mem_free(cdata);
+}
+#line 1 "ostack.c"
+
+#line 20 "ostack.c"
+#line 21 "ostack.c"
+#line 22 "ostack.c"
+#line 23 "ostack.c"
+#line 24 "ostack.c"
+
+#include <stdlib.h>
+#include <string.h>
+#include <err.h>
+#include <assert.h>
+
+void
+ostack_push(struct ostack *ostack, struct elem *node)
+{
+	assert(node->tagid >= 0 && node->tagid < TAGMAP_SZ);
+
+	if (ostack->depth == ostack->alloc) {
+		ostack->alloc = ostack->alloc ? ostack->alloc * 2 : 16;
+		ostack->elems = mem_realloc(ostack->elems,
+		    ostack->alloc * sizeof(struct elem *));
+		if (ostack->elems == NULL)
+			err(1, "realloc ostack");
+		STATS_ADD(allocs[ALLOC_OSTACK], 1);
+	}
+	if (ostack->counts == NULL) {
+		ostack->counts = mem_calloc(TAGMAP_SZ, sizeof(size_t));
+		if (ostack->counts == NULL)
+			err(1, "calloc ostack");
+		STATS_ADD(allocs[ALLOC_OSTACK], 1);
+	}
+
+	assert(ostack->elems != NULL);
+	ostack->elems[ostack->depth++] = node;
+	ostack->counts[node->tagid]++;
+}
+
+struct elem *
+ostack_prev(struct ostack *ostack, struct elem *elem)
+{
+	size_t i;
+	size_t sz;
+
+	sz = ostack_depth(ostack);
+	for (i = sz; i >= 1; i--)  {
+		if (ostack->elems[i-1] == elem && i >= 2) {
+			return ostack->elems[i-2];
+		} else
+			break;
+	}
+	return NULL;
+}
+
+/*
+ * The stack keeps its memory when emptied, for the next document, see
+ * purehtml_reset(). It is released by ostack_free().
+ */
+struct elem *
+ostack_pop(struct ostack *ostack)
+{
+	struct elem *elem;
+
+	if (ostack->depth == 0)
+		return NULL;
+
+	elem = ostack->elems[--ostack->depth];
+	ostack->counts[elem->tagid]--;
+	return elem;
+}
+
+/*
+ * Number of open elements with the given tag id.
+ */
+size_t
+ostack_count(struct ostack *ostack, int tagid)
+{
+	assert(tagid >= 0 && tagid < TAGMAP_SZ);
+
+	if (ostack->counts == NULL)
+		return 0;
+	return ostack->counts[tagid];
+}
+
+void
+ostack_free(struct ostack *ostack)
+{
+	mem_free(ostack->elems);
+	mem_free(ostack->counts);
+	memset(ostack, 0, sizeof(struct ostack));
+}
+
+struct elem *
+ostack_peek_at(struct ostack *ostack, size_t depth)
+{
+	if (ostack->depth == 0 || depth > ostack->depth || depth < 1)
+		return NULL;
+
+	return ostack->elems[depth-1];
+}
+
+struct elem *
+ostack_peek(struct ostack *ostack)
+{
+	return ostack_peek_at(ostack, ostack->depth);
+}
+
+size_t
+ostack_depth(struct ostack *ostack)
+{
+	return ostack->depth;
+}
+
+#line 152 "ostack.c"
+
+#line 216 "ostack.c"
+#line 1 "report.c"
+
+#line 20 "report.c"
+#line 21 "report.c"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <err.h>
+
+#line 1 "errors.c"
+/* generated by enum.awk */
+static const char *errors[] = {
+	"abrupt-closing-of-empty-comment",
+	"cdata-in-html-content",
+	"incorrectly-closed-comment",
+	"incorrectly-opened-comment",
+	"invalid-first-character-of-tag-name",
+	"missing-attribute-value",
+	"missing-doctype-name",
+	"missing-whitespace-before-doctype-name",
+	"missing-whitespace-between-attributes",
+	"nested-comment",
+	"unexpected-character-in-attribute-name",
+	"unexpected-character-in-unquoted-attribute-value",
+	"unexpected-equals-sign-before-attribute-name",
+	"unexpected-solidus-in-tag",
+	"unexpected-doctype",
+	"unexpected-token",
+	"implied-head",
+	"element-not-in-scope",
+	"mismatched-end-tag",
+	"unclosed-element",
+	"nested-button",
+	"unsupported",
+};
+#line 28 "report.c"
+
+static void	enqueue(void *, enum errors, size_t, size_t);
+
+/*
+ * Returns the name of an error code, such as
+ * "missing-whitespace-between-attributes".
+ */
+const char *
+report_name(enum errors code)
+{
+	assert(code < NERRORS);
+
+	return errors[code];
+}
+
+size_t
+report_total(const struct report *report)
+{
+	size_t sum;
+	int i;
+
+	sum = 0;
+	for (i = 0; i < NERRORS; i++)
+		sum += report->count[i];
+	return sum;
+}
+
+static void
+enqueue(void *user, enum errors code, size_t line, size_t offset)
+{
+	struct report_queue *queue = user;
+	struct report_entry *entry;
+
+	if (queue->nentries == queue->alloc) {
+		queue->alloc = queue->alloc ? queue->alloc * 2 : 64;
+		queue->entries = mem_realloc(queue->entries,
+		    queue->alloc * sizeof(struct report_entry));
+		if (queue->entries == NULL)
+			err(1, "realloc report queue");
+	}
+
+	entry = &queue->entries[queue->nentries++];
+	entry->index = queue->index;
+	entry->code = code;
+	entry->line = line;
+	entry->offset = offset;
+}
+
+void
+report_queue_init(struct report_queue *queue)
+{
+	memset(queue, 0, sizeof(struct report_queue));
+	queue->report.error = enqueue;
+	queue->report.user = queue;
+}
+
+/*
+ * Report the errors that came with tokens up to index, adding line to
+ * their line numbers.
+ */
+void
+report_queue_flush(struct report_queue *queue, struct report *report,
+    size_t index, size_t line)
+{
+	struct report_entry *entry;
+
+	for (; queue->next < queue->nentries; queue->next++) {
+		entry = &queue->entries[queue->next];
+		if (entry->index > index)
+			break;
+		REPORT(report, entry->code, entry->line + line, entry->offset);
+	}
+}
+
+void
+report_queue_clear(struct report_queue *queue)
+{
+	queue->nentries = queue->next = queue->index = 0;
+}
+
+void
+report_queue_free(struct report_queue *queue)
+{
+	mem_free(queue->entries);
+	report_queue_init(queue);
+}
+#line 1 "stats.c"
+
+#line 20 "stats.c"
+
+#include <string.h>
+#include <assert.h>
+
+#line 25 "stats.c"
+#line 1 "imodes.c"
+/* generated by enum.awk */
+static const char *imodes[] = {
+	"INITIAL",
+	"BEFORE_HTML",
+	"BEFORE_HEAD",
+	"IN_HEAD",
+	"IN_HEAD_NOSCRIPT",
+	"AFTER_HEAD",
+	"IN_BODY",
+	"TEXT",
+	"IN_TABLE",
+	"IN_TABLE_TEXT",
+	"IN_ROW",
+	"IN_CELL",
+	"IN_CAPTION",
+	"IN_COLUMN_GROUP",
+	"IN_TABLE_BODY",
+	"IN_SELECT",
+	"IN_SELECT_IN_TABLE",
+	"IN_TEMPLATE",
+	"AFTER_BODY",
+	"IN_FRAMESET",
+	"AFTER_FRAMESET",
+	"AFTER_AFTER_BODY",
+	"AFTER_AFTER_FRAMESET",
+};
+#line 26 "stats.c"
+#line 1 "allocs.c"
+/* generated by enum.awk */
+static const char *allocs[] = {
+	"elem",
+	"attr",
+	"cdata",
+	"node",
+	"document",
+	"token",
+	"str",
+	"ostack",
+	"view",
+	"input",
+};
+#line 27 "stats.c"
+
+#ifdef PUREHTML_STATS
+struct purehtml_stats stats_counters;
+#endif
+
+/*
+ * Returns the counters, or NULL if the library was built without them.
+ */
+const struct purehtml_stats *
+purehtml_stats(void)
+{
+#ifdef PUREHTML_STATS
+	return &stats_counters;
+#else
+	return NULL;
+#endif
+}
+
+void
+purehtml_stats_reset(void)
+{
+#ifdef PUREHTML_STATS
+	memset(&stats_counters, 0, sizeof(struct purehtml_stats));
+#endif
+}
+
+const char *
+stats_state_name(int state)
+{
+	assert(state >= 0 && state < NSTATES);
+	return states[state];
+}
+
+const char *
+stats_imode_name(int mode)
+{
+	assert(mode >= 0 && mode < NIMODES);
+	return imodes[mode];
+}
+
+const char *
+stats_alloc_name(int type)
+{
+	assert(type >= 0 && type < NALLOCS);
+	return allocs[type];
+}
+#line 1 "util.c"
+
+#line 20 "util.c"
+#line 21 "util.c"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <err.h>
+
+static struct allocator allocator = { malloc, realloc, free };
+
+/*
+ * Set the allocator, or the default one if NULL. Must be done before
+ * the library allocates anything that is freed after the change.
+ */
+void
+purehtml_allocator(const struct allocator *new)
+{
+	static const struct allocator libc = { malloc, realloc, free };
+
+	allocator = (new != NULL) ? *new : libc;
+}
+
+void *
+mem_malloc(size_t size)
+{
+	return allocator.malloc(size);
+}
+
+void *
+mem_calloc(size_t nmemb, size_t size)
+{
+	void *p;
+
+	if (size > 0 && nmemb > SIZE_MAX / size)
+		return NULL;
+	if ((p = allocator.malloc(nmemb * size)) != NULL)
+		memset(p, 0, nmemb * size);
+	return p;
+}
+
+void *
+mem_realloc(void *ptr, size_t size)
+{
+	return allocator.realloc(ptr, size);
+}
+
+char *
+mem_strdup(const char *s)
+{
+	size_t len;
+	char *p;
+
+	len = strlen(s) + 1;
+	if ((p = allocator.malloc(len)) != NULL)
+		memcpy(p, s, len);
+	return p;
+}
+
+void
+mem_free(void *ptr)
+{
+	allocator.free(ptr);
+}
+
+/*
+ * Example:
+ *   static struct str;
+ *
+ *   str_add(&str, 'a');
+ *
+ * Use '\0' to reset the str without needing to reallocate.
+ */
+void
+str_add(struct str *str, char c)
+{
+	assert(str != NULL);
+
+	if (c == '\0') {
+		str->len = 0;
+		if (str->s != NULL)
+			str->s[str->len] = '\0';
+		return;
+	}
+
+#define STR_CHUNK 64
+	if (str->len+1 >= str->alloc) {
+		str->alloc = str->alloc ? str->alloc * 2 : STR_CHUNK;
+		str->s = mem_realloc(str->s, str->alloc);
+		if (str->s == NULL)
+			err(1, "realloc str");
+		STATS_ADD(allocs[ALLOC_STR], 1);
+	}
+
+	str->s[str->len++] = c;
+	str->s[str->len] = '\0';
+}
+#undef STR_CHUNK
+#line 1 "encoding.c"
+
+#line 20 "encoding.c"
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#define IS_SPACE(_c) ((_c) == '\t' || (_c) == '\n' || (_c) == '\f' || \
+	(_c) == '\r' || (_c) == ' ')
+#define IS_ALPHA(_c) (((_c) >= 'a' && (_c) <= 'z') || \
+	((_c) >= 'A' && (_c) <= 'Z'))
+#define TO_LOWER(_c) ((_c) >= 'A' && (_c) <= 'Z' ? (_c) + 'a' - 'A' : (_c))
+
+/*
+ * High bit set in any of the 8 bytes of a word.
+ */
+#define NON_ASCII 0x8080808080808080ULL
+
+static const char *names[] = {
+	"none",
+	"binary",
+	"UTF-8",
+	"UTF-16LE",
+	"UTF-16BE",
+	"IBM866",
+	"ISO-8859-2",
+	"ISO-8859-5",
+	"ISO-8859-7",
+	"ISO-8859-15",
+	"KOI8-R",
+	"KOI8-U",
+	"macintosh",
+	"windows-1250",
+	"windows-1251",
+	"windows-1252",
+	"windows-1253",
+	"windows-1254",
+	"windows-1257"
+};
+
+/*
+ * Labels from the WHATWG Encoding standard.
+ */
+static const struct {
+	const char	*label;
+	int		 encoding;
+} labels[] = {
+	{ "unicode-1-1-utf-8", ENCODING_UTF8 },
+	{ "unicode11utf8", ENCODING_UTF8 },
+	{ "unicode20utf8", ENCODING_UTF8 },
+	{ "utf-8", ENCODING_UTF8 },
+	{ "utf8", ENCODING_UTF8 },
+	{ "x-unicode20utf8", ENCODING_UTF8 },
+	{ "csunicode", ENCODING_UTF16LE },
+	{ "iso-10646-ucs-2", ENCODING_UTF16LE },
+	{ "ucs-2", ENCODING_UTF16LE },
+	{ "unicode", ENCODING_UTF16LE },
+	{ "unicodefeff", ENCODING_UTF16LE },
+	{ "utf-16", ENCODING_UTF16LE },
+	{ "utf-16le", ENCODING_UTF16LE },
+	{ "unicodefffe", ENCODING_UTF16BE },
+	{ "utf-16be", ENCODING_UTF16BE },
+	{ "866", ENCODING_IBM866 },
+	{ "cp866", ENCODING_IBM866 },
+	{ "csibm866", ENCODING_IBM866 },
+	{ "ibm866", ENCODING_IBM866 },
+	{ "csisolatin2", ENCODING_ISO_8859_2 },
+	{ "iso-8859-2", ENCODING_ISO_8859_2 },
+	{ "iso-ir-101", ENCODING_ISO_8859_2 },
+	{ "iso8859-2", ENCODING_ISO_8859_2 },
+	{ "iso88592", ENCODING_ISO_8859_2 },
+	{ "iso_8859-2", ENCODING_ISO_8859_2 },
+	{ "iso_8859-2:1987", ENCODING_ISO_8859_2 },
+	{ "l2", ENCODING_ISO_8859_2 },
+	{ "latin2", ENCODING_ISO_8859_2 },
+	{ "csisolatincyrillic", ENCODING_ISO_8859_5 },
+	{ "cyrillic", ENCODING_ISO_8859_5 },
+	{ "iso-8859-5", ENCODING_ISO_8859_5 },
+	{ "iso-ir-144", ENCODING_ISO_8859_5 },
+	{ "iso8859-5", ENCODING_ISO_8859_5 },
+	{ "iso88595", ENCODING_ISO_8859_5 },
+	{ "iso_8859-5", ENCODING_ISO_8859_5 },
+	{ "iso_8859-5:1988", ENCODING_ISO_8859_5 },
+	{ "csisolatingreek", ENCODING_ISO_8859_7 },
+	{ "ecma-118", ENCODING_ISO_8859_7 },
+	{ "elot_928", ENCODING_ISO_8859_7 },
+	{ "greek", ENCODING_ISO_8859_7 },
+	{ "greek8", ENCODING_ISO_8859_7 },
+	{ "iso-8859-7", ENCODING_ISO_8859_7 },
+	{ "iso-ir-126", ENCODING_ISO_8859_7 },
+	{ "iso8859-7", ENCODING_ISO_8859_7 },
+	{ "iso88597", ENCODING_ISO_8859_7 },
+	{ "iso_8859-7", ENCODING_ISO_8859_7 },
+	{ "iso_8859-7:1987", ENCODING_ISO_8859_7 },
+	{ "sun_eu_greek", ENCODING_ISO_8859_7 },
+	{ "csisolatin9", ENCODING_ISO_8859_15 },
+	{ "iso-8859-15", ENCODING_ISO_8859_15 },
+	{ "iso8859-15", ENCODING_ISO_8859_15 },
+	{ "iso885915", ENCODING_ISO_8859_15 },
+	{ "iso_8859-15", ENCODING_ISO_8859_15 },
+	{ "l9", ENCODING_ISO_8859_15 },
+	{ "cskoi8r", ENCODING_KOI8_R },
+	{ "koi", ENCODING_KOI8_R },
+	{ "koi8", ENCODING_KOI8_R },
+	{ "koi8-r", ENCODING_KOI8_R },
+	{ "koi8_r", ENCODING_KOI8_R },
+	{ "koi8-ru", ENCODING_KOI8_U },
+	{ "koi8-u", ENCODING_KOI8_U },
+	{ "csmacintosh", ENCODING_MACINTOSH },
+	{ "mac", ENCODING_MACINTOSH },
+	{ "macintosh", ENCODING_MACINTOSH },
+	{ "x-mac-roman", ENCODING_MACINTOSH },
+	{ "cp1250", ENCODING_WINDOWS_1250 },
+	{ "windows-1250", ENCODING_WINDOWS_1250 },
+	{ "x-cp1250", ENCODING_WINDOWS_1250 },
+	{ "cp1251", ENCODING_WINDOWS_1251 },
+	{ "windows-1251", ENCODING_WINDOWS_1251 },
+	{ "x-cp1251", ENCODING_WINDOWS_1251 },
+	{ "ansi_x3.4-1968", ENCODING_WINDOWS_1252 },
+	{ "ascii", ENCODING_WINDOWS_1252 },
+	{ "cp1252", ENCODING_WINDOWS_1252 },
+	{ "cp819", ENCODING_WINDOWS_1252 },
+	{ "csisolatin1", ENCODING_WINDOWS_1252 },
+	{ "ibm819", ENCODING_WINDOWS_1252 },
+	{ "iso-8859-1", ENCODING_WINDOWS_1252 },
+	{ "iso-ir-100", ENCODING_WINDOWS_1252 },
+	{ "iso8859-1", ENCODING_WINDOWS_1252 },
+	{ "iso88591", ENCODING_WINDOWS_1252 },
+	{ "iso_8859-1", ENCODING_WINDOWS_1252 },
+	{ "iso_8859-1:1987", ENCODING_WINDOWS_1252 },
+	{ "l1", ENCODING_WINDOWS_1252 },
+	{ "latin1", ENCODING_WINDOWS_1252 },
+	{ "us-ascii", ENCODING_WINDOWS_1252 },
+	{ "windows-1252", ENCODING_WINDOWS_1252 },
+	{ "x-cp1252", ENCODING_WINDOWS_1252 },
+	{ "x-user-defined", ENCODING_WINDOWS_1252 },
+	{ "cp1253", ENCODING_WINDOWS_1253 },
+	{ "windows-1253", ENCODING_WINDOWS_1253 },
+	{ "x-cp1253", ENCODING_WINDOWS_1253 },
+	{ "cp1254", ENCODING_WINDOWS_1254 },
+	{ "csisolatin5", ENCODING_WINDOWS_1254 },
+	{ "iso-8859-9", ENCODING_WINDOWS_1254 },
+	{ "iso-ir-148", ENCODING_WINDOWS_1254 },
+	{ "iso8859-9", ENCODING_WINDOWS_1254 },
+	{ "iso88599", ENCODING_WINDOWS_1254 },
+	{ "iso_8859-9", ENCODING_WINDOWS_1254 },
+	{ "iso_8859-9:1989", ENCODING_WINDOWS_1254 },
+	{ "l5", ENCODING_WINDOWS_1254 },
+	{ "latin5", ENCODING_WINDOWS_1254 },
+	{ "windows-1254", ENCODING_WINDOWS_1254 },
+	{ "x-cp1254", ENCODING_WINDOWS_1254 },
+	{ "cp1257", ENCODING_WINDOWS_1257 },
+	{ "windows-1257", ENCODING_WINDOWS_1257 },
+	{ "x-cp1257", ENCODING_WINDOWS_1257 }
+};
+
+/*
+ * Code points of bytes 0x80-0xff of the single-byte encodings, bytes
+ * 0x00-0x7f are ASCII in all of them.
+ */
+static const unsigned short tables[][128] = {
+	[ENCODING_IBM866 - ENCODING_IBM866] = {
+		0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417,
+		0x0418, 0x0419, 0x041a, 0x041b, 0x041c, 0x041d, 0x041e, 0x041f,
+		0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427,
+		0x0428, 0x0429, 0x042a, 0x042b, 0x042c, 0x042d, 0x042e, 0x042f,
+		0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437,
+		0x0438, 0x0439, 0x043a, 0x043b, 0x043c, 0x043d, 0x043e, 0x043f,
+		0x2591, 0x2592, 0x2593, 0x2502, 0x2524, 0x2561, 0x2562, 0x2556,
+		0x2555, 0x2563, 0x2551, 0x2557, 0x255d, 0x255c, 0x255b, 0x2510,
+		0x2514, 0x2534, 0x252c, 0x251c, 0x2500, 0x253c, 0x255e, 0x255f,
+		0x255a, 0x2554, 0x2569, 0x2566, 0x2560, 0x2550, 0x256c, 0x2567,
+		0x2568, 0x2564, 0x2565, 0x2559, 0x2558, 0x2552, 0x2553, 0x256b,
+		0x256a, 0x2518, 0x250c, 0x2588, 0x2584, 0x258c, 0x2590, 0x2580,
+		0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447,
+		0x0448, 0x0449, 0x044a, 0x044b, 0x044c, 0x044d, 0x044e, 0x044f,
+		0x0401, 0x0451, 0x0404, 0x0454, 0x0407, 0x0457, 0x040e, 0x045e,
+		0x00b0, 0x2219, 0x00b7, 0x221a, 0x2116, 0x00a4, 0x25a0, 0x00a0,
+	},
+	[ENCODING_ISO_8859_2 - ENCODING_IBM866] = {
+		0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087,
+		0x0088, 0x0089, 0x008a, 0x008b, 0x008c, 0x008d, 0x008e, 0x008f,
+		0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097,
+		0x0098, 0x0099, 0x009a, 0x009b, 0x009c, 0x009d, 0x009e, 0x009f,
+		0x00a0, 0x0104, 0x02d8, 0x0141, 0x00a4, 0x013d, 0x015a, 0x00a7,
+		0x00a8, 0x0160, 0x015e, 0x0164, 0x0179, 0x00ad, 0x017d, 0x017b,
+		0x00b0, 0x0105, 0x02db, 0x0142, 0x00b4, 0x013e, 0x015b, 0x02c7,
+		0x00b8, 0x0161, 0x015f, 0x0165, 0x017a, 0x02dd, 0x017e, 0x017c,
+		0x0154, 0x00c1, 0x00c2, 0x0102, 0x00c4, 0x0139, 0x0106, 0x00c7,
+		0x010c, 0x00c9, 0x0118, 0x00cb, 0x011a, 0x00cd, 0x00ce, 0x010e,
+		0x0110, 0x0143, 0x0147, 0x00d3, 0x00d4, 0x0150, 0x00d6, 0x00d7,
+		0x0158, 0x016e, 0x00da, 0x0170, 0x00dc, 0x00dd, 0x0162, 0x00df,
+		0x0155, 0x00e1, 0x00e2, 0x0103, 0x00e4, 0x013a, 0x0107, 0x00e7,
+		0x010d, 0x00e9, 0x0119, 0x00eb, 0x011b, 0x00ed, 0x00ee, 0x010f,
+		0x0111, 0x0144, 0x0148, 0x00f3, 0x00f4, 0x0151, 0x00f6, 0x00f7,
+		0x0159, 0x016f, 0x00fa, 0x0171, 0x00fc, 0x00fd, 0x0163, 0x02d9,
+	},
+	[ENCODING_ISO_8859_5 - ENCODING_IBM866] = {
+		0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087,
+		0x0088, 0x0089, 0x008a, 0x008b, 0x008c, 0x008d, 0x008e, 0x008f,
+		0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097,
+		0x0098, 0x0099, 0x009a, 0x009b, 0x009c, 0x009d, 0x009e, 0x009f,
+		0x00a0, 0x0401, 0x0402, 0x0403, 0x0404, 0x0405, 0x0406, 0x0407,
+		0x0408, 0x0409, 0x040a, 0x040b, 0x040c, 0x00ad, 0x040e, 0x040f,
+		0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417,
+		0x0418, 0x0419, 0x041a, 0x041b, 0x041c, 0x041d, 0x041e, 0x041f,
+		0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427,
+		0x0428, 0x0429, 0x042a, 0x042b, 0x042c, 0x042d, 0x042e, 0x042f,
+		0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437,
+		0x0438, 0x0439, 0x043a, 0x043b, 0x043c, 0x043d, 0x043e, 0x043f,
+		0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447,
+		0x0448, 0x0449, 0x044a, 0x044b, 0x044c, 0x044d, 0x044e, 0x044f,
+		0x2116, 0x0451, 0x0452, 0x0453, 0x0454, 0x0455, 0x0456, 0x0457,
+		0x0458, 0x0459, 0x045a, 0x045b, 0x045c, 0x00a7, 0x045e, 0x045f,
+	},
+	[ENCODING_ISO_8859_7 - ENCODING_IBM866] = {
+		0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087,
+		0x0088, 0x0089, 0x008a, 0x008b, 0x008c, 0x008d, 0x008e, 0x008f,
+		0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097,
+		0x0098, 0x0099, 0x009a, 0x009b, 0x009c, 0x009d, 0x009e, 0x009f,
+		0x00a0, 0x2018, 0x2019, 0x00a3, 0x20ac, 0x20af, 0x00a6, 0x00a7,
+		0x00a8, 0x00a9, 0x037a, 0x00ab, 0x00ac, 0x00ad, 0xfffd, 0x2015,
+		0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x0384, 0x0385, 0x0386, 0x00b7,
+		0x0388, 0x0389, 0x038a, 0x00bb, 0x038c, 0x00bd, 0x038e, 0x038f,
+		0x0390, 0x0391, 0x0392, 0x0393, 0x0394, 0x0395, 0x0396, 0x0397,
+		0x0398, 0x0399, 0x039a, 0x039b, 0x039c, 0x039d, 0x039e, 0x039f,
+		0x03a0, 0x03a1, 0xfffd, 0x03a3, 0x03a4, 0x03a5, 0x03a6, 0x03a7,
+		0x03a8, 0x03a9, 0x03aa, 0x03ab, 0x03ac, 0x03ad, 0x03ae, 0x03af,
+		0x03b0, 0x03b1, 0x03b2, 0x03b3, 0x03b4, 0x03b5, 0x03b6, 0x03b7,
+		0x03b8, 0x03b9, 0x03ba, 0x03bb, 0x03bc, 0x03bd, 0x03be, 0x03bf,
+		0x03c0, 0x03c1, 0x03c2, 0x03c3, 0x03c4, 0x03c5, 0x03c6, 0x03c7,
+		0x03c8, 0x03c9, 0x03ca, 0x03cb, 0x03cc, 0x03cd, 0x03ce, 0xfffd,
+	},
+	[ENCODING_ISO_8859_15 - ENCODING_IBM866] = {
+		0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087,
+		0x0088, 0x0089, 0x008a, 0x008b, 0x008c, 0x008d, 0x008e, 0x008f,
+		0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097,
+		0x0098, 0x0099, 0x009a, 0x009b, 0x009c, 0x009d, 0x009e, 0x009f,
+		0x00a0, 0x00a1, 0x00a2, 0x00a3, 0x20ac, 0x00a5, 0x0160, 0x00a7,
+		0x0161, 0x00a9, 0x00aa, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x00af,
+		0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x017d, 0x00b5, 0x00b6, 0x00b7,
+		0x017e, 0x00b9, 0x00ba, 0x00bb, 0x0152, 0x0153, 0x0178, 0x00bf,
+		0x00c0, 0x00c1, 0x00c2, 0x00c3, 0x00c4, 0x00c5, 0x00c6, 0x00c7,
+		0x00c8, 0x00c9, 0x00ca, 0x00cb, 0x00cc, 0x00cd, 0x00ce, 0x00cf,
+		0x00d0, 0x00d1, 0x00d2, 0x00d3, 0x00d4, 0x00d5, 0x00d6, 0x00d7,
+		0x00d8, 0x00d9, 0x00da, 0x00db, 0x00dc, 0x00dd, 0x00de, 0x00df,
+		0x00e0, 0x00e1, 0x00e2, 0x00e3, 0x00e4, 0x00e5, 0x00e6, 0x00e7,
+		0x00e8, 0x00e9, 0x00ea, 0x00eb, 0x00ec, 0x00ed, 0x00ee, 0x00ef,
+		0x00f0, 0x00f1, 0x00f2, 0x00f3, 0x00f4, 0x00f5, 0x00f6, 0x00f7,
+		0x00f8, 0x00f9, 0x00fa, 0x00fb, 0x00fc, 0x00fd, 0x00fe, 0x00ff,
+	},
+	[ENCODING_KOI8_R - ENCODING_IBM866] = {
+		0x2500, 0x2502, 0x250c, 0x2510, 0x2514, 0x2518, 0x251c, 0x2524,
+		0x252c, 0x2534, 0x253c, 0x2580, 0x2584, 0x2588, 0x258c, 0x2590,
+		0x2591, 0x2592, 0x2593, 0x2320, 0x25a0, 0x2219, 0x221a, 0x2248,
+		0x2264, 0x2265, 0x00a0, 0x2321, 0x00b0, 0x00b2, 0x00b7, 0x00f7,
+		0x2550, 0x2551, 0x2552, 0x0451, 0x2553, 0x2554, 0x2555, 0x2556,
+		0x2557, 0x2558, 0x2559, 0x255a, 0x255b, 0x255c, 0x255d, 0x255e,
+		0x255f, 0x2560, 0x2561, 0x0401, 0x2562, 0x2563, 0x2564, 0x2565,
+		0x2566, 0x2567, 0x2568, 0x2569, 0x256a, 0x256b, 0x256c, 0x00a9,
+		0x044e, 0x0430, 0x0431, 0x0446, 0x0434, 0x0435, 0x0444, 0x0433,
+		0x0445, 0x0438, 0x0439, 0x043a, 0x043b, 0x043c, 0x043d, 0x043e,
+		0x043f, 0x044f, 0x0440, 0x0441, 0x0442, 0x0443, 0x0436, 0x0432,
+		0x044c, 0x044b, 0x0437, 0x0448, 0x044d, 0x0449, 0x0447, 0x044a,
+		0x042e, 0x0410, 0x0411, 0x0426, 0x0414, 0x0415, 0x0424, 0x0413,
+		0x0425, 0x0418, 0x0419, 0x041a, 0x041b, 0x041c, 0x041d, 0x041e,
+		0x041f, 0x042f, 0x0420, 0x0421, 0x0422, 0x0423, 0x0416, 0x0412,
+		0x042c, 0x042b, 0x0417, 0x0428, 0x042d, 0x0429, 0x0427, 0x042a,
+	},
+	[ENCODING_KOI8_U - ENCODING_IBM866] = {
+		0x2500, 0x2502, 0x250c, 0x2510, 0x2514, 0x2518, 0x251c, 0x2524,
+		0x252c, 0x2534, 0x253c, 0x2580, 0x2584, 0x2588, 0x258c, 0x2590,
+		0x2591, 0x2592, 0x2593, 0x2320, 0x25a0, 0x2219, 0x221a, 0x2248,
+		0x2264, 0x2265, 0x00a0, 0x2321, 0x00b0, 0x00b2, 0x00b7, 0x00f7,
+		0x2550, 0x2551, 0x2552, 0x0451, 0x0454, 0x2554, 0x0456, 0x0457,
+		0x2557, 0x2558, 0x2559, 0x255a, 0x255b, 0x0491, 0x255d, 0x255e,
+		0x255f, 0x2560, 0x2561, 0x0401, 0x0404, 0x2563, 0x0406, 0x0407,
+		0x2566, 0x2567, 0x2568, 0x2569, 0x256a, 0x0490, 0x256c, 0x00a9,
+		0x044e, 0x0430, 0x0431, 0x0446, 0x0434, 0x0435, 0x0444, 0x0433,
+		0x0445, 0x0438, 0x0439, 0x043a, 0x043b, 0x043c, 0x043d, 0x043e,
+		0x043f, 0x044f, 0x0440, 0x0441, 0x0442, 0x0443, 0x0436, 0x0432,
+		0x044c, 0x044b, 0x0437, 0x0448, 0x044d, 0x0449, 0x0447, 0x044a,
+		0x042e, 0x0410, 0x0411, 0x0426, 0x0414, 0x0415, 0x0424, 0x0413,
+		0x0425, 0x0418, 0x0419, 0x041a, 0x041b, 0x041c, 0x041d, 0x041e,
+		0x041f, 0x042f, 0x0420, 0x0421, 0x0422, 0x0423, 0x0416, 0x0412,
+		0x042c, 0x042b, 0x0417, 0x0428, 0x042d, 0x0429, 0x0427, 0x042a,
+	},
+	[ENCODING_MACINTOSH - ENCODING_IBM866] = {
+		0x00c4, 0x00c5, 0x00c7, 0x00c9, 0x00d1, 0x00d6, 0x00dc, 0x00e1,
+		0x00e0, 0x00e2, 0x00e4, 0x00e3, 0x00e5, 0x00e7, 0x00e9, 0x00e8,
+		0x00ea, 0x00eb, 0x00ed, 0x00ec, 0x00ee, 0x00ef, 0x00f1, 0x00f3,
+		0x00f2, 0x00f4, 0x00f6, 0x00f5, 0x00fa, 0x00f9, 0x00fb, 0x00fc,
+		0x2020, 0x00b0, 0x00a2, 0x00a3, 0x00a7, 0x2022, 0x00b6, 0x00df,
+		0x00ae, 0x00a9, 0x2122, 0x00b4, 0x00a8, 0x2260, 0x00c6, 0x00d8,
+		0x221e, 0x00b1, 0x2264, 0x2265, 0x00a5, 0x00b5, 0x2202, 0x2211,
+		0x220f, 0x03c0, 0x222b, 0x00aa, 0x00ba, 0x03a9, 0x00e6, 0x00f8,
+		0x00bf, 0x00a1, 0x00ac, 0x221a, 0x0192, 0x2248, 0x2206, 0x00ab,
+		0x00bb, 0x2026, 0x00a0, 0x00c0, 0x00c3, 0x00d5, 0x0152, 0x0153,
+		0x2013, 0x2014, 0x201c, 0x201d, 0x2018, 0x2019, 0x00f7, 0x25ca,
+		0x00ff, 0x0178, 0x2044, 0x20ac, 0x2039, 0x203a, 0xfb01, 0xfb02,
+		0x2021, 0x00b7, 0x201a, 0x201e, 0x2030, 0x00c2, 0x00ca, 0x00c1,
+		0x00cb, 0x00c8, 0x00cd, 0x00ce, 0x00cf, 0x00cc, 0x00d3, 0x00d4,
+		0xf8ff, 0x00d2, 0x00da, 0x00db, 0x00d9, 0x0131, 0x02c6, 0x02dc,
+		0x00af, 0x02d8, 0x02d9, 0x02da, 0x00b8, 0x02dd, 0x02db, 0x02c7,
+	},
+	[ENCODING_WINDOWS_1250 - ENCODING_IBM866] = {
+		0x20ac, 0x0081, 0x201a, 0x0083, 0x201e, 0x2026, 0x2020, 0x2021,
+		0x0088, 0x2030, 0x0160, 0x2039, 0x015a, 0x0164, 0x017d, 0x0179,
+		0x0090, 0x2018, 0x2019, 0x201c, 0x201d, 0x2022, 0x2013, 0x2014,
+		0x0098, 0x2122, 0x0161, 0x203a, 0x015b, 0x0165, 0x017e, 0x017a,
+		0x00a0, 0x02c7, 0x02d8, 0x0141, 0x00a4, 0x0104, 0x00a6, 0x00a7,
+		0x00a8, 0x00a9, 0x015e, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x017b,
+		0x00b0, 0x00b1, 0x02db, 0x0142, 0x00b4, 0x00b5, 0x00b6, 0x00b7,
+		0x00b8, 0x0105, 0x015f, 0x00bb, 0x013d, 0x02dd, 0x013e, 0x017c,
+		0x0154, 0x00c1, 0x00c2, 0x0102, 0x00c4, 0x0139, 0x0106, 0x00c7,
+		0x010c, 0x00c9, 0x0118, 0x00cb, 0x011a, 0x00cd, 0x00ce, 0x010e,
+		0x0110, 0x0143, 0x0147, 0x00d3, 0x00d4, 0x0150, 0x00d6, 0x00d7,
+		0x0158, 0x016e, 0x00da, 0x0170, 0x00dc, 0x00dd, 0x0162, 0x00df,
+		0x0155, 0x00e1, 0x00e2, 0x0103, 0x00e4, 0x013a, 0x0107, 0x00e7,
+		0x010d, 0x00e9, 0x0119, 0x00eb, 0x011b, 0x00ed, 0x00ee, 0x010f,
+		0x0111, 0x0144, 0x0148, 0x00f3, 0x00f4, 0x0151, 0x00f6, 0x00f7,
+		0x0159, 0x016f, 0x00fa, 0x0171, 0x00fc, 0x00fd, 0x0163, 0x02d9,
+	},
+	[ENCODING_WINDOWS_1251 - ENCODING_IBM866] = {
+		0x0402, 0x0403, 0x201a, 0x0453, 0x201e, 0x2026, 0x2020, 0x2021,
+		0x20ac, 0x2030, 0x0409, 0x2039, 0x040a, 0x040c, 0x040b, 0x040f,
+		0x0452, 0x2018, 0x2019, 0x201c, 0x201d, 0x2022, 0x2013, 0x2014,
+		0x0098, 0x2122, 0x0459, 0x203a, 0x045a, 0x045c, 0x045b, 0x045f,
+		0x00a0, 0x040e, 0x045e, 0x0408, 0x00a4, 0x0490, 0x00a6, 0x00a7,
+		0x0401, 0x00a9, 0x0404, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x0407,
+		0x00b0, 0x00b1, 0x0406, 0x0456, 0x0491, 0x00b5, 0x00b6, 0x00b7,
+		0x0451, 0x2116, 0x0454, 0x00bb, 0x0458, 0x0405, 0x0455, 0x0457,
+		0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417,
+		0x0418, 0x0419, 0x041a, 0x041b, 0x041c, 0x041d, 0x041e, 0x041f,
+		0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427,
+		0x0428, 0x0429, 0x042a, 0x042b, 0x042c, 0x042d, 0x042e, 0x042f,
+		0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437,
+		0x0438, 0x0439, 0x043a, 0x043b, 0x043c, 0x043d, 0x043e, 0x043f,
+		0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447,
+		0x0448, 0x0449, 0x044a, 0x044b, 0x044c, 0x044d, 0x044e, 0x044f,
+	},
+	[ENCODING_WINDOWS_1252 - ENCODING_IBM866] = {
+		0x20ac, 0x0081, 0x201a, 0x0192, 0x201e, 0x2026, 0x2020, 0x2021,
+		0x02c6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008d, 0x017d, 0x008f,
+		0x0090, 0x2018, 0x2019, 0x201c, 0x201d, 0x2022, 0x2013, 0x2014,
+		0x02dc, 0x2122, 0x0161, 0x203a, 0x0153, 0x009d, 0x017e, 0x0178,
+		0x00a0, 0x00a1, 0x00a2, 0x00a3, 0x00a4, 0x00a5, 0x00a6, 0x00a7,
+		0x00a8, 0x00a9, 0x00aa, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x00af,
+		0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x00b4, 0x00b5, 0x00b6, 0x00b7,
+		0x00b8, 0x00b9, 0x00ba, 0x00bb, 0x00bc, 0x00bd, 0x00be, 0x00bf,
+		0x00c0, 0x00c1, 0x00c2, 0x00c3, 0x00c4, 0x00c5, 0x00c6, 0x00c7,
+		0x00c8, 0x00c9, 0x00ca, 0x00cb, 0x00cc, 0x00cd, 0x00ce, 0x00cf,
+		0x00d0, 0x00d1, 0x00d2, 0x00d3, 0x00d4, 0x00d5, 0x00d6, 0x00d7,
+		0x00d8, 0x00d9, 0x00da, 0x00db, 0x00dc, 0x00dd, 0x00de, 0x00df,
+		0x00e0, 0x00e1, 0x00e2, 0x00e3, 0x00e4, 0x00e5, 0x00e6, 0x00e7,
+		0x00e8, 0x00e9, 0x00ea, 0x00eb, 0x00ec, 0x00ed, 0x00ee, 0x00ef,
+		0x00f0, 0x00f1, 0x00f2, 0x00f3, 0x00f4, 0x00f5, 0x00f6, 0x00f7,
+		0x00f8, 0x00f9, 0x00fa, 0x00fb, 0x00fc, 0x00fd, 0x00fe, 0x00ff,
+	},
+	[ENCODING_WINDOWS_1253 - ENCODING_IBM866] = {
+		0x20ac, 0x0081, 0x201a, 0x0192, 0x201e, 0x2026, 0x2020, 0x2021,
+		0x0088, 0x2030, 0x008a, 0x2039, 0x008c, 0x008d, 0x008e, 0x008f,
+		0x0090, 0x2018, 0x2019, 0x201c, 0x201d, 0x2022, 0x2013, 0x2014,
+		0x0098, 0x2122, 0x009a, 0x203a, 0x009c, 0x009d, 0x009e, 0x009f,
+		0x00a0, 0x0385, 0x0386, 0x00a3, 0x00a4, 0x00a5, 0x00a6, 0x00a7,
+		0x00a8, 0x00a9, 0xfffd, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x2015,
+		0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x0384, 0x00b5, 0x00b6, 0x00b7,
+		0x0388, 0x0389, 0x038a, 0x00bb, 0x038c, 0x00bd, 0x038e, 0x038f,
+		0x0390, 0x0391, 0x0392, 0x0393, 0x0394, 0x0395, 0x0396, 0x0397,
+		0x0398, 0x0399, 0x039a, 0x039b, 0x039c, 0x039d, 0x039e, 0x039f,
+		0x03a0, 0x03a1, 0xfffd, 0x03a3, 0x03a4, 0x03a5, 0x03a6, 0x03a7,
+		0x03a8, 0x03a9, 0x03aa, 0x03ab, 0x03ac, 0x03ad, 0x03ae, 0x03af,
+		0x03b0, 0x03b1, 0x03b2, 0x03b3, 0x03b4, 0x03b5, 0x03b6, 0x03b7,
+		0x03b8, 0x03b9, 0x03ba, 0x03bb, 0x03bc, 0x03bd, 0x03be, 0x03bf,
+		0x03c0, 0x03c1, 0x03c2, 0x03c3, 0x03c4, 0x03c5, 0x03c6, 0x03c7,
+		0x03c8, 0x03c9, 0x03ca, 0x03cb, 0x03cc, 0x03cd, 0x03ce, 0xfffd,
+	},
+	[ENCODING_WINDOWS_1254 - ENCODING_IBM866] = {
+		0x20ac, 0x0081, 0x201a, 0x0192, 0x201e, 0x2026, 0x2020, 0x2021,
+		0x02c6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008d, 0x008e, 0x008f,
+		0x0090, 0x2018, 0x2019, 0x201c, 0x201d, 0x2022, 0x2013, 0x2014,
+		0x02dc, 0x2122, 0x0161, 0x203a, 0x0153, 0x009d, 0x009e, 0x0178,
+		0x00a0, 0x00a1, 0x00a2, 0x00a3, 0x00a4, 0x00a5, 0x00a6, 0x00a7,
+		0x00a8, 0x00a9, 0x00aa, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x00af,
+		0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x00b4, 0x00b5, 0x00b6, 0x00b7,
+		0x00b8, 0x00b9, 0x00ba, 0x00bb, 0x00bc, 0x00bd, 0x00be, 0x00bf,
+		0x00c0, 0x00c1, 0x00c2, 0x00c3, 0x00c4, 0x00c5, 0x00c6, 0x00c7,
+		0x00c8, 0x00c9, 0x00ca, 0x00cb, 0x00cc, 0x00cd, 0x00ce, 0x00cf,
+		0x011e, 0x00d1, 0x00d2, 0x00d3, 0x00d4, 0x00d5, 0x00d6, 0x00d7,
+		0x00d8, 0x00d9, 0x00da, 0x00db, 0x00dc, 0x0130, 0x015e, 0x00df,
+		0x00e0, 0x00e1, 0x00e2, 0x00e3, 0x00e4, 0x00e5, 0x00e6, 0x00e7,
+		0x00e8, 0x00e9, 0x00ea, 0x00eb, 0x00ec, 0x00ed, 0x00ee, 0x00ef,
+		0x011f, 0x00f1, 0x00f2, 0x00f3, 0x00f4, 0x00f5, 0x00f6, 0x00f7,
+		0x00f8, 0x00f9, 0x00fa, 0x00fb, 0x00fc, 0x0131, 0x015f, 0x00ff,
+	},
+	[ENCODING_WINDOWS_1257 - ENCODING_IBM866] = {
+		0x20ac, 0x0081, 0x201a, 0x0083, 0x201e, 0x2026, 0x2020, 0x2021,
+		0x0088, 0x2030, 0x008a, 0x2039, 0x008c, 0x00a8, 0x02c7, 0x00b8,
+		0x0090, 0x2018, 0x2019, 0x201c, 0x201d, 0x2022, 0x2013, 0x2014,
+		0x0098, 0x2122, 0x009a, 0x203a, 0x009c, 0x00af, 0x02db, 0x009f,
+		0x00a0, 0xfffd, 0x00a2, 0x00a3, 0x00a4, 0xfffd, 0x00a6, 0x00a7,
+		0x00d8, 0x00a9, 0x0156, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x00c6,
+		0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x00b4, 0x00b5, 0x00b6, 0x00b7,
+		0x00f8, 0x00b9, 0x0157, 0x00bb, 0x00bc, 0x00bd, 0x00be, 0x00e6,
+		0x0104, 0x012e, 0x0100, 0x0106, 0x00c4, 0x00c5, 0x0118, 0x0112,
+		0x010c, 0x00c9, 0x0179, 0x0116, 0x0122, 0x0136, 0x012a, 0x013b,
+		0x0160, 0x0143, 0x0145, 0x00d3, 0x014c, 0x00d5, 0x00d6, 0x00d7,
+		0x0172, 0x0141, 0x015a, 0x016a, 0x00dc, 0x017b, 0x017d, 0x00df,
+		0x0105, 0x012f, 0x0101, 0x0107, 0x00e4, 0x00e5, 0x0119, 0x0113,
+		0x010d, 0x00e9, 0x017a, 0x0117, 0x0123, 0x0137, 0x012b, 0x013c,
+		0x0161, 0x0144, 0x0146, 0x00f3, 0x014d, 0x00f5, 0x00f6, 0x00f7,
+		0x0173, 0x0142, 0x015b, 0x016b, 0x00fc, 0x017c, 0x017e, 0x02d9,
+	},
+};
+
+const char *
+encoding_name(int encoding)
+{
+	assert(encoding >= 0 &&
+	    encoding < (int) (sizeof(names) / sizeof(names[0])));
+
+	return names[encoding];
+}
+
+/*
+ * Returns the encoding of a label like "ISO-8859-1", or ENCODING_NONE
+ * if it is not known.
+ */
+int
+encoding_label(const char *s, size_t len)
+{
+	const char *label;
+	size_t i, j;
+
+	while (len > 0 && IS_SPACE(*s)) {
+		s++;
+		len--;
+	}
+	while (len > 0 && IS_SPACE(s[len - 1]))
+		len--;
+
+	for (i = 0; i < sizeof(labels) / sizeof(labels[0]); i++) {
+		label = labels[i].label;
+		for (j = 0; j < len && label[j] != '\0'; j++)
+			if (TO_LOWER(s[j]) != label[j])
+				break;
+		if (j == len && label[j] == '\0')
+			return labels[i].encoding;
+	}
+
+	return ENCODING_NONE;
+}
+
+/*
+ * Returns the encoding of the charset parameter in a Content-Type
+ * value like "text/html; charset=utf-8", or ENCODING_NONE.
+ */
+int
+encoding_charset(const char *s, size_t len)
+{
+	size_t i, j;
+	char quote;
+
+	i = 0;
+	for (;;) {
+		for (; i + 7 <= len; i++) {
+			for (j = 0; j < 7; j++)
+				if (TO_LOWER(s[i + j]) != "charset"[j])
+					break;
+			if (j == 7)
+				break;
+		}
+		if (i + 7 > len)
+			return ENCODING_NONE;
+		for (i += 7; i < len && IS_SPACE(s[i]); i++)
+			;
+		if (i < len && s[i] == '=')
+			break;
+	}
+
+	for (i++; i < len && IS_SPACE(s[i]); i++)
+		;
+	if (i == len)
+		return ENCODING_NONE;
+
+	if (s[i] == '"' || s[i] == '\'') {
+		quote = s[i++];
+		for (j = i; j < len && s[j] != quote; j++)
+			;
+		if (j == len)
+			return ENCODING_NONE;
+	} else
+		for (j = i; j < len && !IS_SPACE(s[j]) && s[j] != ';'; j++)
+			;
+
+	return encoding_label(&s[i], j - i);
+}
+
+/*
+ * Returns the length of the byte order mark at the start of the buffer
+ * and sets the encoding it implies, or returns 0.
+ */
+size_t
+encoding_bom(const char *buf, size_t len, int *encoding)
+{
+	const unsigned char *s = (const unsigned char *) buf;
+
+	if (len >= 3 && s[0] == 0xef && s[1] == 0xbb && s[2] == 0xbf) {
+		*encoding = ENCODING_UTF8;
+		return 3;
+	} else if (len >= 2 && s[0] == 0xfe && s[1] == 0xff) {
+		*encoding = ENCODING_UTF16BE;
+		return 2;
+	} else if (len >= 2 && s[0] == 0xff && s[1] == 0xfe) {
+		*encoding = ENCODING_UTF16LE;
+		return 2;
+	}
+
+	return 0;
+}
+
+/*
+ * Attribute of a tag found by the prescan, truncated if it is long.
+ */
+struct prescan_attr {
+	char	name[16];
+	char	value[128];
+	size_t	value_len;
+};
+
+/*
+ * The "get an attribute" algorithm of the prescan. Returns the position
+ * after the attribute, or 0 if there is none and *i is left at the '>'
+ * or at the end.
+ */
+static int
+get_attr(const char *s, size_t len, size_t *i, struct prescan_attr *attr)
+{
+	size_t name_len;
+	char c, quote;
+
+	attr->value_len = name_len = 0;
+	while (*i < len && (IS_SPACE(s[*i]) || s[*i] == '/'))
+		(*i)++;
+	if (*i == len || s[*i] == '>')
+		return 0;
+
+	for (;; (*i)++) {
+		if (*i == len)
+			return 0;
+		c = s[*i];
+		if (c == '=' && name_len > 0) {
+			(*i)++;
+			break;
+		} else if (IS_SPACE(c)) {
+			while (*i < len && IS_SPACE(s[*i]))
+				(*i)++;
+			if (*i == len)
+				return 0;
+			if (s[*i] != '=')
+				goto done;
+			(*i)++;
+			break;
+		} else if (c == '/' || c == '>')
+			goto done;
+		if (name_len < sizeof(attr->name) - 1)
+			attr->name[name_len++] = TO_LOWER(c);
+	}
+
+	while (*i < len && IS_SPACE(s[*i]))
+		(*i)++;
+	if (*i == len)
+		return 0;
+
+	if (s[*i] == '"' || s[*i] == '\'') {
+		quote = s[(*i)++];
+		for (; *i < len && s[*i] != quote; (*i)++)
+			if (attr->value_len < sizeof(attr->value))
+				attr->value[attr->value_len++] =
+				    TO_LOWER(s[*i]);
+		if (*i == len)
+			return 0;
+		(*i)++;
+	} else if (s[*i] != '>') {
+		for (; *i < len && !IS_SPACE(s[*i]) && s[*i] != '>'; (*i)++)
+			if (attr->value_len < sizeof(attr->value))
+				attr->value[attr->value_len++] =
+				    TO_LOWER(s[*i]);
+		if (*i == len)
+			return 0;
+	}
+
+done:
+	attr->name[name_len] = '\0';
+	return 1;
+}
+
+/*
+ * Handle a <meta> tag starting at *i, the "<meta" already matched.
+ * Returns the encoding it declares, or ENCODING_NONE.
+ */
+static int
+prescan_meta(const char *s, size_t len, size_t *i)
+{
+	struct prescan_attr attr;
+	int seen, got_pragma, need_pragma, charset;
+
+	seen = got_pragma = 0;
+	need_pragma = -1;
+	charset = ENCODING_NONE;
+
+	*i += 5;
+	while (get_attr(s, len, i, &attr)) {
+		if (strcmp(attr.name, "http-equiv") == 0 && !(seen & 1)) {
+			seen |= 1;
+			if (attr.value_len == 12 &&
+			    memcmp(attr.value, "content-type", 12) == 0)
+				got_pragma = 1;
+		} else if (strcmp(attr.name, "content") == 0 && !(seen & 2)) {
+			seen |= 2;
+			if (charset == ENCODING_NONE && need_pragma == -1) {
+				charset = encoding_charset(attr.value,
+				    attr.value_len);
+				if (charset != ENCODING_NONE)
+					need_pragma = 1;
+			}
+		} else if (strcmp(attr.name, "charset") == 0 && !(seen & 4)) {
+			seen |= 4;
+			charset = encoding_label(attr.value, attr.value_len);
+			need_pragma = 0;
+		}
+	}
+
+	if (need_pragma == -1 || (need_pragma == 1 && !got_pragma))
+		return ENCODING_NONE;
+	if (charset == ENCODING_UTF16LE || charset == ENCODING_UTF16BE)
+		return ENCODING_UTF8;
+	return charset;
+}
+
+/*
+ * Look for a <meta charset> or <meta http-equiv="Content-Type"> in the
+ * first ENCODING_PRESCAN bytes, as in the HTML standard. Returns the
+ * encoding declared, or ENCODING_NONE.
+ */
+int
+encoding_prescan(const char *s, size_t len)
+{
+	struct prescan_attr attr;
+	size_t i;
+	int charset;
+
+	if (len > ENCODING_PRESCAN)
+		len = ENCODING_PRESCAN;
+
+	for (i = 0; i < len; i++) {
+		if (s[i] != '<')
+			continue;
+		if (i + 4 <= len && memcmp(&s[i], "<!--", 4) == 0) {
+			for (i += 2; i + 3 <= len; i++)
+				if (memcmp(&s[i], "-->", 3) == 0)
+					break;
+			i += 2;
+		} else if (i + 6 <= len && TO_LOWER(s[i + 1]) == 'm' &&
+		    TO_LOWER(s[i + 2]) == 'e' && TO_LOWER(s[i + 3]) == 't' &&
+		    TO_LOWER(s[i + 4]) == 'a' &&
+		    (IS_SPACE(s[i + 5]) || s[i + 5] == '/')) {
+			if ((charset = prescan_meta(s, len, &i)) !=
+			    ENCODING_NONE)
+				return charset;
+		} else if (i + 2 < len && (IS_ALPHA(s[i + 1]) ||
+		    (s[i + 1] == '/' && IS_ALPHA(s[i + 2])))) {
+			while (i < len && !IS_SPACE(s[i]) && s[i] != '>')
+				i++;
+			while (get_attr(s, len, &i, &attr))
+				;
+		} else if (i + 1 < len && (s[i + 1] == '!' ||
+		    s[i + 1] == '/' || s[i + 1] == '?')) {
+			while (i < len && s[i] != '>')
+				i++;
+		}
+	}
+
+	return ENCODING_NONE;
+}
+
+/*
+ * Returns the length of a valid UTF-8 sequence at s, 0 if it is valid
+ * so far but cut short, or minus the number of bytes to replace with
+ * U+FFFD if it is not valid.
+ */
+static int
+utf8_check(const unsigned char *s, size_t len)
+{
+	unsigned char lo, hi;
+	int n, i;
+
+	lo = 0x80;
+	hi = 0xbf;
+	if (s[0] < 0x80)
+		return 1;
+	else if (s[0] < 0xc2)
+		return -1;
+	else if (s[0] < 0xe0)
+		n = 2;
+	else if (s[0] < 0xf0) {
+		n = 3;
+		if (s[0] == 0xe0)
+			lo = 0xa0;
+		else if (s[0] == 0xed)
+			hi = 0x9f;
+	} else if (s[0] < 0xf5) {
+		n = 4;
+		if (s[0] == 0xf0)
+			lo = 0x90;
+		else if (s[0] == 0xf4)
+			hi = 0x8f;
+	} else
+		return -1;
+
+	for (i = 1; i < n; i++) {
+		if (i == len)
+			return 0;
+		if (s[i] < lo || s[i] > hi)
+			return -i;
+		lo = 0x80;
+		hi = 0xbf;
+	}
+
+	return n;
+}
+
+/*
+ * Shift based DFA for validating UTF-8: the next state is the 6 bits
+ * of utf8_dfa[byte] at the offset given by the current state, so there
+ * is no branch per byte. ERROR is 0 and stays so.
+ */
+#define S_ERROR		0
+#define S_ACCEPT	6
+#define S_TAIL1		12		/* one continuation byte to go */
+#define S_TAIL2		18
+#define S_TAIL3		24
+#define S_E0		30		/* A0-BF then one more */
+#define S_ED		36		/* 80-9F then one more */
+#define S_F0		42		/* 90-BF then two more */
+#define S_F4		48		/* 80-8F then two more */
+
+#define T(_from, _to) ((uint64_t) (_to) << (_from))
+
+#define ASCII	T(S_ACCEPT, S_ACCEPT)
+#define CONT	(T(S_TAIL1, S_ACCEPT) | T(S_TAIL2, S_TAIL1) | \
+		T(S_TAIL3, S_TAIL2))
+#define CONT_8	(CONT | T(S_ED, S_TAIL1) | T(S_F4, S_TAIL2))
+#define CONT_9	(CONT | T(S_ED, S_TAIL1) | T(S_F0, S_TAIL2))
+#define CONT_A	(CONT | T(S_E0, S_TAIL1) | T(S_F0, S_TAIL2))
+#define LEAD2	T(S_ACCEPT, S_TAIL1)
+#define LEAD3	T(S_ACCEPT, S_TAIL2)
+#define LEAD4	T(S_ACCEPT, S_TAIL3)
+#define BAD	0
+
+#define X4(_x) _x, _x, _x, _x
+#define X16(_x) X4(_x), X4(_x), X4(_x), X4(_x)
+
+static const uint64_t utf8_dfa[256] = {
+	X16(ASCII), X16(ASCII), X16(ASCII), X16(ASCII),
+	X16(ASCII), X16(ASCII), X16(ASCII), X16(ASCII),
+	X16(CONT_8), X16(CONT_9), X16(CONT_A), X16(CONT_A),
+	BAD, BAD, LEAD2, LEAD2, X4(LEAD2), X4(LEAD2), X4(LEAD2),
+	X16(LEAD2),
+	T(S_ACCEPT, S_E0), LEAD3, LEAD3, LEAD3, X4(LEAD3), X4(LEAD3),
+	LEAD3, T(S_ACCEPT, S_ED), LEAD3, LEAD3,
+	T(S_ACCEPT, S_F0), LEAD4, LEAD4, LEAD4, T(S_ACCEPT, S_F4),
+	BAD, BAD, BAD, X4(BAD), X4(BAD)
+};
+
+/*
+ * Returns the start of the sequence that the valid prefix s[0..i) ends
+ * in the middle of.
+ */
+static size_t
+seq_start(const unsigned char *s, size_t i)
+{
+	while (i > 0 && (s[i - 1] & 0xc0) == 0x80)
+		i--;
+	return i > 0 ? i - 1 : 0;
+}
+
+/*
+ * Returns the length of the longest prefix of buf that is valid UTF-8.
+ * Runs of ASCII are skipped 16 bytes at a time and the rest goes
+ * through the DFA in blocks of 16 bytes, checking for an error only at
+ * the end of each block.
+ */
+size_t
+encoding_utf8_valid(const char *buf, size_t len)
+{
+	const unsigned char *s = (const unsigned char *) buf;
+	uint64_t w[2], state, prev;
+	size_t i, j, end, last;
+
+	state = S_ACCEPT;
+	for (i = 0; i < len; i = end) {
+		if (state == S_ACCEPT && i + 16 <= len) {
+			memcpy(w, &s[i], 16);
+			if (((w[0] | w[1]) & NON_ASCII) == 0) {
+				end = i + 16;
+				continue;
+			}
+		}
+
+		prev = state;
+		end = i + 16 < len ? i + 16 : len;
+		for (j = i; j < end; j++)
+			state = (utf8_dfa[s[j]] >> state) & 63;
+		if (state != S_ERROR)
+			continue;
+
+		/*
+		 * Find the end of the last valid sequence in the block.
+		 */
+		last = prev == S_ACCEPT ? i : seq_start(s, i);
+		for (state = prev, j = i; state != S_ERROR; j++) {
+			state = (utf8_dfa[s[j]] >> state) & 63;
+			if (state == S_ACCEPT)
+				last = j + 1;
+		}
+		return last;
+	}
+
+	return state == S_ACCEPT ? len : seq_start(s, len);
+}
+
+/*
+ * Guess the encoding of a document that has no byte order mark: a
+ * <meta> declaration wins, otherwise it is UTF-8 if it validates as
+ * such and windows-1252 if not. If final is zero, buf is only the
+ * start of the document and may end in the middle of a character.
+ */
+int
+encoding_sniff(const char *buf, size_t len, int final)
+{
+	size_t valid;
+	int charset;
+
+	if ((charset = encoding_prescan(buf, len)) != ENCODING_NONE)
+		return charset;
+
+	valid = encoding_utf8_valid(buf, len);
+	if (valid == len || (!final &&
+	    utf8_check((const unsigned char *) &buf[valid], len - valid) == 0))
+		return ENCODING_UTF8;
+
+	return ENCODING_WINDOWS_1252;
+}
+
+static size_t
+put_utf8(char *dst, unsigned int cp)
+{
+	if (cp < 0x80) {
+		dst[0] = cp;
+		return 1;
+	} else if (cp < 0x800) {
+		dst[0] = 0xc0 | (cp >> 6);
+		dst[1] = 0x80 | (cp & 0x3f);
+		return 2;
+	} else if (cp < 0x10000) {
+		dst[0] = 0xe0 | (cp >> 12);
+		dst[1] = 0x80 | ((cp >> 6) & 0x3f);
+		dst[2] = 0x80 | (cp & 0x3f);
+		return 3;
+	}
+	dst[0] = 0xf0 | (cp >> 18);
+	dst[1] = 0x80 | ((cp >> 12) & 0x3f);
+	dst[2] = 0x80 | ((cp >> 6) & 0x3f);
+	dst[3] = 0x80 | (cp & 0x3f);
+	return 4;
+}
+
+static size_t
+decode_single(const unsigned short *table, const unsigned char *s,
+    size_t *len, char *dst, size_t size)
+{
+	uint64_t w;
+	size_t i, o;
+
+	i = o = 0;
+	while (i < *len && o + 3 <= size) {
+		if (i + 8 <= *len && o + 8 <= size) {
+			memcpy(&w, &s[i], 8);
+			if ((w & NON_ASCII) == 0) {
+				memcpy(&dst[o], &w, 8);
+				i += 8;
+				o += 8;
+				continue;
+			}
+		}
+		if (s[i] < 0x80)
+			dst[o++] = s[i];
+		else
+			o += put_utf8(&dst[o], table[s[i] - 0x80]);
+		i++;
+	}
+
+	*len = i;
+	return o;
+}
+
+/*
+ * Copy UTF-8 replacing invalid sequences with U+FFFD as in the
+ * Encoding standard.
+ */
+static size_t
+decode_utf8(const unsigned char *s, size_t *len, char *dst, size_t size,
+    int final)
+{
+	size_t i, o, n;
+	int k;
+
+	i = o = 0;
+	while (i < *len && o + 4 <= size) {
+		n = *len - i < size - o ? *len - i : size - o;
+		n = encoding_utf8_valid((const char *) &s[i], n);
+		if (n > 0) {
+			memcpy(&dst[o], &s[i], n);
+			i += n;
+			o += n;
+			continue;
+		}
+
+		if ((k = utf8_check(&s[i], *len - i)) > 0) {
+			memcpy(&dst[o], &s[i], k);
+			o += k;
+			i += k;
+		} else if (k == 0 && !final)
+			break;
+		else {
+			o += put_utf8(&dst[o], 0xfffd);
+			i += k == 0 ? *len - i : -k;
+		}
+	}
+
+	*len = i;
+	return o;
+}
+
+static size_t
+decode_utf16(int be, const unsigned char *s, size_t *len, char *dst,
+    size_t size, int final)
+{
+	unsigned int cp, lo;
+	size_t i, o;
+
+	i = o = 0;
+	while (i + 2 <= *len && o + 4 <= size) {
+		cp = be ? (s[i] << 8 | s[i + 1]) : (s[i + 1] << 8 | s[i]);
+		i += 2;
+		if (cp >= 0xd800 && cp < 0xdc00) {
+			if (i + 2 > *len) {
+				if (!final) {
+					i -= 2;
+					break;
+				}
+				cp = 0xfffd;
+			} else {
+				lo = be ? (s[i] << 8 | s[i + 1]) :
+				    (s[i + 1] << 8 | s[i]);
+				if (lo >= 0xdc00 && lo < 0xe000) {
+					cp = 0x10000 + ((cp - 0xd800) << 10) +
+					    (lo - 0xdc00);
+					i += 2;
+				} else
+					cp = 0xfffd;
+			}
+		} else if (cp >= 0xdc00 && cp < 0xe000)
+			cp = 0xfffd;
+		o += put_utf8(&dst[o], cp);
+	}
+
+	if (final && i + 1 == *len && o + 3 <= size) {
+		o += put_utf8(&dst[o], 0xfffd);
+		i++;
+	}
+
+	*len = i;
+	return o;
+}
+
+/*
+ * Decode as much of src to UTF-8 as fits in dst, which must have room
+ * for at least 4 bytes. On return *len is the number of bytes of src
+ * that were decoded. Unless final is set, a character cut short at the
+ * end of src is left for the next call. Returns the number of bytes
+ * put to dst.
+ */
+size_t
+encoding_decode(int encoding, const char *src, size_t *len, char *dst,
+    size_t size, int final)
+{
+	const unsigned char *s = (const unsigned char *) src;
+
+	assert(size >= 4);
+
+	switch (encoding) {
+	case ENCODING_UTF8:
+		return decode_utf8(s, len, dst, size, final);
+	case ENCODING_UTF16LE:
+	case ENCODING_UTF16BE:
+		return decode_utf16(encoding == ENCODING_UTF16BE, s, len, dst,
+		    size, final);
+	default:
+		assert(encoding >= ENCODING_IBM866 &&
+		    encoding <= ENCODING_WINDOWS_1257);
+		return decode_single(tables[encoding - ENCODING_IBM866], s,
+		    len, dst, size);
+	}
+}
+
+#line 1171 "encoding.c"
+#undef IS_SPACE
+#undef IS_ALPHA
+#undef TO_LOWER
+#undef NON_ASCII
+#undef S_ERROR
+#undef S_ACCEPT
+#undef S_TAIL1
+#undef S_TAIL2
+#undef S_TAIL3
+#undef S_E0
+#undef S_ED
+#undef S_F0
+#undef S_F4
+#undef T
+#undef ASCII
+#undef CONT
+#undef CONT_8
+#undef CONT_9
+#undef CONT_A
+#undef LEAD2
+#undef LEAD3
+#undef LEAD4
+#undef BAD
+#undef X4
+#undef X16
+#line 1 "input.c"
+
+#line 20 "input.c"
+#line 21 "input.c"
+#line 22 "input.c"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <err.h>
+
+static void	new_input(struct input *);
+static size_t	file_read(void *, char *, size_t);
+static size_t	buf_size(struct input *);
+static void	read_more(struct input *);
+static void	sniff(struct input *);
+
+/*
+ * Forget the encoding sniffed from the previous input.
+ */
+static void
+new_input(struct input *in)
+{
+	if (in->sniffed)
+		in->encoding = ENCODING_NONE;
+	in->sniffed = 0;
+}
+
+/*
+ * Read from a buffer holding all of the input. The refill buffer, if
+ * any, is kept for later use.
+ */
+void
+input_buf(struct input *in, const char *buf, size_t len)
+{
+	new_input(in);
+	in->buf = NULL;
+	in->len = 0;
+	in->pos = 0;
+	in->read = NULL;
+	in->user = NULL;
+	in->eof = 0;
+	in->src = buf;
+	in->src_len = len;
+	in->src_pos = 0;
+	in->src_end = 1;
+}
+
+void
+input_read(struct input *in, size_t (*read)(void *, char *, size_t),
+    void *user)
+{
+	assert(read != NULL);
+
+	new_input(in);
+	in->buf = NULL;
+	in->len = 0;
+	in->pos = 0;
+	in->read = read;
+	in->user = user;
+	in->eof = 0;
+	in->src = in->refill;
+	in->src_len = 0;
+	in->src_pos = 0;
+	in->src_end = 0;
+}
+
+static size_t
+file_read(void *user, char *buf, size_t len)
+{
+	return fread(buf, 1, len, user);
+}
+
+void
+input_file(struct input *in, FILE *fp)
+{
+	assert(fp != NULL);
+
+	input_read(in, file_read, fp);
+}
+
+/*
+ * Size of the refill and decode buffers: room for the prescan, and for
+ * a character cut short by the previous read.
+ */
+static size_t
+buf_size(struct input *in)
+{
+	if (in->size == 0)
+		in->size = INPUT_SIZE;
+
+	return (in->size < ENCODING_PRESCAN ? ENCODING_PRESCAN : in->size) + 4;
+}
+
+/*
+ * Read more to src, keeping what was not decoded yet.
+ */
+static void
+read_more(struct input *in)
+{
+	size_t left, n;
+
+	assert(in->read != NULL);
+
+	if (in->refill == NULL) {
+		if ((in->refill = mem_malloc(buf_size(in))) == NULL)
+			err(1, "malloc input");
+		STATS_ADD(allocs[ALLOC_INPUT], 1);
+	}
+
+	left = in->src_len - in->src_pos;
+	if (left > 0)
+		memmove(in->refill, &in->src[in->src_pos], left);
+	n = buf_size(in) - left;
+	if (n > in->size)
+		n = in->size;
+
+	n = in->read(in->user, &in->refill[left], n);
+	in->src = in->refill;
+	in->src_len = left + n;
+	in->src_pos = 0;
+	if (n == 0)
+		in->src_end = 1;
+}
+
+/*
+ * Decide the encoding from the first ENCODING_PRESCAN bytes.
+ */
+static void
+sniff(struct input *in)
+{
+	while (in->src_len < ENCODING_PRESCAN && !in->src_end)
+		read_more(in);
+
+	in->src_pos += encoding_bom(in->src, in->src_len, &in->encoding);
+	if (in->encoding == ENCODING_NONE)
+		in->encoding = in->charset;
+	if (in->encoding == ENCODING_NONE)
+		in->encoding = encoding_sniff(&in->src[in->src_pos],
+		    in->src_len - in->src_pos, in->src_end);
+	in->sniffed = 1;
+}
+
+/*
+ * Called by INPUT_GETC() when the buffer runs out. Refills it with the
+ * next piece of input, decoded if need be, and returns the first byte,
+ * or EOF.
+ */
+int
+input_fill(struct input *in)
+{
+	size_t n;
+
+	while (!in->eof) {
+		if (in->encoding == ENCODING_NONE)
+			sniff(in);
+
+		n = in->src_len - in->src_pos;
+		if (n > 0 && in->encoding == ENCODING_UTF8 && in->validate)
+			n = encoding_utf8_valid(&in->src[in->src_pos], n);
+
+		if (n > 0 && (in->encoding == ENCODING_UTF8 ||
+		    in->encoding == ENCODING_BINARY)) {
+			in->buf = &in->src[in->src_pos];
+			in->len = n;
+			in->src_pos += n;
+		} else if (in->src_pos < in->src_len) {
+			n = in->src_len - in->src_pos;
+			if (in->decoded == NULL) {
+				in->decoded = mem_malloc(buf_size(in));
+				if (in->decoded == NULL)
+					err(1, "malloc decoded");
+				STATS_ADD(allocs[ALLOC_INPUT], 1);
+			}
+			in->len = encoding_decode(in->encoding,
+			    &in->src[in->src_pos], &n, in->decoded,
+			    buf_size(in), in->src_end);
+			in->buf = in->decoded;
+			in->src_pos += n;
+		} else
+			in->len = 0;
+
+		in->pos = 0;
+		if (in->len > 0)
+			return (unsigned char) in->buf[in->pos++];
+
+		if (in->src_end)
+			in->eof = 1;
+		else
+			read_more(in);
+	}
+
+	return EOF;
+}
+
+/*
+ * Returns the number of input bytes that were read ahead but not yet
+ * consumed, e.g. to give them back to a stream.
+ */
+size_t
+input_ahead(struct input *in)
+{
+	const unsigned char *s;
+	size_t n, i;
+
+	n = in->src_len - in->src_pos;
+	if (in->buf != in->decoded || in->encoding == ENCODING_UTF8)
+		return n + in->len - in->pos;
+
+	s = (const unsigned char *) in->buf;
+	for (i = in->pos; i < in->len; i++) {
+		if ((s[i] & 0xc0) == 0x80)
+			continue;
+		if (in->encoding == ENCODING_UTF16LE ||
+		    in->encoding == ENCODING_UTF16BE)
+			n += s[i] >= 0xf0 ? 4 : 2;
+		else
+			n++;
+	}
+
+	return n;
+}
+
+/*
+ * Decide the encoding of a buffer holding all of the input and decode
+ * it to UTF-8 at once, e.g. to split it in chunks. Returns the decoded
+ * copy to be freed by the caller, or NULL if *buf is valid UTF-8
+ * already, in which case only a byte order mark is skipped.
+ */
+char *
+input_utf8(struct input *in, const char **buf, size_t *len)
+{
+	char *utf8;
+	size_t n;
+
+	input_buf(in, *buf, *len);
+	if (in->encoding == ENCODING_NONE) {
+		sniff(in);
+		*buf += in->src_pos;
+		*len -= in->src_pos;
+	}
+	if (in->encoding == ENCODING_BINARY || (in->encoding ==
+	    ENCODING_UTF8 && (!in->validate ||
+	    encoding_utf8_valid(*buf, *len) == *len)))
+		return NULL;
+
+	/*
+	 * At most 3 bytes of UTF-8 per byte of input.
+	 */
+	if ((utf8 = mem_malloc(*len * 3 + 4)) == NULL)
+		err(1, "malloc utf8");
+	STATS_ADD(allocs[ALLOC_INPUT], 1);
+	n = *len;
+	*len = encoding_decode(in->encoding, *buf, &n, utf8, *len * 3 + 4, 1);
+	*buf = utf8;
+	in->encoding = ENCODING_UTF8;
+
+	return utf8;
+}
+
+void
+input_free(struct input *in)
+{
+	mem_free(in->refill);
+	mem_free(in->decoded);
+	in->refill = NULL;
+	in->decoded = NULL;
+	in->buf = in->src = NULL;
+	in->len = in->pos = 0;
+	in->src_len = in->src_pos = 0;
+}
+#line 1 "inflate.c"
+
+#line 20 "inflate.c"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define WINDOW_MASK (INFLATE_WINDOW - 1)
+
+enum {
+	ST_HEADER = 0,
+	ST_BLOCK,
+	ST_STORED,
+	ST_HUFF,
+	ST_TRAILER,
+	ST_DONE
+};
+
+static const unsigned short lbase[29] = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const unsigned char lext[29] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+	3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const unsigned short dbase[30] = {
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+	8193, 12289, 16385, 24577 };
+static const unsigned char dext[30] = {
+	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+	7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+static void	fail(struct inflate *, const char *);
+static int	next_byte(struct inflate *);
+static void	need(struct inflate *, int);
+static void	drop(struct inflate *, int);
+static unsigned long getbits(struct inflate *, int);
+static int	build(struct huff *, const unsigned char *, int);
+static int	decode(struct inflate *, struct huff *);
+static void	put(struct inflate *, unsigned char);
+static void	header(struct inflate *);
+static void	block(struct inflate *);
+static void	fixed(struct inflate *);
+static void	dynamic(struct inflate *);
+static void	match(struct inflate *, int);
+static void	trailer(struct inflate *);
+
+void
+inflate_init(struct inflate *z, size_t (*read)(void *, char *, size_t),
+    void *user)
+{
+	unsigned long c;
+	int i, k;
+
+	assert(read != NULL);
+
+	memset(z, 0, sizeof(struct inflate));
+	z->read = read;
+	z->user = user;
+
+	for (i = 0; i < 256; i++) {
+		c = i;
+		for (k = 0; k < 8; k++)
+			c = (c & 1) ? 0xedb88320UL ^ (c >> 1) : c >> 1;
+		z->crc_table[i] = c;
+	}
+}
+
+/*
+ * Fill buf with up to len decompressed bytes. Returns 0 at the end of
+ * the data or on an error, which is then set in z->error.
+ */
+size_t
+inflate_read(void *user, char *buf, size_t len)
+{
+	struct inflate *z = user;
+	unsigned char c;
+	size_t n;
+	int sym;
+
+	n = 0;
+	while (n < len) {
+		if (z->copy > 0) {
+			for (; z->copy > 0 && n < len; z->copy--) {
+				c = z->window[(z->total - z->dist) &
+				    WINDOW_MASK];
+				put(z, c);
+				buf[n++] = c;
+			}
+			continue;
+		}
+
+		switch (z->state) {
+		case ST_HEADER:
+			header(z);
+			break;
+		case ST_BLOCK:
+			block(z);
+			break;
+		case ST_STORED:
+			if (z->stored == 0) {
+				z->state = ST_BLOCK;
+				break;
+			}
+			c = getbits(z, 8);
+			put(z, c);
+			buf[n++] = c;
+			z->stored--;
+			break;
+		case ST_HUFF:
+			/*
+			 * Literals are the common case, so stay here.
+			 */
+			while (n < len && z->state == ST_HUFF) {
+				sym = decode(z, &z->lens);
+				if (sym < 256 && sym >= 0) {
+					put(z, sym);
+					buf[n++] = sym;
+				} else if (sym == 256)
+					z->state = ST_BLOCK;
+				else if (sym > 256) {
+					match(z, sym);
+					break;
+				}
+			}
+			break;
+		case ST_TRAILER:
+			trailer(z);
+			break;
+		case ST_DONE:
+			return n;
+		}
+	}
+
+	return n;
+}
+
+static void
+fail(struct inflate *z, const char *error)
+{
+	if (z->error == NULL)
+		z->error = error;
+	z->state = ST_DONE;
+	z->copy = 0;
+}
+
+static int
+next_byte(struct inflate *z)
+{
+	size_t n;
+
+	if (z->in_pos == z->in_len) {
+		if (z->in_eof)
+			return EOF;
+		n = z->read(z->user, (char *) z->in, sizeof(z->in));
+		if (n == 0) {
+			z->in_eof = 1;
+			return EOF;
+		}
+		z->in_len = n;
+		z->in_pos = 0;
+	}
+
+	return z->in[z->in_pos++];
+}
+
+/*
+ * Have at least n <= 24 bits in the bit buffer. Past the end of the
+ * input, pad with zero bits, which are an error only if consumed.
+ */
+static void
+need(struct inflate *z, int n)
+{
+	int c;
+
+	while (z->nbits < n) {
+		if ((c = next_byte(z)) == EOF) {
+			c = 0;
+			z->pad += 8;
+		}
+		z->bits |= (unsigned long) c << z->nbits;
+		z->nbits += 8;
+	}
+}
+
+static void
+drop(struct inflate *z, int n)
+{
+	z->bits >>= n;
+	z->nbits -= n;
+	if (z->nbits < z->pad) {
+		z->pad = z->nbits;
+		fail(z, "unexpected end of data");
+	}
+}
+
+static unsigned long
+getbits(struct inflate *z, int n)
+{
+	unsigned long v;
+
+	need(z, n);
+	v = z->bits & ((1UL << n) - 1);
+	drop(z, n);
+	return v;
+}
+
+static void
+put(struct inflate *z, unsigned char c)
+{
+	z->window[z->total++ & WINDOW_MASK] = c;
+	z->size++;
+
+	if (z->format == INFLATE_GZIP)
+		z->check = z->crc_table[(z->check ^ c) & 0xff] ^
+		    (z->check >> 8);
+	else if (z->format == INFLATE_ZLIB) {
+		/*
+		 * Adler-32, low half a and high half b.
+		 */
+		unsigned long a = z->check & 0xffff, b = z->check >> 16;
+
+		if ((a += c) >= 65521)
+			a -= 65521;
+		if ((b += a) >= 65521)
+			b -= 65521;
+		z->check = (b << 16) | a;
+	}
+}
+
+/*
+ * Make the canonical Huffman code of the given code lengths. Returns
+ * a negative value if over-subscribed, positive if incomplete.
+ */
+static int
+build(struct huff *h, const unsigned char *lengths, int n)
+{
+	unsigned short offs[16];
+	unsigned int code, rev, k;
+	int len, sym, left, i, index;
+
+	memset(h->count, 0, sizeof(h->count));
+	for (sym = 0; sym < n; sym++)
+		h->count[lengths[sym]]++;
+	if (h->count[0] == n) {
+		memset(h->fast, 0, sizeof(h->fast));
+		return 0;
+	}
+
+	left = 1;
+	for (len = 1; len < 16; len++) {
+		left <<= 1;
+		left -= h->count[len];
+		if (left < 0)
+			return left;
+	}
+
+	offs[1] = 0;
+	for (len = 1; len < 15; len++)
+		offs[len + 1] = offs[len] + h->count[len];
+	for (sym = 0; sym < n; sym++)
+		if (lengths[sym] != 0)
+			h->symbol[offs[lengths[sym]]++] = sym;
+
+	/*
+	 * Codes short enough are looked up directly with the next
+	 * INFLATE_FAST bits. The bits come least significant first, so
+	 * the codes are reversed.
+	 */
+	memset(h->fast, 0, sizeof(h->fast));
+	code = 0;
+	index = 0;
+	for (len = 1; len <= INFLATE_FAST; len++) {
+		for (i = 0; i < h->count[len]; i++) {
+			rev = 0;
+			for (k = 0; k < (unsigned int) len; k++)
+				rev |= ((code >> k) & 1) << (len - 1 - k);
+			for (k = rev; k < (1U << INFLATE_FAST); k += 1U << len)
+				h->fast[k] = (h->symbol[index] << 4) | len;
+			index++;
+			code++;
+		}
+		code <<= 1;
+	}
+
+	return left;
+}
+
+static int
+decode(struct inflate *z, struct huff *h)
+{
+	int code, first, count, index, len, e;
+
+	need(z, INFLATE_FAST);
+	e = h->fast[z->bits & ((1 << INFLATE_FAST) - 1)];
+	if (e != 0) {
+		drop(z, e & 15);
+		return e >> 4;
+	}
+
+	need(z, 15);
+	code = first = index = 0;
+	for (len = 1; len < 16; len++) {
+		code |= (z->bits >> (len - 1)) & 1;
+		count = h->count[len];
+		if (code - count < first) {
+			drop(z, len);
+			return h->symbol[index + (code - first)];
+		}
+		index += count;
+		first += count;
+		first <<= 1;
+		code <<= 1;
+	}
+
+	fail(z, "invalid code");
+	return -1;
+}
+
+static void
+header(struct inflate *z)
+{
+	unsigned long b0, b1, flags, n;
+
+	if (z->format == INFLATE_RAW) {
+		z->state = ST_BLOCK;
+		return;
+	}
+
+	b0 = getbits(z, 8);
+	b1 = getbits(z, 8);
+	if (z->format == INFLATE_GZIP &&
+	    (z->error != NULL || b0 != 0x1f || b1 != 0x8b)) {
+		/*
+		 * Something else than a member after the last one.
+		 */
+		z->error = NULL;
+		z->state = ST_DONE;
+		return;
+	}
+	if (z->error != NULL)
+		return;
+
+	if (b0 == 0x1f && b1 == 0x8b) {
+		if (getbits(z, 8) != 8) {
+			fail(z, "unknown compression method");
+			return;
+		}
+		flags = getbits(z, 8);
+		for (n = 0; n < 6; n++)		/* mtime, xfl, os */
+			getbits(z, 8);
+		if (flags & 4)
+			for (n = getbits(z, 16); n > 0 && !z->error; n--)
+				getbits(z, 8);
+		if (flags & 8)
+			while (getbits(z, 8) != 0 && !z->error)
+				;
+		if (flags & 16)
+			while (getbits(z, 8) != 0 && !z->error)
+				;
+		if (flags & 2)
+			getbits(z, 16);
+		z->format = INFLATE_GZIP;
+		z->check = 0xffffffffUL;
+	} else if ((b0 & 0x0f) == 8 && ((b0 << 8) | b1) % 31 == 0) {
+		if (b1 & 0x20) {
+			fail(z, "preset dictionary");
+			return;
+		}
+		z->format = INFLATE_ZLIB;
+		z->check = 1;
+	} else {
+		z->bits = (z->bits << 16) | (b1 << 8) | b0;
+		z->nbits += 16;
+		z->format = INFLATE_RAW;
+	}
+
+	z->last = 0;
+	z->size = 0;
+	if (z->error == NULL)
+		z->state = ST_BLOCK;
+}
+
+static void
+block(struct inflate *z)
+{
+	unsigned long len;
+
+	if (z->last) {
+		z->state = ST_TRAILER;
+		return;
+	}
+
+	z->last = getbits(z, 1);
+	switch (getbits(z, 2)) {
+	case 0:
+		drop(z, z->nbits % 8);
+		len = getbits(z, 16);
+		if ((getbits(z, 16) ^ 0xffff) != len) {
+			fail(z, "bad stored block length");
+			return;
+		}
+		z->stored = len;
+		z->state = ST_STORED;
+		break;
+	case 1:
+		fixed(z);
+		break;
+	case 2:
+		dynamic(z);
+		break;
+	default:
+		fail(z, "bad block type");
+		break;
+	}
+}
+
+static void
+fixed(struct inflate *z)
+{
+	unsigned char lengths[288];
+	int i;
+
+	for (i = 0; i < 144; i++)
+		lengths[i] = 8;
+	for (; i < 256; i++)
+		lengths[i] = 9;
+	for (; i < 280; i++)
+		lengths[i] = 7;
+	for (; i < 288; i++)
+		lengths[i] = 8;
+	build(&z->lens, lengths, 288);
+
+	for (i = 0; i < 30; i++)
+		lengths[i] = 5;
+	build(&z->dists, lengths, 30);
+
+	z->state = ST_HUFF;
+}
+
+static void
+dynamic(struct inflate *z)
+{
+	static const unsigned char order[19] = {
+	    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+	unsigned char lengths[320];
+	int nlen, ndist, ncode, i, sym, len, rep, err;
+
+	nlen = getbits(z, 5) + 257;
+	ndist = getbits(z, 5) + 1;
+	ncode = getbits(z, 4) + 4;
+	if (nlen > 286 || ndist > 30) {
+		fail(z, "bad counts");
+		return;
+	}
+
+	memset(lengths, 0, sizeof(lengths));
+	for (i = 0; i < ncode; i++)
+		lengths[order[i]] = getbits(z, 3);
+	if (build(&z->lens, lengths, 19) != 0) {
+		fail(z, "bad code lengths code");
+		return;
+	}
+
+	for (i = 0; i < nlen + ndist && z->error == NULL; ) {
+		sym = decode(z, &z->lens);
+		if (sym < 0)
+			return;
+		if (sym < 16) {
+			lengths[i++] = sym;
+			continue;
+		}
+
+		len = 0;
+		if (sym == 16) {
+			if (i == 0) {
+				fail(z, "repeat with no first length");
+				return;
+			}
+			len = lengths[i - 1];
+			rep = 3 + getbits(z, 2);
+		} else if (sym == 17)
+			rep = 3 + getbits(z, 3);
+		else
+			rep = 11 + getbits(z, 7);
+		if (i + rep > nlen + ndist) {
+			fail(z, "too many lengths");
+			return;
+		}
+		while (rep-- > 0)
+			lengths[i++] = len;
+	}
+	if (z->error != NULL)
+		return;
+
+	if (lengths[256] == 0) {
+		fail(z, "no end-of-block code");
+		return;
+	}
+
+	/*
+	 * Incomplete codes are fine only if they have a single code.
+	 */
+	err = build(&z->lens, lengths, nlen);
+	if (err < 0 || (err > 0 && nlen - z->lens.count[0] != 1)) {
+		fail(z, "bad literal/length code");
+		return;
+	}
+	err = build(&z->dists, &lengths[nlen], ndist);
+	if (err < 0 || (err > 0 && ndist - z->dists.count[0] != 1)) {
+		fail(z, "bad distance code");
+		return;
+	}
+
+	z->state = ST_HUFF;
+}
+
+static void
+match(struct inflate *z, int sym)
+{
+	size_t len, dist;
+
+	sym -= 257;
+	if (sym >= 29) {
+		fail(z, "bad length symbol");
+		return;
+	}
+	len = lbase[sym] + getbits(z, lext[sym]);
+
+	sym = decode(z, &z->dists);
+	if (sym < 0)
+		return;
+	if (sym >= 30) {
+		fail(z, "bad distance symbol");
+		return;
+	}
+	dist = dbase[sym] + getbits(z, dext[sym]);
+	if (dist > z->total) {
+		fail(z, "distance too far back");
+		return;
+	}
+
+	if (z->error == NULL) {
+		z->copy = len;
+		z->dist = dist;
+	}
+}
+
+static void
+trailer(struct inflate *z)
+{
+	unsigned long check, size;
+	int c;
+
+	drop(z, z->nbits % 8);
+
+	switch (z->format) {
+	case INFLATE_GZIP:
+		check = getbits(z, 16);
+		check |= getbits(z, 16) << 16;
+		size = getbits(z, 16);
+		size |= getbits(z, 16) << 16;
+		if (z->error != NULL)
+			return;
+		if (check != (~z->check & 0xffffffffUL) ||
+		    size != (z->size & 0xffffffffUL)) {
+			fail(z, "bad gzip trailer");
+			return;
+		}
+
+		/*
+		 * Another member may follow.
+		 */
+		if (z->nbits - z->pad < 8) {
+			z->bits = 0;
+			z->nbits = z->pad = 0;
+			if ((c = next_byte(z)) == EOF) {
+				z->state = ST_DONE;
+				return;
+			}
+			z->bits = c;
+			z->nbits = 8;
+		}
+		z->state = ST_HEADER;
+		return;
+	case INFLATE_ZLIB:
+		check = getbits(z, 8) << 24;
+		check |= getbits(z, 8) << 16;
+		check |= getbits(z, 8) << 8;
+		check |= getbits(z, 8);
+		if (z->error == NULL && check != z->check) {
+			fail(z, "bad zlib checksum");
+			return;
+		}
+		break;
+	default:
+		break;
+	}
+
+	z->state = ST_DONE;
+}
+
+#line 850 "inflate.c"
+#undef WINDOW_MASK
+#line 1 "warc.c"
+
+#line 20 "warc.c"
+#line 21 "warc.c"
+#line 22 "warc.c"
+
+#include <assert.h>
+#include <ctype.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <err.h>
+
+/*
+ * A block is read in pieces growing from this size up to its
+ * Content-Length, which is not trusted to allocate at once.
+ */
+#define WARC_BLOCK	65536
+
+struct mem {
+	const char	*p;
+	size_t		 len;
+};
+
+static int		 read_line(struct warc *);
+static size_t		 read_block(struct warc *, struct warc_record *, size_t);
+static const char	*value(const char *, const char *);
+static char		*dup_value(const char *);
+static void		 http(struct warc *, struct warc_record *);
+static void		 dechunk(struct warc_record *);
+static void		 decode_record(struct warc *, struct warc_record *);
+static size_t		 mem_read(void *, char *, size_t);
+
+void
+warc_init(struct warc *w, size_t (*read)(void *, char *, size_t),
+    void *user)
+{
+	memset(w, 0, sizeof(struct warc));
+	w->in.encoding = ENCODING_BINARY;
+	input_read(&w->in, read, user);
+}
+
+void
+warc_free(struct warc *w)
+{
+	input_free(&w->in);
+	mem_free(w->line.s);
+	mem_free(w->inflate);
+	memset(w, 0, sizeof(struct warc));
+}
+
+void
+warc_record_free(struct warc_record *rec)
+{
+	mem_free(rec->type);
+	mem_free(rec->uri);
+	mem_free(rec->content_type);
+	mem_free(rec->block);
+	mem_free(rec->decoded);
+	memset(rec, 0, sizeof(struct warc_record));
+}
+
+/*
+ * Read the next record. Returns 0 at the end of the file or if the
+ * file is bad, which is then set in w->error.
+ */
+int
+warc_next(struct warc *w, struct warc_record *rec)
+{
+	const char *v;
+	char *end;
+	size_t len;
+	int has_len;
+
+	memset(rec, 0, sizeof(struct warc_record));
+
+	/*
+	 * Records are separated by empty lines.
+	 */
+	do {
+		if (!read_line(w))
+			return 0;
+	} while (w->line.len == 0);
+
+	if (strncmp(w->line.s, "WARC/", 5) != 0) {
+		w->error = "not a WARC record";
+		return 0;
+	}
+
+	len = 0;
+	has_len = 0;
+	while (read_line(w) && w->line.len > 0) {
+		if ((v = value(w->line.s, "Content-Length")) != NULL) {
+			errno = 0;
+			len = strtoul(v, &end, 10);
+			has_len = (isdigit((unsigned char) *v) && errno == 0 &&
+			    len < SIZE_MAX) ? 1 : -1;
+		} else if ((v = value(w->line.s, "WARC-Type")) != NULL)
+			rec->type = dup_value(v);
+		else if ((v = value(w->line.s, "WARC-Target-URI")) != NULL) {
+			rec->uri = dup_value(v);
+			if (*rec->uri == '<' &&
+			    rec->uri[strlen(rec->uri) - 1] == '>') {
+				rec->uri[strlen(rec->uri) - 1] = '\0';
+				memmove(rec->uri, &rec->uri[1],
+				    strlen(rec->uri));
+			}
+		}
+	}
+
+	if (has_len != 1) {
+		w->error = has_len == 0 ? "no Content-Length" :
+		    "bad Content-Length";
+		warc_record_free(rec);
+		return 0;
+	}
+
+	if (read_block(w, rec, len) != len) {
+		w->error = "truncated record";
+		warc_record_free(rec);
+		return 0;
+	}
+	rec->block[len] = '\0';
+	rec->block_len = len;
+	rec->payload = rec->block;
+	rec->payload_len = len;
+
+	if (rec->type != NULL && strcmp(rec->type, "response") == 0 &&
+	    strncmp(rec->block, "HTTP/", 5) == 0)
+		http(w, rec);
+
+	return 1;
+}
+
+/*
+ * Whether the record is a response with an HTML payload.
+ */
+int
+warc_is_html(struct warc_record *rec)
+{
+	if (rec->status == 0 || rec->content_type == NULL)
+		return 0;
+
+	return strncasecmp(rec->content_type, "text/html", 9) == 0 ||
+	    strncasecmp(rec->content_type, "application/xhtml+xml", 21) == 0;
+}
+
+/*
+ * Read a line without the line ending into w->line. Returns 0 at the
+ * end of the file.
+ */
+static int
+read_line(struct warc *w)
+{
+	int c;
+
+	str_add(&w->line, '\0');
+	while ((c = INPUT_GETC(&w->in)) != EOF && c != '\n')
+		if (c != '\r')
+			str_add(&w->line, c);
+
+	return c != EOF || w->line.len > 0;
+}
+
+/*
+ * Read a block of len bytes to rec->block, growing it as the bytes
+ * come. Returns the number of bytes read.
+ */
+static size_t
+read_block(struct warc *w, struct warc_record *rec, size_t len)
+{
+	struct input *in = &w->in;
+	size_t n, done, alloc;
+	int c;
+
+	done = 0;
+	alloc = len < WARC_BLOCK ? len : WARC_BLOCK;
+	if ((rec->block = mem_malloc(alloc + 1)) == NULL)
+		err(1, "malloc record");
+	while (done < len) {
+		if (done == alloc) {
+			alloc = alloc > len / 2 ? len : alloc * 2;
+			rec->block = mem_realloc(rec->block, alloc + 1);
+			if (rec->block == NULL)
+				err(1, "realloc record");
+		}
+		if ((n = in->len - in->pos) == 0) {
+			if ((c = input_fill(in)) == EOF)
+				break;
+			rec->block[done++] = c;
+			continue;
+		}
+		if (n > alloc - done)
+			n = alloc - done;
+		memcpy(&rec->block[done], &in->buf[in->pos], n);
+		in->pos += n;
+		done += n;
+	}
+
+	return done;
+}
+
+/*
+ * Returns the value if the header line has the given name.
+ */
+static const char *
+value(const char *line, const char *name)
+{
+	size_t len;
+
+	len = strlen(name);
+	if (strncasecmp(line, name, len) != 0 || line[len] != ':')
+		return NULL;
+
+	line += len + 1;
+	while (*line == ' ' || *line == '\t')
+		line++;
+	return line;
+}
+
+static char *
+dup_value(const char *v)
+{
+	char *s;
+
+	if ((s = mem_strdup(v)) == NULL)
+		err(1, "strdup");
+	return s;
+}
+
+/*
+ * Skip the status line and the headers of an HTTP response.
+ */
+static void
+http(struct warc *w, struct warc_record *rec)
+{
+	char *line, *next, *end;
+	const char *v;
+	int chunked, encoded;
+
+	end = &rec->block[rec->block_len];
+	if ((line = strchr(rec->block, ' ')) != NULL)
+		rec->status = atoi(line + 1);
+
+	chunked = encoded = 0;
+	line = rec->block;
+	for (;;) {
+		if ((next = memchr(line, '\n', end - line)) == NULL) {
+			/*
+			 * Headers only.
+			 */
+			rec->payload = end;
+			rec->payload_len = 0;
+			return;
+		}
+		*next++ = '\0';
+		if (next - line >= 2 && next[-2] == '\r')
+			next[-2] = '\0';
+
+		if (*line == '\0')
+			break;
+
+		if ((v = value(line, "Content-Type")) != NULL) {
+			mem_free(rec->content_type);
+			rec->content_type = dup_value(v);
+		} else if ((v = value(line, "Transfer-Encoding")) != NULL)
+			chunked = (strncasecmp(v, "chunked", 7) == 0);
+		else if ((v = value(line, "Content-Encoding")) != NULL)
+			encoded = (strncasecmp(v, "gzip", 4) == 0 ||
+			    strncasecmp(v, "x-gzip", 6) == 0 ||
+			    strncasecmp(v, "deflate", 7) == 0);
+		line = next;
+	}
+
+	rec->payload = next;
+	rec->payload_len = end - next;
+
+	if (chunked)
+		dechunk(rec);
+	if (encoded)
+		decode_record(w, rec);
+}
+
+/*
+ * Remove chunked transfer coding in place.
+ */
+static void
+dechunk(struct warc_record *rec)
+{
+	char *src, *dst, *end, *p;
+	size_t size;
+
+	src = dst = rec->payload;
+	end = &rec->payload[rec->payload_len];
+	while (src < end) {
+		size = strtoul(src, &p, 16);
+		if (p == src)
+			break;
+		if ((src = memchr(p, '\n', end - p)) == NULL)
+			break;
+		src++;
+		if (size == 0)
+			break;
+		if (size > (size_t) (end - src))
+			size = end - src;
+		memmove(dst, src, size);
+		dst += size;
+		src += size;
+		if (src < end && *src == '\r')
+			src++;
+		if (src < end && *src == '\n')
+			src++;
+	}
+
+	rec->payload_len = dst - rec->payload;
+	*dst = '\0';
+}
+
+static size_t
+mem_read(void *user, char *buf, size_t len)
+{
+	struct mem *mem = user;
+
+	if (len > mem->len)
+		len = mem->len;
+	memcpy(buf, mem->p, len);
+	mem->p += len;
+	mem->len -= len;
+	return len;
+}
+
+/*
+ * Decompress gzip or deflate content coding. On bad data, what could
+ * be decompressed is kept.
+ */
+static void
+decode_record(struct warc *w, struct warc_record *rec)
+{
+	struct mem mem;
+	size_t len, alloc, n;
+	char *buf;
+
+	if (w->inflate == NULL &&
+	    (w->inflate = mem_malloc(sizeof(struct inflate))) == NULL)
+		err(1, "malloc inflate");
+
+	mem.p = rec->payload;
+	mem.len = rec->payload_len;
+	inflate_init(w->inflate, mem_read, &mem);
+
+	buf = NULL;
+	len = 0;
+	alloc = rec->payload_len * 4 + 1;
+	do {
+		if (len + 1 >= alloc || buf == NULL) {
+			alloc = buf ? alloc * 2 : alloc;
+			if ((buf = mem_realloc(buf, alloc)) == NULL)
+				err(1, "realloc payload");
+		}
+		n = inflate_read(w->inflate, &buf[len], alloc - len - 1);
+		len += n;
+	} while (n > 0);
+	buf[len] = '\0';
+
+	rec->decoded = buf;
+	rec->payload = buf;
+	rec->payload_len = len;
+}
+
+#line 516 "warc.c"
+#undef WARC_BLOCK
+#line 1 "tokenlog.c"
+
+#line 20 "tokenlog.c"
+#line 21 "tokenlog.c"
+#line 22 "tokenlog.c"
+#line 23 "tokenlog.c"
+#line 24 "tokenlog.c"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <err.h>
+
+/*
+ * The log starts with TOKENLOG_MAGIC, then for each token:
+ *
+ *	type		byte, TOKEN_*
+ *	end_line	varint, zigzag coded change from the previous token
+ *	end_offset	varint, likewise
+ *	text		varint length and the bytes of token->s
+ *
+ * for start and end tags:
+ *
+ *	tagid		varint
+ *	name		string, empty if the name of the tag id
+ *	self closing	byte
+ *	attributes	varint count, then a name and a value string each
+ *
+ * and last:
+ *
+ *	state		varint, the one dispatch() returned
+ *
+ * Runs of character tokens of one byte that follow each other in the
+ * input and switch no state, which are most tokens, are written as:
+ *
+ *	TOKENLOG_RUN	byte
+ *	count		varint
+ *	bytes		one per token
+ *
+ * Varints are little endian base 128. Strings are a varint of one more
+ * than the length, or 0 for none, then the bytes.
+ */
+
+static void	 put_token(struct tokenlog *, struct token *);
+static void	 put_run(struct tokenlog *);
+static void	 put_uint(struct tokenlog *, size_t);
+static void	 put_delta(struct tokenlog *, size_t, size_t);
+static void	 put_string(struct tokenlog *, const char *);
+static int	 get_byte(struct tokenlog *);
+static size_t	 get_uint(struct tokenlog *);
+static size_t	 get_delta(struct tokenlog *, size_t);
+static char	*get_string(struct tokenlog *);
+
+void
+tokenlog_record(struct tokenlog *log, FILE *out)
+{
+	memset(log, 0, sizeof(struct tokenlog));
+	log->out = out;
+	fputs(TOKENLOG_MAGIC, out);
+}
+
+/*
+ * Before dispatch(), which may take over the name and attributes.
+ */
+void
+tokenlog_put(struct tokenlog *log, struct token *token)
+{
+	char c;
+
+	assert(log->out != NULL);
+
+	if (TOKEN_IS_CHAR(token) && token->s.len == 1) {
+		c = token->s.s[0];
+		if (token->end_offset == log->offset + 1 &&
+		    token->end_line == log->line + (c == '\n')) {
+			str_add(&log->run, c);
+			log->line = token->end_line;
+			log->offset = token->end_offset;
+			log->tokens++;
+			return;
+		}
+	}
+
+	put_run(log);
+	put_token(log, token);
+	log->tokens++;
+}
+
+/*
+ * After dispatch() of the token put last.
+ */
+void
+tokenlog_put_state(struct tokenlog *log, int state)
+{
+	struct token token;
+	char c[2];
+
+	if (log->run.len > 0 && state != STATE_NONE) {
+		/*
+		 * The last character of the run goes on its own.
+		 */
+		memset(&token, 0, sizeof(struct token));
+		token.type = TOKEN_CHAR;
+		token.end_line = log->line;
+		token.end_offset = log->offset;
+		c[0] = log->run.s[--log->run.len];
+		c[1] = '\0';
+		log->run.s[log->run.len] = '\0';
+		token.s.s = c;
+		token.s.len = 1;
+		log->line -= (c[0] == '\n');
+		log->offset--;
+		put_run(log);
+		put_token(log, &token);
+	}
+	if (log->run.len == 0)
+		put_uint(log, state);
+	if (ferror(log->out))
+		log->error = "cannot write token log";
+}
+
+static void
+put_token(struct tokenlog *log, struct token *token)
+{
+	struct attr *attr;
+	size_t n;
+
+	putc(token->type, log->out);
+	put_delta(log, log->line, token->end_line);
+	put_delta(log, log->offset, token->end_offset);
+	log->line = token->end_line;
+	log->offset = token->end_offset;
+	put_uint(log, token->s.len);
+	if (token->s.len > 0)
+		fwrite(token->s.s, 1, token->s.len, log->out);
+
+	if (TOKEN_IS_START_END(token)) {
+		put_uint(log, token->u.tag.tagid);
+		if (token->u.tag.name == tagmap(token->u.tag.tagid)->name)
+			put_string(log, NULL);
+		else
+			put_string(log, token->u.tag.name);
+		putc(token->u.tag.is_self_closing, log->out);
+
+		for (n = 0, attr = token->u.tag.attr; attr != NULL;
+		    attr = attr->next)
+			n++;
+		put_uint(log, n);
+		for (attr = token->u.tag.attr; attr != NULL; attr = attr->next) {
+			put_string(log, attr->name);
+			put_string(log, attr->value);
+		}
+	}
+}
+
+static void
+put_run(struct tokenlog *log)
+{
+	if (log->run.len == 0)
+		return;
+
+	putc(TOKENLOG_RUN, log->out);
+	put_uint(log, log->run.len);
+	fwrite(log->run.s, 1, log->run.len, log->out);
+	str_add(&log->run, '\0');
+}
+
+void
+tokenlog_init(struct tokenlog *log, size_t (*read)(void *, char *, size_t),
+    void *user)
+{
+	memset(log, 0, sizeof(struct tokenlog));
+	log->in.encoding = ENCODING_BINARY;
+	input_read(&log->in, read, user);
+}
+
+/*
+ * Returns the next token and sets the state it was followed by, or
+ * returns NULL at the end of the log or if it is bad, see log->error.
+ * The token is the caller's to give to dispatch() but stays the log's.
+ */
+struct token *
+tokenlog_get(struct tokenlog *log, int *state)
+{
+	struct token *token;
+	struct attr **tail;
+	const char *p;
+	size_t n, tagid;
+	int c;
+
+	token = &log->token;
+	token_clear(token);
+	if (log->error != NULL)
+		return NULL;
+
+	if (!log->started) {
+		for (p = TOKENLOG_MAGIC; *p != '\0'; p++)
+			if (INPUT_GETC(&log->in) != (unsigned char) *p) {
+				log->error = "not a token log";
+				return NULL;
+			}
+		log->started = 1;
+	}
+
+	if (log->run_left == 0) {
+		if ((c = INPUT_GETC(&log->in)) == EOF)
+			return NULL;
+		if (c == TOKENLOG_RUN &&
+		    (log->run_left = get_uint(log)) == 0 && log->error == NULL)
+			log->error = "empty run in token log";
+	}
+	if (log->run_left > 0) {
+		log->run_left--;
+		if ((c = get_byte(log)) == EOF)
+			return NULL;
+		token->type = TOKEN_CHAR;
+		token->end_line = log->line += (c == '\n');
+		token->end_offset = ++log->offset;
+		str_add(&token->s, '\0');
+		str_add(&token->s, c);
+		*state = STATE_NONE;
+		log->tokens++;
+		return token;
+	}
+	if (log->error != NULL)
+		return NULL;
+	if (c < TOKEN_CHAR || c > TOKEN_COMMENT) {
+		log->error = "bad token type in token log";
+		return NULL;
+	}
+
+	token->type = c;
+	token->end_line = log->line = get_delta(log, log->line);
+	token->end_offset = log->offset = get_delta(log, log->offset);
+	str_add(&token->s, '\0');
+	for (n = get_uint(log); n > 0 && log->error == NULL; n--)
+		if ((c = get_byte(log)) != EOF)
+			str_add(&token->s, c);
+
+	if (TOKEN_IS_START_END(token)) {
+		if ((tagid = get_uint(log)) >= TAGMAP_SZ) {
+			log->error = "bad tag id in token log";
+			tagid = 0;
+		}
+		token->u.tag.tagid = tagid;
+		if ((token->u.tag.name = get_string(log)) == NULL &&
+		    (token->u.tag.name = tagmap(tagid)->name) == NULL)
+			log->error = "tag without name in token log";
+		token->u.tag.is_self_closing = get_byte(log) == 1;
+
+		tail = &token->u.tag.attr;
+		for (n = get_uint(log); n > 0 && log->error == NULL; n--) {
+			if ((*tail = mem_calloc(1, sizeof(struct attr))) == NULL)
+				err(1, "calloc attr");
+			STATS_ADD(allocs[ALLOC_ATTR], 1);
+			(*tail)->name = get_string(log);
+			(*tail)->value = get_string(log);
+			if ((*tail)->name == NULL)
+				log->error = "attribute without name in token log";
+			tail = &(*tail)->next;
+		}
+	}
+
+	if ((*state = get_uint(log)) >= NSTATES)
+		log->error = "bad state in token log";
+
+	if (log->error != NULL) {
+		token_clear(token);
+		return NULL;
+	}
+	log->tokens++;
+	return token;
+}
+
+void
+tokenlog_free(struct tokenlog *log)
+{
+	if (log->out != NULL)
+		put_run(log);
+	mem_free(log->run.s);
+	token_clear(&log->token);
+	mem_free(log->token.s.s);
+	input_free(&log->in);
+	memset(log, 0, sizeof(struct tokenlog));
+}
+
+static void
+put_uint(struct tokenlog *log, size_t n)
+{
+	while (n >= 0x80) {
+		putc((n & 0x7f) | 0x80, log->out);
+		n >>= 7;
+	}
+	putc(n, log->out);
+}
+
+static void
+put_delta(struct tokenlog *log, size_t from, size_t to)
+{
+	if (to >= from)
+		put_uint(log, (to - from) << 1);
+	else
+		put_uint(log, ((from - to) << 1) - 1);
+}
+
+static void
+put_string(struct tokenlog *log, const char *s)
+{
+	size_t len;
+
+	if (s == NULL) {
+		put_uint(log, 0);
+		return;
+	}
+	len = strlen(s);
+	put_uint(log, len + 1);
+	fwrite(s, 1, len, log->out);
+}
+
+static int
+get_byte(struct tokenlog *log)
+{
+	int c;
+
+	if ((c = INPUT_GETC(&log->in)) == EOF && log->error == NULL)
+		log->error = "truncated token log";
+	return c;
+}
+
+static size_t
+get_uint(struct tokenlog *log)
+{
+	size_t n;
+	int c, shift;
+
+	n = 0;
+	for (shift = 0; shift < 64; shift += 7) {
+		if ((c = get_byte(log)) == EOF)
+			return 0;
+		n |= (size_t) (c & 0x7f) << shift;
+		if (!(c & 0x80))
+			return n;
+	}
+	log->error = "bad varint in token log";
+	return 0;
+}
+
+static size_t
+get_delta(struct tokenlog *log, size_t from)
+{
+	size_t n;
+
+	n = get_uint(log);
+	if (n & 1)
+		return from - (n + 1) / 2;
+	return from + n / 2;
+}
+
+/*
+ * Allocated, or NULL for none.
+ */
+static char *
+get_string(struct tokenlog *log)
+{
+	size_t len, i;
+	char *s;
+	int c;
+
+	if ((len = get_uint(log)) == 0)
+		return NULL;
+	len--;
+	if ((s = mem_malloc(len + 1)) == NULL)
+		err(1, "malloc token log string");
+	STATS_ADD(allocs[ALLOC_TOKEN], 1);
+	for (i = 0; i < len; i++) {
+		if ((c = get_byte(log)) == EOF)
+			break;
+		s[i] = c;
+	}
+	s[i] = '\0';
+	return s;
+}
+
+#line 526 "tokenlog.c"
+#line 1 "purehtml.c"
+
+#line 20 "purehtml.c"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static double
+elapsed(const struct timespec *t0, const struct timespec *t1)
+{
+	return (t1->tv_sec - t0->tv_sec) + (t1->tv_nsec - t0->tv_nsec) / 1e9;
+}
+
+static double
+clock_cost(void)
+{
+	struct timespec t0, t1;
+	int i;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (i = 0; i < 1000; i++)
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+	return elapsed(&t0, &t1) / 1000;
+}
+
+/*
+ * token_clear() that gives the attributes of a tag token back to the
+ * pool if the dispatcher did not take them.
+ */
+static void
+clear_token(struct purehtml *ctx, struct token *token)
+{
+	if (!token->used && TOKEN_IS_START_END(token)) {
+		attr_pool_put(&ctx->attr_pool, token->u.tag.attr);
+		token->u.tag.attr = NULL;
+	}
+	token_clear(token);
+}
+
+static void
+loop(struct purehtml *ctx, int (*begin)(struct node *),
+    int (*end)(struct node *))
+{
+	struct token *token;
+	int state;
+
+	while (!INPUT_EOF(&ctx->tokenizer.input) && !ctx->dispatcher.stop) {
+		ctx->tokenizer.no_attrs = (ctx->dispatcher.skip != NULL);
+		token = tokenize(&ctx->tokenizer);
+		if (token != NULL) {
+			if (ctx->record != NULL)
+				tokenlog_put(ctx->record, token);
+			state = dispatch(&ctx->dispatcher, token, begin, end);
+			if (ctx->record != NULL)
+				tokenlog_put_state(ctx->record, state);
+			if (state != STATE_NONE)
+				ctx->tokenizer.state = state;
+			clear_token(ctx, token);
+		}
+	}
+}
+
+/*
+ * Like loop() but fills ctx->perf, see purehtml.h.
+ */
+static void
+loop_perf(struct purehtml *ctx, int (*begin)(struct node *),
+    int (*end)(struct node *))
+{
+	struct purehtml_perf *perf;
+	struct timespec t0, t1;
+	struct token *token;
+	size_t calls, ncalls, tokens, ntokens, depth;
+	double tok, disp;
+	int state;
+
+	perf = ctx->perf;
+	if (perf->clock == 0.0)
+		perf->clock = clock_cost();
+
+	calls = ncalls = tokens = ntokens = 0;
+	tok = disp = 0.0;
+	while (!INPUT_EOF(&ctx->tokenizer.input) && !ctx->dispatcher.stop) {
+		ctx->tokenizer.no_attrs = (ctx->dispatcher.skip != NULL);
+		if (calls++ % PERF_SAMPLE == 0) {
+			clock_gettime(CLOCK_MONOTONIC, &t0);
+			token = tokenize(&ctx->tokenizer);
+			clock_gettime(CLOCK_MONOTONIC, &t1);
+			tok += elapsed(&t0, &t1) - perf->clock;
+			ncalls++;
+		} else
+			token = tokenize(&ctx->tokenizer);
+		if (token == NULL)
+			continue;
+		if (ctx->record != NULL)
+			tokenlog_put(ctx->record, token);
+
+		if (tokens++ % PERF_SAMPLE == 0) {
+			clock_gettime(CLOCK_MONOTONIC, &t0);
+			state = dispatch(&ctx->dispatcher, token, begin, end);
+			clear_token(ctx, token);
+			clock_gettime(CLOCK_MONOTONIC, &t1);
+			disp += elapsed(&t0, &t1) - perf->clock;
+			ntokens++;
+		} else {
+			state = dispatch(&ctx->dispatcher, token, begin, end);
+			clear_token(ctx, token);
+		}
+		if (ctx->record != NULL)
+			tokenlog_put_state(ctx->record, state);
+		if (state != STATE_NONE)
+			ctx->tokenizer.state = state;
+
+		depth = ostack_depth(&ctx->dispatcher.ostack);
+		if (depth > perf->max_depth)
+			perf->max_depth = depth;
+	}
+
+	if (ncalls > 0 && tok > 0.0)
+		perf->tokenize += tok * calls / ncalls;
+	if (ntokens > 0 && disp > 0.0)
+		perf->dispatch += disp * tokens / ntokens;
+	perf->tokens += tokens;
+}
+
+static size_t
+run(struct purehtml *ctx, int (*begin)(struct node *),
+    int (*end)(struct node *))
+{
+	size_t offset;
+
+	ctx->dispatcher.document = &ctx->document;
+	ctx->tokenizer.report = ctx->dispatcher.report = &ctx->report;
+	ctx->tokenizer.attrs.pool = ctx->dispatcher.attr_pool =
+	    &ctx->attr_pool;
+	offset = ctx->tokenizer.offset;
+
+	if (ctx->perf != NULL)
+		loop_perf(ctx, begin, end);
+	else
+		loop(ctx, begin, end);
+
+	if (ctx->dispatcher.stop)
+		dispatch_unwind(&ctx->dispatcher);
+
+	/*
+	 * The pool is not for the threaded parsers, which may tokenize
+	 * with a copy of the tokenizer.
+	 */
+	ctx->tokenizer.attrs.pool = NULL;
+	ctx->dispatcher.attr_pool = NULL;
+
+	return ctx->tokenizer.offset - offset;
+}
+
+/*
+ * Returns the number of bytes consumed, which is less than the input
+ * size if a callback returned CB_STOP. The bytes read ahead of the stop
+ * are then given back to the stream, or if it cannot seek, e.g. a pipe,
+ * their number is left in ctx->lost.
+ */
+size_t
+purehtml_parse(struct purehtml *ctx, FILE *fp,
+    int (*begin)(struct node *), int (*end)(struct node *))
+{
+	struct input *in;
+	size_t consumed, ahead;
+
+	assert(fp != NULL);
+
+	in = &ctx->tokenizer.input;
+	input_file(in, fp);
+	consumed = run(ctx, begin, end);
+
+	ctx->lost = 0;
+	if (ctx->dispatcher.stop && (ahead = input_ahead(in)) > 0 &&
+	    fseek(fp, -(long) ahead, SEEK_CUR) == -1)
+		ctx->lost = ahead;
+
+	return consumed;
+}
+
+/*
+ * Like purehtml_parse() but tokenizes straight from a buffer.
+ */
+size_t
+purehtml_parse_buf(struct purehtml *ctx, const char *buf, size_t len,
+    int (*begin)(struct node *), int (*end)(struct node *))
+{
+	input_buf(&ctx->tokenizer.input, buf, len);
+	return run(ctx, begin, end);
+}
+
+/*
+ * Like purehtml_parse() but the input comes from a read callback, see
+ * input.h. The size of the refill buffer can be set in
+ * ctx->tokenizer.input.size before the first parse.
+ */
+size_t
+purehtml_parse_read(struct purehtml *ctx,
+    size_t (*read)(void *, char *, size_t), void *user,
+    int (*begin)(struct node *), int (*end)(struct node *))
+{
+	input_read(&ctx->tokenizer.input, read, user);
+	return run(ctx, begin, end);
+}
+
+/*
+ * Like purehtml_parse_buf() but maps the file into memory. The mapping
+ * is kept until purehtml_free(). Returns (size_t) -1 and sets errno if
+ * the file could not be mapped.
+ */
+size_t
+purehtml_parse_file(struct purehtml *ctx, const char *path,
+    int (*begin)(struct node *), int (*end)(struct node *))
+{
+	struct stat sb;
+	void *map;
+	int fd, saved;
+
+	assert(path != NULL);
+
+	if ((fd = open(path, O_RDONLY)) == -1)
+		return (size_t) -1;
+	if (fstat(fd, &sb) == -1) {
+		saved = errno;
+		close(fd);
+		errno = saved;
+		return (size_t) -1;
+	}
+
+	map = NULL;
+	if (sb.st_size > 0) {
+		map = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map == MAP_FAILED) {
+			saved = errno;
+			close(fd);
+			errno = saved;
+			return (size_t) -1;
+		}
+		posix_madvise(map, sb.st_size, POSIX_MADV_SEQUENTIAL);
+	}
+	close(fd);
+
+	if (ctx->map != NULL)
+		munmap(ctx->map, ctx->map_len);
+	ctx->map = map;
+	ctx->map_len = sb.st_size;
+
+	return purehtml_parse_buf(ctx, map, sb.st_size, begin, end);
+}
+
+/*
+ * Feed the tokens of a log, see tokenlog.h, to the dispatcher as if
+ * they came from the tokenizer. Returns the number of tokens whose
+ * state switch differs from the one in the log, which is 0 unless the
+ * dispatcher has changed since the log was recorded. The tokens
+ * dispatched are in log->tokens and log->error is set if the log is
+ * bad.
+ */
+size_t
+purehtml_replay(struct purehtml *ctx, struct tokenlog *log,
+    int (*begin)(struct node *), int (*end)(struct node *))
+{
+	struct token *token;
+	size_t differ;
+	int state, logged;
+
+	ctx->dispatcher.document = &ctx->document;
+	ctx->dispatcher.report = &ctx->report;
+
+	differ = 0;
+	while (!ctx->dispatcher.stop &&
+	    (token = tokenlog_get(log, &logged)) != NULL) {
+		state = dispatch(&ctx->dispatcher, token, begin, end);
+		if (state != logged)
+			differ++;
+	}
+
+	if (ctx->dispatcher.stop)
+		dispatch_unwind(&ctx->dispatcher);
+
+	return differ;
+}
+
+/*
+ * Make a used parser ready for the next document, as if it was new,
+ * but keep the buffers, the tables and the stack it has grown so far,
+ * so that parsing many documents with it stops allocating once they
+ * have all been grown. The error callback, ctx->perf, ctx->record, the
+ * input validation and the text settings of the dispatcher are kept as
+ * well.
+ */
+void
+purehtml_reset(struct purehtml *ctx)
+{
+	struct purehtml warm;
+	struct tokenizer *t;
+	struct dispatcher *d;
+
+	ctx->dispatcher.attr_pool = &ctx->attr_pool;
+	dispatch_unwind(&ctx->dispatcher);
+	clear_token(ctx, &ctx->tokenizer.token);
+	if (ctx->map != NULL)
+		munmap(ctx->map, ctx->map_len);
+
+	memset(&warm, 0, sizeof(struct purehtml));
+	t = &warm.tokenizer;
+	d = &warm.dispatcher;
+
+	t->name = ctx->tokenizer.name;
+	t->attrib_name = ctx->tokenizer.attrib_name;
+	t->attrib_value = ctx->tokenizer.attrib_value;
+	t->token.s = ctx->tokenizer.token.s;
+	t->attrs = ctx->tokenizer.attrs;
+	attr_index_clear(&t->attrs);
+	t->input.refill = ctx->tokenizer.input.refill;
+	t->input.size = ctx->tokenizer.input.size;
+	t->input.decoded = ctx->tokenizer.input.decoded;
+	t->input.validate = ctx->tokenizer.input.validate;
+	str_add(&t->name, '\0');
+	str_add(&t->attrib_name, '\0');
+	str_add(&t->attrib_value, '\0');
+	str_add(&t->token.s, '\0');
+
+	d->cdata_buf.data = ctx->dispatcher.cdata_buf.data;
+	d->views = ctx->dispatcher.views;
+	d->views_alloc = ctx->dispatcher.views_alloc;
+	d->ostack = ctx->dispatcher.ostack;
+	d->text = ctx->dispatcher.text;
+	d->text_max = ctx->dispatcher.text_max;
+	d->elide_space = ctx->dispatcher.elide_space;
+	str_add(&d->cdata_buf.data, '\0');
+
+	warm.report.error = ctx->report.error;
+	warm.report.user = ctx->report.user;
+	warm.attr_pool = ctx->attr_pool;
+	warm.perf = ctx->perf;
+	warm.record = ctx->record;
+
+	*ctx = warm;
+}
+
+/*
+ * Release everything held by the parser and leave it ready for
+ * parsing again.
+ */
+void
+purehtml_free(struct purehtml *ctx)
+{
+	dispatch_free(&ctx->dispatcher);
+	token_clear(&ctx->tokenizer.token);
+
+	if (ctx->map != NULL)
+		munmap(ctx->map, ctx->map_len);
+
+	input_free(&ctx->tokenizer.input);
+	mem_free(ctx->tokenizer.name.s);
+	mem_free(ctx->tokenizer.attrib_name.s);
+	mem_free(ctx->tokenizer.attrib_value.s);
+	mem_free(ctx->tokenizer.token.s.s);
+	attr_index_free(&ctx->tokenizer.attrs);
+	attr_pool_free(&ctx->attr_pool);
+
+	memset(ctx, 0, sizeof(struct purehtml));
+}
+
+#line 802 "purehtml.c"
+#line 1 "batch.c"
+
+#line 20 "batch.c"
+#line 21 "batch.c"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <err.h>
+
+/*
+ * Each worker owns a range of documents. It takes documents from the
+ * front of its own range and when that runs out, it steals the back
+ * half of the range of some other worker. This keeps all workers busy
+ * even if a few documents are much larger than the rest.
+ */
+struct worker {
+	pthread_mutex_t		 lock;
+	pthread_t		 thread;
+	size_t			 next;		/* documents left */
+	size_t			 end;
+	size_t			 consumed;
+
+	struct purehtml		 ctx;
+	struct pool		*pool;
+};
+
+struct pool {
+	struct purehtml_batch	*batch;
+	struct purehtml_doc	*docs;
+	struct worker		*workers;
+	size_t			 nworkers;
+};
+
+static pthread_key_t doc_key;
+static pthread_once_t doc_once = PTHREAD_ONCE_INIT;
+
+static void
+doc_key_create(void)
+{
+	if ((errno = pthread_key_create(&doc_key, NULL)) != 0)
+		err(1, "pthread_key_create");
+}
+
+/*
+ * Returns the document that the calling worker thread is parsing, or
+ * NULL if called outside of purehtml_batch().
+ */
+struct purehtml_doc *
+purehtml_batch_doc(void)
+{
+	pthread_once(&doc_once, doc_key_create);
+	return pthread_getspecific(doc_key);
+}
+
+static void
+parse_doc(struct worker *w, struct purehtml_doc *doc)
+{
+	struct purehtml_batch *batch;
+	size_t consumed;
+
+	batch = w->pool->batch;
+	doc->ctx = &w->ctx;
+	doc->consumed = 0;
+	doc->error = 0;
+
+	pthread_setspecific(doc_key, doc);
+	w->ctx.tokenizer.input.charset = doc->charset;
+	if (doc->path != NULL)
+		consumed = purehtml_parse_file(&w->ctx, doc->path,
+		    batch->begin, batch->end);
+	else
+		consumed = purehtml_parse_buf(&w->ctx, doc->buf, doc->len,
+		    batch->begin, batch->end);
+	pthread_setspecific(doc_key, NULL);
+
+	if (consumed != (size_t) -1) {
+		doc->consumed = consumed;
+		w->consumed += consumed;
+	} else
+		doc->error = errno;
+	purehtml_reset(&w->ctx);
+
+	if (batch->done != NULL)
+		batch->done(doc);
+	doc->ctx = NULL;
+}
+
+static int
+steal(struct worker *w)
+{
+	struct pool *pool;
+	struct worker *victim;
+	size_t i, n, start;
+
+	pool = w->pool;
+	for (i = 1; i < pool->nworkers; i++) {
+		victim = &pool->workers[(w - pool->workers + i) %
+		    pool->nworkers];
+
+		pthread_mutex_lock(&victim->lock);
+		n = victim->end - victim->next;
+		start = victim->end - (n + 1) / 2;
+		victim->end = start;
+		pthread_mutex_unlock(&victim->lock);
+
+		if (n > 0) {
+			pthread_mutex_lock(&w->lock);
+			w->next = start;
+			w->end = start + (n + 1) / 2;
+			pthread_mutex_unlock(&w->lock);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static void *
+work(void *arg)
+{
+	struct worker *w = arg;
+	size_t i;
+
+	for (;;) {
+		pthread_mutex_lock(&w->lock);
+		if (w->next < w->end) {
+			i = w->next++;
+			pthread_mutex_unlock(&w->lock);
+			parse_doc(w, &w->pool->docs[i]);
+			continue;
+		}
+		pthread_mutex_unlock(&w->lock);
+
+		if (!steal(w))
+			break;
+	}
+
+	return NULL;
+}
+
+/*
+ * Parse n documents using a pool of worker threads and return the
+ * total number of bytes parsed. Per document results are passed to
+ * the done callback as soon as the document is finished.
+ */
+size_t
+purehtml_batch(struct purehtml_batch *batch, struct purehtml_doc *docs,
+    size_t n)
+{
+	struct pool pool;
+	struct worker *w;
+	size_t i, consumed;
+	long ncpu;
+
+	pthread_once(&doc_once, doc_key_create);
+
+	pool.batch = batch;
+	pool.docs = docs;
+	if (batch->nthreads > 0)
+		pool.nworkers = batch->nthreads;
+	else if ((ncpu = sysconf(_SC_NPROCESSORS_ONLN)) > 0)
+		pool.nworkers = ncpu;
+	else
+		pool.nworkers = 1;
+
+	pool.workers = mem_calloc(pool.nworkers, sizeof(struct worker));
+	if (pool.workers == NULL)
+		err(1, "calloc workers");
+
+	for (i = 0; i < pool.nworkers; i++) {
+		w = &pool.workers[i];
+		w->pool = &pool;
+		w->next = n * i / pool.nworkers;
+		w->end = n * (i + 1) / pool.nworkers;
+		if ((errno = pthread_mutex_init(&w->lock, NULL)) != 0)
+			err(1, "pthread_mutex_init");
+		if (batch->init != NULL)
+			batch->init(&w->ctx);
+	}
+
+	for (i = 0; i < pool.nworkers; i++) {
+		w = &pool.workers[i];
+		if ((errno = pthread_create(&w->thread, NULL, work, w)) != 0)
+			err(1, "pthread_create");
+	}
+
+	/*
+	 * The others may still steal from a worker that has finished, so
+	 * the locks go only after all of them.
+	 */
+	for (i = 0; i < pool.nworkers; i++)
+		pthread_join(pool.workers[i].thread, NULL);
+
+	consumed = 0;
+	for (i = 0; i < pool.nworkers; i++) {
+		w = &pool.workers[i];
+		pthread_mutex_destroy(&w->lock);
+		consumed += w->consumed;
+		purehtml_free(&w->ctx);
+	}
+
+	mem_free(pool.workers);
+	return consumed;
+}
+
+#line 294 "batch.c"
+#line 1 "pipeline.c"
+
+#line 20 "pipeline.c"
+#line 21 "pipeline.c"
+
+#include <pthread.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <err.h>
+
+/*
+ * Pipelined parsing: a thread runs the tokenizer and passes the tokens
+ * in batches through a ring to the calling thread, which runs the
+ * dispatcher and the callbacks.
+ *
+ * The dispatcher tells the tokenizer to switch state only after a
+ * start tag of a raw text element (TAG_RAWTEXT), so the tokenizer
+ * runs ahead assuming no switch and waits for the answer only after
+ * such a tag. Inside a skipped raw text element the dispatcher keeps
+ * returning the SKIP_* state, which we ignore: tokenizing the rest of
+ * it in the regular raw text state gives the same end tag.
+ *
+ * With an error callback set, the errors of the tokenizer are held in
+ * the batch and reported on the calling thread before the token they
+ * came with.
+ */
+#define PIPE_BATCHES	8
+#define PIPE_TOKENS	256
+#define PIPE_CHARS	4096
+
+struct batch {
+	struct token	 tokens[PIPE_TOKENS];
+	size_t		 offsets[PIPE_TOKENS];	/* offset after the token */
+	size_t		 ntokens;
+	char		*chars;		/* text of the tokens */
+	size_t		 nchars;
+	size_t		 chars_alloc;	/* PIPE_CHARS or for a longer token */
+	struct report_queue errors;
+	int		 sync;		/* last token needs the state back */
+	int		 eof;
+};
+
+struct pipeline {
+	struct purehtml	*ctx;
+	struct batch	 ring[PIPE_BATCHES];
+	size_t		 head;		/* next batch to fill */
+	size_t		 tail;		/* next batch to dispatch */
+
+	pthread_mutex_t	 lock;
+	pthread_cond_t	 cond;
+	int		 stop;		/* set by the dispatching side */
+	int		 state;		/* answer to a sync */
+	int		 answered;
+	int		 defer;		/* errors in the batches */
+};
+
+/*
+ * Returns the next free batch or NULL if the dispatcher has stopped.
+ */
+static struct batch *
+next_batch(struct pipeline *pl)
+{
+	struct batch *batch;
+	int stop;
+
+	pthread_mutex_lock(&pl->lock);
+	while (pl->head - pl->tail == PIPE_BATCHES && !pl->stop)
+		pthread_cond_wait(&pl->cond, &pl->lock);
+	stop = pl->stop;
+	pthread_mutex_unlock(&pl->lock);
+
+	if (stop)
+		return NULL;
+
+	batch = &pl->ring[pl->head % PIPE_BATCHES];
+	batch->ntokens = 0;
+	batch->nchars = 0;
+	batch->sync = 0;
+	batch->eof = 0;
+	report_queue_clear(&batch->errors);
+	if (pl->defer)
+		pl->ctx->tokenizer.report = &batch->errors.report;
+	return batch;
+}
+
+/*
+ * Publish the batch and, if it ends in a sync, wait for the state the
+ * dispatcher returned. Returns 0 if the dispatcher has stopped.
+ */
+static int
+publish(struct pipeline *pl, struct batch *batch)
+{
+	int stop;
+
+	pthread_mutex_lock(&pl->lock);
+	pl->head++;
+	pl->answered = 0;
+	pthread_cond_broadcast(&pl->cond);
+	if (batch->sync) {
+		while (!pl->answered && !pl->stop)
+			pthread_cond_wait(&pl->cond, &pl->lock);
+		if (pl->answered && pl->state != STATE_NONE)
+			pl->ctx->tokenizer.state = pl->state;
+	}
+	stop = pl->stop;
+	pthread_mutex_unlock(&pl->lock);
+
+	return !stop;
+}
+
+/*
+ * Make room for at least len chars in an empty batch, whose tokens do
+ * not point to the old ones.
+ */
+static void
+grow_chars(struct batch *batch, size_t len)
+{
+	assert(batch->nchars == 0);
+
+	if (batch->chars_alloc == 0)
+		batch->chars_alloc = PIPE_CHARS;
+	while (batch->chars_alloc < len)
+		batch->chars_alloc *= 2;
+	mem_free(batch->chars);
+	if ((batch->chars = mem_malloc(batch->chars_alloc)) == NULL)
+		err(1, "malloc batch chars");
+}
+
+/*
+ * Move the token out of the tokenizer into the batch, which must have
+ * room for its text unless it is empty.
+ */
+static void
+add_token(struct batch *batch, struct token *token, size_t offset)
+{
+	struct token *slot;
+
+	slot = &batch->tokens[batch->ntokens];
+	*slot = *token;
+	memset(&slot->s, 0, sizeof(struct str));
+	if (token->s.len > 0) {
+		if (batch->nchars + token->s.len + 1 > batch->chars_alloc)
+			grow_chars(batch, token->s.len + 1);
+		slot->s.s = &batch->chars[batch->nchars];
+		slot->s.len = token->s.len;
+		memcpy(slot->s.s, token->s.s, token->s.len + 1);
+		batch->nchars += token->s.len + 1;
+	}
+	batch->offsets[batch->ntokens++] = offset;
+	batch->errors.index = batch->ntokens;
+
+	token->used = 1;
+	token_clear(token);
+	str_add(&token->s, '\0');
+}
+
+static void *
+produce(void *arg)
+{
+	struct pipeline *pl = arg;
+	struct tokenizer *tokenizer;
+	struct batch *batch;
+	struct token *token;
+
+	tokenizer = &pl->ctx->tokenizer;
+	if ((batch = next_batch(pl)) == NULL)
+		return NULL;
+
+	while (!INPUT_EOF(&tokenizer->input)) {
+		token = tokenize(tokenizer);
+		if (token == NULL)
+			continue;
+
+		if (batch->ntokens == PIPE_TOKENS || (batch->nchars > 0 &&
+		    batch->nchars + token->s.len + 1 > batch->chars_alloc)) {
+			if (!publish(pl, batch) ||
+			    (batch = next_batch(pl)) == NULL) {
+				token_clear(token);
+				return NULL;
+			}
+		}
+
+		if (TOKEN_IS_START(token) &&
+		    tagmap(token->u.tag.tagid)->flags & TAG_RAWTEXT)
+			batch->sync = 1;
+		add_token(batch, token, tokenizer->offset);
+
+		if (batch->sync && (!publish(pl, batch) ||
+		    (batch = next_batch(pl)) == NULL))
+			return NULL;
+	}
+
+	batch->eof = 1;
+	publish(pl, batch);
+	return NULL;
+}
+
+/*
+ * Like purehtml_parse() but the tokenizer runs on a thread of its own,
+ * overlapping with the tree construction and the callbacks, which run
+ * on the calling thread. The tokens go to ctx->record as they are
+ * dispatched, but ctx->perf must not be set: the tokenizer runs ahead
+ * on another clock. Attributes are collected in skipped subtrees too.
+ */
+size_t
+purehtml_parse_pipelined(struct purehtml *ctx, FILE *fp,
+    int (*begin)(struct node *), int (*end)(struct node *))
+{
+	struct pipeline *pl;
+	struct batch *batch;
+	pthread_t thread;
+	size_t i, start, consumed;
+	int state, eof;
+
+	assert(fp != NULL);
+	assert(ctx->perf == NULL);
+
+	if ((pl = mem_calloc(1, sizeof(struct pipeline))) == NULL)
+		err(1, "calloc pipeline");
+	pl->ctx = ctx;
+	pl->defer = (ctx->report.error != NULL);
+	for (i = 0; i < PIPE_BATCHES; i++)
+		report_queue_init(&pl->ring[i].errors);
+	if ((errno = pthread_mutex_init(&pl->lock, NULL)) != 0)
+		err(1, "pthread_mutex_init");
+	if ((errno = pthread_cond_init(&pl->cond, NULL)) != 0)
+		err(1, "pthread_cond_init");
+
+	input_file(&ctx->tokenizer.input, fp);
+	ctx->tokenizer.no_attrs = 0;
+	ctx->dispatcher.document = &ctx->document;
+	ctx->tokenizer.report = ctx->dispatcher.report = &ctx->report;
+	start = consumed = ctx->tokenizer.offset;
+
+	if ((errno = pthread_create(&thread, NULL, produce, pl)) != 0)
+		err(1, "pthread_create");
+
+	eof = 0;
+	while (!eof) {
+		pthread_mutex_lock(&pl->lock);
+		while (pl->head == pl->tail)
+			pthread_cond_wait(&pl->cond, &pl->lock);
+		pthread_mutex_unlock(&pl->lock);
+
+		batch = &pl->ring[pl->tail % PIPE_BATCHES];
+		state = STATE_NONE;
+		for (i = 0; i < batch->ntokens; i++) {
+			if (!ctx->dispatcher.stop) {
+				report_queue_flush(&batch->errors,
+				    &ctx->report, i, 0);
+				if (ctx->record != NULL)
+					tokenlog_put(ctx->record,
+					    &batch->tokens[i]);
+				state = dispatch(&ctx->dispatcher,
+				    &batch->tokens[i], begin, end);
+				if (ctx->record != NULL)
+					tokenlog_put_state(ctx->record, state);
+				consumed = batch->offsets[i];
+			}
+			token_clear(&batch->tokens[i]);
+		}
+		if (!ctx->dispatcher.stop)
+			report_queue_flush(&batch->errors, &ctx->report,
+			    batch->ntokens, 0);
+		eof = batch->eof || ctx->dispatcher.stop;
+
+		pthread_mutex_lock(&pl->lock);
+		pl->tail++;
+		if (batch->sync) {
+			pl->state = state;
+			pl->answered = 1;
+		}
+		if (ctx->dispatcher.stop)
+			pl->stop = 1;
+		pthread_cond_broadcast(&pl->cond);
+		pthread_mutex_unlock(&pl->lock);
+	}
+
+	pthread_join(thread, NULL);
+	if (!ctx->dispatcher.stop)
+		consumed = ctx->tokenizer.offset;
+
+	/*
+	 * Free the tokens the tokenizer got ahead with before a stop.
+	 */
+	for (; pl->tail != pl->head; pl->tail++) {
+		batch = &pl->ring[pl->tail % PIPE_BATCHES];
+		for (i = 0; i < batch->ntokens; i++)
+			token_clear(&batch->tokens[i]);
+	}
+
+	if (ctx->dispatcher.stop)
+		dispatch_unwind(&ctx->dispatcher);
+
+	ctx->tokenizer.report = &ctx->report;
+	for (i = 0; i < PIPE_BATCHES; i++) {
+		report_queue_free(&pl->ring[i].errors);
+		mem_free(pl->ring[i].chars);
+	}
+	pthread_cond_destroy(&pl->cond);
+	pthread_mutex_destroy(&pl->lock);
+	mem_free(pl);
+
+	return consumed - start;
+}
+
+#line 513 "pipeline.c"
+#undef PIPE_BATCHES
+#undef PIPE_TOKENS
+#undef PIPE_CHARS
+#line 1 "speculate.c"
+
+#line 20 "speculate.c"
+
+#include <pthread.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <errno.h>
+#include <err.h>
+
+/*
+ * Speculative parallel tokenization of a document in memory.
+ *
+ * The input is split into chunks just before something that looks like
+ * a tag, and worker threads tokenize the chunks in parallel guessing
+ * that each one begins in STATE_DATA. They also guess the state the
+ * dispatcher returns after each token.
+ *
+ * The calling thread then dispatches the chunks in order. The tokens
+ * of a chunk are accepted if the real tokenizer is in STATE_DATA where
+ * the chunk begins, and for as long as the state returned by dispatch()
+ * matches the guess. Otherwise the rest of the chunk is tokenized again
+ * by the real tokenizer, so the callbacks see the same tokens as with
+ * purehtml_parse().
+ */
+#define SPEC_CHUNK	(256 * 1024)
+#define SPEC_AHEAD	2		/* chunks in flight per thread */
+
+struct chunk {
+	size_t		 start;		/* input range */
+	size_t		 end;
+
+	struct token	*tokens;
+	size_t		*offsets;	/* offset after the token */
+	size_t		*text;		/* start of the token text in chars */
+	STATE		*guesses;	/* state guessed after the token */
+	size_t		 ntokens;
+	size_t		 alloc;
+	char		*chars;		/* text of the tokens */
+	size_t		 nchars;
+	size_t		 chars_alloc;
+
+	struct report_queue errors;	/* of the tokens */
+	struct tokenizer tokenizer;	/* state at the end of the chunk */
+	int		 done;
+};
+
+struct spec {
+	struct purehtml	*ctx;
+	const char	*buf;
+
+	struct chunk	*chunks;
+	size_t		 nchunks;
+	size_t		 next;		/* next chunk to tokenize */
+	size_t		 dispatched;	/* chunks dispatched so far */
+	size_t		 ahead;
+	size_t		 base;		/* offset where the buffer begins */
+	int		 encoding;	/* of the buffer, for retokenize() */
+
+	pthread_mutex_t	 lock;
+	pthread_cond_t	 cond;
+	int		 stop;
+};
+
+static size_t chunk_size = SPEC_CHUNK;
+
+/*
+ * The state dispatch() returns after a start tag, as far as we know.
+ * A wrong guess only costs tokenizing the rest of the chunk again.
+ */
+static STATE
+guess(struct token *token)
+{
+	if (!TOKEN_IS_START(token))
+		return STATE_NONE;
+
+	return dispatch_raw_state(token->u.tag.tagid);
+}
+
+/*
+ * While skipping, the dispatcher returns the SKIP_* variant of the raw
+ * text state for every token. That is the same as the raw text state
+ * at the start tag and no change elsewhere.
+ */
+static STATE
+actual(struct token *token, int state)
+{
+	switch (state) {
+	case STATE_SKIP_RCDATA:
+		return TOKEN_IS_START(token) ? STATE_RCDATA : STATE_NONE;
+	case STATE_SKIP_RAWTEXT:
+		return TOKEN_IS_START(token) ? STATE_RAWTEXT : STATE_NONE;
+	case STATE_SKIP_SCRIPT_DATA:
+		return TOKEN_IS_START(token) ? STATE_SCRIPT_DATA : STATE_NONE;
+	default:
+		return state;
+	}
+}
+
+static void
+tokenizer_free(struct tokenizer *tokenizer)
+{
+	token_clear(&tokenizer->token);
+	mem_free(tokenizer->name.s);
+	mem_free(tokenizer->attrib_name.s);
+	mem_free(tokenizer->attrib_value.s);
+	mem_free(tokenizer->token.s.s);
+	attr_index_free(&tokenizer->attrs);
+	input_free(&tokenizer->input);
+	memset(tokenizer, 0, sizeof(struct tokenizer));
+}
+
+/*
+ * Continue with the state, position and the token in progress of the
+ * tokenizer of a chunk. The input and the settings of ours stay, and
+ * our buffers go to the chunk to be freed with it.
+ */
+static void
+take_state(struct tokenizer *to, struct tokenizer *from, size_t line)
+{
+	struct tokenizer tmp;
+
+	to->state = from->state;
+	to->return_state = from->return_state;
+	to->line = from->line + line;
+	to->offset = from->offset;
+	memcpy(to->buf, from->buf, sizeof(to->buf));
+	to->buf_len = from->buf_len;
+	to->match = from->match;
+
+	tmp = *to;
+	to->name = from->name;
+	to->attrib_name = from->attrib_name;
+	to->attrib_value = from->attrib_value;
+	to->token = from->token;
+	to->attrs = from->attrs;
+	to->attrs.pool = tmp.attrs.pool;
+	from->name = tmp.name;
+	from->attrib_name = tmp.attrib_name;
+	from->attrib_value = tmp.attrib_value;
+	from->token = tmp.token;
+	from->attrs = tmp.attrs;
+	from->attrs.pool = NULL;
+}
+
+static void
+add_chunk_token(struct chunk *chunk, struct token *token, size_t offset,
+    STATE state)
+{
+	size_t n;
+
+	if (chunk->ntokens == chunk->alloc) {
+		chunk->alloc = chunk->alloc ? chunk->alloc * 2 : 1024;
+		chunk->tokens = mem_realloc(chunk->tokens,
+		    chunk->alloc * sizeof(struct token));
+		chunk->offsets = mem_realloc(chunk->offsets,
+		    chunk->alloc * sizeof(size_t));
+		chunk->text = mem_realloc(chunk->text,
+		    chunk->alloc * sizeof(size_t));
+		chunk->guesses = mem_realloc(chunk->guesses,
+		    chunk->alloc * sizeof(STATE));
+		if (chunk->tokens == NULL || chunk->offsets == NULL ||
+		    chunk->text == NULL || chunk->guesses == NULL)
+			err(1, "realloc chunk");
+	}
+
+	n = chunk->ntokens++;
+	chunk->tokens[n] = *token;
+	memset(&chunk->tokens[n].s, 0, sizeof(struct str));
+	chunk->offsets[n] = offset;
+	chunk->guesses[n] = state;
+	chunk->text[n] = chunk->nchars;
+	if (token->s.len > 0) {
+		while (chunk->nchars + token->s.len + 1 > chunk->chars_alloc) {
+			chunk->chars_alloc = chunk->chars_alloc ?
+			    chunk->chars_alloc * 2 : 4096;
+			chunk->chars = mem_realloc(chunk->chars,
+			    chunk->chars_alloc);
+			if (chunk->chars == NULL)
+				err(1, "realloc chunk");
+		}
+		memcpy(&chunk->chars[chunk->nchars], token->s.s,
+		    token->s.len + 1);
+		chunk->nchars += token->s.len + 1;
+		chunk->tokens[n].s.len = token->s.len;
+	}
+
+	chunk->errors.index = chunk->ntokens;
+
+	token->used = 1;
+	token_clear(token);
+	str_add(&token->s, '\0');
+}
+
+static void
+tokenize_chunk(struct spec *spec, struct chunk *chunk)
+{
+	struct tokenizer *tokenizer;
+	struct token *token;
+	STATE state;
+
+	tokenizer = &chunk->tokenizer;
+	tokenizer->state = STATE_DATA;
+	tokenizer->offset = spec->base + chunk->start;
+	tokenizer->input.encoding = ENCODING_UTF8;
+	report_queue_init(&chunk->errors);
+	tokenizer->report = &chunk->errors.report;
+	input_buf(&tokenizer->input, &spec->buf[chunk->start],
+	    chunk->end - chunk->start);
+
+	while (!INPUT_EOF(&tokenizer->input)) {
+		if ((token = tokenize(tokenizer)) == NULL)
+			continue;
+		state = guess(token);
+		add_chunk_token(chunk, token, tokenizer->offset, state);
+		if (state != STATE_NONE)
+			tokenizer->state = state;
+	}
+}
+
+static void *
+tokenize_chunks(void *arg)
+{
+	struct spec *spec = arg;
+	struct chunk *chunk;
+	size_t i;
+
+	for (;;) {
+		pthread_mutex_lock(&spec->lock);
+		while (spec->next < spec->nchunks && !spec->stop &&
+		    spec->next >= spec->dispatched + spec->ahead)
+			pthread_cond_wait(&spec->cond, &spec->lock);
+		if (spec->next == spec->nchunks || spec->stop) {
+			pthread_mutex_unlock(&spec->lock);
+			return NULL;
+		}
+		i = spec->next++;
+		pthread_mutex_unlock(&spec->lock);
+
+		chunk = &spec->chunks[i];
+		tokenize_chunk(spec, chunk);
+
+		pthread_mutex_lock(&spec->lock);
+		chunk->done = 1;
+		pthread_cond_broadcast(&spec->cond);
+		pthread_mutex_unlock(&spec->lock);
+	}
+}
+
+static void
+free_chunk(struct chunk *chunk, size_t from)
+{
+	size_t i;
+
+	for (i = from; i < chunk->ntokens; i++)
+		token_clear(&chunk->tokens[i]);
+	mem_free(chunk->tokens);
+	mem_free(chunk->offsets);
+	mem_free(chunk->text);
+	mem_free(chunk->guesses);
+	mem_free(chunk->chars);
+	report_queue_free(&chunk->errors);
+	tokenizer_free(&chunk->tokenizer);
+}
+
+/*
+ * Tokenize the input range with the real tokenizer.
+ */
+static void
+retokenize(struct spec *spec, size_t start, size_t end,
+    int (*begin)(struct node *), int (*end_cb)(struct node *))
+{
+	struct purehtml *ctx;
+	struct token *token;
+	int state;
+
+	ctx = spec->ctx;
+	input_buf(&ctx->tokenizer.input, &spec->buf[start], end - start);
+	ctx->tokenizer.input.encoding = spec->encoding;
+	ctx->tokenizer.offset = spec->base + start;
+
+	while (!INPUT_EOF(&ctx->tokenizer.input) && !ctx->dispatcher.stop) {
+		if ((token = tokenize(&ctx->tokenizer)) == NULL)
+			continue;
+		if (ctx->record != NULL)
+			tokenlog_put(ctx->record, token);
+		state = dispatch(&ctx->dispatcher, token, begin, end_cb);
+		if (ctx->record != NULL)
+			tokenlog_put_state(ctx->record, state);
+		if (state != STATE_NONE)
+			ctx->tokenizer.state = state;
+		token_clear(token);
+	}
+}
+
+/*
+ * Dispatch the guessed tokens of a chunk, or as many of them as were
+ * guessed right. Returns 0 if the rest of the chunk has to be
+ * tokenized again from ctx->tokenizer.offset.
+ */
+static int
+accept_chunk(struct spec *spec, struct chunk *chunk,
+    int (*begin)(struct node *), int (*end)(struct node *))
+{
+	struct purehtml *ctx;
+	struct token *token;
+	size_t i, line;
+	STATE state;
+
+	ctx = spec->ctx;
+	line = ctx->tokenizer.line;
+
+	for (i = 0; i < chunk->ntokens && !ctx->dispatcher.stop; i++) {
+		token = &chunk->tokens[i];
+		if (token->s.len > 0)
+			token->s.s = &chunk->chars[chunk->text[i]];
+		token->end_line += line;
+		report_queue_flush(&chunk->errors, &ctx->report, i, line);
+
+		if (ctx->record != NULL)
+			tokenlog_put(ctx->record, token);
+		state = dispatch(&ctx->dispatcher, token, begin, end);
+		if (ctx->record != NULL)
+			tokenlog_put_state(ctx->record, state);
+		state = actual(token, state);
+		token_clear(token);
+		ctx->tokenizer.offset = chunk->offsets[i];
+
+		if (state != chunk->guesses[i]) {
+			/*
+			 * Tokens end in STATE_DATA unless the dispatcher
+			 * says otherwise.
+			 */
+			ctx->tokenizer.state = (state != STATE_NONE) ?
+			    state : STATE_DATA;
+			ctx->tokenizer.line = token->end_line;
+			free_chunk(chunk, i + 1);
+			return 0;
+		}
+	}
+
+	if (ctx->dispatcher.stop) {
+		free_chunk(chunk, i);
+		return 1;
+	}
+
+	/*
+	 * The chunk may end in the middle of a token, so continue where
+	 * the tokenizer that tokenized it left off.
+	 */
+	report_queue_flush(&chunk->errors, &ctx->report, chunk->ntokens, line);
+	take_state(&ctx->tokenizer, &chunk->tokenizer, line);
+	free_chunk(chunk, chunk->ntokens);
+	return 1;
+}
+
+/*
+ * Split at something that looks like a start or an end tag.
+ */
+static size_t
+split(const char *buf, size_t len, size_t at)
+{
+	for (; at + 1 < len; at++)
+		if (buf[at] == '<' && (isalpha((unsigned char) buf[at + 1]) ||
+		    buf[at + 1] == '/'))
+			return at;
+	return len;
+}
+
+/*
+ * Like purehtml_parse() but for a document in memory, tokenizing it in
+ * parallel on nthreads threads (online CPUs if zero). The dispatcher
+ * and the callbacks run on the calling thread, and the tokens go to
+ * ctx->record as they are dispatched. ctx->perf must not be set, as
+ * the tokenizers run on other clocks. Attributes are collected in
+ * skipped subtrees too.
+ */
+size_t
+purehtml_parse_speculative(struct purehtml *ctx, const char *buf,
+    size_t len, int nthreads, int (*begin)(struct node *),
+    int (*end)(struct node *))
+{
+	struct spec spec;
+	struct chunk *chunk;
+	pthread_t *threads;
+	size_t i, n, at, start, consumed;
+	char *utf8;
+	long ncpu;
+	int encoding;
+
+	assert(ctx->perf == NULL);
+
+	if (nthreads <= 0 && (ncpu = sysconf(_SC_NPROCESSORS_ONLN)) > 0)
+		nthreads = ncpu;
+	if (nthreads <= 0)
+		nthreads = 1;
+
+	/*
+	 * Chunks are split in UTF-8.
+	 */
+	input_buf(&ctx->tokenizer.input, buf, len);
+	encoding = ctx->tokenizer.input.encoding;
+	utf8 = input_utf8(&ctx->tokenizer.input, &buf, &len);
+
+	memset(&spec, 0, sizeof(struct spec));
+	spec.ctx = ctx;
+	spec.buf = buf;
+	spec.ahead = nthreads * SPEC_AHEAD;
+	spec.base = ctx->tokenizer.offset;
+	spec.encoding = ctx->tokenizer.input.encoding;
+
+	for (at = 0; at < len; at = split(buf, len, at + chunk_size)) {
+		spec.chunks = mem_realloc(spec.chunks,
+		    (spec.nchunks + 1) * sizeof(struct chunk));
+		if (spec.chunks == NULL)
+			err(1, "realloc chunks");
+		chunk = &spec.chunks[spec.nchunks++];
+		memset(chunk, 0, sizeof(struct chunk));
+		chunk->start = at;
+		chunk->end = split(buf, len, at + chunk_size);
+	}
+
+	if ((errno = pthread_mutex_init(&spec.lock, NULL)) != 0)
+		err(1, "pthread_mutex_init");
+	if ((errno = pthread_cond_init(&spec.cond, NULL)) != 0)
+		err(1, "pthread_cond_init");
+	if ((threads = mem_calloc(nthreads, sizeof(pthread_t))) == NULL)
+		err(1, "calloc threads");
+	for (i = 0; i < (size_t) nthreads; i++)
+		if ((errno = pthread_create(&threads[i], NULL, tokenize_chunks,
+		    &spec)) != 0)
+			err(1, "pthread_create");
+
+	ctx->dispatcher.document = &ctx->document;
+	ctx->tokenizer.report = ctx->dispatcher.report = &ctx->report;
+	ctx->tokenizer.no_attrs = 0;
+	start = ctx->tokenizer.offset;
+
+	for (n = 0; n < spec.nchunks && !ctx->dispatcher.stop; n++) {
+		chunk = &spec.chunks[n];
+
+		pthread_mutex_lock(&spec.lock);
+		while (!chunk->done)
+			pthread_cond_wait(&spec.cond, &spec.lock);
+		pthread_mutex_unlock(&spec.lock);
+
+		/*
+		 * The guesses hold only if the chunk begins in data.
+		 */
+		if (ctx->tokenizer.state != STATE_DATA) {
+			free_chunk(chunk, 0);
+			retokenize(&spec, chunk->start, chunk->end, begin, end);
+		} else if (!accept_chunk(&spec, chunk, begin, end))
+			retokenize(&spec, ctx->tokenizer.offset - spec.base,
+			    chunk->end, begin, end);
+
+		pthread_mutex_lock(&spec.lock);
+		spec.dispatched = n + 1;
+		if (ctx->dispatcher.stop)
+			spec.stop = 1;
+		pthread_cond_broadcast(&spec.cond);
+		pthread_mutex_unlock(&spec.lock);
+	}
+
+	for (i = 0; i < (size_t) nthreads; i++)
+		pthread_join(threads[i], NULL);
+
+	/*
+	 * Chunks tokenized ahead of a stop.
+	 */
+	for (; n < spec.nchunks; n++)
+		if (spec.chunks[n].done)
+			free_chunk(&spec.chunks[n], 0);
+
+	consumed = ctx->tokenizer.offset;
+	if (ctx->dispatcher.stop)
+		dispatch_unwind(&ctx->dispatcher);
+
+	/*
+	 * Nothing of the buffer or the encoding of this document stays in
+	 * the input of the caller.
+	 */
+	input_buf(&ctx->tokenizer.input, NULL, 0);
+	ctx->tokenizer.input.encoding = encoding;
+
+	mem_free(threads);
+	mem_free(spec.chunks);
+	mem_free(utf8);
+	pthread_cond_destroy(&spec.cond);
+	pthread_mutex_destroy(&spec.lock);
+
+	return consumed - start;
+}
+
+#line 722 "speculate.c"
+#undef SPEC_CHUNK
+#undef SPEC_AHEAD
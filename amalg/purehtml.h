@@ -0,0 +1,1480 @@
+/* generated by amalg.awk */
+
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#ifndef PUREHTML_AMALG_H
+#define PUREHTML_AMALG_H
+#line 1 "attr.h"
+
+#ifndef ATTR_H
+#define ATTR_H
+
+#include <stddef.h>
+
+struct attr
+{
+	char *name;
+	char *value;
+	struct attr *next;
+	size_t name_size;		/* of the buffers, if known */
+	size_t value_size;
+};
+
+struct attr_map {
+	char *name;
+	int flags;
+};
+
+enum ATTR_FLAG {
+	ATTR_FLAG_GLOBAL = (1 << 0),
+	ATTR_FLAG_EVENT = (1 << 1),
+};
+
+/*
+ * Hash index of the names of a list being built, so that the duplicate
+ * check of attr_index_set() does not walk the list. Lists shorter than
+ * ATTR_INDEX_MIN are walked as by attr_set().
+ */
+#define ATTR_INDEX_MIN 8
+
+struct attr_index {
+	struct attr **slots;
+	size_t alloc;			/* power of two */
+	size_t n;			/* attributes in the list */
+	struct attr_pool *pool;		/* to take attributes from, or NULL */
+};
+
+/*
+ * Attributes given back once a parser is done with them, taken again
+ * with their name and value buffers, and the names of the custom tags
+ * seen so far, up to ATTR_POOL_NAMES of them. See purehtml_reset().
+ */
+#define ATTR_POOL_NAMES 256
+
+struct attr_pool {
+	struct attr *free;
+	struct attr *names;
+	struct attr_index index;	/* of the names */
+};
+
+struct attr *attr_get(struct attr *, const char *);
+void attr_set(struct attr **, const char *, const char *);
+int attr_has(struct attr *, const char *);
+struct attr *attr_copy(struct attr *);
+void attr_free(struct attr *);
+
+void attr_index_set(struct attr_index *, struct attr **, const char *,
+    const char *);
+void attr_index_clear(struct attr_index *);
+void attr_index_free(struct attr_index *);
+
+void attr_pool_put(struct attr_pool *, struct attr *);
+char *attr_pool_name(struct attr_pool *, const char *);
+void attr_pool_free(struct attr_pool *);
+
+size_t attr_size(struct attr *);
+
+#endif
+#line 1 "document.h"
+
+#ifndef DOCUMENT_H
+#define DOCUMENT_H
+
+struct node;
+
+struct document {
+	struct node	*node;	/* back reference, can be NULL */
+	struct elem	*body;
+	struct elem	*head;
+};
+
+struct document	*document_create(void);
+
+#endif
+#line 1 "dispatch.h"
+
+#ifndef DISPATCHER_H
+#define DISPATCHER_H
+
+struct token;
+struct document;
+struct elem;
+struct elem_view;
+struct attr_pool;
+
+#line 1 "imodes.h"
+/* generated by enum.awk */
+#ifndef IMODES_H
+#define IMODES_H
+enum imodes {
+	IMODE_INITIAL,
+	IMODE_BEFORE_HTML,
+	IMODE_BEFORE_HEAD,
+	IMODE_IN_HEAD,
+	IMODE_IN_HEAD_NOSCRIPT,
+	IMODE_AFTER_HEAD,
+	IMODE_IN_BODY,
+	IMODE_TEXT,
+	IMODE_IN_TABLE,
+	IMODE_IN_TABLE_TEXT,
+	IMODE_IN_ROW,
+	IMODE_IN_CELL,
+	IMODE_IN_CAPTION,
+	IMODE_IN_COLUMN_GROUP,
+	IMODE_IN_TABLE_BODY,
+	IMODE_IN_SELECT,
+	IMODE_IN_SELECT_IN_TABLE,
+	IMODE_IN_TEMPLATE,
+	IMODE_AFTER_BODY,
+	IMODE_IN_FRAMESET,
+	IMODE_AFTER_FRAMESET,
+	IMODE_AFTER_AFTER_BODY,
+	IMODE_AFTER_AFTER_FRAMESET,
+	NIMODES
+};
+#endif
+#line 29 "dispatch.h"
+#line 1 "node.h"
+
+#ifndef NODE_H
+#define NODE_H
+
+#include <stddef.h>
+
+typedef enum nodetype {
+	NODE_ELEM,
+	NODE_CDATA,
+	NODE_DOCUMENT
+} T_NODE;
+
+struct node {
+	T_NODE	type;
+	int	view;		/* owned by the parser, see node_retain() */
+
+	union {
+		struct elem	*elem;
+		struct cdata	*cdata;
+		struct document	*document;
+	} u;
+
+	/*
+	 * Optional nodes for DOM construction.
+	 */
+	struct node *parent;
+	struct node *first;
+	struct node *last;
+	struct node *next;
+	struct node *prev;
+};
+
+struct node	*node_create_from_elem(struct elem *);
+struct node	*node_create_from_cdata(struct cdata *);
+struct node	*node_create_from_document(struct document *);
+struct node	*node_retain(struct node *);
+
+size_t node_size(struct node *);
+void node_free(struct node *);
+
+#endif
+#line 30 "dispatch.h"
+#line 1 "cdata.h"
+
+#ifndef CDATA_H
+#define CDATA_H
+
+#line 1 "util.h"
+
+#ifndef UTIL_H
+#define UTIL_H
+
+#include <stddef.h>
+
+struct str
+{
+	size_t alloc;
+	size_t len;
+	char *s;
+};
+
+void str_add(struct str *, char);
+
+/*
+ * The library allocates through these, which call the functions set
+ * with purehtml_allocator(), by default those of the C library. Memory
+ * allocated by the library must be freed by the library.
+ */
+struct allocator {
+	void	*(*malloc)(size_t);
+	void	*(*realloc)(void *, size_t);
+	void	 (*free)(void *);
+};
+
+void	 purehtml_allocator(const struct allocator *);
+void	*mem_malloc(size_t);
+void	*mem_calloc(size_t, size_t);
+void	*mem_realloc(void *, size_t);
+char	*mem_strdup(const char *);
+void	 mem_free(void *);
+
+/*
+ * The system isspace() is a bit different from the HTML LS isspace and in
+ * worst case the system isspace() can be locale specific.
+ */
+#define HTML_ISSPACE(_c) (\
+	(_c) == '\t' || \
+	(_c) == '\n' || \
+	(_c) == '\f' || \
+	(_c) == ' ')
+
+#endif
+#line 23 "cdata.h"
+
+typedef enum cdatatype {
+	CDATA_TEXT,
+	CDATA_COMMENT,
+} T_CDATA;
+
+struct node;
+struct str;
+
+struct cdata {
+	T_CDATA		 type;
+	struct str	 data;
+
+	struct node	*node;	/* back reference, can be NULL */
+};
+
+struct cdata	*cdata_create(T_CDATA);
+struct cdata	*cdata_copy(struct cdata *);
+void		 cdata_add(struct cdata *, const char *);
+void		 cdata_free(struct cdata *);
+size_t		 cdata_size(struct cdata *);
+
+#endif
+#line 31 "dispatch.h"
+#line 1 "ostack.h"
+
+#ifndef OSTACK_H
+#define OSTACK_H
+
+#include <stddef.h>
+
+struct elem;
+
+/*
+ * Open elements stack. The number of open elements of each tag id is
+ * kept so that looking for one that is not open takes no scan.
+ */
+struct ostack {
+	struct elem	**elems;
+	size_t		  alloc;
+	size_t		  depth;
+	size_t		 *counts;	/* by tag id, see ostack_count() */
+};
+
+void		 ostack_push(struct ostack *, struct elem *elem);
+struct elem	*ostack_pop(struct ostack *);
+struct elem	*ostack_prev(struct ostack *, struct elem *elem);
+struct elem	*ostack_peek(struct ostack *);
+struct elem	*ostack_peek_at(struct ostack *, size_t);
+size_t		 ostack_depth(struct ostack *);
+size_t		 ostack_count(struct ostack *, int);
+void		 ostack_free(struct ostack *);
+
+#endif
+#line 32 "dispatch.h"
+#line 1 "report.h"
+
+#ifndef REPORT_H
+#define REPORT_H
+
+#line 1 "errors.h"
+/* generated by enum.awk */
+#ifndef ERRORS_H
+#define ERRORS_H
+enum errors {
+	ERROR_ABRUPT_CLOSING_OF_EMPTY_COMMENT,
+	ERROR_CDATA_IN_HTML_CONTENT,
+	ERROR_INCORRECTLY_CLOSED_COMMENT,
+	ERROR_INCORRECTLY_OPENED_COMMENT,
+	ERROR_INVALID_FIRST_CHARACTER_OF_TAG_NAME,
+	ERROR_MISSING_ATTRIBUTE_VALUE,
+	ERROR_MISSING_DOCTYPE_NAME,
+	ERROR_MISSING_WHITESPACE_BEFORE_DOCTYPE_NAME,
+	ERROR_MISSING_WHITESPACE_BETWEEN_ATTRIBUTES,
+	ERROR_NESTED_COMMENT,
+	ERROR_UNEXPECTED_CHARACTER_IN_ATTRIBUTE_NAME,
+	ERROR_UNEXPECTED_CHARACTER_IN_UNQUOTED_ATTRIBUTE_VALUE,
+	ERROR_UNEXPECTED_EQUALS_SIGN_BEFORE_ATTRIBUTE_NAME,
+	ERROR_UNEXPECTED_SOLIDUS_IN_TAG,
+	ERROR_UNEXPECTED_DOCTYPE,
+	ERROR_UNEXPECTED_TOKEN,
+	ERROR_IMPLIED_HEAD,
+	ERROR_ELEMENT_NOT_IN_SCOPE,
+	ERROR_MISMATCHED_END_TAG,
+	ERROR_UNCLOSED_ELEMENT,
+	ERROR_NESTED_BUTTON,
+	ERROR_UNSUPPORTED,
+	NERRORS
+};
+#endif
+#line 23 "report.h"
+
+#include <stddef.h>
+
+/*
+ * Parse errors of a document. Each is counted per code, which is all
+ * it costs unless the optional callback is set. The line is 1-based
+ * and the offset is in bytes of UTF-8 from the start of the input.
+ */
+struct report {
+	void	(*error)(void *user, enum errors code, size_t line,
+		    size_t offset);
+	void	*user;
+	size_t	 count[NERRORS];
+};
+
+/*
+ * A library built with -DPUREHTML_FAST reports nothing, not even the
+ * counts, for bulk extraction that has no use for them.
+ */
+#ifdef PUREHTML_FAST
+#define REPORT(_report, _code, _line, _offset)	do { } while (0)
+#else
+#define REPORT(_report, _code, _line, _offset) do { \
+	if ((_report) != NULL) { \
+		(_report)->count[(_code)]++; \
+		if ((_report)->error != NULL) \
+			(_report)->error((_report)->user, (_code), (_line), \
+			    (_offset)); \
+	} \
+} while (0)
+#endif
+
+/*
+ * Errors held back to be reported in order with the tokens they came
+ * with, when tokenizing ahead on another thread. Give the tokenizer
+ * queue->report and keep queue->index at the number of tokens so far.
+ */
+struct report_entry {
+	size_t		 index;		/* of the token */
+	enum errors	 code;
+	size_t		 line;
+	size_t		 offset;
+};
+
+struct report_queue {
+	struct report		 report;
+	struct report_entry	*entries;
+	size_t			 nentries;
+	size_t			 alloc;
+	size_t			 next;		/* to flush */
+	size_t			 index;
+};
+
+const char	*report_name(enum errors);
+size_t		 report_total(const struct report *);
+void		 report_queue_init(struct report_queue *);
+void		 report_queue_flush(struct report_queue *, struct report *,
+		    size_t, size_t);
+void		 report_queue_clear(struct report_queue *);
+void		 report_queue_free(struct report_queue *);
+
+#endif
+#line 33 "dispatch.h"
+
+#include <stddef.h>
+
+typedef enum imodes IMODE;
+
+#define TEXT_MAX 4096
+
+/*
+ * Return values for the begin and end callbacks.
+ */
+enum callback_verdict {
+	CB_CONTINUE,
+	CB_SKIP,		/* skip children of the begun element */
+	CB_STOP			/* stop parsing */
+};
+
+struct dispatcher {
+	struct document	*document;
+	struct cdata	*cdata;		/* pending text or NULL */
+	struct elem	*head_elem;
+	struct ostack	 ostack;	/* open elements */
+
+	/*
+	 * Parser owned storage for the nodes passed to the callbacks.
+	 */
+	struct cdata	 cdata_buf;
+	struct node	 cdata_node;
+	struct elem_view **views;
+	size_t		 views_alloc;
+
+	IMODE		 mode;
+	IMODE		 orig_mode;
+
+	/*
+	 * Element whose children are being skipped, if any. While
+	 * skipping we only track nesting of the same element and the
+	 * raw text children, whose content must not be taken as tags.
+	 */
+	struct elem	*skip;
+	size_t		 skip_depth;
+	int		 skip_state;
+	int		 skip_raw;	/* tag id of such a child, or 0 */
+
+	int		 stop;		/* a callback returned CB_STOP */
+
+	struct report	*report;	/* parse errors, or NULL */
+	struct attr_pool *attr_pool;	/* to give attributes back to, or NULL */
+
+	int (*begin)(struct node *);
+	int (*end)(struct node *);
+
+	/*
+	 * Optional streaming of text: if set, text is passed here in
+	 * pieces of about text_max bytes (TEXT_MAX if zero) instead of
+	 * to begin and end, so that memory use does not depend on the
+	 * size of a text node. The flag tells if the piece is the final
+	 * one of the text node.
+	 */
+	int (*text)(struct node *, int);
+	size_t		 text_max;
+
+	/*
+	 * Optional dropping of whitespace-only text where it cannot
+	 * affect rendering, see flush_cdata().
+	 */
+	int		 elide_space;
+	IMODE		 cdata_mode;	/* mode when pending text began */
+	int		 cdata_space;	/* pending text is all whitespace */
+	int		 cdata_sent;	/* pieces of it were streamed */
+	int		 cdata_block;	/* it follows a block boundary */
+	int		 last_block;	/* last boundary was a block one */
+	size_t		 pre_depth;	/* open preformatted elements */
+};
+
+int dispatch(struct dispatcher *, struct token *, int (*)(struct node *),
+    int (*)(struct node *));
+void dispatch_unwind(struct dispatcher *);
+int dispatch_raw_state(int);
+void dispatch_free(struct dispatcher *);
+
+#endif
+#line 1 "tokenize.h"
+
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#line 23 "tokenize.h"
+#line 1 "token.h"
+
+#ifndef TOKEN_H
+#define TOKEN_H
+
+#line 23 "token.h"
+
+struct attr;
+
+typedef enum token_type {
+	TOKEN_EMPTY,
+	TOKEN_CHAR,
+	TOKEN_DOCTYPE,
+	TOKEN_START_TAG,
+	TOKEN_END_TAG,
+	TOKEN_COMMENT
+} TOKEN_TYPE;
+
+struct tagtoken
+{
+	unsigned short tagid;
+	char *name;			/* can be ptr to tagid name */
+	struct attr *attr;
+	char is_self_closing;
+	char shared_name;		/* interned, see attr_pool_name() */
+};
+
+struct str;
+
+struct token
+{
+	TOKEN_TYPE type;
+	union {
+		struct tagtoken tag;
+	} u;
+	char used;			/* if used, alloc control is passed fwd */
+	struct str s;
+	size_t end_line;
+	size_t end_offset;
+};
+
+const char		*token_str		(struct token *);
+void			 token_set_tag_attr	(struct token *, const char *, const char *);
+void			 token_clear		(struct token *);
+void			 token_set_tag_name	(struct token *, const char *);
+void			 token_add_char		(struct token *, char);
+
+#define TOKEN_SET_DOCTYPE(_c) \
+	((struct token) { .type = TOKEN_DOCTYPE })
+#define TOKEN_SET_START_TAG() \
+	((struct token) { .type = TOKEN_START_TAG })
+#define TOKEN_SET_END_TAG() \
+	((struct token) { .type = TOKEN_END_TAG })
+#define TOKEN_SET_COMMENT() \
+	((struct token) { .type = TOKEN_COMMENT })
+#define TOKEN_IS_COMMENT(_token) \
+	((_token)->type == TOKEN_COMMENT)
+#define TOKEN_IS_CHAR(_token) \
+	((_token)->type == TOKEN_CHAR)
+#define TOKEN_IS_EMPTY(_token) \
+	((_token)->type == TOKEN_EMPTY)
+
+#define TOKEN_IS_SPACE(_token) \
+	((_token)->type == TOKEN_CHAR && \
+	HTML_ISSPACE((_token)->s.s[0]))
+
+#define TOKEN_IS_DOCTYPE(_token) ((_token)->type == TOKEN_DOCTYPE)
+
+#define TOKEN_IS_START(_token) ((_token)->type == TOKEN_START_TAG)
+#define TOKEN_IS_END(_token) ((_token)->type == TOKEN_END_TAG)
+
+#define TOKEN_IS_START_END(_token) \
+	(TOKEN_IS_START(_token) || \
+	TOKEN_IS_END(_token))
+
+#define TOKEN_IS_START_TAG(_token, _tagid) \
+	((_token)->type == TOKEN_START_TAG && \
+	(_token)->u.tag.tagid == (_tagid))
+
+#define TOKEN_IS_END_TAG(_token, _tagid) \
+	((_token)->type == TOKEN_END_TAG && \
+	(_token)->u.tag.tagid == (_tagid))
+
+#define TOKEN_IS_TAG(_token, _tagid) ((_token)->u.tag.tagid == (_tagid))
+
+#endif
+#line 24 "tokenize.h"
+#line 25 "tokenize.h"
+#line 1 "states.h"
+/* generated by enum.awk */
+#ifndef STATES_H
+#define STATES_H
+enum states {
+	STATE_DATA,
+	STATE_NONE,
+	STATE_RCDATA,
+	STATE_RCDATA_LT,
+	STATE_RCDATA_END_TAG_OPEN,
+	STATE_RCDATA_END_TAG_NAME,
+	STATE_RAWTEXT,
+	STATE_RAWTEXT_LT,
+	STATE_RAWTEXT_END_TAG_OPEN,
+	STATE_RAWTEXT_END_TAG_NAME,
+	STATE_PLAINTEXT,
+	STATE_TAG_OPEN,
+	STATE_END_TAG_OPEN,
+	STATE_TAG_NAME,
+	STATE_BEFORE_ATTRIB_NAME,
+	STATE_ATTRIB_NAME,
+	STATE_AFTER_ATTRIB_NAME,
+	STATE_BEFORE_ATTRIB_VAL,
+	STATE_ATTRIB_VAL_QUOTED,
+	STATE_ATTRIB_VAL_SQUOTED,
+	STATE_ATTRIB_VAL,
+	STATE_AFTER_ATTRIB_VAL_QUOTED,
+	STATE_MARKUP_DECLARATION_OPEN,
+	STATE_CHARACTER_REFERENCE,
+	STATE_NAMED_CHAR_REF,
+	STATE_NUM_CHAR_REF,
+	STATE_COMMENT_START,
+	STATE_COMMENT_START_DASH,
+	STATE_COMMENT,
+	STATE_COMMENT_LT,
+	STATE_COMMENT_LT_BANG,
+	STATE_COMMENT_LT_BANG_DASH,
+	STATE_COMMENT_LT_BANG_DASH2,
+	STATE_COMMENT_END_DASH,
+	STATE_COMMENT_END,
+	STATE_COMMENT_END_BANG,
+	STATE_BOGUS_COMMENT,
+	STATE_DOCTYPE,
+	STATE_BEFORE_DOCTYPE_NAME,
+	STATE_DOCTYPE_NAME,
+	STATE_AFTER_DOCTYPE_NAME,
+	STATE_BOGUS_DOCTYPE,
+	STATE_SELF_CLOSING_START_TAG,
+	STATE_SCRIPT_DATA,
+	STATE_SCRIPT_DATA_LT,
+	STATE_SCRIPT_DATA_ESC_START,
+	STATE_SCRIPT_DATA_ESC_START_DASH,
+	STATE_SCRIPT_DATA_ESC_DASH,
+	STATE_SCRIPT_DATA_ESC_DASH2,
+	STATE_SCRIPT_DATA_ESC_LT,
+	STATE_SCRIPT_DATA_ESC_END_TAG_OPEN,
+	STATE_SCRIPT_DATA_ESC_END_TAG_NAME,
+	STATE_SCRIPT_DATA_DBL_ESC_START,
+	STATE_SCRIPT_DATA_ESC,
+	STATE_SCRIPT_DATA_END_TAG_OPEN,
+	STATE_SCRIPT_DATA_END_TAG_NAME,
+	STATE_SKIP_RCDATA,
+	STATE_SKIP_RAWTEXT,
+	STATE_SKIP_SCRIPT_DATA,
+	NSTATES
+};
+#endif
+#line 26 "tokenize.h"
+#line 1 "input.h"
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#line 1 "encoding.h"
+
+#ifndef ENCODING_H
+#define ENCODING_H
+
+#include <stddef.h>
+
+/*
+ * Character encodings that can be decoded to UTF-8. Other labels are
+ * not recognized and such documents are sniffed like undeclared ones.
+ */
+enum encoding {
+	ENCODING_NONE,			/* not known yet */
+	ENCODING_BINARY,		/* bytes as they are */
+	ENCODING_UTF8,
+	ENCODING_UTF16LE,
+	ENCODING_UTF16BE,
+	ENCODING_IBM866,		/* single-byte from here on */
+	ENCODING_ISO_8859_2,
+	ENCODING_ISO_8859_5,
+	ENCODING_ISO_8859_7,
+	ENCODING_ISO_8859_15,
+	ENCODING_KOI8_R,
+	ENCODING_KOI8_U,
+	ENCODING_MACINTOSH,
+	ENCODING_WINDOWS_1250,
+	ENCODING_WINDOWS_1251,
+	ENCODING_WINDOWS_1252,
+	ENCODING_WINDOWS_1253,
+	ENCODING_WINDOWS_1254,
+	ENCODING_WINDOWS_1257
+};
+
+#define ENCODING_PRESCAN 1024
+
+const char	*encoding_name(int);
+int		 encoding_label(const char *, size_t);
+int		 encoding_charset(const char *, size_t);
+size_t		 encoding_bom(const char *, size_t, int *);
+int		 encoding_prescan(const char *, size_t);
+int		 encoding_sniff(const char *, size_t, int);
+size_t		 encoding_utf8_valid(const char *, size_t);
+size_t		 encoding_decode(int, const char *, size_t *, char *, size_t,
+		    int);
+
+#endif
+#line 23 "input.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+#define INPUT_SIZE 65536
+
+/*
+ * Input of the tokenizer: either a buffer that holds all of it, or a
+ * read callback that refills an internal buffer. The callback returns
+ * the number of bytes it put to buf, or 0 at the end of input.
+ *
+ * The input is decoded to UTF-8 on the way. Unless the encoding is set
+ * beforehand, it is sniffed from the first ENCODING_PRESCAN bytes as in
+ * the HTML standard: a byte order mark, then charset from the transport
+ * layer, then a <meta> declaration, then a guess. A sniffed encoding is
+ * sniffed again for the next input. UTF-8 input is passed
+ * through without copying, and if validate is set, only as far as it is
+ * valid: invalid sequences are replaced with U+FFFD. The tokenizer
+ * offsets count bytes of UTF-8.
+ */
+struct input {
+	const char	*buf;		/* bytes not yet consumed */
+	size_t		 len;
+	size_t		 pos;
+
+	size_t		(*read)(void *user, char *buf, size_t len);
+	void		*user;
+	char		*refill;
+	size_t		 size;		/* of reads, INPUT_SIZE if zero */
+	int		 eof;		/* no more after buf */
+
+	int		 charset;	/* ENCODING_* from e.g. Content-Type */
+	int		 encoding;	/* ENCODING_*, sniffed if NONE */
+	int		 sniffed;	/* encoding is of this input only */
+	int		 validate;	/* replace invalid UTF-8 */
+	const char	*src;		/* undecoded input */
+	size_t		 src_len;
+	size_t		 src_pos;
+	int		 src_end;	/* no more after src */
+	char		*decoded;
+};
+
+void	input_buf(struct input *, const char *, size_t);
+void	input_read(struct input *, size_t (*)(void *, char *, size_t),
+	    void *);
+void	input_file(struct input *, FILE *);
+int	input_fill(struct input *);
+size_t	input_ahead(struct input *);
+char	*input_utf8(struct input *, const char **, size_t *);
+void	input_free(struct input *);
+
+/*
+ * Returns the next byte as an unsigned char, or EOF.
+ */
+#define INPUT_GETC(_in) ((_in)->pos < (_in)->len ? \
+	(unsigned char) (_in)->buf[(_in)->pos++] : input_fill(_in))
+
+/*
+ * Back up by one byte, only right after INPUT_GETC().
+ */
+#define INPUT_UNGETC(_in) ((_in)->pos--)
+
+#define INPUT_EOF(_in) ((_in)->pos == (_in)->len && (_in)->eof)
+
+#endif
+#line 27 "tokenize.h"
+#line 28 "tokenize.h"
+
+#include <stdio.h>
+
+typedef enum states STATE;
+
+struct tokenizer {
+	struct str name;
+	struct str attrib_name;
+	struct str attrib_value;
+
+	STATE state;
+	STATE return_state;
+
+	size_t line;
+	size_t offset;		/* bytes consumed */
+
+	struct token token;
+	struct attr_index attrs;	/* of the tag token */
+
+	char buf[16];
+	size_t buf_len;
+	const char *match;
+
+	int no_attrs;		/* drop attributes, e.g. when skipping */
+
+	struct report *report;	/* parse errors, or NULL */
+
+	struct input input;
+};
+
+struct token	*tokenize(struct tokenizer *ctx);
+
+#endif
+#line 1 "tagmap.h"
+
+#ifndef TAGMAP_H
+#define TAGMAP_H
+
+#line 1 "tags.h"
+/* generated by tags.awk */
+enum tagid {
+	TAG_NOFRAMES=3,
+	TAG_Q=9,
+	TAG_H5=21,
+	TAG_FRAMESET=23,
+	TAG_VAR=25,
+	TAG_ASIDE=30,
+	TAG_SLOT=50,
+	TAG_NAV=53,
+	TAG_FIGURE=58,
+	TAG_EM=59,
+	TAG_COMMENT_TAG=78,
+	TAG_SCRIPT=85,
+	TAG_EXCLAIM_TAG=86,
+	TAG_TR=87,
+	TAG_THEAD=94,
+	TAG_BR=100,
+	TAG_U=109,
+	TAG_ARTICLE=124,
+	TAG_CANVAS=140,
+	TAG_WBR=147,
+	TAG_METER=149,
+	TAG_LINK=158,
+	TAG_TIME=159,
+	TAG_PLAINTEXT=169,
+	TAG_COLGROUP=179,
+	TAG_TFOOT=180,
+	TAG_TITLE=186,
+	TAG_KBD=201,
+	TAG_H2=202,
+	TAG_OUTPUT=203,
+	TAG_IMG=221,
+	TAG_DIALOG=224,
+	TAG_AUDIO=226,
+	TAG_CODE=235,
+	TAG_STRONG=237,
+	TAG_TD=248,
+	TAG_DATA=250,
+	TAG_BODY=254,
+	TAG_CENTER=265,
+	TAG_TABLE=272,
+	TAG_CAPTION=286,
+	TAG_PRE=287,
+	TAG_BASE=299,
+	TAG_H6=302,
+	TAG_SVG=304,
+	TAG_OPTGROUP=305,
+	TAG_STRIKE=306,
+	TAG_BASEFONT=314,
+	TAG_RP=322,
+	TAG_DFN=328,
+	TAG_SECTION=333,
+	TAG_AREA=337,
+	TAG_MENU=341,
+	TAG_TH=348,
+	TAG_BDO=365,
+	TAG_FORM=388,
+	TAG_MATH=402,
+	TAG_MAP=406,
+	TAG_STYLE=409,
+	TAG_HEADER=417,
+	TAG_BGSOUND=418,
+	TAG_RT=422,
+	TAG_BLOCKQUOTE=425,
+	TAG_PARAM=426,
+	TAG_APPLET=454,
+	TAG_FRAME=459,
+	TAG_TBODY=466,
+	TAG_CUSTOM_TAG=478,
+	TAG_LABEL=480,
+	TAG_H3=483,
+	TAG_RB=484,
+	TAG_DD=488,
+	TAG_ACRONYM=505,
+	TAG_META=519,
+	TAG_SUMMARY=526,
+	TAG_ABBR=535,
+	TAG_HTML=549,
+	TAG_OBJECT=559,
+	TAG_UL=561,
+	TAG_S=571,
+	TAG_NOSCRIPT=586,
+	TAG_FIGCAPTION=588,
+	TAG_RUBY=610,
+	TAG_DATALIST=622,
+	TAG_A=633,
+	TAG_INS=634,
+	TAG_TT=648,
+	TAG_SAMP=649,
+	TAG_SUP=672,
+	TAG_DEL=677,
+	TAG_MARQUEE=680,
+	TAG_DL=688,
+	TAG_INPUT=696,
+	TAG_HGROUP=709,
+	TAG_BDI=727,
+	TAG_BIG=730,
+	TAG_LI=749,
+	TAG_P=752,
+	TAG_NOBR=761,
+	TAG_H4=764,
+	TAG_DIR=767,
+	TAG_IFRAME=772,
+	TAG_COL=774,
+	TAG_HR=778,
+	TAG_NOEMBED=786,
+	TAG_SELECT=800,
+	TAG_TEMPLATE=820,
+	TAG_PROGRESS=829,
+	TAG_I=833,
+	TAG_SUB=834,
+	TAG_XMP=837,
+	TAG_SMALL=841,
+	TAG_MAIN=845,
+	TAG_FIELDSET=848,
+	TAG_DIV=867,
+	TAG_KEYGEN=868,
+	TAG_FONT=879,
+	TAG_OPTION=881,
+	TAG_DT=888,
+	TAG_TEXTAREA=894,
+	TAG_HEAD=906,
+	TAG_OL=907,
+	TAG_B=914,
+	TAG_SPAN=915,
+	TAG_BUTTON=916,
+	TAG_TRACK=917,
+	TAG_FOOTER=919,
+	TAG_LISTING=930,
+	TAG_DETAILS=934,
+	TAG_H1=945,
+	TAG_PICTURE=948,
+	TAG_SOURCE=961,
+	TAG_CITE=965,
+	TAG_EMBED=981,
+	TAG_RTC=993,
+	TAG_ADDRESS=1006,
+	TAG_MARK=1019,
+	TAG_VIDEO=1023,
+};
+#line 23 "tagmap.h"
+
+#define TAGMAP_SZ 1024		/* tag ids are below */
+
+typedef enum tag_flags {
+	TAG_EMPTY = (1 << 0),
+	TAG_OPTIONAL_CLOSE = (1 << 1),
+	TAG_BLOCK = (1 << 2),
+	TAG_SPECIAL = (1 << 3),
+	TAG_HEADING = (1 << 4),
+	TAG_FORMAT = (1 << 5),
+	TAG_PREFORMATTED = (1 << 6),
+	TAG_RAWTEXT = (1 << 7)
+} TAG_FLAGS;
+
+struct tag {
+	char *name;
+	unsigned char flags;
+};
+
+int			 tagmap_id(const char *);
+const struct tag	*tagmap(int);
+
+#endif
+#line 1 "elem.h"
+
+#ifndef ELEM_H
+#define ELEM_H
+
+#include <stddef.h>
+
+struct node;
+struct token;
+struct attr;
+
+enum elem_ns {
+	NS_HTML,
+	NS_MATHML,
+	NS_SVG,
+	NS_XLINK,
+	NS_XML,
+	NS_XMLNS
+};
+
+struct elem {
+	int		 tagid;
+	char		*name;
+	struct attr	*attr;
+	struct node	*node;	/* back reference, can be NULL */
+	int		 ns;
+	int		 shared_name;	/* interned, see attr_pool_name() */
+};
+
+struct elem	*elem_create_from_token(struct token *token);
+struct elem	*elem_create(const char *name);
+int		 elem_has_attr(struct elem *, const char *);
+const char	*elem_attr_value(struct elem *, const char *);
+void		 elem_set_attr(struct elem *, const char *, const char *);
+
+struct elem	*elem_copy(struct elem *);
+void		 elem_clear(struct elem *);
+
+size_t elem_size(struct elem *);
+void elem_free(struct elem *);
+
+#endif
+#line 1 "stats.h"
+
+#ifndef STATS_H
+#define STATS_H
+
+#line 23 "stats.h"
+#line 24 "stats.h"
+#line 1 "allocs.h"
+/* generated by enum.awk */
+#ifndef ALLOCS_H
+#define ALLOCS_H
+enum allocs {
+	ALLOC_ELEM,
+	ALLOC_ATTR,
+	ALLOC_CDATA,
+	ALLOC_NODE,
+	ALLOC_DOCUMENT,
+	ALLOC_TOKEN,
+	ALLOC_STR,
+	ALLOC_OSTACK,
+	ALLOC_VIEW,
+	ALLOC_INPUT,
+	NALLOCS
+};
+#endif
+#line 25 "stats.h"
+
+#include <stddef.h>
+
+/*
+ * Counters of the hot paths of the tokenizer and the dispatcher. They
+ * are kept only if the library is built with -DPUREHTML_STATS, and are
+ * global and unsynchronized, so they are exact only when one thread
+ * parses at a time.
+ */
+struct purehtml_stats {
+	size_t	 bytes[NSTATES];	/* consumed in each state */
+	size_t	 reconsumes;
+	size_t	 tokens[NIMODES];	/* handled in each mode */
+	size_t	 scope_checks;		/* has_element_in_scope() calls */
+	size_t	 scope_scanned;		/* open elements looked at */
+	size_t	 allocs[NALLOCS];
+};
+
+#ifdef PUREHTML_STATS
+#define STATS_ADD(_field, _n)	(stats_counters._field += (_n))
+
+extern struct purehtml_stats	 stats_counters;
+#else
+#define STATS_ADD(_field, _n)	do { } while (0)
+#endif
+
+const struct purehtml_stats	*purehtml_stats(void);
+void				 purehtml_stats_reset(void);
+const char			*stats_state_name(int);
+const char			*stats_imode_name(int);
+const char			*stats_alloc_name(int);
+
+#endif
+#line 1 "inflate.h"
+
+#ifndef INFLATE_H
+#define INFLATE_H
+
+#include <stddef.h>
+
+#define INFLATE_WINDOW	32768
+#define INFLATE_IN	16384
+#define INFLATE_FAST	9		/* bits looked up at once */
+
+enum inflate_format {
+	INFLATE_AUTO = 0,
+	INFLATE_GZIP,			/* RFC 1952, may have many members */
+	INFLATE_ZLIB,			/* RFC 1950 */
+	INFLATE_RAW			/* RFC 1951 */
+};
+
+struct huff {
+	unsigned short	 count[16];	/* codes of each length */
+	unsigned short	 symbol[288];	/* symbols in canonical order */
+	unsigned short	 fast[1 << INFLATE_FAST]; /* symbol << 4 | length */
+};
+
+/*
+ * Streaming decoder for gzip, zlib and raw deflate data. It pulls the
+ * compressed bytes from a read callback, and inflate_read() is itself
+ * a read callback that can be given to purehtml_parse_read(). Memory
+ * use is bounded by the window.
+ */
+struct inflate {
+	size_t			(*read)(void *, char *, size_t);
+	void			*user;
+	enum inflate_format	 format;	/* detected if AUTO */
+	const char		*error;		/* set if the data is bad */
+
+	unsigned char		 in[INFLATE_IN];
+	size_t			 in_len;
+	size_t			 in_pos;
+	int			 in_eof;
+
+	unsigned long		 bits;
+	int			 nbits;
+	int			 pad;		/* zero bits past the end */
+
+	unsigned char		 window[INFLATE_WINDOW];
+	size_t			 total;		/* bytes out */
+	unsigned long		 size;		/* bytes out of this member */
+
+	int			 state;
+	int			 last;		/* in the final block */
+	size_t			 stored;	/* left in a stored block */
+	size_t			 copy;		/* left in a match */
+	size_t			 dist;
+
+	struct huff		 lens;
+	struct huff		 dists;
+
+	unsigned long		 check;		/* CRC-32 or Adler-32 */
+	unsigned long		 crc_table[256];
+};
+
+void	inflate_init(struct inflate *, size_t (*)(void *, char *, size_t),
+	    void *);
+size_t	inflate_read(void *, char *, size_t);
+
+#endif
+#line 1 "warc.h"
+
+#ifndef WARC_H
+#define WARC_H
+
+#line 23 "warc.h"
+#line 24 "warc.h"
+
+#include <stddef.h>
+
+struct inflate;
+
+/*
+ * A record of a WARC file. For HTTP responses the payload is the body
+ * with the HTTP headers skipped, chunked transfer coding removed and
+ * gzip or deflate content coding decompressed.
+ */
+struct warc_record {
+	char		*type;		/* WARC-Type */
+	char		*uri;		/* WARC-Target-URI */
+	int		 status;	/* HTTP status, 0 if not a response */
+	char		*content_type;	/* HTTP Content-Type */
+
+	char		*block;		/* record block */
+	size_t		 block_len;
+	char		*payload;
+	size_t		 payload_len;
+	char		*decoded;	/* payload if it was compressed */
+};
+
+/*
+ * Reads records one after another from a read callback, see input.h.
+ * For .warc.gz files, read through struct inflate.
+ */
+struct warc {
+	struct input	 in;
+	struct str	 line;
+	struct inflate	*inflate;	/* for content coding */
+	const char	*error;		/* set if the file is bad */
+};
+
+void	warc_init(struct warc *, size_t (*)(void *, char *, size_t), void *);
+int	warc_next(struct warc *, struct warc_record *);
+int	warc_is_html(struct warc_record *);
+void	warc_record_free(struct warc_record *);
+void	warc_free(struct warc *);
+
+#endif
+#line 1 "tokenlog.h"
+
+#ifndef TOKENLOG_H
+#define TOKENLOG_H
+
+#line 23 "tokenlog.h"
+#line 24 "tokenlog.h"
+#line 25 "tokenlog.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+#define TOKENLOG_MAGIC	"PHTL\001"
+#define TOKENLOG_RUN	0x40		/* record of character tokens */
+
+/*
+ * Binary log of the tokens given to dispatch(), each with the state it
+ * asked the tokenizer to switch to, for running the dispatcher without
+ * the tokenizer, see purehtml_replay(). The format is in tokenlog.c.
+ *
+ * A log is either written to a stream with tokenlog_put() and
+ * tokenlog_put_state() after tokenlog_record(), or read from a read
+ * callback, see input.h, with tokenlog_get() after tokenlog_init().
+ * When writing, tokenlog_free() writes what is still pending.
+ */
+struct tokenlog {
+	FILE		*out;		/* when recording */
+	struct input	 in;		/* when replaying */
+	struct token	 token;		/* last one read */
+	struct str	 run;		/* characters not written yet */
+	size_t		 run_left;	/* characters not read yet */
+	size_t		 line;		/* of the previous token */
+	size_t		 offset;
+	size_t		 tokens;
+	int		 started;	/* magic read */
+	const char	*error;		/* set if the log is bad */
+};
+
+void		 tokenlog_record(struct tokenlog *, FILE *);
+void		 tokenlog_put(struct tokenlog *, struct token *);
+void		 tokenlog_put_state(struct tokenlog *, int);
+void		 tokenlog_init(struct tokenlog *,
+		    size_t (*)(void *, char *, size_t), void *);
+struct token	*tokenlog_get(struct tokenlog *, int *);
+void		 tokenlog_free(struct tokenlog *);
+
+#endif
+#line 1 "attrs.h"
+/* generated by attrs.awk */
+enum attrid {
+	ATTR_ACCESSKEY=3,
+	ATTR_REQUIRED=17,
+	ATTR_ID=29,
+	ATTR_ONKEYDOWN=30,
+	ATTR_ONAUXCLICK=33,
+	ATTR_SLOT=50,
+	ATTR_ONCOPY=72,
+	ATTR_HEIGHT=73,
+	ATTR_ONEMPTIED=93,
+	ATTR_ONWAITING=104,
+	ATTR_ONFORMDATA=123,
+	ATTR_SIZE=124,
+	ATTR_IS=148,
+	ATTR_CLASS=158,
+	ATTR_ONDRAGSTART=169,
+	ATTR_ONCANPLAY=173,
+	ATTR_ONLOADEDMETADATA=175,
+	ATTR_ONCONTEXTLOST=180,
+	ATTR_LIST=181,
+	ATTR_TITLE=186,
+	ATTR_ONBEFOREMATCH=189,
+	ATTR_READONLY=190,
+	ATTR_ONPAUSE=195,
+	ATTR_DECODING=205,
+	ATTR_ONSTALLED=206,
+	ATTR_ONBLUR=210,
+	ATTR_ONMOUSEOVER=211,
+	ATTR_ONDRAGEND=218,
+	ATTR_ONCLICK=227,
+	ATTR_REFERRERPOLICY=229,
+	ATTR_INERT=258,
+	ATTR_NAME=273,
+	ATTR_ONVOLUMECHANGE=283,
+	ATTR_ONCANPLAYTHROUGH=286,
+	ATTR_ONCONTEXTMENU=287,
+	ATTR_ONPASTE=290,
+	ATTR_ONSEEKING=315,
+	ATTR_USEMAP=316,
+	ATTR_SIZES=318,
+	ATTR_CONTENTEDITABLE=333,
+	ATTR_ONERROR=359,
+	ATTR_ONKEYUP=387,
+	ATTR_ONRATECHANGE=391,
+	ATTR_ONDURATIONCHANGE=393,
+	ATTR_ONCLOSE=403,
+	ATTR_STYLE=409,
+	ATTR_ONENDED=413,
+	ATTR_ONPROGRESS=442,
+	ATTR_AUTOCOMPLETE=458,
+	ATTR_COLSPAN=472,
+	ATTR_SPELLCHECK=502,
+	ATTR_ONDRAGLEAVE=504,
+	ATTR_ONPLAY=507,
+	ATTR_PATTERN=518,
+	ATTR_ONKEYPRESS=523,
+	ATTR_ONMOUSEMOVE=525,
+	ATTR_ONCUT=537,
+	ATTR_ONTOGGLE=551,
+	ATTR_DIRNAME=560,
+	ATTR_ONBEFOREINPUT=576,
+	ATTR_ONDBLCLICK=589,
+	ATTR_ONSEEKED=590,
+	ATTR_ONINVALID=596,
+	ATTR_ONMOUSEUP=603,
+	ATTR_MAX=606,
+	ATTR_TABINDEX=607,
+	ATTR_ALT=617,
+	ATTR_PLACEHOLDER=619,
+	ATTR_MULTIPLE=620,
+	ATTR_ONRESET=624,
+	ATTR_ONDRAGENTER=641,
+	ATTR_TYPE=642,
+	ATTR_ONCONTEXTRESTORED=650,
+	ATTR_ONINPUT=653,
+	ATTR_ONRESIZE=663,
+	ATTR_TRANSLATE=670,
+	ATTR_ONWHEEL=682,
+	ATTR_ONCANCEL=707,
+	ATTR_HIDDEN=708,
+	ATTR_ISMAP=714,
+	ATTR_ONSCROLL=716,
+	ATTR_ONTIMEUPDATE=719,
+	ATTR_MAXLENGTH=720,
+	ATTR_ONSECURITYPOLICYVIOLATION=722,
+	ATTR_ITEMREF=732,
+	ATTR_WIDTH=744,
+	ATTR_MIN=748,
+	ATTR_ONFOCUS=757,
+	ATTR_DISABLED=760,
+	ATTR_DIR=767,
+	ATTR_DRAGGABLE=769,
+	ATTR_CROSSORIGIN=770,
+	ATTR_SRC=776,
+	ATTR_ITEMPROP=792,
+	ATTR_ONPLAYING=801,
+	ATTR_ONMOUSELEAVE=803,
+	ATTR_REL=804,
+	ATTR_ONCUECHANGE=816,
+	ATTR_ROWSPAN=818,
+	ATTR_ONMOUSEOUT=822,
+	ATTR_ITEMTYPE=825,
+	ATTR_ONLOADSTART=827,
+	ATTR_SRCSET=828,
+	ATTR_AUTOFOCUS=833,
+	ATTR_ONLOADEDDATA=840,
+	ATTR_INPUTMODE=877,
+	ATTR_ONMOUSEDOWN=886,
+	ATTR_ONLOAD=901,
+	ATTR_CONTENT=923,
+	ATTR_ONSUBMIT=929,
+	ATTR_AUTOCAPITALIZE=935,
+	ATTR_ENTERKEYHINT=938,
+	ATTR_ONMOUSEENTER=940,
+	ATTR_STEP=941,
+	ATTR_ONCHANGE=955,
+	ATTR_MINLENGTH=958,
+	ATTR_ITEMID=964,
+	ATTR_ONSUSPEND=991,
+	ATTR_ONDRAG=995,
+	ATTR_ONSELECT=1005,
+	ATTR_ONSLOTCHANGE=1006,
+	ATTR_ONDRAGOVER=1007,
+	ATTR_ITEMSCOPE=1009,
+	ATTR_LANG=1010,
+	ATTR_ONDROP=1011,
+	ATTR_HEADERS=1012,
+	ATTR_HREF=1013,
+	ATTR_LOADING=1014,
+	ATTR_NONCE=1019,
+};
+#line 1 "purehtml.h"
+
+#ifndef PUREHTML_H
+#define PUREHTML_H
+
+#line 23 "purehtml.h"
+#line 24 "purehtml.h"
+#line 25 "purehtml.h"
+#line 26 "purehtml.h"
+
+#include <stdio.h>
+
+struct node;
+
+/*
+ * Where the time of the serial parsers goes, filled if ctx->perf is
+ * set. One call in PERF_SAMPLE of tokenize() and dispatch() is timed
+ * and the times are scaled up, less the cost of reading the clock.
+ * The dispatch time includes the callbacks. Everything accumulates
+ * over parses.
+ */
+#define PERF_SAMPLE	32
+
+struct purehtml_perf {
+	double		 tokenize;	/* seconds */
+	double		 dispatch;	/* seconds */
+	double		 clock;		/* seconds per clock read */
+	size_t		 tokens;
+	size_t		 max_depth;	/* of open elements */
+};
+
+/*
+ * Convenience driver that ties the tokenizer and the dispatcher
+ * together and runs the tokenize() -> dispatch() loop.
+ */
+struct purehtml {
+	struct tokenizer	 tokenizer;
+	struct dispatcher	 dispatcher;
+	struct document		 document;
+	struct report		 report;	/* parse errors */
+	struct attr_pool	 attr_pool;	/* see purehtml_reset() */
+	struct purehtml_perf	*perf;		/* optional */
+	struct tokenlog		*record;	/* optional, see tokenlog.h */
+
+	size_t			 lost;		/* see purehtml_parse() */
+	void			*map;		/* see purehtml_parse_file() */
+	size_t			 map_len;
+};
+
+size_t	purehtml_parse(struct purehtml *, FILE *, int (*)(struct node *),
+	    int (*)(struct node *));
+size_t	purehtml_parse_buf(struct purehtml *, const char *, size_t,
+	    int (*)(struct node *), int (*)(struct node *));
+size_t	purehtml_parse_file(struct purehtml *, const char *,
+	    int (*)(struct node *), int (*)(struct node *));
+size_t	purehtml_parse_read(struct purehtml *,
+	    size_t (*)(void *, char *, size_t), void *,
+	    int (*)(struct node *), int (*)(struct node *));
+size_t	purehtml_parse_pipelined(struct purehtml *, FILE *,
+	    int (*)(struct node *), int (*)(struct node *));
+size_t	purehtml_parse_speculative(struct purehtml *, const char *, size_t,
+	    int, int (*)(struct node *), int (*)(struct node *));
+size_t	purehtml_replay(struct purehtml *, struct tokenlog *,
+	    int (*)(struct node *), int (*)(struct node *));
+void	purehtml_reset(struct purehtml *);
+void	purehtml_free(struct purehtml *);
+
+#endif
+#line 1 "batch.h"
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#line 23 "batch.h"
+
+#include <stddef.h>
+
+struct node;
+
+/*
+ * A document to parse with purehtml_batch(), either a file or a
+ * buffer.
+ */
+struct purehtml_doc {
+	const char	*path;		/* file to parse, or NULL */
+	const char	*buf;		/* buffer to parse if path is NULL */
+	size_t		 len;
+	int		 charset;	/* ENCODING_* if known, e.g. */
+					/* from a Content-Type header */
+	void		*user;
+
+	/*
+	 * Filled in while parsing.
+	 */
+	struct purehtml	*ctx;		/* parser of the document */
+	size_t		 consumed;	/* bytes parsed */
+	int		 error;		/* errno if the file did not open */
+};
+
+/*
+ * The callbacks get called concurrently from the worker threads, each
+ * of which owns a parser that is reused for all its documents. Use
+ * purehtml_batch_doc() in begin and end to find out the document.
+ */
+struct purehtml_batch {
+	int	 nthreads;		/* online CPUs if zero */
+
+	int	(*begin)(struct node *);
+	int	(*end)(struct node *);
+	void	(*init)(struct purehtml *);	/* optional, set options */
+	void	(*done)(struct purehtml_doc *);	/* optional, result */
+};
+
+size_t			 purehtml_batch(struct purehtml_batch *,
+			    struct purehtml_doc *, size_t);
+struct purehtml_doc	*purehtml_batch_doc(void);
+
+#endif
+#endif
@@ -17,12 +17,15 @@
  */
 
 #include "attr.h"
+#include "stats.h"
+#include "util.h"
 
 #include <stdlib.h>
 #include <string.h>
 #include <err.h>
 #include <assert.h>
 #include <strings.h>
+#include <ctype.h>
 
 #include "attrs.c"
 
@@ -91,6 +94,70 @@ attr_size(struct attr *attr)
 	return sum;
 }
 
+static struct attr *
+attr_new(struct attr **head)
+{
+	struct attr *attr;
+
+	attr = mem_calloc(1, sizeof(struct attr));
+	if (attr == NULL)
+		err(1, "calloc attr");
+	STATS_ADD(allocs[ALLOC_ATTR], 1);
+	attr->next = (*head);
+	*head = attr;
+	return attr;
+}
+
+/*
+ * An attribute of the pool if there is one, or a new one.
+ */
+static struct attr *
+attr_take(struct attr_index *index, struct attr **head)
+{
+	struct attr *attr;
+
+	if (index->pool == NULL || (attr = index->pool->free) == NULL)
+		return attr_new(head);
+
+	index->pool->free = attr->next;
+	attr->next = (*head);
+	*head = attr;
+	return attr;
+}
+
+/*
+ * Copy s to the buffer *p of *size bytes, replacing it if too small.
+ */
+static void
+attr_copy_str(char **p, size_t *size, const char *s)
+{
+	size_t len;
+
+	len = strlen(s) + 1;
+	if (len > *size) {
+		mem_free(*p);
+		if ((*p = mem_malloc(len)) == NULL)
+			err(1, "malloc attr");
+		STATS_ADD(allocs[ALLOC_ATTR], 1);
+		*size = len;
+	}
+	memcpy(*p, s, len);
+}
+
+static void
+attr_assign(struct attr *attr, const char *name, const char *value)
+{
+	attr_copy_str(&attr->name, &attr->name_size, name);
+
+	if (value != NULL)
+		attr_copy_str(&attr->value, &attr->value_size, value);
+	else {
+		mem_free(attr->value);
+		attr->value = NULL;
+		attr->value_size = 0;
+	}
+}
+
 void
 attr_set(struct attr **head, const char *name, const char *value)
 {
@@ -98,32 +165,153 @@ attr_set(struct attr **head, const char *name, const char *value)
 
 	assert(name != NULL && *name != '\0');
 
-	attr = attr_get(*head, name);
-	if (attr == NULL) {
-		attr = calloc(1, sizeof(struct attr));
-		if (attr == NULL)
-			err(1, "calloc attr");
-		attr->next = (*head);
-		*head = attr;
-	}
+	if ((attr = attr_get(*head, name)) == NULL)
+		attr = attr_new(head);
+	attr_assign(attr, name, value);
+}
+
+static size_t
+attr_hash(const char *name)
+{
+	size_t h;
 
-	if (attr->name != NULL) {
-		free(attr->name);
-		attr->name = NULL;
+	h = 2166136261u;
+	while (*name != '\0') {
+		h ^= (unsigned char) tolower((unsigned char) *name++);
+		h *= 16777619u;
 	}
-	attr->name = strdup(name);
-	if (attr->name == NULL)
-		err(1, "strdup attr name");
+	return h;
+}
 
-	if (attr->value != NULL) {
-		free(attr->value);
-		attr->value = NULL;
+/*
+ * Slot of the given name, or the empty slot where it would go.
+ */
+static struct attr **
+attr_index_slot(struct attr_index *index, const char *name)
+{
+	size_t i;
+
+	i = attr_hash(name) & (index->alloc - 1);
+	while (index->slots[i] != NULL &&
+	    strcasecmp(index->slots[i]->name, name) != 0)
+		i = (i + 1) & (index->alloc - 1);
+	return &index->slots[i];
+}
+
+static void
+attr_index_build(struct attr_index *index, struct attr *head, size_t alloc)
+{
+	if (alloc != index->alloc) {
+		mem_free(index->slots);
+		index->alloc = alloc;
+		index->slots = mem_calloc(alloc, sizeof(struct attr *));
+		if (index->slots == NULL)
+			err(1, "calloc attr index");
+		STATS_ADD(allocs[ALLOC_ATTR], 1);
+	} else
+		memset(index->slots, 0, alloc * sizeof(struct attr *));
+
+	for (; head != NULL; head = head->next)
+		*attr_index_slot(index, head->name) = head;
+}
+
+/*
+ * Like attr_set() on a list that only gets attributes through the
+ * index until attr_index_clear().
+ */
+void
+attr_index_set(struct attr_index *index, struct attr **head,
+    const char *name, const char *value)
+{
+	struct attr **slot;
+	struct attr *attr;
+
+	assert(name != NULL && *name != '\0');
+
+	if (index->n < ATTR_INDEX_MIN) {
+		if ((attr = attr_get(*head, name)) == NULL) {
+			attr = attr_take(index, head);
+			index->n++;
+		}
+		attr_assign(attr, name, value);
+		if (index->n == ATTR_INDEX_MIN)
+			attr_index_build(index, *head, index->alloc ?
+			    index->alloc : ATTR_INDEX_MIN * 4);
+		return;
 	}
-	if (value != NULL) {
-		attr->value = strdup(value);
-		if (attr->value == NULL)
-			err(1, "strdup attr value");
+
+	if (index->n * 2 >= index->alloc)
+		attr_index_build(index, *head, index->alloc * 2);
+	slot = attr_index_slot(index, name);
+	if (*slot == NULL) {
+		*slot = attr_take(index, head);
+		index->n++;
 	}
+	attr_assign(*slot, name, value);
+}
+
+void
+attr_index_clear(struct attr_index *index)
+{
+	if (index->n >= ATTR_INDEX_MIN)
+		memset(index->slots, 0, index->alloc * sizeof(struct attr *));
+	index->n = 0;
+}
+
+void
+attr_index_free(struct attr_index *index)
+{
+	mem_free(index->slots);
+	memset(index, 0, sizeof(struct attr_index));
+}
+
+/*
+ * Give back a list of attributes for attr_index_set() to take.
+ */
+void
+attr_pool_put(struct attr_pool *pool, struct attr *attr)
+{
+	struct attr *tail;
+
+	if (attr == NULL)
+		return;
+	for (tail = attr; tail->next != NULL; tail = tail->next)
+		;
+	tail->next = pool->free;
+	pool->free = attr;
+}
+
+/*
+ * The interned copy of a custom tag name, kept until attr_pool_free(),
+ * or NULL if the pool has no room for another one.
+ */
+char *
+attr_pool_name(struct attr_pool *pool, const char *name)
+{
+	struct attr *attr;
+
+	if (*name == '\0')
+		return NULL;
+	if (pool->index.n < ATTR_INDEX_MIN)
+		attr = attr_get(pool->names, name);
+	else
+		attr = *attr_index_slot(&pool->index, name);
+	if (attr != NULL)
+		return attr->name;
+
+	if (pool->index.n >= ATTR_POOL_NAMES)
+		return NULL;
+	attr_index_set(&pool->index, &pool->names, name, NULL);
+	return pool->names->name;
+}
+
+void
+attr_pool_free(struct attr_pool *pool)
+{
+	attr_free(pool->free);
+	attr_free(pool->names);
+	attr_index_free(&pool->index);
+	memset(pool, 0, sizeof(struct attr_pool));
 }
 
 int
@@ -135,6 +323,52 @@ attr_has(struct attr *head, const char *name)
 	return 1;
 }
 
+/*
+ * Deep copy of the list, preserving order.
+ */
+struct attr *
+attr_copy(struct attr *attr)
+{
+	struct attr *head;
+	struct attr **tail;
+
+	head = NULL;
+	tail = &head;
+	while (attr != NULL) {
+		*tail = mem_calloc(1, sizeof(struct attr));
+		if (*tail == NULL)
+			err(1, "calloc attr");
+		if (attr->name != NULL &&
+		    ((*tail)->name = mem_strdup(attr->name)) == NULL)
+			err(1, "strdup attr name");
+		if (attr->value != NULL &&
+		    ((*tail)->value = mem_strdup(attr->value)) == NULL)
+			err(1, "strdup attr value");
+		STATS_ADD(allocs[ALLOC_ATTR], 1 + (attr->name != NULL) +
+		    (attr->value != NULL));
+		tail = &(*tail)->next;
+		attr = attr->next;
+	}
+
+	return head;
+}
+
+void
+attr_free(struct attr *attr)
+{
+	struct attr *next;
+
+	while (attr != NULL) {
+		if (attr->name != NULL)
+			mem_free(attr->name);
+		if (attr->value != NULL)
+			mem_free(attr->value);
+		next = attr->next;
+		mem_free(attr);
+		attr = next;
+	}
+}
+
 #ifdef TEST
 #include <stdio.h>
 int main(int argc, char **argv)
@@ -155,6 +389,155 @@ int main(int argc, char **argv)
 		assert(attr_has(head, "src") == 0);
 	}
 
+	{
+		struct attr *head = NULL, *copy;
+
+		attr_set(&head, "href", "foo");
+		attr_set(&head, "alt", NULL);
+		copy = attr_copy(head);
+		assert(strcmp(copy->name, head->name) == 0);
+		assert(copy->value == NULL);
+		assert(strcmp(copy->next->value, "foo") == 0);
+		attr_free(head);
+		attr_free(copy);
+	}
+
+	{
+		struct attr_index index = { 0 };
+		struct attr *head, *attr;
+		char name[16], value[16];
+		int i, j, n;
+
+		/*
+		 * Twice, the second time on a cleared index.
+		 */
+		for (j = 0; j < 2; j++) {
+			head = NULL;
+			for (i = 0; i < 100; i++) {
+				snprintf(name, sizeof(name), "a%d", i % 40);
+				snprintf(value, sizeof(value), "%d", i);
+				attr_index_set(&index, &head, name, value);
+			}
+			attr_index_set(&index, &head, "A7", NULL);
+			for (n = 0, attr = head; attr != NULL; attr = attr->next)
+				n++;
+			assert(n == 40);
+			assert(strcmp(attr_get(head, "a39")->value, "79") == 0);
+			assert(strcmp(attr_get(head, "a0")->value, "80") == 0);
+			assert(attr_get(head, "a7")->value == NULL);
+			attr_free(head);
+			attr_index_clear(&index);
+		}
+		attr_index_free(&index);
+	}
+
+	{
+		struct attr_pool pool = { 0 };
+		struct attr_index index = { 0 };
+		struct attr *head, *taken;
+		char name[16];
+		char *p;
+		int i;
+
+		/*
+		 * Given back attributes are taken again, buffers and all.
+		 */
+		index.pool = &pool;
+		head = NULL;
+		attr_index_set(&index, &head, "href", "longer value");
+		taken = head;
+		p = head->value;
+		attr_pool_put(&pool, head);
+		attr_index_clear(&index);
+		head = NULL;
+		attr_index_set(&index, &head, "id", "short");
+		assert(head == taken && head->value == p);
+		assert(strcmp(head->name, "id") == 0 && pool.free == NULL);
+		attr_pool_put(&pool, head);
+
+		p = attr_pool_name(&pool, "my-tag");
+		assert(strcmp(p, "my-tag") == 0);
+		assert(attr_pool_name(&pool, "my-tag") == p);
+		assert(attr_pool_name(&pool, "") == NULL);
+		for (i = 0; i < ATTR_POOL_NAMES; i++) {
+			snprintf(name, sizeof(name), "x-%d", i);
+			attr_pool_name(&pool, name);
+		}
+		assert(attr_pool_name(&pool, "my-tag") == p);
+		assert(attr_pool_name(&pool, "x-last") == NULL);
+		attr_pool_free(&pool);
+		attr_index_free(&index);
+	}
+
+	return 0;
+}
+#endif
+
+#ifdef BENCH
+#include <stdio.h>
+#include <time.h>
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * attr_set() of n distinct names and attr_get() of the first name set,
+ * which is the last one in the list, and of a name not in the list.
+ */
+int
+main(int argc, char **argv)
+{
+	static const size_t counts[] = { 1, 4, 16, 64, 256 };
+	static volatile size_t sink;
+	char names[256][8], name[32];
+	struct attr *head;
+	size_t i, j, n, reps;
+	double start, set, get, miss;
+
+	for (i = 0; i < 256; i++)
+		snprintf(names[i], sizeof(names[i]), "a%zu", i);
+
+	for (i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+		reps = 2000000 / (counts[i] * counts[i]) + 100;
+
+		start = now();
+		for (j = 0; j < reps; j++) {
+			head = NULL;
+			for (n = 0; n < counts[i]; n++)
+				attr_set(&head, names[n], "v");
+			attr_free(head);
+		}
+		set = (now() - start) / (reps * counts[i]);
+
+		head = NULL;
+		for (n = 0; n < counts[i]; n++)
+			attr_set(&head, names[n], "v");
+		reps *= counts[i];
+		start = now();
+		for (j = 0; j < reps; j++)
+			sink += (attr_get(head, names[0]) != NULL);
+		get = (now() - start) / reps;
+		start = now();
+		for (j = 0; j < reps; j++)
+			sink += (attr_get(head, "none") != NULL);
+		miss = (now() - start) / reps;
+		attr_free(head);
+
+		snprintf(name, sizeof(name), "attr_set with %zu", counts[i]);
+		printf("%-32s%8.1f ns/op\n", name, set * 1e9);
+		snprintf(name, sizeof(name), "attr_get with %zu", counts[i]);
+		printf("%-32s%8.1f ns/op\n", name, get * 1e9);
+		snprintf(name, sizeof(name), "attr_get miss with %zu",
+		    counts[i]);
+		printf("%-32s%8.1f ns/op\n", name, miss * 1e9);
+	}
+
 	return 0;
 }
 #endif
@@ -26,6 +26,8 @@ struct attr
 	char *name;
 	char *value;
 	struct attr *next;
+	size_t name_size;		/* of the buffers, if known */
+	size_t value_size;
 };
 
 struct attr_map {
@@ -38,9 +40,47 @@ enum ATTR_FLAG {
 	ATTR_FLAG_EVENT = (1 << 1),
 };
 
+/*
+ * Hash index of the names of a list being built, so that the duplicate
+ * check of attr_index_set() does not walk the list. Lists shorter than
+ * ATTR_INDEX_MIN are walked as by attr_set().
+ */
+#define ATTR_INDEX_MIN 8
+
+struct attr_index {
+	struct attr **slots;
+	size_t alloc;			/* power of two */
+	size_t n;			/* attributes in the list */
+	struct attr_pool *pool;		/* to take attributes from, or NULL */
+};
+
+/*
+ * Attributes given back once a parser is done with them, taken again
+ * with their name and value buffers, and the names of the custom tags
+ * seen so far, up to ATTR_POOL_NAMES of them. See purehtml_reset().
+ */
+#define ATTR_POOL_NAMES 256
+
+struct attr_pool {
+	struct attr *free;
+	struct attr *names;
+	struct attr_index index;	/* of the names */
+};
+
 struct attr *attr_get(struct attr *, const char *);
 void attr_set(struct attr **, const char *, const char *);
 int attr_has(struct attr *, const char *);
+struct attr *attr_copy(struct attr *);
+void attr_free(struct attr *);
+
+void attr_index_set(struct attr_index *, struct attr **, const char *,
+    const char *);
+void attr_index_clear(struct attr_index *);
+void attr_index_free(struct attr_index *);
+
+void attr_pool_put(struct attr_pool *, struct attr *);
+char *attr_pool_name(struct attr_pool *, const char *);
+void attr_pool_free(struct attr_pool *);
 
 size_t attr_size(struct attr *);
 
@@ -0,0 +1,1027 @@
+/* generated by attrs.awk */
+static const struct attr_map attr_map[] = {
+	{ NULL, 0 }, /* 0 */
+	{ NULL, 0 }, /* 1 */
+	{ NULL, 0 }, /* 2 */
+	{ "accesskey", ATTR_FLAG_GLOBAL }, /* 3 */
+	{ NULL, 0 }, /* 4 */
+	{ NULL, 0 }, /* 5 */
+	{ NULL, 0 }, /* 6 */
+	{ NULL, 0 }, /* 7 */
+	{ NULL, 0 }, /* 8 */
+	{ NULL, 0 }, /* 9 */
+	{ NULL, 0 }, /* 10 */
+	{ NULL, 0 }, /* 11 */
+	{ NULL, 0 }, /* 12 */
+	{ NULL, 0 }, /* 13 */
+	{ NULL, 0 }, /* 14 */
+	{ NULL, 0 }, /* 15 */
+	{ NULL, 0 }, /* 16 */
+	{ "required", 0 }, /* 17 */
+	{ NULL, 0 }, /* 18 */
+	{ NULL, 0 }, /* 19 */
+	{ NULL, 0 }, /* 20 */
+	{ NULL, 0 }, /* 21 */
+	{ NULL, 0 }, /* 22 */
+	{ NULL, 0 }, /* 23 */
+	{ NULL, 0 }, /* 24 */
+	{ NULL, 0 }, /* 25 */
+	{ NULL, 0 }, /* 26 */
+	{ NULL, 0 }, /* 27 */
+	{ NULL, 0 }, /* 28 */
+	{ "id", ATTR_FLAG_GLOBAL }, /* 29 */
+	{ "onkeydown", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 30 */
+	{ NULL, 0 }, /* 31 */
+	{ NULL, 0 }, /* 32 */
+	{ "onauxclick", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 33 */
+	{ NULL, 0 }, /* 34 */
+	{ NULL, 0 }, /* 35 */
+	{ NULL, 0 }, /* 36 */
+	{ NULL, 0 }, /* 37 */
+	{ NULL, 0 }, /* 38 */
+	{ NULL, 0 }, /* 39 */
+	{ NULL, 0 }, /* 40 */
+	{ NULL, 0 }, /* 41 */
+	{ NULL, 0 }, /* 42 */
+	{ NULL, 0 }, /* 43 */
+	{ NULL, 0 }, /* 44 */
+	{ NULL, 0 }, /* 45 */
+	{ NULL, 0 }, /* 46 */
+	{ NULL, 0 }, /* 47 */
+	{ NULL, 0 }, /* 48 */
+	{ NULL, 0 }, /* 49 */
+	{ "slot", ATTR_FLAG_GLOBAL }, /* 50 */
+	{ NULL, 0 }, /* 51 */
+	{ NULL, 0 }, /* 52 */
+	{ NULL, 0 }, /* 53 */
+	{ NULL, 0 }, /* 54 */
+	{ NULL, 0 }, /* 55 */
+	{ NULL, 0 }, /* 56 */
+	{ NULL, 0 }, /* 57 */
+	{ NULL, 0 }, /* 58 */
+	{ NULL, 0 }, /* 59 */
+	{ NULL, 0 }, /* 60 */
+	{ NULL, 0 }, /* 61 */
+	{ NULL, 0 }, /* 62 */
+	{ NULL, 0 }, /* 63 */
+	{ NULL, 0 }, /* 64 */
+	{ NULL, 0 }, /* 65 */
+	{ NULL, 0 }, /* 66 */
+	{ NULL, 0 }, /* 67 */
+	{ NULL, 0 }, /* 68 */
+	{ NULL, 0 }, /* 69 */
+	{ NULL, 0 }, /* 70 */
+	{ NULL, 0 }, /* 71 */
+	{ "oncopy", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 72 */
+	{ "height", 0 }, /* 73 */
+	{ NULL, 0 }, /* 74 */
+	{ NULL, 0 }, /* 75 */
+	{ NULL, 0 }, /* 76 */
+	{ NULL, 0 }, /* 77 */
+	{ NULL, 0 }, /* 78 */
+	{ NULL, 0 }, /* 79 */
+	{ NULL, 0 }, /* 80 */
+	{ NULL, 0 }, /* 81 */
+	{ NULL, 0 }, /* 82 */
+	{ NULL, 0 }, /* 83 */
+	{ NULL, 0 }, /* 84 */
+	{ NULL, 0 }, /* 85 */
+	{ NULL, 0 }, /* 86 */
+	{ NULL, 0 }, /* 87 */
+	{ NULL, 0 }, /* 88 */
+	{ NULL, 0 }, /* 89 */
+	{ NULL, 0 }, /* 90 */
+	{ NULL, 0 }, /* 91 */
+	{ NULL, 0 }, /* 92 */
+	{ "onemptied", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 93 */
+	{ NULL, 0 }, /* 94 */
+	{ NULL, 0 }, /* 95 */
+	{ NULL, 0 }, /* 96 */
+	{ NULL, 0 }, /* 97 */
+	{ NULL, 0 }, /* 98 */
+	{ NULL, 0 }, /* 99 */
+	{ NULL, 0 }, /* 100 */
+	{ NULL, 0 }, /* 101 */
+	{ NULL, 0 }, /* 102 */
+	{ NULL, 0 }, /* 103 */
+	{ "onwaiting", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 104 */
+	{ NULL, 0 }, /* 105 */
+	{ NULL, 0 }, /* 106 */
+	{ NULL, 0 }, /* 107 */
+	{ NULL, 0 }, /* 108 */
+	{ NULL, 0 }, /* 109 */
+	{ NULL, 0 }, /* 110 */
+	{ NULL, 0 }, /* 111 */
+	{ NULL, 0 }, /* 112 */
+	{ NULL, 0 }, /* 113 */
+	{ NULL, 0 }, /* 114 */
+	{ NULL, 0 }, /* 115 */
+	{ NULL, 0 }, /* 116 */
+	{ NULL, 0 }, /* 117 */
+	{ NULL, 0 }, /* 118 */
+	{ NULL, 0 }, /* 119 */
+	{ NULL, 0 }, /* 120 */
+	{ NULL, 0 }, /* 121 */
+	{ NULL, 0 }, /* 122 */
+	{ "onformdata", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 123 */
+	{ "size", 0 } /* jump 1 */, /* 124 */
+	{ NULL, 0 }, /* 125 */
+	{ NULL, 0 }, /* 126 */
+	{ NULL, 0 }, /* 127 */
+	{ NULL, 0 }, /* 128 */
+	{ NULL, 0 }, /* 129 */
+	{ NULL, 0 }, /* 130 */
+	{ NULL, 0 }, /* 131 */
+	{ NULL, 0 }, /* 132 */
+	{ NULL, 0 }, /* 133 */
+	{ NULL, 0 }, /* 134 */
+	{ NULL, 0 }, /* 135 */
+	{ NULL, 0 }, /* 136 */
+	{ NULL, 0 }, /* 137 */
+	{ NULL, 0 }, /* 138 */
+	{ NULL, 0 }, /* 139 */
+	{ NULL, 0 }, /* 140 */
+	{ NULL, 0 }, /* 141 */
+	{ NULL, 0 }, /* 142 */
+	{ NULL, 0 }, /* 143 */
+	{ NULL, 0 }, /* 144 */
+	{ NULL, 0 }, /* 145 */
+	{ NULL, 0 }, /* 146 */
+	{ NULL, 0 }, /* 147 */
+	{ "is", ATTR_FLAG_GLOBAL }, /* 148 */
+	{ NULL, 0 }, /* 149 */
+	{ NULL, 0 }, /* 150 */
+	{ NULL, 0 }, /* 151 */
+	{ NULL, 0 }, /* 152 */
+	{ NULL, 0 }, /* 153 */
+	{ NULL, 0 }, /* 154 */
+	{ NULL, 0 }, /* 155 */
+	{ NULL, 0 }, /* 156 */
+	{ NULL, 0 }, /* 157 */
+	{ "class", ATTR_FLAG_GLOBAL }, /* 158 */
+	{ NULL, 0 }, /* 159 */
+	{ NULL, 0 }, /* 160 */
+	{ NULL, 0 }, /* 161 */
+	{ NULL, 0 }, /* 162 */
+	{ NULL, 0 }, /* 163 */
+	{ NULL, 0 }, /* 164 */
+	{ NULL, 0 }, /* 165 */
+	{ NULL, 0 }, /* 166 */
+	{ NULL, 0 }, /* 167 */
+	{ NULL, 0 }, /* 168 */
+	{ "ondragstart", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 169 */
+	{ NULL, 0 }, /* 170 */
+	{ NULL, 0 }, /* 171 */
+	{ NULL, 0 }, /* 172 */
+	{ "oncanplay", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 173 */
+	{ NULL, 0 }, /* 174 */
+	{ "onloadedmetadata", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 175 */
+	{ NULL, 0 }, /* 176 */
+	{ NULL, 0 }, /* 177 */
+	{ NULL, 0 }, /* 178 */
+	{ NULL, 0 }, /* 179 */
+	{ "oncontextlost", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 180 */
+	{ "list", 0 } /* jump 1 */, /* 181 */
+	{ NULL, 0 }, /* 182 */
+	{ NULL, 0 }, /* 183 */
+	{ NULL, 0 }, /* 184 */
+	{ NULL, 0 }, /* 185 */
+	{ "title", ATTR_FLAG_GLOBAL }, /* 186 */
+	{ NULL, 0 }, /* 187 */
+	{ NULL, 0 }, /* 188 */
+	{ "onbeforematch", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 189 */
+	{ "readonly", 0 }, /* 190 */
+	{ NULL, 0 }, /* 191 */
+	{ NULL, 0 }, /* 192 */
+	{ NULL, 0 }, /* 193 */
+	{ NULL, 0 }, /* 194 */
+	{ "onpause", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 195 */
+	{ NULL, 0 }, /* 196 */
+	{ NULL, 0 }, /* 197 */
+	{ NULL, 0 }, /* 198 */
+	{ NULL, 0 }, /* 199 */
+	{ NULL, 0 }, /* 200 */
+	{ NULL, 0 }, /* 201 */
+	{ NULL, 0 }, /* 202 */
+	{ NULL, 0 }, /* 203 */
+	{ NULL, 0 }, /* 204 */
+	{ "decoding", 0 }, /* 205 */
+	{ "onstalled", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 206 */
+	{ NULL, 0 }, /* 207 */
+	{ NULL, 0 }, /* 208 */
+	{ NULL, 0 }, /* 209 */
+	{ "onblur", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 210 */
+	{ "onmouseover", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT } /* jump 1 */, /* 211 */
+	{ NULL, 0 }, /* 212 */
+	{ NULL, 0 }, /* 213 */
+	{ NULL, 0 }, /* 214 */
+	{ NULL, 0 }, /* 215 */
+	{ NULL, 0 }, /* 216 */
+	{ NULL, 0 }, /* 217 */
+	{ "ondragend", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 218 */
+	{ NULL, 0 }, /* 219 */
+	{ NULL, 0 }, /* 220 */
+	{ NULL, 0 }, /* 221 */
+	{ NULL, 0 }, /* 222 */
+	{ NULL, 0 }, /* 223 */
+	{ NULL, 0 }, /* 224 */
+	{ NULL, 0 }, /* 225 */
+	{ NULL, 0 }, /* 226 */
+	{ "onclick", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 227 */
+	{ NULL, 0 }, /* 228 */
+	{ "referrerpolicy", 0 }, /* 229 */
+	{ NULL, 0 }, /* 230 */
+	{ NULL, 0 }, /* 231 */
+	{ NULL, 0 }, /* 232 */
+	{ NULL, 0 }, /* 233 */
+	{ NULL, 0 }, /* 234 */
+	{ NULL, 0 }, /* 235 */
+	{ NULL, 0 }, /* 236 */
+	{ NULL, 0 }, /* 237 */
+	{ NULL, 0 }, /* 238 */
+	{ NULL, 0 }, /* 239 */
+	{ NULL, 0 }, /* 240 */
+	{ NULL, 0 }, /* 241 */
+	{ NULL, 0 }, /* 242 */
+	{ NULL, 0 }, /* 243 */
+	{ NULL, 0 }, /* 244 */
+	{ NULL, 0 }, /* 245 */
+	{ NULL, 0 }, /* 246 */
+	{ NULL, 0 }, /* 247 */
+	{ NULL, 0 }, /* 248 */
+	{ NULL, 0 }, /* 249 */
+	{ NULL, 0 }, /* 250 */
+	{ NULL, 0 }, /* 251 */
+	{ NULL, 0 }, /* 252 */
+	{ NULL, 0 }, /* 253 */
+	{ NULL, 0 }, /* 254 */
+	{ NULL, 0 }, /* 255 */
+	{ NULL, 0 }, /* 256 */
+	{ NULL, 0 }, /* 257 */
+	{ "inert", ATTR_FLAG_GLOBAL }, /* 258 */
+	{ NULL, 0 }, /* 259 */
+	{ NULL, 0 }, /* 260 */
+	{ NULL, 0 }, /* 261 */
+	{ NULL, 0 }, /* 262 */
+	{ NULL, 0 }, /* 263 */
+	{ NULL, 0 }, /* 264 */
+	{ NULL, 0 }, /* 265 */
+	{ NULL, 0 }, /* 266 */
+	{ NULL, 0 }, /* 267 */
+	{ NULL, 0 }, /* 268 */
+	{ NULL, 0 }, /* 269 */
+	{ NULL, 0 }, /* 270 */
+	{ NULL, 0 }, /* 271 */
+	{ NULL, 0 }, /* 272 */
+	{ "name", 0 }, /* 273 */
+	{ NULL, 0 }, /* 274 */
+	{ NULL, 0 }, /* 275 */
+	{ NULL, 0 }, /* 276 */
+	{ NULL, 0 }, /* 277 */
+	{ NULL, 0 }, /* 278 */
+	{ NULL, 0 }, /* 279 */
+	{ NULL, 0 }, /* 280 */
+	{ NULL, 0 }, /* 281 */
+	{ NULL, 0 }, /* 282 */
+	{ "onvolumechange", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 283 */
+	{ NULL, 0 }, /* 284 */
+	{ NULL, 0 }, /* 285 */
+	{ "oncanplaythrough", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 286 */
+	{ "oncontextmenu", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 287 */
+	{ NULL, 0 }, /* 288 */
+	{ NULL, 0 }, /* 289 */
+	{ "onpaste", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 290 */
+	{ NULL, 0 }, /* 291 */
+	{ NULL, 0 }, /* 292 */
+	{ NULL, 0 }, /* 293 */
+	{ NULL, 0 }, /* 294 */
+	{ NULL, 0 }, /* 295 */
+	{ NULL, 0 }, /* 296 */
+	{ NULL, 0 }, /* 297 */
+	{ NULL, 0 }, /* 298 */
+	{ NULL, 0 }, /* 299 */
+	{ NULL, 0 }, /* 300 */
+	{ NULL, 0 }, /* 301 */
+	{ NULL, 0 }, /* 302 */
+	{ NULL, 0 }, /* 303 */
+	{ NULL, 0 }, /* 304 */
+	{ NULL, 0 }, /* 305 */
+	{ NULL, 0 }, /* 306 */
+	{ NULL, 0 }, /* 307 */
+	{ NULL, 0 }, /* 308 */
+	{ NULL, 0 }, /* 309 */
+	{ NULL, 0 }, /* 310 */
+	{ NULL, 0 }, /* 311 */
+	{ NULL, 0 }, /* 312 */
+	{ NULL, 0 }, /* 313 */
+	{ NULL, 0 }, /* 314 */
+	{ "onseeking", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 315 */
+	{ "usemap", 0 } /* jump 1 */, /* 316 */
+	{ NULL, 0 }, /* 317 */
+	{ "sizes", 0 }, /* 318 */
+	{ NULL, 0 }, /* 319 */
+	{ NULL, 0 }, /* 320 */
+	{ NULL, 0 }, /* 321 */
+	{ NULL, 0 }, /* 322 */
+	{ NULL, 0 }, /* 323 */
+	{ NULL, 0 }, /* 324 */
+	{ NULL, 0 }, /* 325 */
+	{ NULL, 0 }, /* 326 */
+	{ NULL, 0 }, /* 327 */
+	{ NULL, 0 }, /* 328 */
+	{ NULL, 0 }, /* 329 */
+	{ NULL, 0 }, /* 330 */
+	{ NULL, 0 }, /* 331 */
+	{ NULL, 0 }, /* 332 */
+	{ "contenteditable", ATTR_FLAG_GLOBAL }, /* 333 */
+	{ NULL, 0 }, /* 334 */
+	{ NULL, 0 }, /* 335 */
+	{ NULL, 0 }, /* 336 */
+	{ NULL, 0 }, /* 337 */
+	{ NULL, 0 }, /* 338 */
+	{ NULL, 0 }, /* 339 */
+	{ NULL, 0 }, /* 340 */
+	{ NULL, 0 }, /* 341 */
+	{ NULL, 0 }, /* 342 */
+	{ NULL, 0 }, /* 343 */
+	{ NULL, 0 }, /* 344 */
+	{ NULL, 0 }, /* 345 */
+	{ NULL, 0 }, /* 346 */
+	{ NULL, 0 }, /* 347 */
+	{ NULL, 0 }, /* 348 */
+	{ NULL, 0 }, /* 349 */
+	{ NULL, 0 }, /* 350 */
+	{ NULL, 0 }, /* 351 */
+	{ NULL, 0 }, /* 352 */
+	{ NULL, 0 }, /* 353 */
+	{ NULL, 0 }, /* 354 */
+	{ NULL, 0 }, /* 355 */
+	{ NULL, 0 }, /* 356 */
+	{ NULL, 0 }, /* 357 */
+	{ NULL, 0 }, /* 358 */
+	{ "onerror", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 359 */
+	{ NULL, 0 }, /* 360 */
+	{ NULL, 0 }, /* 361 */
+	{ NULL, 0 }, /* 362 */
+	{ NULL, 0 }, /* 363 */
+	{ NULL, 0 }, /* 364 */
+	{ NULL, 0 }, /* 365 */
+	{ NULL, 0 }, /* 366 */
+	{ NULL, 0 }, /* 367 */
+	{ NULL, 0 }, /* 368 */
+	{ NULL, 0 }, /* 369 */
+	{ NULL, 0 }, /* 370 */
+	{ NULL, 0 }, /* 371 */
+	{ NULL, 0 }, /* 372 */
+	{ NULL, 0 }, /* 373 */
+	{ NULL, 0 }, /* 374 */
+	{ NULL, 0 }, /* 375 */
+	{ NULL, 0 }, /* 376 */
+	{ NULL, 0 }, /* 377 */
+	{ NULL, 0 }, /* 378 */
+	{ NULL, 0 }, /* 379 */
+	{ NULL, 0 }, /* 380 */
+	{ NULL, 0 }, /* 381 */
+	{ NULL, 0 }, /* 382 */
+	{ NULL, 0 }, /* 383 */
+	{ NULL, 0 }, /* 384 */
+	{ NULL, 0 }, /* 385 */
+	{ NULL, 0 }, /* 386 */
+	{ "onkeyup", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 387 */
+	{ NULL, 0 }, /* 388 */
+	{ NULL, 0 }, /* 389 */
+	{ NULL, 0 }, /* 390 */
+	{ "onratechange", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 391 */
+	{ NULL, 0 }, /* 392 */
+	{ "ondurationchange", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 393 */
+	{ NULL, 0 }, /* 394 */
+	{ NULL, 0 }, /* 395 */
+	{ NULL, 0 }, /* 396 */
+	{ NULL, 0 }, /* 397 */
+	{ NULL, 0 }, /* 398 */
+	{ NULL, 0 }, /* 399 */
+	{ NULL, 0 }, /* 400 */
+	{ NULL, 0 }, /* 401 */
+	{ NULL, 0 }, /* 402 */
+	{ "onclose", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 403 */
+	{ NULL, 0 }, /* 404 */
+	{ NULL, 0 }, /* 405 */
+	{ NULL, 0 }, /* 406 */
+	{ NULL, 0 }, /* 407 */
+	{ NULL, 0 }, /* 408 */
+	{ "style", ATTR_FLAG_GLOBAL }, /* 409 */
+	{ NULL, 0 }, /* 410 */
+	{ NULL, 0 }, /* 411 */
+	{ NULL, 0 }, /* 412 */
+	{ "onended", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 413 */
+	{ NULL, 0 }, /* 414 */
+	{ NULL, 0 }, /* 415 */
+	{ NULL, 0 }, /* 416 */
+	{ NULL, 0 }, /* 417 */
+	{ NULL, 0 }, /* 418 */
+	{ NULL, 0 }, /* 419 */
+	{ NULL, 0 }, /* 420 */
+	{ NULL, 0 }, /* 421 */
+	{ NULL, 0 }, /* 422 */
+	{ NULL, 0 }, /* 423 */
+	{ NULL, 0 }, /* 424 */
+	{ NULL, 0 }, /* 425 */
+	{ NULL, 0 }, /* 426 */
+	{ NULL, 0 }, /* 427 */
+	{ NULL, 0 }, /* 428 */
+	{ NULL, 0 }, /* 429 */
+	{ NULL, 0 }, /* 430 */
+	{ NULL, 0 }, /* 431 */
+	{ NULL, 0 }, /* 432 */
+	{ NULL, 0 }, /* 433 */
+	{ NULL, 0 }, /* 434 */
+	{ NULL, 0 }, /* 435 */
+	{ NULL, 0 }, /* 436 */
+	{ NULL, 0 }, /* 437 */
+	{ NULL, 0 }, /* 438 */
+	{ NULL, 0 }, /* 439 */
+	{ NULL, 0 }, /* 440 */
+	{ NULL, 0 }, /* 441 */
+	{ "onprogress", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 442 */
+	{ NULL, 0 }, /* 443 */
+	{ NULL, 0 }, /* 444 */
+	{ NULL, 0 }, /* 445 */
+	{ NULL, 0 }, /* 446 */
+	{ NULL, 0 }, /* 447 */
+	{ NULL, 0 }, /* 448 */
+	{ NULL, 0 }, /* 449 */
+	{ NULL, 0 }, /* 450 */
+	{ NULL, 0 }, /* 451 */
+	{ NULL, 0 }, /* 452 */
+	{ NULL, 0 }, /* 453 */
+	{ NULL, 0 }, /* 454 */
+	{ NULL, 0 }, /* 455 */
+	{ NULL, 0 }, /* 456 */
+	{ NULL, 0 }, /* 457 */
+	{ "autocomplete", 0 }, /* 458 */
+	{ NULL, 0 }, /* 459 */
+	{ NULL, 0 }, /* 460 */
+	{ NULL, 0 }, /* 461 */
+	{ NULL, 0 }, /* 462 */
+	{ NULL, 0 }, /* 463 */
+	{ NULL, 0 }, /* 464 */
+	{ NULL, 0 }, /* 465 */
+	{ NULL, 0 }, /* 466 */
+	{ NULL, 0 }, /* 467 */
+	{ NULL, 0 }, /* 468 */
+	{ NULL, 0 }, /* 469 */
+	{ NULL, 0 }, /* 470 */
+	{ NULL, 0 }, /* 471 */
+	{ "colspan", 0 }, /* 472 */
+	{ NULL, 0 }, /* 473 */
+	{ NULL, 0 }, /* 474 */
+	{ NULL, 0 }, /* 475 */
+	{ NULL, 0 }, /* 476 */
+	{ NULL, 0 }, /* 477 */
+	{ NULL, 0 }, /* 478 */
+	{ NULL, 0 }, /* 479 */
+	{ NULL, 0 }, /* 480 */
+	{ NULL, 0 }, /* 481 */
+	{ NULL, 0 }, /* 482 */
+	{ NULL, 0 }, /* 483 */
+	{ NULL, 0 }, /* 484 */
+	{ NULL, 0 }, /* 485 */
+	{ NULL, 0 }, /* 486 */
+	{ NULL, 0 }, /* 487 */
+	{ NULL, 0 }, /* 488 */
+	{ NULL, 0 }, /* 489 */
+	{ NULL, 0 }, /* 490 */
+	{ NULL, 0 }, /* 491 */
+	{ NULL, 0 }, /* 492 */
+	{ NULL, 0 }, /* 493 */
+	{ NULL, 0 }, /* 494 */
+	{ NULL, 0 }, /* 495 */
+	{ NULL, 0 }, /* 496 */
+	{ NULL, 0 }, /* 497 */
+	{ NULL, 0 }, /* 498 */
+	{ NULL, 0 }, /* 499 */
+	{ NULL, 0 }, /* 500 */
+	{ NULL, 0 }, /* 501 */
+	{ "spellcheck", ATTR_FLAG_GLOBAL }, /* 502 */
+	{ NULL, 0 }, /* 503 */
+	{ "ondragleave", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 504 */
+	{ NULL, 0 }, /* 505 */
+	{ NULL, 0 }, /* 506 */
+	{ "onplay", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 507 */
+	{ NULL, 0 }, /* 508 */
+	{ NULL, 0 }, /* 509 */
+	{ NULL, 0 }, /* 510 */
+	{ NULL, 0 }, /* 511 */
+	{ NULL, 0 }, /* 512 */
+	{ NULL, 0 }, /* 513 */
+	{ NULL, 0 }, /* 514 */
+	{ NULL, 0 }, /* 515 */
+	{ NULL, 0 }, /* 516 */
+	{ NULL, 0 }, /* 517 */
+	{ "pattern", 0 }, /* 518 */
+	{ NULL, 0 }, /* 519 */
+	{ NULL, 0 }, /* 520 */
+	{ NULL, 0 }, /* 521 */
+	{ NULL, 0 }, /* 522 */
+	{ "onkeypress", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 523 */
+	{ NULL, 0 }, /* 524 */
+	{ "onmousemove", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 525 */
+	{ NULL, 0 }, /* 526 */
+	{ NULL, 0 }, /* 527 */
+	{ NULL, 0 }, /* 528 */
+	{ NULL, 0 }, /* 529 */
+	{ NULL, 0 }, /* 530 */
+	{ NULL, 0 }, /* 531 */
+	{ NULL, 0 }, /* 532 */
+	{ NULL, 0 }, /* 533 */
+	{ NULL, 0 }, /* 534 */
+	{ NULL, 0 }, /* 535 */
+	{ NULL, 0 }, /* 536 */
+	{ "oncut", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 537 */
+	{ NULL, 0 }, /* 538 */
+	{ NULL, 0 }, /* 539 */
+	{ NULL, 0 }, /* 540 */
+	{ NULL, 0 }, /* 541 */
+	{ NULL, 0 }, /* 542 */
+	{ NULL, 0 }, /* 543 */
+	{ NULL, 0 }, /* 544 */
+	{ NULL, 0 }, /* 545 */
+	{ NULL, 0 }, /* 546 */
+	{ NULL, 0 }, /* 547 */
+	{ NULL, 0 }, /* 548 */
+	{ NULL, 0 }, /* 549 */
+	{ NULL, 0 }, /* 550 */
+	{ "ontoggle", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 551 */
+	{ NULL, 0 }, /* 552 */
+	{ NULL, 0 }, /* 553 */
+	{ NULL, 0 }, /* 554 */
+	{ NULL, 0 }, /* 555 */
+	{ NULL, 0 }, /* 556 */
+	{ NULL, 0 }, /* 557 */
+	{ NULL, 0 }, /* 558 */
+	{ NULL, 0 }, /* 559 */
+	{ "dirname", 0 }, /* 560 */
+	{ NULL, 0 }, /* 561 */
+	{ NULL, 0 }, /* 562 */
+	{ NULL, 0 }, /* 563 */
+	{ NULL, 0 }, /* 564 */
+	{ NULL, 0 }, /* 565 */
+	{ NULL, 0 }, /* 566 */
+	{ NULL, 0 }, /* 567 */
+	{ NULL, 0 }, /* 568 */
+	{ NULL, 0 }, /* 569 */
+	{ NULL, 0 }, /* 570 */
+	{ NULL, 0 }, /* 571 */
+	{ NULL, 0 }, /* 572 */
+	{ NULL, 0 }, /* 573 */
+	{ NULL, 0 }, /* 574 */
+	{ NULL, 0 }, /* 575 */
+	{ "onbeforeinput", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 576 */
+	{ NULL, 0 }, /* 577 */
+	{ NULL, 0 }, /* 578 */
+	{ NULL, 0 }, /* 579 */
+	{ NULL, 0 }, /* 580 */
+	{ NULL, 0 }, /* 581 */
+	{ NULL, 0 }, /* 582 */
+	{ NULL, 0 }, /* 583 */
+	{ NULL, 0 }, /* 584 */
+	{ NULL, 0 }, /* 585 */
+	{ NULL, 0 }, /* 586 */
+	{ NULL, 0 }, /* 587 */
+	{ NULL, 0 }, /* 588 */
+	{ "ondblclick", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 589 */
+	{ "onseeked", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 590 */
+	{ NULL, 0 }, /* 591 */
+	{ NULL, 0 }, /* 592 */
+	{ NULL, 0 }, /* 593 */
+	{ NULL, 0 }, /* 594 */
+	{ NULL, 0 }, /* 595 */
+	{ "oninvalid", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 596 */
+	{ NULL, 0 }, /* 597 */
+	{ NULL, 0 }, /* 598 */
+	{ NULL, 0 }, /* 599 */
+	{ NULL, 0 }, /* 600 */
+	{ NULL, 0 }, /* 601 */
+	{ NULL, 0 }, /* 602 */
+	{ "onmouseup", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 603 */
+	{ NULL, 0 }, /* 604 */
+	{ NULL, 0 }, /* 605 */
+	{ "max", 0 }, /* 606 */
+	{ "tabindex", ATTR_FLAG_GLOBAL }, /* 607 */
+	{ NULL, 0 }, /* 608 */
+	{ NULL, 0 }, /* 609 */
+	{ NULL, 0 }, /* 610 */
+	{ NULL, 0 }, /* 611 */
+	{ NULL, 0 }, /* 612 */
+	{ NULL, 0 }, /* 613 */
+	{ NULL, 0 }, /* 614 */
+	{ NULL, 0 }, /* 615 */
+	{ NULL, 0 }, /* 616 */
+	{ "alt", 0 }, /* 617 */
+	{ NULL, 0 }, /* 618 */
+	{ "placeholder", 0 }, /* 619 */
+	{ "multiple", 0 }, /* 620 */
+	{ NULL, 0 }, /* 621 */
+	{ NULL, 0 }, /* 622 */
+	{ NULL, 0 }, /* 623 */
+	{ "onreset", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 624 */
+	{ NULL, 0 }, /* 625 */
+	{ NULL, 0 }, /* 626 */
+	{ NULL, 0 }, /* 627 */
+	{ NULL, 0 }, /* 628 */
+	{ NULL, 0 }, /* 629 */
+	{ NULL, 0 }, /* 630 */
+	{ NULL, 0 }, /* 631 */
+	{ NULL, 0 }, /* 632 */
+	{ NULL, 0 }, /* 633 */
+	{ NULL, 0 }, /* 634 */
+	{ NULL, 0 }, /* 635 */
+	{ NULL, 0 }, /* 636 */
+	{ NULL, 0 }, /* 637 */
+	{ NULL, 0 }, /* 638 */
+	{ NULL, 0 }, /* 639 */
+	{ NULL, 0 }, /* 640 */
+	{ "ondragenter", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 641 */
+	{ "type", 0 }, /* 642 */
+	{ NULL, 0 }, /* 643 */
+	{ NULL, 0 }, /* 644 */
+	{ NULL, 0 }, /* 645 */
+	{ NULL, 0 }, /* 646 */
+	{ NULL, 0 }, /* 647 */
+	{ NULL, 0 }, /* 648 */
+	{ NULL, 0 }, /* 649 */
+	{ "oncontextrestored", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 650 */
+	{ NULL, 0 }, /* 651 */
+	{ NULL, 0 }, /* 652 */
+	{ "oninput", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 653 */
+	{ NULL, 0 }, /* 654 */
+	{ NULL, 0 }, /* 655 */
+	{ NULL, 0 }, /* 656 */
+	{ NULL, 0 }, /* 657 */
+	{ NULL, 0 }, /* 658 */
+	{ NULL, 0 }, /* 659 */
+	{ NULL, 0 }, /* 660 */
+	{ NULL, 0 }, /* 661 */
+	{ NULL, 0 }, /* 662 */
+	{ "onresize", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 663 */
+	{ NULL, 0 }, /* 664 */
+	{ NULL, 0 }, /* 665 */
+	{ NULL, 0 }, /* 666 */
+	{ NULL, 0 }, /* 667 */
+	{ NULL, 0 }, /* 668 */
+	{ NULL, 0 }, /* 669 */
+	{ "translate", ATTR_FLAG_GLOBAL }, /* 670 */
+	{ NULL, 0 }, /* 671 */
+	{ NULL, 0 }, /* 672 */
+	{ NULL, 0 }, /* 673 */
+	{ NULL, 0 }, /* 674 */
+	{ NULL, 0 }, /* 675 */
+	{ NULL, 0 }, /* 676 */
+	{ NULL, 0 }, /* 677 */
+	{ NULL, 0 }, /* 678 */
+	{ NULL, 0 }, /* 679 */
+	{ NULL, 0 }, /* 680 */
+	{ NULL, 0 }, /* 681 */
+	{ "onwheel", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 682 */
+	{ NULL, 0 }, /* 683 */
+	{ NULL, 0 }, /* 684 */
+	{ NULL, 0 }, /* 685 */
+	{ NULL, 0 }, /* 686 */
+	{ NULL, 0 }, /* 687 */
+	{ NULL, 0 }, /* 688 */
+	{ NULL, 0 }, /* 689 */
+	{ NULL, 0 }, /* 690 */
+	{ NULL, 0 }, /* 691 */
+	{ NULL, 0 }, /* 692 */
+	{ NULL, 0 }, /* 693 */
+	{ NULL, 0 }, /* 694 */
+	{ NULL, 0 }, /* 695 */
+	{ NULL, 0 }, /* 696 */
+	{ NULL, 0 }, /* 697 */
+	{ NULL, 0 }, /* 698 */
+	{ NULL, 0 }, /* 699 */
+	{ NULL, 0 }, /* 700 */
+	{ NULL, 0 }, /* 701 */
+	{ NULL, 0 }, /* 702 */
+	{ NULL, 0 }, /* 703 */
+	{ NULL, 0 }, /* 704 */
+	{ NULL, 0 }, /* 705 */
+	{ NULL, 0 }, /* 706 */
+	{ "oncancel", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 707 */
+	{ "hidden", ATTR_FLAG_GLOBAL }, /* 708 */
+	{ NULL, 0 }, /* 709 */
+	{ NULL, 0 }, /* 710 */
+	{ NULL, 0 }, /* 711 */
+	{ NULL, 0 }, /* 712 */
+	{ NULL, 0 }, /* 713 */
+	{ "ismap", 0 }, /* 714 */
+	{ NULL, 0 }, /* 715 */
+	{ "onscroll", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 716 */
+	{ NULL, 0 }, /* 717 */
+	{ NULL, 0 }, /* 718 */
+	{ "ontimeupdate", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 719 */
+	{ "maxlength", 0 }, /* 720 */
+	{ NULL, 0 }, /* 721 */
+	{ "onsecuritypolicyviolation", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 722 */
+	{ NULL, 0 }, /* 723 */
+	{ NULL, 0 }, /* 724 */
+	{ NULL, 0 }, /* 725 */
+	{ NULL, 0 }, /* 726 */
+	{ NULL, 0 }, /* 727 */
+	{ NULL, 0 }, /* 728 */
+	{ NULL, 0 }, /* 729 */
+	{ NULL, 0 }, /* 730 */
+	{ NULL, 0 }, /* 731 */
+	{ "itemref", ATTR_FLAG_GLOBAL }, /* 732 */
+	{ NULL, 0 }, /* 733 */
+	{ NULL, 0 }, /* 734 */
+	{ NULL, 0 }, /* 735 */
+	{ NULL, 0 }, /* 736 */
+	{ NULL, 0 }, /* 737 */
+	{ NULL, 0 }, /* 738 */
+	{ NULL, 0 }, /* 739 */
+	{ NULL, 0 }, /* 740 */
+	{ NULL, 0 }, /* 741 */
+	{ NULL, 0 }, /* 742 */
+	{ NULL, 0 }, /* 743 */
+	{ "width", 0 }, /* 744 */
+	{ NULL, 0 }, /* 745 */
+	{ NULL, 0 }, /* 746 */
+	{ NULL, 0 }, /* 747 */
+	{ "min", 0 }, /* 748 */
+	{ NULL, 0 }, /* 749 */
+	{ NULL, 0 }, /* 750 */
+	{ NULL, 0 }, /* 751 */
+	{ NULL, 0 }, /* 752 */
+	{ NULL, 0 }, /* 753 */
+	{ NULL, 0 }, /* 754 */
+	{ NULL, 0 }, /* 755 */
+	{ NULL, 0 }, /* 756 */
+	{ "onfocus", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 757 */
+	{ NULL, 0 }, /* 758 */
+	{ NULL, 0 }, /* 759 */
+	{ "disabled", 0 }, /* 760 */
+	{ NULL, 0 }, /* 761 */
+	{ NULL, 0 }, /* 762 */
+	{ NULL, 0 }, /* 763 */
+	{ NULL, 0 }, /* 764 */
+	{ NULL, 0 }, /* 765 */
+	{ NULL, 0 }, /* 766 */
+	{ "dir", ATTR_FLAG_GLOBAL }, /* 767 */
+	{ NULL, 0 }, /* 768 */
+	{ "draggable", ATTR_FLAG_GLOBAL }, /* 769 */
+	{ "crossorigin", 0 }, /* 770 */
+	{ NULL, 0 }, /* 771 */
+	{ NULL, 0 }, /* 772 */
+	{ NULL, 0 }, /* 773 */
+	{ NULL, 0 }, /* 774 */
+	{ NULL, 0 }, /* 775 */
+	{ "src", 0 }, /* 776 */
+	{ NULL, 0 }, /* 777 */
+	{ NULL, 0 }, /* 778 */
+	{ NULL, 0 }, /* 779 */
+	{ NULL, 0 }, /* 780 */
+	{ NULL, 0 }, /* 781 */
+	{ NULL, 0 }, /* 782 */
+	{ NULL, 0 }, /* 783 */
+	{ NULL, 0 }, /* 784 */
+	{ NULL, 0 }, /* 785 */
+	{ NULL, 0 }, /* 786 */
+	{ NULL, 0 }, /* 787 */
+	{ NULL, 0 }, /* 788 */
+	{ NULL, 0 }, /* 789 */
+	{ NULL, 0 }, /* 790 */
+	{ NULL, 0 }, /* 791 */
+	{ "itemprop", ATTR_FLAG_GLOBAL }, /* 792 */
+	{ NULL, 0 }, /* 793 */
+	{ NULL, 0 }, /* 794 */
+	{ NULL, 0 }, /* 795 */
+	{ NULL, 0 }, /* 796 */
+	{ NULL, 0 }, /* 797 */
+	{ NULL, 0 }, /* 798 */
+	{ NULL, 0 }, /* 799 */
+	{ NULL, 0 }, /* 800 */
+	{ "onplaying", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 801 */
+	{ NULL, 0 }, /* 802 */
+	{ "onmouseleave", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 803 */
+	{ "rel", 0 } /* jump 1 */, /* 804 */
+	{ NULL, 0 }, /* 805 */
+	{ NULL, 0 }, /* 806 */
+	{ NULL, 0 }, /* 807 */
+	{ NULL, 0 }, /* 808 */
+	{ NULL, 0 }, /* 809 */
+	{ NULL, 0 }, /* 810 */
+	{ NULL, 0 }, /* 811 */
+	{ NULL, 0 }, /* 812 */
+	{ NULL, 0 }, /* 813 */
+	{ NULL, 0 }, /* 814 */
+	{ NULL, 0 }, /* 815 */
+	{ "oncuechange", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 816 */
+	{ NULL, 0 }, /* 817 */
+	{ "rowspan", 0 }, /* 818 */
+	{ NULL, 0 }, /* 819 */
+	{ NULL, 0 }, /* 820 */
+	{ NULL, 0 }, /* 821 */
+	{ "onmouseout", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 822 */
+	{ NULL, 0 }, /* 823 */
+	{ NULL, 0 }, /* 824 */
+	{ "itemtype", ATTR_FLAG_GLOBAL }, /* 825 */
+	{ NULL, 0 }, /* 826 */
+	{ "onloadstart", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 827 */
+	{ "srcset", 0 }, /* 828 */
+	{ NULL, 0 }, /* 829 */
+	{ NULL, 0 }, /* 830 */
+	{ NULL, 0 }, /* 831 */
+	{ NULL, 0 }, /* 832 */
+	{ "autofocus", ATTR_FLAG_GLOBAL }, /* 833 */
+	{ NULL, 0 }, /* 834 */
+	{ NULL, 0 }, /* 835 */
+	{ NULL, 0 }, /* 836 */
+	{ NULL, 0 }, /* 837 */
+	{ NULL, 0 }, /* 838 */
+	{ NULL, 0 }, /* 839 */
+	{ "onloadeddata", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 840 */
+	{ NULL, 0 }, /* 841 */
+	{ NULL, 0 }, /* 842 */
+	{ NULL, 0 }, /* 843 */
+	{ NULL, 0 }, /* 844 */
+	{ NULL, 0 }, /* 845 */
+	{ NULL, 0 }, /* 846 */
+	{ NULL, 0 }, /* 847 */
+	{ NULL, 0 }, /* 848 */
+	{ NULL, 0 }, /* 849 */
+	{ NULL, 0 }, /* 850 */
+	{ NULL, 0 }, /* 851 */
+	{ NULL, 0 }, /* 852 */
+	{ NULL, 0 }, /* 853 */
+	{ NULL, 0 }, /* 854 */
+	{ NULL, 0 }, /* 855 */
+	{ NULL, 0 }, /* 856 */
+	{ NULL, 0 }, /* 857 */
+	{ NULL, 0 }, /* 858 */
+	{ NULL, 0 }, /* 859 */
+	{ NULL, 0 }, /* 860 */
+	{ NULL, 0 }, /* 861 */
+	{ NULL, 0 }, /* 862 */
+	{ NULL, 0 }, /* 863 */
+	{ NULL, 0 }, /* 864 */
+	{ NULL, 0 }, /* 865 */
+	{ NULL, 0 }, /* 866 */
+	{ NULL, 0 }, /* 867 */
+	{ NULL, 0 }, /* 868 */
+	{ NULL, 0 }, /* 869 */
+	{ NULL, 0 }, /* 870 */
+	{ NULL, 0 }, /* 871 */
+	{ NULL, 0 }, /* 872 */
+	{ NULL, 0 }, /* 873 */
+	{ NULL, 0 }, /* 874 */
+	{ NULL, 0 }, /* 875 */
+	{ NULL, 0 }, /* 876 */
+	{ "inputmode", ATTR_FLAG_GLOBAL }, /* 877 */
+	{ NULL, 0 }, /* 878 */
+	{ NULL, 0 }, /* 879 */
+	{ NULL, 0 }, /* 880 */
+	{ NULL, 0 }, /* 881 */
+	{ NULL, 0 }, /* 882 */
+	{ NULL, 0 }, /* 883 */
+	{ NULL, 0 }, /* 884 */
+	{ NULL, 0 }, /* 885 */
+	{ "onmousedown", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 886 */
+	{ NULL, 0 }, /* 887 */
+	{ NULL, 0 }, /* 888 */
+	{ NULL, 0 }, /* 889 */
+	{ NULL, 0 }, /* 890 */
+	{ NULL, 0 }, /* 891 */
+	{ NULL, 0 }, /* 892 */
+	{ NULL, 0 }, /* 893 */
+	{ NULL, 0 }, /* 894 */
+	{ NULL, 0 }, /* 895 */
+	{ NULL, 0 }, /* 896 */
+	{ NULL, 0 }, /* 897 */
+	{ NULL, 0 }, /* 898 */
+	{ NULL, 0 }, /* 899 */
+	{ NULL, 0 }, /* 900 */
+	{ "onload", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 901 */
+	{ NULL, 0 }, /* 902 */
+	{ NULL, 0 }, /* 903 */
+	{ NULL, 0 }, /* 904 */
+	{ NULL, 0 }, /* 905 */
+	{ NULL, 0 }, /* 906 */
+	{ NULL, 0 }, /* 907 */
+	{ NULL, 0 }, /* 908 */
+	{ NULL, 0 }, /* 909 */
+	{ NULL, 0 }, /* 910 */
+	{ NULL, 0 }, /* 911 */
+	{ NULL, 0 }, /* 912 */
+	{ NULL, 0 }, /* 913 */
+	{ NULL, 0 }, /* 914 */
+	{ NULL, 0 }, /* 915 */
+	{ NULL, 0 }, /* 916 */
+	{ NULL, 0 }, /* 917 */
+	{ NULL, 0 }, /* 918 */
+	{ NULL, 0 }, /* 919 */
+	{ NULL, 0 }, /* 920 */
+	{ NULL, 0 }, /* 921 */
+	{ NULL, 0 }, /* 922 */
+	{ "content", 0 }, /* 923 */
+	{ NULL, 0 }, /* 924 */
+	{ NULL, 0 }, /* 925 */
+	{ NULL, 0 }, /* 926 */
+	{ NULL, 0 }, /* 927 */
+	{ NULL, 0 }, /* 928 */
+	{ "onsubmit", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 929 */
+	{ NULL, 0 }, /* 930 */
+	{ NULL, 0 }, /* 931 */
+	{ NULL, 0 }, /* 932 */
+	{ NULL, 0 }, /* 933 */
+	{ NULL, 0 }, /* 934 */
+	{ "autocapitalize", ATTR_FLAG_GLOBAL }, /* 935 */
+	{ NULL, 0 }, /* 936 */
+	{ NULL, 0 }, /* 937 */
+	{ "enterkeyhint", ATTR_FLAG_GLOBAL }, /* 938 */
+	{ NULL, 0 }, /* 939 */
+	{ "onmouseenter", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 940 */
+	{ "step", 0 } /* jump 1 */, /* 941 */
+	{ NULL, 0 }, /* 942 */
+	{ NULL, 0 }, /* 943 */
+	{ NULL, 0 }, /* 944 */
+	{ NULL, 0 }, /* 945 */
+	{ NULL, 0 }, /* 946 */
+	{ NULL, 0 }, /* 947 */
+	{ NULL, 0 }, /* 948 */
+	{ NULL, 0 }, /* 949 */
+	{ NULL, 0 }, /* 950 */
+	{ NULL, 0 }, /* 951 */
+	{ NULL, 0 }, /* 952 */
+	{ NULL, 0 }, /* 953 */
+	{ NULL, 0 }, /* 954 */
+	{ "onchange", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 955 */
+	{ NULL, 0 }, /* 956 */
+	{ NULL, 0 }, /* 957 */
+	{ "minlength", 0 }, /* 958 */
+	{ NULL, 0 }, /* 959 */
+	{ NULL, 0 }, /* 960 */
+	{ NULL, 0 }, /* 961 */
+	{ NULL, 0 }, /* 962 */
+	{ NULL, 0 }, /* 963 */
+	{ "itemid", ATTR_FLAG_GLOBAL }, /* 964 */
+	{ NULL, 0 }, /* 965 */
+	{ NULL, 0 }, /* 966 */
+	{ NULL, 0 }, /* 967 */
+	{ NULL, 0 }, /* 968 */
+	{ NULL, 0 }, /* 969 */
+	{ NULL, 0 }, /* 970 */
+	{ NULL, 0 }, /* 971 */
+	{ NULL, 0 }, /* 972 */
+	{ NULL, 0 }, /* 973 */
+	{ NULL, 0 }, /* 974 */
+	{ NULL, 0 }, /* 975 */
+	{ NULL, 0 }, /* 976 */
+	{ NULL, 0 }, /* 977 */
+	{ NULL, 0 }, /* 978 */
+	{ NULL, 0 }, /* 979 */
+	{ NULL, 0 }, /* 980 */
+	{ NULL, 0 }, /* 981 */
+	{ NULL, 0 }, /* 982 */
+	{ NULL, 0 }, /* 983 */
+	{ NULL, 0 }, /* 984 */
+	{ NULL, 0 }, /* 985 */
+	{ NULL, 0 }, /* 986 */
+	{ NULL, 0 }, /* 987 */
+	{ NULL, 0 }, /* 988 */
+	{ NULL, 0 }, /* 989 */
+	{ NULL, 0 }, /* 990 */
+	{ "onsuspend", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 991 */
+	{ NULL, 0 }, /* 992 */
+	{ NULL, 0 }, /* 993 */
+	{ NULL, 0 }, /* 994 */
+	{ "ondrag", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 995 */
+	{ NULL, 0 }, /* 996 */
+	{ NULL, 0 }, /* 997 */
+	{ NULL, 0 }, /* 998 */
+	{ NULL, 0 }, /* 999 */
+	{ NULL, 0 }, /* 1000 */
+	{ NULL, 0 }, /* 1001 */
+	{ NULL, 0 }, /* 1002 */
+	{ NULL, 0 }, /* 1003 */
+	{ NULL, 0 }, /* 1004 */
+	{ "onselect", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 1005 */
+	{ "onslotchange", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT } /* jump 1 */, /* 1006 */
+	{ "ondragover", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT }, /* 1007 */
+	{ NULL, 0 }, /* 1008 */
+	{ "itemscope", ATTR_FLAG_GLOBAL }, /* 1009 */
+	{ "lang", ATTR_FLAG_GLOBAL }, /* 1010 */
+	{ "ondrop", ATTR_FLAG_GLOBAL | ATTR_FLAG_EVENT } /* jump 1 */, /* 1011 */
+	{ "headers", 0 }, /* 1012 */
+	{ "href", 0 }, /* 1013 */
+	{ "loading", 0 }, /* 1014 */
+	{ NULL, 0 }, /* 1015 */
+	{ NULL, 0 }, /* 1016 */
+	{ NULL, 0 }, /* 1017 */
+	{ NULL, 0 }, /* 1018 */
+	{ "nonce", ATTR_FLAG_GLOBAL }, /* 1019 */
+	{ NULL, 0 }, /* 1020 */
+	{ NULL, 0 }, /* 1021 */
+	{ NULL, 0 }, /* 1022 */
+	{ NULL, 0 }, /* 1023 */
+};
@@ -0,0 +1,132 @@
+/* generated by attrs.awk */
+enum attrid {
+	ATTR_ACCESSKEY=3,
+	ATTR_REQUIRED=17,
+	ATTR_ID=29,
+	ATTR_ONKEYDOWN=30,
+	ATTR_ONAUXCLICK=33,
+	ATTR_SLOT=50,
+	ATTR_ONCOPY=72,
+	ATTR_HEIGHT=73,
+	ATTR_ONEMPTIED=93,
+	ATTR_ONWAITING=104,
+	ATTR_ONFORMDATA=123,
+	ATTR_SIZE=124,
+	ATTR_IS=148,
+	ATTR_CLASS=158,
+	ATTR_ONDRAGSTART=169,
+	ATTR_ONCANPLAY=173,
+	ATTR_ONLOADEDMETADATA=175,
+	ATTR_ONCONTEXTLOST=180,
+	ATTR_LIST=181,
+	ATTR_TITLE=186,
+	ATTR_ONBEFOREMATCH=189,
+	ATTR_READONLY=190,
+	ATTR_ONPAUSE=195,
+	ATTR_DECODING=205,
+	ATTR_ONSTALLED=206,
+	ATTR_ONBLUR=210,
+	ATTR_ONMOUSEOVER=211,
+	ATTR_ONDRAGEND=218,
+	ATTR_ONCLICK=227,
+	ATTR_REFERRERPOLICY=229,
+	ATTR_INERT=258,
+	ATTR_NAME=273,
+	ATTR_ONVOLUMECHANGE=283,
+	ATTR_ONCANPLAYTHROUGH=286,
+	ATTR_ONCONTEXTMENU=287,
+	ATTR_ONPASTE=290,
+	ATTR_ONSEEKING=315,
+	ATTR_USEMAP=316,
+	ATTR_SIZES=318,
+	ATTR_CONTENTEDITABLE=333,
+	ATTR_ONERROR=359,
+	ATTR_ONKEYUP=387,
+	ATTR_ONRATECHANGE=391,
+	ATTR_ONDURATIONCHANGE=393,
+	ATTR_ONCLOSE=403,
+	ATTR_STYLE=409,
+	ATTR_ONENDED=413,
+	ATTR_ONPROGRESS=442,
+	ATTR_AUTOCOMPLETE=458,
+	ATTR_COLSPAN=472,
+	ATTR_SPELLCHECK=502,
+	ATTR_ONDRAGLEAVE=504,
+	ATTR_ONPLAY=507,
+	ATTR_PATTERN=518,
+	ATTR_ONKEYPRESS=523,
+	ATTR_ONMOUSEMOVE=525,
+	ATTR_ONCUT=537,
+	ATTR_ONTOGGLE=551,
+	ATTR_DIRNAME=560,
+	ATTR_ONBEFOREINPUT=576,
+	ATTR_ONDBLCLICK=589,
+	ATTR_ONSEEKED=590,
+	ATTR_ONINVALID=596,
+	ATTR_ONMOUSEUP=603,
+	ATTR_MAX=606,
+	ATTR_TABINDEX=607,
+	ATTR_ALT=617,
+	ATTR_PLACEHOLDER=619,
+	ATTR_MULTIPLE=620,
+	ATTR_ONRESET=624,
+	ATTR_ONDRAGENTER=641,
+	ATTR_TYPE=642,
+	ATTR_ONCONTEXTRESTORED=650,
+	ATTR_ONINPUT=653,
+	ATTR_ONRESIZE=663,
+	ATTR_TRANSLATE=670,
+	ATTR_ONWHEEL=682,
+	ATTR_ONCANCEL=707,
+	ATTR_HIDDEN=708,
+	ATTR_ISMAP=714,
+	ATTR_ONSCROLL=716,
+	ATTR_ONTIMEUPDATE=719,
+	ATTR_MAXLENGTH=720,
+	ATTR_ONSECURITYPOLICYVIOLATION=722,
+	ATTR_ITEMREF=732,
+	ATTR_WIDTH=744,
+	ATTR_MIN=748,
+	ATTR_ONFOCUS=757,
+	ATTR_DISABLED=760,
+	ATTR_DIR=767,
+	ATTR_DRAGGABLE=769,
+	ATTR_CROSSORIGIN=770,
+	ATTR_SRC=776,
+	ATTR_ITEMPROP=792,
+	ATTR_ONPLAYING=801,
+	ATTR_ONMOUSELEAVE=803,
+	ATTR_REL=804,
+	ATTR_ONCUECHANGE=816,
+	ATTR_ROWSPAN=818,
+	ATTR_ONMOUSEOUT=822,
+	ATTR_ITEMTYPE=825,
+	ATTR_ONLOADSTART=827,
+	ATTR_SRCSET=828,
+	ATTR_AUTOFOCUS=833,
+	ATTR_ONLOADEDDATA=840,
+	ATTR_INPUTMODE=877,
+	ATTR_ONMOUSEDOWN=886,
+	ATTR_ONLOAD=901,
+	ATTR_CONTENT=923,
+	ATTR_ONSUBMIT=929,
+	ATTR_AUTOCAPITALIZE=935,
+	ATTR_ENTERKEYHINT=938,
+	ATTR_ONMOUSEENTER=940,
+	ATTR_STEP=941,
+	ATTR_ONCHANGE=955,
+	ATTR_MINLENGTH=958,
+	ATTR_ITEMID=964,
+	ATTR_ONSUSPEND=991,
+	ATTR_ONDRAG=995,
+	ATTR_ONSELECT=1005,
+	ATTR_ONSLOTCHANGE=1006,
+	ATTR_ONDRAGOVER=1007,
+	ATTR_ITEMSCOPE=1009,
+	ATTR_LANG=1010,
+	ATTR_ONDROP=1011,
+	ATTR_HEADERS=1012,
+	ATTR_HREF=1013,
+	ATTR_LOADING=1014,
+	ATTR_NONCE=1019,
+};
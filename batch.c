@@ -0,0 +1,293 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "batch.h"
+#include "util.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <err.h>
+
+/*
+ * Each worker owns a range of documents. It takes documents from the
+ * front of its own range and when that runs out, it steals the back
+ * half of the range of some other worker. This keeps all workers busy
+ * even if a few documents are much larger than the rest.
+ */
+struct worker {
+	pthread_mutex_t		 lock;
+	pthread_t		 thread;
+	size_t			 next;		/* documents left */
+	size_t			 end;
+	size_t			 consumed;
+
+	struct purehtml		 ctx;
+	struct pool		*pool;
+};
+
+struct pool {
+	struct purehtml_batch	*batch;
+	struct purehtml_doc	*docs;
+	struct worker		*workers;
+	size_t			 nworkers;
+};
+
+static pthread_key_t doc_key;
+static pthread_once_t doc_once = PTHREAD_ONCE_INIT;
+
+static void
+doc_key_create(void)
+{
+	if ((errno = pthread_key_create(&doc_key, NULL)) != 0)
+		err(1, "pthread_key_create");
+}
+
+/*
+ * Returns the document that the calling worker thread is parsing, or
+ * NULL if called outside of purehtml_batch().
+ */
+struct purehtml_doc *
+purehtml_batch_doc(void)
+{
+	pthread_once(&doc_once, doc_key_create);
+	return pthread_getspecific(doc_key);
+}
+
+static void
+parse_doc(struct worker *w, struct purehtml_doc *doc)
+{
+	struct purehtml_batch *batch;
+	size_t consumed;
+
+	batch = w->pool->batch;
+	doc->ctx = &w->ctx;
+	doc->consumed = 0;
+	doc->error = 0;
+
+	pthread_setspecific(doc_key, doc);
+	w->ctx.tokenizer.input.charset = doc->charset;
+	if (doc->path != NULL)
+		consumed = purehtml_parse_file(&w->ctx, doc->path,
+		    batch->begin, batch->end);
+	else
+		consumed = purehtml_parse_buf(&w->ctx, doc->buf, doc->len,
+		    batch->begin, batch->end);
+	pthread_setspecific(doc_key, NULL);
+
+	if (consumed != (size_t) -1) {
+		doc->consumed = consumed;
+		w->consumed += consumed;
+	} else
+		doc->error = errno;
+	purehtml_reset(&w->ctx);
+
+	if (batch->done != NULL)
+		batch->done(doc);
+	doc->ctx = NULL;
+}
+
+static int
+steal(struct worker *w)
+{
+	struct pool *pool;
+	struct worker *victim;
+	size_t i, n, start;
+
+	pool = w->pool;
+	for (i = 1; i < pool->nworkers; i++) {
+		victim = &pool->workers[(w - pool->workers + i) %
+		    pool->nworkers];
+
+		pthread_mutex_lock(&victim->lock);
+		n = victim->end - victim->next;
+		start = victim->end - (n + 1) / 2;
+		victim->end = start;
+		pthread_mutex_unlock(&victim->lock);
+
+		if (n > 0) {
+			pthread_mutex_lock(&w->lock);
+			w->next = start;
+			w->end = start + (n + 1) / 2;
+			pthread_mutex_unlock(&w->lock);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static void *
+work(void *arg)
+{
+	struct worker *w = arg;
+	size_t i;
+
+	for (;;) {
+		pthread_mutex_lock(&w->lock);
+		if (w->next < w->end) {
+			i = w->next++;
+			pthread_mutex_unlock(&w->lock);
+			parse_doc(w, &w->pool->docs[i]);
+			continue;
+		}
+		pthread_mutex_unlock(&w->lock);
+
+		if (!steal(w))
+			break;
+	}
+
+	return NULL;
+}
+
+/*
+ * Parse n documents using a pool of worker threads and return the
+ * total number of bytes parsed. Per document results are passed to
+ * the done callback as soon as the document is finished.
+ */
+size_t
+purehtml_batch(struct purehtml_batch *batch, struct purehtml_doc *docs,
+    size_t n)
+{
+	struct pool pool;
+	struct worker *w;
+	size_t i, consumed;
+	long ncpu;
+
+	pthread_once(&doc_once, doc_key_create);
+
+	pool.batch = batch;
+	pool.docs = docs;
+	if (batch->nthreads > 0)
+		pool.nworkers = batch->nthreads;
+	else if ((ncpu = sysconf(_SC_NPROCESSORS_ONLN)) > 0)
+		pool.nworkers = ncpu;
+	else
+		pool.nworkers = 1;
+
+	pool.workers = mem_calloc(pool.nworkers, sizeof(struct worker));
+	if (pool.workers == NULL)
+		err(1, "calloc workers");
+
+	for (i = 0; i < pool.nworkers; i++) {
+		w = &pool.workers[i];
+		w->pool = &pool;
+		w->next = n * i / pool.nworkers;
+		w->end = n * (i + 1) / pool.nworkers;
+		if ((errno = pthread_mutex_init(&w->lock, NULL)) != 0)
+			err(1, "pthread_mutex_init");
+		if (batch->init != NULL)
+			batch->init(&w->ctx);
+	}
+
+	for (i = 0; i < pool.nworkers; i++) {
+		w = &pool.workers[i];
+		if ((errno = pthread_create(&w->thread, NULL, work, w)) != 0)
+			err(1, "pthread_create");
+	}
+
+	/*
+	 * The others may still steal from a worker that has finished, so
+	 * the locks go only after all of them.
+	 */
+	for (i = 0; i < pool.nworkers; i++)
+		pthread_join(pool.workers[i].thread, NULL);
+
+	consumed = 0;
+	for (i = 0; i < pool.nworkers; i++) {
+		w = &pool.workers[i];
+		pthread_mutex_destroy(&w->lock);
+		consumed += w->consumed;
+		purehtml_free(&w->ctx);
+	}
+
+	mem_free(pool.workers);
+	return consumed;
+}
+
+#ifdef TEST
+#include "node.h"
+#include "elem.h"
+
+#include <assert.h>
+#include <stdio.h>
+
+#define NDOCS 1000
+
+static size_t counts[NDOCS];
+
+static int
+begin(struct node *node)
+{
+	struct purehtml_doc *doc;
+
+	doc = purehtml_batch_doc();
+	assert(doc != NULL && doc->ctx != NULL);
+	if (node->type == NODE_ELEM)
+		(*(size_t *) doc->user)++;
+	return CB_CONTINUE;
+}
+
+static int
+end(struct node *node)
+{
+	return CB_CONTINUE;
+}
+
+int
+main(int argc, char **argv)
+{
+	static struct purehtml_doc docs[NDOCS];
+	static char bufs[NDOCS][256];
+	struct purehtml_batch batch = { 0 };
+	size_t i, total, consumed;
+	int j, n;
+
+	/*
+	 * Uneven document sizes: every 100th one is large.
+	 */
+	total = 0;
+	for (i = 0; i < NDOCS; i++) {
+		n = (i % 100 == 0) ? 20 : 1;
+		strcpy(bufs[i], "<body>");
+		for (j = 0; j < n; j++)
+			strcat(bufs[i], "<p>a<b>b</b>");
+		docs[i].buf = bufs[i];
+		docs[i].len = strlen(bufs[i]);
+		docs[i].user = &counts[i];
+		total += docs[i].len;
+	}
+
+	batch.nthreads = 4;
+	batch.begin = begin;
+	batch.end = end;
+	consumed = purehtml_batch(&batch, docs, NDOCS);
+	assert(consumed == total);
+	assert(purehtml_batch_doc() == NULL);
+
+	for (i = 0; i < NDOCS; i++) {
+		n = (i % 100 == 0) ? 20 : 1;
+		assert(docs[i].consumed == docs[i].len);
+		assert(docs[i].error == 0);
+		assert(counts[i] == 3 + 2 * n);
+	}
+	return 0;
+}
+#endif
@@ -0,0 +1,66 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "purehtml.h"
+
+#include <stddef.h>
+
+struct node;
+
+/*
+ * A document to parse with purehtml_batch(), either a file or a
+ * buffer.
+ */
+struct purehtml_doc {
+	const char	*path;		/* file to parse, or NULL */
+	const char	*buf;		/* buffer to parse if path is NULL */
+	size_t		 len;
+	int		 charset;	/* ENCODING_* if known, e.g. */
+					/* from a Content-Type header */
+	void		*user;
+
+	/*
+	 * Filled in while parsing.
+	 */
+	struct purehtml	*ctx;		/* parser of the document */
+	size_t		 consumed;	/* bytes parsed */
+	int		 error;		/* errno if the file did not open */
+};
+
+/*
+ * The callbacks get called concurrently from the worker threads, each
+ * of which owns a parser that is reused for all its documents. Use
+ * purehtml_batch_doc() in begin and end to find out the document.
+ */
+struct purehtml_batch {
+	int	 nthreads;		/* online CPUs if zero */
+
+	int	(*begin)(struct node *);
+	int	(*end)(struct node *);
+	void	(*init)(struct purehtml *);	/* optional, set options */
+	void	(*done)(struct purehtml_doc *);	/* optional, result */
+};
+
+size_t			 purehtml_batch(struct purehtml_batch *,
+			    struct purehtml_doc *, size_t);
+struct purehtml_doc	*purehtml_batch_doc(void);
+
+#endif
@@ -0,0 +1,454 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <err.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <dirent.h>
+#include <time.h>
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "purehtml.h"
+
+/*
+ * Measures the tokenizer alone, the dispatcher alone on a token log
+ * recorded beforehand and the whole parser on each input and prints
+ * the results as JSON on stdout.
+ */
+struct sample {
+	char		*name;
+	char		*buf;
+	size_t		 len;
+	char		*log;		/* see tokenlog.h */
+	size_t		 log_len;
+};
+
+struct mem {
+	const char	*p;
+	size_t		 len;
+};
+
+struct phase {
+	double		 secs;		/* best of the runs */
+	size_t		 tokens;
+	size_t		 nodes;
+	size_t		 allocs;	/* per run */
+	long		 rss_kb;	/* peak the runs added */
+};
+
+static void add_path(const char *);
+static void add_dir(const char *);
+static void load(struct sample *, const char *);
+static double now(void);
+static void tokenize_only(struct sample *, struct phase *);
+static void parse(struct sample *, struct phase *);
+static void record(struct sample *);
+static void replay(struct sample *, struct phase *);
+static size_t read_mem(void *, char *, size_t);
+static void measure(struct sample *, struct phase *,
+    void (*)(struct sample *, struct phase *));
+static void print_str(const char *);
+static void print_phase(const char *, struct sample *, struct phase *,
+    int);
+static int begin(struct node *);
+static int end(struct node *);
+
+static struct sample *inputs;
+static size_t ninputs;
+static int runs = 5;
+
+/*
+ * Allocations are counted by the allocator the library is given.
+ */
+static size_t allocs;
+
+static void *
+count_malloc(size_t size)
+{
+	allocs++;
+	return malloc(size);
+}
+
+static void *
+count_realloc(void *ptr, size_t size)
+{
+	allocs++;
+	return realloc(ptr, size);
+}
+
+static const struct allocator counting = { count_malloc, count_realloc, free };
+
+static size_t nodes;
+
+int
+main(int argc, char **argv)
+{
+	struct phase tok, disp, all;
+	size_t i;
+	int ch;
+
+	while ((ch = getopt(argc, argv, "n:")) != -1) {
+		switch (ch) {
+		case 'n':
+			runs = atoi(optarg);
+			break;
+		default:
+			goto usage;
+		}
+	}
+
+	argc -= optind;
+	argv += optind;
+
+	if (argc == 0 || runs <= 0)
+		goto usage;
+
+	while (argc-- > 0)
+		add_path(*argv++);
+
+	purehtml_allocator(&counting);
+
+	printf("{\n\t\"runs\": %d,\n\t\"inputs\": [", runs);
+	for (i = 0; i < ninputs; i++) {
+		record(&inputs[i]);
+		measure(&inputs[i], &tok, tokenize_only);
+		measure(&inputs[i], &disp, replay);
+		measure(&inputs[i], &all, parse);
+		all.tokens = tok.tokens;
+
+		printf("%s\n\t\t{\n\t\t\t\"name\": ", i > 0 ? "," : "");
+		print_str(inputs[i].name);
+		printf(",\n\t\t\t\"bytes\": %zu,\n", inputs[i].len);
+		print_phase("tokenize", &inputs[i], &tok, 0);
+		printf(",\n");
+		print_phase("dispatch", &inputs[i], &disp, 1);
+		printf(",\n");
+		print_phase("parse", &inputs[i], &all, 1);
+		printf("\n\t\t}");
+
+		free(inputs[i].name);
+		free(inputs[i].buf);
+		free(inputs[i].log);
+	}
+	free(inputs);
+
+	printf("\n\t]\n}\n");
+	return 0;
+
+usage:
+	fprintf(stderr, "usage: bench [-n runs] file|dir ...\n");
+	return 1;
+}
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * Run the phase the given number of times in a child process, keeping
+ * the best time and the peak RSS it grew by, which leaves out the
+ * memory of the other phases and of the inputs.
+ */
+static void
+measure(struct sample *input, struct phase *phase,
+    void (*run)(struct sample *, struct phase *))
+{
+	struct rusage ru;
+	double start, secs;
+	long rss;
+	pid_t pid;
+	int fds[2], i, status;
+
+	fflush(stdout);
+	if (pipe(fds) == -1)
+		err(1, "pipe");
+	if ((pid = fork()) == -1)
+		err(1, "fork");
+
+	if (pid == 0) {
+		close(fds[0]);
+		getrusage(RUSAGE_SELF, &ru);
+		rss = ru.ru_maxrss;
+		memset(phase, 0, sizeof(struct phase));
+		for (i = 0; i < runs; i++) {
+			phase->tokens = phase->nodes = phase->allocs = 0;
+			start = now();
+			run(input, phase);
+			secs = now() - start;
+			if (i == 0 || secs < phase->secs)
+				phase->secs = secs;
+		}
+		getrusage(RUSAGE_SELF, &ru);
+		phase->rss_kb = ru.ru_maxrss - rss;
+		if (write(fds[1], phase, sizeof(struct phase)) !=
+		    sizeof(struct phase))
+			err(1, "write");
+		exit(0);
+	}
+
+	close(fds[1]);
+	if (read(fds[0], phase, sizeof(struct phase)) !=
+	    sizeof(struct phase))
+		errx(1, "%s: no result", input->name);
+	close(fds[0]);
+	if (waitpid(pid, &status, 0) == -1 || !WIFEXITED(status) ||
+	    WEXITSTATUS(status) != 0)
+		errx(1, "%s: phase failed", input->name);
+}
+
+/*
+ * The tokenizer with the state switches the dispatcher would ask for
+ * after the start tags of raw text elements.
+ */
+static void
+tokenize_only(struct sample *input, struct phase *phase)
+{
+	static struct purehtml ctx;
+	struct tokenizer *tokenizer;
+	struct token *token;
+	size_t before;
+	int state;
+
+	before = allocs;
+	tokenizer = &ctx.tokenizer;
+	tokenizer->attrs.pool = &ctx.attr_pool;
+	input_buf(&tokenizer->input, input->buf, input->len);
+	while (!INPUT_EOF(&tokenizer->input)) {
+		if ((token = tokenize(tokenizer)) == NULL)
+			continue;
+		phase->tokens++;
+		if (TOKEN_IS_START(token) &&
+		    (state = dispatch_raw_state(token->u.tag.tagid)) !=
+		    STATE_NONE)
+			tokenizer->state = state;
+		if (TOKEN_IS_START_END(token)) {
+			attr_pool_put(&ctx.attr_pool, token->u.tag.attr);
+			token->u.tag.attr = NULL;
+		}
+		token_clear(token);
+	}
+	purehtml_free(&ctx);
+	phase->allocs = allocs - before;
+}
+
+static void
+parse(struct sample *input, struct phase *phase)
+{
+	static struct purehtml ctx;
+	size_t before;
+
+	before = allocs;
+	nodes = 0;
+	purehtml_parse_buf(&ctx, input->buf, input->len, begin, end);
+	phase->nodes = nodes;
+	purehtml_free(&ctx);
+	phase->allocs = allocs - before;
+}
+
+/*
+ * Log the tokens of a parse for replay().
+ */
+static void
+record(struct sample *input)
+{
+	static struct purehtml ctx;
+	struct tokenlog log;
+	FILE *fp;
+
+	if ((fp = open_memstream(&input->log, &input->log_len)) == NULL)
+		err(1, "open_memstream");
+	tokenlog_record(&log, fp);
+	ctx.record = &log;
+	purehtml_parse_buf(&ctx, input->buf, input->len, begin, end);
+	purehtml_free(&ctx);
+	tokenlog_free(&log);
+	if (fclose(fp) != 0)
+		err(1, "token log");
+}
+
+/*
+ * The dispatcher with the tokens read from the log, which costs less
+ * than tokenizing but is not free.
+ */
+static void
+replay(struct sample *input, struct phase *phase)
+{
+	static struct purehtml ctx;
+	struct tokenlog log;
+	struct mem mem;
+	size_t before;
+
+	before = allocs;
+	nodes = 0;
+	mem.p = input->log;
+	mem.len = input->log_len;
+	tokenlog_init(&log, read_mem, &mem);
+	if (purehtml_replay(&ctx, &log, begin, end) > 0 || log.error != NULL)
+		errx(1, "%s: bad token log", input->name);
+	phase->tokens = log.tokens;
+	phase->nodes = nodes;
+	tokenlog_free(&log);
+	purehtml_free(&ctx);
+	phase->allocs = allocs - before;
+}
+
+static size_t
+read_mem(void *user, char *buf, size_t len)
+{
+	struct mem *mem = user;
+
+	if (len > mem->len)
+		len = mem->len;
+	memcpy(buf, mem->p, len);
+	mem->p += len;
+	mem->len -= len;
+	return len;
+}
+
+static int
+begin(struct node *node)
+{
+	nodes++;
+	return CB_CONTINUE;
+}
+
+static int
+end(struct node *node)
+{
+	return CB_CONTINUE;
+}
+
+static void
+print_phase(const char *name, struct sample *input, struct phase *phase,
+    int with_nodes)
+{
+	double secs;
+
+	secs = phase->secs > 0 ? phase->secs : 1e-9;
+	printf("\t\t\t\"%s\": {\n", name);
+	printf("\t\t\t\t\"seconds\": %.6f,\n", phase->secs);
+	printf("\t\t\t\t\"mb_per_s\": %.2f,\n", input->len / secs / 1e6);
+	printf("\t\t\t\t\"tokens\": %zu,\n", phase->tokens);
+	printf("\t\t\t\t\"tokens_per_s\": %.0f,\n", phase->tokens / secs);
+	if (with_nodes) {
+		printf("\t\t\t\t\"nodes\": %zu,\n", phase->nodes);
+		printf("\t\t\t\t\"nodes_per_s\": %.0f,\n",
+		    phase->nodes / secs);
+	}
+	printf("\t\t\t\t\"allocs\": %zu,\n", phase->allocs);
+	printf("\t\t\t\t\"peak_rss_kb\": %ld\n", phase->rss_kb);
+	printf("\t\t\t}");
+}
+
+static void
+print_str(const char *s)
+{
+	putchar('"');
+	for (; *s != '\0'; s++) {
+		if (*s == '"' || *s == '\\')
+			printf("\\%c", *s);
+		else if ((unsigned char) *s < 0x20)
+			printf("\\u%04x", (unsigned char) *s);
+		else
+			putchar(*s);
+	}
+	putchar('"');
+}
+
+static void
+add_path(const char *path)
+{
+	struct stat sb;
+
+	if (stat(path, &sb) == -1) {
+		warn("%s", path);
+		return;
+	}
+
+	if (S_ISDIR(sb.st_mode))
+		add_dir(path);
+	else if (S_ISREG(sb.st_mode)) {
+		inputs = realloc(inputs, (ninputs + 1) * sizeof(struct sample));
+		if (inputs == NULL)
+			err(1, "realloc");
+		load(&inputs[ninputs++], path);
+	}
+}
+
+static void
+add_dir(const char *path)
+{
+	struct dirent **names;
+	char *name;
+	size_t len;
+	int i, n;
+
+	if ((n = scandir(path, &names, NULL, alphasort)) == -1) {
+		warn("%s", path);
+		return;
+	}
+
+	for (i = 0; i < n; i++) {
+		if (*names[i]->d_name != '.') {
+			len = strlen(path) + strlen(names[i]->d_name) + 2;
+			if ((name = malloc(len)) == NULL)
+				err(1, "malloc");
+			snprintf(name, len, "%s/%s", path, names[i]->d_name);
+			add_path(name);
+			free(name);
+		}
+		free(names[i]);
+	}
+	free(names);
+}
+
+static void
+load(struct sample *input, const char *path)
+{
+	FILE *fp;
+	size_t alloc, n;
+
+	if ((fp = fopen(path, "r")) == NULL)
+		err(1, "%s", path);
+
+	input->buf = NULL;
+	input->len = alloc = 0;
+	do {
+		if (input->len == alloc) {
+			alloc = alloc ? alloc * 2 : 65536;
+			if ((input->buf = realloc(input->buf, alloc)) == NULL)
+				err(1, "realloc %s", path);
+		}
+		n = fread(&input->buf[input->len], 1, alloc - input->len, fp);
+		input->len += n;
+	} while (n > 0);
+	fclose(fp);
+
+	if ((input->name = strdup(path)) == NULL)
+		err(1, "strdup");
+}
@@ -0,0 +1,66 @@
+# Compare results.json files of bench, e.g. of the default and of the
+# -DPUREHTML_FAST build: prints the MB/s of each phase of each input in
+# the first and the speedup over it in each of the others, named after
+# the files with "results-" and ".json" stripped.
+#
+#	awk -f bench/compare.awk results.json results-fast.json
+
+FNR == 1 {
+	file++
+	label = FILENAME
+	sub(/.*\//, "", label)
+	sub(/^results-?/, "", label)
+	sub(/\.json$/, "", label)
+	labels[file] = label == "" ? "default" : label
+}
+
+/"name":/ {
+	name = $0
+	sub(/.*"name": "/, "", name)
+	sub(/",?$/, "", name)
+	if (file == 1 && !(name in seen)) {
+		seen[name] = 1
+		names[++ninputs] = name
+	}
+}
+
+/": {$/ && !/"inputs"/ {
+	phase = $1
+	gsub(/[":]/, "", phase)
+	if (file == 1 && !(phase in pseen)) {
+		pseen[phase] = 1
+		phases[++nphases] = phase
+	}
+}
+
+/"mb_per_s":/ {
+	v = $2
+	sub(/,$/, "", v)
+	mbs[file, name, phase] = v
+}
+
+END {
+	printf("%-24s %-10s %10s", "input", "phase", labels[1] " MB/s")
+	for (k = 2; k <= file; k++)
+		printf(" %10s", labels[k])
+	printf("\n")
+	for (i = 1; i <= ninputs; i++) {
+		n = names[i]
+		short = n
+		sub(/.*\//, "", short)
+		for (j = 1; j <= nphases; j++) {
+			p = phases[j]
+			if (!((1, n, p) in mbs))
+				continue
+			a = mbs[1, n, p]
+			printf("%-24s %-10s %10.2f", short, p, a)
+			for (k = 2; k <= file; k++) {
+				if (!((k, n, p) in mbs) || a == 0)
+					printf(" %10s", "-")
+				else
+					printf(" %9.2fx", mbs[k, n, p] / a)
+			}
+			printf("\n")
+		}
+	}
+}
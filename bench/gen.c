@@ -0,0 +1,325 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <err.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ * Generates synthetic HTML of a given shape for benchmarking. The
+ * output depends only on the shape, the size and the seed.
+ */
+static void deep(void);
+static void table(void);
+static void text(void);
+static void attrs(void);
+static void script(void);
+static void entities(void);
+static void soup(void);
+
+static const struct shape {
+	const char	*name;
+	void		 (*gen)(void);
+	const char	*about;
+} shapes[] = {
+	{ "deep",	deep,		"deeply nested elements" },
+	{ "table",	table,		"wide tables" },
+	{ "text",	text,		"giant text nodes" },
+	{ "attrs",	attrs,		"elements with many attributes" },
+	{ "script",	script,		"script and style heavy page" },
+	{ "entities",	entities,	"text dense with character references" },
+	{ "soup",	soup,		"misnested and unclosed tags" },
+};
+
+static size_t size = 4 * 1024 * 1024;
+static size_t out;
+static uint64_t seed = 1;
+
+static const char *words[] = {
+	"lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing",
+	"elit", "sed", "do", "eiusmod", "tempor", "incididunt", "ut", "labore",
+	"et", "dolore", "magna", "aliqua", "enim", "ad", "minim", "veniam",
+	"quis", "nostrud", "exercitation", "ullamco", "laboris", "nisi",
+	"aliquip", "ex", "ea", "commodo", "consequat"
+};
+#define NWORDS	(sizeof(words) / sizeof(words[0]))
+
+/*
+ * xorshift64*, good enough and the same everywhere.
+ */
+static size_t
+rnd(size_t n)
+{
+	seed ^= seed >> 12;
+	seed ^= seed << 25;
+	seed ^= seed >> 27;
+	return (size_t) ((seed * 0x2545f4914f6cdd1dULL) >> 32) % n;
+}
+
+static void
+put(const char *s)
+{
+	out += strlen(s);
+	fputs(s, stdout);
+}
+
+static int
+more(void)
+{
+	return out < size;
+}
+
+static void
+put_words(size_t n)
+{
+	while (n-- > 0) {
+		put(words[rnd(NWORDS)]);
+		if (n > 0)
+			put(" ");
+	}
+}
+
+static void
+head(const char *title)
+{
+	put("<!DOCTYPE html>\n<html><head><meta charset=utf-8><title>");
+	put(title);
+	put("</title></head>\n<body>\n");
+}
+
+static void
+deep(void)
+{
+	char span[1000];
+	size_t i, depth;
+
+	head("deep");
+	while (more()) {
+		depth = 200 + rnd(sizeof(span) - 200);
+		for (i = 0; i < depth; i++) {
+			span[i] = (rnd(4) == 0);
+			put(span[i] ? "<span>" : "<div class=d>");
+		}
+		put_words(3);
+		while (i-- > 0)
+			put(span[i] ? "</span>" : "</div>");
+		put("\n");
+	}
+}
+
+static void
+table(void)
+{
+	size_t i, cols;
+	char s[32];
+
+	head("table");
+	while (more()) {
+		cols = 50 + rnd(150);
+		put("<table>\n<thead><tr>");
+		for (i = 0; i < cols; i++) {
+			snprintf(s, sizeof(s), "<th>c%zu", i);
+			put(s);
+		}
+		put("\n<tbody>\n");
+		for (i = 0; i < cols * 20; i++) {
+			if (i % cols == 0)
+				put(rnd(2) ? "<tr>" : "</tr><tr>");
+			snprintf(s, sizeof(s), rnd(2) ? "<td>%zu" : "<td>%zu</td>",
+			    rnd(100000));
+			put(s);
+			if (i % cols == cols - 1)
+				put("\n");
+		}
+		put("</table>\n");
+	}
+}
+
+static void
+text(void)
+{
+	head("text");
+	while (more()) {
+		put("<p>");
+		while (more() && rnd(100000) != 0) {
+			put_words(1 + rnd(12));
+			put(rnd(8) ? " " : ".\n");
+		}
+		put("</p>\n");
+	}
+}
+
+static void
+attrs(void)
+{
+	size_t i, n;
+	char s[64];
+
+	head("attrs");
+	while (more()) {
+		put("<div");
+		n = 5 + rnd(40);
+		for (i = 0; i < n; i++) {
+			switch (rnd(4)) {
+			case 0:
+				snprintf(s, sizeof(s), " data-a%zu=\"%s %s\"",
+				    i, words[rnd(NWORDS)], words[rnd(NWORDS)]);
+				break;
+			case 1:
+				snprintf(s, sizeof(s), " aria-%s='%zu'",
+				    words[rnd(NWORDS)], rnd(1000));
+				break;
+			case 2:
+				snprintf(s, sizeof(s), " x%zu=%s", i,
+				    words[rnd(NWORDS)]);
+				break;
+			default:
+				snprintf(s, sizeof(s), " %s", words[rnd(NWORDS)]);
+				break;
+			}
+			put(s);
+		}
+		put(">");
+		put_words(2);
+		put("</div>\n");
+	}
+}
+
+static void
+script(void)
+{
+	size_t i, n;
+
+	head("script");
+	while (more()) {
+		put("<script>\n");
+		n = 20 + rnd(200);
+		for (i = 0; i < n; i++) {
+			switch (rnd(4)) {
+			case 0:
+				put("if (a < b && c > d) { x = '</div>'; }\n");
+				break;
+			case 1:
+				put("document.write('<p>' + s + '</p>');\n");
+				break;
+			case 2:
+				put("var s = \"</scr\" + \"ipt>\"; // </p>\n");
+				break;
+			default:
+				put("for (i = 0; i < n; i++) f(i);\n");
+				break;
+			}
+		}
+		put("</script>\n<style>\n");
+		n = 5 + rnd(50);
+		for (i = 0; i < n; i++)
+			put("div > p:first-child { margin: 0 <1em>; }\n");
+		put("</style>\n<p>");
+		put_words(10);
+		put("</p>\n");
+	}
+}
+
+static void
+entities(void)
+{
+	static const char *refs[] = {
+		"&amp;", "&lt;", "&gt;", "&quot;", "&nbsp;", "&eacute;",
+		"&copy;", "&#169;", "&#x27;", "&#x1F600;", "&hellip;", "&amp",
+		"&notit;", "&mdash;"
+	};
+
+	head("entities");
+	while (more()) {
+		put("<p title=\"a&amp;b&lt;c\">");
+		while (rnd(50) != 0) {
+			put(refs[rnd(sizeof(refs) / sizeof(refs[0]))]);
+			if (rnd(2))
+				put_words(1);
+		}
+		put("</p>\n");
+	}
+}
+
+static void
+soup(void)
+{
+	static const char *tags[] = {
+		"<b>", "</b>", "<i>", "</i>", "<p>", "</p>", "<a href=x>",
+		"</a>", "<li>", "</ul>", "<ul>", "<table>", "<td>", "</tr>",
+		"</table>", "<div>", "</span>", "<font size=2>", "</font>",
+		"<br/>", "</br>", "<form>", "<select><option>", "<h1>",
+		"</h2>", "<nobr>", "<em>"
+	};
+
+	head("soup");
+	while (more()) {
+		put(tags[rnd(sizeof(tags) / sizeof(tags[0]))]);
+		if (rnd(3) == 0)
+			put_words(1 + rnd(4));
+		if (rnd(200) == 0)
+			put("</body></html>\n<body>");
+	}
+}
+
+int
+main(int argc, char **argv)
+{
+	const struct shape *shape;
+	size_t i;
+	int ch;
+
+	while ((ch = getopt(argc, argv, "s:n:")) != -1) {
+		switch (ch) {
+		case 's':
+			seed = strtoull(optarg, NULL, 0);
+			if (seed == 0)
+				seed = 1;
+			break;
+		case 'n':
+			size = strtoull(optarg, NULL, 0);
+			break;
+		default:
+			goto usage;
+		}
+	}
+
+	argc -= optind;
+	argv += optind;
+
+	if (argc != 1)
+		goto usage;
+
+	for (i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++) {
+		shape = &shapes[i];
+		if (strcmp(*argv, shape->name) == 0) {
+			shape->gen();
+			put("\n</body></html>\n");
+			return 0;
+		}
+	}
+
+usage:
+	fprintf(stderr, "usage: gen [-s seed] [-n bytes] shape\n");
+	for (i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++)
+		fprintf(stderr, "\t%s\t%s\n", shapes[i].name, shapes[i].about);
+	return 1;
+}
@@ -0,0 +1,260 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <err.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "purehtml.h"
+#include "node.h"
+
+/*
+ * Parses inputs of pathological shapes at sizes n, 2n, 4n and 8n and
+ * fails if the time per item at 8n is more than TOLERANCE times that
+ * at n, which a quadratic path would make about 8. With -x the inputs
+ * are given as a file to a command instead, e.g. to webgem.
+ */
+#define TOLERANCE	2.5
+#define RUNS		3
+
+static void attrs(struct str *, size_t);
+static void deep(struct str *, size_t);
+static void scope(struct str *, size_t);
+static void text(struct str *, size_t);
+static void links(struct str *, size_t);
+
+static const struct shape {
+	const char	*name;
+	void		 (*gen)(struct str *, size_t);
+	size_t		 n;
+	const char	*about;
+} shapes[] = {
+	{ "attrs",	attrs,	4000,	"attributes on one element" },
+	{ "deep",	deep,	4000,	"nested elements" },
+	{ "scope",	scope,	4000,	"end tags not in scope below nesting" },
+	{ "text",	text,	1 << 20, "bytes of one text node" },
+	{ "links",	links,	8000,	"distinct links" },
+};
+
+static double	now(void);
+static double	measure(const struct shape *, size_t);
+static void	put(struct str *, const char *);
+static int	begin(struct node *);
+static int	end(struct node *);
+
+static const char *command;
+
+int
+main(int argc, char **argv)
+{
+	const struct shape *shape;
+	double t[4], ratio;
+	size_t i, j;
+	int ch, failed;
+
+	while ((ch = getopt(argc, argv, "x:")) != -1) {
+		switch (ch) {
+		case 'x':
+			command = optarg;
+			break;
+		default:
+			goto usage;
+		}
+	}
+
+	argc -= optind;
+	argv += optind;
+
+	failed = 0;
+	for (i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++) {
+		shape = &shapes[i];
+		for (j = 0; j < (size_t) argc; j++)
+			if (strcmp(argv[j], shape->name) == 0)
+				break;
+		if (argc > 0 && j == (size_t) argc)
+			continue;
+
+		for (j = 0; j < 4; j++)
+			t[j] = measure(shape, shape->n << j);
+		ratio = (t[3] / 8) / (t[0] > 0 ? t[0] : 1e-9);
+
+		printf("%-8s", shape->name);
+		for (j = 0; j < 4; j++)
+			printf(" %9.2f ms", t[j] * 1e3);
+		printf("  x%.2f %s\n", ratio, ratio <= TOLERANCE ? "ok" :
+		    "FAIL");
+		if (ratio > TOLERANCE) {
+			printf("\t%zu..%zu %s grow worse than linearly\n",
+			    shape->n, shape->n << 3, shape->about);
+			failed = 1;
+		}
+	}
+
+	return failed;
+
+usage:
+	fprintf(stderr, "usage: scale [-x command] [shape ...]\n");
+	return 1;
+}
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * Best of RUNS.
+ */
+static double
+measure(const struct shape *shape, size_t n)
+{
+	static struct purehtml ctx;
+	char path[] = "/tmp/scale.XXXXXX", cmd[1024];
+	struct str html = { 0 };
+	double best, start, secs;
+	FILE *fp;
+	int i, fd;
+
+	shape->gen(&html, n);
+
+	fd = -1;
+	if (command != NULL) {
+		if ((fd = mkstemp(path)) == -1)
+			err(1, "mkstemp");
+		if ((fp = fdopen(fd, "w")) == NULL)
+			err(1, "fdopen");
+		fwrite(html.s, 1, html.len, fp);
+		fclose(fp);
+		snprintf(cmd, sizeof(cmd), "%s %s >/dev/null", command, path);
+	}
+
+	best = 0;
+	for (i = 0; i < RUNS; i++) {
+		start = now();
+		if (command != NULL) {
+			if (system(cmd) != 0)
+				errx(1, "%s failed", cmd);
+		} else {
+			purehtml_parse_buf(&ctx, html.s, html.len, begin, end);
+			purehtml_free(&ctx);
+		}
+		secs = now() - start;
+		if (i == 0 || secs < best)
+			best = secs;
+	}
+
+	if (command != NULL)
+		unlink(path);
+	mem_free(html.s);
+	return best;
+}
+
+static void
+put(struct str *s, const char *p)
+{
+	while (*p != '\0')
+		str_add(s, *p++);
+}
+
+static void
+attrs(struct str *s, size_t n)
+{
+	char buf[32];
+	size_t i;
+
+	put(s, "<p");
+	for (i = 0; i < n; i++) {
+		snprintf(buf, sizeof(buf), " a%zu=x", i);
+		put(s, buf);
+	}
+	put(s, ">x</p>");
+}
+
+static void
+deep(struct str *s, size_t n)
+{
+	size_t i;
+
+	for (i = 0; i < n; i++)
+		put(s, "<div>");
+	for (i = 0; i < n; i++)
+		put(s, "</div>");
+}
+
+/*
+ * Each </p> looks for a p in button scope below n elements and finds
+ * none.
+ */
+static void
+scope(struct str *s, size_t n)
+{
+	size_t i;
+
+	for (i = 0; i < n; i++)
+		put(s, "<div>");
+	for (i = 0; i < n; i++)
+		put(s, "</p>");
+}
+
+static void
+text(struct str *s, size_t n)
+{
+	size_t i;
+
+	put(s, "<p>");
+	for (i = 0; i < n; i++)
+		str_add(s, 'a' + i % 26);
+	put(s, "</p>");
+}
+
+static void
+links(struct str *s, size_t n)
+{
+	char buf[64];
+	size_t i;
+
+	put(s, "<ul>");
+	for (i = 0; i < n; i++) {
+		snprintf(buf, sizeof(buf), "<li><a href=\"/%zu\">%zu</a>", i,
+		    i);
+		put(s, buf);
+	}
+	put(s, "</ul>");
+}
+
+static int
+begin(struct node *node)
+{
+	if (node->type == NODE_CDATA)
+		node_free(node);
+	return CB_CONTINUE;
+}
+
+static int
+end(struct node *node)
+{
+	node_free(node);
+	return CB_CONTINUE;
+}
@@ -18,8 +18,10 @@
 
 #include "cdata.h"
 #include "util.h"
+#include "stats.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <err.h>
 
 struct cdata *
@@ -27,14 +29,34 @@ cdata_create(T_CDATA type)
 {
 	struct cdata *cdata;
 
-	cdata = calloc(1, sizeof(struct cdata));
+	cdata = mem_calloc(1, sizeof(struct cdata));
 	if (cdata == NULL)
 		err(1, "calloc cdata");
+	STATS_ADD(allocs[ALLOC_CDATA], 1);
 	cdata->type = type;
 
 	return cdata;
 }
 
+struct cdata *
+cdata_copy(struct cdata *cdata)
+{
+	struct cdata *copy;
+
+	copy = cdata_create(cdata->type);
+	if (cdata->data.s != NULL) {
+		copy->data.alloc = cdata->data.len + 1;
+		copy->data.len = cdata->data.len;
+		copy->data.s = mem_malloc(copy->data.alloc);
+		if (copy->data.s == NULL)
+			err(1, "malloc cdata");
+		STATS_ADD(allocs[ALLOC_CDATA], 1);
+		memcpy(copy->data.s, cdata->data.s, copy->data.alloc);
+	}
+
+	return copy;
+}
+
 void
 cdata_add(struct cdata *cdata, const char *s)
 {
@@ -52,6 +74,6 @@ void
 cdata_free(struct cdata *cdata)
 {
 	if (cdata->data.s != NULL)
-		free(cdata->data.s);
-	free(cdata);
+		mem_free(cdata->data.s);
+	mem_free(cdata);
 }
@@ -37,6 +37,7 @@ struct cdata {
 };
 
 struct cdata	*cdata_create(T_CDATA);
+struct cdata	*cdata_copy(struct cdata *);
 void		 cdata_add(struct cdata *, const char *);
 void		 cdata_free(struct cdata *);
 size_t		 cdata_size(struct cdata *);
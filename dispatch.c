@@ -24,42 +24,406 @@
 #include "ostack.h"
 #include "cdata.h"
 #include "elem.h"
+#include "attr.h"
+#include "stats.h"
 
 #include <stdlib.h>
 #include <assert.h>
 #include <err.h>
 #include <stdarg.h>
+#include <string.h>
 
-#include "imodes.c"
 #include "states.h"
 
+struct elem_view {
+	struct node	node;
+	struct elem	elem;
+};
+
+static void clear_view(struct dispatcher *, struct elem *);
 static void insert_char(struct dispatcher *, struct token *);
 static void insert_close_tag(struct dispatcher *, struct token *);
 static void insert_token_set_mode(struct dispatcher *, struct token *, IMODE);
 static int insert_token_with_mode(struct dispatcher *, struct token *, IMODE);
 static struct elem *pop(struct dispatcher *);
-static void print_err(struct dispatcher *, struct token *, IMODE, const char *);
+static void print_err(struct dispatcher *, struct token *, enum errors);
+static int skip_token(struct dispatcher *, struct token *);
 
 /* helper */
 int
 dispatch(struct dispatcher *ctx, struct token *token,
-    void (*begin)(struct node *), void(*end)(struct node *))
+    int (*begin)(struct node *), int (*end)(struct node *))
 {
+	int state;
+
 	ctx->begin = begin;
 	ctx->end = end;
-	return insert_token_with_mode(ctx, token, ctx->mode);
+
+	if (ctx->stop)
+		return STATE_NONE;
+
+	if (ctx->skip != NULL)
+		return skip_token(ctx, token);
+
+	state = insert_token_with_mode(ctx, token, ctx->mode);
+	if (ctx->skip != NULL && ctx->skip_state == STATE_NONE) {
+		switch (state) {
+		case STATE_RCDATA:
+			ctx->skip_state = STATE_SKIP_RCDATA;
+			break;
+		case STATE_RAWTEXT:
+			ctx->skip_state = STATE_SKIP_RAWTEXT;
+			break;
+		case STATE_SCRIPT_DATA:
+			ctx->skip_state = STATE_SKIP_SCRIPT_DATA;
+			break;
+		default:
+			return state;
+		}
+		return ctx->skip_state;
+	}
+	return state;
+}
+
+/*
+ * Release what an element view took over from its token, giving the
+ * attributes back to the pool if there is one.
+ */
+static void
+clear_view(struct dispatcher *ctx, struct elem *elem)
+{
+	if (ctx->attr_pool != NULL) {
+		attr_pool_put(ctx->attr_pool, elem->attr);
+		elem->attr = NULL;
+	}
+	elem_clear(elem);
+}
+
+static void
+skip_end(struct dispatcher *ctx)
+{
+	ctx->skip = NULL;
+	ctx->skip_depth = 0;
+	ctx->skip_state = STATE_NONE;
+	ctx->skip_raw = 0;
+}
+
+/*
+ * The state insert_token_with_mode() switches the tokenizer to after
+ * the start tag of a raw text element, or STATE_NONE for the ones it
+ * leaves in the data state, such as textarea and noscript.
+ */
+int
+dispatch_raw_state(int tagid)
+{
+	switch (tagid) {
+	case TAG_TITLE:
+		return STATE_RCDATA;
+	case TAG_STYLE:
+	case TAG_NOFRAMES:
+		return STATE_RAWTEXT;
+	case TAG_SCRIPT:
+		return STATE_SCRIPT_DATA;
+	case TAG_PLAINTEXT:
+		return STATE_PLAINTEXT;
+	default:
+		return STATE_NONE;
+	}
+}
+
+/*
+ * The state the content of a skipped raw text element is tokenized in.
+ */
+static int
+skip_raw_state(int tagid)
+{
+	switch (dispatch_raw_state(tagid)) {
+	case STATE_RCDATA:
+		return STATE_SKIP_RCDATA;
+	case STATE_RAWTEXT:
+		return STATE_SKIP_RAWTEXT;
+	case STATE_SCRIPT_DATA:
+		return STATE_SKIP_SCRIPT_DATA;
+	default:
+		return dispatch_raw_state(tagid);
+	}
+}
+
+/*
+ * Release what is still held after parsing was stopped: the pending
+ * text and the elements left on the open elements stack. Callbacks
+ * are not called for these.
+ */
+void
+dispatch_unwind(struct dispatcher *ctx)
+{
+	struct elem *elem;
+
+	if (ctx->cdata != NULL) {
+		str_add(&ctx->cdata->data, '\0');
+		ctx->cdata = NULL;
+	}
+
+	while ((elem = ostack_pop(&ctx->ostack)) != NULL)
+		clear_view(ctx, elem);
+
+	skip_end(ctx);
+	ctx->head_elem = NULL;
+	ctx->pre_depth = 0;
+}
+
+/*
+ * Release everything held by the dispatcher.
+ */
+void
+dispatch_free(struct dispatcher *ctx)
+{
+	size_t i;
+
+	dispatch_unwind(ctx);
+
+	for (i = 0; i < ctx->views_alloc; i++)
+		mem_free(ctx->views[i]);
+	mem_free(ctx->views);
+	ctx->views = NULL;
+	ctx->views_alloc = 0;
+
+	ostack_free(&ctx->ostack);
+
+	mem_free(ctx->cdata_buf.data.s);
+	memset(&ctx->cdata_buf.data, 0, sizeof(struct str));
+}
+
+/*
+ * Minimal tree construction while the children of ctx->skip are being
+ * skipped: no nodes are built and we only count nesting of elements
+ * with the same name. The skip ends when the matching end tag, an end
+ * tag of an open ancestor, or an implicitly closing start tag arrives.
+ * That token is then processed normally so the tree stays correct.
+ * The content of raw text children is skipped up to their end tag.
+ */
+static int
+skip_token(struct dispatcher *ctx, struct token *token)
+{
+	struct elem *elem;
+	size_t i;
+	int tagid;
+	int same;
+	int below;
+
+	if (ctx->skip_raw != 0) {
+		if (!TOKEN_IS_END(token) ||
+		    token->u.tag.tagid != ctx->skip_raw)
+			return skip_raw_state(ctx->skip_raw);
+		ctx->skip_raw = 0;
+		return ctx->skip_state;
+	}
+
+	if (!TOKEN_IS_START_END(token))
+		return ctx->skip_state;
+
+	tagid = token->u.tag.tagid;
+	same = (tagid == ctx->skip->tagid &&
+	    (tagid != TAG_CUSTOM_TAG ||
+	    strcmp(token->u.tag.name, ctx->skip->name) == 0));
+
+	if (TOKEN_IS_START(token)) {
+		if (ctx->skip_depth == 0 && ctx->skip_state == STATE_NONE &&
+		    ((same && tagmap(tagid)->flags & TAG_OPTIONAL_CLOSE) ||
+		    (ctx->skip->tagid == TAG_P &&
+		    tagmap(tagid)->flags & TAG_BLOCK))) {
+			skip_end(ctx);
+			return dispatch(ctx, token, ctx->begin, ctx->end);
+		}
+		if (same && !(tagmap(tagid)->flags & TAG_EMPTY))
+			ctx->skip_depth++;
+		if (skip_raw_state(tagid) != STATE_NONE) {
+			ctx->skip_raw = tagid;
+			return skip_raw_state(tagid);
+		}
+		return ctx->skip_state;
+	}
+
+	if (same) {
+		if (ctx->skip_depth > 0) {
+			ctx->skip_depth--;
+			return ctx->skip_state;
+		}
+		skip_end(ctx);
+		return dispatch(ctx, token, ctx->begin, ctx->end);
+	}
+
+	below = 0;
+	for (i = ostack_depth(&ctx->ostack); i >= 1; i--) {
+		elem = ostack_peek_at(&ctx->ostack, i);
+		if (elem == ctx->skip)
+			below = 1;
+		else if (below && elem->tagid == tagid) {
+			skip_end(ctx);
+			return dispatch(ctx, token, ctx->begin, ctx->end);
+		}
+	}
+
+	return ctx->skip_state;
+}
+
+/*
+ * Nodes are not delivered while a subtree is skipped or after a
+ * callback asked us to stop.
+ */
+static int
+silent(struct dispatcher *ctx)
+{
+	return (ctx->skip != NULL || ctx->stop);
+}
+
+static int
+callback(struct dispatcher *ctx, int (*cb)(struct node *), struct node *node)
+{
+	int verdict;
+
+	verdict = cb(node);
+	if (verdict == CB_STOP)
+		ctx->stop = 1;
+
+	return verdict;
+}
+
+static int
+is_block(int tagid)
+{
+	return ((tagmap(tagid)->flags & TAG_BLOCK) != 0);
+}
+
+/*
+ * Whitespace-only text is never rendered in the head and table modes,
+ * and in the body it collapses away next to a block boundary unless
+ * it is inside a preformatted element.
+ */
+static int
+is_elidable(struct dispatcher *ctx, int tagid)
+{
+	if (!ctx->elide_space || !ctx->cdata_space || ctx->cdata_sent ||
+	    ctx->pre_depth > 0)
+		return 0;
+
+	switch (ctx->cdata_mode) {
+	case IMODE_IN_BODY:
+	case IMODE_IN_CELL:
+	case IMODE_IN_CAPTION:
+		return (ctx->cdata_block || is_block(tagid));
+	default:
+		return 1;
+	}
+}
+
+/*
+ * Deliver the pending text at the boundary of the element tagid.
+ */
+static void
+flush_cdata(struct dispatcher *ctx, int (*cb)(struct node *), int tagid)
+{
+	struct node *node;
+
+	if (ctx->cdata == NULL)
+		return;
+
+	node = ctx->cdata->node;
+	if (!silent(ctx) && !is_elidable(ctx, tagid)) {
+		if (ctx->text != NULL) {
+			if (ctx->text(node, 1) == CB_STOP)
+				ctx->stop = 1;
+		} else
+			callback(ctx, cb, node);
+	}
+
+	str_add(&ctx->cdata->data, '\0');
+	ctx->cdata = NULL;
 }
 
 static void
 insert_char(struct dispatcher *ctx, struct token *token)
 {
+	const char *s;
+
 	assert(token->type == TOKEN_CHAR);
 
-	if (ctx->cdata == NULL)
-		ctx->cdata = cdata_create(CDATA_TEXT);
+	if (ctx->cdata == NULL) {
+		ctx->cdata_buf.type = CDATA_TEXT;
+		ctx->cdata_buf.node = &ctx->cdata_node;
+		ctx->cdata_node.type = NODE_CDATA;
+		ctx->cdata_node.view = 1;
+		ctx->cdata_node.u.cdata = &ctx->cdata_buf;
+		ctx->cdata = &ctx->cdata_buf;
+		ctx->cdata_mode = ctx->mode;
+		ctx->cdata_space = 1;
+		ctx->cdata_sent = 0;
+		ctx->cdata_block = ctx->last_block;
+	}
+
+	for (s = token->s.s; ctx->cdata_space && *s != '\0'; s++)
+		if (!HTML_ISSPACE(*s))
+			ctx->cdata_space = 0;
 
 	cdata_add(ctx->cdata, token->s.s);
 	token->used = 1;
+
+	/*
+	 * In streaming mode the text is delivered in pieces as soon as
+	 * it grows past the threshold; the final piece is delivered by
+	 * flush_cdata() at the element boundary.
+	 */
+	if (ctx->text != NULL && ctx->cdata->data.len >=
+	    (ctx->text_max > 0 ? ctx->text_max : TEXT_MAX)) {
+		if (!silent(ctx) && ctx->text(ctx->cdata->node, 0) == CB_STOP)
+			ctx->stop = 1;
+		str_add(&ctx->cdata->data, '\0');
+		ctx->cdata_sent = 1;
+	}
+}
+
+/*
+ * Elements are passed to the callbacks as views living in a slot per
+ * open elements stack depth, so nothing gets allocated for them unless
+ * a callback asks for a copy with node_retain(). The view takes over
+ * the name and attributes of the token until the element is closed.
+ */
+static struct elem *
+elem_view(struct dispatcher *ctx, struct token *token)
+{
+	struct elem_view *view;
+	size_t depth;
+
+	depth = ostack_depth(&ctx->ostack);
+	if (depth >= ctx->views_alloc) {
+		ctx->views = mem_realloc(ctx->views,
+		    (depth + 1) * 2 * sizeof(struct elem_view *));
+		if (ctx->views == NULL)
+			err(1, "realloc views");
+		STATS_ADD(allocs[ALLOC_VIEW], 1);
+		while (ctx->views_alloc < (depth + 1) * 2) {
+			view = mem_malloc(sizeof(struct elem_view));
+			if (view == NULL)
+				err(1, "malloc view");
+			STATS_ADD(allocs[ALLOC_VIEW], 1);
+			ctx->views[ctx->views_alloc++] = view;
+		}
+	}
+
+	view = ctx->views[depth];
+	memset(view, 0, sizeof(struct elem_view));
+	view->elem.tagid = token->u.tag.tagid;
+	view->elem.name = token->u.tag.name;
+	view->elem.shared_name = token->u.tag.shared_name;
+	view->elem.attr = token->u.tag.attr;
+	view->elem.node = &view->node;
+	view->node.type = NODE_ELEM;
+	view->node.view = 1;
+	view->node.u.elem = &view->elem;
+	token->used = 1;
+
+	assert(view->elem.name != NULL);
+	return &view->elem;
 }
 
 static struct elem *
@@ -67,29 +431,44 @@ insert_element_ns(struct dispatcher *ctx, struct token *token, int ns)
 {
 	struct elem *elem;
 	struct node *node;
+	int verdict;
 
 	assert(token->type == TOKEN_START_TAG);
 
-	if (ctx->cdata != NULL) {
-		ctx->begin(node_create_from_cdata(ctx->cdata));
-		ctx->cdata = NULL;
-	}
-
-	elem = elem_create_from_token(token);
-	elem->attr = token->u.tag.attr;
+	flush_cdata(ctx, ctx->begin, token->u.tag.tagid);
 
+	elem = elem_view(ctx, token);
 	if (elem->tagid)
 		ctx->head_elem = elem;
 
-	node = node_create_from_elem(elem);
-	ctx->begin(node);
+	node = elem->node;
 
-	if (!(tagmap(elem->tagid)->flags & TAG_EMPTY)) {
-		ostack_push(elem);
-	} else
-		ctx->end(node);
+	/*
+	 * Implied elements can still get inserted below a skipped one
+	 * while the token that started the skip is being processed.
+	 */
+	if (silent(ctx))
+		verdict = CB_CONTINUE;
+	else
+		verdict = callback(ctx, ctx->begin, node);
 
-	token->used = 1;
+	ctx->last_block = is_block(elem->tagid);
+
+	if (!(tagmap(elem->tagid)->flags & TAG_EMPTY)) {
+		ostack_push(&ctx->ostack, elem);
+		if (tagmap(elem->tagid)->flags & TAG_PREFORMATTED)
+			ctx->pre_depth++;
+		if (verdict == CB_SKIP && ctx->skip == NULL) {
+			ctx->skip = elem;
+			ctx->skip_depth = 0;
+			ctx->skip_state = STATE_NONE;
+			ctx->skip_raw = 0;
+		}
+	} else {
+		if (!silent(ctx))
+			callback(ctx, ctx->end, node);
+		clear_view(ctx, elem);
+	}
 
 	return elem;
 }
@@ -150,14 +529,22 @@ insert_tag_name_set_mode(struct dispatcher *ctx, const char *name, int close,
 static void
 close_tag(struct dispatcher *ctx, struct elem *elem)
 {
-	if (ctx->cdata != NULL) {
-		ctx->end(node_create_from_cdata(ctx->cdata));
-		ctx->cdata = NULL;
-	}
+	flush_cdata(ctx, ctx->end, elem->tagid);
 
-	ostack_pop();
+	ostack_pop(&ctx->ostack);
 	assert(elem->node != NULL);
-	ctx->end(elem->node);
+
+	if (tagmap(elem->tagid)->flags & TAG_PREFORMATTED)
+		ctx->pre_depth--;
+	ctx->last_block = is_block(elem->tagid);
+
+	if (ctx->skip == elem)
+		skip_end(ctx);
+
+	if (!silent(ctx))
+		callback(ctx, ctx->end, elem->node);
+
+	clear_view(ctx, elem);
 }
 
 static void
@@ -167,7 +554,7 @@ insert_close_tag(struct dispatcher *ctx, struct token *token)
 
 	assert(token->type == TOKEN_END_TAG);
 
-	elem = ostack_peek();
+	elem = ostack_peek(&ctx->ostack);
 	close_tag(ctx, elem);
 
 	token->used = 0;
@@ -183,17 +570,18 @@ insert_close_tag_set_mode(struct dispatcher *ctx, struct token *token,
 }
 
 static int
-is_open(int num_args, ...)
+is_open(struct dispatcher *ctx, int num_args, ...)
 {
 	size_t sz, i, j;
 	va_list ap;
 
-	sz = ostack_depth();
+	sz = ostack_depth(&ctx->ostack);
 
 	for (i = sz; i >= 1; i--)  {
 		va_start(ap, num_args);
 		for (j = 0; j < num_args; j++)
-			if (ostack_peek_at(i)->tagid == va_arg(ap, int))
+			if (ostack_peek_at(&ctx->ostack, i)->tagid ==
+			    va_arg(ap, int))
 				return 1;
 		va_end(ap);
 	}
@@ -202,24 +590,25 @@ is_open(int num_args, ...)
 }
 
 static int
-is_open_other_than(int num_args, ...)
+is_open_other_than(struct dispatcher *ctx, int num_args, ...)
 {
 	size_t sz, i, j;
 	va_list ap;
 	int found;
 
-	sz = ostack_depth();
+	sz = ostack_depth(&ctx->ostack);
 	found = 0;
 	for (i = sz; i >= 1; i--)  {
 		va_start(ap, num_args);
 		found = 0;
 		for (j = 0; j < num_args; j++) {
-			if (ostack_peek_at(i)->tagid == va_arg(ap, int)) {
+			if (ostack_peek_at(&ctx->ostack, i)->tagid ==
+			    va_arg(ap, int)) {
 				found++;
 			}
 		}
 		if (found == 0)
-			return ostack_peek_at(i)->tagid;
+			return ostack_peek_at(&ctx->ostack, i)->tagid;
 		va_end(ap);
 	}
 
@@ -240,9 +629,9 @@ generate_implied_end_tags_thoroughly(struct dispatcher *ctx)
 {
 	size_t sz, i;
 
-	sz = ostack_depth();
+	sz = ostack_depth(&ctx->ostack);
 	for (i = sz; i >= 1; i--) {
-		switch (ostack_peek_at(i)->tagid) {
+		switch (ostack_peek_at(&ctx->ostack, i)->tagid) {
 		case TAG_CAPTION:
 		case TAG_COLGROUP:
 		case TAG_DD:
@@ -274,12 +663,12 @@ generate_implied_end_tags(struct dispatcher *ctx, int except)
 {
 	size_t sz, i;
 
-	sz = ostack_depth();
+	sz = ostack_depth(&ctx->ostack);
 	for (i = sz; i >= 1; i--) {
-		if (ostack_peek_at(i)->tagid == except)
+		if (ostack_peek_at(&ctx->ostack, i)->tagid == except)
 			return 0;
 
-		switch (ostack_peek_at(i)->tagid) {
+		switch (ostack_peek_at(&ctx->ostack, i)->tagid) {
 		case TAG_DD:
 		case TAG_DT:
 		case TAG_LI:
@@ -303,20 +692,25 @@ static int
 close_p_element(struct dispatcher *ctx)
 {
 	generate_implied_end_tags(ctx, TAG_P);
-	if (ostack_peek()->tagid != TAG_P)
+	if (ostack_peek(&ctx->ostack)->tagid != TAG_P)
 		return 0;
 	pop(ctx);
 	return 1;
 }
 
 static int
-has_element_in_scope(int target, int scope)
+has_element_in_scope(struct dispatcher *ctx, int target, int scope)
 {
 	size_t sz, i;
 
-	sz = ostack_depth();
+	STATS_ADD(scope_checks, 1);
+	if (ostack_count(&ctx->ostack, target) == 0)
+		return 0;
+
+	sz = ostack_depth(&ctx->ostack);
 	for (i = sz; i >= 1; i--) {
-		if (ostack_peek_at(i)->tagid == target)
+		STATS_ADD(scope_scanned, 1);
+		if (ostack_peek_at(&ctx->ostack, i)->tagid == target)
 			return 1;
 
 		/*
@@ -324,7 +718,7 @@ has_element_in_scope(int target, int scope)
 		 */
 		switch (scope) {
 		case SCOPE_LIST_ITEM:
-			switch (ostack_peek_at(i)->tagid) {
+			switch (ostack_peek_at(&ctx->ostack, i)->tagid) {
 			case TAG_OL:
 				return 0;
 			case TAG_UL:
@@ -332,13 +726,13 @@ has_element_in_scope(int target, int scope)
 			}
 			break;
 		case SCOPE_BUTTON:
-			switch (ostack_peek_at(i)->tagid) {
+			switch (ostack_peek_at(&ctx->ostack, i)->tagid) {
 			case TAG_BUTTON:
 				return 0;
 			}
 			break;
 		case SCOPE_TABLE:
-			switch (ostack_peek_at(i)->tagid) {
+			switch (ostack_peek_at(&ctx->ostack, i)->tagid) {
 			case TAG_HTML:
 			case TAG_TABLE:
 			case TAG_TEMPLATE:
@@ -350,9 +744,11 @@ has_element_in_scope(int target, int scope)
 		}
 
 		if (scope == SCOPE_SELECT) {
-			if (ostack_peek_at(i)->tagid == TAG_OPTGROUP)
+			if (ostack_peek_at(&ctx->ostack, i)->tagid ==
+			    TAG_OPTGROUP)
 				continue;
-			if (ostack_peek_at(i)->tagid == TAG_OPTION)
+			if (ostack_peek_at(&ctx->ostack, i)->tagid ==
+			    TAG_OPTION)
 				continue;
 			return 0;
 		}
@@ -361,7 +757,7 @@ has_element_in_scope(int target, int scope)
 		case SCOPE_LIST_ITEM:
 		case SCOPE_BUTTON:
 		case SCOPE_ANY:
-			switch (ostack_peek_at(i)->tagid) {
+			switch (ostack_peek_at(&ctx->ostack, i)->tagid) {
 			case TAG_APPLET:
 			case TAG_CAPTION:
 			case TAG_HTML:
@@ -386,7 +782,7 @@ pop(struct dispatcher *ctx)
 {
 	struct elem *elem;
 
-	elem = ostack_peek();
+	elem = ostack_peek(&ctx->ostack);
 	close_tag(ctx, elem);
 	return elem;
 }
@@ -394,8 +790,8 @@ pop(struct dispatcher *ctx)
 static struct elem *
 pop_elem(struct dispatcher *ctx, int tagid)
 {
-	while (ostack_peek() != NULL) {
-		if (ostack_peek()->tagid == tagid) {
+	while (ostack_peek(&ctx->ostack) != NULL) {
+		if (ostack_peek(&ctx->ostack)->tagid == tagid) {
 			return pop(ctx);
 		} else
 			pop(ctx);
@@ -444,9 +840,9 @@ is_end_tag(struct token *token, int num_args, ...)
 static int
 check_p(struct dispatcher *ctx, struct token *token, IMODE mode)
 {
-	if (has_element_in_scope(TAG_P, SCOPE_BUTTON)) {
+	if (has_element_in_scope(ctx, TAG_P, SCOPE_BUTTON)) {
 		if (close_p_element(ctx) == 0) {
-			print_err(ctx, token, mode, "closing p failed");
+			print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
 			return -1;
 		}
 	}
@@ -459,33 +855,21 @@ adoption_agency(struct dispatcher *ctx, struct token *token)
 }
 
 static void
-print_err(struct dispatcher *ctx, struct token *token, IMODE mode,
-    const char *msg)
+print_err(struct dispatcher *ctx, struct token *token, enum errors code)
 {
-#define ERR_STR "%zu: parsing %s in %s"
-	if (TOKEN_IS_START_END(token))
-		warnx(ERR_STR "(%s): %s",
-		    token->end_line+1,
-		    token_str(token), imodes[mode], token->u.tag.name, msg);
-	else if (TOKEN_IS_CHAR(token))
-		warnx(ERR_STR "('%s'): %s",
-		    token->end_line+1,
-		    token_str(token), imodes[mode], token->s.s, msg);
-	else
-		warnx(ERR_STR ": %s",
-		    token->end_line+1, token_str(token), imodes[mode], msg);
+	REPORT(ctx->report, code, token->end_line + 1, token->end_offset);
 }
 
 static IMODE
-reset_imode(struct elem *head_elem_ptr)
+reset_imode(struct dispatcher *ctx, struct elem *head_elem_ptr)
 {
 	int last;
 	size_t depth;
 	struct elem *node;
 
 	last = 0;
-	depth = ostack_depth();
-	node = ostack_peek_at(depth);
+	depth = ostack_depth(&ctx->ostack);
+	node = ostack_peek_at(&ctx->ostack, depth);
 
 	if (node == NULL)
 		return IMODE_INITIAL;
@@ -527,7 +911,7 @@ reset_imode(struct elem *head_elem_ptr)
 		if (last)
 			return IMODE_IN_BODY;
 
-		node = ostack_peek_at(--depth);
+		node = ostack_peek_at(&ctx->ostack, --depth);
 		assert(node != NULL);
 	} while(1);
 }
@@ -542,8 +926,8 @@ clear_to_context(struct dispatcher *ctx, enum context c)
 {
 	int tagid;
 
-	while (ostack_depth() >= 1) {
-		tagid = ostack_peek()->tagid;
+	while (ostack_depth(&ctx->ostack) >= 1) {
+		tagid = ostack_peek(&ctx->ostack)->tagid;
 		if (c == CONTEXT_TABLE && (tagid == TAG_TABLE ||
 		    tagid == TAG_TEMPLATE || tagid == TAG_HTML))
 			return;
@@ -564,19 +948,20 @@ static void
 close_cell(struct dispatcher *ctx, struct token *token)
 {
 	generate_implied_end_tags(ctx, -1);
-	if (ostack_peek()->tagid == TAG_TD) {
+	if (ostack_peek(&ctx->ostack)->tagid == TAG_TD) {
 		pop_elem(ctx, TAG_TD);
 		ctx->mode = IMODE_IN_ROW;
-	} else if (ostack_peek()->tagid == TAG_TH) {
+	} else if (ostack_peek(&ctx->ostack)->tagid == TAG_TH) {
 		pop_elem(ctx, TAG_TH);
 		ctx->mode = IMODE_IN_ROW;
 	} else
-		print_err(ctx, token, ctx->mode, "close cell");
+		print_err(ctx, token, ERROR_UNCLOSED_ELEMENT);
 }
 
 /*
  * TODO: Add comment handling (now all comments are ignored altogether).
- * TODO: Add DOCTYPE token handling (now all are DOCTYPEs are ignored altogether).
+ * TODO: Add DOCTYPE token handling (now all are DOCTYPEs are ignored
+ * altogether).
  */
 #include <stdio.h>
 static int
@@ -589,14 +974,17 @@ insert_token_with_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
 #if 0
 	printf("Insert %s (%s) ", token_str(token), imodes[mode]);
 	if (token->type == TOKEN_START_TAG)
-		printf("...tag %s (%d)\n", token->u.tag.name, token->u.tag.tagid);
+		printf("...tag %s (%d)\n", token->u.tag.name,
+		    token->u.tag.tagid);
 	if (token->type == TOKEN_END_TAG)
-		printf("...tag end %s (%d)\n", token->u.tag.name, token->u.tag.tagid);
+		printf("...tag end %s (%d)\n", token->u.tag.name,
+		    token->u.tag.tagid);
 	if (token->type == TOKEN_CHAR)
 		printf("...char '%s'\n", token->s.s);
 	printf("\n");
 #endif
 
+	STATS_ADD(tokens[mode], 1);
 	if (TOKEN_IS_EMPTY(token) || TOKEN_IS_COMMENT(token))
 		return STATE_NONE;
 
@@ -606,8 +994,8 @@ insert_token_with_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
 	if (TOKEN_IS_CHAR(token)) {
 		switch (mode) {
 		case IMODE_IN_HEAD:
-			if (ostack_peek() != NULL &&
-			    ostack_peek()->tagid == TAG_TITLE) {
+			if (ostack_peek(&ctx->ostack) != NULL &&
+			    ostack_peek(&ctx->ostack)->tagid == TAG_TITLE) {
 				insert_char(ctx, token);
 				return STATE_NONE;
 			}
@@ -628,7 +1016,7 @@ insert_token_with_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
 	}
 
 	if (mode != IMODE_INITIAL && TOKEN_IS_DOCTYPE(token)) {
-		warnx("parse error (doctype not expected)");
+		print_err(ctx, token, ERROR_UNEXPECTED_DOCTYPE);
 		return STATE_NONE;
 	}
 
@@ -666,7 +1054,8 @@ insert_token_with_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
 		if (TOKEN_IS_START_TAG(token, TAG_HTML)) {
 			insert_tag_set_mode(ctx, token, IMODE_BEFORE_HEAD);
 		} else {
-			insert_tag_name_set_mode(ctx, "html", 0, IMODE_BEFORE_HEAD);
+			insert_tag_name_set_mode(ctx, "html", 0,
+			    IMODE_BEFORE_HEAD);
 			return dispatch(ctx, token, ctx->begin, ctx->end);
 		}
 		return STATE_NONE;
@@ -703,7 +1092,7 @@ insert_token_with_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
 			return STATE_RAWTEXT;
 		} else if (TOKEN_IS_START_TAG(token, TAG_NOSCRIPT)) {
 			insert_tag_set_mode(ctx, token, IMODE_IN_HEAD_NOSCRIPT);
-			print_err(ctx, token, mode, "in head noscript");
+			print_err(ctx, token, ERROR_UNEXPECTED_TOKEN);
 			return STATE_NONE;
 		} else if (TOKEN_IS_START_TAG(token, TAG_SCRIPT)) {
 			ctx->orig_mode = ctx->mode;
@@ -714,7 +1103,7 @@ insert_token_with_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
 		/* TODO: What should we do here if we already popped
 		 *       head off? */
 			pop_elem(ctx, TAG_HEAD);
-			print_err(ctx, token, mode, "force head");
+			print_err(ctx, token, ERROR_IMPLIED_HEAD);
 			insert_token_set_mode(ctx, token, IMODE_AFTER_HEAD);
 			return STATE_NONE;
 		}
@@ -741,25 +1130,26 @@ insert_token_with_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
 		return STATE_NONE;
 	case IMODE_IN_SELECT:
 		if (TOKEN_IS_END_TAG(token, TAG_SELECT)) {
-			if (!has_element_in_scope(TAG_SELECT,
+			if (!has_element_in_scope(ctx, TAG_SELECT,
 			    SCOPE_SELECT)) {
-				print_err(ctx, token, mode, "no select tag");
+				print_err(ctx, token,
+				    ERROR_ELEMENT_NOT_IN_SCOPE);
 				return STATE_NONE;
 			}
 			pop_elem(ctx, TAG_SELECT);
-			ctx->mode = reset_imode(ctx->head_elem);
+			ctx->mode = reset_imode(ctx, ctx->head_elem);
 			return STATE_NONE;
 		}
 		if (TOKEN_IS_START_TAG(token, TAG_OPTION)) {
-			if (ostack_peek()->tagid == TAG_OPTION)
+			if (ostack_peek(&ctx->ostack)->tagid == TAG_OPTION)
 				pop(ctx);
 			insert_tag(ctx, token);
 			return STATE_NONE;
 		}
 		if (TOKEN_IS_START_TAG(token, TAG_OPTGROUP)) {
-			if (ostack_peek()->tagid == TAG_OPTION)
+			if (ostack_peek(&ctx->ostack)->tagid == TAG_OPTION)
 				pop(ctx);
-			if (ostack_peek()->tagid == TAG_OPTGROUP)
+			if (ostack_peek(&ctx->ostack)->tagid == TAG_OPTGROUP)
 				pop(ctx);
 			insert_tag(ctx, token);
 			return STATE_NONE;
@@ -768,16 +1158,16 @@ insert_token_with_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
 	case IMODE_IN_BODY:
 		if (TOKEN_IS_COMMENT(token) ||
 		    TOKEN_IS_DOCTYPE(token)) {
-			print_err(ctx, token, mode, "did not expect");
+			print_err(ctx, token, ERROR_UNEXPECTED_TOKEN);
 			return STATE_NONE;
 		}
 		if (TOKEN_IS_START_TAG(token, TAG_HTML) ||
 		    TOKEN_IS_START_TAG(token, TAG_BODY)) {
-			print_err(ctx, token, mode, "did not expect");
+			print_err(ctx, token, ERROR_UNEXPECTED_TOKEN);
 			return STATE_NONE;
 		}
 		if (TOKEN_IS_START_TAG(token, TAG_FRAMESET)) {
-			print_err(ctx, token, mode, "did not expect");
+			print_err(ctx, token, ERROR_UNEXPECTED_TOKEN);
 			return STATE_NONE;
 		}
 		if (TOKEN_IS_START_TAG(token, TAG_SELECT)) {
@@ -808,29 +1198,31 @@ insert_token_with_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
 		    TOKEN_IS_START_TAG(token, TAG_TEMPLATE) ||
 		    TOKEN_IS_START_TAG(token, TAG_TITLE) ||
 		    TOKEN_IS_END_TAG(token, TAG_TEMPLATE)) {
-			return insert_token_with_mode(ctx, token, IMODE_IN_HEAD);
+			return insert_token_with_mode(ctx, token,
+			    IMODE_IN_HEAD);
 		}
 		if (TOKEN_IS_END_TAG(token, TAG_BODY) ||
 		    TOKEN_IS_END_TAG(token, TAG_HTML)) {
-			if (!is_open(1, TAG_BODY)) {
-				print_err(ctx, token, mode, "body was not open");
+			if (!is_open(ctx, 1, TAG_BODY)) {
+				print_err(ctx, token,
+				    ERROR_ELEMENT_NOT_IN_SCOPE);
 				return STATE_NONE;
 			}
-			tagid = is_open_other_than(18, TAG_DD, TAG_DT, TAG_LI,
-			    TAG_OPTGROUP, TAG_OPTION, TAG_P, TAG_RB, TAG_RP,
-			    TAG_RT, TAG_RTC, TAG_TBODY, TAG_TD, TAG_TFOOT,
-			    TAG_TH, TAG_THEAD, TAG_TR, TAG_BODY, TAG_HTML);
+			tagid = is_open_other_than(ctx, 18, TAG_DD, TAG_DT,
+			    TAG_LI, TAG_OPTGROUP, TAG_OPTION, TAG_P, TAG_RB,
+			    TAG_RP, TAG_RT, TAG_RTC, TAG_TBODY, TAG_TD,
+			    TAG_TFOOT, TAG_TH, TAG_THEAD, TAG_TR, TAG_BODY,
+			    TAG_HTML);
 			if (tagid != -1) {
-				warnx("STILL OPEN: %s", tagmap(tagid)->name);
-				print_err(ctx, token, mode,
-				    "elem is still open");
+				print_err(ctx, token, ERROR_UNCLOSED_ELEMENT);
 				return STATE_NONE;
 			}
 			if (TOKEN_IS_END_TAG(token, TAG_BODY)) {
 				insert_close_tag(ctx, token);
 				return STATE_NONE;
 			}
-			return insert_token_with_mode(ctx, token, IMODE_AFTER_BODY);
+			return insert_token_with_mode(ctx, token,
+			    IMODE_AFTER_BODY);
 		}
 		if (is_start_tag(token, 24, TAG_ADDRESS, TAG_ARTICLE,
 		    TAG_ASIDE, TAG_BLOCKQUOTE, TAG_CENTER, TAG_DETAILS,
@@ -845,14 +1237,16 @@ insert_token_with_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
 		}
 		if (TOKEN_IS_END(token) &&
 		    tagmap(token->u.tag.tagid)->flags & TAG_HEADING) {
-			if (!has_element_in_scope(token->u.tag.tagid,
+			if (!has_element_in_scope(ctx, token->u.tag.tagid,
 			    SCOPE_ANY)) {
-				print_err(ctx, token, mode, "no heading tag");
+				print_err(ctx, token,
+				    ERROR_ELEMENT_NOT_IN_SCOPE);
 				return STATE_NONE;
 			}
 			generate_implied_end_tags(ctx, token->u.tag.tagid);
-			if (ostack_peek()->tagid != token->u.tag.tagid) {
-				print_err(ctx, token, mode, "did not match");
+			if (ostack_peek(&ctx->ostack)->tagid !=
+			    token->u.tag.tagid) {
+				print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
 				return STATE_NONE;
 			}
 			pop_elem(ctx, token->u.tag.tagid);
@@ -883,7 +1277,7 @@ insert_token_with_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
 		}
 		if (TOKEN_IS_START_TAG(token, TAG_NOBR)) {
 			/* TODO adoption agency etc */
-			print_err(ctx, token, mode, "TODO nobr");
+			print_err(ctx, token, ERROR_UNSUPPORTED);
 			return STATE_NONE;
 		}
 		if (TOKEN_IS_END(token) &&
@@ -894,12 +1288,13 @@ insert_token_with_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
 			insert_close_tag(ctx, token);
 			return STATE_NONE;
 		}
-		if (is_start_tag(token, 3, TAG_APPLET, TAG_MARQUEE, TAG_OBJECT)) {
-			print_err(ctx, token, mode, "TODO applet, marquee, object");
+		if (is_start_tag(token, 3, TAG_APPLET, TAG_MARQUEE,
+		    TAG_OBJECT)) {
+			print_err(ctx, token, ERROR_UNSUPPORTED);
 			return STATE_NONE;
 		}
 		if (TOKEN_IS_END_TAG(token, TAG_BR)) {
-			print_err(ctx, token, mode, "TODO end for br");
+			print_err(ctx, token, ERROR_UNSUPPORTED);
 			return STATE_NONE;
 		}
 		if (is_start_tag(token, 6, TAG_AREA, TAG_BR, TAG_EMBED, TAG_IMG,
@@ -911,8 +1306,9 @@ insert_token_with_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
 		    tagmap(token->u.tag.tagid)->flags & TAG_HEADING) {
 			if (check_p(ctx, token, mode) == -1)
 				return STATE_NONE;
-			if (tagmap(ostack_peek()->tagid)->flags & TAG_HEADING) {
-				print_err(ctx, token, mode, "was not H tag");
+			if (tagmap(ostack_peek(&ctx->ostack)->tagid)->flags &
+			    TAG_HEADING) {
+				print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
 				pop(ctx);
 			}
 			insert_tag(ctx, token);
@@ -933,8 +1329,8 @@ insert_token_with_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
 			return STATE_NONE;
 		}
 		if (TOKEN_IS_START_TAG(token, TAG_BUTTON)) {
-			if (has_element_in_scope(TAG_BUTTON, SCOPE_ANY)) {
-				print_err(ctx, token, mode, "already button");
+			if (has_element_in_scope(ctx, TAG_BUTTON, SCOPE_ANY)) {
+				print_err(ctx, token, ERROR_NESTED_BUTTON);
 				generate_implied_end_tags(ctx, -1);
 				pop_elem(ctx, TAG_BUTTON);
 			}
@@ -947,43 +1343,46 @@ insert_token_with_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
 		    TAG_FIGCAPTION, TAG_FIGURE, TAG_FOOTER, TAG_HEADER,
 		    TAG_HGROUP, TAG_LISTING, TAG_MAIN, TAG_MENU, TAG_NAV,
 		    TAG_OL, TAG_PRE, TAG_SECTION, TAG_SUMMARY, TAG_UL)) {
-			if (!has_element_in_scope(token->u.tag.tagid,
+			if (!has_element_in_scope(ctx, token->u.tag.tagid,
 			    SCOPE_ANY)) {
-				print_err(ctx, token, mode, "did not match");
+				print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
 				return STATE_NONE;
 			}
 			generate_implied_end_tags(ctx, 0);
-			if (ostack_peek()->ns != NS_HTML ||
-			    ostack_peek()->tagid != token->u.tag.tagid) {
-				print_err(ctx, token, mode, "did not match");
+			if (ostack_peek(&ctx->ostack)->ns != NS_HTML ||
+			    ostack_peek(&ctx->ostack)->tagid !=
+			    token->u.tag.tagid) {
+				print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
 				return STATE_NONE;
 			}
 			pop_elem(ctx, token->u.tag.tagid);
 			return STATE_NONE;
 		}
 		if (is_end_tag(token, 2, TAG_DD, TAG_DT)) {
-			if (!has_element_in_scope(token->u.tag.tagid,
+			if (!has_element_in_scope(ctx, token->u.tag.tagid,
 			    SCOPE_ANY)) {
-				print_err(ctx, token, mode, "no dd/dt tag");
+				print_err(ctx, token,
+				    ERROR_ELEMENT_NOT_IN_SCOPE);
 				return STATE_NONE;
 			}
 			generate_implied_end_tags(ctx, token->u.tag.tagid);
-			if (ostack_peek()->tagid != token->u.tag.tagid) {
-				print_err(ctx, token, mode, "did not match");
+			if (ostack_peek(&ctx->ostack)->tagid !=
+			    token->u.tag.tagid) {
+				print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
 				return STATE_NONE;
 			}
 			pop_elem(ctx, token->u.tag.tagid);
 			return STATE_NONE;
 		}
 		if (is_start_tag(token, 2, TAG_DD, TAG_DT)) {
-			sz = ostack_depth();
+			sz = ostack_depth(&ctx->ostack);
 dd_dt_loop:
-			tagid = ostack_peek_at(sz)->tagid;
+			tagid = ostack_peek_at(&ctx->ostack, sz)->tagid;
 			if (tagid == TAG_DD || tagid == TAG_DT) {
 				generate_implied_end_tags(ctx, tagid);
-				if (ostack_peek()->tagid != tagid) {
-					print_err(ctx, token, mode,
-					    "did not match");
+				if (ostack_peek(&ctx->ostack)->tagid != tagid) {
+					print_err(ctx, token,
+					    ERROR_MISMATCHED_END_TAG);
 					return STATE_NONE;
 				}
 				pop(ctx);
@@ -996,7 +1395,7 @@ dd_dt_loop:
 				sz--;
 				goto dd_dt_loop;
 			} else {
-				print_err(ctx, token, mode, "should not happen");
+				print_err(ctx, token, ERROR_UNSUPPORTED);
 			}
 			return STATE_NONE;
 dd_dt_done:
@@ -1012,24 +1411,27 @@ dd_dt_done:
 			return STATE_PLAINTEXT;
 		}
 		if (TOKEN_IS_END_TAG(token, TAG_P)) {
-			if (!has_element_in_scope(TAG_P, SCOPE_BUTTON)) {
-				print_err(ctx, token, mode, "no p tag");
+			if (!has_element_in_scope(ctx, TAG_P, SCOPE_BUTTON)) {
+				print_err(ctx, token,
+				    ERROR_ELEMENT_NOT_IN_SCOPE);
 				insert_tag_name(ctx, "p", 0);
 			}
 			if (close_p_element(ctx) == 0) {
-				print_err(ctx, token, mode, "closing p");
+				print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
 				return STATE_NONE;
 			}
 			return STATE_NONE;
 		}
 		if (TOKEN_IS_END_TAG(token, TAG_LI)) {
-			if (!has_element_in_scope(TAG_LI, SCOPE_LIST_ITEM)) {
-				print_err(ctx, token, mode, "no li tag");
+			if (!has_element_in_scope(ctx, TAG_LI,
+			    SCOPE_LIST_ITEM)) {
+				print_err(ctx, token,
+				    ERROR_ELEMENT_NOT_IN_SCOPE);
 				return STATE_NONE;
 			}
 			generate_implied_end_tags(ctx, TAG_LI);
-			if (ostack_peek()->tagid != TAG_LI) {
-				print_err(ctx, token, mode, "no match");
+			if (ostack_peek(&ctx->ostack)->tagid != TAG_LI) {
+				print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
 				return STATE_NONE;
 			}
 			pop_elem(ctx, TAG_LI);
@@ -1037,19 +1439,22 @@ dd_dt_done:
 		}
 		if (TOKEN_IS_START_TAG(token, TAG_LI)) {
 li_loop:
-			if (ostack_peek()->tagid == TAG_LI) {
+			if (ostack_peek(&ctx->ostack)->tagid == TAG_LI) {
 				generate_implied_end_tags(ctx, TAG_LI);
-				if (ostack_peek()->tagid != TAG_LI) {
-					print_err(ctx, token, mode, "was not li tag");
+				if (ostack_peek(&ctx->ostack)->tagid !=
+				    TAG_LI) {
+					print_err(ctx, token,
+					    ERROR_MISMATCHED_END_TAG);
 					return STATE_NONE;
 				}
 				pop(ctx);
 				goto li_done;
 			}
-			if ((tagmap(ostack_peek()->tagid)->flags & TAG_SPECIAL) &&
-			    (ostack_peek()->tagid != TAG_ADDRESS &&
-			     ostack_peek()->tagid != TAG_DIV &&
-			     ostack_peek()->tagid != TAG_P))
+			if ((tagmap(ostack_peek(&ctx->ostack)->tagid)->flags &
+			    TAG_SPECIAL) &&
+			    (ostack_peek(&ctx->ostack)->tagid != TAG_ADDRESS &&
+			     ostack_peek(&ctx->ostack)->tagid != TAG_DIV &&
+			     ostack_peek(&ctx->ostack)->tagid != TAG_P))
 				goto li_done;
 
 			pop(ctx);
@@ -1065,7 +1470,6 @@ li_done:
 		if (TOKEN_IS_END_TAG(token, TAG_HTML)) {
 			insert_close_tag(ctx, token);
 			ctx->mode = IMODE_AFTER_AFTER_BODY;
-			warnx("[switch to after after body]");
 			return STATE_NONE;
 		}	
 		break;
@@ -1076,16 +1480,18 @@ li_done:
 			return STATE_NONE;
 		}
 		if (TOKEN_IS_END_TAG(token, TAG_TABLE)) {
-			if (!has_element_in_scope(TAG_TABLE, SCOPE_TABLE)) {
-				print_err(ctx, token, mode, "no table tag");
+			if (!has_element_in_scope(ctx, TAG_TABLE,
+			    SCOPE_TABLE)) {
+				print_err(ctx, token,
+				    ERROR_ELEMENT_NOT_IN_SCOPE);
 				return STATE_NONE;
 			}
 			if (pop_elem(ctx, TAG_TABLE) == NULL) {
-				print_err(ctx, token, mode, "did not pop table");
+				print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
 				return STATE_NONE;
 			}
 			assert(ctx->head_elem);
-			ctx->mode = reset_imode(ctx->head_elem);
+			ctx->mode = reset_imode(ctx, ctx->head_elem);
 			return STATE_NONE;
 		}
 		if (is_start_tag(token, 3, TAG_TBODY, TAG_TFOOT, TAG_THEAD)) {
@@ -1108,7 +1514,7 @@ li_done:
 			return STATE_NONE;
 		}
 		if (is_start_tag(token, 2, TAG_TH, TAG_TD)) {
-			print_err(ctx, token, mode, "unexpected th/td");
+			print_err(ctx, token, ERROR_UNEXPECTED_TOKEN);
 			clear_to_context(ctx, CONTEXT_TABLE_BODY);
 			insert_tag_name_set_mode(ctx, "tr", 0, IMODE_IN_ROW);
 			return STATE_NONE;
@@ -1121,8 +1527,9 @@ li_done:
 			return STATE_NONE;
 		}
 		if (is_end_tag(token, 1, TAG_TR)) {
-			if (!has_element_in_scope(TAG_TR, SCOPE_TABLE)) {
-				print_err(ctx, token, mode, "no tr");
+			if (!has_element_in_scope(ctx, TAG_TR, SCOPE_TABLE)) {
+				print_err(ctx, token,
+				    ERROR_ELEMENT_NOT_IN_SCOPE);
 				return STATE_NONE;
 			}
 			clear_to_context(ctx, CONTEXT_TABLE_ROW);
@@ -1133,13 +1540,15 @@ li_done:
 		if (is_start_tag(token, 7, TAG_CAPTION, TAG_COL, TAG_COLGROUP,
 		    TAG_TBODY, TAG_TFOOT, TAG_THEAD, TAG_TR) ||
 		    is_end_tag(token, 1, TAG_TABLE)) {
-			if (!has_element_in_scope(TAG_TR, SCOPE_TABLE)) {
-				print_err(ctx, token, mode, "no tr");
+			if (!has_element_in_scope(ctx, TAG_TR, SCOPE_TABLE)) {
+				print_err(ctx, token,
+				    ERROR_ELEMENT_NOT_IN_SCOPE);
 				return STATE_NONE;
 			}
 			clear_to_context(ctx, CONTEXT_TABLE_ROW);
-			if (ostack_peek()->tagid != TAG_TR) {
-				print_err(ctx, token, mode, "no tr");
+			if (ostack_peek(&ctx->ostack)->tagid != TAG_TR) {
+				print_err(ctx, token,
+				    ERROR_ELEMENT_NOT_IN_SCOPE);
 				return STATE_NONE;
 			}
 			pop(ctx);
@@ -1149,14 +1558,17 @@ li_done:
 		return STATE_NONE;
 	case IMODE_IN_CELL:
 		if (is_end_tag(token, 2, TAG_TH, TAG_TD)) {
-			if (!has_element_in_scope(token->u.tag.tagid,
+			if (!has_element_in_scope(ctx, token->u.tag.tagid,
 			    SCOPE_TABLE)) {
-				print_err(ctx, token, mode, "no th/td (in cell)");
+				print_err(ctx, token,
+				    ERROR_ELEMENT_NOT_IN_SCOPE);
 				return STATE_NONE;
 			}
 			generate_implied_end_tags(ctx, -1);
-			if (ostack_peek()->tagid != token->u.tag.tagid) {
-				print_err(ctx, token, mode, "no th/td in cell 2");
+			if (ostack_peek(&ctx->ostack)->tagid !=
+			    token->u.tag.tagid) {
+				print_err(ctx, token,
+				    ERROR_ELEMENT_NOT_IN_SCOPE);
 				return STATE_NONE;
 			}
 			pop_elem(ctx, token->u.tag.tagid);
@@ -1165,9 +1577,10 @@ li_done:
 		}
 		if (is_start_tag(token, 9, TAG_CAPTION, TAG_COL, TAG_COLGROUP,
 		    TAG_TBODY, TAG_TD, TAG_TFOOT, TAG_TH, TAG_THEAD, TAG_TR)) {
-			if (!has_element_in_scope(TAG_TD, SCOPE_TABLE) &&
-			    !has_element_in_scope(TAG_TH, SCOPE_TABLE)) {
-				print_err(ctx, token, mode, "no th/td (in cell)");
+			if (!has_element_in_scope(ctx, TAG_TD, SCOPE_TABLE) &&
+			    !has_element_in_scope(ctx, TAG_TH, SCOPE_TABLE)) {
+				print_err(ctx, token,
+				    ERROR_ELEMENT_NOT_IN_SCOPE);
 				return STATE_NONE;
 			}
 			close_cell(ctx, token);
@@ -1175,14 +1588,14 @@ li_done:
 		}
 		if (is_end_tag(token, 5, TAG_BODY, TAG_CAPTION, TAG_COL,
 		    TAG_COLGROUP, TAG_HTML)) {
-			print_err(ctx, token, mode, "parse error");
+			print_err(ctx, token, ERROR_UNEXPECTED_TOKEN);
 			return STATE_NONE;
 		}
 		if (is_end_tag(token, 5, TAG_TABLE, TAG_TBODY, TAG_TFOOT,
 		    TAG_THEAD, TAG_TR)) {
-			if (!has_element_in_scope(token->u.tag.tagid,
+			if (!has_element_in_scope(ctx, token->u.tag.tagid,
 			    SCOPE_TABLE)) {
-				print_err(ctx, token, mode, "parse error");
+				print_err(ctx, token, ERROR_UNEXPECTED_TOKEN);
 				return STATE_NONE;
 			}
 			close_cell(ctx, token);
@@ -1200,7 +1613,6 @@ li_done:
 		return STATE_NONE;
 		break;
 	case IMODE_AFTER_AFTER_BODY:
-		warnx("[in after after body]");
 		break;
 	case IMODE_IN_HEAD_NOSCRIPT:
 		if (is_end_tag(token, 1, TAG_NOSCRIPT)) {
@@ -1211,9 +1623,6 @@ li_done:
 		ctx->mode = IMODE_IN_HEAD;
 		break;
 	default:
-		if (TOKEN_IS_START(token)) {
-			warnx("Got start tag: '%s'", token->u.tag.name);
-		}
 		return STATE_NONE;
 	}
 
@@ -1232,19 +1641,20 @@ li_done:
 			insert_tag(ctx, token);
 		else if (TOKEN_IS_END(token)) {
 			/* "Any other end tag" */
-			node = ostack_peek();
+			node = ostack_peek(&ctx->ostack);
 loop:
 			if (node->ns == NS_HTML &&
 			    node->tagid == token->u.tag.tagid) {
 				generate_implied_end_tags(ctx,
 				    token->u.tag.tagid);
-				if (node->tagid != ostack_peek()->tagid) {
-					print_err(ctx, token, mode,
-					    "end tag did not match");
+				if (node->tagid !=
+				    ostack_peek(&ctx->ostack)->tagid) {
+					print_err(ctx, token,
+					    ERROR_MISMATCHED_END_TAG);
 					return STATE_NONE;
 				}
-				while (ostack_depth() >= 1) {
-					if (node == ostack_peek()) {
+				while (ostack_depth(&ctx->ostack) >= 1) {
+					if (node == ostack_peek(&ctx->ostack)) {
 						pop(ctx);
 						break;
 					} else {
@@ -1254,13 +1664,13 @@ loop:
 				return STATE_NONE;
 			} else if (tagmap(node->tagid)->flags &
 			    TAG_SPECIAL) {
-				warnx("special was: %s", node->name);
-				print_err(ctx, token, mode, "was special");
+				print_err(ctx, token, ERROR_MISMATCHED_END_TAG);
 				return STATE_NONE;
 			} else {
-				node = ostack_prev(node);
+				node = ostack_prev(&ctx->ostack, node);
 				if (node == NULL) {
-					print_err(ctx, token, mode, "no prev node");
+					print_err(ctx, token,
+					    ERROR_MISMATCHED_END_TAG);
 					return STATE_NONE;
 				}
 				goto loop;
@@ -1281,3 +1691,61 @@ insert_token_set_mode(struct dispatcher *ctx, struct token *token, IMODE mode)
 	ctx->mode = mode;
 	insert_token_with_mode(ctx, token, ctx->mode);
 }
+
+#ifdef BENCH
+#include <time.h>
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * has_element_in_scope() on a stack of divs, for an element that is
+ * not there, which scans the whole stack, and for the one at the top.
+ */
+int
+main(int argc, char **argv)
+{
+	static const size_t depths[] = { 16, 256, 4096 };
+	static struct dispatcher ctx;
+	static struct elem elems[4096];
+	static volatile size_t sink;
+	char name[48];
+	size_t i, j, reps;
+	double start, miss, hit;
+
+	for (i = 0; i < sizeof(depths) / sizeof(depths[0]); i++) {
+		while (ostack_depth(&ctx.ostack) > 0)
+			ostack_pop(&ctx.ostack);
+		for (j = 0; j < depths[i]; j++) {
+			elems[j].tagid = TAG_DIV;
+			ostack_push(&ctx.ostack, &elems[j]);
+		}
+		reps = 50000000 / depths[i];
+
+		start = now();
+		for (j = 0; j < reps; j++)
+			sink += has_element_in_scope(&ctx, TAG_P, SCOPE_BUTTON);
+		miss = (now() - start) / reps;
+		start = now();
+		for (j = 0; j < reps; j++)
+			sink += has_element_in_scope(&ctx, TAG_DIV, SCOPE_ANY);
+		hit = (now() - start) / reps;
+
+		snprintf(name, sizeof(name), "in scope miss at depth %zu",
+		    depths[i]);
+		printf("%-32s%8.1f ns/op\n", name, miss * 1e9);
+		snprintf(name, sizeof(name), "in scope top at depth %zu",
+		    depths[i]);
+		printf("%-32s%8.1f ns/op\n", name, hit * 1e9);
+	}
+	ostack_free(&ctx.ostack);
+
+	return 0;
+}
+#endif
@@ -19,29 +19,95 @@
 #ifndef DISPATCHER_H
 #define DISPATCHER_H
 
-struct node;
 struct token;
-struct cdata;
 struct document;
 struct elem;
+struct elem_view;
+struct attr_pool;
 
 #include "imodes.h"
+#include "node.h"
+#include "cdata.h"
+#include "ostack.h"
+#include "report.h"
+
+#include <stddef.h>
 
 typedef enum imodes IMODE;
 
+#define TEXT_MAX 4096
+
+/*
+ * Return values for the begin and end callbacks.
+ */
+enum callback_verdict {
+	CB_CONTINUE,
+	CB_SKIP,		/* skip children of the begun element */
+	CB_STOP			/* stop parsing */
+};
+
 struct dispatcher {
 	struct document	*document;
-	struct cdata	*cdata;
+	struct cdata	*cdata;		/* pending text or NULL */
 	struct elem	*head_elem;
+	struct ostack	 ostack;	/* open elements */
+
+	/*
+	 * Parser owned storage for the nodes passed to the callbacks.
+	 */
+	struct cdata	 cdata_buf;
+	struct node	 cdata_node;
+	struct elem_view **views;
+	size_t		 views_alloc;
 
 	IMODE		 mode;
 	IMODE		 orig_mode;
 
-	void (*begin)(struct node *);
-	void (*end)(struct node *);
+	/*
+	 * Element whose children are being skipped, if any. While
+	 * skipping we only track nesting of the same element and the
+	 * raw text children, whose content must not be taken as tags.
+	 */
+	struct elem	*skip;
+	size_t		 skip_depth;
+	int		 skip_state;
+	int		 skip_raw;	/* tag id of such a child, or 0 */
+
+	int		 stop;		/* a callback returned CB_STOP */
+
+	struct report	*report;	/* parse errors, or NULL */
+	struct attr_pool *attr_pool;	/* to give attributes back to, or NULL */
+
+	int (*begin)(struct node *);
+	int (*end)(struct node *);
+
+	/*
+	 * Optional streaming of text: if set, text is passed here in
+	 * pieces of about text_max bytes (TEXT_MAX if zero) instead of
+	 * to begin and end, so that memory use does not depend on the
+	 * size of a text node. The flag tells if the piece is the final
+	 * one of the text node.
+	 */
+	int (*text)(struct node *, int);
+	size_t		 text_max;
+
+	/*
+	 * Optional dropping of whitespace-only text where it cannot
+	 * affect rendering, see flush_cdata().
+	 */
+	int		 elide_space;
+	IMODE		 cdata_mode;	/* mode when pending text began */
+	int		 cdata_space;	/* pending text is all whitespace */
+	int		 cdata_sent;	/* pieces of it were streamed */
+	int		 cdata_block;	/* it follows a block boundary */
+	int		 last_block;	/* last boundary was a block one */
+	size_t		 pre_depth;	/* open preformatted elements */
 };
 
-int dispatch(struct dispatcher *, struct token *, void (*)(struct node *),
-    void (*)(struct node *));
+int dispatch(struct dispatcher *, struct token *, int (*)(struct node *),
+    int (*)(struct node *));
+void dispatch_unwind(struct dispatcher *);
+int dispatch_raw_state(int);
+void dispatch_free(struct dispatcher *);
 
 #endif
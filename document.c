@@ -17,6 +17,8 @@
  */
 
 #include "document.h"
+#include "stats.h"
+#include "util.h"
 
 #include <stdlib.h>
 #include <err.h>
@@ -26,9 +28,10 @@ document_create(void)
 {
 	struct document	*document;
 
-	document = calloc(1, sizeof(struct document));
+	document = mem_calloc(1, sizeof(struct document));
 	if (document == NULL)
 		err(1, "calloc document");
+	STATS_ADD(allocs[ALLOC_DOCUMENT], 1);
 
 	return document;
 }
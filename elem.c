@@ -20,6 +20,8 @@
 #include "token.h"
 #include "tagmap.h"
 #include "attr.h"
+#include "stats.h"
+#include "util.h"
 
 #include <stdlib.h>
 #include <assert.h>
@@ -68,12 +70,14 @@ elem_create_from_token(struct token *token)
 
 	assert(TOKEN_IS_START_END(token));
 
-	elem = calloc(1, sizeof(struct elem));
+	elem = mem_calloc(1, sizeof(struct elem));
 	if (elem == NULL)
 		err(1, "calloc elem");
+	STATS_ADD(allocs[ALLOC_ELEM], 1);
 
 	elem->tagid = token->u.tag.tagid;
 	elem->name = token->u.tag.name;
+	elem->shared_name = token->u.tag.shared_name;
 
 	assert(elem->name != NULL);
 	return elem;
@@ -92,29 +96,54 @@ elem_size(struct elem *elem)
 	return sum;
 }
 
-void
-elem_free(struct elem *elem)
+struct elem *
+elem_copy(struct elem *elem)
 {
-	struct attr	*attr, *next;
+	struct elem *copy;
 
 	assert(elem != NULL);
 	assert(elem->name != NULL);
 
+	copy = mem_calloc(1, sizeof(struct elem));
+	if (copy == NULL)
+		err(1, "calloc elem");
+	STATS_ADD(allocs[ALLOC_ELEM], 1);
+
+	copy->tagid = elem->tagid;
+	copy->ns = elem->ns;
 	if (elem->name != tagmap(elem->tagid)->name) {
-		free(elem->name);
+		copy->name = mem_strdup(elem->name);
+		if (copy->name == NULL)
+			err(1, "strdup elem name");
+		STATS_ADD(allocs[ALLOC_ELEM], 1);
+	} else
+		copy->name = elem->name;
+	copy->attr = attr_copy(elem->attr);
+
+	return copy;
+}
+
+/*
+ * Releases the name and attributes but not the elem itself.
+ */
+void
+elem_clear(struct elem *elem)
+{
+	assert(elem != NULL);
+	assert(elem->name != NULL);
+
+	if (elem->name != tagmap(elem->tagid)->name && !elem->shared_name) {
+		mem_free(elem->name);
 		elem->name = NULL;
 	}
 
-	attr = elem->attr;
-	while (attr != NULL) {
-		if (attr->name != NULL)
-			free(attr->name);
-		if (attr->value != NULL)
-			free(attr->value);
-		next = attr->next;
-		free(attr);
-		attr = next;
-	}
+	attr_free(elem->attr);
+	elem->attr = NULL;
+}
 
-	free(elem);
+void
+elem_free(struct elem *elem)
+{
+	elem_clear(elem);
+	mem_free(elem);
 }
@@ -40,6 +40,7 @@ struct elem {
 	struct attr	*attr;
 	struct node	*node;	/* back reference, can be NULL */
 	int		 ns;
+	int		 shared_name;	/* interned, see attr_pool_name() */
 };
 
 struct elem	*elem_create_from_token(struct token *token);
@@ -48,6 +49,9 @@ int		 elem_has_attr(struct elem *, const char *);
 const char	*elem_attr_value(struct elem *, const char *);
 void		 elem_set_attr(struct elem *, const char *, const char *);
 
+struct elem	*elem_copy(struct elem *);
+void		 elem_clear(struct elem *);
+
 size_t elem_size(struct elem *);
 void elem_free(struct elem *);
 
@@ -0,0 +1,1170 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "encoding.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#define IS_SPACE(_c) ((_c) == '\t' || (_c) == '\n' || (_c) == '\f' || \
+	(_c) == '\r' || (_c) == ' ')
+#define IS_ALPHA(_c) (((_c) >= 'a' && (_c) <= 'z') || \
+	((_c) >= 'A' && (_c) <= 'Z'))
+#define TO_LOWER(_c) ((_c) >= 'A' && (_c) <= 'Z' ? (_c) + 'a' - 'A' : (_c))
+
+/*
+ * High bit set in any of the 8 bytes of a word.
+ */
+#define NON_ASCII 0x8080808080808080ULL
+
+static const char *names[] = {
+	"none",
+	"binary",
+	"UTF-8",
+	"UTF-16LE",
+	"UTF-16BE",
+	"IBM866",
+	"ISO-8859-2",
+	"ISO-8859-5",
+	"ISO-8859-7",
+	"ISO-8859-15",
+	"KOI8-R",
+	"KOI8-U",
+	"macintosh",
+	"windows-1250",
+	"windows-1251",
+	"windows-1252",
+	"windows-1253",
+	"windows-1254",
+	"windows-1257"
+};
+
+/*
+ * Labels from the WHATWG Encoding standard.
+ */
+static const struct {
+	const char	*label;
+	int		 encoding;
+} labels[] = {
+	{ "unicode-1-1-utf-8", ENCODING_UTF8 },
+	{ "unicode11utf8", ENCODING_UTF8 },
+	{ "unicode20utf8", ENCODING_UTF8 },
+	{ "utf-8", ENCODING_UTF8 },
+	{ "utf8", ENCODING_UTF8 },
+	{ "x-unicode20utf8", ENCODING_UTF8 },
+	{ "csunicode", ENCODING_UTF16LE },
+	{ "iso-10646-ucs-2", ENCODING_UTF16LE },
+	{ "ucs-2", ENCODING_UTF16LE },
+	{ "unicode", ENCODING_UTF16LE },
+	{ "unicodefeff", ENCODING_UTF16LE },
+	{ "utf-16", ENCODING_UTF16LE },
+	{ "utf-16le", ENCODING_UTF16LE },
+	{ "unicodefffe", ENCODING_UTF16BE },
+	{ "utf-16be", ENCODING_UTF16BE },
+	{ "866", ENCODING_IBM866 },
+	{ "cp866", ENCODING_IBM866 },
+	{ "csibm866", ENCODING_IBM866 },
+	{ "ibm866", ENCODING_IBM866 },
+	{ "csisolatin2", ENCODING_ISO_8859_2 },
+	{ "iso-8859-2", ENCODING_ISO_8859_2 },
+	{ "iso-ir-101", ENCODING_ISO_8859_2 },
+	{ "iso8859-2", ENCODING_ISO_8859_2 },
+	{ "iso88592", ENCODING_ISO_8859_2 },
+	{ "iso_8859-2", ENCODING_ISO_8859_2 },
+	{ "iso_8859-2:1987", ENCODING_ISO_8859_2 },
+	{ "l2", ENCODING_ISO_8859_2 },
+	{ "latin2", ENCODING_ISO_8859_2 },
+	{ "csisolatincyrillic", ENCODING_ISO_8859_5 },
+	{ "cyrillic", ENCODING_ISO_8859_5 },
+	{ "iso-8859-5", ENCODING_ISO_8859_5 },
+	{ "iso-ir-144", ENCODING_ISO_8859_5 },
+	{ "iso8859-5", ENCODING_ISO_8859_5 },
+	{ "iso88595", ENCODING_ISO_8859_5 },
+	{ "iso_8859-5", ENCODING_ISO_8859_5 },
+	{ "iso_8859-5:1988", ENCODING_ISO_8859_5 },
+	{ "csisolatingreek", ENCODING_ISO_8859_7 },
+	{ "ecma-118", ENCODING_ISO_8859_7 },
+	{ "elot_928", ENCODING_ISO_8859_7 },
+	{ "greek", ENCODING_ISO_8859_7 },
+	{ "greek8", ENCODING_ISO_8859_7 },
+	{ "iso-8859-7", ENCODING_ISO_8859_7 },
+	{ "iso-ir-126", ENCODING_ISO_8859_7 },
+	{ "iso8859-7", ENCODING_ISO_8859_7 },
+	{ "iso88597", ENCODING_ISO_8859_7 },
+	{ "iso_8859-7", ENCODING_ISO_8859_7 },
+	{ "iso_8859-7:1987", ENCODING_ISO_8859_7 },
+	{ "sun_eu_greek", ENCODING_ISO_8859_7 },
+	{ "csisolatin9", ENCODING_ISO_8859_15 },
+	{ "iso-8859-15", ENCODING_ISO_8859_15 },
+	{ "iso8859-15", ENCODING_ISO_8859_15 },
+	{ "iso885915", ENCODING_ISO_8859_15 },
+	{ "iso_8859-15", ENCODING_ISO_8859_15 },
+	{ "l9", ENCODING_ISO_8859_15 },
+	{ "cskoi8r", ENCODING_KOI8_R },
+	{ "koi", ENCODING_KOI8_R },
+	{ "koi8", ENCODING_KOI8_R },
+	{ "koi8-r", ENCODING_KOI8_R },
+	{ "koi8_r", ENCODING_KOI8_R },
+	{ "koi8-ru", ENCODING_KOI8_U },
+	{ "koi8-u", ENCODING_KOI8_U },
+	{ "csmacintosh", ENCODING_MACINTOSH },
+	{ "mac", ENCODING_MACINTOSH },
+	{ "macintosh", ENCODING_MACINTOSH },
+	{ "x-mac-roman", ENCODING_MACINTOSH },
+	{ "cp1250", ENCODING_WINDOWS_1250 },
+	{ "windows-1250", ENCODING_WINDOWS_1250 },
+	{ "x-cp1250", ENCODING_WINDOWS_1250 },
+	{ "cp1251", ENCODING_WINDOWS_1251 },
+	{ "windows-1251", ENCODING_WINDOWS_1251 },
+	{ "x-cp1251", ENCODING_WINDOWS_1251 },
+	{ "ansi_x3.4-1968", ENCODING_WINDOWS_1252 },
+	{ "ascii", ENCODING_WINDOWS_1252 },
+	{ "cp1252", ENCODING_WINDOWS_1252 },
+	{ "cp819", ENCODING_WINDOWS_1252 },
+	{ "csisolatin1", ENCODING_WINDOWS_1252 },
+	{ "ibm819", ENCODING_WINDOWS_1252 },
+	{ "iso-8859-1", ENCODING_WINDOWS_1252 },
+	{ "iso-ir-100", ENCODING_WINDOWS_1252 },
+	{ "iso8859-1", ENCODING_WINDOWS_1252 },
+	{ "iso88591", ENCODING_WINDOWS_1252 },
+	{ "iso_8859-1", ENCODING_WINDOWS_1252 },
+	{ "iso_8859-1:1987", ENCODING_WINDOWS_1252 },
+	{ "l1", ENCODING_WINDOWS_1252 },
+	{ "latin1", ENCODING_WINDOWS_1252 },
+	{ "us-ascii", ENCODING_WINDOWS_1252 },
+	{ "windows-1252", ENCODING_WINDOWS_1252 },
+	{ "x-cp1252", ENCODING_WINDOWS_1252 },
+	{ "x-user-defined", ENCODING_WINDOWS_1252 },
+	{ "cp1253", ENCODING_WINDOWS_1253 },
+	{ "windows-1253", ENCODING_WINDOWS_1253 },
+	{ "x-cp1253", ENCODING_WINDOWS_1253 },
+	{ "cp1254", ENCODING_WINDOWS_1254 },
+	{ "csisolatin5", ENCODING_WINDOWS_1254 },
+	{ "iso-8859-9", ENCODING_WINDOWS_1254 },
+	{ "iso-ir-148", ENCODING_WINDOWS_1254 },
+	{ "iso8859-9", ENCODING_WINDOWS_1254 },
+	{ "iso88599", ENCODING_WINDOWS_1254 },
+	{ "iso_8859-9", ENCODING_WINDOWS_1254 },
+	{ "iso_8859-9:1989", ENCODING_WINDOWS_1254 },
+	{ "l5", ENCODING_WINDOWS_1254 },
+	{ "latin5", ENCODING_WINDOWS_1254 },
+	{ "windows-1254", ENCODING_WINDOWS_1254 },
+	{ "x-cp1254", ENCODING_WINDOWS_1254 },
+	{ "cp1257", ENCODING_WINDOWS_1257 },
+	{ "windows-1257", ENCODING_WINDOWS_1257 },
+	{ "x-cp1257", ENCODING_WINDOWS_1257 }
+};
+
+/*
+ * Code points of bytes 0x80-0xff of the single-byte encodings, bytes
+ * 0x00-0x7f are ASCII in all of them.
+ */
+static const unsigned short tables[][128] = {
+	[ENCODING_IBM866 - ENCODING_IBM866] = {
+		0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417,
+		0x0418, 0x0419, 0x041a, 0x041b, 0x041c, 0x041d, 0x041e, 0x041f,
+		0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427,
+		0x0428, 0x0429, 0x042a, 0x042b, 0x042c, 0x042d, 0x042e, 0x042f,
+		0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437,
+		0x0438, 0x0439, 0x043a, 0x043b, 0x043c, 0x043d, 0x043e, 0x043f,
+		0x2591, 0x2592, 0x2593, 0x2502, 0x2524, 0x2561, 0x2562, 0x2556,
+		0x2555, 0x2563, 0x2551, 0x2557, 0x255d, 0x255c, 0x255b, 0x2510,
+		0x2514, 0x2534, 0x252c, 0x251c, 0x2500, 0x253c, 0x255e, 0x255f,
+		0x255a, 0x2554, 0x2569, 0x2566, 0x2560, 0x2550, 0x256c, 0x2567,
+		0x2568, 0x2564, 0x2565, 0x2559, 0x2558, 0x2552, 0x2553, 0x256b,
+		0x256a, 0x2518, 0x250c, 0x2588, 0x2584, 0x258c, 0x2590, 0x2580,
+		0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447,
+		0x0448, 0x0449, 0x044a, 0x044b, 0x044c, 0x044d, 0x044e, 0x044f,
+		0x0401, 0x0451, 0x0404, 0x0454, 0x0407, 0x0457, 0x040e, 0x045e,
+		0x00b0, 0x2219, 0x00b7, 0x221a, 0x2116, 0x00a4, 0x25a0, 0x00a0,
+	},
+	[ENCODING_ISO_8859_2 - ENCODING_IBM866] = {
+		0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087,
+		0x0088, 0x0089, 0x008a, 0x008b, 0x008c, 0x008d, 0x008e, 0x008f,
+		0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097,
+		0x0098, 0x0099, 0x009a, 0x009b, 0x009c, 0x009d, 0x009e, 0x009f,
+		0x00a0, 0x0104, 0x02d8, 0x0141, 0x00a4, 0x013d, 0x015a, 0x00a7,
+		0x00a8, 0x0160, 0x015e, 0x0164, 0x0179, 0x00ad, 0x017d, 0x017b,
+		0x00b0, 0x0105, 0x02db, 0x0142, 0x00b4, 0x013e, 0x015b, 0x02c7,
+		0x00b8, 0x0161, 0x015f, 0x0165, 0x017a, 0x02dd, 0x017e, 0x017c,
+		0x0154, 0x00c1, 0x00c2, 0x0102, 0x00c4, 0x0139, 0x0106, 0x00c7,
+		0x010c, 0x00c9, 0x0118, 0x00cb, 0x011a, 0x00cd, 0x00ce, 0x010e,
+		0x0110, 0x0143, 0x0147, 0x00d3, 0x00d4, 0x0150, 0x00d6, 0x00d7,
+		0x0158, 0x016e, 0x00da, 0x0170, 0x00dc, 0x00dd, 0x0162, 0x00df,
+		0x0155, 0x00e1, 0x00e2, 0x0103, 0x00e4, 0x013a, 0x0107, 0x00e7,
+		0x010d, 0x00e9, 0x0119, 0x00eb, 0x011b, 0x00ed, 0x00ee, 0x010f,
+		0x0111, 0x0144, 0x0148, 0x00f3, 0x00f4, 0x0151, 0x00f6, 0x00f7,
+		0x0159, 0x016f, 0x00fa, 0x0171, 0x00fc, 0x00fd, 0x0163, 0x02d9,
+	},
+	[ENCODING_ISO_8859_5 - ENCODING_IBM866] = {
+		0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087,
+		0x0088, 0x0089, 0x008a, 0x008b, 0x008c, 0x008d, 0x008e, 0x008f,
+		0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097,
+		0x0098, 0x0099, 0x009a, 0x009b, 0x009c, 0x009d, 0x009e, 0x009f,
+		0x00a0, 0x0401, 0x0402, 0x0403, 0x0404, 0x0405, 0x0406, 0x0407,
+		0x0408, 0x0409, 0x040a, 0x040b, 0x040c, 0x00ad, 0x040e, 0x040f,
+		0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417,
+		0x0418, 0x0419, 0x041a, 0x041b, 0x041c, 0x041d, 0x041e, 0x041f,
+		0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427,
+		0x0428, 0x0429, 0x042a, 0x042b, 0x042c, 0x042d, 0x042e, 0x042f,
+		0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437,
+		0x0438, 0x0439, 0x043a, 0x043b, 0x043c, 0x043d, 0x043e, 0x043f,
+		0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447,
+		0x0448, 0x0449, 0x044a, 0x044b, 0x044c, 0x044d, 0x044e, 0x044f,
+		0x2116, 0x0451, 0x0452, 0x0453, 0x0454, 0x0455, 0x0456, 0x0457,
+		0x0458, 0x0459, 0x045a, 0x045b, 0x045c, 0x00a7, 0x045e, 0x045f,
+	},
+	[ENCODING_ISO_8859_7 - ENCODING_IBM866] = {
+		0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087,
+		0x0088, 0x0089, 0x008a, 0x008b, 0x008c, 0x008d, 0x008e, 0x008f,
+		0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097,
+		0x0098, 0x0099, 0x009a, 0x009b, 0x009c, 0x009d, 0x009e, 0x009f,
+		0x00a0, 0x2018, 0x2019, 0x00a3, 0x20ac, 0x20af, 0x00a6, 0x00a7,
+		0x00a8, 0x00a9, 0x037a, 0x00ab, 0x00ac, 0x00ad, 0xfffd, 0x2015,
+		0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x0384, 0x0385, 0x0386, 0x00b7,
+		0x0388, 0x0389, 0x038a, 0x00bb, 0x038c, 0x00bd, 0x038e, 0x038f,
+		0x0390, 0x0391, 0x0392, 0x0393, 0x0394, 0x0395, 0x0396, 0x0397,
+		0x0398, 0x0399, 0x039a, 0x039b, 0x039c, 0x039d, 0x039e, 0x039f,
+		0x03a0, 0x03a1, 0xfffd, 0x03a3, 0x03a4, 0x03a5, 0x03a6, 0x03a7,
+		0x03a8, 0x03a9, 0x03aa, 0x03ab, 0x03ac, 0x03ad, 0x03ae, 0x03af,
+		0x03b0, 0x03b1, 0x03b2, 0x03b3, 0x03b4, 0x03b5, 0x03b6, 0x03b7,
+		0x03b8, 0x03b9, 0x03ba, 0x03bb, 0x03bc, 0x03bd, 0x03be, 0x03bf,
+		0x03c0, 0x03c1, 0x03c2, 0x03c3, 0x03c4, 0x03c5, 0x03c6, 0x03c7,
+		0x03c8, 0x03c9, 0x03ca, 0x03cb, 0x03cc, 0x03cd, 0x03ce, 0xfffd,
+	},
+	[ENCODING_ISO_8859_15 - ENCODING_IBM866] = {
+		0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087,
+		0x0088, 0x0089, 0x008a, 0x008b, 0x008c, 0x008d, 0x008e, 0x008f,
+		0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097,
+		0x0098, 0x0099, 0x009a, 0x009b, 0x009c, 0x009d, 0x009e, 0x009f,
+		0x00a0, 0x00a1, 0x00a2, 0x00a3, 0x20ac, 0x00a5, 0x0160, 0x00a7,
+		0x0161, 0x00a9, 0x00aa, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x00af,
+		0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x017d, 0x00b5, 0x00b6, 0x00b7,
+		0x017e, 0x00b9, 0x00ba, 0x00bb, 0x0152, 0x0153, 0x0178, 0x00bf,
+		0x00c0, 0x00c1, 0x00c2, 0x00c3, 0x00c4, 0x00c5, 0x00c6, 0x00c7,
+		0x00c8, 0x00c9, 0x00ca, 0x00cb, 0x00cc, 0x00cd, 0x00ce, 0x00cf,
+		0x00d0, 0x00d1, 0x00d2, 0x00d3, 0x00d4, 0x00d5, 0x00d6, 0x00d7,
+		0x00d8, 0x00d9, 0x00da, 0x00db, 0x00dc, 0x00dd, 0x00de, 0x00df,
+		0x00e0, 0x00e1, 0x00e2, 0x00e3, 0x00e4, 0x00e5, 0x00e6, 0x00e7,
+		0x00e8, 0x00e9, 0x00ea, 0x00eb, 0x00ec, 0x00ed, 0x00ee, 0x00ef,
+		0x00f0, 0x00f1, 0x00f2, 0x00f3, 0x00f4, 0x00f5, 0x00f6, 0x00f7,
+		0x00f8, 0x00f9, 0x00fa, 0x00fb, 0x00fc, 0x00fd, 0x00fe, 0x00ff,
+	},
+	[ENCODING_KOI8_R - ENCODING_IBM866] = {
+		0x2500, 0x2502, 0x250c, 0x2510, 0x2514, 0x2518, 0x251c, 0x2524,
+		0x252c, 0x2534, 0x253c, 0x2580, 0x2584, 0x2588, 0x258c, 0x2590,
+		0x2591, 0x2592, 0x2593, 0x2320, 0x25a0, 0x2219, 0x221a, 0x2248,
+		0x2264, 0x2265, 0x00a0, 0x2321, 0x00b0, 0x00b2, 0x00b7, 0x00f7,
+		0x2550, 0x2551, 0x2552, 0x0451, 0x2553, 0x2554, 0x2555, 0x2556,
+		0x2557, 0x2558, 0x2559, 0x255a, 0x255b, 0x255c, 0x255d, 0x255e,
+		0x255f, 0x2560, 0x2561, 0x0401, 0x2562, 0x2563, 0x2564, 0x2565,
+		0x2566, 0x2567, 0x2568, 0x2569, 0x256a, 0x256b, 0x256c, 0x00a9,
+		0x044e, 0x0430, 0x0431, 0x0446, 0x0434, 0x0435, 0x0444, 0x0433,
+		0x0445, 0x0438, 0x0439, 0x043a, 0x043b, 0x043c, 0x043d, 0x043e,
+		0x043f, 0x044f, 0x0440, 0x0441, 0x0442, 0x0443, 0x0436, 0x0432,
+		0x044c, 0x044b, 0x0437, 0x0448, 0x044d, 0x0449, 0x0447, 0x044a,
+		0x042e, 0x0410, 0x0411, 0x0426, 0x0414, 0x0415, 0x0424, 0x0413,
+		0x0425, 0x0418, 0x0419, 0x041a, 0x041b, 0x041c, 0x041d, 0x041e,
+		0x041f, 0x042f, 0x0420, 0x0421, 0x0422, 0x0423, 0x0416, 0x0412,
+		0x042c, 0x042b, 0x0417, 0x0428, 0x042d, 0x0429, 0x0427, 0x042a,
+	},
+	[ENCODING_KOI8_U - ENCODING_IBM866] = {
+		0x2500, 0x2502, 0x250c, 0x2510, 0x2514, 0x2518, 0x251c, 0x2524,
+		0x252c, 0x2534, 0x253c, 0x2580, 0x2584, 0x2588, 0x258c, 0x2590,
+		0x2591, 0x2592, 0x2593, 0x2320, 0x25a0, 0x2219, 0x221a, 0x2248,
+		0x2264, 0x2265, 0x00a0, 0x2321, 0x00b0, 0x00b2, 0x00b7, 0x00f7,
+		0x2550, 0x2551, 0x2552, 0x0451, 0x0454, 0x2554, 0x0456, 0x0457,
+		0x2557, 0x2558, 0x2559, 0x255a, 0x255b, 0x0491, 0x255d, 0x255e,
+		0x255f, 0x2560, 0x2561, 0x0401, 0x0404, 0x2563, 0x0406, 0x0407,
+		0x2566, 0x2567, 0x2568, 0x2569, 0x256a, 0x0490, 0x256c, 0x00a9,
+		0x044e, 0x0430, 0x0431, 0x0446, 0x0434, 0x0435, 0x0444, 0x0433,
+		0x0445, 0x0438, 0x0439, 0x043a, 0x043b, 0x043c, 0x043d, 0x043e,
+		0x043f, 0x044f, 0x0440, 0x0441, 0x0442, 0x0443, 0x0436, 0x0432,
+		0x044c, 0x044b, 0x0437, 0x0448, 0x044d, 0x0449, 0x0447, 0x044a,
+		0x042e, 0x0410, 0x0411, 0x0426, 0x0414, 0x0415, 0x0424, 0x0413,
+		0x0425, 0x0418, 0x0419, 0x041a, 0x041b, 0x041c, 0x041d, 0x041e,
+		0x041f, 0x042f, 0x0420, 0x0421, 0x0422, 0x0423, 0x0416, 0x0412,
+		0x042c, 0x042b, 0x0417, 0x0428, 0x042d, 0x0429, 0x0427, 0x042a,
+	},
+	[ENCODING_MACINTOSH - ENCODING_IBM866] = {
+		0x00c4, 0x00c5, 0x00c7, 0x00c9, 0x00d1, 0x00d6, 0x00dc, 0x00e1,
+		0x00e0, 0x00e2, 0x00e4, 0x00e3, 0x00e5, 0x00e7, 0x00e9, 0x00e8,
+		0x00ea, 0x00eb, 0x00ed, 0x00ec, 0x00ee, 0x00ef, 0x00f1, 0x00f3,
+		0x00f2, 0x00f4, 0x00f6, 0x00f5, 0x00fa, 0x00f9, 0x00fb, 0x00fc,
+		0x2020, 0x00b0, 0x00a2, 0x00a3, 0x00a7, 0x2022, 0x00b6, 0x00df,
+		0x00ae, 0x00a9, 0x2122, 0x00b4, 0x00a8, 0x2260, 0x00c6, 0x00d8,
+		0x221e, 0x00b1, 0x2264, 0x2265, 0x00a5, 0x00b5, 0x2202, 0x2211,
+		0x220f, 0x03c0, 0x222b, 0x00aa, 0x00ba, 0x03a9, 0x00e6, 0x00f8,
+		0x00bf, 0x00a1, 0x00ac, 0x221a, 0x0192, 0x2248, 0x2206, 0x00ab,
+		0x00bb, 0x2026, 0x00a0, 0x00c0, 0x00c3, 0x00d5, 0x0152, 0x0153,
+		0x2013, 0x2014, 0x201c, 0x201d, 0x2018, 0x2019, 0x00f7, 0x25ca,
+		0x00ff, 0x0178, 0x2044, 0x20ac, 0x2039, 0x203a, 0xfb01, 0xfb02,
+		0x2021, 0x00b7, 0x201a, 0x201e, 0x2030, 0x00c2, 0x00ca, 0x00c1,
+		0x00cb, 0x00c8, 0x00cd, 0x00ce, 0x00cf, 0x00cc, 0x00d3, 0x00d4,
+		0xf8ff, 0x00d2, 0x00da, 0x00db, 0x00d9, 0x0131, 0x02c6, 0x02dc,
+		0x00af, 0x02d8, 0x02d9, 0x02da, 0x00b8, 0x02dd, 0x02db, 0x02c7,
+	},
+	[ENCODING_WINDOWS_1250 - ENCODING_IBM866] = {
+		0x20ac, 0x0081, 0x201a, 0x0083, 0x201e, 0x2026, 0x2020, 0x2021,
+		0x0088, 0x2030, 0x0160, 0x2039, 0x015a, 0x0164, 0x017d, 0x0179,
+		0x0090, 0x2018, 0x2019, 0x201c, 0x201d, 0x2022, 0x2013, 0x2014,
+		0x0098, 0x2122, 0x0161, 0x203a, 0x015b, 0x0165, 0x017e, 0x017a,
+		0x00a0, 0x02c7, 0x02d8, 0x0141, 0x00a4, 0x0104, 0x00a6, 0x00a7,
+		0x00a8, 0x00a9, 0x015e, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x017b,
+		0x00b0, 0x00b1, 0x02db, 0x0142, 0x00b4, 0x00b5, 0x00b6, 0x00b7,
+		0x00b8, 0x0105, 0x015f, 0x00bb, 0x013d, 0x02dd, 0x013e, 0x017c,
+		0x0154, 0x00c1, 0x00c2, 0x0102, 0x00c4, 0x0139, 0x0106, 0x00c7,
+		0x010c, 0x00c9, 0x0118, 0x00cb, 0x011a, 0x00cd, 0x00ce, 0x010e,
+		0x0110, 0x0143, 0x0147, 0x00d3, 0x00d4, 0x0150, 0x00d6, 0x00d7,
+		0x0158, 0x016e, 0x00da, 0x0170, 0x00dc, 0x00dd, 0x0162, 0x00df,
+		0x0155, 0x00e1, 0x00e2, 0x0103, 0x00e4, 0x013a, 0x0107, 0x00e7,
+		0x010d, 0x00e9, 0x0119, 0x00eb, 0x011b, 0x00ed, 0x00ee, 0x010f,
+		0x0111, 0x0144, 0x0148, 0x00f3, 0x00f4, 0x0151, 0x00f6, 0x00f7,
+		0x0159, 0x016f, 0x00fa, 0x0171, 0x00fc, 0x00fd, 0x0163, 0x02d9,
+	},
+	[ENCODING_WINDOWS_1251 - ENCODING_IBM866] = {
+		0x0402, 0x0403, 0x201a, 0x0453, 0x201e, 0x2026, 0x2020, 0x2021,
+		0x20ac, 0x2030, 0x0409, 0x2039, 0x040a, 0x040c, 0x040b, 0x040f,
+		0x0452, 0x2018, 0x2019, 0x201c, 0x201d, 0x2022, 0x2013, 0x2014,
+		0x0098, 0x2122, 0x0459, 0x203a, 0x045a, 0x045c, 0x045b, 0x045f,
+		0x00a0, 0x040e, 0x045e, 0x0408, 0x00a4, 0x0490, 0x00a6, 0x00a7,
+		0x0401, 0x00a9, 0x0404, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x0407,
+		0x00b0, 0x00b1, 0x0406, 0x0456, 0x0491, 0x00b5, 0x00b6, 0x00b7,
+		0x0451, 0x2116, 0x0454, 0x00bb, 0x0458, 0x0405, 0x0455, 0x0457,
+		0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417,
+		0x0418, 0x0419, 0x041a, 0x041b, 0x041c, 0x041d, 0x041e, 0x041f,
+		0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427,
+		0x0428, 0x0429, 0x042a, 0x042b, 0x042c, 0x042d, 0x042e, 0x042f,
+		0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437,
+		0x0438, 0x0439, 0x043a, 0x043b, 0x043c, 0x043d, 0x043e, 0x043f,
+		0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447,
+		0x0448, 0x0449, 0x044a, 0x044b, 0x044c, 0x044d, 0x044e, 0x044f,
+	},
+	[ENCODING_WINDOWS_1252 - ENCODING_IBM866] = {
+		0x20ac, 0x0081, 0x201a, 0x0192, 0x201e, 0x2026, 0x2020, 0x2021,
+		0x02c6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008d, 0x017d, 0x008f,
+		0x0090, 0x2018, 0x2019, 0x201c, 0x201d, 0x2022, 0x2013, 0x2014,
+		0x02dc, 0x2122, 0x0161, 0x203a, 0x0153, 0x009d, 0x017e, 0x0178,
+		0x00a0, 0x00a1, 0x00a2, 0x00a3, 0x00a4, 0x00a5, 0x00a6, 0x00a7,
+		0x00a8, 0x00a9, 0x00aa, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x00af,
+		0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x00b4, 0x00b5, 0x00b6, 0x00b7,
+		0x00b8, 0x00b9, 0x00ba, 0x00bb, 0x00bc, 0x00bd, 0x00be, 0x00bf,
+		0x00c0, 0x00c1, 0x00c2, 0x00c3, 0x00c4, 0x00c5, 0x00c6, 0x00c7,
+		0x00c8, 0x00c9, 0x00ca, 0x00cb, 0x00cc, 0x00cd, 0x00ce, 0x00cf,
+		0x00d0, 0x00d1, 0x00d2, 0x00d3, 0x00d4, 0x00d5, 0x00d6, 0x00d7,
+		0x00d8, 0x00d9, 0x00da, 0x00db, 0x00dc, 0x00dd, 0x00de, 0x00df,
+		0x00e0, 0x00e1, 0x00e2, 0x00e3, 0x00e4, 0x00e5, 0x00e6, 0x00e7,
+		0x00e8, 0x00e9, 0x00ea, 0x00eb, 0x00ec, 0x00ed, 0x00ee, 0x00ef,
+		0x00f0, 0x00f1, 0x00f2, 0x00f3, 0x00f4, 0x00f5, 0x00f6, 0x00f7,
+		0x00f8, 0x00f9, 0x00fa, 0x00fb, 0x00fc, 0x00fd, 0x00fe, 0x00ff,
+	},
+	[ENCODING_WINDOWS_1253 - ENCODING_IBM866] = {
+		0x20ac, 0x0081, 0x201a, 0x0192, 0x201e, 0x2026, 0x2020, 0x2021,
+		0x0088, 0x2030, 0x008a, 0x2039, 0x008c, 0x008d, 0x008e, 0x008f,
+		0x0090, 0x2018, 0x2019, 0x201c, 0x201d, 0x2022, 0x2013, 0x2014,
+		0x0098, 0x2122, 0x009a, 0x203a, 0x009c, 0x009d, 0x009e, 0x009f,
+		0x00a0, 0x0385, 0x0386, 0x00a3, 0x00a4, 0x00a5, 0x00a6, 0x00a7,
+		0x00a8, 0x00a9, 0xfffd, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x2015,
+		0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x0384, 0x00b5, 0x00b6, 0x00b7,
+		0x0388, 0x0389, 0x038a, 0x00bb, 0x038c, 0x00bd, 0x038e, 0x038f,
+		0x0390, 0x0391, 0x0392, 0x0393, 0x0394, 0x0395, 0x0396, 0x0397,
+		0x0398, 0x0399, 0x039a, 0x039b, 0x039c, 0x039d, 0x039e, 0x039f,
+		0x03a0, 0x03a1, 0xfffd, 0x03a3, 0x03a4, 0x03a5, 0x03a6, 0x03a7,
+		0x03a8, 0x03a9, 0x03aa, 0x03ab, 0x03ac, 0x03ad, 0x03ae, 0x03af,
+		0x03b0, 0x03b1, 0x03b2, 0x03b3, 0x03b4, 0x03b5, 0x03b6, 0x03b7,
+		0x03b8, 0x03b9, 0x03ba, 0x03bb, 0x03bc, 0x03bd, 0x03be, 0x03bf,
+		0x03c0, 0x03c1, 0x03c2, 0x03c3, 0x03c4, 0x03c5, 0x03c6, 0x03c7,
+		0x03c8, 0x03c9, 0x03ca, 0x03cb, 0x03cc, 0x03cd, 0x03ce, 0xfffd,
+	},
+	[ENCODING_WINDOWS_1254 - ENCODING_IBM866] = {
+		0x20ac, 0x0081, 0x201a, 0x0192, 0x201e, 0x2026, 0x2020, 0x2021,
+		0x02c6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008d, 0x008e, 0x008f,
+		0x0090, 0x2018, 0x2019, 0x201c, 0x201d, 0x2022, 0x2013, 0x2014,
+		0x02dc, 0x2122, 0x0161, 0x203a, 0x0153, 0x009d, 0x009e, 0x0178,
+		0x00a0, 0x00a1, 0x00a2, 0x00a3, 0x00a4, 0x00a5, 0x00a6, 0x00a7,
+		0x00a8, 0x00a9, 0x00aa, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x00af,
+		0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x00b4, 0x00b5, 0x00b6, 0x00b7,
+		0x00b8, 0x00b9, 0x00ba, 0x00bb, 0x00bc, 0x00bd, 0x00be, 0x00bf,
+		0x00c0, 0x00c1, 0x00c2, 0x00c3, 0x00c4, 0x00c5, 0x00c6, 0x00c7,
+		0x00c8, 0x00c9, 0x00ca, 0x00cb, 0x00cc, 0x00cd, 0x00ce, 0x00cf,
+		0x011e, 0x00d1, 0x00d2, 0x00d3, 0x00d4, 0x00d5, 0x00d6, 0x00d7,
+		0x00d8, 0x00d9, 0x00da, 0x00db, 0x00dc, 0x0130, 0x015e, 0x00df,
+		0x00e0, 0x00e1, 0x00e2, 0x00e3, 0x00e4, 0x00e5, 0x00e6, 0x00e7,
+		0x00e8, 0x00e9, 0x00ea, 0x00eb, 0x00ec, 0x00ed, 0x00ee, 0x00ef,
+		0x011f, 0x00f1, 0x00f2, 0x00f3, 0x00f4, 0x00f5, 0x00f6, 0x00f7,
+		0x00f8, 0x00f9, 0x00fa, 0x00fb, 0x00fc, 0x0131, 0x015f, 0x00ff,
+	},
+	[ENCODING_WINDOWS_1257 - ENCODING_IBM866] = {
+		0x20ac, 0x0081, 0x201a, 0x0083, 0x201e, 0x2026, 0x2020, 0x2021,
+		0x0088, 0x2030, 0x008a, 0x2039, 0x008c, 0x00a8, 0x02c7, 0x00b8,
+		0x0090, 0x2018, 0x2019, 0x201c, 0x201d, 0x2022, 0x2013, 0x2014,
+		0x0098, 0x2122, 0x009a, 0x203a, 0x009c, 0x00af, 0x02db, 0x009f,
+		0x00a0, 0xfffd, 0x00a2, 0x00a3, 0x00a4, 0xfffd, 0x00a6, 0x00a7,
+		0x00d8, 0x00a9, 0x0156, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x00c6,
+		0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x00b4, 0x00b5, 0x00b6, 0x00b7,
+		0x00f8, 0x00b9, 0x0157, 0x00bb, 0x00bc, 0x00bd, 0x00be, 0x00e6,
+		0x0104, 0x012e, 0x0100, 0x0106, 0x00c4, 0x00c5, 0x0118, 0x0112,
+		0x010c, 0x00c9, 0x0179, 0x0116, 0x0122, 0x0136, 0x012a, 0x013b,
+		0x0160, 0x0143, 0x0145, 0x00d3, 0x014c, 0x00d5, 0x00d6, 0x00d7,
+		0x0172, 0x0141, 0x015a, 0x016a, 0x00dc, 0x017b, 0x017d, 0x00df,
+		0x0105, 0x012f, 0x0101, 0x0107, 0x00e4, 0x00e5, 0x0119, 0x0113,
+		0x010d, 0x00e9, 0x017a, 0x0117, 0x0123, 0x0137, 0x012b, 0x013c,
+		0x0161, 0x0144, 0x0146, 0x00f3, 0x014d, 0x00f5, 0x00f6, 0x00f7,
+		0x0173, 0x0142, 0x015b, 0x016b, 0x00fc, 0x017c, 0x017e, 0x02d9,
+	},
+};
+
+const char *
+encoding_name(int encoding)
+{
+	assert(encoding >= 0 &&
+	    encoding < (int) (sizeof(names) / sizeof(names[0])));
+
+	return names[encoding];
+}
+
+/*
+ * Returns the encoding of a label like "ISO-8859-1", or ENCODING_NONE
+ * if it is not known.
+ */
+int
+encoding_label(const char *s, size_t len)
+{
+	const char *label;
+	size_t i, j;
+
+	while (len > 0 && IS_SPACE(*s)) {
+		s++;
+		len--;
+	}
+	while (len > 0 && IS_SPACE(s[len - 1]))
+		len--;
+
+	for (i = 0; i < sizeof(labels) / sizeof(labels[0]); i++) {
+		label = labels[i].label;
+		for (j = 0; j < len && label[j] != '\0'; j++)
+			if (TO_LOWER(s[j]) != label[j])
+				break;
+		if (j == len && label[j] == '\0')
+			return labels[i].encoding;
+	}
+
+	return ENCODING_NONE;
+}
+
+/*
+ * Returns the encoding of the charset parameter in a Content-Type
+ * value like "text/html; charset=utf-8", or ENCODING_NONE.
+ */
+int
+encoding_charset(const char *s, size_t len)
+{
+	size_t i, j;
+	char quote;
+
+	i = 0;
+	for (;;) {
+		for (; i + 7 <= len; i++) {
+			for (j = 0; j < 7; j++)
+				if (TO_LOWER(s[i + j]) != "charset"[j])
+					break;
+			if (j == 7)
+				break;
+		}
+		if (i + 7 > len)
+			return ENCODING_NONE;
+		for (i += 7; i < len && IS_SPACE(s[i]); i++)
+			;
+		if (i < len && s[i] == '=')
+			break;
+	}
+
+	for (i++; i < len && IS_SPACE(s[i]); i++)
+		;
+	if (i == len)
+		return ENCODING_NONE;
+
+	if (s[i] == '"' || s[i] == '\'') {
+		quote = s[i++];
+		for (j = i; j < len && s[j] != quote; j++)
+			;
+		if (j == len)
+			return ENCODING_NONE;
+	} else
+		for (j = i; j < len && !IS_SPACE(s[j]) && s[j] != ';'; j++)
+			;
+
+	return encoding_label(&s[i], j - i);
+}
+
+/*
+ * Returns the length of the byte order mark at the start of the buffer
+ * and sets the encoding it implies, or returns 0.
+ */
+size_t
+encoding_bom(const char *buf, size_t len, int *encoding)
+{
+	const unsigned char *s = (const unsigned char *) buf;
+
+	if (len >= 3 && s[0] == 0xef && s[1] == 0xbb && s[2] == 0xbf) {
+		*encoding = ENCODING_UTF8;
+		return 3;
+	} else if (len >= 2 && s[0] == 0xfe && s[1] == 0xff) {
+		*encoding = ENCODING_UTF16BE;
+		return 2;
+	} else if (len >= 2 && s[0] == 0xff && s[1] == 0xfe) {
+		*encoding = ENCODING_UTF16LE;
+		return 2;
+	}
+
+	return 0;
+}
+
+/*
+ * Attribute of a tag found by the prescan, truncated if it is long.
+ */
+struct prescan_attr {
+	char	name[16];
+	char	value[128];
+	size_t	value_len;
+};
+
+/*
+ * The "get an attribute" algorithm of the prescan. Returns the position
+ * after the attribute, or 0 if there is none and *i is left at the '>'
+ * or at the end.
+ */
+static int
+get_attr(const char *s, size_t len, size_t *i, struct prescan_attr *attr)
+{
+	size_t name_len;
+	char c, quote;
+
+	attr->value_len = name_len = 0;
+	while (*i < len && (IS_SPACE(s[*i]) || s[*i] == '/'))
+		(*i)++;
+	if (*i == len || s[*i] == '>')
+		return 0;
+
+	for (;; (*i)++) {
+		if (*i == len)
+			return 0;
+		c = s[*i];
+		if (c == '=' && name_len > 0) {
+			(*i)++;
+			break;
+		} else if (IS_SPACE(c)) {
+			while (*i < len && IS_SPACE(s[*i]))
+				(*i)++;
+			if (*i == len)
+				return 0;
+			if (s[*i] != '=')
+				goto done;
+			(*i)++;
+			break;
+		} else if (c == '/' || c == '>')
+			goto done;
+		if (name_len < sizeof(attr->name) - 1)
+			attr->name[name_len++] = TO_LOWER(c);
+	}
+
+	while (*i < len && IS_SPACE(s[*i]))
+		(*i)++;
+	if (*i == len)
+		return 0;
+
+	if (s[*i] == '"' || s[*i] == '\'') {
+		quote = s[(*i)++];
+		for (; *i < len && s[*i] != quote; (*i)++)
+			if (attr->value_len < sizeof(attr->value))
+				attr->value[attr->value_len++] =
+				    TO_LOWER(s[*i]);
+		if (*i == len)
+			return 0;
+		(*i)++;
+	} else if (s[*i] != '>') {
+		for (; *i < len && !IS_SPACE(s[*i]) && s[*i] != '>'; (*i)++)
+			if (attr->value_len < sizeof(attr->value))
+				attr->value[attr->value_len++] =
+				    TO_LOWER(s[*i]);
+		if (*i == len)
+			return 0;
+	}
+
+done:
+	attr->name[name_len] = '\0';
+	return 1;
+}
+
+/*
+ * Handle a <meta> tag starting at *i, the "<meta" already matched.
+ * Returns the encoding it declares, or ENCODING_NONE.
+ */
+static int
+prescan_meta(const char *s, size_t len, size_t *i)
+{
+	struct prescan_attr attr;
+	int seen, got_pragma, need_pragma, charset;
+
+	seen = got_pragma = 0;
+	need_pragma = -1;
+	charset = ENCODING_NONE;
+
+	*i += 5;
+	while (get_attr(s, len, i, &attr)) {
+		if (strcmp(attr.name, "http-equiv") == 0 && !(seen & 1)) {
+			seen |= 1;
+			if (attr.value_len == 12 &&
+			    memcmp(attr.value, "content-type", 12) == 0)
+				got_pragma = 1;
+		} else if (strcmp(attr.name, "content") == 0 && !(seen & 2)) {
+			seen |= 2;
+			if (charset == ENCODING_NONE && need_pragma == -1) {
+				charset = encoding_charset(attr.value,
+				    attr.value_len);
+				if (charset != ENCODING_NONE)
+					need_pragma = 1;
+			}
+		} else if (strcmp(attr.name, "charset") == 0 && !(seen & 4)) {
+			seen |= 4;
+			charset = encoding_label(attr.value, attr.value_len);
+			need_pragma = 0;
+		}
+	}
+
+	if (need_pragma == -1 || (need_pragma == 1 && !got_pragma))
+		return ENCODING_NONE;
+	if (charset == ENCODING_UTF16LE || charset == ENCODING_UTF16BE)
+		return ENCODING_UTF8;
+	return charset;
+}
+
+/*
+ * Look for a <meta charset> or <meta http-equiv="Content-Type"> in the
+ * first ENCODING_PRESCAN bytes, as in the HTML standard. Returns the
+ * encoding declared, or ENCODING_NONE.
+ */
+int
+encoding_prescan(const char *s, size_t len)
+{
+	struct prescan_attr attr;
+	size_t i;
+	int charset;
+
+	if (len > ENCODING_PRESCAN)
+		len = ENCODING_PRESCAN;
+
+	for (i = 0; i < len; i++) {
+		if (s[i] != '<')
+			continue;
+		if (i + 4 <= len && memcmp(&s[i], "<!--", 4) == 0) {
+			for (i += 2; i + 3 <= len; i++)
+				if (memcmp(&s[i], "-->", 3) == 0)
+					break;
+			i += 2;
+		} else if (i + 6 <= len && TO_LOWER(s[i + 1]) == 'm' &&
+		    TO_LOWER(s[i + 2]) == 'e' && TO_LOWER(s[i + 3]) == 't' &&
+		    TO_LOWER(s[i + 4]) == 'a' &&
+		    (IS_SPACE(s[i + 5]) || s[i + 5] == '/')) {
+			if ((charset = prescan_meta(s, len, &i)) !=
+			    ENCODING_NONE)
+				return charset;
+		} else if (i + 2 < len && (IS_ALPHA(s[i + 1]) ||
+		    (s[i + 1] == '/' && IS_ALPHA(s[i + 2])))) {
+			while (i < len && !IS_SPACE(s[i]) && s[i] != '>')
+				i++;
+			while (get_attr(s, len, &i, &attr))
+				;
+		} else if (i + 1 < len && (s[i + 1] == '!' ||
+		    s[i + 1] == '/' || s[i + 1] == '?')) {
+			while (i < len && s[i] != '>')
+				i++;
+		}
+	}
+
+	return ENCODING_NONE;
+}
+
+/*
+ * Returns the length of a valid UTF-8 sequence at s, 0 if it is valid
+ * so far but cut short, or minus the number of bytes to replace with
+ * U+FFFD if it is not valid.
+ */
+static int
+utf8_check(const unsigned char *s, size_t len)
+{
+	unsigned char lo, hi;
+	int n, i;
+
+	lo = 0x80;
+	hi = 0xbf;
+	if (s[0] < 0x80)
+		return 1;
+	else if (s[0] < 0xc2)
+		return -1;
+	else if (s[0] < 0xe0)
+		n = 2;
+	else if (s[0] < 0xf0) {
+		n = 3;
+		if (s[0] == 0xe0)
+			lo = 0xa0;
+		else if (s[0] == 0xed)
+			hi = 0x9f;
+	} else if (s[0] < 0xf5) {
+		n = 4;
+		if (s[0] == 0xf0)
+			lo = 0x90;
+		else if (s[0] == 0xf4)
+			hi = 0x8f;
+	} else
+		return -1;
+
+	for (i = 1; i < n; i++) {
+		if (i == len)
+			return 0;
+		if (s[i] < lo || s[i] > hi)
+			return -i;
+		lo = 0x80;
+		hi = 0xbf;
+	}
+
+	return n;
+}
+
+/*
+ * Shift based DFA for validating UTF-8: the next state is the 6 bits
+ * of utf8_dfa[byte] at the offset given by the current state, so there
+ * is no branch per byte. ERROR is 0 and stays so.
+ */
+#define S_ERROR		0
+#define S_ACCEPT	6
+#define S_TAIL1		12		/* one continuation byte to go */
+#define S_TAIL2		18
+#define S_TAIL3		24
+#define S_E0		30		/* A0-BF then one more */
+#define S_ED		36		/* 80-9F then one more */
+#define S_F0		42		/* 90-BF then two more */
+#define S_F4		48		/* 80-8F then two more */
+
+#define T(_from, _to) ((uint64_t) (_to) << (_from))
+
+#define ASCII	T(S_ACCEPT, S_ACCEPT)
+#define CONT	(T(S_TAIL1, S_ACCEPT) | T(S_TAIL2, S_TAIL1) | \
+		T(S_TAIL3, S_TAIL2))
+#define CONT_8	(CONT | T(S_ED, S_TAIL1) | T(S_F4, S_TAIL2))
+#define CONT_9	(CONT | T(S_ED, S_TAIL1) | T(S_F0, S_TAIL2))
+#define CONT_A	(CONT | T(S_E0, S_TAIL1) | T(S_F0, S_TAIL2))
+#define LEAD2	T(S_ACCEPT, S_TAIL1)
+#define LEAD3	T(S_ACCEPT, S_TAIL2)
+#define LEAD4	T(S_ACCEPT, S_TAIL3)
+#define BAD	0
+
+#define X4(_x) _x, _x, _x, _x
+#define X16(_x) X4(_x), X4(_x), X4(_x), X4(_x)
+
+static const uint64_t utf8_dfa[256] = {
+	X16(ASCII), X16(ASCII), X16(ASCII), X16(ASCII),
+	X16(ASCII), X16(ASCII), X16(ASCII), X16(ASCII),
+	X16(CONT_8), X16(CONT_9), X16(CONT_A), X16(CONT_A),
+	BAD, BAD, LEAD2, LEAD2, X4(LEAD2), X4(LEAD2), X4(LEAD2),
+	X16(LEAD2),
+	T(S_ACCEPT, S_E0), LEAD3, LEAD3, LEAD3, X4(LEAD3), X4(LEAD3),
+	LEAD3, T(S_ACCEPT, S_ED), LEAD3, LEAD3,
+	T(S_ACCEPT, S_F0), LEAD4, LEAD4, LEAD4, T(S_ACCEPT, S_F4),
+	BAD, BAD, BAD, X4(BAD), X4(BAD)
+};
+
+/*
+ * Returns the start of the sequence that the valid prefix s[0..i) ends
+ * in the middle of.
+ */
+static size_t
+seq_start(const unsigned char *s, size_t i)
+{
+	while (i > 0 && (s[i - 1] & 0xc0) == 0x80)
+		i--;
+	return i > 0 ? i - 1 : 0;
+}
+
+/*
+ * Returns the length of the longest prefix of buf that is valid UTF-8.
+ * Runs of ASCII are skipped 16 bytes at a time and the rest goes
+ * through the DFA in blocks of 16 bytes, checking for an error only at
+ * the end of each block.
+ */
+size_t
+encoding_utf8_valid(const char *buf, size_t len)
+{
+	const unsigned char *s = (const unsigned char *) buf;
+	uint64_t w[2], state, prev;
+	size_t i, j, end, last;
+
+	state = S_ACCEPT;
+	for (i = 0; i < len; i = end) {
+		if (state == S_ACCEPT && i + 16 <= len) {
+			memcpy(w, &s[i], 16);
+			if (((w[0] | w[1]) & NON_ASCII) == 0) {
+				end = i + 16;
+				continue;
+			}
+		}
+
+		prev = state;
+		end = i + 16 < len ? i + 16 : len;
+		for (j = i; j < end; j++)
+			state = (utf8_dfa[s[j]] >> state) & 63;
+		if (state != S_ERROR)
+			continue;
+
+		/*
+		 * Find the end of the last valid sequence in the block.
+		 */
+		last = prev == S_ACCEPT ? i : seq_start(s, i);
+		for (state = prev, j = i; state != S_ERROR; j++) {
+			state = (utf8_dfa[s[j]] >> state) & 63;
+			if (state == S_ACCEPT)
+				last = j + 1;
+		}
+		return last;
+	}
+
+	return state == S_ACCEPT ? len : seq_start(s, len);
+}
+
+/*
+ * Guess the encoding of a document that has no byte order mark: a
+ * <meta> declaration wins, otherwise it is UTF-8 if it validates as
+ * such and windows-1252 if not. If final is zero, buf is only the
+ * start of the document and may end in the middle of a character.
+ */
+int
+encoding_sniff(const char *buf, size_t len, int final)
+{
+	size_t valid;
+	int charset;
+
+	if ((charset = encoding_prescan(buf, len)) != ENCODING_NONE)
+		return charset;
+
+	valid = encoding_utf8_valid(buf, len);
+	if (valid == len || (!final &&
+	    utf8_check((const unsigned char *) &buf[valid], len - valid) == 0))
+		return ENCODING_UTF8;
+
+	return ENCODING_WINDOWS_1252;
+}
+
+static size_t
+put_utf8(char *dst, unsigned int cp)
+{
+	if (cp < 0x80) {
+		dst[0] = cp;
+		return 1;
+	} else if (cp < 0x800) {
+		dst[0] = 0xc0 | (cp >> 6);
+		dst[1] = 0x80 | (cp & 0x3f);
+		return 2;
+	} else if (cp < 0x10000) {
+		dst[0] = 0xe0 | (cp >> 12);
+		dst[1] = 0x80 | ((cp >> 6) & 0x3f);
+		dst[2] = 0x80 | (cp & 0x3f);
+		return 3;
+	}
+	dst[0] = 0xf0 | (cp >> 18);
+	dst[1] = 0x80 | ((cp >> 12) & 0x3f);
+	dst[2] = 0x80 | ((cp >> 6) & 0x3f);
+	dst[3] = 0x80 | (cp & 0x3f);
+	return 4;
+}
+
+static size_t
+decode_single(const unsigned short *table, const unsigned char *s,
+    size_t *len, char *dst, size_t size)
+{
+	uint64_t w;
+	size_t i, o;
+
+	i = o = 0;
+	while (i < *len && o + 3 <= size) {
+		if (i + 8 <= *len && o + 8 <= size) {
+			memcpy(&w, &s[i], 8);
+			if ((w & NON_ASCII) == 0) {
+				memcpy(&dst[o], &w, 8);
+				i += 8;
+				o += 8;
+				continue;
+			}
+		}
+		if (s[i] < 0x80)
+			dst[o++] = s[i];
+		else
+			o += put_utf8(&dst[o], table[s[i] - 0x80]);
+		i++;
+	}
+
+	*len = i;
+	return o;
+}
+
+/*
+ * Copy UTF-8 replacing invalid sequences with U+FFFD as in the
+ * Encoding standard.
+ */
+static size_t
+decode_utf8(const unsigned char *s, size_t *len, char *dst, size_t size,
+    int final)
+{
+	size_t i, o, n;
+	int k;
+
+	i = o = 0;
+	while (i < *len && o + 4 <= size) {
+		n = *len - i < size - o ? *len - i : size - o;
+		n = encoding_utf8_valid((const char *) &s[i], n);
+		if (n > 0) {
+			memcpy(&dst[o], &s[i], n);
+			i += n;
+			o += n;
+			continue;
+		}
+
+		if ((k = utf8_check(&s[i], *len - i)) > 0) {
+			memcpy(&dst[o], &s[i], k);
+			o += k;
+			i += k;
+		} else if (k == 0 && !final)
+			break;
+		else {
+			o += put_utf8(&dst[o], 0xfffd);
+			i += k == 0 ? *len - i : -k;
+		}
+	}
+
+	*len = i;
+	return o;
+}
+
+static size_t
+decode_utf16(int be, const unsigned char *s, size_t *len, char *dst,
+    size_t size, int final)
+{
+	unsigned int cp, lo;
+	size_t i, o;
+
+	i = o = 0;
+	while (i + 2 <= *len && o + 4 <= size) {
+		cp = be ? (s[i] << 8 | s[i + 1]) : (s[i + 1] << 8 | s[i]);
+		i += 2;
+		if (cp >= 0xd800 && cp < 0xdc00) {
+			if (i + 2 > *len) {
+				if (!final) {
+					i -= 2;
+					break;
+				}
+				cp = 0xfffd;
+			} else {
+				lo = be ? (s[i] << 8 | s[i + 1]) :
+				    (s[i + 1] << 8 | s[i]);
+				if (lo >= 0xdc00 && lo < 0xe000) {
+					cp = 0x10000 + ((cp - 0xd800) << 10) +
+					    (lo - 0xdc00);
+					i += 2;
+				} else
+					cp = 0xfffd;
+			}
+		} else if (cp >= 0xdc00 && cp < 0xe000)
+			cp = 0xfffd;
+		o += put_utf8(&dst[o], cp);
+	}
+
+	if (final && i + 1 == *len && o + 3 <= size) {
+		o += put_utf8(&dst[o], 0xfffd);
+		i++;
+	}
+
+	*len = i;
+	return o;
+}
+
+/*
+ * Decode as much of src to UTF-8 as fits in dst, which must have room
+ * for at least 4 bytes. On return *len is the number of bytes of src
+ * that were decoded. Unless final is set, a character cut short at the
+ * end of src is left for the next call. Returns the number of bytes
+ * put to dst.
+ */
+size_t
+encoding_decode(int encoding, const char *src, size_t *len, char *dst,
+    size_t size, int final)
+{
+	const unsigned char *s = (const unsigned char *) src;
+
+	assert(size >= 4);
+
+	switch (encoding) {
+	case ENCODING_UTF8:
+		return decode_utf8(s, len, dst, size, final);
+	case ENCODING_UTF16LE:
+	case ENCODING_UTF16BE:
+		return decode_utf16(encoding == ENCODING_UTF16BE, s, len, dst,
+		    size, final);
+	default:
+		assert(encoding >= ENCODING_IBM866 &&
+		    encoding <= ENCODING_WINDOWS_1257);
+		return decode_single(tables[encoding - ENCODING_IBM866], s,
+		    len, dst, size);
+	}
+}
+
+#ifdef TEST
+#include <stdio.h>
+#include <stdlib.h>
+
+static void
+prescan(const char *html, int expect)
+{
+	int encoding;
+
+	encoding = encoding_prescan(html, strlen(html));
+	if (encoding != expect) {
+		fprintf(stderr, "%s: got %s, expect %s\n", html,
+		    encoding_name(encoding), encoding_name(expect));
+		assert(0);
+	}
+}
+
+/*
+ * Decode as if read step bytes at a time.
+ */
+static void
+decode(int encoding, const char *src, size_t len, size_t step,
+    const char *expect)
+{
+	char dst[256];
+	size_t i, n, o, end;
+
+	i = o = end = 0;
+	while (i < len) {
+		end = end + step < len ? end + step : len;
+		n = end - i;
+		o += encoding_decode(encoding, &src[i], &n, &dst[o],
+		    sizeof(dst) - o, end == len);
+		i += n;
+	}
+	dst[o] = '\0';
+	if (strcmp(dst, expect) != 0) {
+		fprintf(stderr, "%s: got %s, expect %s\n",
+		    encoding_name(encoding), dst, expect);
+		assert(0);
+	}
+}
+
+/*
+ * Valid prefix one sequence at a time.
+ */
+static size_t
+valid_slow(const char *buf, size_t len)
+{
+	size_t i;
+	int n;
+
+	for (i = 0; i < len; i += n)
+		if ((n = utf8_check((const unsigned char *) &buf[i],
+		    len - i)) <= 0)
+			break;
+	return i;
+}
+
+int
+main(int argc, char **argv)
+{
+	const char *s;
+	char buf[64];
+	size_t i, j, n;
+	int encoding;
+
+	srand(1);
+	for (i = 0; i < 100000; i++) {
+		n = rand() % sizeof(buf);
+		for (j = 0; j < n; j++)
+			buf[j] = rand() % 4 == 0 ? 'a' : 0x80 + rand() % 0x80;
+		assert(encoding_utf8_valid(buf, n) == valid_slow(buf, n));
+	}
+	for (i = 0; i < 100000; i++) {
+		for (n = 0; n + 4 <= sizeof(buf); )
+			n += put_utf8(&buf[n], rand() % 4 == 0 ? 'a' :
+			    rand() % 4 == 0 ? 0x10000 + rand() % 0x100000 :
+			    rand() % 0xd800);
+		if (rand() % 2)
+			buf[rand() % n] = rand();
+		assert(encoding_utf8_valid(buf, n) == valid_slow(buf, n));
+	}
+
+	assert(encoding_label(" Latin1\t", 8) == ENCODING_WINDOWS_1252);
+	assert(encoding_label("utf8x", 5) == ENCODING_NONE);
+	s = "text/html; Charset = \"KOI8-R\"";
+	assert(encoding_charset(s, strlen(s)) == ENCODING_KOI8_R);
+	s = "text/html;charset=utf-8;x";
+	assert(encoding_charset(s, strlen(s)) == ENCODING_UTF8);
+	s = "charset; charset='x";
+	assert(encoding_charset(s, strlen(s)) == ENCODING_NONE);
+
+	assert(encoding_bom("\xef\xbb\xbfx", 4, &encoding) == 3 &&
+	    encoding == ENCODING_UTF8);
+	assert(encoding_bom("\xff\xfe", 2, &encoding) == 2 &&
+	    encoding == ENCODING_UTF16LE);
+	assert(encoding_bom("\xef\xbb", 2, &encoding) == 0);
+
+	prescan("<meta charset=iso-8859-2>", ENCODING_ISO_8859_2);
+	prescan("<META CHARSET='Windows-1251'/>", ENCODING_WINDOWS_1251);
+	prescan("<meta http-equiv=Content-Type "
+	    "content=\"text/html; charset=koi8-u\">", ENCODING_KOI8_U);
+	prescan("<meta content=\"text/html; charset=koi8-u\">", ENCODING_NONE);
+	prescan("<meta charset=utf-16le>", ENCODING_UTF8);
+	prescan("<meta charset=bogus><meta charset=latin2>",
+	    ENCODING_ISO_8859_2);
+	prescan("<!-- <meta charset=latin2> --><p>", ENCODING_NONE);
+	prescan("<div title='<meta charset=latin2>'>", ENCODING_NONE);
+	prescan("<metal charset=latin2>", ENCODING_NONE);
+	prescan("<meta charset=latin2", ENCODING_NONE);
+
+	assert(encoding_sniff("<p>caf\xc3\xa9", 8, 1) == ENCODING_UTF8);
+	assert(encoding_sniff("<p>caf\xc3", 7, 0) == ENCODING_UTF8);
+	assert(encoding_sniff("<p>caf\xc3", 7, 1) == ENCODING_WINDOWS_1252);
+	assert(encoding_sniff("<p>caf\xe9", 7, 1) == ENCODING_WINDOWS_1252);
+	assert(encoding_sniff("\xed\xa0\x80", 3, 1) == ENCODING_WINDOWS_1252);
+	assert(encoding_utf8_valid("abcdefgh\xe2\x82\xac!\xf4\x90", 14) ==
+	    12);
+
+	decode(ENCODING_UTF8, "a\xc3\xa9\xc0\xaf\xe2\x82\xe2\x82\xac\xf4\x90"
+	    "\xed\xa0\x80z\xf0\x9f\x98", 19, 2,
+	    "a\xc3\xa9\xef\xbf\xbd\xef\xbf\xbd\xef\xbf\xbd\xe2\x82\xac"
+	    "\xef\xbf\xbd\xef\xbf\xbd\xef\xbf\xbd\xef\xbf\xbd\xef\xbf\xbd"
+	    "z\xef\xbf\xbd");
+	decode(ENCODING_WINDOWS_1252, "caf\xe9 \x80\x81", 7, 3,
+	    "caf\xc3\xa9 \xe2\x82\xac\xc2\x81");
+	decode(ENCODING_KOI8_R, "\xf0\xd2\xc9\xd7\xc5\xd4 world!", 13, 100,
+	    "\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82 world!");
+	decode(ENCODING_UTF16LE, "a\0\xac\x20=\xd8\x00\xdf", 8, 3,
+	    "a\xe2\x82\xac\xf0\x9f\x9c\x80");
+	decode(ENCODING_UTF16BE, "\0a\xd8=\0b\0", 7, 1,
+	    "a\xef\xbf\xbd" "b\xef\xbf\xbd");
+	return 0;
+}
+#endif
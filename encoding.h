@@ -0,0 +1,62 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef ENCODING_H
+#define ENCODING_H
+
+#include <stddef.h>
+
+/*
+ * Character encodings that can be decoded to UTF-8. Other labels are
+ * not recognized and such documents are sniffed like undeclared ones.
+ */
+enum encoding {
+	ENCODING_NONE,			/* not known yet */
+	ENCODING_BINARY,		/* bytes as they are */
+	ENCODING_UTF8,
+	ENCODING_UTF16LE,
+	ENCODING_UTF16BE,
+	ENCODING_IBM866,		/* single-byte from here on */
+	ENCODING_ISO_8859_2,
+	ENCODING_ISO_8859_5,
+	ENCODING_ISO_8859_7,
+	ENCODING_ISO_8859_15,
+	ENCODING_KOI8_R,
+	ENCODING_KOI8_U,
+	ENCODING_MACINTOSH,
+	ENCODING_WINDOWS_1250,
+	ENCODING_WINDOWS_1251,
+	ENCODING_WINDOWS_1252,
+	ENCODING_WINDOWS_1253,
+	ENCODING_WINDOWS_1254,
+	ENCODING_WINDOWS_1257
+};
+
+#define ENCODING_PRESCAN 1024
+
+const char	*encoding_name(int);
+int		 encoding_label(const char *, size_t);
+int		 encoding_charset(const char *, size_t);
+size_t		 encoding_bom(const char *, size_t, int *);
+int		 encoding_prescan(const char *, size_t);
+int		 encoding_sniff(const char *, size_t, int);
+size_t		 encoding_utf8_valid(const char *, size_t);
+size_t		 encoding_decode(int, const char *, size_t *, char *, size_t,
+		    int);
+
+#endif
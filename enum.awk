@@ -2,15 +2,26 @@ BEGIN {
 	printf("/* generated by enum.awk */\n");
 	if (mode == "c")
 		printf("static const char *%s[] = {\n", name);
-	else
+	else {
+		printf("#ifndef %s_H\n#define %s_H\n", toupper(name),
+		    toupper(name));
 		printf("enum %s {\n", name);
+	}
 }
 /^[A-Z_]/ {
 	if (mode == "h")
 		printf("\t%s_%s,\n", prefix, $1);
-	else
+	else if (lower) {
+		s = tolower($1);
+		gsub("_", "-", s);
+		printf("\t\"%s\",\n", s);
+	} else
 		printf("\t\"%s\",\n", $1);
 }
 END {
+	if (mode == "h" && last != "")
+		printf("\t%s\n", last);
 	printf("};\n");
+	if (mode == "h")
+		printf("#endif\n");
 }
@@ -0,0 +1,25 @@
+/* generated by enum.awk */
+static const char *errors[] = {
+	"abrupt-closing-of-empty-comment",
+	"cdata-in-html-content",
+	"incorrectly-closed-comment",
+	"incorrectly-opened-comment",
+	"invalid-first-character-of-tag-name",
+	"missing-attribute-value",
+	"missing-doctype-name",
+	"missing-whitespace-before-doctype-name",
+	"missing-whitespace-between-attributes",
+	"nested-comment",
+	"unexpected-character-in-attribute-name",
+	"unexpected-character-in-unquoted-attribute-value",
+	"unexpected-equals-sign-before-attribute-name",
+	"unexpected-solidus-in-tag",
+	"unexpected-doctype",
+	"unexpected-token",
+	"implied-head",
+	"element-not-in-scope",
+	"mismatched-end-tag",
+	"unclosed-element",
+	"nested-button",
+	"unsupported",
+};
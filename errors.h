@@ -0,0 +1,29 @@
+/* generated by enum.awk */
+#ifndef ERRORS_H
+#define ERRORS_H
+enum errors {
+	ERROR_ABRUPT_CLOSING_OF_EMPTY_COMMENT,
+	ERROR_CDATA_IN_HTML_CONTENT,
+	ERROR_INCORRECTLY_CLOSED_COMMENT,
+	ERROR_INCORRECTLY_OPENED_COMMENT,
+	ERROR_INVALID_FIRST_CHARACTER_OF_TAG_NAME,
+	ERROR_MISSING_ATTRIBUTE_VALUE,
+	ERROR_MISSING_DOCTYPE_NAME,
+	ERROR_MISSING_WHITESPACE_BEFORE_DOCTYPE_NAME,
+	ERROR_MISSING_WHITESPACE_BETWEEN_ATTRIBUTES,
+	ERROR_NESTED_COMMENT,
+	ERROR_UNEXPECTED_CHARACTER_IN_ATTRIBUTE_NAME,
+	ERROR_UNEXPECTED_CHARACTER_IN_UNQUOTED_ATTRIBUTE_VALUE,
+	ERROR_UNEXPECTED_EQUALS_SIGN_BEFORE_ATTRIBUTE_NAME,
+	ERROR_UNEXPECTED_SOLIDUS_IN_TAG,
+	ERROR_UNEXPECTED_DOCTYPE,
+	ERROR_UNEXPECTED_TOKEN,
+	ERROR_IMPLIED_HEAD,
+	ERROR_ELEMENT_NOT_IN_SCOPE,
+	ERROR_MISMATCHED_END_TAG,
+	ERROR_UNCLOSED_ELEMENT,
+	ERROR_NESTED_BUTTON,
+	ERROR_UNSUPPORTED,
+	NERRORS
+};
+#endif
@@ -19,13 +19,16 @@
 #include <ctype.h>
 #include <err.h>
 #include <unistd.h>
+#include <string.h>
+#include <stdlib.h>
 
 /*
- * Optional: getrusage() and gettimeofday() for perf display.
+ * Optional: getrusage() and clock_gettime() for perf display.
  */
 #include <sys/resource.h>
-#include <sys/time.h>
+#include <time.h>
 
+#include <purehtml/purehtml.h>
 #include <purehtml/tokenize.h>
 #include <purehtml/dispatch.h>
 #include <purehtml/ostack.h>
@@ -33,13 +36,30 @@
 #include <purehtml/elem.h>
 #include <purehtml/cdata.h>
 #include <purehtml/document.h>
+#include <purehtml/inflate.h>
+#include <purehtml/warc.h>
+#include <purehtml/report.h>
+#include <purehtml/stats.h>
+#include <purehtml/util.h>
+#include <purehtml/tokenlog.h>
 
 /*
  * We dump the tree as we get it.
  * The magic happens in begin() and end().
  */
-static void begin(struct node *);
-static void end(struct node *);
+static int begin(struct node *);
+static int end(struct node *);
+
+/*
+ * With -p the callbacks are timed and the allocations counted.
+ */
+static int (*on_begin)(struct node *) = begin;
+static int (*on_end)(struct node *) = end;
+static int timed_begin(struct node *);
+static int timed_end(struct node *);
+static void *count_malloc(size_t);
+static void *count_realloc(void *, size_t);
+static void count_free(void *);
 
 /*
  * Optional helper functions.
@@ -48,8 +68,14 @@ static void print_stack(void);
 static void print_text(struct str *);
 static void print_indent(void);
 static void print_val(size_t);
-static void print_perf(struct timeval);
+static void print_perf(struct timespec, size_t);
 static void print_mem(void);
+static void print_stats(void);
+static char *slurp(FILE *, size_t *);
+static size_t read_file(void *, char *, size_t);
+static size_t parse_warc(FILE *);
+static size_t replay(FILE *);
+static void print_error(void *, enum errors, size_t, size_t);
 
 /*
  * Optional command line flags.
@@ -60,6 +86,17 @@ static int want_flat;
 static int want_mem;
 static int want_quiet;
 static int want_perf;
+static int want_elide;
+static int want_valid;
+static int want_pipeline;
+static int want_gzip;
+static int want_warc;
+static int want_errors;
+static int want_replay;
+static int nthreads;
+static const char *skip_name;
+static const char *stop_name;
+static const char *record_path;
 
 /*
  * Optional summation of memory usage.
@@ -67,21 +104,54 @@ static int want_perf;
 static size_t cdata_mem;
 static size_t elem_mem;
 
+/*
+ * Optional performance metrics: where the parse time goes, the nodes
+ * and the calls to the allocator. The latter are not locked, so they
+ * are approximate with -t and -j.
+ */
+static struct purehtml_perf perf;
+static double callback_time;
+static size_t callbacks;
+static size_t sampled;
+static size_t nodes;
+static size_t mallocs;
+static size_t reallocs;
+static size_t frees;
+static const struct allocator counting = { count_malloc, count_realloc,
+    count_free };
+
+/*
+ * Parse errors of the WARC records parsed so far.
+ */
+static size_t warc_errors;
+
+/*
+ * The parser, for looking at its open elements stack.
+ */
+static struct purehtml purehtml;
+
+/*
+ * Decompressor for -z.
+ */
+static struct inflate inflate;
+
+/*
+ * Token log for -T and -R.
+ */
+static struct tokenlog tokenlog;
+
 int
 main(int argc, char **argv)
 {
-	static struct tokenizer tokenizer;
-	static struct dispatcher dispatcher;
-	static struct document document;
-	FILE *fp;
-	struct token *token;
-	int state;
+	FILE *fp, *record;
+	size_t len;
+	char *buf;
 	char ch;
-	struct timeval tv;
+	struct timespec start;
 
-	gettimeofday(&tv, NULL);
+	clock_gettime(CLOCK_MONOTONIC, &start);
 
-	while ((ch = getopt(argc, argv, "srfmqp")) != -1) {
+	while ((ch = getopt(argc, argv, "srfmqpwutzWERj:k:e:T:")) != -1) {
 		switch (ch) {
 		case 's':
 			want_stack = 1;
@@ -101,15 +171,60 @@ main(int argc, char **argv)
 		case 'p':
 			want_perf = 1;
 			break;
+		case 'w':
+			want_elide = 1;
+			break;
+		case 'u':
+			want_valid = 1;
+			break;
+		case 't':
+			want_pipeline = 1;
+			break;
+		case 'z':
+			want_gzip = 1;
+			break;
+		case 'W':
+			want_warc = 1;
+			break;
+		case 'E':
+			want_errors = 1;
+			break;
+		case 'R':
+			want_replay = 1;
+			break;
+		case 'T':
+			record_path = optarg;
+			break;
+		case 'j':
+			nthreads = atoi(optarg);
+			break;
+		case 'k':
+			skip_name = optarg;
+			break;
+		case 'e':
+			stop_name = optarg;
+			break;
 		default:
 			fprintf(stderr,
-			    "usage: %s [-srf] [file]\n"
+			    "usage: %s [-srfqpmwutzWER] [-j threads] [-k tag] "
+			    "[-e tag] [-T log] [file]\n"
 			    "\t-s\tprint stack\n"
 			    "\t-r\treconstruct HTML\n"
 			    "\t-f\tprint flat without indent\n"
 			    "\t-q\tquiet\n"
 			    "\t-p\tshow performance metrics\n"
-			    "\t-m\tsum memory usage\n",
+			    "\t-m\tsum memory usage\n"
+			    "\t-w\tdrop whitespace-only text\n"
+			    "\t-u\treplace invalid UTF-8\n"
+			    "\t-t\ttokenize on a separate thread\n"
+			    "\t-j\ttokenize in parallel on given threads\n"
+			    "\t-z\tinput is gzip, zlib or deflate compressed\n"
+			    "\t-W\tinput is a WARC file, dump HTML responses\n"
+			    "\t-E\tprint parse errors\n"
+			    "\t-R\tinput is a token log, replay it\n"
+			    "\t-T\trecord tokens to given log\n"
+			    "\t-k\tskip children of given tag\n"
+			    "\t-e\tstop parsing after end of given tag\n",
 			    *argv);
 			return 1;
 		}
@@ -118,41 +233,235 @@ main(int argc, char **argv)
 	argc -= optind;
 	argv += optind;
 
-	if (argc == 1) {
-		fp = fopen(*argv, "r");
-		if (fp == NULL)
-			err(1, "fopen %s", *argv);
-	} else {
-		fp = fdopen(0, "r");
-		if (fp == NULL)
-			err(1, "fdopen stdin");
-	}
-	tokenizer.fp = fp;
-
 	if (want_reconstruct)
 		printf("<!DOCTYPE html>\n");
 
-	dispatcher.document = &document;
-	while (!feof(fp)) {
-		token = tokenize(&tokenizer);
-		if (token != NULL) {
-			state = dispatch(&dispatcher, token, begin, end);
-			if (state != STATE_NONE)
-				tokenizer.state = state;
-			token_clear(token);
+	purehtml.dispatcher.elide_space = want_elide;
+	purehtml.tokenizer.input.validate = want_valid;
+	if (want_errors)
+		purehtml.report.error = print_error;
+	record = NULL;
+	if (record_path != NULL) {
+		if ((record = fopen(record_path, "w")) == NULL)
+			err(1, "fopen %s", record_path);
+		tokenlog_record(&tokenlog, record);
+		purehtml.record = &tokenlog;
+	}
+	if (want_perf) {
+		if (nthreads == 0 && !want_pipeline)
+			purehtml.perf = &perf;
+		purehtml_allocator(&counting);
+		on_begin = timed_begin;
+		on_end = timed_end;
+	}
+
+	/*
+	 * Files are mapped into memory unless we need a stream.
+	 */
+	if (argc == 1 && nthreads == 0 && !want_pipeline && !want_gzip &&
+	    !want_warc && !want_replay) {
+		len = purehtml_parse_file(&purehtml, *argv, on_begin, on_end);
+		if (len == (size_t) -1)
+			err(1, "%s", *argv);
+		fp = NULL;
+	} else {
+		if (argc == 1) {
+			fp = fopen(*argv, "r");
+			if (fp == NULL)
+				err(1, "fopen %s", *argv);
+		} else {
+			fp = fdopen(0, "r");
+			if (fp == NULL)
+				err(1, "fdopen stdin");
 		}
+
+		if (want_replay)
+			len = replay(fp);
+		else if (want_warc)
+			len = parse_warc(fp);
+		else if (want_gzip) {
+			inflate_init(&inflate, read_file, fp);
+			len = purehtml_parse_read(&purehtml, inflate_read,
+			    &inflate, on_begin, on_end);
+			if (inflate.error != NULL)
+				errx(1, "%s", inflate.error);
+		} else if (nthreads > 0) {
+			buf = slurp(fp, &len);
+			len = purehtml_parse_speculative(&purehtml, buf, len,
+			    nthreads, on_begin, on_end);
+			free(buf);
+		} else if (want_pipeline)
+			len = purehtml_parse_pipelined(&purehtml, fp,
+			    on_begin, on_end);
+		else
+			len = purehtml_parse(&purehtml, fp, on_begin, on_end);
+	}
+
+	if (record != NULL) {
+		tokenlog_free(&tokenlog);
+		if (ferror(record))
+			errx(1, "cannot write %s", record_path);
+		if (fclose(record) != 0)
+			err(1, "%s", record_path);
 	}
 
 	if (want_perf)
-		print_perf(tv);
+		print_perf(start, len);
 
 	if (want_mem)
 		print_mem();
 
-	fclose(fp);
+	if (fp != NULL)
+		fclose(fp);
 	return 0;
 }
 
+static size_t
+read_file(void *user, char *buf, size_t len)
+{
+	return fread(buf, 1, len, user);
+}
+
+/*
+ * Dump each HTML response of a WARC file, which may be compressed.
+ */
+static size_t
+parse_warc(FILE *fp)
+{
+	struct warc warc;
+	struct warc_record rec;
+	size_t len;
+	int c;
+
+	if ((c = getc(fp)) == EOF)
+		return 0;
+	ungetc(c, fp);
+
+	if (c == 0x1f) {
+		inflate_init(&inflate, read_file, fp);
+		warc_init(&warc, inflate_read, &inflate);
+	} else
+		warc_init(&warc, read_file, fp);
+
+	len = 0;
+	while (warc_next(&warc, &rec)) {
+		if (warc_is_html(&rec)) {
+			if (want_reconstruct && !want_quiet)
+				printf("<!-- %s -->\n", rec.uri ? rec.uri : "");
+			else if (!want_quiet)
+				printf("# %s\n", rec.uri ? rec.uri : "");
+
+			warc_errors += report_total(&purehtml.report);
+			purehtml_reset(&purehtml);
+			if (rec.content_type != NULL)
+				purehtml.tokenizer.input.charset =
+				    encoding_charset(rec.content_type,
+				    strlen(rec.content_type));
+			len += purehtml_parse_buf(&purehtml, rec.payload,
+			    rec.payload_len, on_begin, on_end);
+		}
+		warc_record_free(&rec);
+	}
+
+	if (inflate.error != NULL)
+		warnx("%s", inflate.error);
+	else if (warc.error != NULL)
+		warnx("%s", warc.error);
+	warc_free(&warc);
+	return len;
+}
+
+/*
+ * Dispatch the tokens of a log recorded with -T, which may be
+ * compressed. Returns the bytes the tokens covered.
+ */
+static size_t
+replay(FILE *fp)
+{
+	size_t differ;
+	int c;
+
+	if ((c = getc(fp)) == EOF)
+		return 0;
+	ungetc(c, fp);
+
+	if (c == 0x1f) {
+		inflate_init(&inflate, read_file, fp);
+		tokenlog_init(&tokenlog, inflate_read, &inflate);
+	} else
+		tokenlog_init(&tokenlog, read_file, fp);
+
+	differ = purehtml_replay(&purehtml, &tokenlog, on_begin, on_end);
+	if (inflate.error != NULL)
+		errx(1, "%s", inflate.error);
+	if (tokenlog.error != NULL)
+		errx(1, "%s", tokenlog.error);
+	if (differ > 0)
+		warnx("%zu tokens switched the tokenizer state differently",
+		    differ);
+	return tokenlog.offset;
+}
+
+static void
+print_error(void *user, enum errors code, size_t line, size_t offset)
+{
+	fprintf(stderr, "%zu:%zu: %s\n", line, offset, report_name(code));
+}
+
+/*
+ * Read all of the input into memory.
+ */
+static char *
+slurp(FILE *fp, size_t *len)
+{
+	char *buf;
+	size_t alloc, n;
+
+	buf = NULL;
+	*len = alloc = 0;
+	do {
+		if (*len == alloc) {
+			alloc = alloc ? alloc * 2 : 65536;
+			if ((buf = realloc(buf, alloc)) == NULL)
+				err(1, "realloc");
+		}
+		n = fread(&buf[*len], 1, alloc - *len, fp);
+		*len += n;
+	} while (n > 0);
+
+	return buf;
+}
+
+/*
+ * Counters of a library built with -DPUREHTML_STATS.
+ */
+static void
+print_stats(void)
+{
+	const struct purehtml_stats *stats;
+	int i;
+
+	if ((stats = purehtml_stats()) == NULL)
+		return;
+
+	for (i = 0; i < NSTATES; i++)
+		if (stats->bytes[i] > 0)
+			printf("\n\t%10zu bytes in %s", stats->bytes[i],
+			    stats_state_name(i));
+	printf("\n\t%10zu bytes reconsumed", stats->reconsumes);
+	for (i = 0; i < NIMODES; i++)
+		if (stats->tokens[i] > 0)
+			printf("\n\t%10zu tokens in %s", stats->tokens[i],
+			    stats_imode_name(i));
+	printf("\n\t%10zu scope checks, %.1f elements per check",
+	    stats->scope_checks, stats->scope_checks ?
+	    (double) stats->scope_scanned / stats->scope_checks : 0.0);
+	for (i = 0; i < NALLOCS; i++)
+		if (stats->allocs[i] > 0)
+			printf("\n\t%10zu %s allocations", stats->allocs[i],
+			    stats_alloc_name(i));
+}
+
 static void
 print_mem()
 {
@@ -183,32 +492,120 @@ print_mem()
 		printf("\n");
 }
 
+static double
+elapsed(const struct timespec *t0, const struct timespec *t1)
+{
+	return (t1->tv_sec - t0->tv_sec) + (t1->tv_nsec - t0->tv_nsec) / 1e9;
+}
+
+/*
+ * Time one callback in PERF_SAMPLE like the parser times its calls.
+ */
+static int
+timed(int (*cb)(struct node *), struct node *node)
+{
+	struct timespec t0, t1;
+	int verdict;
+
+	if (callbacks++ % PERF_SAMPLE != 0)
+		return cb(node);
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	verdict = cb(node);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	callback_time += elapsed(&t0, &t1) - perf.clock;
+	sampled++;
+	return verdict;
+}
+
+static int
+timed_begin(struct node *node)
+{
+	nodes++;
+	return timed(begin, node);
+}
+
+static int
+timed_end(struct node *node)
+{
+	return timed(end, node);
+}
+
+static void *
+count_malloc(size_t size)
+{
+	mallocs++;
+	return malloc(size);
+}
+
+static void *
+count_realloc(void *ptr, size_t size)
+{
+	reallocs++;
+	return realloc(ptr, size);
+}
+
 static void
-print_perf(struct timeval tv)
+count_free(void *ptr)
+{
+	frees++;
+	free(ptr);
+}
+
+static void
+print_perf(struct timespec start, size_t len)
 {
 	struct rusage ru;
-	struct timeval tvend;
+	struct timespec now;
+	double cb;
 	int real, total, system;
 
 	getrusage(RUSAGE_SELF, &ru);
-	gettimeofday(&tvend, NULL);
+	clock_gettime(CLOCK_MONOTONIC, &now);
 
 	if (want_reconstruct)
 		printf("<!--\n ");
 
-	real = (int) (((tvend.tv_sec * 1000000 + tvend.tv_usec) -
-	    (tv.tv_sec * 1000000 + tv.tv_usec)) / 1000);
+	real = (int) (elapsed(&start, &now) * 1000);
 	total = (int) (
 	    ((ru.ru_utime.tv_sec * 1000000) + (ru.ru_stime.tv_sec * 1000000) +
 	    ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1000);
-	system = (int) ((ru.ru_stime.tv_sec * 1000000) +
-	    (ru.ru_stime.tv_usec) / 1000);
-
-	printf("rutime\t%6d ms\n\t%6d ms system",
-	    total, system);
+	system = (int) (((ru.ru_stime.tv_sec * 1000000) +
+	    ru.ru_stime.tv_usec) / 1000);
+
+	/*
+	 * The callbacks are sampled like the parser, scale them up the
+	 * same way.
+	 */
+	cb = sampled > 0 ? callback_time * callbacks / sampled : 0.0;
+	if (cb < 0.0)
+		cb = 0.0;
+
+	printf("rutime\t%6d ms\n\t%6d ms system", total, system);
 	printf("\n\t%6d ms unaccounted latencies",
-	    (real - (total+system)) > 0 ?
-	    (real - (total+system)) : 0);
+	    (real - total) > 0 ? (real - total) : 0);
+
+	/*
+	 * Only the serial parsers split their time.
+	 */
+	if (perf.tokens > 0) {
+		printf("\n\t%6d ms tokenizer", (int) (perf.tokenize * 1000));
+		printf("\n\t%6d ms dispatcher", perf.dispatch > cb ?
+		    (int) ((perf.dispatch - cb) * 1000) : 0);
+	}
+	printf("\n\t%6d ms callbacks", (int) (cb * 1000));
+	printf("\n\t%6zu bytes consumed", len);
+	printf("\n\t%6.1f MB/s", real > 0 ? len / 1e3 / real : 0.0);
+	if (perf.tokens > 0) {
+		printf("\n\t%6zu tokens", perf.tokens);
+		printf("\n\t%6zu peak depth", perf.max_depth);
+	}
+	printf("\n\t%6zu nodes", nodes);
+	printf("\n\t%6zu mallocs\n\t%6zu reallocs\n\t%6zu frees",
+	    mallocs, reallocs, frees);
+	printf("\n\t%6zu parse errors",
+	    warc_errors + report_total(&purehtml.report));
+	print_stats();
 
 	if (want_reconstruct)
 		printf(" -->\n");
@@ -227,12 +624,13 @@ print_stack()
 	if (want_reconstruct)
 		printf("<!-- ");
 
-	sz = ostack_depth();
+	sz = ostack_depth(&purehtml.dispatcher.ostack);
 	for (i = sz; i >= 1; i--) {
 		if (i != sz)
 			printf(".");
 
-		printf("%s", ostack_peek_at(i)->name);
+		printf("%s",
+		    ostack_peek_at(&purehtml.dispatcher.ostack, i)->name);
 	}
 
 	if (want_reconstruct)
@@ -270,14 +668,17 @@ print_indent()
 {
 	size_t i;
 
-	for (i = ostack_depth(); i >= 1; i--)
+	for (i = ostack_depth(&purehtml.dispatcher.ostack); i >= 1; i--)
 		putchar(' ');
 }
 
-static void
+static int
 begin(struct node *node)
 {
 	char *p;
+	int verdict;
+
+	verdict = CB_CONTINUE;
 
 	if (!want_flat && !want_quiet)
 		print_indent();
@@ -304,6 +705,10 @@ begin(struct node *node)
 
 		if (want_mem)
 			elem_mem += node_size(node);
+
+		if (skip_name != NULL &&
+		    strcmp(node->u.elem->name, skip_name) == 0)
+			verdict = CB_SKIP;
 		break;
 	case NODE_CDATA:
 		if (!want_quiet)
@@ -326,14 +731,22 @@ begin(struct node *node)
 #if 0
 	node_free(node);
 #endif
+	return verdict;
 }
 
-static void
+static int
 end(struct node *node)
 {
+	int verdict;
+
+	verdict = CB_CONTINUE;
+	if (stop_name != NULL && node->type == NODE_ELEM &&
+	    strcmp(node->u.elem->name, stop_name) == 0)
+		verdict = CB_STOP;
+
 	if (!want_reconstruct && node->type == NODE_ELEM) {
 		node_free(node);
-		return;
+		return verdict;
 	}
 
 	if (!want_flat && !want_quiet)
@@ -361,6 +774,7 @@ end(struct node *node)
 		putchar('\n');
 
 	node_free(node);
+	return verdict;
 }
 
 static void
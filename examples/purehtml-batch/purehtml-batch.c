@@ -0,0 +1,416 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <err.h>
+#include <errno.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <dirent.h>
+#include <time.h>
+
+#include <sys/stat.h>
+
+#include <purehtml/purehtml.h>
+#include <purehtml/batch.h>
+#include <purehtml/node.h>
+#include <purehtml/inflate.h>
+#include <purehtml/warc.h>
+
+/*
+ * Parses many documents in parallel and prints a line per document,
+ * or with -b measures the throughput with 1, 2, 4, ... threads.
+ */
+struct result {
+	size_t	 elems;
+	size_t	 texts;
+};
+
+static int begin(struct node *);
+static int end(struct node *);
+static void done(struct purehtml_doc *);
+
+static void add_path(const char *);
+static void add_dir(const char *);
+static struct purehtml_doc *new_doc(void);
+static void run_warc(const char *);
+static size_t read_file(void *, char *, size_t);
+static void load(void);
+static double now(void);
+static double run(int);
+
+/*
+ * Optional command line flags.
+ */
+static int want_quiet;
+static int want_bench;
+static int want_warc;
+static int nthreads;
+
+static struct purehtml_doc *docs;
+static struct result *results;
+static size_t ndocs;
+static size_t docs_alloc;
+static size_t total;
+
+/*
+ * Records of the WARC file being parsed with -W.
+ */
+#define WARC_GROUP 1024
+static struct warc_record *recs;
+static struct inflate inflate;
+
+int
+main(int argc, char **argv)
+{
+	char *line;
+	size_t sz;
+	ssize_t len;
+	double secs;
+	int ch, n;
+
+	while ((ch = getopt(argc, argv, "qbWj:")) != -1) {
+		switch (ch) {
+		case 'q':
+			want_quiet = 1;
+			break;
+		case 'b':
+			want_bench = 1;
+			break;
+		case 'W':
+			want_warc = 1;
+			break;
+		case 'j':
+			nthreads = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr,
+			    "usage: %s [-qbW] [-j threads] [file|dir ...]\n"
+			    "\t-q\tquiet, print only the summary\n"
+			    "\t-b\tbenchmark with 1, 2, 4, ... threads\n"
+			    "\t-W\tfiles are WARC, parse HTML responses\n"
+			    "\t-j\tnumber of threads (default: CPUs)\n"
+			    "Reads the file names from stdin if none given.\n",
+			    *argv);
+			return 1;
+		}
+	}
+
+	argc -= optind;
+	argv += optind;
+
+	if (nthreads <= 0)
+		nthreads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (nthreads <= 0)
+		nthreads = 1;
+
+	if (want_warc) {
+		if (argc == 0)
+			run_warc(NULL);
+		while (argc-- > 0)
+			run_warc(*argv++);
+		return 0;
+	}
+
+	if (argc == 0) {
+		line = NULL;
+		sz = 0;
+		while ((len = getline(&line, &sz, stdin)) > 0) {
+			if (line[len - 1] == '\n')
+				line[len - 1] = '\0';
+			if (*line != '\0')
+				add_path(line);
+		}
+		free(line);
+	}
+	while (argc-- > 0)
+		add_path(*argv++);
+
+	if (!want_bench) {
+		secs = run(nthreads);
+		fprintf(stderr, "%zu documents, %zu bytes, %.3f s, "
+		    "%.1f docs/s, %.2f MB/s\n", ndocs, total, secs,
+		    ndocs / secs, total / secs / 1e6);
+		return 0;
+	}
+
+	/*
+	 * Read the corpus into memory first so that the numbers tell
+	 * about the parser instead of the disk.
+	 */
+	load();
+	want_quiet = 1;
+	printf("threads\tdocs/s\tMB/s\n");
+	for (n = 1; ; n *= 2) {
+		if (n > nthreads)
+			n = nthreads;
+		secs = run(n);
+		printf("%d\t%.1f\t%.2f\n", n, ndocs / secs,
+		    total / secs / 1e6);
+		if (n == nthreads)
+			break;
+	}
+
+	return 0;
+}
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double
+run(int n)
+{
+	struct purehtml_batch batch = { 0 };
+	double start;
+	size_t i;
+
+	batch.nthreads = n;
+	batch.begin = begin;
+	batch.end = end;
+	batch.done = done;
+
+	for (i = 0; i < ndocs; i++)
+		docs[i].user = &results[i];
+	memset(results, 0, ndocs * sizeof(struct result));
+
+	start = now();
+	total = purehtml_batch(&batch, docs, ndocs);
+	return now() - start;
+}
+
+static int
+begin(struct node *node)
+{
+	struct result *result;
+
+	result = purehtml_batch_doc()->user;
+	if (node->type == NODE_ELEM)
+		result->elems++;
+	else
+		result->texts++;
+	return CB_CONTINUE;
+}
+
+static int
+end(struct node *node)
+{
+	return CB_CONTINUE;
+}
+
+static void
+done(struct purehtml_doc *doc)
+{
+	struct result *result;
+
+	if (doc->error != 0) {
+		errno = doc->error;
+		warn("%s", doc->path);
+		return;
+	}
+
+	result = doc->user;
+	if (!want_quiet)
+		printf("%s\t%zu bytes\t%zu elements\t%zu texts\n",
+		    doc->path ? doc->path : recs[doc - docs].uri,
+		    doc->consumed, result->elems, result->texts);
+}
+
+static void
+add_path(const char *path)
+{
+	struct stat sb;
+
+	if (stat(path, &sb) == -1) {
+		warn("%s", path);
+		return;
+	}
+
+	if (S_ISDIR(sb.st_mode)) {
+		add_dir(path);
+		return;
+	} else if (!S_ISREG(sb.st_mode))
+		return;
+
+	if ((new_doc()->path = strdup(path)) == NULL)
+		err(1, "strdup");
+}
+
+static struct purehtml_doc *
+new_doc(void)
+{
+	if (ndocs == docs_alloc) {
+		docs_alloc = docs_alloc ? docs_alloc * 2 : 64;
+		docs = realloc(docs, docs_alloc * sizeof(struct purehtml_doc));
+		results = realloc(results, docs_alloc * sizeof(struct result));
+		if (docs == NULL || results == NULL)
+			err(1, "realloc docs");
+	}
+
+	memset(&docs[ndocs], 0, sizeof(struct purehtml_doc));
+	return &docs[ndocs++];
+}
+
+static size_t
+read_file(void *user, char *buf, size_t len)
+{
+	return fread(buf, 1, len, user);
+}
+
+/*
+ * Parse the HTML responses of a WARC file, which may be compressed, in
+ * parallel a group of records at a time.
+ */
+static void
+run_warc(const char *path)
+{
+	struct warc warc;
+	size_t i, n, bytes;
+	double secs;
+	FILE *fp;
+	int c, more;
+
+	if (path == NULL)
+		fp = stdin;
+	else if ((fp = fopen(path, "r")) == NULL) {
+		warn("%s", path);
+		return;
+	}
+
+	if ((c = getc(fp)) != EOF)
+		ungetc(c, fp);
+	if (c == 0x1f) {
+		inflate_init(&inflate, read_file, fp);
+		warc_init(&warc, inflate_read, &inflate);
+	} else
+		warc_init(&warc, read_file, fp);
+
+	if (recs == NULL &&
+	    (recs = calloc(WARC_GROUP, sizeof(struct warc_record))) == NULL)
+		err(1, "calloc records");
+
+	n = bytes = 0;
+	secs = 0.0;
+	more = 1;
+	while (more) {
+		ndocs = 0;
+		while (ndocs < WARC_GROUP &&
+		    (more = warc_next(&warc, &recs[ndocs])) != 0) {
+			if (!warc_is_html(&recs[ndocs])) {
+				warc_record_free(&recs[ndocs]);
+				continue;
+			}
+			new_doc();
+			docs[ndocs - 1].buf = recs[ndocs - 1].payload;
+			docs[ndocs - 1].len = recs[ndocs - 1].payload_len;
+			if (recs[ndocs - 1].content_type != NULL)
+				docs[ndocs - 1].charset = encoding_charset(
+				    recs[ndocs - 1].content_type,
+				    strlen(recs[ndocs - 1].content_type));
+		}
+
+		if (ndocs > 0) {
+			secs += run(nthreads);
+			bytes += total;
+			n += ndocs;
+		}
+		for (i = 0; i < ndocs; i++)
+			warc_record_free(&recs[i]);
+	}
+
+	if (inflate.error != NULL)
+		warnx("%s: %s", path ? path : "stdin", inflate.error);
+	else if (warc.error != NULL)
+		warnx("%s: %s", path ? path : "stdin", warc.error);
+	warc_free(&warc);
+	if (fp != stdin)
+		fclose(fp);
+
+	fprintf(stderr, "%s: %zu documents, %zu bytes, %.3f s, "
+	    "%.1f docs/s, %.2f MB/s\n", path ? path : "stdin", n, bytes,
+	    secs, n / secs, bytes / secs / 1e6);
+}
+
+static void
+add_dir(const char *path)
+{
+	DIR *dir;
+	struct dirent *dirent;
+	char *name;
+	size_t len;
+
+	if ((dir = opendir(path)) == NULL) {
+		warn("%s", path);
+		return;
+	}
+
+	while ((dirent = readdir(dir)) != NULL) {
+		if (*dirent->d_name == '.')
+			continue;
+		len = strlen(path) + strlen(dirent->d_name) + 2;
+		if ((name = malloc(len)) == NULL)
+			err(1, "malloc");
+		snprintf(name, len, "%s/%s", path, dirent->d_name);
+		add_path(name);
+		free(name);
+	}
+
+	closedir(dir);
+}
+
+/*
+ * Turn the files into in-memory buffers.
+ */
+static void
+load(void)
+{
+	FILE *fp;
+	char *buf;
+	size_t i, len, alloc, n;
+
+	for (i = 0; i < ndocs; i++) {
+		if ((fp = fopen(docs[i].path, "r")) == NULL) {
+			warn("%s", docs[i].path);
+			continue;
+		}
+
+		buf = NULL;
+		len = alloc = 0;
+		do {
+			if (len == alloc) {
+				alloc = alloc ? alloc * 2 : 65536;
+				if ((buf = realloc(buf, alloc)) == NULL)
+					err(1, "realloc %s", docs[i].path);
+			}
+			n = fread(&buf[len], 1, alloc - len, fp);
+			len += n;
+		} while (n > 0);
+		fclose(fp);
+
+		docs[i].buf = buf;
+		docs[i].len = len;
+		free((char *) docs[i].path);
+		docs[i].path = NULL;
+	}
+}
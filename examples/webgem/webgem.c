@@ -24,6 +24,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <purehtml/purehtml.h>
 #include <purehtml/tokenize.h>
 #include <purehtml/dispatch.h>
 #include <purehtml/ostack.h>
@@ -63,9 +64,14 @@ struct block {
 static struct block *current_block;
 
 /*
- * Linked list of links.
+ * Linked list of links, newest first, and a hash set of them by URL.
+ * The links from link_flushed on have been dumped already.
  */
 static struct link *link_head;
+static struct link *link_flushed;
+static struct link **link_set;
+static size_t link_set_alloc;	/* power of two */
+static size_t nlinks;
 
 /*
  * Current link text that we are constructing.
@@ -95,8 +101,8 @@ static int have_lf;
  * We convert to 'text/gemini' as we get it.
  * The magic happens here.
  */
-static void begin(struct node *);
-static void end(struct node *);
+static int begin(struct node *);
+static int end(struct node *);
 
 /*
  * Print content properly according to HTML inline rendering context
@@ -108,7 +114,8 @@ static void print_line(const char *, size_t, char);
 /*
  * Support for storing links.
  */
-static int has_link(const char *);
+static struct link **link_slot(const char *);
+static void grow_links(void);
 static void add_link(struct block *, const char *, const char *, int);
 
 /*
@@ -148,44 +155,33 @@ static void end_br(void);
 static void end_img(struct elem *);
 static void end_a(struct elem *);
 
+/*
+ * The parser, for looking at its open elements stack.
+ */
+static struct purehtml purehtml;
+
 int
 main(int argc, char **argv)
 {
-	static struct tokenizer tokenizer;
-	static struct dispatcher dispatcher;
-	static struct document document;
 	FILE *fp;
-	struct token *token;
-	int state;
 
 	if (argc == 2) {
-		fp = fopen(argv[1], "r");
-		if (fp == NULL)
-			err(1, "fopen %s", argv[1]);
+		if (purehtml_parse_file(&purehtml, argv[1], begin, end) ==
+		    (size_t) -1)
+			err(1, "%s", argv[1]);
 	} else {
 		fp = fdopen(0, "r");
 		if (fp == NULL)
 			err(1, "fdopen stdin");
-	}
-	tokenizer.fp = fp;
-
-	dispatcher.document = &document;
-	while (!feof(fp)) {
-		token = tokenize(&tokenizer);
-		if (token != NULL) {
-			state = dispatch(&dispatcher, token, begin, end);
-			if (state != STATE_NONE)
-				tokenizer.state = state;
-			token_clear(token);
-		}
+		purehtml_parse(&purehtml, fp, begin, end);
+		fclose(fp);
 	}
 
 	free_links();
-	fclose(fp);
 	return 0;
 }
 
-static void
+static int
 begin(struct node *node)
 {
 	switch (node->type) {
@@ -213,9 +209,11 @@ begin(struct node *node)
 	default:
 		break;
 	}
+
+	return CB_CONTINUE;
 }
 
-static void
+static int
 end(struct node *node)
 {
 	switch (node->type) {
@@ -247,6 +245,7 @@ end(struct node *node)
 	}
 
 	node_free(node);
+	return CB_CONTINUE;
 }
 
 static int
@@ -254,44 +253,68 @@ is_child_of(int tagid)
 {
 	struct elem *elem;
 
-	elem = ostack_peek();
+	elem = ostack_peek(&purehtml.dispatcher.ostack);
 	if (elem == NULL)
 		return 0;
 
 	if (elem->tagid == tagid)
 		return 1;
 
-	while ((elem = ostack_prev(elem)) != NULL)
+	while ((elem = ostack_prev(&purehtml.dispatcher.ostack, elem)) != NULL)
 		if (elem->tagid == tagid)
 			return 1;
 
 	return 0;
 }
 
-static int
-has_link(const char *url)
+/*
+ * Slot of the given URL in the set, or the empty slot where it would go.
+ */
+static struct link **
+link_slot(const char *url)
 {
-	struct link *link;
+	const char *p;
+	size_t h;
 
-	link = link_head;
-	while (link != NULL) {
-		if (link->url != NULL && strcmp(link->url, url) == 0)
-			return 1;
-		link = link->next;
+	h = 2166136261u;
+	for (p = url; *p != '\0'; p++) {
+		h ^= (unsigned char) *p;
+		h *= 16777619u;
 	}
 
-	return 0;
+	h &= link_set_alloc - 1;
+	while (link_set[h] != NULL && strcmp(link_set[h]->url, url) != 0)
+		h = (h + 1) & (link_set_alloc - 1);
+	return &link_set[h];
 }
 
 static void
-add_link(struct block *block, const char *url, const char *desc, int is_img)
+grow_links(void)
 {
 	struct link *link;
 
+	free(link_set);
+	link_set_alloc = link_set_alloc ? link_set_alloc * 2 : 64;
+	link_set = calloc(link_set_alloc, sizeof(struct link *));
+	if (link_set == NULL)
+		err(1, "calloc link set");
+
+	for (link = link_head; link != NULL; link = link->next)
+		*link_slot(link->url) = link;
+}
+
+static void
+add_link(struct block *block, const char *url, const char *desc, int is_img)
+{
+	struct link *link, **slot;
+
 	if (url == NULL || *url == '\0' || *url == '#')
 		return;
 
-	if (has_link(url))
+	if (nlinks * 2 >= link_set_alloc)
+		grow_links();
+	slot = link_slot(url);
+	if (*slot != NULL)
 		return;
 
 	link = calloc(1, sizeof(struct link));
@@ -315,6 +338,8 @@ add_link(struct block *block, const char *url, const char *desc, int is_img)
 
 	link->next = link_head;
 	link_head = link;
+	*slot = link;
+	nlinks++;
 }
 
 /*
@@ -440,6 +465,7 @@ free_links()
 			free(tmp->desc);
 		free(tmp);
 	}	
+	free(link_set);
 }
 
 static int
@@ -449,8 +475,7 @@ flush_links(struct block *block)
 	size_t i;
 
 	i = 0;
-	link = link_head;
-	for (link = link_head; link != NULL; link = link->next) {
+	for (link = link_head; link != link_flushed; link = link->next) {
 		if (link->block == NULL)
 			continue;
 
@@ -463,6 +488,7 @@ flush_links(struct block *block)
 		printf("\n");
 		i++;
 	}
+	link_flushed = link_head;
 	have_links = 0;
 
 	return i;
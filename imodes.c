@@ -0,0 +1,26 @@
+/* generated by enum.awk */
+static const char *imodes[] = {
+	"INITIAL",
+	"BEFORE_HTML",
+	"BEFORE_HEAD",
+	"IN_HEAD",
+	"IN_HEAD_NOSCRIPT",
+	"AFTER_HEAD",
+	"IN_BODY",
+	"TEXT",
+	"IN_TABLE",
+	"IN_TABLE_TEXT",
+	"IN_ROW",
+	"IN_CELL",
+	"IN_CAPTION",
+	"IN_COLUMN_GROUP",
+	"IN_TABLE_BODY",
+	"IN_SELECT",
+	"IN_SELECT_IN_TABLE",
+	"IN_TEMPLATE",
+	"AFTER_BODY",
+	"IN_FRAMESET",
+	"AFTER_FRAMESET",
+	"AFTER_AFTER_BODY",
+	"AFTER_AFTER_FRAMESET",
+};
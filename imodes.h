@@ -0,0 +1,30 @@
+/* generated by enum.awk */
+#ifndef IMODES_H
+#define IMODES_H
+enum imodes {
+	IMODE_INITIAL,
+	IMODE_BEFORE_HTML,
+	IMODE_BEFORE_HEAD,
+	IMODE_IN_HEAD,
+	IMODE_IN_HEAD_NOSCRIPT,
+	IMODE_AFTER_HEAD,
+	IMODE_IN_BODY,
+	IMODE_TEXT,
+	IMODE_IN_TABLE,
+	IMODE_IN_TABLE_TEXT,
+	IMODE_IN_ROW,
+	IMODE_IN_CELL,
+	IMODE_IN_CAPTION,
+	IMODE_IN_COLUMN_GROUP,
+	IMODE_IN_TABLE_BODY,
+	IMODE_IN_SELECT,
+	IMODE_IN_SELECT_IN_TABLE,
+	IMODE_IN_TEMPLATE,
+	IMODE_AFTER_BODY,
+	IMODE_IN_FRAMESET,
+	IMODE_AFTER_FRAMESET,
+	IMODE_AFTER_AFTER_BODY,
+	IMODE_AFTER_AFTER_FRAMESET,
+	NIMODES
+};
+#endif
@@ -0,0 +1,849 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "inflate.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define WINDOW_MASK (INFLATE_WINDOW - 1)
+
+enum {
+	ST_HEADER = 0,
+	ST_BLOCK,
+	ST_STORED,
+	ST_HUFF,
+	ST_TRAILER,
+	ST_DONE
+};
+
+static const unsigned short lbase[29] = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const unsigned char lext[29] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+	3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const unsigned short dbase[30] = {
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+	8193, 12289, 16385, 24577 };
+static const unsigned char dext[30] = {
+	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+	7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+static void	fail(struct inflate *, const char *);
+static int	next_byte(struct inflate *);
+static void	need(struct inflate *, int);
+static void	drop(struct inflate *, int);
+static unsigned long getbits(struct inflate *, int);
+static int	build(struct huff *, const unsigned char *, int);
+static int	decode(struct inflate *, struct huff *);
+static void	put(struct inflate *, unsigned char);
+static void	header(struct inflate *);
+static void	block(struct inflate *);
+static void	fixed(struct inflate *);
+static void	dynamic(struct inflate *);
+static void	match(struct inflate *, int);
+static void	trailer(struct inflate *);
+
+void
+inflate_init(struct inflate *z, size_t (*read)(void *, char *, size_t),
+    void *user)
+{
+	unsigned long c;
+	int i, k;
+
+	assert(read != NULL);
+
+	memset(z, 0, sizeof(struct inflate));
+	z->read = read;
+	z->user = user;
+
+	for (i = 0; i < 256; i++) {
+		c = i;
+		for (k = 0; k < 8; k++)
+			c = (c & 1) ? 0xedb88320UL ^ (c >> 1) : c >> 1;
+		z->crc_table[i] = c;
+	}
+}
+
+/*
+ * Fill buf with up to len decompressed bytes. Returns 0 at the end of
+ * the data or on an error, which is then set in z->error.
+ */
+size_t
+inflate_read(void *user, char *buf, size_t len)
+{
+	struct inflate *z = user;
+	unsigned char c;
+	size_t n;
+	int sym;
+
+	n = 0;
+	while (n < len) {
+		if (z->copy > 0) {
+			for (; z->copy > 0 && n < len; z->copy--) {
+				c = z->window[(z->total - z->dist) &
+				    WINDOW_MASK];
+				put(z, c);
+				buf[n++] = c;
+			}
+			continue;
+		}
+
+		switch (z->state) {
+		case ST_HEADER:
+			header(z);
+			break;
+		case ST_BLOCK:
+			block(z);
+			break;
+		case ST_STORED:
+			if (z->stored == 0) {
+				z->state = ST_BLOCK;
+				break;
+			}
+			c = getbits(z, 8);
+			put(z, c);
+			buf[n++] = c;
+			z->stored--;
+			break;
+		case ST_HUFF:
+			/*
+			 * Literals are the common case, so stay here.
+			 */
+			while (n < len && z->state == ST_HUFF) {
+				sym = decode(z, &z->lens);
+				if (sym < 256 && sym >= 0) {
+					put(z, sym);
+					buf[n++] = sym;
+				} else if (sym == 256)
+					z->state = ST_BLOCK;
+				else if (sym > 256) {
+					match(z, sym);
+					break;
+				}
+			}
+			break;
+		case ST_TRAILER:
+			trailer(z);
+			break;
+		case ST_DONE:
+			return n;
+		}
+	}
+
+	return n;
+}
+
+static void
+fail(struct inflate *z, const char *error)
+{
+	if (z->error == NULL)
+		z->error = error;
+	z->state = ST_DONE;
+	z->copy = 0;
+}
+
+static int
+next_byte(struct inflate *z)
+{
+	size_t n;
+
+	if (z->in_pos == z->in_len) {
+		if (z->in_eof)
+			return EOF;
+		n = z->read(z->user, (char *) z->in, sizeof(z->in));
+		if (n == 0) {
+			z->in_eof = 1;
+			return EOF;
+		}
+		z->in_len = n;
+		z->in_pos = 0;
+	}
+
+	return z->in[z->in_pos++];
+}
+
+/*
+ * Have at least n <= 24 bits in the bit buffer. Past the end of the
+ * input, pad with zero bits, which are an error only if consumed.
+ */
+static void
+need(struct inflate *z, int n)
+{
+	int c;
+
+	while (z->nbits < n) {
+		if ((c = next_byte(z)) == EOF) {
+			c = 0;
+			z->pad += 8;
+		}
+		z->bits |= (unsigned long) c << z->nbits;
+		z->nbits += 8;
+	}
+}
+
+static void
+drop(struct inflate *z, int n)
+{
+	z->bits >>= n;
+	z->nbits -= n;
+	if (z->nbits < z->pad) {
+		z->pad = z->nbits;
+		fail(z, "unexpected end of data");
+	}
+}
+
+static unsigned long
+getbits(struct inflate *z, int n)
+{
+	unsigned long v;
+
+	need(z, n);
+	v = z->bits & ((1UL << n) - 1);
+	drop(z, n);
+	return v;
+}
+
+static void
+put(struct inflate *z, unsigned char c)
+{
+	z->window[z->total++ & WINDOW_MASK] = c;
+	z->size++;
+
+	if (z->format == INFLATE_GZIP)
+		z->check = z->crc_table[(z->check ^ c) & 0xff] ^
+		    (z->check >> 8);
+	else if (z->format == INFLATE_ZLIB) {
+		/*
+		 * Adler-32, low half a and high half b.
+		 */
+		unsigned long a = z->check & 0xffff, b = z->check >> 16;
+
+		if ((a += c) >= 65521)
+			a -= 65521;
+		if ((b += a) >= 65521)
+			b -= 65521;
+		z->check = (b << 16) | a;
+	}
+}
+
+/*
+ * Make the canonical Huffman code of the given code lengths. Returns
+ * a negative value if over-subscribed, positive if incomplete.
+ */
+static int
+build(struct huff *h, const unsigned char *lengths, int n)
+{
+	unsigned short offs[16];
+	unsigned int code, rev, k;
+	int len, sym, left, i, index;
+
+	memset(h->count, 0, sizeof(h->count));
+	for (sym = 0; sym < n; sym++)
+		h->count[lengths[sym]]++;
+	if (h->count[0] == n) {
+		memset(h->fast, 0, sizeof(h->fast));
+		return 0;
+	}
+
+	left = 1;
+	for (len = 1; len < 16; len++) {
+		left <<= 1;
+		left -= h->count[len];
+		if (left < 0)
+			return left;
+	}
+
+	offs[1] = 0;
+	for (len = 1; len < 15; len++)
+		offs[len + 1] = offs[len] + h->count[len];
+	for (sym = 0; sym < n; sym++)
+		if (lengths[sym] != 0)
+			h->symbol[offs[lengths[sym]]++] = sym;
+
+	/*
+	 * Codes short enough are looked up directly with the next
+	 * INFLATE_FAST bits. The bits come least significant first, so
+	 * the codes are reversed.
+	 */
+	memset(h->fast, 0, sizeof(h->fast));
+	code = 0;
+	index = 0;
+	for (len = 1; len <= INFLATE_FAST; len++) {
+		for (i = 0; i < h->count[len]; i++) {
+			rev = 0;
+			for (k = 0; k < (unsigned int) len; k++)
+				rev |= ((code >> k) & 1) << (len - 1 - k);
+			for (k = rev; k < (1U << INFLATE_FAST); k += 1U << len)
+				h->fast[k] = (h->symbol[index] << 4) | len;
+			index++;
+			code++;
+		}
+		code <<= 1;
+	}
+
+	return left;
+}
+
+static int
+decode(struct inflate *z, struct huff *h)
+{
+	int code, first, count, index, len, e;
+
+	need(z, INFLATE_FAST);
+	e = h->fast[z->bits & ((1 << INFLATE_FAST) - 1)];
+	if (e != 0) {
+		drop(z, e & 15);
+		return e >> 4;
+	}
+
+	need(z, 15);
+	code = first = index = 0;
+	for (len = 1; len < 16; len++) {
+		code |= (z->bits >> (len - 1)) & 1;
+		count = h->count[len];
+		if (code - count < first) {
+			drop(z, len);
+			return h->symbol[index + (code - first)];
+		}
+		index += count;
+		first += count;
+		first <<= 1;
+		code <<= 1;
+	}
+
+	fail(z, "invalid code");
+	return -1;
+}
+
+static void
+header(struct inflate *z)
+{
+	unsigned long b0, b1, flags, n;
+
+	if (z->format == INFLATE_RAW) {
+		z->state = ST_BLOCK;
+		return;
+	}
+
+	b0 = getbits(z, 8);
+	b1 = getbits(z, 8);
+	if (z->format == INFLATE_GZIP &&
+	    (z->error != NULL || b0 != 0x1f || b1 != 0x8b)) {
+		/*
+		 * Something else than a member after the last one.
+		 */
+		z->error = NULL;
+		z->state = ST_DONE;
+		return;
+	}
+	if (z->error != NULL)
+		return;
+
+	if (b0 == 0x1f && b1 == 0x8b) {
+		if (getbits(z, 8) != 8) {
+			fail(z, "unknown compression method");
+			return;
+		}
+		flags = getbits(z, 8);
+		for (n = 0; n < 6; n++)		/* mtime, xfl, os */
+			getbits(z, 8);
+		if (flags & 4)
+			for (n = getbits(z, 16); n > 0 && !z->error; n--)
+				getbits(z, 8);
+		if (flags & 8)
+			while (getbits(z, 8) != 0 && !z->error)
+				;
+		if (flags & 16)
+			while (getbits(z, 8) != 0 && !z->error)
+				;
+		if (flags & 2)
+			getbits(z, 16);
+		z->format = INFLATE_GZIP;
+		z->check = 0xffffffffUL;
+	} else if ((b0 & 0x0f) == 8 && ((b0 << 8) | b1) % 31 == 0) {
+		if (b1 & 0x20) {
+			fail(z, "preset dictionary");
+			return;
+		}
+		z->format = INFLATE_ZLIB;
+		z->check = 1;
+	} else {
+		z->bits = (z->bits << 16) | (b1 << 8) | b0;
+		z->nbits += 16;
+		z->format = INFLATE_RAW;
+	}
+
+	z->last = 0;
+	z->size = 0;
+	if (z->error == NULL)
+		z->state = ST_BLOCK;
+}
+
+static void
+block(struct inflate *z)
+{
+	unsigned long len;
+
+	if (z->last) {
+		z->state = ST_TRAILER;
+		return;
+	}
+
+	z->last = getbits(z, 1);
+	switch (getbits(z, 2)) {
+	case 0:
+		drop(z, z->nbits % 8);
+		len = getbits(z, 16);
+		if ((getbits(z, 16) ^ 0xffff) != len) {
+			fail(z, "bad stored block length");
+			return;
+		}
+		z->stored = len;
+		z->state = ST_STORED;
+		break;
+	case 1:
+		fixed(z);
+		break;
+	case 2:
+		dynamic(z);
+		break;
+	default:
+		fail(z, "bad block type");
+		break;
+	}
+}
+
+static void
+fixed(struct inflate *z)
+{
+	unsigned char lengths[288];
+	int i;
+
+	for (i = 0; i < 144; i++)
+		lengths[i] = 8;
+	for (; i < 256; i++)
+		lengths[i] = 9;
+	for (; i < 280; i++)
+		lengths[i] = 7;
+	for (; i < 288; i++)
+		lengths[i] = 8;
+	build(&z->lens, lengths, 288);
+
+	for (i = 0; i < 30; i++)
+		lengths[i] = 5;
+	build(&z->dists, lengths, 30);
+
+	z->state = ST_HUFF;
+}
+
+static void
+dynamic(struct inflate *z)
+{
+	static const unsigned char order[19] = {
+	    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+	unsigned char lengths[320];
+	int nlen, ndist, ncode, i, sym, len, rep, err;
+
+	nlen = getbits(z, 5) + 257;
+	ndist = getbits(z, 5) + 1;
+	ncode = getbits(z, 4) + 4;
+	if (nlen > 286 || ndist > 30) {
+		fail(z, "bad counts");
+		return;
+	}
+
+	memset(lengths, 0, sizeof(lengths));
+	for (i = 0; i < ncode; i++)
+		lengths[order[i]] = getbits(z, 3);
+	if (build(&z->lens, lengths, 19) != 0) {
+		fail(z, "bad code lengths code");
+		return;
+	}
+
+	for (i = 0; i < nlen + ndist && z->error == NULL; ) {
+		sym = decode(z, &z->lens);
+		if (sym < 0)
+			return;
+		if (sym < 16) {
+			lengths[i++] = sym;
+			continue;
+		}
+
+		len = 0;
+		if (sym == 16) {
+			if (i == 0) {
+				fail(z, "repeat with no first length");
+				return;
+			}
+			len = lengths[i - 1];
+			rep = 3 + getbits(z, 2);
+		} else if (sym == 17)
+			rep = 3 + getbits(z, 3);
+		else
+			rep = 11 + getbits(z, 7);
+		if (i + rep > nlen + ndist) {
+			fail(z, "too many lengths");
+			return;
+		}
+		while (rep-- > 0)
+			lengths[i++] = len;
+	}
+	if (z->error != NULL)
+		return;
+
+	if (lengths[256] == 0) {
+		fail(z, "no end-of-block code");
+		return;
+	}
+
+	/*
+	 * Incomplete codes are fine only if they have a single code.
+	 */
+	err = build(&z->lens, lengths, nlen);
+	if (err < 0 || (err > 0 && nlen - z->lens.count[0] != 1)) {
+		fail(z, "bad literal/length code");
+		return;
+	}
+	err = build(&z->dists, &lengths[nlen], ndist);
+	if (err < 0 || (err > 0 && ndist - z->dists.count[0] != 1)) {
+		fail(z, "bad distance code");
+		return;
+	}
+
+	z->state = ST_HUFF;
+}
+
+static void
+match(struct inflate *z, int sym)
+{
+	size_t len, dist;
+
+	sym -= 257;
+	if (sym >= 29) {
+		fail(z, "bad length symbol");
+		return;
+	}
+	len = lbase[sym] + getbits(z, lext[sym]);
+
+	sym = decode(z, &z->dists);
+	if (sym < 0)
+		return;
+	if (sym >= 30) {
+		fail(z, "bad distance symbol");
+		return;
+	}
+	dist = dbase[sym] + getbits(z, dext[sym]);
+	if (dist > z->total) {
+		fail(z, "distance too far back");
+		return;
+	}
+
+	if (z->error == NULL) {
+		z->copy = len;
+		z->dist = dist;
+	}
+}
+
+static void
+trailer(struct inflate *z)
+{
+	unsigned long check, size;
+	int c;
+
+	drop(z, z->nbits % 8);
+
+	switch (z->format) {
+	case INFLATE_GZIP:
+		check = getbits(z, 16);
+		check |= getbits(z, 16) << 16;
+		size = getbits(z, 16);
+		size |= getbits(z, 16) << 16;
+		if (z->error != NULL)
+			return;
+		if (check != (~z->check & 0xffffffffUL) ||
+		    size != (z->size & 0xffffffffUL)) {
+			fail(z, "bad gzip trailer");
+			return;
+		}
+
+		/*
+		 * Another member may follow.
+		 */
+		if (z->nbits - z->pad < 8) {
+			z->bits = 0;
+			z->nbits = z->pad = 0;
+			if ((c = next_byte(z)) == EOF) {
+				z->state = ST_DONE;
+				return;
+			}
+			z->bits = c;
+			z->nbits = 8;
+		}
+		z->state = ST_HEADER;
+		return;
+	case INFLATE_ZLIB:
+		check = getbits(z, 8) << 24;
+		check |= getbits(z, 8) << 16;
+		check |= getbits(z, 8) << 8;
+		check |= getbits(z, 8);
+		if (z->error == NULL && check != z->check) {
+			fail(z, "bad zlib checksum");
+			return;
+		}
+		break;
+	default:
+		break;
+	}
+
+	z->state = ST_DONE;
+}
+
+#ifdef TEST
+#include <stdlib.h>
+
+/*
+ * Made with Python's gzip and zlib modules.
+ */
+static const unsigned char gz_fixed[] = {
+	0x1f, 0x8b, 0x08, 0x08, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0x61,
+	0x2e, 0x68, 0x74, 0x6d, 0x6c, 0x00, 0xb3, 0x29, 0xb0, 0xcb, 0x48,
+	0xcd, 0xc9, 0xc9, 0xd7, 0x51, 0x28, 0xcf, 0x2f, 0xca, 0x49, 0xb1,
+	0xd1, 0x2f, 0xb0, 0x03, 0x00, 0xcb, 0xcb, 0xe6, 0xbc, 0x13, 0x00,
+	0x00, 0x00
+};
+
+static const unsigned char zlib_dynamic[] = {
+	0x78, 0xda, 0x85, 0x95, 0x51, 0x6a, 0xc3, 0x30, 0x0c, 0x86, 0xdf,
+	0x7b, 0x8a, 0xd2, 0x0b, 0x38, 0xb2, 0x6c, 0x27, 0x06, 0xcf, 0x77,
+	0xc9, 0xa8, 0x47, 0x02, 0x29, 0x1b, 0x25, 0x7b, 0xd8, 0xed, 0xd7,
+	0x2e, 0x96, 0xc6, 0x60, 0xe8, 0x7f, 0x0a, 0x49, 0x3e, 0x14, 0x49,
+	0x9f, 0xe4, 0x94, 0x65, 0xbf, 0x6d, 0xb5, 0x2c, 0x6d, 0xbe, 0xd6,
+	0xb2, 0xaf, 0xfb, 0xd6, 0xea, 0xc7, 0xe7, 0xbd, 0x3d, 0x9f, 0x16,
+	0x77, 0xdc, 0x17, 0x77, 0xbc, 0x7d, 0x7d, 0xbf, 0x7e, 0xd5, 0xb2,
+	0xad, 0xb5, 0xcc, 0xe7, 0xe5, 0xde, 0xde, 0x5e, 0x2e, 0x6e, 0xdd,
+	0xdb, 0xcd, 0x0d, 0x97, 0xfa, 0xbc, 0x9e, 0x87, 0xe2, 0xe6, 0x07,
+	0xfc, 0x00, 0x4e, 0xff, 0x50, 0xd4, 0x29, 0x32, 0x29, 0xdf, 0xa9,
+	0x60, 0x52, 0xdc, 0xa9, 0x6c, 0x52, 0x41, 0xbe, 0x98, 0x4c, 0x2c,
+	0x76, 0xcc, 0x47, 0x13, 0x4b, 0x1d, 0x63, 0x3b, 0xda, 0x28, 0x05,
+	0xd8, 0xb9, 0x4d, 0x1d, 0x4b, 0x76, 0xa1, 0xb9, 0x63, 0x93, 0xdd,
+	0x35, 0x12, 0x05, 0x34, 0x00, 0x09, 0x6a, 0xc1, 0x83, 0x88, 0x22,
+	0x82, 0x82, 0x9d, 0x21, 0xb1, 0x76, 0xd9, 0xae, 0x98, 0x54, 0x47,
+	0xb6, 0x3b, 0x48, 0x2a, 0x04, 0x18, 0xa1, 0xa4, 0xe6, 0x40, 0x44,
+	0x91, 0xe2, 0x27, 0x90, 0xa3, 0x68, 0x61, 0x0f, 0xaa, 0xce, 0x3a,
+	0x0d, 0x60, 0x9e, 0xc5, 0x4c, 0x00, 0x66, 0xbc, 0x98, 0x09, 0x01,
+	0x44, 0xd4, 0x15, 0x99, 0xec, 0x1c, 0xbd, 0x98, 0x89, 0xde, 0xae,
+	0xda, 0x8b, 0x99, 0x38, 0xda, 0x7d, 0xf4, 0x62, 0x26, 0x01, 0x33,
+	0x5e, 0xcc, 0x24, 0x14, 0x51, 0xcc, 0x8c, 0x28, 0x47, 0x31, 0x33,
+	0xa2, 0xaa, 0x75, 0x65, 0x40, 0x1f, 0x59, 0xcc, 0x64, 0x60, 0x86,
+	0xc5, 0x4c, 0x06, 0xae, 0x59, 0x77, 0x66, 0x00, 0xe3, 0xc3, 0xba,
+	0x34, 0x03, 0x98, 0x48, 0xd6, 0xad, 0x21, 0x30, 0xe4, 0x1c, 0x75,
+	0xb5, 0x81, 0x1d, 0x4e, 0x4a, 0x82, 0x55, 0x64, 0xd1, 0x43, 0x0c,
+	0xb6, 0x9b, 0xa7, 0xdf, 0xf3, 0x02, 0xd4, 0x2e, 0x82, 0x28, 0xfe,
+	0x39, 0x83, 0xdc, 0xf1, 0x7b, 0x71, 0x3f, 0xff, 0xa3, 0xd3, 0x37,
+	0x24, 0x2a, 0xee, 0x29
+};
+
+static const unsigned char raw_far[] = {
+	0xed, 0xdd, 0x47, 0x75, 0xc0, 0x30, 0x00, 0xc0, 0x50, 0xac, 0xf1,
+	0x8a, 0x67, 0x1c, 0x8f, 0x78, 0xa1, 0x6f, 0x41, 0xf4, 0xd4, 0xa7,
+	0x0f, 0x40, 0x14, 0x54, 0xd2, 0xa9, 0x36, 0x5e, 0x3e, 0xeb, 0x2e,
+	0xc2, 0x8c, 0xfd, 0xf4, 0xe1, 0x74, 0xb2, 0xaf, 0xd9, 0xe2, 0x6d,
+	0xf3, 0xf2, 0x52, 0x0e, 0x9f, 0x8d, 0xd7, 0x5a, 0x0b, 0x7f, 0x76,
+	0x7c, 0xb4, 0x5e, 0xa1, 0x9d, 0xfb, 0x6a, 0xcb, 0x8c, 0x65, 0xcc,
+	0x27, 0xeb, 0xf6, 0xea, 0xbb, 0x65, 0x0a, 0x21, 0xb8, 0xe5, 0x75,
+	0xcf, 0x62, 0x86, 0xa1, 0x4c, 0xf1, 0xce, 0xae, 0xab, 0x1f, 0x37,
+	0xb2, 0x90, 0x3d, 0xab, 0xa4, 0x82, 0xfd, 0x76, 0x9d, 0x27, 0xa9,
+	0xdf, 0x6c, 0xab, 0xae, 0xdd, 0xa3, 0xb7, 0xfe, 0x4c, 0xfb, 0xba,
+	0xe0, 0xda, 0x99, 0xe1, 0x99, 0x6b, 0x0c, 0x51, 0x56, 0xae, 0x51,
+	0xd8, 0xa3, 0xe2, 0xd8, 0x7d, 0xa9, 0xd1, 0xa3, 0xd0, 0xd9, 0x87,
+	0x7b, 0xef, 0x2c, 0xfd, 0x2b, 0xa2, 0x4b, 0xa2, 0x5e, 0xad, 0x44,
+	0xeb, 0x8f, 0xb4, 0x3a, 0x8e, 0xf2, 0xda, 0x13, 0xef, 0x27, 0x2d,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf8,
+	0x23, 0xe5, 0x9f, 0x7c, 0x5f, 0x7f, 0x00
+};
+
+static const unsigned char gz_members[] = {
+	0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x03, 0x01,
+	0x13, 0x00, 0xec, 0xff, 0x3c, 0x70, 0x3e, 0x68, 0x65, 0x6c, 0x6c,
+	0x6f, 0x2c, 0x20, 0x77, 0x6f, 0x72, 0x6c, 0x64, 0x3c, 0x2f, 0x70,
+	0x3e, 0xcb, 0xcb, 0xe6, 0xbc, 0x13, 0x00, 0x00, 0x00, 0x1f, 0x8b,
+	0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x95, 0x51,
+	0x6a, 0xc3, 0x30, 0x0c, 0x86, 0xdf, 0x7b, 0x8a, 0xd2, 0x0b, 0x38,
+	0xb2, 0x6c, 0x27, 0x06, 0xcf, 0x77, 0xc9, 0xa8, 0x47, 0x02, 0x29,
+	0x1b, 0x25, 0x7b, 0xd8, 0xed, 0xd7, 0x2e, 0x96, 0xc6, 0x60, 0xe8,
+	0x7f, 0x0a, 0x49, 0x3e, 0x14, 0x49, 0x9f, 0xe4, 0x94, 0x65, 0xbf,
+	0x6d, 0xb5, 0x2c, 0x6d, 0xbe, 0xd6, 0xb2, 0xaf, 0xfb, 0xd6, 0xea,
+	0xc7, 0xe7, 0xbd, 0x3d, 0x9f, 0x16, 0x77, 0xdc, 0x17, 0x77, 0xbc,
+	0x7d, 0x7d, 0xbf, 0x7e, 0xd5, 0xb2, 0xad, 0xb5, 0xcc, 0xe7, 0xe5,
+	0xde, 0xde, 0x5e, 0x2e, 0x6e, 0xdd, 0xdb, 0xcd, 0x0d, 0x97, 0xfa,
+	0xbc, 0x9e, 0x87, 0xe2, 0xe6, 0x07, 0xfc, 0x00, 0x4e, 0xff, 0x50,
+	0xd4, 0x29, 0x32, 0x29, 0xdf, 0xa9, 0x60, 0x52, 0xdc, 0xa9, 0x6c,
+	0x52, 0x41, 0xbe, 0x98, 0x4c, 0x2c, 0x76, 0xcc, 0x47, 0x13, 0x4b,
+	0x1d, 0x63, 0x3b, 0xda, 0x28, 0x05, 0xd8, 0xb9, 0x4d, 0x1d, 0x4b,
+	0x76, 0xa1, 0xb9, 0x63, 0x93, 0xdd, 0x35, 0x12, 0x05, 0x34, 0x00,
+	0x09, 0x6a, 0xc1, 0x83, 0x88, 0x22, 0x82, 0x82, 0x9d, 0x21, 0xb1,
+	0x76, 0xd9, 0xae, 0x98, 0x54, 0x47, 0xb6, 0x3b, 0x48, 0x2a, 0x04,
+	0x18, 0xa1, 0xa4, 0xe6, 0x40, 0x44, 0x91, 0xe2, 0x27, 0x90, 0xa3,
+	0x68, 0x61, 0x0f, 0xaa, 0xce, 0x3a, 0x0d, 0x60, 0x9e, 0xc5, 0x4c,
+	0x00, 0x66, 0xbc, 0x98, 0x09, 0x01, 0x44, 0xd4, 0x15, 0x99, 0xec,
+	0x1c, 0xbd, 0x98, 0x89, 0xde, 0xae, 0xda, 0x8b, 0x99, 0x38, 0xda,
+	0x7d, 0xf4, 0x62, 0x26, 0x01, 0x33, 0x5e, 0xcc, 0x24, 0x14, 0x51,
+	0xcc, 0x8c, 0x28, 0x47, 0x31, 0x33, 0xa2, 0xaa, 0x75, 0x65, 0x40,
+	0x1f, 0x59, 0xcc, 0x64, 0x60, 0x86, 0xc5, 0x4c, 0x06, 0xae, 0x59,
+	0x77, 0x66, 0x00, 0xe3, 0xc3, 0xba, 0x34, 0x03, 0x98, 0x48, 0xd6,
+	0xad, 0x21, 0x30, 0xe4, 0x1c, 0x75, 0xb5, 0x81, 0x1d, 0x4e, 0x4a,
+	0x82, 0x55, 0x64, 0xd1, 0x43, 0x0c, 0xb6, 0x9b, 0xa7, 0xdf, 0xf3,
+	0x02, 0xd4, 0x2e, 0x82, 0x28, 0xfe, 0x39, 0x83, 0xdc, 0xf1, 0x7b,
+	0x71, 0x3f, 0xff, 0xa3, 0xd3, 0x37, 0xcb, 0x7b, 0x35, 0xab, 0x97,
+	0x06, 0x00, 0x00
+};
+
+struct src {
+	const unsigned char	*data;
+	size_t			 len;
+	size_t			 pos;
+	size_t			 step;		/* bytes per read */
+};
+
+static size_t
+src_read(void *user, char *buf, size_t len)
+{
+	struct src *src = user;
+	size_t n;
+
+	n = src->len - src->pos;
+	if (n > len)
+		n = len;
+	if (n > src->step)
+		n = src->step;
+	memcpy(buf, &src->data[src->pos], n);
+	src->pos += n;
+	return n;
+}
+
+/*
+ * Inflate with every combination of small and large reads on both
+ * sides and compare with the expected output.
+ */
+static void
+check(const unsigned char *data, size_t len, const char *expect,
+    size_t expect_len, enum inflate_format format)
+{
+	static const size_t steps[] = { 1, 7, 65536 };
+	static struct inflate z;
+	struct src src;
+	char *out;
+	size_t i, j, n, got;
+
+	out = malloc(expect_len + 1);
+	assert(out != NULL);
+
+	for (i = 0; i < 3; i++) {
+		for (j = 0; j < 3; j++) {
+			memset(&src, 0, sizeof(struct src));
+			src.data = data;
+			src.len = len;
+			src.step = steps[i];
+			inflate_init(&z, src_read, &src);
+
+			got = 0;
+			do {
+				n = expect_len + 1 - got;
+				if (n > steps[j])
+					n = steps[j];
+				n = inflate_read(&z, &out[got], n);
+				got += n;
+			} while (n > 0 && got <= expect_len);
+
+			assert(z.error == NULL);
+			assert(z.format == format);
+			assert(got == expect_len);
+			assert(memcmp(out, expect, expect_len) == 0);
+		}
+	}
+
+	free(out);
+}
+
+int
+main(int argc, char **argv)
+{
+	static const char small[] = "<p>hello, world</p>";
+	static unsigned char bad[sizeof(gz_fixed)];
+	static struct inflate z;
+	struct src src;
+	char html[2048], far[30400], both[sizeof(small) - 1 + sizeof(html)];
+	unsigned long x;
+	size_t len;
+	int i;
+
+	len = snprintf(html, sizeof(html), "%s",
+	    "<html><head><title>purehtml</title></head><body>");
+	for (i = 0; i < 40; i++)
+		len += snprintf(&html[len], sizeof(html) - len,
+		    "<li><a href=\"/item/%d\">item %d</a></li>\n", i, i * i);
+	len += snprintf(&html[len], sizeof(html) - len, "</body></html>\n");
+
+	x = 1;
+	for (i = 0; i < 200; i++) {
+		x = (x * 1103515245 + 12345) % 2147483648UL;
+		far[i] = far[i + 30200] = 'a' + (x >> 16) % 26;
+	}
+	memset(&far[200], 'x', 30000);
+
+	memcpy(both, small, sizeof(small) - 1);
+	memcpy(&both[sizeof(small) - 1], html, len);
+
+	check(gz_fixed, sizeof(gz_fixed), small, sizeof(small) - 1,
+	    INFLATE_GZIP);
+	check(zlib_dynamic, sizeof(zlib_dynamic), html, len, INFLATE_ZLIB);
+	check(raw_far, sizeof(raw_far), far, sizeof(far), INFLATE_RAW);
+	check(gz_members, sizeof(gz_members), both, sizeof(small) - 1 + len,
+	    INFLATE_GZIP);
+
+	/*
+	 * A flipped bit in the data and a truncated stream.
+	 */
+	memcpy(bad, gz_fixed, sizeof(bad));
+	bad[20] ^= 1;
+	memset(&src, 0, sizeof(struct src));
+	src.data = bad;
+	src.len = sizeof(bad);
+	src.step = sizeof(bad);
+	inflate_init(&z, src_read, &src);
+	while (inflate_read(&z, far, sizeof(far)) > 0)
+		;
+	assert(z.error != NULL);
+
+	src.pos = 0;
+	src.data = gz_fixed;
+	src.len = sizeof(gz_fixed) - 5;
+	inflate_init(&z, src_read, &src);
+	while (inflate_read(&z, far, sizeof(far)) > 0)
+		;
+	assert(z.error != NULL);
+	return 0;
+}
+#endif
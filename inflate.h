@@ -0,0 +1,83 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef INFLATE_H
+#define INFLATE_H
+
+#include <stddef.h>
+
+#define INFLATE_WINDOW	32768
+#define INFLATE_IN	16384
+#define INFLATE_FAST	9		/* bits looked up at once */
+
+enum inflate_format {
+	INFLATE_AUTO = 0,
+	INFLATE_GZIP,			/* RFC 1952, may have many members */
+	INFLATE_ZLIB,			/* RFC 1950 */
+	INFLATE_RAW			/* RFC 1951 */
+};
+
+struct huff {
+	unsigned short	 count[16];	/* codes of each length */
+	unsigned short	 symbol[288];	/* symbols in canonical order */
+	unsigned short	 fast[1 << INFLATE_FAST]; /* symbol << 4 | length */
+};
+
+/*
+ * Streaming decoder for gzip, zlib and raw deflate data. It pulls the
+ * compressed bytes from a read callback, and inflate_read() is itself
+ * a read callback that can be given to purehtml_parse_read(). Memory
+ * use is bounded by the window.
+ */
+struct inflate {
+	size_t			(*read)(void *, char *, size_t);
+	void			*user;
+	enum inflate_format	 format;	/* detected if AUTO */
+	const char		*error;		/* set if the data is bad */
+
+	unsigned char		 in[INFLATE_IN];
+	size_t			 in_len;
+	size_t			 in_pos;
+	int			 in_eof;
+
+	unsigned long		 bits;
+	int			 nbits;
+	int			 pad;		/* zero bits past the end */
+
+	unsigned char		 window[INFLATE_WINDOW];
+	size_t			 total;		/* bytes out */
+	unsigned long		 size;		/* bytes out of this member */
+
+	int			 state;
+	int			 last;		/* in the final block */
+	size_t			 stored;	/* left in a stored block */
+	size_t			 copy;		/* left in a match */
+	size_t			 dist;
+
+	struct huff		 lens;
+	struct huff		 dists;
+
+	unsigned long		 check;		/* CRC-32 or Adler-32 */
+	unsigned long		 crc_table[256];
+};
+
+void	inflate_init(struct inflate *, size_t (*)(void *, char *, size_t),
+	    void *);
+size_t	inflate_read(void *, char *, size_t);
+
+#endif
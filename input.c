@@ -0,0 +1,287 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "input.h"
+#include "stats.h"
+#include "util.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <err.h>
+
+static void	new_input(struct input *);
+static size_t	file_read(void *, char *, size_t);
+static size_t	buf_size(struct input *);
+static void	read_more(struct input *);
+static void	sniff(struct input *);
+
+/*
+ * Forget the encoding sniffed from the previous input.
+ */
+static void
+new_input(struct input *in)
+{
+	if (in->sniffed)
+		in->encoding = ENCODING_NONE;
+	in->sniffed = 0;
+}
+
+/*
+ * Read from a buffer holding all of the input. The refill buffer, if
+ * any, is kept for later use.
+ */
+void
+input_buf(struct input *in, const char *buf, size_t len)
+{
+	new_input(in);
+	in->buf = NULL;
+	in->len = 0;
+	in->pos = 0;
+	in->read = NULL;
+	in->user = NULL;
+	in->eof = 0;
+	in->src = buf;
+	in->src_len = len;
+	in->src_pos = 0;
+	in->src_end = 1;
+}
+
+void
+input_read(struct input *in, size_t (*read)(void *, char *, size_t),
+    void *user)
+{
+	assert(read != NULL);
+
+	new_input(in);
+	in->buf = NULL;
+	in->len = 0;
+	in->pos = 0;
+	in->read = read;
+	in->user = user;
+	in->eof = 0;
+	in->src = in->refill;
+	in->src_len = 0;
+	in->src_pos = 0;
+	in->src_end = 0;
+}
+
+static size_t
+file_read(void *user, char *buf, size_t len)
+{
+	return fread(buf, 1, len, user);
+}
+
+void
+input_file(struct input *in, FILE *fp)
+{
+	assert(fp != NULL);
+
+	input_read(in, file_read, fp);
+}
+
+/*
+ * Size of the refill and decode buffers: room for the prescan, and for
+ * a character cut short by the previous read.
+ */
+static size_t
+buf_size(struct input *in)
+{
+	if (in->size == 0)
+		in->size = INPUT_SIZE;
+
+	return (in->size < ENCODING_PRESCAN ? ENCODING_PRESCAN : in->size) + 4;
+}
+
+/*
+ * Read more to src, keeping what was not decoded yet.
+ */
+static void
+read_more(struct input *in)
+{
+	size_t left, n;
+
+	assert(in->read != NULL);
+
+	if (in->refill == NULL) {
+		if ((in->refill = mem_malloc(buf_size(in))) == NULL)
+			err(1, "malloc input");
+		STATS_ADD(allocs[ALLOC_INPUT], 1);
+	}
+
+	left = in->src_len - in->src_pos;
+	if (left > 0)
+		memmove(in->refill, &in->src[in->src_pos], left);
+	n = buf_size(in) - left;
+	if (n > in->size)
+		n = in->size;
+
+	n = in->read(in->user, &in->refill[left], n);
+	in->src = in->refill;
+	in->src_len = left + n;
+	in->src_pos = 0;
+	if (n == 0)
+		in->src_end = 1;
+}
+
+/*
+ * Decide the encoding from the first ENCODING_PRESCAN bytes.
+ */
+static void
+sniff(struct input *in)
+{
+	while (in->src_len < ENCODING_PRESCAN && !in->src_end)
+		read_more(in);
+
+	in->src_pos += encoding_bom(in->src, in->src_len, &in->encoding);
+	if (in->encoding == ENCODING_NONE)
+		in->encoding = in->charset;
+	if (in->encoding == ENCODING_NONE)
+		in->encoding = encoding_sniff(&in->src[in->src_pos],
+		    in->src_len - in->src_pos, in->src_end);
+	in->sniffed = 1;
+}
+
+/*
+ * Called by INPUT_GETC() when the buffer runs out. Refills it with the
+ * next piece of input, decoded if need be, and returns the first byte,
+ * or EOF.
+ */
+int
+input_fill(struct input *in)
+{
+	size_t n;
+
+	while (!in->eof) {
+		if (in->encoding == ENCODING_NONE)
+			sniff(in);
+
+		n = in->src_len - in->src_pos;
+		if (n > 0 && in->encoding == ENCODING_UTF8 && in->validate)
+			n = encoding_utf8_valid(&in->src[in->src_pos], n);
+
+		if (n > 0 && (in->encoding == ENCODING_UTF8 ||
+		    in->encoding == ENCODING_BINARY)) {
+			in->buf = &in->src[in->src_pos];
+			in->len = n;
+			in->src_pos += n;
+		} else if (in->src_pos < in->src_len) {
+			n = in->src_len - in->src_pos;
+			if (in->decoded == NULL) {
+				in->decoded = mem_malloc(buf_size(in));
+				if (in->decoded == NULL)
+					err(1, "malloc decoded");
+				STATS_ADD(allocs[ALLOC_INPUT], 1);
+			}
+			in->len = encoding_decode(in->encoding,
+			    &in->src[in->src_pos], &n, in->decoded,
+			    buf_size(in), in->src_end);
+			in->buf = in->decoded;
+			in->src_pos += n;
+		} else
+			in->len = 0;
+
+		in->pos = 0;
+		if (in->len > 0)
+			return (unsigned char) in->buf[in->pos++];
+
+		if (in->src_end)
+			in->eof = 1;
+		else
+			read_more(in);
+	}
+
+	return EOF;
+}
+
+/*
+ * Returns the number of input bytes that were read ahead but not yet
+ * consumed, e.g. to give them back to a stream.
+ */
+size_t
+input_ahead(struct input *in)
+{
+	const unsigned char *s;
+	size_t n, i;
+
+	n = in->src_len - in->src_pos;
+	if (in->buf != in->decoded || in->encoding == ENCODING_UTF8)
+		return n + in->len - in->pos;
+
+	s = (const unsigned char *) in->buf;
+	for (i = in->pos; i < in->len; i++) {
+		if ((s[i] & 0xc0) == 0x80)
+			continue;
+		if (in->encoding == ENCODING_UTF16LE ||
+		    in->encoding == ENCODING_UTF16BE)
+			n += s[i] >= 0xf0 ? 4 : 2;
+		else
+			n++;
+	}
+
+	return n;
+}
+
+/*
+ * Decide the encoding of a buffer holding all of the input and decode
+ * it to UTF-8 at once, e.g. to split it in chunks. Returns the decoded
+ * copy to be freed by the caller, or NULL if *buf is valid UTF-8
+ * already, in which case only a byte order mark is skipped.
+ */
+char *
+input_utf8(struct input *in, const char **buf, size_t *len)
+{
+	char *utf8;
+	size_t n;
+
+	input_buf(in, *buf, *len);
+	if (in->encoding == ENCODING_NONE) {
+		sniff(in);
+		*buf += in->src_pos;
+		*len -= in->src_pos;
+	}
+	if (in->encoding == ENCODING_BINARY || (in->encoding ==
+	    ENCODING_UTF8 && (!in->validate ||
+	    encoding_utf8_valid(*buf, *len) == *len)))
+		return NULL;
+
+	/*
+	 * At most 3 bytes of UTF-8 per byte of input.
+	 */
+	if ((utf8 = mem_malloc(*len * 3 + 4)) == NULL)
+		err(1, "malloc utf8");
+	STATS_ADD(allocs[ALLOC_INPUT], 1);
+	n = *len;
+	*len = encoding_decode(in->encoding, *buf, &n, utf8, *len * 3 + 4, 1);
+	*buf = utf8;
+	in->encoding = ENCODING_UTF8;
+
+	return utf8;
+}
+
+void
+input_free(struct input *in)
+{
+	mem_free(in->refill);
+	mem_free(in->decoded);
+	in->refill = NULL;
+	in->decoded = NULL;
+	in->buf = in->src = NULL;
+	in->len = in->pos = 0;
+	in->src_len = in->src_pos = 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "encoding.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+#define INPUT_SIZE 65536
+
+/*
+ * Input of the tokenizer: either a buffer that holds all of it, or a
+ * read callback that refills an internal buffer. The callback returns
+ * the number of bytes it put to buf, or 0 at the end of input.
+ *
+ * The input is decoded to UTF-8 on the way. Unless the encoding is set
+ * beforehand, it is sniffed from the first ENCODING_PRESCAN bytes as in
+ * the HTML standard: a byte order mark, then charset from the transport
+ * layer, then a <meta> declaration, then a guess. A sniffed encoding is
+ * sniffed again for the next input. UTF-8 input is passed
+ * through without copying, and if validate is set, only as far as it is
+ * valid: invalid sequences are replaced with U+FFFD. The tokenizer
+ * offsets count bytes of UTF-8.
+ */
+struct input {
+	const char	*buf;		/* bytes not yet consumed */
+	size_t		 len;
+	size_t		 pos;
+
+	size_t		(*read)(void *user, char *buf, size_t len);
+	void		*user;
+	char		*refill;
+	size_t		 size;		/* of reads, INPUT_SIZE if zero */
+	int		 eof;		/* no more after buf */
+
+	int		 charset;	/* ENCODING_* from e.g. Content-Type */
+	int		 encoding;	/* ENCODING_*, sniffed if NONE */
+	int		 sniffed;	/* encoding is of this input only */
+	int		 validate;	/* replace invalid UTF-8 */
+	const char	*src;		/* undecoded input */
+	size_t		 src_len;
+	size_t		 src_pos;
+	int		 src_end;	/* no more after src */
+	char		*decoded;
+};
+
+void	input_buf(struct input *, const char *, size_t);
+void	input_read(struct input *, size_t (*)(void *, char *, size_t),
+	    void *);
+void	input_file(struct input *, FILE *);
+int	input_fill(struct input *);
+size_t	input_ahead(struct input *);
+char	*input_utf8(struct input *, const char **, size_t *);
+void	input_free(struct input *);
+
+/*
+ * Returns the next byte as an unsigned char, or EOF.
+ */
+#define INPUT_GETC(_in) ((_in)->pos < (_in)->len ? \
+	(unsigned char) (_in)->buf[(_in)->pos++] : input_fill(_in))
+
+/*
+ * Back up by one byte, only right after INPUT_GETC().
+ */
+#define INPUT_UNGETC(_in) ((_in)->pos--)
+
+#define INPUT_EOF(_in) ((_in)->pos == (_in)->len && (_in)->eof)
+
+#endif
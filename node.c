@@ -20,6 +20,8 @@
 #include "elem.h"
 #include "cdata.h"
 #include "document.h"
+#include "stats.h"
+#include "util.h"
 
 #include <stdlib.h>
 #include <err.h>
@@ -78,7 +80,7 @@ node_free_internal(struct node *node, int want_sum)
 	}
 
 	if (!want_sum)
-		free(node);
+		mem_free(node);
 
 	return sum;
 }
@@ -89,12 +91,43 @@ node_size(struct node *node)
 	return node_free_internal(node, 1);
 }
 
+/*
+ * Views are released by the parser after the callback returns.
+ */
 void
 node_free(struct node *node)
 {
+	if (node->view)
+		return;
+
 	(void) node_free_internal(node, 0);
 }
 
+/*
+ * The nodes passed to the begin and end callbacks are views owned by
+ * the parser, valid only until the callback returns. This returns a
+ * copy the caller owns and releases with node_free().
+ */
+struct node *
+node_retain(struct node *node)
+{
+	assert(node != NULL);
+
+	if (!node->view)
+		return node;
+
+	switch (node->type) {
+	case NODE_ELEM:
+		return node_create_from_elem(elem_copy(node->u.elem));
+	case NODE_CDATA:
+		return node_create_from_cdata(cdata_copy(node->u.cdata));
+	default:
+		break;
+	}
+
+	return node;
+}
+
 struct node *
 node_create_from_document(struct document *document)
 {
@@ -114,9 +147,10 @@ node_create(T_NODE type)
 {
 	struct node	*node;
 
-	node = calloc(1, sizeof(struct node));
+	node = mem_calloc(1, sizeof(struct node));
 	if (node == NULL)
 		err(1, "calloc node");
+	STATS_ADD(allocs[ALLOC_NODE], 1);
 
 	node->type = type;
 
@@ -29,6 +29,7 @@ typedef enum nodetype {
 
 struct node {
 	T_NODE	type;
+	int	view;		/* owned by the parser, see node_retain() */
 
 	union {
 		struct elem	*elem;
@@ -49,6 +50,7 @@ struct node {
 struct node	*node_create_from_elem(struct elem *);
 struct node	*node_create_from_cdata(struct cdata *);
 struct node	*node_create_from_document(struct document *);
+struct node	*node_retain(struct node *);
 
 size_t node_size(struct node *);
 void node_free(struct node *);
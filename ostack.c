@@ -17,85 +17,114 @@
  */
 
 #include "ostack.h"
+#include "elem.h"
+#include "tagmap.h"
+#include "stats.h"
+#include "util.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <err.h>
 #include <assert.h>
 
-/*
- * Open elements stack.
- */
-static struct elem **_ostack;
-static size_t _ostack_alloc;
-static size_t _ostack_depth;
-
 void
-ostack_push(struct elem *node)
+ostack_push(struct ostack *ostack, struct elem *node)
 {
-	if (_ostack_depth == _ostack_alloc) {
-		_ostack_alloc += 4;
-		_ostack = realloc(_ostack, _ostack_alloc * sizeof(struct domnode *));
-		if (_ostack == NULL)
+	assert(node->tagid >= 0 && node->tagid < TAGMAP_SZ);
+
+	if (ostack->depth == ostack->alloc) {
+		ostack->alloc = ostack->alloc ? ostack->alloc * 2 : 16;
+		ostack->elems = mem_realloc(ostack->elems,
+		    ostack->alloc * sizeof(struct elem *));
+		if (ostack->elems == NULL)
 			err(1, "realloc ostack");
+		STATS_ADD(allocs[ALLOC_OSTACK], 1);
+	}
+	if (ostack->counts == NULL) {
+		ostack->counts = mem_calloc(TAGMAP_SZ, sizeof(size_t));
+		if (ostack->counts == NULL)
+			err(1, "calloc ostack");
+		STATS_ADD(allocs[ALLOC_OSTACK], 1);
 	}
 
-	assert(_ostack != NULL);
-	_ostack[_ostack_depth++] = node;
+	assert(ostack->elems != NULL);
+	ostack->elems[ostack->depth++] = node;
+	ostack->counts[node->tagid]++;
 }
 
-#include "elem.h"
-#include <err.h>
 struct elem *
-ostack_prev(struct elem *elem)
+ostack_prev(struct ostack *ostack, struct elem *elem)
 {
 	size_t i;
 	size_t sz;
 
-	sz = ostack_depth();
+	sz = ostack_depth(ostack);
 	for (i = sz; i >= 1; i--)  {
-		if (_ostack[i-1] == elem && i >= 2) {
-			return _ostack[i-2];
+		if (ostack->elems[i-1] == elem && i >= 2) {
+			return ostack->elems[i-2];
 		} else
 			break;
 	}
 	return NULL;
 }
 
+/*
+ * The stack keeps its memory when emptied, for the next document, see
+ * purehtml_reset(). It is released by ostack_free().
+ */
 struct elem *
-ostack_pop(void)
+ostack_pop(struct ostack *ostack)
 {
-	if (_ostack_depth > 0) {
-		_ostack_depth--;
-		return _ostack[_ostack_depth];
-	}
-	if (_ostack_depth == 0 && _ostack_alloc > 0) {
-		free(_ostack);
-		_ostack = NULL;
-		_ostack_alloc = 0;
-	}
+	struct elem *elem;
 
-	return NULL;
+	if (ostack->depth == 0)
+		return NULL;
+
+	elem = ostack->elems[--ostack->depth];
+	ostack->counts[elem->tagid]--;
+	return elem;
+}
+
+/*
+ * Number of open elements with the given tag id.
+ */
+size_t
+ostack_count(struct ostack *ostack, int tagid)
+{
+	assert(tagid >= 0 && tagid < TAGMAP_SZ);
+
+	if (ostack->counts == NULL)
+		return 0;
+	return ostack->counts[tagid];
+}
+
+void
+ostack_free(struct ostack *ostack)
+{
+	mem_free(ostack->elems);
+	mem_free(ostack->counts);
+	memset(ostack, 0, sizeof(struct ostack));
 }
 
 struct elem *
-ostack_peek_at(size_t depth)
+ostack_peek_at(struct ostack *ostack, size_t depth)
 {
-	if (_ostack_depth == 0 || depth > _ostack_depth || depth < 1)
+	if (ostack->depth == 0 || depth > ostack->depth || depth < 1)
 		return NULL;
 
-	return _ostack[depth-1];
+	return ostack->elems[depth-1];
 }
 
 struct elem *
-ostack_peek(void)
+ostack_peek(struct ostack *ostack)
 {
-	return ostack_peek_at(_ostack_depth);
+	return ostack_peek_at(ostack, ostack->depth);
 }
 
 size_t
-ostack_depth(void)
+ostack_depth(struct ostack *ostack)
 {
-	return _ostack_depth;
+	return ostack->depth;
 }
 
 #ifdef TEST
@@ -103,14 +132,84 @@ ostack_depth(void)
 int
 main(int argc, char **argv)
 {
-	struct elem elem1, elem2;
+	struct ostack ostack = { 0 };
+	struct elem elem1 = { 0 }, elem2 = { 0 };
+
+	elem2.tagid = TAG_P;
+
+	ostack_push(&ostack, &elem1);
+	ostack_push(&ostack, &elem2);
+	assert(ostack_count(&ostack, TAG_P) == 1);
+	assert(ostack_pop(&ostack) == &elem2);
+	assert(ostack_count(&ostack, TAG_P) == 0);
+	assert(ostack_pop(&ostack) == &elem1);
+	assert(ostack_pop(&ostack) == NULL);
+	assert(ostack.alloc > 0);
+	ostack_free(&ostack);
+	return 0;
+}
+#endif
+
+#ifdef BENCH
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static double
+now(void)
+{
+	struct timespec ts;
 
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * Push to the given depth and pop back, on a new stack that has to
+ * grow and on one that has grown already.
+ */
+int
+main(int argc, char **argv)
+{
+	static const size_t depths[] = { 16, 256, 4096, 65536 };
+	static struct elem elem;
+	struct ostack ostack;
+	char name[32];
+	size_t i, j, k, depth, reps;
+	double start, cold, warm;
+
+	for (i = 0; i < sizeof(depths) / sizeof(depths[0]); i++) {
+		depth = depths[i];
+		reps = 20000000 / depth;
+
+		memset(&ostack, 0, sizeof(struct ostack));
+		start = now();
+		for (j = 0; j < reps; j++) {
+			for (k = 0; k < depth; k++)
+				ostack_push(&ostack, &elem);
+			ostack_free(&ostack);
+		}
+		cold = (now() - start) / (reps * depth);
+
+		memset(&ostack, 0, sizeof(struct ostack));
+		start = now();
+		for (j = 0; j < reps; j++) {
+			for (k = 0; k < depth; k++)
+				ostack_push(&ostack, &elem);
+			for (k = 0; k < depth; k++)
+				ostack_pop(&ostack);
+		}
+		warm = (now() - start) / (reps * depth);
+		ostack_free(&ostack);
+
+		snprintf(name, sizeof(name), "ostack push/pop new to %zu",
+		    depth);
+		printf("%-32s%8.1f ns/op\n", name, cold * 1e9);
+		snprintf(name, sizeof(name), "ostack push/pop old to %zu",
+		    depth);
+		printf("%-32s%8.1f ns/op\n", name, warm * 1e9);
+	}
 
-	ostack_push(&elem1);
-	ostack_push(&elem2);
-	assert(ostack_pop() == &elem2);
-	assert(ostack_pop() == &elem1);
-	assert(ostack_pop() == NULL);
 	return 0;
 }
 #endif
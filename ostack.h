@@ -23,11 +23,24 @@
 
 struct elem;
 
-void		 ostack_push(struct elem *elem);
-struct elem	*ostack_pop(void);
-struct elem	*ostack_prev(struct elem *elem);
-struct elem	*ostack_peek(void);
-struct elem	*ostack_peek_at(size_t);
-size_t		 ostack_depth(void);
+/*
+ * Open elements stack. The number of open elements of each tag id is
+ * kept so that looking for one that is not open takes no scan.
+ */
+struct ostack {
+	struct elem	**elems;
+	size_t		  alloc;
+	size_t		  depth;
+	size_t		 *counts;	/* by tag id, see ostack_count() */
+};
+
+void		 ostack_push(struct ostack *, struct elem *elem);
+struct elem	*ostack_pop(struct ostack *);
+struct elem	*ostack_prev(struct ostack *, struct elem *elem);
+struct elem	*ostack_peek(struct ostack *);
+struct elem	*ostack_peek_at(struct ostack *, size_t);
+size_t		 ostack_depth(struct ostack *);
+size_t		 ostack_count(struct ostack *, int);
+void		 ostack_free(struct ostack *);
 
 #endif
@@ -0,0 +1,512 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "purehtml.h"
+#include "tagmap.h"
+
+#include <pthread.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <err.h>
+
+/*
+ * Pipelined parsing: a thread runs the tokenizer and passes the tokens
+ * in batches through a ring to the calling thread, which runs the
+ * dispatcher and the callbacks.
+ *
+ * The dispatcher tells the tokenizer to switch state only after a
+ * start tag of a raw text element (TAG_RAWTEXT), so the tokenizer
+ * runs ahead assuming no switch and waits for the answer only after
+ * such a tag. Inside a skipped raw text element the dispatcher keeps
+ * returning the SKIP_* state, which we ignore: tokenizing the rest of
+ * it in the regular raw text state gives the same end tag.
+ *
+ * With an error callback set, the errors of the tokenizer are held in
+ * the batch and reported on the calling thread before the token they
+ * came with.
+ */
+#define PIPE_BATCHES	8
+#define PIPE_TOKENS	256
+#define PIPE_CHARS	4096
+
+struct batch {
+	struct token	 tokens[PIPE_TOKENS];
+	size_t		 offsets[PIPE_TOKENS];	/* offset after the token */
+	size_t		 ntokens;
+	char		*chars;		/* text of the tokens */
+	size_t		 nchars;
+	size_t		 chars_alloc;	/* PIPE_CHARS or for a longer token */
+	struct report_queue errors;
+	int		 sync;		/* last token needs the state back */
+	int		 eof;
+};
+
+struct pipeline {
+	struct purehtml	*ctx;
+	struct batch	 ring[PIPE_BATCHES];
+	size_t		 head;		/* next batch to fill */
+	size_t		 tail;		/* next batch to dispatch */
+
+	pthread_mutex_t	 lock;
+	pthread_cond_t	 cond;
+	int		 stop;		/* set by the dispatching side */
+	int		 state;		/* answer to a sync */
+	int		 answered;
+	int		 defer;		/* errors in the batches */
+};
+
+/*
+ * Returns the next free batch or NULL if the dispatcher has stopped.
+ */
+static struct batch *
+next_batch(struct pipeline *pl)
+{
+	struct batch *batch;
+	int stop;
+
+	pthread_mutex_lock(&pl->lock);
+	while (pl->head - pl->tail == PIPE_BATCHES && !pl->stop)
+		pthread_cond_wait(&pl->cond, &pl->lock);
+	stop = pl->stop;
+	pthread_mutex_unlock(&pl->lock);
+
+	if (stop)
+		return NULL;
+
+	batch = &pl->ring[pl->head % PIPE_BATCHES];
+	batch->ntokens = 0;
+	batch->nchars = 0;
+	batch->sync = 0;
+	batch->eof = 0;
+	report_queue_clear(&batch->errors);
+	if (pl->defer)
+		pl->ctx->tokenizer.report = &batch->errors.report;
+	return batch;
+}
+
+/*
+ * Publish the batch and, if it ends in a sync, wait for the state the
+ * dispatcher returned. Returns 0 if the dispatcher has stopped.
+ */
+static int
+publish(struct pipeline *pl, struct batch *batch)
+{
+	int stop;
+
+	pthread_mutex_lock(&pl->lock);
+	pl->head++;
+	pl->answered = 0;
+	pthread_cond_broadcast(&pl->cond);
+	if (batch->sync) {
+		while (!pl->answered && !pl->stop)
+			pthread_cond_wait(&pl->cond, &pl->lock);
+		if (pl->answered && pl->state != STATE_NONE)
+			pl->ctx->tokenizer.state = pl->state;
+	}
+	stop = pl->stop;
+	pthread_mutex_unlock(&pl->lock);
+
+	return !stop;
+}
+
+/*
+ * Make room for at least len chars in an empty batch, whose tokens do
+ * not point to the old ones.
+ */
+static void
+grow_chars(struct batch *batch, size_t len)
+{
+	assert(batch->nchars == 0);
+
+	if (batch->chars_alloc == 0)
+		batch->chars_alloc = PIPE_CHARS;
+	while (batch->chars_alloc < len)
+		batch->chars_alloc *= 2;
+	mem_free(batch->chars);
+	if ((batch->chars = mem_malloc(batch->chars_alloc)) == NULL)
+		err(1, "malloc batch chars");
+}
+
+/*
+ * Move the token out of the tokenizer into the batch, which must have
+ * room for its text unless it is empty.
+ */
+static void
+add_token(struct batch *batch, struct token *token, size_t offset)
+{
+	struct token *slot;
+
+	slot = &batch->tokens[batch->ntokens];
+	*slot = *token;
+	memset(&slot->s, 0, sizeof(struct str));
+	if (token->s.len > 0) {
+		if (batch->nchars + token->s.len + 1 > batch->chars_alloc)
+			grow_chars(batch, token->s.len + 1);
+		slot->s.s = &batch->chars[batch->nchars];
+		slot->s.len = token->s.len;
+		memcpy(slot->s.s, token->s.s, token->s.len + 1);
+		batch->nchars += token->s.len + 1;
+	}
+	batch->offsets[batch->ntokens++] = offset;
+	batch->errors.index = batch->ntokens;
+
+	token->used = 1;
+	token_clear(token);
+	str_add(&token->s, '\0');
+}
+
+static void *
+produce(void *arg)
+{
+	struct pipeline *pl = arg;
+	struct tokenizer *tokenizer;
+	struct batch *batch;
+	struct token *token;
+
+	tokenizer = &pl->ctx->tokenizer;
+	if ((batch = next_batch(pl)) == NULL)
+		return NULL;
+
+	while (!INPUT_EOF(&tokenizer->input)) {
+		token = tokenize(tokenizer);
+		if (token == NULL)
+			continue;
+
+		if (batch->ntokens == PIPE_TOKENS || (batch->nchars > 0 &&
+		    batch->nchars + token->s.len + 1 > batch->chars_alloc)) {
+			if (!publish(pl, batch) ||
+			    (batch = next_batch(pl)) == NULL) {
+				token_clear(token);
+				return NULL;
+			}
+		}
+
+		if (TOKEN_IS_START(token) &&
+		    tagmap(token->u.tag.tagid)->flags & TAG_RAWTEXT)
+			batch->sync = 1;
+		add_token(batch, token, tokenizer->offset);
+
+		if (batch->sync && (!publish(pl, batch) ||
+		    (batch = next_batch(pl)) == NULL))
+			return NULL;
+	}
+
+	batch->eof = 1;
+	publish(pl, batch);
+	return NULL;
+}
+
+/*
+ * Like purehtml_parse() but the tokenizer runs on a thread of its own,
+ * overlapping with the tree construction and the callbacks, which run
+ * on the calling thread. The tokens go to ctx->record as they are
+ * dispatched, but ctx->perf must not be set: the tokenizer runs ahead
+ * on another clock. Attributes are collected in skipped subtrees too.
+ */
+size_t
+purehtml_parse_pipelined(struct purehtml *ctx, FILE *fp,
+    int (*begin)(struct node *), int (*end)(struct node *))
+{
+	struct pipeline *pl;
+	struct batch *batch;
+	pthread_t thread;
+	size_t i, start, consumed;
+	int state, eof;
+
+	assert(fp != NULL);
+	assert(ctx->perf == NULL);
+
+	if ((pl = mem_calloc(1, sizeof(struct pipeline))) == NULL)
+		err(1, "calloc pipeline");
+	pl->ctx = ctx;
+	pl->defer = (ctx->report.error != NULL);
+	for (i = 0; i < PIPE_BATCHES; i++)
+		report_queue_init(&pl->ring[i].errors);
+	if ((errno = pthread_mutex_init(&pl->lock, NULL)) != 0)
+		err(1, "pthread_mutex_init");
+	if ((errno = pthread_cond_init(&pl->cond, NULL)) != 0)
+		err(1, "pthread_cond_init");
+
+	input_file(&ctx->tokenizer.input, fp);
+	ctx->tokenizer.no_attrs = 0;
+	ctx->dispatcher.document = &ctx->document;
+	ctx->tokenizer.report = ctx->dispatcher.report = &ctx->report;
+	start = consumed = ctx->tokenizer.offset;
+
+	if ((errno = pthread_create(&thread, NULL, produce, pl)) != 0)
+		err(1, "pthread_create");
+
+	eof = 0;
+	while (!eof) {
+		pthread_mutex_lock(&pl->lock);
+		while (pl->head == pl->tail)
+			pthread_cond_wait(&pl->cond, &pl->lock);
+		pthread_mutex_unlock(&pl->lock);
+
+		batch = &pl->ring[pl->tail % PIPE_BATCHES];
+		state = STATE_NONE;
+		for (i = 0; i < batch->ntokens; i++) {
+			if (!ctx->dispatcher.stop) {
+				report_queue_flush(&batch->errors,
+				    &ctx->report, i, 0);
+				if (ctx->record != NULL)
+					tokenlog_put(ctx->record,
+					    &batch->tokens[i]);
+				state = dispatch(&ctx->dispatcher,
+				    &batch->tokens[i], begin, end);
+				if (ctx->record != NULL)
+					tokenlog_put_state(ctx->record, state);
+				consumed = batch->offsets[i];
+			}
+			token_clear(&batch->tokens[i]);
+		}
+		if (!ctx->dispatcher.stop)
+			report_queue_flush(&batch->errors, &ctx->report,
+			    batch->ntokens, 0);
+		eof = batch->eof || ctx->dispatcher.stop;
+
+		pthread_mutex_lock(&pl->lock);
+		pl->tail++;
+		if (batch->sync) {
+			pl->state = state;
+			pl->answered = 1;
+		}
+		if (ctx->dispatcher.stop)
+			pl->stop = 1;
+		pthread_cond_broadcast(&pl->cond);
+		pthread_mutex_unlock(&pl->lock);
+	}
+
+	pthread_join(thread, NULL);
+	if (!ctx->dispatcher.stop)
+		consumed = ctx->tokenizer.offset;
+
+	/*
+	 * Free the tokens the tokenizer got ahead with before a stop.
+	 */
+	for (; pl->tail != pl->head; pl->tail++) {
+		batch = &pl->ring[pl->tail % PIPE_BATCHES];
+		for (i = 0; i < batch->ntokens; i++)
+			token_clear(&batch->tokens[i]);
+	}
+
+	if (ctx->dispatcher.stop)
+		dispatch_unwind(&ctx->dispatcher);
+
+	ctx->tokenizer.report = &ctx->report;
+	for (i = 0; i < PIPE_BATCHES; i++) {
+		report_queue_free(&pl->ring[i].errors);
+		mem_free(pl->ring[i].chars);
+	}
+	pthread_cond_destroy(&pl->cond);
+	pthread_mutex_destroy(&pl->lock);
+	mem_free(pl);
+
+	return consumed - start;
+}
+
+#ifdef TEST
+#include "node.h"
+#include "elem.h"
+#include "cdata.h"
+
+static struct str out;
+static const char *stop_name;
+
+static void
+out_add(const char *s)
+{
+	while (*s != '\0')
+		str_add(&out, *s++);
+}
+
+static void
+add_error(void *user, enum errors code, size_t line, size_t offset)
+{
+	char s[64];
+
+	snprintf(s, sizeof(s), "{%zu:%zu:%s}", line, offset,
+	    report_name(code));
+	out_add(s);
+}
+
+static int
+begin(struct node *node)
+{
+	if (node->type == NODE_ELEM) {
+		out_add("<");
+		out_add(node->u.elem->name);
+		out_add(">");
+		if (strcmp(node->u.elem->name, "nav") == 0 ||
+		    strcmp(node->u.elem->name, "style") == 0)
+			return CB_SKIP;
+	} else
+		out_add(node->u.cdata->data.s);
+	return CB_CONTINUE;
+}
+
+static int
+end(struct node *node)
+{
+	if (node->type == NODE_ELEM) {
+		out_add("</");
+		out_add(node->u.elem->name);
+		out_add(">");
+		if (stop_name != NULL &&
+		    strcmp(node->u.elem->name, stop_name) == 0)
+			return CB_STOP;
+	} else
+		out_add(node->u.cdata->data.s);
+	return CB_CONTINUE;
+}
+
+/*
+ * Both ways of parsing must give the same callbacks and length.
+ */
+static void
+compare(const char *html)
+{
+	static struct purehtml ctx;
+	FILE *fp;
+	char *expect;
+	size_t len;
+
+	purehtml_free(&ctx);
+	ctx.report.error = add_error;
+	str_add(&out, '\0');
+	fp = fmemopen((void *) html, strlen(html), "r");
+	assert(fp != NULL);
+	len = purehtml_parse(&ctx, fp, begin, end);
+	fclose(fp);
+	expect = mem_strdup(out.s);
+	assert(expect != NULL);
+
+	purehtml_free(&ctx);
+	ctx.report.error = add_error;
+	str_add(&out, '\0');
+	fp = fmemopen((void *) html, strlen(html), "r");
+	assert(fp != NULL);
+	assert(purehtml_parse_pipelined(&ctx, fp, begin, end) == len);
+	fclose(fp);
+
+	if (strcmp(out.s, expect) != 0) {
+		fprintf(stderr, "got:    %s\nexpect: %s\n", out.s, expect);
+		assert(0);
+	}
+	mem_free(expect);
+}
+
+static size_t
+read_mem(void *user, char *buf, size_t len)
+{
+	return fread(buf, 1, len, user);
+}
+
+/*
+ * The tokens recorded from a pipelined parse must replay to the same
+ * callbacks.
+ */
+static void
+replay(const char *html)
+{
+	struct purehtml ctx;
+	struct tokenlog log;
+	char *buf, *expect;
+	size_t len;
+	FILE *fp;
+	FILE *in;
+
+	memset(&ctx, 0, sizeof(struct purehtml));
+	fp = open_memstream(&buf, &len);
+	assert(fp != NULL);
+	tokenlog_record(&log, fp);
+	ctx.record = &log;
+	str_add(&out, '\0');
+	in = fmemopen((void *) html, strlen(html), "r");
+	assert(in != NULL);
+	purehtml_parse_pipelined(&ctx, in, begin, end);
+	fclose(in);
+	purehtml_free(&ctx);
+	assert(log.error == NULL);
+	tokenlog_free(&log);
+	fclose(fp);
+	expect = mem_strdup(out.s);
+	assert(expect != NULL);
+
+	fp = fmemopen(buf, len, "r");
+	assert(fp != NULL);
+	tokenlog_init(&log, read_mem, fp);
+	str_add(&out, '\0');
+	assert(purehtml_replay(&ctx, &log, begin, end) == 0);
+	assert(log.error == NULL);
+	purehtml_free(&ctx);
+	fclose(fp);
+
+	if (strcmp(out.s, expect) != 0) {
+		fprintf(stderr, "got:    %s\nexpect: %s\n", out.s, expect);
+		assert(0);
+	}
+	tokenlog_free(&log);
+	mem_free(expect);
+	free(buf);
+}
+
+int
+main(int argc, char **argv)
+{
+	static const char part[] =
+	    "<div><p>a <b>b</b> c</p><title>x<b>y</title>"
+	    "<script>if (a</b) x='</scr';</script>"
+	    "<style>p</b>{}</style><nav><p>n<script>y</script></nav>"
+	    "<ul><li>a<li>b</ul><textarea>t<b></textarea></div>\n"
+	    "<p a b=1 c=d'>x</i><!--></p>\n";
+	struct str html = { 0 };
+	const char *p;
+	int i;
+
+	compare("<title>a</title><body><p>b</p></body>");
+	compare(part);
+
+	for (i = 0; i < 200; i++)
+		for (p = part; *p != '\0'; p++)
+			str_add(&html, *p);
+	compare(html.s);
+	replay(html.s);
+
+	stop_name = "nav";
+	compare(html.s);
+	replay(html.s);
+	stop_name = NULL;
+
+	/*
+	 * A character token longer than a batch.
+	 */
+	html.len = 0;
+	for (p = "<p><title></"; *p != '\0'; p++)
+		str_add(&html, *p);
+	for (i = 0; i < 3 * PIPE_CHARS; i++)
+		str_add(&html, 'a');
+	for (p = "1 x</title><p>y"; *p != '\0'; p++)
+		str_add(&html, *p);
+	compare(html.s);
+	mem_free(html.s);
+	return 0;
+}
+#endif
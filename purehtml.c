@@ -0,0 +1,804 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "purehtml.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static double
+elapsed(const struct timespec *t0, const struct timespec *t1)
+{
+	return (t1->tv_sec - t0->tv_sec) + (t1->tv_nsec - t0->tv_nsec) / 1e9;
+}
+
+static double
+clock_cost(void)
+{
+	struct timespec t0, t1;
+	int i;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (i = 0; i < 1000; i++)
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+	return elapsed(&t0, &t1) / 1000;
+}
+
+/*
+ * token_clear() that gives the attributes of a tag token back to the
+ * pool if the dispatcher did not take them.
+ */
+static void
+clear_token(struct purehtml *ctx, struct token *token)
+{
+	if (!token->used && TOKEN_IS_START_END(token)) {
+		attr_pool_put(&ctx->attr_pool, token->u.tag.attr);
+		token->u.tag.attr = NULL;
+	}
+	token_clear(token);
+}
+
+static void
+loop(struct purehtml *ctx, int (*begin)(struct node *),
+    int (*end)(struct node *))
+{
+	struct token *token;
+	int state;
+
+	while (!INPUT_EOF(&ctx->tokenizer.input) && !ctx->dispatcher.stop) {
+		ctx->tokenizer.no_attrs = (ctx->dispatcher.skip != NULL);
+		token = tokenize(&ctx->tokenizer);
+		if (token != NULL) {
+			if (ctx->record != NULL)
+				tokenlog_put(ctx->record, token);
+			state = dispatch(&ctx->dispatcher, token, begin, end);
+			if (ctx->record != NULL)
+				tokenlog_put_state(ctx->record, state);
+			if (state != STATE_NONE)
+				ctx->tokenizer.state = state;
+			clear_token(ctx, token);
+		}
+	}
+}
+
+/*
+ * Like loop() but fills ctx->perf, see purehtml.h.
+ */
+static void
+loop_perf(struct purehtml *ctx, int (*begin)(struct node *),
+    int (*end)(struct node *))
+{
+	struct purehtml_perf *perf;
+	struct timespec t0, t1;
+	struct token *token;
+	size_t calls, ncalls, tokens, ntokens, depth;
+	double tok, disp;
+	int state;
+
+	perf = ctx->perf;
+	if (perf->clock == 0.0)
+		perf->clock = clock_cost();
+
+	calls = ncalls = tokens = ntokens = 0;
+	tok = disp = 0.0;
+	while (!INPUT_EOF(&ctx->tokenizer.input) && !ctx->dispatcher.stop) {
+		ctx->tokenizer.no_attrs = (ctx->dispatcher.skip != NULL);
+		if (calls++ % PERF_SAMPLE == 0) {
+			clock_gettime(CLOCK_MONOTONIC, &t0);
+			token = tokenize(&ctx->tokenizer);
+			clock_gettime(CLOCK_MONOTONIC, &t1);
+			tok += elapsed(&t0, &t1) - perf->clock;
+			ncalls++;
+		} else
+			token = tokenize(&ctx->tokenizer);
+		if (token == NULL)
+			continue;
+		if (ctx->record != NULL)
+			tokenlog_put(ctx->record, token);
+
+		if (tokens++ % PERF_SAMPLE == 0) {
+			clock_gettime(CLOCK_MONOTONIC, &t0);
+			state = dispatch(&ctx->dispatcher, token, begin, end);
+			clear_token(ctx, token);
+			clock_gettime(CLOCK_MONOTONIC, &t1);
+			disp += elapsed(&t0, &t1) - perf->clock;
+			ntokens++;
+		} else {
+			state = dispatch(&ctx->dispatcher, token, begin, end);
+			clear_token(ctx, token);
+		}
+		if (ctx->record != NULL)
+			tokenlog_put_state(ctx->record, state);
+		if (state != STATE_NONE)
+			ctx->tokenizer.state = state;
+
+		depth = ostack_depth(&ctx->dispatcher.ostack);
+		if (depth > perf->max_depth)
+			perf->max_depth = depth;
+	}
+
+	if (ncalls > 0 && tok > 0.0)
+		perf->tokenize += tok * calls / ncalls;
+	if (ntokens > 0 && disp > 0.0)
+		perf->dispatch += disp * tokens / ntokens;
+	perf->tokens += tokens;
+}
+
+static size_t
+run(struct purehtml *ctx, int (*begin)(struct node *),
+    int (*end)(struct node *))
+{
+	size_t offset;
+
+	ctx->dispatcher.document = &ctx->document;
+	ctx->tokenizer.report = ctx->dispatcher.report = &ctx->report;
+	ctx->tokenizer.attrs.pool = ctx->dispatcher.attr_pool =
+	    &ctx->attr_pool;
+	offset = ctx->tokenizer.offset;
+
+	if (ctx->perf != NULL)
+		loop_perf(ctx, begin, end);
+	else
+		loop(ctx, begin, end);
+
+	if (ctx->dispatcher.stop)
+		dispatch_unwind(&ctx->dispatcher);
+
+	/*
+	 * The pool is not for the threaded parsers, which may tokenize
+	 * with a copy of the tokenizer.
+	 */
+	ctx->tokenizer.attrs.pool = NULL;
+	ctx->dispatcher.attr_pool = NULL;
+
+	return ctx->tokenizer.offset - offset;
+}
+
+/*
+ * Returns the number of bytes consumed, which is less than the input
+ * size if a callback returned CB_STOP. The bytes read ahead of the stop
+ * are then given back to the stream, or if it cannot seek, e.g. a pipe,
+ * their number is left in ctx->lost.
+ */
+size_t
+purehtml_parse(struct purehtml *ctx, FILE *fp,
+    int (*begin)(struct node *), int (*end)(struct node *))
+{
+	struct input *in;
+	size_t consumed, ahead;
+
+	assert(fp != NULL);
+
+	in = &ctx->tokenizer.input;
+	input_file(in, fp);
+	consumed = run(ctx, begin, end);
+
+	ctx->lost = 0;
+	if (ctx->dispatcher.stop && (ahead = input_ahead(in)) > 0 &&
+	    fseek(fp, -(long) ahead, SEEK_CUR) == -1)
+		ctx->lost = ahead;
+
+	return consumed;
+}
+
+/*
+ * Like purehtml_parse() but tokenizes straight from a buffer.
+ */
+size_t
+purehtml_parse_buf(struct purehtml *ctx, const char *buf, size_t len,
+    int (*begin)(struct node *), int (*end)(struct node *))
+{
+	input_buf(&ctx->tokenizer.input, buf, len);
+	return run(ctx, begin, end);
+}
+
+/*
+ * Like purehtml_parse() but the input comes from a read callback, see
+ * input.h. The size of the refill buffer can be set in
+ * ctx->tokenizer.input.size before the first parse.
+ */
+size_t
+purehtml_parse_read(struct purehtml *ctx,
+    size_t (*read)(void *, char *, size_t), void *user,
+    int (*begin)(struct node *), int (*end)(struct node *))
+{
+	input_read(&ctx->tokenizer.input, read, user);
+	return run(ctx, begin, end);
+}
+
+/*
+ * Like purehtml_parse_buf() but maps the file into memory. The mapping
+ * is kept until purehtml_free(). Returns (size_t) -1 and sets errno if
+ * the file could not be mapped.
+ */
+size_t
+purehtml_parse_file(struct purehtml *ctx, const char *path,
+    int (*begin)(struct node *), int (*end)(struct node *))
+{
+	struct stat sb;
+	void *map;
+	int fd, saved;
+
+	assert(path != NULL);
+
+	if ((fd = open(path, O_RDONLY)) == -1)
+		return (size_t) -1;
+	if (fstat(fd, &sb) == -1) {
+		saved = errno;
+		close(fd);
+		errno = saved;
+		return (size_t) -1;
+	}
+
+	map = NULL;
+	if (sb.st_size > 0) {
+		map = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map == MAP_FAILED) {
+			saved = errno;
+			close(fd);
+			errno = saved;
+			return (size_t) -1;
+		}
+		posix_madvise(map, sb.st_size, POSIX_MADV_SEQUENTIAL);
+	}
+	close(fd);
+
+	if (ctx->map != NULL)
+		munmap(ctx->map, ctx->map_len);
+	ctx->map = map;
+	ctx->map_len = sb.st_size;
+
+	return purehtml_parse_buf(ctx, map, sb.st_size, begin, end);
+}
+
+/*
+ * Feed the tokens of a log, see tokenlog.h, to the dispatcher as if
+ * they came from the tokenizer. Returns the number of tokens whose
+ * state switch differs from the one in the log, which is 0 unless the
+ * dispatcher has changed since the log was recorded. The tokens
+ * dispatched are in log->tokens and log->error is set if the log is
+ * bad.
+ */
+size_t
+purehtml_replay(struct purehtml *ctx, struct tokenlog *log,
+    int (*begin)(struct node *), int (*end)(struct node *))
+{
+	struct token *token;
+	size_t differ;
+	int state, logged;
+
+	ctx->dispatcher.document = &ctx->document;
+	ctx->dispatcher.report = &ctx->report;
+
+	differ = 0;
+	while (!ctx->dispatcher.stop &&
+	    (token = tokenlog_get(log, &logged)) != NULL) {
+		state = dispatch(&ctx->dispatcher, token, begin, end);
+		if (state != logged)
+			differ++;
+	}
+
+	if (ctx->dispatcher.stop)
+		dispatch_unwind(&ctx->dispatcher);
+
+	return differ;
+}
+
+/*
+ * Make a used parser ready for the next document, as if it was new,
+ * but keep the buffers, the tables and the stack it has grown so far,
+ * so that parsing many documents with it stops allocating once they
+ * have all been grown. The error callback, ctx->perf, ctx->record, the
+ * input validation and the text settings of the dispatcher are kept as
+ * well.
+ */
+void
+purehtml_reset(struct purehtml *ctx)
+{
+	struct purehtml warm;
+	struct tokenizer *t;
+	struct dispatcher *d;
+
+	ctx->dispatcher.attr_pool = &ctx->attr_pool;
+	dispatch_unwind(&ctx->dispatcher);
+	clear_token(ctx, &ctx->tokenizer.token);
+	if (ctx->map != NULL)
+		munmap(ctx->map, ctx->map_len);
+
+	memset(&warm, 0, sizeof(struct purehtml));
+	t = &warm.tokenizer;
+	d = &warm.dispatcher;
+
+	t->name = ctx->tokenizer.name;
+	t->attrib_name = ctx->tokenizer.attrib_name;
+	t->attrib_value = ctx->tokenizer.attrib_value;
+	t->token.s = ctx->tokenizer.token.s;
+	t->attrs = ctx->tokenizer.attrs;
+	attr_index_clear(&t->attrs);
+	t->input.refill = ctx->tokenizer.input.refill;
+	t->input.size = ctx->tokenizer.input.size;
+	t->input.decoded = ctx->tokenizer.input.decoded;
+	t->input.validate = ctx->tokenizer.input.validate;
+	str_add(&t->name, '\0');
+	str_add(&t->attrib_name, '\0');
+	str_add(&t->attrib_value, '\0');
+	str_add(&t->token.s, '\0');
+
+	d->cdata_buf.data = ctx->dispatcher.cdata_buf.data;
+	d->views = ctx->dispatcher.views;
+	d->views_alloc = ctx->dispatcher.views_alloc;
+	d->ostack = ctx->dispatcher.ostack;
+	d->text = ctx->dispatcher.text;
+	d->text_max = ctx->dispatcher.text_max;
+	d->elide_space = ctx->dispatcher.elide_space;
+	str_add(&d->cdata_buf.data, '\0');
+
+	warm.report.error = ctx->report.error;
+	warm.report.user = ctx->report.user;
+	warm.attr_pool = ctx->attr_pool;
+	warm.perf = ctx->perf;
+	warm.record = ctx->record;
+
+	*ctx = warm;
+}
+
+/*
+ * Release everything held by the parser and leave it ready for
+ * parsing again.
+ */
+void
+purehtml_free(struct purehtml *ctx)
+{
+	dispatch_free(&ctx->dispatcher);
+	token_clear(&ctx->tokenizer.token);
+
+	if (ctx->map != NULL)
+		munmap(ctx->map, ctx->map_len);
+
+	input_free(&ctx->tokenizer.input);
+	mem_free(ctx->tokenizer.name.s);
+	mem_free(ctx->tokenizer.attrib_name.s);
+	mem_free(ctx->tokenizer.attrib_value.s);
+	mem_free(ctx->tokenizer.token.s.s);
+	attr_index_free(&ctx->tokenizer.attrs);
+	attr_pool_free(&ctx->attr_pool);
+
+	memset(ctx, 0, sizeof(struct purehtml));
+}
+
+#ifdef TEST
+#include "node.h"
+#include "elem.h"
+#include "cdata.h"
+
+#include <string.h>
+
+static struct str out;
+static struct node *kept;
+static const char *stop_name;
+static int elide;
+static int validate;
+
+static void
+out_add(const char *s)
+{
+	while (*s != '\0')
+		str_add(&out, *s++);
+}
+
+static int
+begin(struct node *node)
+{
+	if (node->type == NODE_ELEM) {
+		out_add("<");
+		out_add(node->u.elem->name);
+		if (node->u.elem->attr != NULL)
+			out_add(" @");
+		out_add(">");
+		if (kept == NULL && node->u.elem->attr != NULL)
+			kept = node_retain(node);
+		if (strcmp(node->u.elem->name, "nav") == 0 ||
+		    strcmp(node->u.elem->name, "script") == 0 ||
+		    strcmp(node->u.elem->name, "style") == 0 ||
+		    strcmp(node->u.elem->name, "li") == 0)
+			return CB_SKIP;
+	} else if (node->type == NODE_CDATA) {
+		out_add(node->u.cdata->data.s);
+		node_free(node);
+	}
+	return CB_CONTINUE;
+}
+
+static int
+end(struct node *node)
+{
+	int verdict;
+
+	verdict = CB_CONTINUE;
+	if (node->type == NODE_ELEM) {
+		out_add("</");
+		out_add(node->u.elem->name);
+		out_add(">");
+		if (stop_name != NULL &&
+		    strcmp(node->u.elem->name, stop_name) == 0)
+			verdict = CB_STOP;
+	} else if (node->type == NODE_CDATA)
+		out_add(node->u.cdata->data.s);
+	node_free(node);
+	return verdict;
+}
+
+static int
+text(struct node *node, int final)
+{
+	out_add(final ? "[" : "(");
+	out_add(node->u.cdata->data.s);
+	out_add(final ? "]" : ")");
+	return CB_CONTINUE;
+}
+
+static size_t
+parse_text(const char *html, const char *expect)
+{
+	static struct purehtml ctx;
+	FILE *fp;
+	size_t len;
+
+	purehtml_free(&ctx);
+	ctx.dispatcher.text = text;
+	ctx.dispatcher.text_max = 4;
+	str_add(&out, '\0');
+
+	fp = fmemopen((void *) html, strlen(html), "r");
+	assert(fp != NULL);
+	len = purehtml_parse(&ctx, fp, begin, end);
+	fclose(fp);
+
+	if (strcmp(out.s, expect) != 0) {
+		fprintf(stderr, "got:    %s\nexpect: %s\n", out.s, expect);
+		assert(0);
+	}
+
+	return len;
+}
+
+/*
+ * Collect the parse errors in the str of report.user.
+ */
+static void
+add_error(void *user, enum errors code, size_t line, size_t offset)
+{
+	struct str *errors = user;
+	char s[64];
+	const char *p;
+
+	snprintf(s, sizeof(s), "%zu:%zu:%s ", line, offset, report_name(code));
+	for (p = s; *p != '\0'; p++)
+		str_add(errors, *p);
+}
+
+/*
+ * Parse errors with their positions, returns their number.
+ */
+static size_t
+parse_errors(const char *html, const char *expect)
+{
+	static struct purehtml ctx;
+	struct str errors = { 0 };
+
+	purehtml_free(&ctx);
+	ctx.report.error = add_error;
+	ctx.report.user = &errors;
+	purehtml_parse_buf(&ctx, html, strlen(html), begin, end);
+	if (strcmp(errors.s, expect) != 0) {
+		fprintf(stderr, "got:    %s\nexpect: %s\n", errors.s, expect);
+		assert(0);
+	}
+	mem_free(errors.s);
+	return report_total(&ctx.report);
+}
+
+/*
+ * Live blocks of the counting allocator, and calls to it that allocate.
+ */
+static long live;
+static long allocs;
+
+static void *
+count_malloc(size_t size)
+{
+	live++;
+	allocs++;
+	return malloc(size);
+}
+
+static void *
+count_realloc(void *ptr, size_t size)
+{
+	if (ptr == NULL)
+		live++;
+	allocs++;
+	return realloc(ptr, size);
+}
+
+static void
+count_free(void *ptr)
+{
+	if (ptr != NULL)
+		live--;
+	free(ptr);
+}
+
+/*
+ * Parse with ctx->perf set and through the counting allocator, which
+ * must give the same result and leave nothing allocated.
+ */
+static void
+parse_perf(const char *html, const char *expect, size_t tokens,
+    size_t depth)
+{
+	static const struct allocator counting = { count_malloc,
+	    count_realloc, count_free };
+	struct purehtml ctx;
+	struct purehtml_perf perf;
+
+	memset(&ctx, 0, sizeof(struct purehtml));
+	memset(&perf, 0, sizeof(struct purehtml_perf));
+	ctx.perf = &perf;
+	purehtml_allocator(&counting);
+	str_add(&out, '\0');
+	purehtml_parse_buf(&ctx, html, strlen(html), begin, end);
+	purehtml_free(&ctx);
+	purehtml_allocator(NULL);
+
+	if (strcmp(out.s, expect) != 0) {
+		fprintf(stderr, "got:    %s\nexpect: %s\n", out.s, expect);
+		assert(0);
+	}
+	assert(perf.tokens == tokens);
+	assert(perf.max_depth == depth);
+	assert(perf.tokenize >= 0.0 && perf.dispatch >= 0.0);
+	assert(live == 0);
+}
+
+/*
+ * Parse the same document over and over with purehtml_reset() in
+ * between, which must give the same result every time and stop
+ * allocating once the recycled attribute buffers have grown to fit.
+ */
+static void
+parse_reset(const char *html, const char *expect)
+{
+	static const struct allocator counting = { count_malloc,
+	    count_realloc, count_free };
+	struct purehtml ctx;
+	long warm;
+	int i;
+
+	memset(&ctx, 0, sizeof(struct purehtml));
+	purehtml_allocator(&counting);
+	warm = 0;
+	for (i = 0; i < 8; i++) {
+		out.len = 0;
+		str_add(&out, '\0');
+		purehtml_parse_buf(&ctx, html, strlen(html), begin, end);
+		purehtml_reset(&ctx);
+		if (strcmp(out.s, expect) != 0) {
+			fprintf(stderr, "got:    %s\nexpect: %s\n", out.s,
+			    expect);
+			assert(0);
+		}
+		if (i == 2)
+			warm = allocs;
+	}
+	assert(allocs == warm);
+	purehtml_free(&ctx);
+	purehtml_allocator(NULL);
+	assert(live == 0);
+}
+
+/*
+ * Stop parsing a pipe, which cannot take back what was read ahead, and
+ * check that it is reported.
+ */
+static void
+parse_pipe(const char *html, const char *rest)
+{
+	static struct purehtml ctx;
+	char buf[256];
+	FILE *fp;
+	size_t n;
+	int fds[2];
+
+	assert(pipe(fds) == 0);
+	assert(write(fds[1], html, strlen(html)) == strlen(html));
+	close(fds[1]);
+	fp = fdopen(fds[0], "r");
+	assert(fp != NULL);
+
+	purehtml_free(&ctx);
+	str_add(&out, '\0');
+	purehtml_parse(&ctx, fp, begin, end);
+	n = fread(buf, 1, sizeof(buf) - 1, fp);
+	buf[n] = '\0';
+	fclose(fp);
+
+	assert(n + ctx.lost == strlen(rest));
+	assert(strcmp(buf, &rest[ctx.lost]) == 0);
+}
+
+/*
+ * Read a few bytes at a time.
+ */
+static size_t
+read_some(void *user, char *buf, size_t len)
+{
+	const char **p = user;
+	size_t n;
+
+	for (n = 0; n < len && **p != '\0'; n++)
+		buf[n] = *(*p)++;
+	return n;
+}
+
+/*
+ * Parse from a stream, from memory, from a mapped file and from a read
+ * callback, which must all give the same result.
+ */
+static size_t
+parse(const char *html, const char *expect)
+{
+	static struct purehtml ctx;
+	char path[] = "/tmp/purehtml.XXXXXX";
+	const char *p;
+	FILE *fp;
+	size_t len, i;
+	int fd;
+
+	fd = mkstemp(path);
+	assert(fd != -1);
+	assert(write(fd, html, strlen(html)) == strlen(html));
+	close(fd);
+
+	for (i = 0; i < 4; i++) {
+		purehtml_free(&ctx);
+		ctx.dispatcher.elide_space = elide;
+		ctx.tokenizer.input.validate = validate;
+		str_add(&out, '\0');
+
+		if (i == 0) {
+			fp = fmemopen((void *) html, strlen(html), "r");
+			assert(fp != NULL);
+			len = purehtml_parse(&ctx, fp, begin, end);
+			fclose(fp);
+		} else if (i == 1)
+			assert(purehtml_parse_buf(&ctx, html, strlen(html),
+			    begin, end) == len);
+		else if (i == 2)
+			assert(purehtml_parse_file(&ctx, path, begin, end) ==
+			    len);
+		else {
+			p = html;
+			ctx.tokenizer.input.size = 3;
+			assert(purehtml_parse_read(&ctx, read_some, &p, begin,
+			    end) == len);
+		}
+
+		if (strcmp(out.s, expect) != 0) {
+			fprintf(stderr, "got:    %s\nexpect: %s\n", out.s,
+			    expect);
+			assert(0);
+		}
+	}
+
+	unlink(path);
+	return len;
+}
+
+/*
+ * A parser used again without purehtml_reset() sniffs the encoding of
+ * the next input again, unless it was set.
+ */
+static void
+parse_again(int encoding, const char *html, const char *again,
+    const char *expect)
+{
+	static struct purehtml ctx;
+
+	purehtml_free(&ctx);
+	ctx.tokenizer.input.encoding = encoding;
+	purehtml_parse_buf(&ctx, html, strlen(html), begin, end);
+	str_add(&out, '\0');
+	purehtml_parse_buf(&ctx, again, strlen(again), begin, end);
+
+	if (strcmp(out.s, expect) != 0) {
+		fprintf(stderr, "got:    %s\nexpect: %s\n", out.s, expect);
+		assert(0);
+	}
+}
+
+int
+main(int argc, char **argv)
+{
+	parse("<body><nav a=\"b\"><nav><p>x</nav>y</nav>z</body>",
+	    "<html><head></head><body><nav @></nav>z</body>");
+	assert(kept != NULL && !kept->view);
+	assert(strcmp(kept->u.elem->name, "nav") == 0);
+	assert(strcmp(elem_attr_value(kept->u.elem, "a"), "b") == 0);
+	node_free(kept);
+	parse("<body><script>if (a</b) x='</scr';</script>z</body>",
+	    "<html><head></head><body><script></script>z</body>");
+	parse("<body><style>p{}</style>z</body>",
+	    "<html><head></head><body><style></style>z</body>");
+	parse("<body><nav><style>p::before{content:\"<nav>\"}</style>q</nav>"
+	    "z<p>after</p></body>",
+	    "<html><head></head><body><nav></nav>z<p>after</p></body>");
+	parse("<nav><script>w(\"</nav>\");</script>q</nav>z<p>a</p>",
+	    "<html><head></head><body><nav></nav>z<p>a</p>");
+	parse("<body><ul><li>a<b>c</b><li>b</ul></body>",
+	    "<html><head></head><body><ul><li></li><li></li></ul></body>");
+	parse_text("<body><p>abcdefghij</p><p>abcd</p><p>x</p></body>",
+	    "<html><head></head><body><p>(abcd)(efgh)[ij]</p>"
+	    "<p>(abcd)[]</p><p>[x]</p></body>");
+	elide = 1;
+	parse("<html> <head> <title> </title> </head>\n<body> <div>\n"
+	    "<b>a</b> <i>b</i>\n</div> <pre> </pre> <b>c</b> </body>",
+	    "<html><head><title></title></head><body><div><b>a</b> <i>b</i>"
+	    "</div><pre> </pre><b>c</b> </body>");
+	elide = 0;
+	parse("<meta charset=latin1><p>caf\xe9</p>",
+	    "<html><head><meta @></meta></head><body><p>caf\xc3\xa9</p>");
+	parse("\xef\xbb\xbf<p>\xe2\x82\xac</p>",
+	    "<html><head></head><body><p>\xe2\x82\xac</p>");
+	validate = 1;
+	parse("<meta charset=utf-8><p>a\xff\xc3\xa9\xe2\x82</p>",
+	    "<html><head><meta @></meta></head><body>"
+	    "<p>a\xef\xbf\xbd\xc3\xa9\xef\xbf\xbd</p>");
+	validate = 0;
+	parse_again(ENCODING_NONE, "<meta charset=latin1><p>a</p>",
+	    "<p>caf\xc3\xa9</p>", "<p>caf\xc3\xa9</p>");
+	parse_again(ENCODING_WINDOWS_1252, "<p>a</p>", "<p>caf\xe9</p>",
+	    "<p>caf\xc3\xa9</p>");
+	assert(parse_errors("<!DOCTYPE html><p a b=1 c=d'>x\n<!-->\n</i></b></body>",
+	    "1:28:unexpected-character-in-unquoted-attribute-value "
+	    "1:29:implied-head 2:36:abrupt-closing-of-empty-comment "
+	    "3:52:element-not-in-scope ") == 4);
+	parse_perf("<p><b><i>a</i></b></p><p>b</p>",
+	    "<html><head></head><body><p><b><i>a</i></b></p><p>b</p>",
+	    10, 5);
+	parse_reset("<!DOCTYPE html><p class=a id=b>x<my-tag x=1>y</my-tag>"
+	    "<div><b>z</b></div>",
+	    "<html><head></head><body><p @>x<CUSTOM_TAG @>y</CUSTOM_TAG></p>"
+	    "<div><b>z</b></div>");
+	stop_name = "head";
+	assert(parse("<title>a</title></head><body><p>b</p></body>",
+	    "<html><head><title>a</title></head>") ==
+	    strlen("<title>a</title></head>"));
+	parse_pipe("<title>a</title></head><body><p>b</p></body>",
+	    "<body><p>b</p></body>");
+	return 0;
+}
+#endif
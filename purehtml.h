@@ -0,0 +1,84 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef PUREHTML_H
+#define PUREHTML_H
+
+#include "tokenize.h"
+#include "dispatch.h"
+#include "document.h"
+#include "tokenlog.h"
+
+#include <stdio.h>
+
+struct node;
+
+/*
+ * Where the time of the serial parsers goes, filled if ctx->perf is
+ * set. One call in PERF_SAMPLE of tokenize() and dispatch() is timed
+ * and the times are scaled up, less the cost of reading the clock.
+ * The dispatch time includes the callbacks. Everything accumulates
+ * over parses.
+ */
+#define PERF_SAMPLE	32
+
+struct purehtml_perf {
+	double		 tokenize;	/* seconds */
+	double		 dispatch;	/* seconds */
+	double		 clock;		/* seconds per clock read */
+	size_t		 tokens;
+	size_t		 max_depth;	/* of open elements */
+};
+
+/*
+ * Convenience driver that ties the tokenizer and the dispatcher
+ * together and runs the tokenize() -> dispatch() loop.
+ */
+struct purehtml {
+	struct tokenizer	 tokenizer;
+	struct dispatcher	 dispatcher;
+	struct document		 document;
+	struct report		 report;	/* parse errors */
+	struct attr_pool	 attr_pool;	/* see purehtml_reset() */
+	struct purehtml_perf	*perf;		/* optional */
+	struct tokenlog		*record;	/* optional, see tokenlog.h */
+
+	size_t			 lost;		/* see purehtml_parse() */
+	void			*map;		/* see purehtml_parse_file() */
+	size_t			 map_len;
+};
+
+size_t	purehtml_parse(struct purehtml *, FILE *, int (*)(struct node *),
+	    int (*)(struct node *));
+size_t	purehtml_parse_buf(struct purehtml *, const char *, size_t,
+	    int (*)(struct node *), int (*)(struct node *));
+size_t	purehtml_parse_file(struct purehtml *, const char *,
+	    int (*)(struct node *), int (*)(struct node *));
+size_t	purehtml_parse_read(struct purehtml *,
+	    size_t (*)(void *, char *, size_t), void *,
+	    int (*)(struct node *), int (*)(struct node *));
+size_t	purehtml_parse_pipelined(struct purehtml *, FILE *,
+	    int (*)(struct node *), int (*)(struct node *));
+size_t	purehtml_parse_speculative(struct purehtml *, const char *, size_t,
+	    int, int (*)(struct node *), int (*)(struct node *));
+size_t	purehtml_replay(struct purehtml *, struct tokenlog *,
+	    int (*)(struct node *), int (*)(struct node *));
+void	purehtml_reset(struct purehtml *);
+void	purehtml_free(struct purehtml *);
+
+#endif
@@ -0,0 +1,113 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "report.h"
+#include "util.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <err.h>
+
+#include "errors.c"
+
+static void	enqueue(void *, enum errors, size_t, size_t);
+
+/*
+ * Returns the name of an error code, such as
+ * "missing-whitespace-between-attributes".
+ */
+const char *
+report_name(enum errors code)
+{
+	assert(code < NERRORS);
+
+	return errors[code];
+}
+
+size_t
+report_total(const struct report *report)
+{
+	size_t sum;
+	int i;
+
+	sum = 0;
+	for (i = 0; i < NERRORS; i++)
+		sum += report->count[i];
+	return sum;
+}
+
+static void
+enqueue(void *user, enum errors code, size_t line, size_t offset)
+{
+	struct report_queue *queue = user;
+	struct report_entry *entry;
+
+	if (queue->nentries == queue->alloc) {
+		queue->alloc = queue->alloc ? queue->alloc * 2 : 64;
+		queue->entries = mem_realloc(queue->entries,
+		    queue->alloc * sizeof(struct report_entry));
+		if (queue->entries == NULL)
+			err(1, "realloc report queue");
+	}
+
+	entry = &queue->entries[queue->nentries++];
+	entry->index = queue->index;
+	entry->code = code;
+	entry->line = line;
+	entry->offset = offset;
+}
+
+void
+report_queue_init(struct report_queue *queue)
+{
+	memset(queue, 0, sizeof(struct report_queue));
+	queue->report.error = enqueue;
+	queue->report.user = queue;
+}
+
+/*
+ * Report the errors that came with tokens up to index, adding line to
+ * their line numbers.
+ */
+void
+report_queue_flush(struct report_queue *queue, struct report *report,
+    size_t index, size_t line)
+{
+	struct report_entry *entry;
+
+	for (; queue->next < queue->nentries; queue->next++) {
+		entry = &queue->entries[queue->next];
+		if (entry->index > index)
+			break;
+		REPORT(report, entry->code, entry->line + line, entry->offset);
+	}
+}
+
+void
+report_queue_clear(struct report_queue *queue)
+{
+	queue->nentries = queue->next = queue->index = 0;
+}
+
+void
+report_queue_free(struct report_queue *queue)
+{
+	mem_free(queue->entries);
+	report_queue_init(queue);
+}
@@ -0,0 +1,84 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef REPORT_H
+#define REPORT_H
+
+#include "errors.h"
+
+#include <stddef.h>
+
+/*
+ * Parse errors of a document. Each is counted per code, which is all
+ * it costs unless the optional callback is set. The line is 1-based
+ * and the offset is in bytes of UTF-8 from the start of the input.
+ */
+struct report {
+	void	(*error)(void *user, enum errors code, size_t line,
+		    size_t offset);
+	void	*user;
+	size_t	 count[NERRORS];
+};
+
+/*
+ * A library built with -DPUREHTML_FAST reports nothing, not even the
+ * counts, for bulk extraction that has no use for them.
+ */
+#ifdef PUREHTML_FAST
+#define REPORT(_report, _code, _line, _offset)	do { } while (0)
+#else
+#define REPORT(_report, _code, _line, _offset) do { \
+	if ((_report) != NULL) { \
+		(_report)->count[(_code)]++; \
+		if ((_report)->error != NULL) \
+			(_report)->error((_report)->user, (_code), (_line), \
+			    (_offset)); \
+	} \
+} while (0)
+#endif
+
+/*
+ * Errors held back to be reported in order with the tokens they came
+ * with, when tokenizing ahead on another thread. Give the tokenizer
+ * queue->report and keep queue->index at the number of tokens so far.
+ */
+struct report_entry {
+	size_t		 index;		/* of the token */
+	enum errors	 code;
+	size_t		 line;
+	size_t		 offset;
+};
+
+struct report_queue {
+	struct report		 report;
+	struct report_entry	*entries;
+	size_t			 nentries;
+	size_t			 alloc;
+	size_t			 next;		/* to flush */
+	size_t			 index;
+};
+
+const char	*report_name(enum errors);
+size_t		 report_total(const struct report *);
+void		 report_queue_init(struct report_queue *);
+void		 report_queue_flush(struct report_queue *, struct report *,
+		    size_t, size_t);
+void		 report_queue_clear(struct report_queue *);
+void		 report_queue_free(struct report_queue *);
+
+#endif
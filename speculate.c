@@ -0,0 +1,721 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "purehtml.h"
+
+#include <pthread.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <errno.h>
+#include <err.h>
+
+/*
+ * Speculative parallel tokenization of a document in memory.
+ *
+ * The input is split into chunks just before something that looks like
+ * a tag, and worker threads tokenize the chunks in parallel guessing
+ * that each one begins in STATE_DATA. They also guess the state the
+ * dispatcher returns after each token.
+ *
+ * The calling thread then dispatches the chunks in order. The tokens
+ * of a chunk are accepted if the real tokenizer is in STATE_DATA where
+ * the chunk begins, and for as long as the state returned by dispatch()
+ * matches the guess. Otherwise the rest of the chunk is tokenized again
+ * by the real tokenizer, so the callbacks see the same tokens as with
+ * purehtml_parse().
+ */
+#define SPEC_CHUNK	(256 * 1024)
+#define SPEC_AHEAD	2		/* chunks in flight per thread */
+
+struct chunk {
+	size_t		 start;		/* input range */
+	size_t		 end;
+
+	struct token	*tokens;
+	size_t		*offsets;	/* offset after the token */
+	size_t		*text;		/* start of the token text in chars */
+	STATE		*guesses;	/* state guessed after the token */
+	size_t		 ntokens;
+	size_t		 alloc;
+	char		*chars;		/* text of the tokens */
+	size_t		 nchars;
+	size_t		 chars_alloc;
+
+	struct report_queue errors;	/* of the tokens */
+	struct tokenizer tokenizer;	/* state at the end of the chunk */
+	int		 done;
+};
+
+struct spec {
+	struct purehtml	*ctx;
+	const char	*buf;
+
+	struct chunk	*chunks;
+	size_t		 nchunks;
+	size_t		 next;		/* next chunk to tokenize */
+	size_t		 dispatched;	/* chunks dispatched so far */
+	size_t		 ahead;
+	size_t		 base;		/* offset where the buffer begins */
+	int		 encoding;	/* of the buffer, for retokenize() */
+
+	pthread_mutex_t	 lock;
+	pthread_cond_t	 cond;
+	int		 stop;
+};
+
+static size_t chunk_size = SPEC_CHUNK;
+
+/*
+ * The state dispatch() returns after a start tag, as far as we know.
+ * A wrong guess only costs tokenizing the rest of the chunk again.
+ */
+static STATE
+guess(struct token *token)
+{
+	if (!TOKEN_IS_START(token))
+		return STATE_NONE;
+
+	return dispatch_raw_state(token->u.tag.tagid);
+}
+
+/*
+ * While skipping, the dispatcher returns the SKIP_* variant of the raw
+ * text state for every token. That is the same as the raw text state
+ * at the start tag and no change elsewhere.
+ */
+static STATE
+actual(struct token *token, int state)
+{
+	switch (state) {
+	case STATE_SKIP_RCDATA:
+		return TOKEN_IS_START(token) ? STATE_RCDATA : STATE_NONE;
+	case STATE_SKIP_RAWTEXT:
+		return TOKEN_IS_START(token) ? STATE_RAWTEXT : STATE_NONE;
+	case STATE_SKIP_SCRIPT_DATA:
+		return TOKEN_IS_START(token) ? STATE_SCRIPT_DATA : STATE_NONE;
+	default:
+		return state;
+	}
+}
+
+static void
+tokenizer_free(struct tokenizer *tokenizer)
+{
+	token_clear(&tokenizer->token);
+	mem_free(tokenizer->name.s);
+	mem_free(tokenizer->attrib_name.s);
+	mem_free(tokenizer->attrib_value.s);
+	mem_free(tokenizer->token.s.s);
+	attr_index_free(&tokenizer->attrs);
+	input_free(&tokenizer->input);
+	memset(tokenizer, 0, sizeof(struct tokenizer));
+}
+
+/*
+ * Continue with the state, position and the token in progress of the
+ * tokenizer of a chunk. The input and the settings of ours stay, and
+ * our buffers go to the chunk to be freed with it.
+ */
+static void
+take_state(struct tokenizer *to, struct tokenizer *from, size_t line)
+{
+	struct tokenizer tmp;
+
+	to->state = from->state;
+	to->return_state = from->return_state;
+	to->line = from->line + line;
+	to->offset = from->offset;
+	memcpy(to->buf, from->buf, sizeof(to->buf));
+	to->buf_len = from->buf_len;
+	to->match = from->match;
+
+	tmp = *to;
+	to->name = from->name;
+	to->attrib_name = from->attrib_name;
+	to->attrib_value = from->attrib_value;
+	to->token = from->token;
+	to->attrs = from->attrs;
+	to->attrs.pool = tmp.attrs.pool;
+	from->name = tmp.name;
+	from->attrib_name = tmp.attrib_name;
+	from->attrib_value = tmp.attrib_value;
+	from->token = tmp.token;
+	from->attrs = tmp.attrs;
+	from->attrs.pool = NULL;
+}
+
+static void
+add_chunk_token(struct chunk *chunk, struct token *token, size_t offset,
+    STATE state)
+{
+	size_t n;
+
+	if (chunk->ntokens == chunk->alloc) {
+		chunk->alloc = chunk->alloc ? chunk->alloc * 2 : 1024;
+		chunk->tokens = mem_realloc(chunk->tokens,
+		    chunk->alloc * sizeof(struct token));
+		chunk->offsets = mem_realloc(chunk->offsets,
+		    chunk->alloc * sizeof(size_t));
+		chunk->text = mem_realloc(chunk->text,
+		    chunk->alloc * sizeof(size_t));
+		chunk->guesses = mem_realloc(chunk->guesses,
+		    chunk->alloc * sizeof(STATE));
+		if (chunk->tokens == NULL || chunk->offsets == NULL ||
+		    chunk->text == NULL || chunk->guesses == NULL)
+			err(1, "realloc chunk");
+	}
+
+	n = chunk->ntokens++;
+	chunk->tokens[n] = *token;
+	memset(&chunk->tokens[n].s, 0, sizeof(struct str));
+	chunk->offsets[n] = offset;
+	chunk->guesses[n] = state;
+	chunk->text[n] = chunk->nchars;
+	if (token->s.len > 0) {
+		while (chunk->nchars + token->s.len + 1 > chunk->chars_alloc) {
+			chunk->chars_alloc = chunk->chars_alloc ?
+			    chunk->chars_alloc * 2 : 4096;
+			chunk->chars = mem_realloc(chunk->chars,
+			    chunk->chars_alloc);
+			if (chunk->chars == NULL)
+				err(1, "realloc chunk");
+		}
+		memcpy(&chunk->chars[chunk->nchars], token->s.s,
+		    token->s.len + 1);
+		chunk->nchars += token->s.len + 1;
+		chunk->tokens[n].s.len = token->s.len;
+	}
+
+	chunk->errors.index = chunk->ntokens;
+
+	token->used = 1;
+	token_clear(token);
+	str_add(&token->s, '\0');
+}
+
+static void
+tokenize_chunk(struct spec *spec, struct chunk *chunk)
+{
+	struct tokenizer *tokenizer;
+	struct token *token;
+	STATE state;
+
+	tokenizer = &chunk->tokenizer;
+	tokenizer->state = STATE_DATA;
+	tokenizer->offset = spec->base + chunk->start;
+	tokenizer->input.encoding = ENCODING_UTF8;
+	report_queue_init(&chunk->errors);
+	tokenizer->report = &chunk->errors.report;
+	input_buf(&tokenizer->input, &spec->buf[chunk->start],
+	    chunk->end - chunk->start);
+
+	while (!INPUT_EOF(&tokenizer->input)) {
+		if ((token = tokenize(tokenizer)) == NULL)
+			continue;
+		state = guess(token);
+		add_chunk_token(chunk, token, tokenizer->offset, state);
+		if (state != STATE_NONE)
+			tokenizer->state = state;
+	}
+}
+
+static void *
+tokenize_chunks(void *arg)
+{
+	struct spec *spec = arg;
+	struct chunk *chunk;
+	size_t i;
+
+	for (;;) {
+		pthread_mutex_lock(&spec->lock);
+		while (spec->next < spec->nchunks && !spec->stop &&
+		    spec->next >= spec->dispatched + spec->ahead)
+			pthread_cond_wait(&spec->cond, &spec->lock);
+		if (spec->next == spec->nchunks || spec->stop) {
+			pthread_mutex_unlock(&spec->lock);
+			return NULL;
+		}
+		i = spec->next++;
+		pthread_mutex_unlock(&spec->lock);
+
+		chunk = &spec->chunks[i];
+		tokenize_chunk(spec, chunk);
+
+		pthread_mutex_lock(&spec->lock);
+		chunk->done = 1;
+		pthread_cond_broadcast(&spec->cond);
+		pthread_mutex_unlock(&spec->lock);
+	}
+}
+
+static void
+free_chunk(struct chunk *chunk, size_t from)
+{
+	size_t i;
+
+	for (i = from; i < chunk->ntokens; i++)
+		token_clear(&chunk->tokens[i]);
+	mem_free(chunk->tokens);
+	mem_free(chunk->offsets);
+	mem_free(chunk->text);
+	mem_free(chunk->guesses);
+	mem_free(chunk->chars);
+	report_queue_free(&chunk->errors);
+	tokenizer_free(&chunk->tokenizer);
+}
+
+/*
+ * Tokenize the input range with the real tokenizer.
+ */
+static void
+retokenize(struct spec *spec, size_t start, size_t end,
+    int (*begin)(struct node *), int (*end_cb)(struct node *))
+{
+	struct purehtml *ctx;
+	struct token *token;
+	int state;
+
+	ctx = spec->ctx;
+	input_buf(&ctx->tokenizer.input, &spec->buf[start], end - start);
+	ctx->tokenizer.input.encoding = spec->encoding;
+	ctx->tokenizer.offset = spec->base + start;
+
+	while (!INPUT_EOF(&ctx->tokenizer.input) && !ctx->dispatcher.stop) {
+		if ((token = tokenize(&ctx->tokenizer)) == NULL)
+			continue;
+		if (ctx->record != NULL)
+			tokenlog_put(ctx->record, token);
+		state = dispatch(&ctx->dispatcher, token, begin, end_cb);
+		if (ctx->record != NULL)
+			tokenlog_put_state(ctx->record, state);
+		if (state != STATE_NONE)
+			ctx->tokenizer.state = state;
+		token_clear(token);
+	}
+}
+
+/*
+ * Dispatch the guessed tokens of a chunk, or as many of them as were
+ * guessed right. Returns 0 if the rest of the chunk has to be
+ * tokenized again from ctx->tokenizer.offset.
+ */
+static int
+accept_chunk(struct spec *spec, struct chunk *chunk,
+    int (*begin)(struct node *), int (*end)(struct node *))
+{
+	struct purehtml *ctx;
+	struct token *token;
+	size_t i, line;
+	STATE state;
+
+	ctx = spec->ctx;
+	line = ctx->tokenizer.line;
+
+	for (i = 0; i < chunk->ntokens && !ctx->dispatcher.stop; i++) {
+		token = &chunk->tokens[i];
+		if (token->s.len > 0)
+			token->s.s = &chunk->chars[chunk->text[i]];
+		token->end_line += line;
+		report_queue_flush(&chunk->errors, &ctx->report, i, line);
+
+		if (ctx->record != NULL)
+			tokenlog_put(ctx->record, token);
+		state = dispatch(&ctx->dispatcher, token, begin, end);
+		if (ctx->record != NULL)
+			tokenlog_put_state(ctx->record, state);
+		state = actual(token, state);
+		token_clear(token);
+		ctx->tokenizer.offset = chunk->offsets[i];
+
+		if (state != chunk->guesses[i]) {
+			/*
+			 * Tokens end in STATE_DATA unless the dispatcher
+			 * says otherwise.
+			 */
+			ctx->tokenizer.state = (state != STATE_NONE) ?
+			    state : STATE_DATA;
+			ctx->tokenizer.line = token->end_line;
+			free_chunk(chunk, i + 1);
+			return 0;
+		}
+	}
+
+	if (ctx->dispatcher.stop) {
+		free_chunk(chunk, i);
+		return 1;
+	}
+
+	/*
+	 * The chunk may end in the middle of a token, so continue where
+	 * the tokenizer that tokenized it left off.
+	 */
+	report_queue_flush(&chunk->errors, &ctx->report, chunk->ntokens, line);
+	take_state(&ctx->tokenizer, &chunk->tokenizer, line);
+	free_chunk(chunk, chunk->ntokens);
+	return 1;
+}
+
+/*
+ * Split at something that looks like a start or an end tag.
+ */
+static size_t
+split(const char *buf, size_t len, size_t at)
+{
+	for (; at + 1 < len; at++)
+		if (buf[at] == '<' && (isalpha((unsigned char) buf[at + 1]) ||
+		    buf[at + 1] == '/'))
+			return at;
+	return len;
+}
+
+/*
+ * Like purehtml_parse() but for a document in memory, tokenizing it in
+ * parallel on nthreads threads (online CPUs if zero). The dispatcher
+ * and the callbacks run on the calling thread, and the tokens go to
+ * ctx->record as they are dispatched. ctx->perf must not be set, as
+ * the tokenizers run on other clocks. Attributes are collected in
+ * skipped subtrees too.
+ */
+size_t
+purehtml_parse_speculative(struct purehtml *ctx, const char *buf,
+    size_t len, int nthreads, int (*begin)(struct node *),
+    int (*end)(struct node *))
+{
+	struct spec spec;
+	struct chunk *chunk;
+	pthread_t *threads;
+	size_t i, n, at, start, consumed;
+	char *utf8;
+	long ncpu;
+	int encoding;
+
+	assert(ctx->perf == NULL);
+
+	if (nthreads <= 0 && (ncpu = sysconf(_SC_NPROCESSORS_ONLN)) > 0)
+		nthreads = ncpu;
+	if (nthreads <= 0)
+		nthreads = 1;
+
+	/*
+	 * Chunks are split in UTF-8.
+	 */
+	input_buf(&ctx->tokenizer.input, buf, len);
+	encoding = ctx->tokenizer.input.encoding;
+	utf8 = input_utf8(&ctx->tokenizer.input, &buf, &len);
+
+	memset(&spec, 0, sizeof(struct spec));
+	spec.ctx = ctx;
+	spec.buf = buf;
+	spec.ahead = nthreads * SPEC_AHEAD;
+	spec.base = ctx->tokenizer.offset;
+	spec.encoding = ctx->tokenizer.input.encoding;
+
+	for (at = 0; at < len; at = split(buf, len, at + chunk_size)) {
+		spec.chunks = mem_realloc(spec.chunks,
+		    (spec.nchunks + 1) * sizeof(struct chunk));
+		if (spec.chunks == NULL)
+			err(1, "realloc chunks");
+		chunk = &spec.chunks[spec.nchunks++];
+		memset(chunk, 0, sizeof(struct chunk));
+		chunk->start = at;
+		chunk->end = split(buf, len, at + chunk_size);
+	}
+
+	if ((errno = pthread_mutex_init(&spec.lock, NULL)) != 0)
+		err(1, "pthread_mutex_init");
+	if ((errno = pthread_cond_init(&spec.cond, NULL)) != 0)
+		err(1, "pthread_cond_init");
+	if ((threads = mem_calloc(nthreads, sizeof(pthread_t))) == NULL)
+		err(1, "calloc threads");
+	for (i = 0; i < (size_t) nthreads; i++)
+		if ((errno = pthread_create(&threads[i], NULL, tokenize_chunks,
+		    &spec)) != 0)
+			err(1, "pthread_create");
+
+	ctx->dispatcher.document = &ctx->document;
+	ctx->tokenizer.report = ctx->dispatcher.report = &ctx->report;
+	ctx->tokenizer.no_attrs = 0;
+	start = ctx->tokenizer.offset;
+
+	for (n = 0; n < spec.nchunks && !ctx->dispatcher.stop; n++) {
+		chunk = &spec.chunks[n];
+
+		pthread_mutex_lock(&spec.lock);
+		while (!chunk->done)
+			pthread_cond_wait(&spec.cond, &spec.lock);
+		pthread_mutex_unlock(&spec.lock);
+
+		/*
+		 * The guesses hold only if the chunk begins in data.
+		 */
+		if (ctx->tokenizer.state != STATE_DATA) {
+			free_chunk(chunk, 0);
+			retokenize(&spec, chunk->start, chunk->end, begin, end);
+		} else if (!accept_chunk(&spec, chunk, begin, end))
+			retokenize(&spec, ctx->tokenizer.offset - spec.base,
+			    chunk->end, begin, end);
+
+		pthread_mutex_lock(&spec.lock);
+		spec.dispatched = n + 1;
+		if (ctx->dispatcher.stop)
+			spec.stop = 1;
+		pthread_cond_broadcast(&spec.cond);
+		pthread_mutex_unlock(&spec.lock);
+	}
+
+	for (i = 0; i < (size_t) nthreads; i++)
+		pthread_join(threads[i], NULL);
+
+	/*
+	 * Chunks tokenized ahead of a stop.
+	 */
+	for (; n < spec.nchunks; n++)
+		if (spec.chunks[n].done)
+			free_chunk(&spec.chunks[n], 0);
+
+	consumed = ctx->tokenizer.offset;
+	if (ctx->dispatcher.stop)
+		dispatch_unwind(&ctx->dispatcher);
+
+	/*
+	 * Nothing of the buffer or the encoding of this document stays in
+	 * the input of the caller.
+	 */
+	input_buf(&ctx->tokenizer.input, NULL, 0);
+	ctx->tokenizer.input.encoding = encoding;
+
+	mem_free(threads);
+	mem_free(spec.chunks);
+	mem_free(utf8);
+	pthread_cond_destroy(&spec.cond);
+	pthread_mutex_destroy(&spec.lock);
+
+	return consumed - start;
+}
+
+#ifdef TEST
+#include "node.h"
+#include "elem.h"
+#include "cdata.h"
+
+static struct str out;
+static const char *stop_name;
+
+static void
+out_add(const char *s)
+{
+	while (*s != '\0')
+		str_add(&out, *s++);
+}
+
+static void
+add_error(void *user, enum errors code, size_t line, size_t offset)
+{
+	char s[64];
+
+	snprintf(s, sizeof(s), "{%zu:%zu:%s}", line, offset,
+	    report_name(code));
+	out_add(s);
+}
+
+static int
+begin(struct node *node)
+{
+	if (node->type == NODE_ELEM) {
+		out_add("<");
+		out_add(node->u.elem->name);
+		out_add(">");
+		if (strcmp(node->u.elem->name, "nav") == 0 ||
+		    strcmp(node->u.elem->name, "style") == 0)
+			return CB_SKIP;
+	} else
+		out_add(node->u.cdata->data.s);
+	return CB_CONTINUE;
+}
+
+static int
+end(struct node *node)
+{
+	if (node->type == NODE_ELEM) {
+		out_add("</");
+		out_add(node->u.elem->name);
+		out_add(">");
+		if (stop_name != NULL &&
+		    strcmp(node->u.elem->name, stop_name) == 0)
+			return CB_STOP;
+	} else
+		out_add(node->u.cdata->data.s);
+	return CB_CONTINUE;
+}
+
+/*
+ * Must give the same callbacks and length as purehtml_parse().
+ */
+static void
+compare(const char *html, int nthreads)
+{
+	static struct purehtml ctx;
+	FILE *fp;
+	char *expect;
+	size_t len;
+
+	purehtml_free(&ctx);
+	ctx.report.error = add_error;
+	str_add(&out, '\0');
+	fp = fmemopen((void *) html, strlen(html), "r");
+	assert(fp != NULL);
+	len = purehtml_parse(&ctx, fp, begin, end);
+	fclose(fp);
+	expect = mem_strdup(out.s);
+	assert(expect != NULL);
+
+	purehtml_free(&ctx);
+	ctx.report.error = add_error;
+	str_add(&out, '\0');
+	assert(purehtml_parse_speculative(&ctx, html, strlen(html), nthreads,
+	    begin, end) == len);
+
+	if (strcmp(out.s, expect) != 0) {
+		fprintf(stderr, "got:    %s\nexpect: %s\n", out.s, expect);
+		assert(0);
+	}
+	mem_free(expect);
+	purehtml_free(&ctx);
+}
+
+/*
+ * The input settings of the caller survive, and nothing of the
+ * document stays in the input.
+ */
+static void
+keep_input(void)
+{
+	static const char html[] =
+	    "<meta charset=iso-8859-1><p a=\"\xe9\">\xe9<b>x</b></p>";
+	struct purehtml ctx = { 0 };
+
+	ctx.tokenizer.input.validate = 1;
+	ctx.tokenizer.input.size = 7;
+	ctx.tokenizer.attrs.pool = &ctx.attr_pool;
+	str_add(&out, '\0');
+	purehtml_parse_speculative(&ctx, html, strlen(html), 2, begin, end);
+	assert(strstr(out.s, "\xc3\xa9") != NULL);
+	assert(ctx.tokenizer.input.validate == 1);
+	assert(ctx.tokenizer.input.size == 7);
+	assert(ctx.tokenizer.input.encoding == ENCODING_NONE);
+	assert(ctx.tokenizer.input.src == NULL);
+	assert(ctx.tokenizer.attrs.pool == &ctx.attr_pool);
+	purehtml_free(&ctx);
+}
+
+static size_t
+read_mem(void *user, char *buf, size_t len)
+{
+	return fread(buf, 1, len, user);
+}
+
+/*
+ * The tokens recorded from a speculative parse must replay to the same
+ * callbacks.
+ */
+static void
+replay(const char *html, int nthreads)
+{
+	struct purehtml ctx;
+	struct tokenlog log;
+	char *buf, *expect;
+	size_t len;
+	FILE *fp;
+
+	memset(&ctx, 0, sizeof(struct purehtml));
+	fp = open_memstream(&buf, &len);
+	assert(fp != NULL);
+	tokenlog_record(&log, fp);
+	ctx.record = &log;
+	str_add(&out, '\0');
+	purehtml_parse_speculative(&ctx, html, strlen(html), nthreads, begin,
+	    end);
+	purehtml_free(&ctx);
+	assert(log.error == NULL);
+	tokenlog_free(&log);
+	fclose(fp);
+	expect = mem_strdup(out.s);
+	assert(expect != NULL);
+
+	fp = fmemopen(buf, len, "r");
+	assert(fp != NULL);
+	tokenlog_init(&log, read_mem, fp);
+	str_add(&out, '\0');
+	assert(purehtml_replay(&ctx, &log, begin, end) == 0);
+	assert(log.error == NULL);
+	purehtml_free(&ctx);
+	fclose(fp);
+
+	if (strcmp(out.s, expect) != 0) {
+		fprintf(stderr, "got:    %s\nexpect: %s\n", out.s, expect);
+		assert(0);
+	}
+	tokenlog_free(&log);
+	mem_free(expect);
+	free(buf);
+}
+
+int
+main(int argc, char **argv)
+{
+	static const char part[] =
+	    "<div title=\"a <b>\"><p>a &amp; <b>b</b> c</p><title>x<b>y</title>"
+	    "<script>if (a</b) x='<p></scr';</script>"
+	    "<style>p</b>{}</style><nav><p>n<script>y</script></nav>"
+	    "<!-- <p> --><ul><li>a<li>b</ul><textarea>t<b></textarea></div>\n"
+	    "<p a b=1 c=d'>x</i><!--></p>\n";
+	static const size_t sizes[] = { 1, 7, 16, 100, SPEC_CHUNK };
+	struct str html = { 0 };
+	const char *p;
+	size_t i;
+	int j;
+
+	for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		chunk_size = sizes[i];
+		compare("<title>a</title><body><p>b</p></body>", 2);
+		compare(part, 3);
+	}
+
+	for (j = 0; j < 200; j++)
+		for (p = part; *p != '\0'; p++)
+			str_add(&html, *p);
+	for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		chunk_size = sizes[i];
+		stop_name = NULL;
+		compare(html.s, 4);
+		replay(html.s, 4);
+		stop_name = "nav";
+		compare(html.s, 4);
+		replay(html.s, 4);
+	}
+	mem_free(html.s);
+
+	chunk_size = 16;
+	keep_input();
+	mem_free(out.s);
+	return 0;
+}
+#endif
@@ -0,0 +1,62 @@
+/* generated by enum.awk */
+static const char *states[] = {
+	"DATA",
+	"NONE",
+	"RCDATA",
+	"RCDATA_LT",
+	"RCDATA_END_TAG_OPEN",
+	"RCDATA_END_TAG_NAME",
+	"RAWTEXT",
+	"RAWTEXT_LT",
+	"RAWTEXT_END_TAG_OPEN",
+	"RAWTEXT_END_TAG_NAME",
+	"PLAINTEXT",
+	"TAG_OPEN",
+	"END_TAG_OPEN",
+	"TAG_NAME",
+	"BEFORE_ATTRIB_NAME",
+	"ATTRIB_NAME",
+	"AFTER_ATTRIB_NAME",
+	"BEFORE_ATTRIB_VAL",
+	"ATTRIB_VAL_QUOTED",
+	"ATTRIB_VAL_SQUOTED",
+	"ATTRIB_VAL",
+	"AFTER_ATTRIB_VAL_QUOTED",
+	"MARKUP_DECLARATION_OPEN",
+	"CHARACTER_REFERENCE",
+	"NAMED_CHAR_REF",
+	"NUM_CHAR_REF",
+	"COMMENT_START",
+	"COMMENT_START_DASH",
+	"COMMENT",
+	"COMMENT_LT",
+	"COMMENT_LT_BANG",
+	"COMMENT_LT_BANG_DASH",
+	"COMMENT_LT_BANG_DASH2",
+	"COMMENT_END_DASH",
+	"COMMENT_END",
+	"COMMENT_END_BANG",
+	"BOGUS_COMMENT",
+	"DOCTYPE",
+	"BEFORE_DOCTYPE_NAME",
+	"DOCTYPE_NAME",
+	"AFTER_DOCTYPE_NAME",
+	"BOGUS_DOCTYPE",
+	"SELF_CLOSING_START_TAG",
+	"SCRIPT_DATA",
+	"SCRIPT_DATA_LT",
+	"SCRIPT_DATA_ESC_START",
+	"SCRIPT_DATA_ESC_START_DASH",
+	"SCRIPT_DATA_ESC_DASH",
+	"SCRIPT_DATA_ESC_DASH2",
+	"SCRIPT_DATA_ESC_LT",
+	"SCRIPT_DATA_ESC_END_TAG_OPEN",
+	"SCRIPT_DATA_ESC_END_TAG_NAME",
+	"SCRIPT_DATA_DBL_ESC_START",
+	"SCRIPT_DATA_ESC",
+	"SCRIPT_DATA_END_TAG_OPEN",
+	"SCRIPT_DATA_END_TAG_NAME",
+	"SKIP_RCDATA",
+	"SKIP_RAWTEXT",
+	"SKIP_SCRIPT_DATA",
+};
@@ -0,0 +1,66 @@
+/* generated by enum.awk */
+#ifndef STATES_H
+#define STATES_H
+enum states {
+	STATE_DATA,
+	STATE_NONE,
+	STATE_RCDATA,
+	STATE_RCDATA_LT,
+	STATE_RCDATA_END_TAG_OPEN,
+	STATE_RCDATA_END_TAG_NAME,
+	STATE_RAWTEXT,
+	STATE_RAWTEXT_LT,
+	STATE_RAWTEXT_END_TAG_OPEN,
+	STATE_RAWTEXT_END_TAG_NAME,
+	STATE_PLAINTEXT,
+	STATE_TAG_OPEN,
+	STATE_END_TAG_OPEN,
+	STATE_TAG_NAME,
+	STATE_BEFORE_ATTRIB_NAME,
+	STATE_ATTRIB_NAME,
+	STATE_AFTER_ATTRIB_NAME,
+	STATE_BEFORE_ATTRIB_VAL,
+	STATE_ATTRIB_VAL_QUOTED,
+	STATE_ATTRIB_VAL_SQUOTED,
+	STATE_ATTRIB_VAL,
+	STATE_AFTER_ATTRIB_VAL_QUOTED,
+	STATE_MARKUP_DECLARATION_OPEN,
+	STATE_CHARACTER_REFERENCE,
+	STATE_NAMED_CHAR_REF,
+	STATE_NUM_CHAR_REF,
+	STATE_COMMENT_START,
+	STATE_COMMENT_START_DASH,
+	STATE_COMMENT,
+	STATE_COMMENT_LT,
+	STATE_COMMENT_LT_BANG,
+	STATE_COMMENT_LT_BANG_DASH,
+	STATE_COMMENT_LT_BANG_DASH2,
+	STATE_COMMENT_END_DASH,
+	STATE_COMMENT_END,
+	STATE_COMMENT_END_BANG,
+	STATE_BOGUS_COMMENT,
+	STATE_DOCTYPE,
+	STATE_BEFORE_DOCTYPE_NAME,
+	STATE_DOCTYPE_NAME,
+	STATE_AFTER_DOCTYPE_NAME,
+	STATE_BOGUS_DOCTYPE,
+	STATE_SELF_CLOSING_START_TAG,
+	STATE_SCRIPT_DATA,
+	STATE_SCRIPT_DATA_LT,
+	STATE_SCRIPT_DATA_ESC_START,
+	STATE_SCRIPT_DATA_ESC_START_DASH,
+	STATE_SCRIPT_DATA_ESC_DASH,
+	STATE_SCRIPT_DATA_ESC_DASH2,
+	STATE_SCRIPT_DATA_ESC_LT,
+	STATE_SCRIPT_DATA_ESC_END_TAG_OPEN,
+	STATE_SCRIPT_DATA_ESC_END_TAG_NAME,
+	STATE_SCRIPT_DATA_DBL_ESC_START,
+	STATE_SCRIPT_DATA_ESC,
+	STATE_SCRIPT_DATA_END_TAG_OPEN,
+	STATE_SCRIPT_DATA_END_TAG_NAME,
+	STATE_SKIP_RCDATA,
+	STATE_SKIP_RAWTEXT,
+	STATE_SKIP_SCRIPT_DATA,
+	NSTATES
+};
+#endif
@@ -0,0 +1,72 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "stats.h"
+
+#include <string.h>
+#include <assert.h>
+
+#include "states.c"
+#include "imodes.c"
+#include "allocs.c"
+
+#ifdef PUREHTML_STATS
+struct purehtml_stats stats_counters;
+#endif
+
+/*
+ * Returns the counters, or NULL if the library was built without them.
+ */
+const struct purehtml_stats *
+purehtml_stats(void)
+{
+#ifdef PUREHTML_STATS
+	return &stats_counters;
+#else
+	return NULL;
+#endif
+}
+
+void
+purehtml_stats_reset(void)
+{
+#ifdef PUREHTML_STATS
+	memset(&stats_counters, 0, sizeof(struct purehtml_stats));
+#endif
+}
+
+const char *
+stats_state_name(int state)
+{
+	assert(state >= 0 && state < NSTATES);
+	return states[state];
+}
+
+const char *
+stats_imode_name(int mode)
+{
+	assert(mode >= 0 && mode < NIMODES);
+	return imodes[mode];
+}
+
+const char *
+stats_alloc_name(int type)
+{
+	assert(type >= 0 && type < NALLOCS);
+	return allocs[type];
+}
@@ -0,0 +1,57 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include "states.h"
+#include "imodes.h"
+#include "allocs.h"
+
+#include <stddef.h>
+
+/*
+ * Counters of the hot paths of the tokenizer and the dispatcher. They
+ * are kept only if the library is built with -DPUREHTML_STATS, and are
+ * global and unsynchronized, so they are exact only when one thread
+ * parses at a time.
+ */
+struct purehtml_stats {
+	size_t	 bytes[NSTATES];	/* consumed in each state */
+	size_t	 reconsumes;
+	size_t	 tokens[NIMODES];	/* handled in each mode */
+	size_t	 scope_checks;		/* has_element_in_scope() calls */
+	size_t	 scope_scanned;		/* open elements looked at */
+	size_t	 allocs[NALLOCS];
+};
+
+#ifdef PUREHTML_STATS
+#define STATS_ADD(_field, _n)	(stats_counters._field += (_n))
+
+extern struct purehtml_stats	 stats_counters;
+#else
+#define STATS_ADD(_field, _n)	do { } while (0)
+#endif
+
+const struct purehtml_stats	*purehtml_stats(void);
+void				 purehtml_stats_reset(void);
+const char			*stats_state_name(int);
+const char			*stats_imode_name(int);
+const char			*stats_alloc_name(int);
+
+#endif
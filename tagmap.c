@@ -24,8 +24,6 @@
 
 #include "tags.c"
 
-#define TAGMAP_SZ 1024
-
 const struct tag *
 tagmap(int i)
 {
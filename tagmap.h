@@ -21,13 +21,17 @@
 
 #include "tags.h"
 
+#define TAGMAP_SZ 1024		/* tag ids are below */
+
 typedef enum tag_flags {
 	TAG_EMPTY = (1 << 0),
 	TAG_OPTIONAL_CLOSE = (1 << 1),
 	TAG_BLOCK = (1 << 2),
 	TAG_SPECIAL = (1 << 3),
 	TAG_HEADING = (1 << 4),
-	TAG_FORMAT = (1 << 5)
+	TAG_FORMAT = (1 << 5),
+	TAG_PREFORMATTED = (1 << 6),
+	TAG_RAWTEXT = (1 << 7)
 } TAG_FLAGS;
 
 struct tag {
@@ -21,6 +21,10 @@ BEGIN {
 			flags = flags "TAG_HEADING";
 		if (substr($2,i,1) ~ /f/)
 			flags = flags "TAG_FORMAT";
+		if (substr($2,i,1) ~ /w/)
+			flags = flags "TAG_PREFORMATTED";
+		if (substr($2,i,1) ~ /r/)
+			flags = flags "TAG_RAWTEXT";
 	}
 	if (length($2) == 0)
 		flags = "0";
@@ -0,0 +1,141 @@
+/* generated by tags.awk */
+enum tagid {
+	TAG_NOFRAMES=3,
+	TAG_Q=9,
+	TAG_H5=21,
+	TAG_FRAMESET=23,
+	TAG_VAR=25,
+	TAG_ASIDE=30,
+	TAG_SLOT=50,
+	TAG_NAV=53,
+	TAG_FIGURE=58,
+	TAG_EM=59,
+	TAG_COMMENT_TAG=78,
+	TAG_SCRIPT=85,
+	TAG_EXCLAIM_TAG=86,
+	TAG_TR=87,
+	TAG_THEAD=94,
+	TAG_BR=100,
+	TAG_U=109,
+	TAG_ARTICLE=124,
+	TAG_CANVAS=140,
+	TAG_WBR=147,
+	TAG_METER=149,
+	TAG_LINK=158,
+	TAG_TIME=159,
+	TAG_PLAINTEXT=169,
+	TAG_COLGROUP=179,
+	TAG_TFOOT=180,
+	TAG_TITLE=186,
+	TAG_KBD=201,
+	TAG_H2=202,
+	TAG_OUTPUT=203,
+	TAG_IMG=221,
+	TAG_DIALOG=224,
+	TAG_AUDIO=226,
+	TAG_CODE=235,
+	TAG_STRONG=237,
+	TAG_TD=248,
+	TAG_DATA=250,
+	TAG_BODY=254,
+	TAG_CENTER=265,
+	TAG_TABLE=272,
+	TAG_CAPTION=286,
+	TAG_PRE=287,
+	TAG_BASE=299,
+	TAG_H6=302,
+	TAG_SVG=304,
+	TAG_OPTGROUP=305,
+	TAG_STRIKE=306,
+	TAG_BASEFONT=314,
+	TAG_RP=322,
+	TAG_DFN=328,
+	TAG_SECTION=333,
+	TAG_AREA=337,
+	TAG_MENU=341,
+	TAG_TH=348,
+	TAG_BDO=365,
+	TAG_FORM=388,
+	TAG_MATH=402,
+	TAG_MAP=406,
+	TAG_STYLE=409,
+	TAG_HEADER=417,
+	TAG_BGSOUND=418,
+	TAG_RT=422,
+	TAG_BLOCKQUOTE=425,
+	TAG_PARAM=426,
+	TAG_APPLET=454,
+	TAG_FRAME=459,
+	TAG_TBODY=466,
+	TAG_CUSTOM_TAG=478,
+	TAG_LABEL=480,
+	TAG_H3=483,
+	TAG_RB=484,
+	TAG_DD=488,
+	TAG_ACRONYM=505,
+	TAG_META=519,
+	TAG_SUMMARY=526,
+	TAG_ABBR=535,
+	TAG_HTML=549,
+	TAG_OBJECT=559,
+	TAG_UL=561,
+	TAG_S=571,
+	TAG_NOSCRIPT=586,
+	TAG_FIGCAPTION=588,
+	TAG_RUBY=610,
+	TAG_DATALIST=622,
+	TAG_A=633,
+	TAG_INS=634,
+	TAG_TT=648,
+	TAG_SAMP=649,
+	TAG_SUP=672,
+	TAG_DEL=677,
+	TAG_MARQUEE=680,
+	TAG_DL=688,
+	TAG_INPUT=696,
+	TAG_HGROUP=709,
+	TAG_BDI=727,
+	TAG_BIG=730,
+	TAG_LI=749,
+	TAG_P=752,
+	TAG_NOBR=761,
+	TAG_H4=764,
+	TAG_DIR=767,
+	TAG_IFRAME=772,
+	TAG_COL=774,
+	TAG_HR=778,
+	TAG_NOEMBED=786,
+	TAG_SELECT=800,
+	TAG_TEMPLATE=820,
+	TAG_PROGRESS=829,
+	TAG_I=833,
+	TAG_SUB=834,
+	TAG_XMP=837,
+	TAG_SMALL=841,
+	TAG_MAIN=845,
+	TAG_FIELDSET=848,
+	TAG_DIV=867,
+	TAG_KEYGEN=868,
+	TAG_FONT=879,
+	TAG_OPTION=881,
+	TAG_DT=888,
+	TAG_TEXTAREA=894,
+	TAG_HEAD=906,
+	TAG_OL=907,
+	TAG_B=914,
+	TAG_SPAN=915,
+	TAG_BUTTON=916,
+	TAG_TRACK=917,
+	TAG_FOOTER=919,
+	TAG_LISTING=930,
+	TAG_DETAILS=934,
+	TAG_H1=945,
+	TAG_PICTURE=948,
+	TAG_SOURCE=961,
+	TAG_CITE=965,
+	TAG_EMBED=981,
+	TAG_RTC=993,
+	TAG_ADDRESS=1006,
+	TAG_MARK=1019,
+	TAG_VIDEO=1023,
+};
@@ -19,6 +19,8 @@
 #include "token.h"
 #include "attr.h"
 #include "tagmap.h"
+#include "stats.h"
+#include "util.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -61,22 +63,14 @@ tagtoken_set_attr(struct tagtoken *tagtoken, const char *name, const char *value
 void
 token_clear(struct token *token)
 {
-	struct attr	*np;
-	struct attr	*next;
-
 	assert(token != NULL);
 
 	if (!token->used && TOKEN_IS_START_END(token)) {
-		if (token->u.tag.name != NULL &&
+		if (token->u.tag.name != NULL && !token->u.tag.shared_name &&
 		    token->u.tag.name != tagmap(token->u.tag.tagid)->name)
-			free(token->u.tag.name);
-
-		np = token->u.tag.attr;
-		while (np != NULL) {
-			next = np->next;
-			free(np);
-			np = next;
-		}
+			mem_free(token->u.tag.name);
+
+		attr_free(token->u.tag.attr);
 	} else if (TOKEN_IS_CHAR(token)) {
 		str_add(&token->s, '\0');
 	}
@@ -101,9 +95,10 @@ token_set_tag_name(struct token *token, const char *name)
 
 	token->u.tag.tagid = tagmap_id(name);
 	if (token->u.tag.tagid == 0) {
-		token->u.tag.name = strdup(name);
+		token->u.tag.name = mem_strdup(name);
 		if (token->u.tag.name == NULL)
 			err(1, "strup token tag name");
+		STATS_ADD(allocs[ALLOC_TOKEN], 1);
 	} else
 		token->u.tag.name = tagmap(token->u.tag.tagid)->name;
 }
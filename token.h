@@ -38,6 +38,7 @@ struct tagtoken
 	char *name;			/* can be ptr to tagid name */
 	struct attr *attr;
 	char is_self_closing;
+	char shared_name;		/* interned, see attr_pool_name() */
 };
 
 struct str;
@@ -51,6 +52,7 @@ struct token
 	char used;			/* if used, alloc control is passed fwd */
 	struct str s;
 	size_t end_line;
+	size_t end_offset;
 };
 
 const char		*token_str		(struct token *);
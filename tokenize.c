@@ -17,26 +17,48 @@
  */
 
 #include "tokenize.h"
+#include "tagmap.h"
 #include "util.h"
+#include "stats.h"
 
 #include <ctype.h>
 #include <assert.h>
-#include <err.h>
 #include <string.h>
 
 #include "states.c"
 
+/*
+ * A library built with -DPUREHTML_FAST does not count lines and leaves
+ * the end_line of tokens at 0, see report.h for the parse errors.
+ */
+#ifdef PUREHTML_FAST
+#define COUNT_LINE(_ctx, _c)	do { } while (0)
+#define MARK_END(_ctx) \
+	((_ctx)->token.end_offset = (_ctx)->offset)
+#else
+#define COUNT_LINE(_ctx, _c)	do { \
+	if ((_c) == '\n') \
+		(_ctx)->line++; \
+} while (0)
+#define MARK_END(_ctx)		do { \
+	(_ctx)->token.end_line = (_ctx)->line; \
+	(_ctx)->token.end_offset = (_ctx)->offset; \
+} while (0)
+#endif
+
 static void		 enter_state_return(struct tokenizer *, STATE, STATE);
 static struct token	*enter_state_emit(struct tokenizer *, STATE, struct token *);
 static struct token	*enter_state_emit_char(struct tokenizer *, STATE, char);
 static struct token	*enter_state_emit_doctype(struct tokenizer *, STATE);
 static void		 enter_state_reconsume(struct tokenizer *, STATE, char);
 static void		 enter_state(struct tokenizer *, STATE);
-static void		 print_err(struct tokenizer *, const char *);
-static void		 enter_state_err(struct tokenizer *, STATE, const char *);
+static void		 tokenize_err(struct tokenizer *, enum errors);
+static void		 enter_state_err(struct tokenizer *, STATE, enum errors);
+static void		 new_token(struct tokenizer *, struct token);
 static void		 push_char(struct tokenizer *, char);
-
-static int cnt;
+static void		 set_tag_name(struct tokenizer *);
+static void		 set_attr(struct tokenizer *);
+static void		 skip_raw(struct tokenizer *, int);
 
 struct token *
 tokenize(struct tokenizer *ctx)
@@ -44,15 +66,15 @@ tokenize(struct tokenizer *ctx)
 	char c;
 	char *p;
 
-	assert(ctx->fp != NULL);
-
-	c = fgetc(ctx->fp);
+	c = INPUT_GETC(&ctx->input);
 
 	if (c == EOF)
 		return NULL;
 
-	if (c == '\n')
-		ctx->line++;
+	ctx->offset++;
+	STATS_ADD(bytes[ctx->state], 1);
+
+	COUNT_LINE(ctx, c);
 
 	/*
 	 * Additional prefilter for all modes and states, simplifying
@@ -168,7 +190,7 @@ tokenize(struct tokenizer *ctx)
 		break;
 	case STATE_SCRIPT_DATA_END_TAG_OPEN:
 		if (isalpha(c)) {
-			ctx->token = TOKEN_SET_END_TAG();
+			new_token(ctx, TOKEN_SET_END_TAG());
 			enter_state_reconsume(ctx, STATE_SCRIPT_DATA_END_TAG_NAME, c);
 		} else
 			enter_state_reconsume(ctx, STATE_SCRIPT_DATA, c);
@@ -180,7 +202,7 @@ tokenize(struct tokenizer *ctx)
 			if (strcmp(ctx->name.s, "script") != 0) {
 				return enter_state_emit_char(ctx, STATE_SCRIPT_DATA, '<');
 			} else {
-				token_set_tag_name(&ctx->token, ctx->name.s);
+				set_tag_name(ctx);
 				return enter_state_emit(ctx, STATE_DATA, &ctx->token);
 			}
 		} else if (isalpha(c)) {
@@ -209,7 +231,7 @@ tokenize(struct tokenizer *ctx)
 		break;
 	case STATE_RAWTEXT_END_TAG_OPEN:
 		if (isalpha(c)) {
-			ctx->token = TOKEN_SET_END_TAG();
+			new_token(ctx, TOKEN_SET_END_TAG());
 			enter_state_reconsume(ctx, STATE_RAWTEXT_END_TAG_NAME,
 			    c);
 		} else {
@@ -223,7 +245,7 @@ tokenize(struct tokenizer *ctx)
 			enter_state(ctx, STATE_BEFORE_ATTRIB_NAME);
 		} else if (c == '/') {
 		} else if (c == '>') {
-			token_set_tag_name(&ctx->token, ctx->name.s);
+			set_tag_name(ctx);
 			return enter_state_emit(ctx, STATE_DATA, &ctx->token);
 		} else if (isalpha(c)) {
 			c = tolower(c);
@@ -254,7 +276,7 @@ tokenize(struct tokenizer *ctx)
 		break;
 	case STATE_RCDATA_END_TAG_OPEN:
 		if (isalpha(c)) {
-			ctx->token = TOKEN_SET_END_TAG();
+			new_token(ctx, TOKEN_SET_END_TAG());
 			enter_state_reconsume(ctx, STATE_RCDATA_END_TAG_NAME, c);
 		} else {
 			push_char(ctx, '<');
@@ -269,7 +291,7 @@ tokenize(struct tokenizer *ctx)
 		else if (c == '/')
 			ctx->token.u.tag.is_self_closing = 1;
 		else if (c == '>') {
-			token_set_tag_name(&ctx->token, ctx->name.s);
+			set_tag_name(ctx);
 			return enter_state_emit(ctx, STATE_DATA, &ctx->token);
 		} else if (isalpha(c)) {
 			c = tolower(c);
@@ -306,7 +328,7 @@ tokenize(struct tokenizer *ctx)
 			return NULL;
 		default:
 			if (isalpha(c)) {
-				ctx->token = TOKEN_SET_START_TAG();
+				new_token(ctx, TOKEN_SET_START_TAG());
 				enter_state_reconsume(ctx, STATE_TAG_NAME, c);
 				return NULL;
 			}
@@ -343,7 +365,7 @@ tokenize(struct tokenizer *ctx)
 				return NULL;
 			case '[':
 				enter_state_err(ctx, STATE_BOGUS_COMMENT,
-				    "cdata-in-html-content");
+				    ERROR_CDATA_IN_HTML_CONTENT);
 				return NULL;
 			default:
 				assert(0);
@@ -352,7 +374,7 @@ tokenize(struct tokenizer *ctx)
 			return NULL;
 
 err_markup_declaration_open:
-		warnx("incorrectly-opened-comment");
+		tokenize_err(ctx, ERROR_INCORRECTLY_OPENED_COMMENT);
 		enter_state(ctx, STATE_BOGUS_COMMENT);
 		return NULL;
 	case STATE_DOCTYPE:
@@ -363,8 +385,8 @@ err_markup_declaration_open:
 			enter_state_reconsume(ctx, STATE_BEFORE_DOCTYPE_NAME, c);
 			return NULL;
 		} else {
-			print_err(ctx,
-			    "missing-whitespace-before-doctype-name");
+			tokenize_err(ctx,
+			    ERROR_MISSING_WHITESPACE_BEFORE_DOCTYPE_NAME);
 			enter_state_reconsume(ctx, STATE_BEFORE_DOCTYPE_NAME, c);
 			return NULL;
 		}
@@ -374,7 +396,7 @@ err_markup_declaration_open:
 			return NULL;
 		} else if (c == '>') {
 			enter_state_err(ctx, STATE_DATA,
-			    "missing-doctype-name");
+			    ERROR_MISSING_DOCTYPE_NAME);
 			return NULL;
 		} else {
 			enter_state(ctx, STATE_DOCTYPE_NAME);
@@ -424,18 +446,19 @@ err_markup_declaration_open:
 			return NULL;
 		}
 		if (isalpha(c)) {
-			ctx->token = TOKEN_SET_END_TAG();
+			new_token(ctx, TOKEN_SET_END_TAG());
 			enter_state_reconsume(ctx, STATE_TAG_NAME, c);
 			return NULL;
 		} else {
-			print_err(ctx, "invalid-first-character-of-tag-name");
+			tokenize_err(ctx,
+			    ERROR_INVALID_FIRST_CHARACTER_OF_TAG_NAME);
 			enter_state_reconsume(ctx, STATE_BOGUS_COMMENT, c);
 			return NULL;
 		}
 		break;
 	case STATE_TAG_NAME:
 		if (HTML_ISSPACE(c)) {
-			token_set_tag_name(&ctx->token, ctx->name.s);
+			set_tag_name(ctx);
 			enter_state(ctx, STATE_BEFORE_ATTRIB_NAME);
 			return NULL;
 		}
@@ -444,7 +467,7 @@ err_markup_declaration_open:
 			
 		switch (c) {
 		case '>':
-			token_set_tag_name(&ctx->token, ctx->name.s);
+			set_tag_name(ctx);
 			return enter_state_emit(ctx, STATE_DATA, &ctx->token);
 		default:
 			str_add(&ctx->name, c);
@@ -456,7 +479,7 @@ err_markup_declaration_open:
 			enter_state_reconsume(ctx, STATE_AFTER_ATTRIB_NAME, c);
 		else if (c == '=') {
 			enter_state_err(ctx, STATE_ATTRIB_NAME,
-			    "unexpected-equals-sign-before-attribute-name");
+			    ERROR_UNEXPECTED_EQUALS_SIGN_BEFORE_ATTRIBUTE_NAME);
 		} else {
 			enter_state_reconsume(ctx, STATE_ATTRIB_NAME, c);
 		}
@@ -468,15 +491,14 @@ err_markup_declaration_open:
 			enter_state(ctx, STATE_BEFORE_ATTRIB_VAL);
 		else {
 			if (c == '\"' || c == '\'' || c == '<')
-				print_err(ctx,
-				    "unexpected-character-in-attribute-name");
+				tokenize_err(ctx,
+				    ERROR_UNEXPECTED_CHARACTER_IN_ATTRIBUTE_NAME);
 			c = tolower(c);
 			str_add(&ctx->attrib_name, c);
 		}
 		break;
 	case STATE_AFTER_ATTRIB_NAME:
-		token_set_tag_attr(&ctx->token,
-		    ctx->attrib_name.s, ctx->attrib_value.s);
+		set_attr(ctx);
 		if (c == '/') {
 			enter_state(ctx, STATE_SELF_CLOSING_START_TAG);
 		} else if (c == '=')
@@ -492,7 +514,7 @@ err_markup_declaration_open:
 		else if (c == '\'')
 			enter_state(ctx, STATE_ATTRIB_VAL_SQUOTED);
 		else if (c == '>') {
-			print_err(ctx, "missing-attribute-value");
+			tokenize_err(ctx, ERROR_MISSING_ATTRIBUTE_VALUE);
 			return enter_state_emit(ctx, STATE_DATA, &ctx->token);
 		} else
 			enter_state(ctx, STATE_ATTRIB_VAL);
@@ -516,12 +538,12 @@ err_markup_declaration_open:
 			enter_state_return(ctx, STATE_CHARACTER_REFERENCE,
 			    STATE_ATTRIB_VAL);
 		} else if (c == '>') {
-			token_set_tag_attr(&ctx->token,
-			    ctx->attrib_name.s, ctx->attrib_value.s);
+			set_attr(ctx);
 			return enter_state_emit(ctx, STATE_DATA, &ctx->token);
 		} else if (c == '\"' || c == '\'' || c == '<' || c == '=' ||
 		    c == '`') {
-			print_err(ctx, "unexpected-character-in-unquoted-attribute-value");
+			tokenize_err(ctx,
+			    ERROR_UNEXPECTED_CHARACTER_IN_UNQUOTED_ATTRIBUTE_VALUE);
 		} else {
 			str_add(&ctx->attrib_value, c);
 			/* TODO */
@@ -533,21 +555,20 @@ err_markup_declaration_open:
 		else if (c == '/')
 			enter_state(ctx, STATE_SELF_CLOSING_START_TAG);
 		else if (c == '>') {
-			token_set_tag_attr(&ctx->token,
-			    ctx->attrib_name.s, ctx->attrib_value.s);
+			set_attr(ctx);
 			return enter_state_emit(ctx, STATE_DATA, &ctx->token);
 		} else {
-			print_err(ctx, "missing-whitespace-between-attributes");
+			tokenize_err(ctx,
+			    ERROR_MISSING_WHITESPACE_BETWEEN_ATTRIBUTES);
 			enter_state_reconsume(ctx, STATE_BEFORE_ATTRIB_NAME, c);
 		}
 		break;
 	case STATE_SELF_CLOSING_START_TAG:
 		if (c == '>') {
-			token_set_tag_attr(&ctx->token,
-			    ctx->attrib_name.s, ctx->attrib_value.s);
+			set_attr(ctx);
 			return enter_state_emit(ctx, STATE_DATA, &ctx->token);
 		} else {
-			print_err(ctx, "unexpected-solidus-in-tag");
+			tokenize_err(ctx, ERROR_UNEXPECTED_SOLIDUS_IN_TAG);
 			enter_state(ctx, STATE_BEFORE_ATTRIB_NAME);
 		}
 		break;
@@ -555,7 +576,7 @@ err_markup_declaration_open:
 		if (c == '-')
 			enter_state(ctx, STATE_COMMENT_START_DASH);
 		else if (c == '>') {
-			print_err(ctx, "abrupt-closing-of-empty-comment");
+			tokenize_err(ctx, ERROR_ABRUPT_CLOSING_OF_EMPTY_COMMENT);
 			return enter_state_emit(ctx, STATE_DATA, &ctx->token);
 		} else
 			enter_state_reconsume(ctx, STATE_COMMENT, c);
@@ -564,7 +585,7 @@ err_markup_declaration_open:
 		if (c == '-')
 			enter_state(ctx, STATE_COMMENT_END);
 		else if (c == '>') {
-			print_err(ctx, "abrupt-closing-of-empty-comment");
+			tokenize_err(ctx, ERROR_ABRUPT_CLOSING_OF_EMPTY_COMMENT);
 			enter_state(ctx, STATE_DATA);
 		} else
 			enter_state_reconsume(ctx, STATE_COMMENT, c);
@@ -598,7 +619,7 @@ err_markup_declaration_open:
 		if (c == '>')
 			enter_state_reconsume(ctx, STATE_COMMENT_END, c);
 		else {
-			print_err(ctx, "nested-comment");
+			tokenize_err(ctx, ERROR_NESTED_COMMENT);
 			enter_state_reconsume(ctx, STATE_COMMENT_END, c);
 		}
 		break;
@@ -621,7 +642,7 @@ err_markup_declaration_open:
 		if (c == '-')
 			enter_state(ctx, STATE_COMMENT_END_DASH);
 		else if (c == '>') {
-			print_err(ctx, "incorrectly-closed-comment");
+			tokenize_err(ctx, ERROR_INCORRECTLY_CLOSED_COMMENT);
 			enter_state(ctx, STATE_DATA);
 		} else
 			enter_state_reconsume(ctx, STATE_COMMENT, c);
@@ -644,9 +665,13 @@ err_markup_declaration_open:
 	case STATE_NUM_CHAR_REF:
 		enter_state(ctx, ctx->return_state);
 		break;
+	case STATE_SKIP_RCDATA:
+	case STATE_SKIP_RAWTEXT:
+	case STATE_SKIP_SCRIPT_DATA:
+		skip_raw(ctx, c);
+		break;
 	default:
 		printf("State: %s\n", states[ctx->state]);
-		print_err(ctx, "unhandled state");
 		assert(0);
 		break;
 	}
@@ -663,6 +688,7 @@ enter_state(struct tokenizer *ctx, STATE state)
 
 	switch (state) {
 	case STATE_SCRIPT_DATA_END_TAG_NAME:
+	case STATE_RAWTEXT_END_TAG_NAME:
 	case STATE_RCDATA_END_TAG_NAME:
 	case STATE_TAG_NAME:
 		str_add(&ctx->name, '\0');
@@ -671,10 +697,7 @@ enter_state(struct tokenizer *ctx, STATE state)
 		str_add(&ctx->attrib_value, '\0');
 		break;
 	case STATE_BEFORE_ATTRIB_NAME:
-		if (ctx->attrib_name.s != NULL &&
-		    *ctx->attrib_name.s != '\0')
-			token_set_tag_attr(&ctx->token,
-			    ctx->attrib_name.s, ctx->attrib_value.s);
+		set_attr(ctx);
 		break;
 	case STATE_ATTRIB_NAME:
 		str_add(&ctx->attrib_name, '\0');
@@ -686,7 +709,7 @@ enter_state(struct tokenizer *ctx, STATE state)
 	case STATE_COMMENT_START:
 	case STATE_BOGUS_COMMENT:
 	case STATE_COMMENT:
-		ctx->token = TOKEN_SET_COMMENT();
+		new_token(ctx, TOKEN_SET_COMMENT());
 		break;
 	default:
 		break;
@@ -706,19 +729,112 @@ static struct token *
 enter_state_emit(struct tokenizer *ctx, STATE state, struct token *token)
 {
 	enter_state(ctx, state);
-	ctx->token.end_line = ctx->line;
+	MARK_END(ctx);
 
 	return &ctx->token;
 }
 
+/*
+ * Start a new token, keeping the buffer of the character tokens.
+ */
+static void
+new_token(struct tokenizer *ctx, struct token token)
+{
+	struct str s;
+
+	s = ctx->token.s;
+	ctx->token = token;
+	ctx->token.s = s;
+	str_add(&ctx->token.s, '\0');
+	attr_index_clear(&ctx->attrs);
+}
+
 static void
 push_char(struct tokenizer *ctx, char c)
 {
 	ctx->token.type = TOKEN_CHAR;
-	ctx->token.end_line = ctx->line;
+	MARK_END(ctx);
 	str_add(&ctx->token.s, c);
 }
 
+/*
+ * With a pool the names of custom tags are interned, see
+ * attr_pool_name(), instead of copied for every tag.
+ */
+static void
+set_tag_name(struct tokenizer *ctx)
+{
+	struct tagtoken *tag;
+
+	tag = &ctx->token.u.tag;
+	if (ctx->attrs.pool == NULL) {
+		token_set_tag_name(&ctx->token, ctx->name.s);
+		return;
+	}
+
+	tag->tagid = tagmap_id(ctx->name.s);
+	if (tag->tagid != 0)
+		tag->name = tagmap(tag->tagid)->name;
+	else if ((tag->name = attr_pool_name(ctx->attrs.pool,
+	    ctx->name.s)) != NULL)
+		tag->shared_name = 1;
+	else
+		token_set_tag_name(&ctx->token, ctx->name.s);
+}
+
+/*
+ * Attributes are not collected at all while the consumer skips the
+ * subtree, see no_attrs.
+ */
+static void
+set_attr(struct tokenizer *ctx)
+{
+	if (ctx->no_attrs || ctx->attrib_name.s == NULL ||
+	    *ctx->attrib_name.s == '\0')
+		return;
+
+	assert(TOKEN_IS_START_END(&ctx->token));
+	attr_index_set(&ctx->attrs, &ctx->token.u.tag.attr,
+	    ctx->attrib_name.s, ctx->attrib_value.s);
+}
+
+/*
+ * Fast-forward the raw text of a skipped element up to the next "</"
+ * without emitting character tokens, then continue in the regular end
+ * tag open state so that the end tag gets tokenized as usual.
+ */
+static void
+skip_raw(struct tokenizer *ctx, int c)
+{
+	int prev;
+
+	prev = '\0';
+	for (;;) {
+		if (prev == '<' && c == '/')
+			break;
+		prev = c;
+		c = INPUT_GETC(&ctx->input);
+		if (c == EOF)
+			return;
+		ctx->offset++;
+		COUNT_LINE(ctx, c);
+	}
+
+	switch (ctx->state) {
+	case STATE_SKIP_RCDATA:
+		enter_state(ctx, STATE_RCDATA_END_TAG_OPEN);
+		break;
+	case STATE_SKIP_RAWTEXT:
+		enter_state(ctx, STATE_RAWTEXT_END_TAG_OPEN);
+		break;
+	case STATE_SKIP_SCRIPT_DATA:
+		enter_state(ctx, STATE_SCRIPT_DATA_END_TAG_OPEN);
+		break;
+	default:
+		assert(0);
+	}
+}
+
 static struct token *
 enter_state_emit_char(struct tokenizer *ctx, STATE state, char c)
 {
@@ -731,8 +847,8 @@ enter_state_emit_char(struct tokenizer *ctx, STATE state, char c)
 static struct token *
 enter_state_emit_doctype(struct tokenizer *ctx, STATE state)
 {
-	ctx->token = TOKEN_SET_DOCTYPE();
-	ctx->token.end_line = ctx->line;
+	new_token(ctx, TOKEN_SET_DOCTYPE());
+	MARK_END(ctx);
 
 	enter_state(ctx, state);
 
@@ -743,28 +859,27 @@ static void
 enter_state_reconsume(struct tokenizer *ctx, STATE state, char c)
 {
 	enter_state(ctx, state);
+	STATS_ADD(reconsumes, 1);
 
-	cnt--;
+	ctx->offset--;
 #if 0
 	printf("RECONSUME c='%c'\n", c);
 #endif
-	if (ungetc(c, ctx->fp) == EOF)
-		err(1, "ungetc");
+	INPUT_UNGETC(&ctx->input);
 }
 
 static void
-print_err(struct tokenizer *ctx, const char *msg)
+tokenize_err(struct tokenizer *ctx, enum errors code)
 {
 	assert(ctx != NULL);
-	assert(msg != NULL);
 
-	warnx("%zu: %s", ctx->line+1, msg);
+	REPORT(ctx->report, code, ctx->line + 1, ctx->offset);
 }
 
 static void
-enter_state_err(struct tokenizer *ctx, STATE state, const char *msg)
+enter_state_err(struct tokenizer *ctx, STATE state, enum errors code)
 {
-	print_err(ctx, msg);
+	tokenize_err(ctx, code);
 	enter_state(ctx, state);
 }
 
@@ -788,14 +903,12 @@ main(int argc, char **argv)
 {
 	static struct tokenizer tokenizer;
 	struct token *token;
-	FILE *fp;
 	static const char buf[] = \
 	    "foobar<img src=foobar rel=\"zap\">zup</address>last";
 
-	fp = fmemopen((void *) buf, sizeof(buf), "r");
-	tokenizer.fp = fp;
+	input_buf(&tokenizer.input, buf, sizeof(buf));
 
-	while (!feof(fp)) {
+	while (!INPUT_EOF(&tokenizer.input)) {
 		token = tokenize(&tokenizer);
 		if (token != NULL) {
 			dump_token(token);
@@ -803,7 +916,73 @@ main(int argc, char **argv)
 		} else
 			printf("NULL token\n");
 	}
-	fclose(fp);
+
+	return 0;
+}
+#endif
+
+#ifdef BENCH
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * The helpers the tokenizer calls per tag name and per character.
+ */
+int
+main(int argc, char **argv)
+{
+	static const char *known[] = {
+		"a", "div", "span", "table", "blockquote", "figcaption"
+	};
+	static const char *unknown[] = {
+		"x", "foo", "my-widget", "custom-element-name", "svgpath"
+	};
+	static const size_t lens[] = { 16, 256, 4096, 65536, 1048576 };
+	static volatile size_t sink;
+	struct str str;
+	char name[32];
+	size_t i, j, n, reps;
+	double start;
+
+	reps = 2000000;
+	start = now();
+	for (j = 0; j < reps; j++)
+		for (i = 0; i < sizeof(known) / sizeof(known[0]); i++)
+			sink += tagmap_id(known[i]);
+	printf("%-32s%8.1f ns/op\n", "tagmap_id known",
+	    (now() - start) / (reps * i) * 1e9);
+
+	start = now();
+	for (j = 0; j < reps; j++)
+		for (i = 0; i < sizeof(unknown) / sizeof(unknown[0]); i++)
+			sink += tagmap_id(unknown[i]);
+	printf("%-32s%8.1f ns/op\n", "tagmap_id unknown",
+	    (now() - start) / (reps * i) * 1e9);
+
+	for (i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+		reps = 20000000 / lens[i];
+		start = now();
+		for (j = 0; j < reps; j++) {
+			memset(&str, 0, sizeof(struct str));
+			for (n = 0; n < lens[i]; n++)
+				str_add(&str, 'x');
+			sink += str.len;
+			mem_free(str.s);
+		}
+		snprintf(name, sizeof(name), "str_add to %zu", lens[i]);
+		printf("%-32s%8.1f ns/op\n", name,
+		    (now() - start) / (reps * lens[i]) * 1e9);
+	}
 
 	return 0;
 }
@@ -21,7 +21,10 @@
 
 #include "util.h"
 #include "token.h"
+#include "attr.h"
 #include "states.h"
+#include "input.h"
+#include "report.h"
 
 #include <stdio.h>
 
@@ -36,14 +39,20 @@ struct tokenizer {
 	STATE return_state;
 
 	size_t line;
+	size_t offset;		/* bytes consumed */
 
 	struct token token;
+	struct attr_index attrs;	/* of the tag token */
 
 	char buf[16];
 	size_t buf_len;
 	const char *match;
 
-	FILE *fp;
+	int no_attrs;		/* drop attributes, e.g. when skipping */
+
+	struct report *report;	/* parse errors, or NULL */
+
+	struct input input;
 };
 
 struct token	*tokenize(struct tokenizer *ctx);
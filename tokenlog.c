@@ -0,0 +1,525 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "tokenlog.h"
+#include "tagmap.h"
+#include "attr.h"
+#include "states.h"
+#include "stats.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <err.h>
+
+/*
+ * The log starts with TOKENLOG_MAGIC, then for each token:
+ *
+ *	type		byte, TOKEN_*
+ *	end_line	varint, zigzag coded change from the previous token
+ *	end_offset	varint, likewise
+ *	text		varint length and the bytes of token->s
+ *
+ * for start and end tags:
+ *
+ *	tagid		varint
+ *	name		string, empty if the name of the tag id
+ *	self closing	byte
+ *	attributes	varint count, then a name and a value string each
+ *
+ * and last:
+ *
+ *	state		varint, the one dispatch() returned
+ *
+ * Runs of character tokens of one byte that follow each other in the
+ * input and switch no state, which are most tokens, are written as:
+ *
+ *	TOKENLOG_RUN	byte
+ *	count		varint
+ *	bytes		one per token
+ *
+ * Varints are little endian base 128. Strings are a varint of one more
+ * than the length, or 0 for none, then the bytes.
+ */
+
+static void	 put_token(struct tokenlog *, struct token *);
+static void	 put_run(struct tokenlog *);
+static void	 put_uint(struct tokenlog *, size_t);
+static void	 put_delta(struct tokenlog *, size_t, size_t);
+static void	 put_string(struct tokenlog *, const char *);
+static int	 get_byte(struct tokenlog *);
+static size_t	 get_uint(struct tokenlog *);
+static size_t	 get_delta(struct tokenlog *, size_t);
+static char	*get_string(struct tokenlog *);
+
+void
+tokenlog_record(struct tokenlog *log, FILE *out)
+{
+	memset(log, 0, sizeof(struct tokenlog));
+	log->out = out;
+	fputs(TOKENLOG_MAGIC, out);
+}
+
+/*
+ * Before dispatch(), which may take over the name and attributes.
+ */
+void
+tokenlog_put(struct tokenlog *log, struct token *token)
+{
+	char c;
+
+	assert(log->out != NULL);
+
+	if (TOKEN_IS_CHAR(token) && token->s.len == 1) {
+		c = token->s.s[0];
+		if (token->end_offset == log->offset + 1 &&
+		    token->end_line == log->line + (c == '\n')) {
+			str_add(&log->run, c);
+			log->line = token->end_line;
+			log->offset = token->end_offset;
+			log->tokens++;
+			return;
+		}
+	}
+
+	put_run(log);
+	put_token(log, token);
+	log->tokens++;
+}
+
+/*
+ * After dispatch() of the token put last.
+ */
+void
+tokenlog_put_state(struct tokenlog *log, int state)
+{
+	struct token token;
+	char c[2];
+
+	if (log->run.len > 0 && state != STATE_NONE) {
+		/*
+		 * The last character of the run goes on its own.
+		 */
+		memset(&token, 0, sizeof(struct token));
+		token.type = TOKEN_CHAR;
+		token.end_line = log->line;
+		token.end_offset = log->offset;
+		c[0] = log->run.s[--log->run.len];
+		c[1] = '\0';
+		log->run.s[log->run.len] = '\0';
+		token.s.s = c;
+		token.s.len = 1;
+		log->line -= (c[0] == '\n');
+		log->offset--;
+		put_run(log);
+		put_token(log, &token);
+	}
+	if (log->run.len == 0)
+		put_uint(log, state);
+	if (ferror(log->out))
+		log->error = "cannot write token log";
+}
+
+static void
+put_token(struct tokenlog *log, struct token *token)
+{
+	struct attr *attr;
+	size_t n;
+
+	putc(token->type, log->out);
+	put_delta(log, log->line, token->end_line);
+	put_delta(log, log->offset, token->end_offset);
+	log->line = token->end_line;
+	log->offset = token->end_offset;
+	put_uint(log, token->s.len);
+	if (token->s.len > 0)
+		fwrite(token->s.s, 1, token->s.len, log->out);
+
+	if (TOKEN_IS_START_END(token)) {
+		put_uint(log, token->u.tag.tagid);
+		if (token->u.tag.name == tagmap(token->u.tag.tagid)->name)
+			put_string(log, NULL);
+		else
+			put_string(log, token->u.tag.name);
+		putc(token->u.tag.is_self_closing, log->out);
+
+		for (n = 0, attr = token->u.tag.attr; attr != NULL;
+		    attr = attr->next)
+			n++;
+		put_uint(log, n);
+		for (attr = token->u.tag.attr; attr != NULL; attr = attr->next) {
+			put_string(log, attr->name);
+			put_string(log, attr->value);
+		}
+	}
+}
+
+static void
+put_run(struct tokenlog *log)
+{
+	if (log->run.len == 0)
+		return;
+
+	putc(TOKENLOG_RUN, log->out);
+	put_uint(log, log->run.len);
+	fwrite(log->run.s, 1, log->run.len, log->out);
+	str_add(&log->run, '\0');
+}
+
+void
+tokenlog_init(struct tokenlog *log, size_t (*read)(void *, char *, size_t),
+    void *user)
+{
+	memset(log, 0, sizeof(struct tokenlog));
+	log->in.encoding = ENCODING_BINARY;
+	input_read(&log->in, read, user);
+}
+
+/*
+ * Returns the next token and sets the state it was followed by, or
+ * returns NULL at the end of the log or if it is bad, see log->error.
+ * The token is the caller's to give to dispatch() but stays the log's.
+ */
+struct token *
+tokenlog_get(struct tokenlog *log, int *state)
+{
+	struct token *token;
+	struct attr **tail;
+	const char *p;
+	size_t n, tagid;
+	int c;
+
+	token = &log->token;
+	token_clear(token);
+	if (log->error != NULL)
+		return NULL;
+
+	if (!log->started) {
+		for (p = TOKENLOG_MAGIC; *p != '\0'; p++)
+			if (INPUT_GETC(&log->in) != (unsigned char) *p) {
+				log->error = "not a token log";
+				return NULL;
+			}
+		log->started = 1;
+	}
+
+	if (log->run_left == 0) {
+		if ((c = INPUT_GETC(&log->in)) == EOF)
+			return NULL;
+		if (c == TOKENLOG_RUN &&
+		    (log->run_left = get_uint(log)) == 0 && log->error == NULL)
+			log->error = "empty run in token log";
+	}
+	if (log->run_left > 0) {
+		log->run_left--;
+		if ((c = get_byte(log)) == EOF)
+			return NULL;
+		token->type = TOKEN_CHAR;
+		token->end_line = log->line += (c == '\n');
+		token->end_offset = ++log->offset;
+		str_add(&token->s, '\0');
+		str_add(&token->s, c);
+		*state = STATE_NONE;
+		log->tokens++;
+		return token;
+	}
+	if (log->error != NULL)
+		return NULL;
+	if (c < TOKEN_CHAR || c > TOKEN_COMMENT) {
+		log->error = "bad token type in token log";
+		return NULL;
+	}
+
+	token->type = c;
+	token->end_line = log->line = get_delta(log, log->line);
+	token->end_offset = log->offset = get_delta(log, log->offset);
+	str_add(&token->s, '\0');
+	for (n = get_uint(log); n > 0 && log->error == NULL; n--)
+		if ((c = get_byte(log)) != EOF)
+			str_add(&token->s, c);
+
+	if (TOKEN_IS_START_END(token)) {
+		if ((tagid = get_uint(log)) >= TAGMAP_SZ) {
+			log->error = "bad tag id in token log";
+			tagid = 0;
+		}
+		token->u.tag.tagid = tagid;
+		if ((token->u.tag.name = get_string(log)) == NULL &&
+		    (token->u.tag.name = tagmap(tagid)->name) == NULL)
+			log->error = "tag without name in token log";
+		token->u.tag.is_self_closing = get_byte(log) == 1;
+
+		tail = &token->u.tag.attr;
+		for (n = get_uint(log); n > 0 && log->error == NULL; n--) {
+			if ((*tail = mem_calloc(1, sizeof(struct attr))) == NULL)
+				err(1, "calloc attr");
+			STATS_ADD(allocs[ALLOC_ATTR], 1);
+			(*tail)->name = get_string(log);
+			(*tail)->value = get_string(log);
+			if ((*tail)->name == NULL)
+				log->error = "attribute without name in token log";
+			tail = &(*tail)->next;
+		}
+	}
+
+	if ((*state = get_uint(log)) >= NSTATES)
+		log->error = "bad state in token log";
+
+	if (log->error != NULL) {
+		token_clear(token);
+		return NULL;
+	}
+	log->tokens++;
+	return token;
+}
+
+void
+tokenlog_free(struct tokenlog *log)
+{
+	if (log->out != NULL)
+		put_run(log);
+	mem_free(log->run.s);
+	token_clear(&log->token);
+	mem_free(log->token.s.s);
+	input_free(&log->in);
+	memset(log, 0, sizeof(struct tokenlog));
+}
+
+static void
+put_uint(struct tokenlog *log, size_t n)
+{
+	while (n >= 0x80) {
+		putc((n & 0x7f) | 0x80, log->out);
+		n >>= 7;
+	}
+	putc(n, log->out);
+}
+
+static void
+put_delta(struct tokenlog *log, size_t from, size_t to)
+{
+	if (to >= from)
+		put_uint(log, (to - from) << 1);
+	else
+		put_uint(log, ((from - to) << 1) - 1);
+}
+
+static void
+put_string(struct tokenlog *log, const char *s)
+{
+	size_t len;
+
+	if (s == NULL) {
+		put_uint(log, 0);
+		return;
+	}
+	len = strlen(s);
+	put_uint(log, len + 1);
+	fwrite(s, 1, len, log->out);
+}
+
+static int
+get_byte(struct tokenlog *log)
+{
+	int c;
+
+	if ((c = INPUT_GETC(&log->in)) == EOF && log->error == NULL)
+		log->error = "truncated token log";
+	return c;
+}
+
+static size_t
+get_uint(struct tokenlog *log)
+{
+	size_t n;
+	int c, shift;
+
+	n = 0;
+	for (shift = 0; shift < 64; shift += 7) {
+		if ((c = get_byte(log)) == EOF)
+			return 0;
+		n |= (size_t) (c & 0x7f) << shift;
+		if (!(c & 0x80))
+			return n;
+	}
+	log->error = "bad varint in token log";
+	return 0;
+}
+
+static size_t
+get_delta(struct tokenlog *log, size_t from)
+{
+	size_t n;
+
+	n = get_uint(log);
+	if (n & 1)
+		return from - (n + 1) / 2;
+	return from + n / 2;
+}
+
+/*
+ * Allocated, or NULL for none.
+ */
+static char *
+get_string(struct tokenlog *log)
+{
+	size_t len, i;
+	char *s;
+	int c;
+
+	if ((len = get_uint(log)) == 0)
+		return NULL;
+	len--;
+	if ((s = mem_malloc(len + 1)) == NULL)
+		err(1, "malloc token log string");
+	STATS_ADD(allocs[ALLOC_TOKEN], 1);
+	for (i = 0; i < len; i++) {
+		if ((c = get_byte(log)) == EOF)
+			break;
+		s[i] = c;
+	}
+	s[i] = '\0';
+	return s;
+}
+
+#ifdef TEST
+#include "purehtml.h"
+#include "node.h"
+#include "elem.h"
+#include "cdata.h"
+
+static struct str out;
+
+static void
+out_add(const char *s)
+{
+	while (*s != '\0')
+		str_add(&out, *s++);
+}
+
+static int
+begin(struct node *node)
+{
+	struct attr *attr;
+
+	if (node->type == NODE_ELEM) {
+		out_add("<");
+		out_add(node->u.elem->name);
+		for (attr = node->u.elem->attr; attr != NULL;
+		    attr = attr->next) {
+			out_add(" ");
+			out_add(attr->name);
+			if (attr->value != NULL) {
+				out_add("=");
+				out_add(attr->value);
+			}
+		}
+		out_add(">");
+	} else if (node->type == NODE_CDATA) {
+		out_add(node->u.cdata->data.s);
+		node_free(node);
+	}
+	return CB_CONTINUE;
+}
+
+static int
+end(struct node *node)
+{
+	if (node->type == NODE_ELEM) {
+		out_add("</");
+		out_add(node->u.elem->name);
+		out_add(">");
+	} else if (node->type == NODE_CDATA)
+		out_add(node->u.cdata->data.s);
+	node_free(node);
+	return CB_CONTINUE;
+}
+
+static size_t
+read_mem(void *user, char *buf, size_t len)
+{
+	FILE *fp = user;
+
+	return fread(buf, 1, len, fp);
+}
+
+/*
+ * Record a parse, replay it and check that the callbacks see the same.
+ */
+static void
+round_trip(const char *html, size_t cut)
+{
+	struct purehtml ctx;
+	struct tokenlog log;
+	char *buf, *expect;
+	size_t len, tokens;
+	FILE *fp;
+
+	memset(&ctx, 0, sizeof(struct purehtml));
+	fp = open_memstream(&buf, &len);
+	assert(fp != NULL);
+	tokenlog_record(&log, fp);
+	ctx.record = &log;
+	str_add(&out, '\0');
+	purehtml_parse_buf(&ctx, html, strlen(html), begin, end);
+	purehtml_free(&ctx);
+	assert(log.error == NULL);
+	tokens = log.tokens;
+	tokenlog_free(&log);
+	fclose(fp);
+	expect = mem_strdup(out.s);
+	assert(expect != NULL);
+
+	fp = fmemopen(buf, cut ? cut : len, "r");
+	assert(fp != NULL);
+	tokenlog_init(&log, read_mem, fp);
+	str_add(&out, '\0');
+	assert(purehtml_replay(&ctx, &log, begin, end) == 0);
+	purehtml_free(&ctx);
+	fclose(fp);
+
+	if (cut)
+		assert(log.error != NULL && log.tokens < tokens);
+	else {
+		assert(log.error == NULL && log.tokens == tokens);
+		if (strcmp(out.s, expect) != 0) {
+			fprintf(stderr, "got:    %s\nexpect: %s\n", out.s,
+			    expect);
+			assert(0);
+		}
+	}
+	tokenlog_free(&log);
+	mem_free(expect);
+	free(buf);
+}
+
+int
+main(int argc, char **argv)
+{
+	static const char html[] = "<!DOCTYPE html><title>a&lt;b</title>"
+	    "<!-- c -->\n<p id=x class=\"y z\" hidden>d<my-tag e=f>g"
+	    "</my-tag><script>if (a</b) x='</scr';</script>\n"
+	    "<textarea>h<i></textarea><br/><table><td>j</table>";
+
+	round_trip(html, 0);
+	round_trip(html, 40);
+	round_trip("", 0);
+	mem_free(out.s);
+	return 0;
+}
+#endif
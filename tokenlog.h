@@ -0,0 +1,63 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef TOKENLOG_H
+#define TOKENLOG_H
+
+#include "input.h"
+#include "token.h"
+#include "util.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+#define TOKENLOG_MAGIC	"PHTL\001"
+#define TOKENLOG_RUN	0x40		/* record of character tokens */
+
+/*
+ * Binary log of the tokens given to dispatch(), each with the state it
+ * asked the tokenizer to switch to, for running the dispatcher without
+ * the tokenizer, see purehtml_replay(). The format is in tokenlog.c.
+ *
+ * A log is either written to a stream with tokenlog_put() and
+ * tokenlog_put_state() after tokenlog_record(), or read from a read
+ * callback, see input.h, with tokenlog_get() after tokenlog_init().
+ * When writing, tokenlog_free() writes what is still pending.
+ */
+struct tokenlog {
+	FILE		*out;		/* when recording */
+	struct input	 in;		/* when replaying */
+	struct token	 token;		/* last one read */
+	struct str	 run;		/* characters not written yet */
+	size_t		 run_left;	/* characters not read yet */
+	size_t		 line;		/* of the previous token */
+	size_t		 offset;
+	size_t		 tokens;
+	int		 started;	/* magic read */
+	const char	*error;		/* set if the log is bad */
+};
+
+void		 tokenlog_record(struct tokenlog *, FILE *);
+void		 tokenlog_put(struct tokenlog *, struct token *);
+void		 tokenlog_put_state(struct tokenlog *, int);
+void		 tokenlog_init(struct tokenlog *,
+		    size_t (*)(void *, char *, size_t), void *);
+struct token	*tokenlog_get(struct tokenlog *, int *);
+void		 tokenlog_free(struct tokenlog *);
+
+#endif
@@ -17,11 +17,70 @@
  */
 
 #include "util.h"
+#include "stats.h"
 
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 #include <assert.h>
 #include <err.h>
 
+static struct allocator allocator = { malloc, realloc, free };
+
+/*
+ * Set the allocator, or the default one if NULL. Must be done before
+ * the library allocates anything that is freed after the change.
+ */
+void
+purehtml_allocator(const struct allocator *new)
+{
+	static const struct allocator libc = { malloc, realloc, free };
+
+	allocator = (new != NULL) ? *new : libc;
+}
+
+void *
+mem_malloc(size_t size)
+{
+	return allocator.malloc(size);
+}
+
+void *
+mem_calloc(size_t nmemb, size_t size)
+{
+	void *p;
+
+	if (size > 0 && nmemb > SIZE_MAX / size)
+		return NULL;
+	if ((p = allocator.malloc(nmemb * size)) != NULL)
+		memset(p, 0, nmemb * size);
+	return p;
+}
+
+void *
+mem_realloc(void *ptr, size_t size)
+{
+	return allocator.realloc(ptr, size);
+}
+
+char *
+mem_strdup(const char *s)
+{
+	size_t len;
+	char *p;
+
+	len = strlen(s) + 1;
+	if ((p = allocator.malloc(len)) != NULL)
+		memcpy(p, s, len);
+	return p;
+}
+
+void
+mem_free(void *ptr)
+{
+	allocator.free(ptr);
+}
+
 /*
  * Example:
  *   static struct str;
@@ -44,10 +103,11 @@ str_add(struct str *str, char c)
 
 #define STR_CHUNK 64
 	if (str->len+1 >= str->alloc) {
-		str->alloc += STR_CHUNK;
-		str->s = realloc(str->s, str->alloc);
+		str->alloc = str->alloc ? str->alloc * 2 : STR_CHUNK;
+		str->s = mem_realloc(str->s, str->alloc);
 		if (str->s == NULL)
 			err(1, "realloc str");
+		STATS_ADD(allocs[ALLOC_STR], 1);
 	}
 
 	str->s[str->len++] = c;
@@ -30,6 +30,24 @@ struct str
 
 void str_add(struct str *, char);
 
+/*
+ * The library allocates through these, which call the functions set
+ * with purehtml_allocator(), by default those of the C library. Memory
+ * allocated by the library must be freed by the library.
+ */
+struct allocator {
+	void	*(*malloc)(size_t);
+	void	*(*realloc)(void *, size_t);
+	void	 (*free)(void *);
+};
+
+void	 purehtml_allocator(const struct allocator *);
+void	*mem_malloc(size_t);
+void	*mem_calloc(size_t, size_t);
+void	*mem_realloc(void *, size_t);
+char	*mem_strdup(const char *);
+void	 mem_free(void *);
+
 /*
  * The system isspace() is a bit different from the HTML LS isspace and in
  * worst case the system isspace() can be locale specific.
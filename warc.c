@@ -0,0 +1,515 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "warc.h"
+#include "inflate.h"
+#include "util.h"
+
+#include <assert.h>
+#include <ctype.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <err.h>
+
+/*
+ * A block is read in pieces growing from this size up to its
+ * Content-Length, which is not trusted to allocate at once.
+ */
+#define WARC_BLOCK	65536
+
+struct mem {
+	const char	*p;
+	size_t		 len;
+};
+
+static int		 read_line(struct warc *);
+static size_t		 read_block(struct warc *, struct warc_record *, size_t);
+static const char	*value(const char *, const char *);
+static char		*dup_value(const char *);
+static void		 http(struct warc *, struct warc_record *);
+static void		 dechunk(struct warc_record *);
+static void		 decode_record(struct warc *, struct warc_record *);
+static size_t		 mem_read(void *, char *, size_t);
+
+void
+warc_init(struct warc *w, size_t (*read)(void *, char *, size_t),
+    void *user)
+{
+	memset(w, 0, sizeof(struct warc));
+	w->in.encoding = ENCODING_BINARY;
+	input_read(&w->in, read, user);
+}
+
+void
+warc_free(struct warc *w)
+{
+	input_free(&w->in);
+	mem_free(w->line.s);
+	mem_free(w->inflate);
+	memset(w, 0, sizeof(struct warc));
+}
+
+void
+warc_record_free(struct warc_record *rec)
+{
+	mem_free(rec->type);
+	mem_free(rec->uri);
+	mem_free(rec->content_type);
+	mem_free(rec->block);
+	mem_free(rec->decoded);
+	memset(rec, 0, sizeof(struct warc_record));
+}
+
+/*
+ * Read the next record. Returns 0 at the end of the file or if the
+ * file is bad, which is then set in w->error.
+ */
+int
+warc_next(struct warc *w, struct warc_record *rec)
+{
+	const char *v;
+	char *end;
+	size_t len;
+	int has_len;
+
+	memset(rec, 0, sizeof(struct warc_record));
+
+	/*
+	 * Records are separated by empty lines.
+	 */
+	do {
+		if (!read_line(w))
+			return 0;
+	} while (w->line.len == 0);
+
+	if (strncmp(w->line.s, "WARC/", 5) != 0) {
+		w->error = "not a WARC record";
+		return 0;
+	}
+
+	len = 0;
+	has_len = 0;
+	while (read_line(w) && w->line.len > 0) {
+		if ((v = value(w->line.s, "Content-Length")) != NULL) {
+			errno = 0;
+			len = strtoul(v, &end, 10);
+			has_len = (isdigit((unsigned char) *v) && errno == 0 &&
+			    len < SIZE_MAX) ? 1 : -1;
+		} else if ((v = value(w->line.s, "WARC-Type")) != NULL)
+			rec->type = dup_value(v);
+		else if ((v = value(w->line.s, "WARC-Target-URI")) != NULL) {
+			rec->uri = dup_value(v);
+			if (*rec->uri == '<' &&
+			    rec->uri[strlen(rec->uri) - 1] == '>') {
+				rec->uri[strlen(rec->uri) - 1] = '\0';
+				memmove(rec->uri, &rec->uri[1],
+				    strlen(rec->uri));
+			}
+		}
+	}
+
+	if (has_len != 1) {
+		w->error = has_len == 0 ? "no Content-Length" :
+		    "bad Content-Length";
+		warc_record_free(rec);
+		return 0;
+	}
+
+	if (read_block(w, rec, len) != len) {
+		w->error = "truncated record";
+		warc_record_free(rec);
+		return 0;
+	}
+	rec->block[len] = '\0';
+	rec->block_len = len;
+	rec->payload = rec->block;
+	rec->payload_len = len;
+
+	if (rec->type != NULL && strcmp(rec->type, "response") == 0 &&
+	    strncmp(rec->block, "HTTP/", 5) == 0)
+		http(w, rec);
+
+	return 1;
+}
+
+/*
+ * Whether the record is a response with an HTML payload.
+ */
+int
+warc_is_html(struct warc_record *rec)
+{
+	if (rec->status == 0 || rec->content_type == NULL)
+		return 0;
+
+	return strncasecmp(rec->content_type, "text/html", 9) == 0 ||
+	    strncasecmp(rec->content_type, "application/xhtml+xml", 21) == 0;
+}
+
+/*
+ * Read a line without the line ending into w->line. Returns 0 at the
+ * end of the file.
+ */
+static int
+read_line(struct warc *w)
+{
+	int c;
+
+	str_add(&w->line, '\0');
+	while ((c = INPUT_GETC(&w->in)) != EOF && c != '\n')
+		if (c != '\r')
+			str_add(&w->line, c);
+
+	return c != EOF || w->line.len > 0;
+}
+
+/*
+ * Read a block of len bytes to rec->block, growing it as the bytes
+ * come. Returns the number of bytes read.
+ */
+static size_t
+read_block(struct warc *w, struct warc_record *rec, size_t len)
+{
+	struct input *in = &w->in;
+	size_t n, done, alloc;
+	int c;
+
+	done = 0;
+	alloc = len < WARC_BLOCK ? len : WARC_BLOCK;
+	if ((rec->block = mem_malloc(alloc + 1)) == NULL)
+		err(1, "malloc record");
+	while (done < len) {
+		if (done == alloc) {
+			alloc = alloc > len / 2 ? len : alloc * 2;
+			rec->block = mem_realloc(rec->block, alloc + 1);
+			if (rec->block == NULL)
+				err(1, "realloc record");
+		}
+		if ((n = in->len - in->pos) == 0) {
+			if ((c = input_fill(in)) == EOF)
+				break;
+			rec->block[done++] = c;
+			continue;
+		}
+		if (n > alloc - done)
+			n = alloc - done;
+		memcpy(&rec->block[done], &in->buf[in->pos], n);
+		in->pos += n;
+		done += n;
+	}
+
+	return done;
+}
+
+/*
+ * Returns the value if the header line has the given name.
+ */
+static const char *
+value(const char *line, const char *name)
+{
+	size_t len;
+
+	len = strlen(name);
+	if (strncasecmp(line, name, len) != 0 || line[len] != ':')
+		return NULL;
+
+	line += len + 1;
+	while (*line == ' ' || *line == '\t')
+		line++;
+	return line;
+}
+
+static char *
+dup_value(const char *v)
+{
+	char *s;
+
+	if ((s = mem_strdup(v)) == NULL)
+		err(1, "strdup");
+	return s;
+}
+
+/*
+ * Skip the status line and the headers of an HTTP response.
+ */
+static void
+http(struct warc *w, struct warc_record *rec)
+{
+	char *line, *next, *end;
+	const char *v;
+	int chunked, encoded;
+
+	end = &rec->block[rec->block_len];
+	if ((line = strchr(rec->block, ' ')) != NULL)
+		rec->status = atoi(line + 1);
+
+	chunked = encoded = 0;
+	line = rec->block;
+	for (;;) {
+		if ((next = memchr(line, '\n', end - line)) == NULL) {
+			/*
+			 * Headers only.
+			 */
+			rec->payload = end;
+			rec->payload_len = 0;
+			return;
+		}
+		*next++ = '\0';
+		if (next - line >= 2 && next[-2] == '\r')
+			next[-2] = '\0';
+
+		if (*line == '\0')
+			break;
+
+		if ((v = value(line, "Content-Type")) != NULL) {
+			mem_free(rec->content_type);
+			rec->content_type = dup_value(v);
+		} else if ((v = value(line, "Transfer-Encoding")) != NULL)
+			chunked = (strncasecmp(v, "chunked", 7) == 0);
+		else if ((v = value(line, "Content-Encoding")) != NULL)
+			encoded = (strncasecmp(v, "gzip", 4) == 0 ||
+			    strncasecmp(v, "x-gzip", 6) == 0 ||
+			    strncasecmp(v, "deflate", 7) == 0);
+		line = next;
+	}
+
+	rec->payload = next;
+	rec->payload_len = end - next;
+
+	if (chunked)
+		dechunk(rec);
+	if (encoded)
+		decode_record(w, rec);
+}
+
+/*
+ * Remove chunked transfer coding in place.
+ */
+static void
+dechunk(struct warc_record *rec)
+{
+	char *src, *dst, *end, *p;
+	size_t size;
+
+	src = dst = rec->payload;
+	end = &rec->payload[rec->payload_len];
+	while (src < end) {
+		size = strtoul(src, &p, 16);
+		if (p == src)
+			break;
+		if ((src = memchr(p, '\n', end - p)) == NULL)
+			break;
+		src++;
+		if (size == 0)
+			break;
+		if (size > (size_t) (end - src))
+			size = end - src;
+		memmove(dst, src, size);
+		dst += size;
+		src += size;
+		if (src < end && *src == '\r')
+			src++;
+		if (src < end && *src == '\n')
+			src++;
+	}
+
+	rec->payload_len = dst - rec->payload;
+	*dst = '\0';
+}
+
+static size_t
+mem_read(void *user, char *buf, size_t len)
+{
+	struct mem *mem = user;
+
+	if (len > mem->len)
+		len = mem->len;
+	memcpy(buf, mem->p, len);
+	mem->p += len;
+	mem->len -= len;
+	return len;
+}
+
+/*
+ * Decompress gzip or deflate content coding. On bad data, what could
+ * be decompressed is kept.
+ */
+static void
+decode_record(struct warc *w, struct warc_record *rec)
+{
+	struct mem mem;
+	size_t len, alloc, n;
+	char *buf;
+
+	if (w->inflate == NULL &&
+	    (w->inflate = mem_malloc(sizeof(struct inflate))) == NULL)
+		err(1, "malloc inflate");
+
+	mem.p = rec->payload;
+	mem.len = rec->payload_len;
+	inflate_init(w->inflate, mem_read, &mem);
+
+	buf = NULL;
+	len = 0;
+	alloc = rec->payload_len * 4 + 1;
+	do {
+		if (len + 1 >= alloc || buf == NULL) {
+			alloc = buf ? alloc * 2 : alloc;
+			if ((buf = mem_realloc(buf, alloc)) == NULL)
+				err(1, "realloc payload");
+		}
+		n = inflate_read(w->inflate, &buf[len], alloc - len - 1);
+		len += n;
+	} while (n > 0);
+	buf[len] = '\0';
+
+	rec->decoded = buf;
+	rec->payload = buf;
+	rec->payload_len = len;
+}
+
+#ifdef TEST
+#include <stdio.h>
+
+/*
+ * "<p>hello, world</p>" made with Python's gzip module.
+ */
+static const unsigned char gz[] = {
+	0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0xb3,
+	0x29, 0xb0, 0xcb, 0x48, 0xcd, 0xc9, 0xc9, 0xd7, 0x51, 0x28, 0xcf,
+	0x2f, 0xca, 0x49, 0xb1, 0xd1, 0x2f, 0xb0, 0x03, 0x00, 0xcb, 0xcb,
+	0xe6, 0xbc, 0x13, 0x00, 0x00, 0x00
+};
+
+static char file[4096];
+static size_t file_len;
+
+static void
+add(const char *s, size_t len)
+{
+	assert(file_len + len <= sizeof(file));
+	memcpy(&file[file_len], s, len);
+	file_len += len;
+}
+
+static void
+record(const char *type, const char *uri, const char *block, size_t len)
+{
+	char buf[256];
+
+	snprintf(buf, sizeof(buf), "WARC/1.0\r\nWARC-Type: %s\r\n"
+	    "WARC-Target-URI: %s\r\nContent-Length: %zu\r\n\r\n", type, uri,
+	    len);
+	add(buf, strlen(buf));
+	add(block, len);
+	add("\r\n\r\n", 4);
+}
+
+/*
+ * A file of one bad record.
+ */
+static void
+bad(const char *s, const char *error)
+{
+	struct warc w;
+	struct warc_record rec;
+	struct mem mem;
+
+	mem.p = s;
+	mem.len = strlen(s);
+	warc_init(&w, mem_read, &mem);
+	assert(!warc_next(&w, &rec));
+	assert(w.error != NULL && strcmp(w.error, error) == 0);
+	warc_free(&w);
+}
+
+int
+main(int argc, char **argv)
+{
+	static const char html[] = "HTTP/1.1 200 OK\r\n"
+	    "Content-Type: text/html; charset=utf-8\r\n\r\n<p>a</p>";
+	static const char chunked[] = "HTTP/1.1 200 OK\r\n"
+	    "Content-Type: text/html\r\nTransfer-Encoding: chunked\r\n\r\n"
+	    "4\r\n<p>b\r\n4;x=y\r\n</p>\r\n0\r\n\r\n";
+	static const char png[] = "HTTP/1.0 404 Not Found\n"
+	    "Content-Type: image/png\n\n\x89PNG";
+	char gzipped[256];
+	struct warc w;
+	struct warc_record rec;
+	struct mem mem;
+	size_t len;
+
+	record("warcinfo", "", "software: test\r\n", 16);
+	record("request", "http://a/", "GET / HTTP/1.1\r\n\r\n", 18);
+	record("response", "<http://a/>", html, sizeof(html) - 1);
+	record("response", "http://b/", chunked, sizeof(chunked) - 1);
+	record("response", "http://c/", png, sizeof(png) - 1);
+	len = snprintf(gzipped, sizeof(gzipped), "HTTP/1.1 200 OK\r\n"
+	    "Content-Type: text/html\r\nContent-Encoding: gzip\r\n\r\n");
+	memcpy(&gzipped[len], gz, sizeof(gz));
+	record("response", "http://d/", gzipped, len + sizeof(gz));
+	add("WARC/1.0\r\nContent-Length: 100\r\n\r\nshort", 38);
+
+	mem.p = file;
+	mem.len = file_len;
+	warc_init(&w, mem_read, &mem);
+	w.in.size = 7;
+
+	assert(warc_next(&w, &rec) && strcmp(rec.type, "warcinfo") == 0);
+	assert(!warc_is_html(&rec));
+	warc_record_free(&rec);
+
+	assert(warc_next(&w, &rec) && strcmp(rec.type, "request") == 0);
+	assert(rec.status == 0 && !warc_is_html(&rec));
+	warc_record_free(&rec);
+
+	assert(warc_next(&w, &rec) && warc_is_html(&rec));
+	assert(strcmp(rec.uri, "http://a/") == 0 && rec.status == 200);
+	assert(strcmp(rec.payload, "<p>a</p>") == 0 && rec.payload_len == 8);
+	warc_record_free(&rec);
+
+	assert(warc_next(&w, &rec) && warc_is_html(&rec));
+	assert(strcmp(rec.payload, "<p>b</p>") == 0 && rec.payload_len == 8);
+	warc_record_free(&rec);
+
+	assert(warc_next(&w, &rec) && !warc_is_html(&rec));
+	assert(rec.status == 404 && strcmp(rec.payload, "\x89PNG") == 0);
+	warc_record_free(&rec);
+
+	assert(warc_next(&w, &rec) && warc_is_html(&rec));
+	assert(strcmp(rec.payload, "<p>hello, world</p>") == 0);
+	warc_record_free(&rec);
+
+	assert(!warc_next(&w, &rec) && w.error != NULL);
+	assert(strcmp(w.error, "truncated record") == 0);
+	warc_free(&w);
+
+	bad("WARC/1.0\r\nContent-Length: 18446744073709551615\r\n\r\nx",
+	    "bad Content-Length");
+	bad("WARC/1.0\r\nContent-Length: 99999999999999999999\r\n\r\nx",
+	    "bad Content-Length");
+	bad("WARC/1.0\r\nContent-Length: -1\r\n\r\nx",
+	    "bad Content-Length");
+	bad("WARC/1.0\r\nContent-Length: 1000000000000\r\n\r\nx",
+	    "truncated record");
+	bad("WARC/1.0\r\nWARC-Type: x\r\n\r\nx", "no Content-Length");
+	return 0;
+}
+#endif
@@ -0,0 +1,64 @@
+/*
+ * ISC License
+ *
+ * Copyright (c) 2022, Tommi Leino <namhas@gmail.com>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef WARC_H
+#define WARC_H
+
+#include "input.h"
+#include "util.h"
+
+#include <stddef.h>
+
+struct inflate;
+
+/*
+ * A record of a WARC file. For HTTP responses the payload is the body
+ * with the HTTP headers skipped, chunked transfer coding removed and
+ * gzip or deflate content coding decompressed.
+ */
+struct warc_record {
+	char		*type;		/* WARC-Type */
+	char		*uri;		/* WARC-Target-URI */
+	int		 status;	/* HTTP status, 0 if not a response */
+	char		*content_type;	/* HTTP Content-Type */
+
+	char		*block;		/* record block */
+	size_t		 block_len;
+	char		*payload;
+	size_t		 payload_len;
+	char		*decoded;	/* payload if it was compressed */
+};
+
+/*
+ * Reads records one after another from a read callback, see input.h.
+ * For .warc.gz files, read through struct inflate.
+ */
+struct warc {
+	struct input	 in;
+	struct str	 line;
+	struct inflate	*inflate;	/* for content coding */
+	const char	*error;		/* set if the file is bad */
+};
+
+void	warc_init(struct warc *, size_t (*)(void *, char *, size_t), void *);
+int	warc_next(struct warc *, struct warc_record *);
+int	warc_is_html(struct warc_record *);
+void	warc_record_free(struct warc_record *);
+void	warc_free(struct warc *);
+
+#endif